@@ -0,0 +1,119 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAsynArrayBuffer.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcAsynArrayBuffer.h"
+#include <string.h>
+#include <new>
+#include <epicsAtomic.h>
+
+ecmcAsynArrayBuffer::ecmcAsynArrayBuffer(size_t bytes, int decimation) {
+  size_              = bytes;
+  writeIndex_        = 0;
+  state_             = 1;  // middle
+  readIndex_         = 2;
+  decimation_        = decimation > 1 ? decimation : 1;
+  decimationCounter_ = 0;
+  publishedCount_    = 0;
+  fetchedCount_      = 0;
+
+  for (int i = 0; i < ECMC_ASYN_ARRAY_BUFFER_COUNT; i++) {
+    buffers_[i] = NULL;
+    bytes_[i]   = 0;
+  }
+
+  try {
+    for (int i = 0; i < ECMC_ASYN_ARRAY_BUFFER_COUNT; i++) {
+      buffers_[i] = new uint8_t[bytes];
+      memset(buffers_[i], 0, bytes);
+    }
+  } catch (std::bad_alloc& ex) {
+    for (int i = 0; i < ECMC_ASYN_ARRAY_BUFFER_COUNT; i++) {
+      delete[] buffers_[i];
+      buffers_[i] = NULL;
+    }
+    size_ = 0;
+  }
+}
+
+ecmcAsynArrayBuffer::~ecmcAsynArrayBuffer() {
+  for (int i = 0; i < ECMC_ASYN_ARRAY_BUFFER_COUNT; i++) {
+    delete[] buffers_[i];
+  }
+}
+
+uint8_t * ecmcAsynArrayBuffer::getWriteBuffer() {
+  return buffers_[writeIndex_];
+}
+
+bool ecmcAsynArrayBuffer::publish(size_t bytes, bool force) {
+  if (!force && (++decimationCounter_ < decimation_)) {
+    return false;
+  }
+  decimationCounter_ = 0;
+
+  bytes_[writeIndex_] = bytes > size_ ? size_ : bytes;
+
+  // Make data visible before the buffer is handed over
+  epicsAtomicWriteMemoryBarrier();
+
+  int oldState = epicsAtomicGetIntT(&state_);
+  int newState = writeIndex_ | ECMC_ASYN_ARRAY_BUFFER_NEW_DATA;
+  int prev     = 0;
+
+  while ((prev = epicsAtomicCmpAndSwapIntT(&state_, oldState,
+                                           newState)) != oldState) {
+    oldState = prev;
+  }
+
+  writeIndex_ = oldState & ECMC_ASYN_ARRAY_BUFFER_INDEX_MASK;
+  publishedCount_++;
+  return true;
+}
+
+bool ecmcAsynArrayBuffer::fetch(uint8_t **data, size_t *bytes) {
+  int oldState = epicsAtomicGetIntT(&state_);
+
+  if (!(oldState & ECMC_ASYN_ARRAY_BUFFER_NEW_DATA)) {
+    return false;
+  }
+
+  int prev = 0;
+
+  while ((prev = epicsAtomicCmpAndSwapIntT(&state_, oldState,
+                                           readIndex_)) != oldState) {
+    oldState = prev;
+  }
+
+  epicsAtomicReadMemoryBarrier();
+
+  readIndex_ = oldState & ECMC_ASYN_ARRAY_BUFFER_INDEX_MASK;
+  *data      = buffers_[readIndex_];
+  *bytes     = bytes_[readIndex_];
+  fetchedCount_++;
+  return true;
+}
+
+size_t ecmcAsynArrayBuffer::getSize() {
+  return size_;
+}
+
+int ecmcAsynArrayBuffer::getDecimation() {
+  return decimation_;
+}
+
+uint64_t ecmcAsynArrayBuffer::getPublishedCount() {
+  return publishedCount_;
+}
+
+uint64_t ecmcAsynArrayBuffer::getFetchedCount() {
+  return fetchedCount_;
+}
@@ -0,0 +1,64 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAsynArrayBuffer.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Triple buffer for publication of large array parameters outside rt.
+* The rt thread fills the write buffer (directly, see getWriteBuffer()) and
+* flips it with the middle buffer in publish(). A non rt publisher thread
+* takes the latest buffer with fetch() and does the asyn array callbacks
+* from it. Neither side blocks or copies. Optional decimation: only every
+* n:th publish() flips (intermediate fills are overwritten).
+*
+\*************************************************************************/
+
+#ifndef ECMC_ASYN_ARRAY_BUFFER_H_
+#define ECMC_ASYN_ARRAY_BUFFER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ECMC_ASYN_ARRAY_BUFFER_COUNT 3
+#define ECMC_ASYN_ARRAY_BUFFER_INDEX_MASK 0x3
+#define ECMC_ASYN_ARRAY_BUFFER_NEW_DATA 0x4
+
+class ecmcAsynArrayBuffer {
+public:
+  // Returns NULL buffers if allocation failed (check getSize())
+  ecmcAsynArrayBuffer(size_t bytes,
+                      int    decimation);
+  ~ecmcAsynArrayBuffer();
+
+  // Rt side
+  uint8_t* getWriteBuffer();
+  bool     publish(size_t bytes,
+                   bool   force);
+
+  // Publisher side. Returns true if a new buffer is available.
+  bool     fetch(uint8_t **data,
+                 size_t   *bytes);
+
+  size_t   getSize();
+  int      getDecimation();
+  uint64_t getPublishedCount();
+  uint64_t getFetchedCount();
+
+private:
+  uint8_t *buffers_[ECMC_ASYN_ARRAY_BUFFER_COUNT];
+  size_t bytes_[ECMC_ASYN_ARRAY_BUFFER_COUNT];
+  size_t size_;
+  int state_;        // middle index | new data flag (epicsAtomic)
+  int writeIndex_;   // rt only
+  int readIndex_;    // publisher only
+  int decimation_;
+  int decimationCounter_;
+  uint64_t publishedCount_;
+  uint64_t fetchedCount_;
+};
+
+#endif  /* ECMC_ASYN_ARRAY_BUFFER_H_ */
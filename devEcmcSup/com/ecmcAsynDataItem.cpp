@@ -25,6 +25,7 @@
 #include <epicsMutex.h>
 #include <epicsExport.h>
 #include <epicsEvent.h>
+#include <epicsAtomic.h>
 #include <dbCommon.h>
 #include <dbBase.h>
 #include <dbStaticLib.h>
@@ -41,24 +42,16 @@ ecmcAsynDataItem::ecmcAsynDataItem(ecmcAsynPortDriver *asynPortDriver,
                                    ecmcEcDataType      dt,
                                    double              updateRateMs) :
   ecmcDataItem(paramName) {
+  initVars();
   asynPortDriver_            = asynPortDriver;
-  asynUpdateCycleCounter_    = 0;
-  supportedTypesCounter_     = 0;
-  fctPtrExeCmd_              = NULL;
-  useExeCmdFunc_             = false;
-  exeCmdUserObj_             = NULL;
   dataItem_.dataType         = dt;
   dataItem_.dataElementSize  = getEcDataTypeByteSize(dt);
   dataItem_.dataUpdateRateMs = updateRateMs;
-
-  for (int i = 0; i < ERROR_ASYN_MAX_SUPPORTED_TYPES_COUNT; i++) {
-    supportedTypes_[i] = asynParamNotDefined;
-  }
-  memset(&paramInfo_, 0, sizeof(ecmcParamInfo));
-  paramInfo_.name        = strdup(paramName);
-  paramInfo_.asynType    = asynParType;
-  paramInfo_.dataIsArray = asynTypeIsArray(asynParType);
+  paramInfo_->name           = strdup(paramName);
+  paramInfo_->asynType       = asynParType;
+  paramInfo_->dataIsArray    = asynTypeIsArray(asynParType);
   addSupportedAsynType(asynParType);
+  syncParamInfo();
 }
 
 ecmcAsynDataItem::ecmcAsynDataItem(ecmcAsynPortDriver *asynPortDriver,
@@ -66,38 +59,47 @@ ecmcAsynDataItem::ecmcAsynDataItem(ecmcAsynPortDriver *asynPortDriver,
                                    asynParamType       asynParType,
                                    ecmcEcDataType      dt) :
   ecmcDataItem(paramName) {
+  initVars();
   asynPortDriver_           = asynPortDriver;
-  asynUpdateCycleCounter_   = 0;
-  supportedTypesCounter_    = 0;
-  fctPtrExeCmd_             = NULL;
-  useExeCmdFunc_            = false;
-  exeCmdUserObj_            = NULL;
   dataItem_.dataType        = dt;
   dataItem_.dataElementSize = getEcDataTypeByteSize(dt);
-
-  for (int i = 0; i < ERROR_ASYN_MAX_SUPPORTED_TYPES_COUNT; i++) {
-    supportedTypes_[i] = asynParamNotDefined;
-  }
-  memset(&paramInfo_, 0, sizeof(ecmcParamInfo));
-  paramInfo_.name        = strdup(paramName);
-  paramInfo_.asynType    = asynParType;
-  paramInfo_.dataIsArray = asynTypeIsArray(asynParType);
+  paramInfo_->name          = strdup(paramName);
+  paramInfo_->asynType      = asynParType;
+  paramInfo_->dataIsArray   = asynTypeIsArray(asynParType);
   addSupportedAsynType(asynParType);
+  syncParamInfo();
 }
 
 ecmcAsynDataItem::ecmcAsynDataItem(ecmcAsynPortDriver *asynPortDriver) :
   ecmcDataItem("empty") {
-  memset(&paramInfo_, 0, sizeof(ecmcParamInfo));
+  initVars();
   asynPortDriver_         = asynPortDriver;
-  asynUpdateCycleCounter_ = 0;
-  supportedTypesCounter_  = 0;
   dataItem_.dataType      = ECMC_EC_NONE;
-  paramInfo_.name         = strdup("empty");
-  paramInfo_.asynType     = asynParamNotDefined;
-  paramInfo_.dataIsArray  = 0;
-  fctPtrExeCmd_           = NULL;
-  useExeCmdFunc_          = false;
-  exeCmdUserObj_          = NULL;
+  paramInfo_->name        = strdup("empty");
+  paramInfo_->asynType    = asynParamNotDefined;
+  paramInfo_->dataIsArray = 0;
+  syncParamInfo();
+}
+
+void ecmcAsynDataItem::initVars() {
+  asynPortDriver_        = NULL;
+  supportedTypesCounter_ = 0;
+  fctPtrExeCmd_          = NULL;
+  useExeCmdFunc_         = false;
+  exeCmdUserObj_         = NULL;
+  allowScheduler_        = true;
+  arrayBuffer_           = NULL;
+  deferValue_            = 0;
+  deferBytes_            = 0;
+  deferSeq_              = 0;
+  deferAlarm_            = 0;
+  deferValuePending_     = 0;
+  deferAlarmPending_     = 0;
+  deferQueued_           = 0;
+  memset(&rt_, 0, sizeof(rt_));
+
+  // Names and record info are only used at config and report
+  paramInfo_ = (ecmcParamInfo *)calloc(1, sizeof(ecmcParamInfo));
 
   for (int i = 0; i < ERROR_ASYN_MAX_SUPPORTED_TYPES_COUNT; i++) {
     supportedTypes_[i] = asynParamNotDefined;
@@ -105,31 +107,23 @@ ecmcAsynDataItem::ecmcAsynDataItem(ecmcAsynPortDriver *asynPortDriver) :
 }
 
 ecmcAsynDataItem::~ecmcAsynDataItem() {
-  free(paramInfo_.recordName);
-  paramInfo_.recordName = NULL;
-  free(paramInfo_.recordType);
-  paramInfo_.recordType = NULL;
-  free(paramInfo_.scan);
-  paramInfo_.scan = NULL;
-  free(paramInfo_.dtyp);
-  paramInfo_.dtyp = 0;
-  free(paramInfo_.inp);
-  paramInfo_.inp = NULL;
-  free(paramInfo_.out);
-  paramInfo_.out = NULL;
-  free(paramInfo_.drvInfo);
-  paramInfo_.drvInfo = NULL;
-  free(paramInfo_.asynTypeStr);
-  paramInfo_.asynTypeStr = NULL;
-  free(paramInfo_.name);
-  paramInfo_.name = NULL;
+  free(paramInfo_->recordName);
+  free(paramInfo_->recordType);
+  free(paramInfo_->scan);
+  free(paramInfo_->dtyp);
+  free(paramInfo_->inp);
+  free(paramInfo_->out);
+  free(paramInfo_->drvInfo);
+  free(paramInfo_->asynTypeStr);
+  free(paramInfo_->name);
+  free(paramInfo_);
+  paramInfo_ = NULL;
+  delete arrayBuffer_;
+  arrayBuffer_ = NULL;
 }
 
 int ecmcAsynDataItem::refreshParamRT(int force) {
-  if (!asynPortDriver_->getAllowRtThreadCom()) {
-    return ERROR_ASYN_NOT_REFRESHED_RETURN;
-  }
-  return refreshParam(force, dataItem_.data, dataItem_.dataSize);
+  return refreshParamRT(force, dataItem_.data, dataItem_.dataSize);
 }
 
 int ecmcAsynDataItem::refreshParam(int force) {
@@ -137,10 +131,7 @@ int ecmcAsynDataItem::refreshParam(int force) {
 }
 
 int ecmcAsynDataItem::refreshParamRT(int force, size_t bytes) {
-  if (!asynPortDriver_->getAllowRtThreadCom()) {
-    return ERROR_ASYN_NOT_REFRESHED_RETURN;
-  }
-  return refreshParam(force, dataItem_.data, bytes);
+  return refreshParamRT(force, dataItem_.data, bytes);
 }
 
 int ecmcAsynDataItem::refreshParam(int force, size_t bytes) {
@@ -148,6 +139,13 @@ int ecmcAsynDataItem::refreshParam(int force, size_t bytes) {
 }
 
 int ecmcAsynDataItem::refreshParamRT(int force, uint8_t *data, size_t bytes) {
+  // Published by the parameter wheel when due, only keep the data location
+  if (rt_.scheduled && !force && !hasSubscribers()) {
+    dataItem_.data     = data;
+    dataItem_.dataSize = bytes;
+    return ERROR_ASYN_NOT_REFRESHED_RETURN;
+  }
+
   if (!asynPortDriver_->getAllowRtThreadCom()) {
     return ERROR_ASYN_NOT_REFRESHED_RETURN;
   }
@@ -174,37 +172,237 @@ int ecmcAsynDataItem::refreshParam(int force, uint8_t *data, size_t bytes) {
   refresh();
 
   // Do not update if not linked to epics-record
-  if (!paramInfo_.initialized) {
+  if (!rt_.initialized) {
     return 0;
   }
 
+  // Published when due by the parameter wheel (see ecmcAsynParamWheel)
+  if (rt_.scheduled && !force) {
+    return ERROR_ASYN_NOT_REFRESHED_RETURN;
+  }
 
-  const int sampleTimeCycles = paramInfo_.sampleTimeCycles;
+  const int sampleTimeCycles = rt_.sampleTimeCycles;
   if (!force) {
     if (sampleTimeCycles < 0) {
       return ERROR_ASYN_NOT_REFRESHED_RETURN;
     }
 
     if ((sampleTimeCycles >= 0) &&
-        (asynUpdateCycleCounter_ < sampleTimeCycles - 1)) {
-      asynUpdateCycleCounter_++;
+        (rt_.cycleCounter < sampleTimeCycles - 1)) {
+      rt_.cycleCounter++;
       return ERROR_ASYN_NOT_REFRESHED_RETURN;  // Not refreshed
     }
   }
 
+  if (arrayBuffer_) {
+    return bufferParam(force, data, bytes);
+  }
+
+  return publishOrDeferParam(force, data, bytes);
+}
+
+/*
+* Publish to the parameter library, or hand over to the param publisher
+* thread if the rt thread runs without the port lock (command mailbox).
+*/
+int ecmcAsynDataItem::publishOrDeferParam(int      force,
+                                          uint8_t *data,
+                                          size_t   bytes) {
+  const bool changed = rt_.dataIsArray || valueChanged(data, bytes);
+
+  // Already in the parameter library, no callbacks needed
+  if (!changed && !force) {
+    rt_.cycleCounter = 0;
+    return 0;
+  }
+
+  if (asynPortDriver_->getDeferredPublish()) {
+    return deferParam(data, bytes);
+  }
+
+  int errorCode = publishParam(force, data, bytes);
+
+  if (errorCode) {
+    rt_.lastBytes = 0;  // Retried at next refresh
+    return errorCode;
+  }
+
+  // Array callbacks are already done
+  if (!rt_.dataIsArray) {
+    asynPortDriver_->setParamsChanged();
+  }
+  return 0;
+}
+
+/*
+* Scalar differs from the last published value. Values larger than 8 bytes
+* (octet) are always treated as changed.
+*/
+bool ecmcAsynDataItem::valueChanged(uint8_t *data, size_t bytes) {
+  if (!data || (bytes > sizeof(rt_.lastValue))) {
+    return true;
+  }
+
+  uint64_t value = 0;
+  memcpy(&value, data, bytes);
+
+  if ((value == rt_.lastValue) && (bytes == rt_.lastBytes)) {
+    return false;
+  }
+
+  rt_.lastValue = value;
+  rt_.lastBytes = bytes;
+  return true;
+}
+
+/*
+* Store the value for the param publisher thread (port not locked).
+* Only the latest value is published, the item is queued once.
+* Arrays are published by the array publisher (see setArrayBuffered()).
+*/
+int ecmcAsynDataItem::deferParam(uint8_t *data, size_t bytes) {
   if (data == 0) {
     return ERROR_ASYN_DATA_NULL;
   }
 
-  if ((bytes > ecmcMaxSize_) && arrayCheckSize_) {
-    bytes = ecmcMaxSize_;
+  if (rt_.dataIsArray) {
+    return ERROR_ASYN_NOT_REFRESHED_RETURN;
   }
 
-  dataItem_.dataSize = bytes;
+  if (bytes > sizeof(deferValue_)) {
+    bytes = sizeof(deferValue_);
+  }
+
+  // Sequence odd while written (single writer, the owner of the item)
+  epicsAtomicSetSizeT(&deferSeq_, deferSeq_ + 1);
+  epicsAtomicWriteMemoryBarrier();
+  memcpy(&deferValue_, data, bytes);
+  deferBytes_ = bytes;
+  epicsAtomicWriteMemoryBarrier();
+  epicsAtomicSetSizeT(&deferSeq_, deferSeq_ + 1);
+
+  rt_.cycleCounter = 0;
+  epicsAtomicSetIntT(&deferValuePending_, 1);
+  asynPortDriver_->setParamsChanged();
+  return queueDeferred(&deferValuePending_);
+}
+
+int ecmcAsynDataItem::queueDeferred(int *pending) {
+  if (epicsAtomicCmpAndSwapIntT(&deferQueued_, 0, 1) != 0) {
+    return 0;  // Already queued
+  }
+
+  int errorCode = asynPortDriver_->postDeferred(deferredApply, this);
+
+  if (errorCode) {
+    // Retried at next refresh (also if the value is unchanged)
+    rt_.lastBytes = 0;
+    epicsAtomicSetIntT(pending, 0);
+    epicsAtomicSetIntT(&deferQueued_, 0);
+    return ERROR_ASYN_DEFER_QUEUE_FULL;
+  }
+  return 0;
+}
+
+void ecmcAsynDataItem::deferredApply(void    *obj,
+                                     uint8_t *data,
+                                     size_t   bytes,
+                                     int      type) {
+  ((ecmcAsynDataItem *)obj)->applyDeferred();
+}
+
+/*
+* Called by the param publisher thread (port locked).
+*/
+void ecmcAsynDataItem::applyDeferred() {
+  // Updates from now on are queued again
+  epicsAtomicSetIntT(&deferQueued_, 0);
+
+  if (epicsAtomicCmpAndSwapIntT(&deferValuePending_, 1, 0) == 1) {
+    uint64_t value = 0;
+    size_t   bytes = 0;
+    size_t   seq   = 0;
+
+    do {
+      seq = epicsAtomicGetSizeT(&deferSeq_);
+      epicsAtomicReadMemoryBarrier();
+      value = deferValue_;
+      bytes = deferBytes_;
+      epicsAtomicReadMemoryBarrier();
+    } while ((seq & 1) || (seq != epicsAtomicGetSizeT(&deferSeq_)));
+
+    publishParam(0, (uint8_t *)&value, bytes);
+  }
+
+  if (epicsAtomicCmpAndSwapIntT(&deferAlarmPending_, 1, 0) == 1) {
+    int alarm = epicsAtomicGetIntT(&deferAlarm_);
+    applyAlarmParam(alarm >> 16, alarm & 0xFFFF);
+  }
+}
+
+/*
+* Hand over array data to the publisher thread (rt side). No copy if the
+* owner filled the write buffer directly (see getArrayWriteBuffer()).
+*/
+int ecmcAsynDataItem::bufferParam(int force, uint8_t *data, size_t bytes) {
+  if (data == 0) {
+    return ERROR_ASYN_DATA_NULL;
+  }
+
+  if (bytes > arrayBuffer_->getSize()) {
+    bytes = arrayBuffer_->getSize();
+  }
+
+  uint8_t *writeBuffer = arrayBuffer_->getWriteBuffer();
+
+  if (data != writeBuffer) {
+    memcpy(writeBuffer, data, bytes);
+  }
+
+  rt_.cycleCounter = 0;
+  return arrayBuffer_->publish(bytes, force) ? 0 :
+         ERROR_ASYN_NOT_REFRESHED_RETURN;
+}
+
+/*
+* Called by the array publisher thread (port locked).
+* Returns 0 if new data was published.
+*/
+int ecmcAsynDataItem::publishArrayBuffer() {
+  uint8_t *data = NULL;
+  size_t bytes  = 0;
+
+  if (!arrayBuffer_ || !arrayBuffer_->fetch(&data, &bytes)) {
+    return ERROR_ASYN_NOT_REFRESHED_RETURN;
+  }
+
+  if (doArrayCallbacks(data, bytes) != asynSuccess) {
+    return ERROR_ASYN_REFRESH_FAIL;
+  }
+  return 0;
+}
+
+/*
+* Called by the parameter wheel when the parameter is due.
+* Publishes the data of the last refreshParam() call.
+*/
+int ecmcAsynDataItem::refreshParamScheduled() {
+  return publishOrDeferParam(0, dataItem_.data, dataItem_.dataSize);
+}
+
+int ecmcAsynDataItem::publishParam(int force, uint8_t *data, size_t bytes) {
+  if (data == 0) {
+    return ERROR_ASYN_DATA_NULL;
+  }
+
+  if ((bytes > ecmcMaxSize_) && arrayCheckSize_) {
+    bytes              = ecmcMaxSize_;
+    dataItem_.dataSize = bytes;
+  }
 
   asynStatus stat = asynError;
-  const int paramIndex = paramInfo_.index;
-  const asynParamType asynType = paramInfo_.asynType;
+  const int paramIndex = rt_.index;
+  const asynParamType asynType = rt_.asynType;
 
   switch (asynType) {
   case asynParamUInt32Digital:
@@ -238,8 +436,8 @@ int ecmcAsynDataItem::refreshParam(int force, uint8_t *data, size_t bytes) {
 
   case asynParamFloat64:
 
-    if (paramInfo_.cmdInt64ToFloat64) {
-      if (dataItem_.dataSize == sizeof(int64_t)) {
+    if (rt_.cmdInt64ToFloat64) {
+      if (bytes == sizeof(int64_t)) {
         stat = asynPortDriver_->setDoubleParam(ECMC_ASYN_DEFAULT_LIST,
                                                paramIndex,
                                                static_cast<epicsFloat64>(*(
@@ -250,8 +448,8 @@ int ecmcAsynDataItem::refreshParam(int force, uint8_t *data, size_t bytes) {
       }
     }
 
-    if (paramInfo_.cmdUint64ToFloat64) {
-      if (dataItem_.dataSize == sizeof(uint64_t)) {
+    if (rt_.cmdUint64ToFloat64) {
+      if (bytes == sizeof(uint64_t)) {
         stat = asynPortDriver_->setDoubleParam(ECMC_ASYN_DEFAULT_LIST,
                                                paramIndex,
                                                static_cast<epicsFloat64>(*(
@@ -262,8 +460,8 @@ int ecmcAsynDataItem::refreshParam(int force, uint8_t *data, size_t bytes) {
       }
     }
 
-    if (paramInfo_.cmdUint32ToFloat64) {
-      if (dataItem_.dataSize == sizeof(uint32_t)) {
+    if (rt_.cmdUint32ToFloat64) {
+      if (bytes == sizeof(uint32_t)) {
         stat = asynPortDriver_->setDoubleParam(ECMC_ASYN_DEFAULT_LIST,
                                                paramIndex,
                                                static_cast<epicsFloat64>(*(
@@ -274,8 +472,8 @@ int ecmcAsynDataItem::refreshParam(int force, uint8_t *data, size_t bytes) {
       }
     }
 
-    if (paramInfo_.cmdFloat64ToInt32) {
-      if (dataItem_.dataSize == sizeof(double)) {
+    if (rt_.cmdFloat64ToInt32) {
+      if (bytes == sizeof(double)) {
         stat = asynPortDriver_->setIntegerParam(ECMC_ASYN_DEFAULT_LIST,
                                                 paramIndex,
                                                 static_cast<epicsInt32>(*(
@@ -299,6 +497,54 @@ int ecmcAsynDataItem::refreshParam(int force, uint8_t *data, size_t bytes) {
                                            *((epicsFloat64 *)data));
     break;
 
+  case asynParamInt8Array:
+  case asynParamInt16Array:
+  case asynParamInt32Array:
+  case asynParamFloat32Array:
+  case asynParamFloat64Array:
+    stat = doArrayCallbacks(data, bytes);
+    break;
+
+#ifdef ECMC_ASYN_ASYNPARAMINT64
+  case asynParamInt64:
+    stat = asynPortDriver_->setInteger64Param(ECMC_ASYN_DEFAULT_LIST,
+                                              paramIndex,
+                                              *((epicsInt64 *)data));
+    break;
+
+  case asynParamInt64Array:
+    stat = doArrayCallbacks(data, bytes);
+    break;
+#endif // ECMC_ASYN_ASYNPARAMINT64
+
+  default:
+    return ERROR_ASYN_DATA_TYPE_NOT_SUPPORTED;
+
+    break;
+  }
+
+  rt_.cycleCounter = 0;
+
+  if (stat != asynSuccess) {
+    asynPrint(
+      asynPortDriver_->getTraceAsynUser(),
+      ASYN_TRACE_ERROR,
+      "ecmcAsynDataItem::refreshParam: ERROR: Refresh failed for parameter %s, bytes %zu, force %d, sample time %d (0x%x).\n",
+      getName(),
+      bytes,
+      force,
+      rt_.sampleTimeCycles,
+      ERROR_ASYN_REFRESH_FAIL);
+    return ERROR_ASYN_REFRESH_FAIL;
+  }
+  return 0;
+}
+
+asynStatus ecmcAsynDataItem::doArrayCallbacks(uint8_t *data, size_t bytes) {
+  asynStatus stat = asynError;
+  const int paramIndex = rt_.index;
+
+  switch (rt_.asynType) {
   case asynParamInt8Array:
     stat = asynPortDriver_->doCallbacksInt8Array((epicsInt8 *)data,
                                                  bytes,
@@ -335,12 +581,6 @@ int ecmcAsynDataItem::refreshParam(int force, uint8_t *data, size_t bytes) {
     break;
 
 #ifdef ECMC_ASYN_ASYNPARAMINT64
-  case asynParamInt64:
-    stat = asynPortDriver_->setInteger64Param(ECMC_ASYN_DEFAULT_LIST,
-                                              paramIndex,
-                                              *((epicsInt64 *)data));
-    break;
-
   case asynParamInt64Array:
     stat = asynPortDriver_->doCallbacksInt64Array((epicsInt64 *)data,
                                                   bytes / sizeof(epicsInt64),
@@ -350,30 +590,14 @@ int ecmcAsynDataItem::refreshParam(int force, uint8_t *data, size_t bytes) {
 #endif // ECMC_ASYN_ASYNPARAMINT64
 
   default:
-    return ERROR_ASYN_DATA_TYPE_NOT_SUPPORTED;
-
     break;
   }
 
-  asynUpdateCycleCounter_ = 0;
-
-  if (stat != asynSuccess) {
-    asynPrint(
-      asynPortDriver_->getTraceAsynUser(),
-      ASYN_TRACE_ERROR,
-      "ecmcAsynDataItem::refreshParam: ERROR: Refresh failed for parameter %s, bytes %zu, force %d, sample time %d (0x%x).\n",
-      getName(),
-      bytes,
-      force,
-      paramInfo_.sampleTimeCycles,
-      ERROR_ASYN_REFRESH_FAIL);
-    return ERROR_ASYN_REFRESH_FAIL;
-  }
-  return 0;
+  return stat;
 }
 
 int ecmcAsynDataItem::createParam() {
-  return createParam(dataItem_.name, paramInfo_.asynType);
+  return createParam(dataItem_.name, paramInfo_->asynType);
 }
 
 int ecmcAsynDataItem::createParam(const char   *paramName,
@@ -389,38 +613,41 @@ int ecmcAsynDataItem::createParam(const char   *paramName,
   if (asynPortDriver_ == 0) {
     return ERROR_ASYN_PORT_NULL;
   }
-  paramInfo_.name     = strdup(paramName);
-  paramInfo_.asynType = asynParType;
+  paramInfo_->name     = strdup(paramName);
+  paramInfo_->asynType = asynParType;
+
+  asynStatus status = asynError;
 
   // ECMC double, epics record int32
-  if (paramInfo_.cmdFloat64ToInt32 &&
-      (paramInfo_.asynType == asynParamFloat64) &&
+  if (paramInfo_->cmdFloat64ToInt32 &&
+      (paramInfo_->asynType == asynParamFloat64) &&
       (dataItem_.dataSize == sizeof(epicsFloat64))) {
-    asynStatus status = asynPortDriver_->createParam(ECMC_ASYN_DEFAULT_LIST,
-                                                     paramName,
-                                                     asynParamInt32,
-                                                     &paramInfo_.index);
-    return (status == asynSuccess) ? 0 : ERROR_ASYN_CREATE_PARAM_FAIL;
+    status = asynPortDriver_->createParam(ECMC_ASYN_DEFAULT_LIST,
+                                          paramName,
+                                          asynParamInt32,
+                                          &paramInfo_->index);
+  } else {
+    status = asynPortDriver_->createParam(ECMC_ASYN_DEFAULT_LIST,
+                                          paramName,
+                                          paramInfo_->asynType,
+                                          &paramInfo_->index);
   }
-
-  asynStatus status = asynPortDriver_->createParam(ECMC_ASYN_DEFAULT_LIST,
-                                                   paramName,
-                                                   paramInfo_.asynType,
-                                                   &paramInfo_.index);
+  syncParamInfo();
   return (status == asynSuccess) ? 0 : ERROR_ASYN_CREATE_PARAM_FAIL;
 }
 
 int ecmcAsynDataItem::getAsynParameterIndex() {
-  return paramInfo_.index;
+  return paramInfo_->index;
 }
 
 int ecmcAsynDataItem::setAsynParameterType(asynParamType parType) {
-  paramInfo_.asynType = parType;
+  paramInfo_->asynType = parType;
+  syncParamInfo();
   return 0;
 }
 
 asynParamType ecmcAsynDataItem::getAsynParameterType() {
-  return paramInfo_.asynType;
+  return paramInfo_->asynType;
 }
 
 int ecmcAsynDataItem::setAsynPortDriver(ecmcAsynPortDriver *asynPortDriver) {
@@ -429,49 +656,65 @@ int ecmcAsynDataItem::setAsynPortDriver(ecmcAsynPortDriver *asynPortDriver) {
 }
 
 int ecmcAsynDataItem::setAsynParSampleTimeMS(double sampleTime) {
-  paramInfo_.sampleTimeMS     = sampleTime;
-  paramInfo_.sampleTimeCycles = (int32_t)(sampleTime / 1000.0 * mcuFrequency);
+  paramInfo_->sampleTimeMS     = sampleTime;
+  paramInfo_->sampleTimeCycles = (int32_t)(sampleTime / 1000.0 * mcuFrequency);
 
-  if (paramInfo_.sampleTimeMS == -1) {
-    paramInfo_.sampleTimeCycles = -1;
+  if (paramInfo_->sampleTimeMS == -1) {
+    paramInfo_->sampleTimeCycles = -1;
   }
+  syncParamInfo();
   return 0;
 }
 
 ecmcParamInfo * ecmcAsynDataItem::getParamInfo() {
-  return &paramInfo_;
+  return paramInfo_;
+}
+
+/*
+* Copy the fields used in each refreshParam() to the hot rt_ struct.
+*/
+void ecmcAsynDataItem::syncParamInfo() {
+  rt_.index              = paramInfo_->index;
+  rt_.sampleTimeCycles   = paramInfo_->sampleTimeCycles;
+  rt_.asynType           = paramInfo_->asynType;
+  rt_.initialized        = paramInfo_->initialized;
+  rt_.dataIsArray        = paramInfo_->dataIsArray;
+  rt_.cmdUint64ToFloat64 = paramInfo_->cmdUint64ToFloat64;
+  rt_.cmdInt64ToFloat64  = paramInfo_->cmdInt64ToFloat64;
+  rt_.cmdFloat64ToInt32  = paramInfo_->cmdFloat64ToInt32;
+  rt_.cmdUint32ToFloat64 = paramInfo_->cmdUint32ToFloat64;
 }
 
 bool ecmcAsynDataItem::linkedToAsynClient() {
-  return paramInfo_.initialized;
+  return paramInfo_->initialized;
 }
 
 int32_t ecmcAsynDataItem::getSampleTimeCycles() {
-  return paramInfo_.sampleTimeCycles;
+  return paramInfo_->sampleTimeCycles;
 }
 
 double ecmcAsynDataItem::getSampleTimeMs() {
-  return paramInfo_.sampleTimeCycles * 1000.0 / mcuFrequency;
+  return paramInfo_->sampleTimeCycles * 1000.0 / mcuFrequency;
 }
 
 char * ecmcAsynDataItem::getParamName() {
-  return paramInfo_.name;
+  return paramInfo_->name;
 }
 
 char * ecmcAsynDataItem::getDrvInfo() {
-  return paramInfo_.drvInfo;
+  return paramInfo_->drvInfo;
 }
 
 char * ecmcAsynDataItem::getDtyp() {
-  return paramInfo_.dtyp;
+  return paramInfo_->dtyp;
 }
 
 char * ecmcAsynDataItem::getRecordType() {
-  return paramInfo_.recordType;
+  return paramInfo_->recordType;
 }
 
 char * ecmcAsynDataItem::getRecordName() {
-  return paramInfo_.recordName;
+  return paramInfo_->recordName;
 }
 
 int ecmcAsynDataItem::addSupportedAsynType(asynParamType type) {
@@ -503,11 +746,11 @@ int ecmcAsynDataItem::getSupportedAsynTypeCount() {
 }
 
 asynParamType ecmcAsynDataItem::getAsynType() {
-  return paramInfo_.asynType;
+  return paramInfo_->asynType;
 }
 
 char * ecmcAsynDataItem::getAsynTypeName() {
-  return paramInfo_.asynTypeStr;
+  return paramInfo_->asynTypeStr;
 }
 
 asynParamType ecmcAsynDataItem::getSupportedAsynType(int index) {
@@ -518,7 +761,72 @@ asynParamType ecmcAsynDataItem::getSupportedAsynType(int index) {
 }
 
 bool ecmcAsynDataItem::willRefreshNext() {
-  return asynUpdateCycleCounter_ >= paramInfo_.sampleTimeCycles - 1;
+  return rt_.cycleCounter >= rt_.sampleTimeCycles - 1;
+}
+
+void ecmcAsynDataItem::setScheduled(bool scheduled) {
+  rt_.scheduled = scheduled;
+}
+
+bool ecmcAsynDataItem::getScheduled() {
+  return rt_.scheduled;
+}
+
+void ecmcAsynDataItem::setAllowScheduler(bool allow) {
+  allowScheduler_ = allow;
+}
+
+bool ecmcAsynDataItem::getAllowScheduler() {
+  return allowScheduler_;
+}
+
+/** Publish array from the non rt array publisher thread.
+ * The rt thread hands over the data in a triple buffer and the
+ * doCallbacks*Array() calls are made by the publisher thread.
+ * Not allowed in rt.
+ */
+int ecmcAsynDataItem::setArrayBuffered(int decimation) {
+  if (!paramInfo_->dataIsArray) {
+    return ERROR_ASYN_ARRAY_BUFFER_NOT_ARRAY;
+  }
+
+  if (arrayBuffer_) {
+    return 0;
+  }
+
+  arrayBuffer_ = new ecmcAsynArrayBuffer(ecmcMaxSize_, decimation);
+
+  if (arrayBuffer_->getSize() == 0) {
+    delete arrayBuffer_;
+    arrayBuffer_ = NULL;
+    return ERROR_ASYN_ARRAY_BUFFER_ALLOC_FAIL;
+  }
+
+  int errorCode = asynPortDriver_->addArrayBufferedParam(this);
+
+  if (errorCode) {
+    delete arrayBuffer_;
+    arrayBuffer_ = NULL;
+    return errorCode;
+  }
+
+  // Published by the publisher thread, not the wheel
+  allowScheduler_ = false;
+  return 0;
+}
+
+bool ecmcAsynDataItem::getArrayBuffered() {
+  return arrayBuffer_ != NULL;
+}
+
+/** Buffer owners can fill directly (zero copy). Changes after each
+ *  handover. NULL if not buffered.
+ */
+uint8_t * ecmcAsynDataItem::getArrayWriteBuffer() {
+  if (!arrayBuffer_) {
+    return NULL;
+  }
+  return arrayBuffer_->getWriteBuffer();
 }
 
 /** Set parameter alarm state.
@@ -530,6 +838,17 @@ bool ecmcAsynDataItem::willRefreshNext() {
  * \return asynSuccess or asynError.
  */
 asynStatus ecmcAsynDataItem::setAlarmParam(int alarm, int severity) {
+  // Applied by the param publisher thread (see deferParam())
+  if (asynPortDriver_->getDeferredPublish()) {
+    epicsAtomicSetIntT(&deferAlarm_, (alarm << 16) | (severity & 0xFFFF));
+    epicsAtomicSetIntT(&deferAlarmPending_, 1);
+    return queueDeferred(&deferAlarmPending_) ? asynError : asynSuccess;
+  }
+
+  return applyAlarmParam(alarm, severity);
+}
+
+asynStatus ecmcAsynDataItem::applyAlarmParam(int alarm, int severity) {
   asynStatus stat;
   int oldAlarmStatus = 0;
   const int paramIndex = getAsynParameterIndex();
@@ -552,7 +871,7 @@ asynStatus ecmcAsynDataItem::setAlarmParam(int alarm, int severity) {
     if (stat != asynSuccess) {
       return asynError;
     }
-    paramInfo_.alarmStatus = alarm;
+    paramInfo_->alarmStatus = alarm;
     doCallbacks            = true;
   }
 
@@ -573,7 +892,7 @@ asynStatus ecmcAsynDataItem::setAlarmParam(int alarm, int severity) {
     if (stat != asynSuccess) {
       return asynError;
     }
-    paramInfo_.alarmSeverity = severity;
+    paramInfo_->alarmSeverity = severity;
     doCallbacks              = true;
   }
 
@@ -582,7 +901,11 @@ asynStatus ecmcAsynDataItem::setAlarmParam(int alarm, int severity) {
   }
 
   // Alarm status or severity changed=>Do callbacks with old buffered data (if nElemnts==0 then no data in record...)
-  if (paramInfo_.dataIsArray && (dataItem_.dataSize > 0)) {
+  if (paramInfo_->dataIsArray && (dataItem_.dataSize > 0)) {
+    // Buffer is owned by the rt thread, alarm goes with the next array
+    if (arrayBuffer_ && asynPortDriver_->getDeferredPublish()) {
+      return asynSuccess;
+    }
     refreshParamRT(1);
   } else {
     stat = asynPortDriver_->callParamCallbacks(ECMC_ASYN_DEFAULT_LIST,
@@ -593,11 +916,11 @@ asynStatus ecmcAsynDataItem::setAlarmParam(int alarm, int severity) {
 }
 
 int ecmcAsynDataItem::getAlarmStatus() {
-  return paramInfo_.alarmStatus;
+  return paramInfo_->alarmStatus;
 }
 
 int ecmcAsynDataItem::getAlarmSeverity() {
-  return paramInfo_.alarmSeverity;
+  return paramInfo_->alarmSeverity;
 }
 
 int ecmcAsynDataItem::asynTypeIsArray(asynParamType asynParType) {
@@ -660,6 +983,80 @@ asynStatus ecmcAsynDataItem::writeGeneric(uint8_t      *data,
     return asynError;
   }
 
+  // Post to rt thread if command mailbox is in use (RT owns objects)
+  ecmcCmdMailbox *mailbox = asynPortDriver_->getCmdMailbox();
+
+  if (mailbox && (bytesToWrite <= ECMC_CMD_MAILBOX_MAX_PAYLOAD)) {
+    int errorCode = mailbox->post(mailboxWrite,
+                                  this,
+                                  data,
+                                  bytesToWrite,
+                                  (int)type);
+
+    if (errorCode) {
+      LOGERR(
+        "%s/%s:%d: ERROR: %s write error. Command mailbox post failed (0x%x).\n",
+        __FILE__,
+        __FUNCTION__,
+        __LINE__,
+        getName(),
+        errorCode);
+      return asynError;
+    }
+    *writtenBytes = bytesToWrite;
+    return asynSuccess;
+  }
+
+  // Larger writes by reference, wait for the rt thread (lock free rt)
+  if (mailbox && asynPortDriver_->getDeferredPublish()) {
+    ecmcAsynWriteCall write = { this, data, bytesToWrite, type, writtenBytes };
+    int result    = asynError;
+    int errorCode = mailbox->call(callWrite,
+                                  &write,
+                                  ECMC_CMD_MAILBOX_CALL_TIMEOUT_S,
+                                  &result);
+
+    if (errorCode) {
+      LOGERR(
+        "%s/%s:%d: ERROR: %s write error. Command mailbox call failed (0x%x).\n",
+        __FILE__,
+        __FUNCTION__,
+        __LINE__,
+        getName(),
+        errorCode);
+      return asynError;
+    }
+    return (asynStatus)result;
+  }
+
+  return applyWrite(data, bytesToWrite, type, writtenBytes);
+}
+
+int ecmcAsynDataItem::callWrite(void *arg) {
+  ecmcAsynWriteCall *write = (ecmcAsynWriteCall *)arg;
+
+  return write->item->applyWrite(write->data,
+                                 write->bytes,
+                                 write->type,
+                                 write->writtenBytes);
+}
+
+void ecmcAsynDataItem::mailboxWrite(void    *obj,
+                                    uint8_t *data,
+                                    size_t   bytes,
+                                    int      type) {
+  size_t written = 0;
+
+  ((ecmcAsynDataItem *)obj)->applyWrite(data,
+                                        bytes,
+                                        (asynParamType)type,
+                                        &written);
+}
+
+asynStatus ecmcAsynDataItem::applyWrite(uint8_t      *data,
+                                        size_t        bytesToWrite,
+                                        asynParamType type,
+                                        size_t       *writtenBytes) {
   // Execute function instead of copy data
   if (useExeCmdFunc_) {
     return fctPtrExeCmd_((void *)data, bytesToWrite, type, exeCmdUserObj_);
@@ -761,8 +1158,8 @@ asynStatus ecmcAsynDataItem::readGeneric(uint8_t      *data,
 
 asynStatus ecmcAsynDataItem::readInt32(epicsInt32 *value) {
   // Check if cmd. ECMC double, epics record int32
-  if (paramInfo_.cmdFloat64ToInt32) {
-    if ((paramInfo_.asynType == asynParamFloat64) &&
+  if (paramInfo_->cmdFloat64ToInt32) {
+    if ((paramInfo_->asynType == asynParamFloat64) &&
         (dataItem_.dataSize == sizeof(epicsFloat64))) {
       *value = static_cast<epicsInt32>(*(epicsFloat64 *)dataItem_.data);
       return asynSuccess;
@@ -785,8 +1182,8 @@ asynStatus ecmcAsynDataItem::readInt32(epicsInt32 *value) {
 
 asynStatus ecmcAsynDataItem::writeInt32(epicsInt32 value) {
   // Check if cmd. ECMC double, epics record int32
-  if (paramInfo_.cmdFloat64ToInt32) {
-    if ((paramInfo_.asynType == asynParamFloat64) &&
+  if (paramInfo_->cmdFloat64ToInt32) {
+    if ((paramInfo_->asynType == asynParamFloat64) &&
         (dataItem_.dataSize == sizeof(epicsFloat64))) {
       epicsFloat64 temp = static_cast<epicsFloat64>(value);
       memcpy(dataItem_.data, &temp, sizeof(epicsFloat64));
@@ -873,8 +1270,8 @@ asynStatus ecmcAsynDataItem::writeUInt32Digital(epicsUInt32 value,
 
 asynStatus ecmcAsynDataItem::readFloat64(epicsFloat64 *value) {
   // Check if cmd. ECMC int64, epics record double
-  if (paramInfo_.cmdInt64ToFloat64) {
-    if ((paramInfo_.asynType == asynParamFloat64) &&
+  if (paramInfo_->cmdInt64ToFloat64) {
+    if ((paramInfo_->asynType == asynParamFloat64) &&
         (dataItem_.dataSize == sizeof(int64_t))) {
       *value = static_cast<epicsFloat64>(*(int64_t *)dataItem_.data);
       return asynSuccess;
@@ -891,8 +1288,8 @@ asynStatus ecmcAsynDataItem::readFloat64(epicsFloat64 *value) {
   }
 
   // Check if cmd. ECMC uint64, epics record double
-  if (paramInfo_.cmdUint64ToFloat64) {
-    if ((paramInfo_.asynType == asynParamFloat64) &&
+  if (paramInfo_->cmdUint64ToFloat64) {
+    if ((paramInfo_->asynType == asynParamFloat64) &&
         (dataItem_.dataSize == sizeof(uint64_t))) {
       *value = static_cast<epicsFloat64>(*(uint64_t *)dataItem_.data);
       return asynSuccess;
@@ -908,8 +1305,8 @@ asynStatus ecmcAsynDataItem::readFloat64(epicsFloat64 *value) {
     }
   }
 
-  if (paramInfo_.cmdUint32ToFloat64) {
-    if ((paramInfo_.asynType == asynParamFloat64) &&
+  if (paramInfo_->cmdUint32ToFloat64) {
+    if ((paramInfo_->asynType == asynParamFloat64) &&
         (dataItem_.dataSize == sizeof(uint32_t))) {
       *value = static_cast<epicsFloat64>(*(uint32_t *)dataItem_.data);
       return asynSuccess;
@@ -926,7 +1323,7 @@ asynStatus ecmcAsynDataItem::readFloat64(epicsFloat64 *value) {
   }
   // Special case F32
   if (dataItem_.dataType == ECMC_EC_F32) {
-    if ((paramInfo_.asynType == asynParamFloat64) &&
+    if ((paramInfo_->asynType == asynParamFloat64) &&
         (dataItem_.dataSize >= sizeof(float))) {
       *value = static_cast<epicsFloat64>(*(float *)dataItem_.data);
       return asynSuccess;
@@ -949,8 +1346,8 @@ asynStatus ecmcAsynDataItem::readFloat64(epicsFloat64 *value) {
 
 asynStatus ecmcAsynDataItem::writeFloat64(epicsFloat64 value) {
   // Check if cmd. ECMC int64, epics record double
-  if (paramInfo_.cmdInt64ToFloat64) {
-    if ((paramInfo_.asynType == asynParamFloat64) &&
+  if (paramInfo_->cmdInt64ToFloat64) {
+    if ((paramInfo_->asynType == asynParamFloat64) &&
         (dataItem_.dataSize == sizeof(int64_t))) {
       int64_t temp = static_cast<int64_t>(value);
       memcpy(dataItem_.data, &temp, sizeof(int64_t));
@@ -968,8 +1365,8 @@ asynStatus ecmcAsynDataItem::writeFloat64(epicsFloat64 value) {
   }
 
   // Check if cmd. ECMC uint64, epics record double
-  if (paramInfo_.cmdUint64ToFloat64) {
-    if ((paramInfo_.asynType == asynParamFloat64) &&
+  if (paramInfo_->cmdUint64ToFloat64) {
+    if ((paramInfo_->asynType == asynParamFloat64) &&
         (dataItem_.dataSize == sizeof(uint64_t))) {
       uint64_t temp = static_cast<uint64_t>(value);
       memcpy(dataItem_.data, &temp, sizeof(uint64_t));
@@ -988,7 +1385,7 @@ asynStatus ecmcAsynDataItem::writeFloat64(epicsFloat64 value) {
 
   // Special case F32
   if (dataItem_.dataType == ECMC_EC_F32) {
-    if ((paramInfo_.asynType == asynParamFloat64) &&
+    if ((paramInfo_->asynType == asynParamFloat64) &&
         (dataItem_.dataSize >= sizeof(float))) {
       float temp = static_cast<float>(value);
       memcpy(dataItem_.data, &temp, sizeof(float));
@@ -1195,24 +1592,24 @@ asynStatus ecmcAsynDataItem::getRecordInfoFromDrvInfo(const char *drvInfo) {
   }
 
   while (!status) {
-    paramInfo_.recordType = strdup(dbGetRecordTypeName(pdbentry));
+    paramInfo_->recordType = strdup(dbGetRecordTypeName(pdbentry));
     status                = dbFirstRecord(pdbentry);
 
     while (!status) {
-      paramInfo_.recordName = strdup(dbGetRecordName(pdbentry));
+      paramInfo_->recordName = strdup(dbGetRecordName(pdbentry));
 
       if (!dbIsAlias(pdbentry)) {
         status = dbFindField(pdbentry, "INP");
 
         if (!status) {
-          paramInfo_.inp = strdup(dbGetString(pdbentry));
+          paramInfo_->inp = strdup(dbGetString(pdbentry));
 
           isInput = true;
           char port[ECMC_MAX_FIELD_CHAR_LENGTH];
           int  adr;
           int  timeout;
           char currdrvInfo[ECMC_MAX_FIELD_CHAR_LENGTH];
-          int  nvals = sscanf(paramInfo_.inp,
+          int  nvals = sscanf(paramInfo_->inp,
                               ECMC_ASYN_INP_FORMAT,
                               port,
                               &adr,
@@ -1228,7 +1625,7 @@ asynStatus ecmcAsynDataItem::getRecordInfoFromDrvInfo(const char *drvInfo) {
             }
           } else {
             int mask = 0;
-            nvals = sscanf(paramInfo_.inp,
+            nvals = sscanf(paramInfo_->inp,
                            ECMC_ASYN_MASK_INP_FORMAT,
                            port,
                            &adr,
@@ -1251,13 +1648,13 @@ asynStatus ecmcAsynDataItem::getRecordInfoFromDrvInfo(const char *drvInfo) {
         status = dbFindField(pdbentry, "OUT");
 
         if (!status) {
-          paramInfo_.out = strdup(dbGetString(pdbentry));
+          paramInfo_->out = strdup(dbGetString(pdbentry));
           isOutput       = true;
           char port[ECMC_MAX_FIELD_CHAR_LENGTH];
           int  adr;
           int  timeout;
           char currdrvInfo[ECMC_MAX_FIELD_CHAR_LENGTH];
-          int  nvals = sscanf(paramInfo_.out,
+          int  nvals = sscanf(paramInfo_->out,
                               ECMC_ASYN_INP_FORMAT,
                               port,
                               &adr,
@@ -1273,7 +1670,7 @@ asynStatus ecmcAsynDataItem::getRecordInfoFromDrvInfo(const char *drvInfo) {
             }
           } else {
             int mask = 0;
-            nvals = sscanf(paramInfo_.out,
+            nvals = sscanf(paramInfo_->out,
                            ECMC_ASYN_MASK_INP_FORMAT,
                            port,
                            &adr,
@@ -1300,17 +1697,17 @@ asynStatus ecmcAsynDataItem::getRecordInfoFromDrvInfo(const char *drvInfo) {
           status = dbFindField(pdbentry, "DTYP");
 
           if (!status) {
-            paramInfo_.dtyp = strdup(dbGetString(pdbentry));
+            paramInfo_->dtyp = strdup(dbGetString(pdbentry));
 
-            // paramInfo_.asynType=stringToAsynType(dbGetString(pdbentry));
+            // paramInfo_->asynType=stringToAsynType(dbGetString(pdbentry));
           } else {
-            paramInfo_.dtyp = 0;
+            paramInfo_->dtyp = 0;
 
-            // paramInfo_.asynType=asynParamNotDefined;
+            // paramInfo_->asynType=asynParamNotDefined;
           }
 
           // drvInput (not a field)
-          paramInfo_.drvInfo = strdup(drvInfo);
+          paramInfo_->drvInfo = strdup(drvInfo);
           dbFreeEntry(pdbentry);
 
           // The correct record was found and the paramInfo structure is filled
@@ -1318,40 +1715,40 @@ asynStatus ecmcAsynDataItem::getRecordInfoFromDrvInfo(const char *drvInfo) {
         } else {
           // Not correct record. Do cleanup.
           if (isInput) {
-            free(paramInfo_.inp);
-            paramInfo_.inp = 0;
+            free(paramInfo_->inp);
+            paramInfo_->inp = 0;
           }
 
           if (isOutput) {
-            free(paramInfo_.out);
-            paramInfo_.out = 0;
+            free(paramInfo_->out);
+            paramInfo_->out = 0;
           }
-          paramInfo_.drvInfo = 0;
-          paramInfo_.scan    = 0;
-          paramInfo_.dtyp    = 0;
+          paramInfo_->drvInfo = 0;
+          paramInfo_->scan    = 0;
+          paramInfo_->dtyp    = 0;
           isInput            = false;
           isOutput           = false;
         }
       }
       status = dbNextRecord(pdbentry);
-      free(paramInfo_.recordName);
-      paramInfo_.recordName = 0;
+      free(paramInfo_->recordName);
+      paramInfo_->recordName = 0;
       recordFound           = false;
     }
     status = dbNextRecordType(pdbentry);
-    free(paramInfo_.recordType);
-    paramInfo_.recordType = 0;
+    free(paramInfo_->recordType);
+    paramInfo_->recordType = 0;
   }
   dbFreeEntry(pdbentry);
 
   // Record not found so other asyn port driver/client
-  paramInfo_.recordType = strdup("none");
-  paramInfo_.recordName = strdup("asynPortDriver");
-  paramInfo_.inp        = strdup("none");
-  paramInfo_.dtyp       = strdup("none");
-  paramInfo_.out        = strdup("none");
-  paramInfo_.drvInfo    = strdup(drvInfo);
-  paramInfo_.scan       = 0;
+  paramInfo_->recordType = strdup("none");
+  paramInfo_->recordName = strdup("asynPortDriver");
+  paramInfo_->inp        = strdup("none");
+  paramInfo_->dtyp       = strdup("none");
+  paramInfo_->out        = strdup("none");
+  paramInfo_->drvInfo    = strdup(drvInfo);
+  paramInfo_->scan       = 0;
 
   return asynError;
 }
@@ -1378,12 +1775,12 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
             drvInfo);
 
   // Check if input or output
-  paramInfo_.isIOIntr = false;
+  paramInfo_->isIOIntr = false;
   const char *temp = strrchr(drvInfo, '?');
 
   if (temp) {
     if (strlen(temp) == 1) {
-      paramInfo_.isIOIntr = true; // All inputs will be created I/O intr
+      paramInfo_->isIOIntr = true; // All inputs will be created I/O intr
     }
   }
 
@@ -1394,7 +1791,7 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
     driverName,
     functionName,
     drvInfo,
-    paramInfo_.isIOIntr ? "I/O Intr (end with ?)" : "not I/O Intr (end with =)");
+    paramInfo_->isIOIntr ? "I/O Intr (end with ?)" : "not I/O Intr (end with =)");
 
   // take part after last "/" if option or complete string..
   char buffer[ECMC_MAX_FIELD_CHAR_LENGTH];
@@ -1406,8 +1803,8 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
     int nvals = sscanf(drvInfoEnd, "/%s", buffer);
 
     if (nvals == 1) {
-      paramInfo_.name                              = strdup(buffer);
-      paramInfo_.name[strlen(paramInfo_.name) - 1] = 0; // Strip ? or = from end
+      paramInfo_->name                              = strdup(buffer);
+      paramInfo_->name[strlen(paramInfo_->name) - 1] = 0; // Strip ? or = from end
     } else {
       asynPrint(
         asynPortDriver_->getTraceAsynUser(),
@@ -1419,13 +1816,13 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
       return asynError;
     }
   } else {   // No options
-    paramInfo_.name                              = strdup(drvInfo);
-    paramInfo_.name[strlen(paramInfo_.name) - 1] = 0; // Strip ? or = from end
+    paramInfo_->name                              = strdup(drvInfo);
+    paramInfo_->name[strlen(paramInfo_->name) - 1] = 0; // Strip ? or = from end
   }
 
   // Check if ECMC_OPTION_T_SAMPLE_RATE_MS option
   const char *option = ECMC_OPTION_T_SAMPLE_RATE_MS;
-  paramInfo_.sampleTimeMS = asynPortDriver_->getDefaultSampleTimeMs();
+  paramInfo_->sampleTimeMS = asynPortDriver_->getDefaultSampleTimeMs();
   const char *isThere = strstr(drvInfo, option);
 
   if (isThere) {
@@ -1443,10 +1840,10 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
 
     int nvals = sscanf(isThere + strlen(option),
                        "=%lf/",
-                       &paramInfo_.sampleTimeMS);
+                       &paramInfo_->sampleTimeMS);
 
     if (nvals != 1) {
-      paramInfo_.sampleTimeMS = asynPortDriver_->getDefaultSampleTimeMs();
+      paramInfo_->sampleTimeMS = asynPortDriver_->getDefaultSampleTimeMs();
       asynPrint(
         asynPortDriver_->getTraceAsynUser(),
         ASYN_TRACE_ERROR,
@@ -1466,8 +1863,8 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
     dataUpdateRateMs = mcuPeriod / 1E6;
   }
 
-  if ((paramInfo_.sampleTimeMS < dataUpdateRateMs) &&
-      (paramInfo_.sampleTimeMS > 0)) {
+  if ((paramInfo_->sampleTimeMS < dataUpdateRateMs) &&
+      (paramInfo_->sampleTimeMS > 0)) {
     asynPrint(
       asynPortDriver_->getTraceAsynUser(),
       ASYN_TRACE_ERROR,
@@ -1475,24 +1872,24 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
       " %3.1lfms will be used. (drvInfo = %s).\n",
       driverName,
       functionName,
-      paramInfo_.sampleTimeMS,
+      paramInfo_->sampleTimeMS,
       dataUpdateRateMs,
       dataUpdateRateMs,
       drvInfo);
-    paramInfo_.sampleTimeMS = dataUpdateRateMs;
+    paramInfo_->sampleTimeMS = dataUpdateRateMs;
   }
 
-  paramInfo_.sampleTimeCycles =
-    (int32_t)(paramInfo_.sampleTimeMS / dataUpdateRateMs);
+  paramInfo_->sampleTimeCycles =
+    (int32_t)(paramInfo_->sampleTimeMS / dataUpdateRateMs);
 
-  if (paramInfo_.sampleTimeMS == -1) {
-    paramInfo_.sampleTimeCycles = -1;
+  if (paramInfo_->sampleTimeMS == -1) {
+    paramInfo_->sampleTimeCycles = -1;
   }
 
   // Check if TYPE option
   option                 = ECMC_OPTION_TYPE;
-  paramInfo_.asynTypeStr = NULL;
-  paramInfo_.asynType    = asynParamNotDefined;
+  paramInfo_->asynTypeStr = NULL;
+  paramInfo_->asynType    = asynParamNotDefined;
 
   isThere = strstr(drvInfo, option);
 
@@ -1522,16 +1919,16 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
         drvInfo);
       return asynError;
     }
-    paramInfo_.asynTypeStr = strdup(buffer);
-    paramInfo_.asynType    = stringToAsynType(paramInfo_.asynTypeStr);
+    paramInfo_->asynTypeStr = strdup(buffer);
+    paramInfo_->asynType    = stringToAsynType(paramInfo_->asynTypeStr);
   }
 
   // Check if CMD option
   option                        = ECMC_OPTION_CMD;
-  paramInfo_.cmdUint64ToFloat64 = false;
-  paramInfo_.cmdInt64ToFloat64  = false;
-  paramInfo_.cmdFloat64ToInt32  = false;
-  paramInfo_.cmdUint32ToFloat64 = false;
+  paramInfo_->cmdUint64ToFloat64 = false;
+  paramInfo_->cmdInt64ToFloat64  = false;
+  paramInfo_->cmdFloat64ToInt32  = false;
+  paramInfo_->cmdUint32ToFloat64 = false;
 
   isThere = strstr(drvInfo, option);
 
@@ -1567,7 +1964,7 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
     isThere = strstr(buffer, ECMC_OPTION_CMD_UINT64_TO_FLOAT64);
 
     if (isThere) {
-      paramInfo_.cmdUint64ToFloat64 = true;
+      paramInfo_->cmdUint64ToFloat64 = true;
       cmdOK                         = true;
     }
 
@@ -1576,7 +1973,7 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
       isThere = strstr(buffer, ECMC_OPTION_CMD_UINT32_TO_FLOAT64);
 
       if (isThere) {
-        paramInfo_.cmdUint32ToFloat64 = true;
+        paramInfo_->cmdUint32ToFloat64 = true;
         cmdOK                         = true;
       }
     }
@@ -1586,7 +1983,7 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
       isThere = strstr(buffer, ECMC_OPTION_CMD_INT64_TO_FLOAT64);
 
       if (isThere) {
-        paramInfo_.cmdInt64ToFloat64 = true;
+        paramInfo_->cmdInt64ToFloat64 = true;
         cmdOK                        = true;
       }
     }
@@ -1596,7 +1993,7 @@ asynStatus ecmcAsynDataItem::parseInfofromDrvInfo(const char *drvInfo) {
       isThere = strstr(buffer, ECMC_OPTION_CMD_FLOAT64_TO_INT32);
 
       if (isThere) {
-        paramInfo_.cmdFloat64ToInt32 = true;
+        paramInfo_->cmdFloat64ToInt32 = true;
         cmdOK                        = true;
       }
     }
@@ -1628,6 +2025,7 @@ asynStatus ecmcAsynDataItem::setDrvInfo(const char *drvInfo) {
 
   // Parse options and name
   asynStatus status = parseInfofromDrvInfo(drvInfo);
+  syncParamInfo();
 
   if (status != asynSuccess) {
     return asynError;
@@ -19,6 +19,7 @@
 #include "ecmcAsynPortDriverUtils.h"
 #include "asynPortDriver.h"
 #include "ecmcDataItem.h"
+#include "ecmcAsynArrayBuffer.h"
 
 #ifndef VERSION_INT
 #  define VERSION_INT(V, R, M,\
@@ -45,6 +46,12 @@
 #define ERROR_ASYN_WRITE_VALUE_OUT_OF_RANGE 0x220007
 #define ERROR_ASYN_REFRESH_FAIL 0x220008
 #define ERROR_ASYN_CMD_FAIL 0x220009
+#define ERROR_ASYN_ARRAY_BUFFER_NOT_ARRAY 0x22000A
+#define ERROR_ASYN_ARRAY_BUFFER_ALLOC_FAIL 0x22000B
+#define ERROR_ASYN_ARRAY_BUFFER_LIST_FULL 0x22000C
+#define ERROR_ASYN_ARRAY_BUFFER_PARAM_NOT_FOUND 0x22000D
+#define ERROR_ASYN_DEFER_QUEUE_FULL 0x22000E
+#define ERROR_ASYN_DEFER_THREAD_FAIL 0x22000F
 
 #define ERROR_ASYN_MAX_SUPPORTED_TYPES_COUNT 10
 #define ERROR_ASYN_NOT_REFRESHED_RETURN -1
@@ -55,6 +62,16 @@ typedef asynStatus (*ecmcExeCmdFcn)(void *,
                                     void *);
 
 class ecmcAsynPortDriver;  // Include in cpp
+class ecmcAsynDataItem;
+
+// Write executed by the rt thread, data passed by reference
+typedef struct ecmcAsynWriteCall {
+  ecmcAsynDataItem *item;
+  uint8_t          *data;
+  size_t            bytes;
+  asynParamType     type;
+  size_t           *writtenBytes;
+} ecmcAsynWriteCall;
 
 // Asyn Parameter informtaion
 typedef struct ecmcParamInfo {
@@ -85,6 +102,23 @@ typedef struct ecmcParamInfo {
   bool          cmdUint32ToFloat64;
 } ecmcParamInfo;
 
+// Per cycle subset of ecmcParamInfo (see syncParamInfo())
+typedef struct ecmcParamRt {
+  int32_t       index;
+  int32_t       sampleTimeCycles;
+  int32_t       cycleCounter;
+  asynParamType asynType;
+  bool          initialized;
+  bool          scheduled;
+  bool          dataIsArray;
+  bool          cmdUint64ToFloat64;
+  bool          cmdInt64ToFloat64;
+  bool          cmdFloat64ToInt32;
+  bool          cmdUint32ToFloat64;
+  uint64_t      lastValue;  // Last published scalar (see valueChanged())
+  size_t        lastBytes;
+} ecmcParamRt;
+
 /**
 *  This class handles all asyn related information.
 *  All ecmc related information is handled in the class ecmcDataItem.
@@ -115,6 +149,7 @@ public:
   int refreshParamRT(int      force,
                      uint8_t *data,
                      size_t   bytes);
+  int refreshParamScheduled();
 
   int createParam();
   int createParam(const char   *paramName,
@@ -138,6 +173,9 @@ public:
   int32_t        getSampleTimeCycles();
   double         getSampleTimeMs();
   ecmcParamInfo* getParamInfo();
+
+  // Must be called after writing to getParamInfo() fields
+  void           syncParamInfo();
   int            addSupportedAsynType(asynParamType type);
   bool           asynTypeSupported(asynParamType type);
   int            getSupportedAsynTypeCount();
@@ -145,6 +183,20 @@ public:
   char*          getAsynTypeName();
   asynParamType  getSupportedAsynType(int index);
   bool           willRefreshNext();
+
+  // Publishing by parameter wheel (owners refresh data only)
+  void           setScheduled(bool scheduled);
+  bool           getScheduled();
+
+  // Owners that need the refreshParamRT() return value opt out
+  void           setAllowScheduler(bool allow);
+  bool           getAllowScheduler();
+
+  // Array callbacks from non rt publisher thread (see ecmcAsynArrayBuffer)
+  int            setArrayBuffered(int decimation);
+  bool           getArrayBuffered();
+  uint8_t*       getArrayWriteBuffer();
+  int            publishArrayBuffer();
   asynStatus     setAlarmParam(int alarm,
                                int severity);
   int            getAlarmStatus();
@@ -205,6 +257,31 @@ private:
   asynStatus getRecordInfoFromDrvInfo(const char *drvInfo);
   asynStatus parseInfofromDrvInfo(const char *drvInfo);
   int        asynTypeIsArray(asynParamType asynParType);
+  int        publishParam(int      force,
+                          uint8_t *data,
+                          size_t   bytes);
+  int        bufferParam(int      force,
+                         uint8_t *data,
+                         size_t   bytes);
+  bool       valueChanged(uint8_t *data,
+                          size_t   bytes);
+  int        publishOrDeferParam(int      force,
+                                 uint8_t *data,
+                                 size_t   bytes);
+  int        deferParam(uint8_t *data,
+                        size_t   bytes);
+  int        queueDeferred(int *pending);
+  void       applyDeferred();
+  asynStatus applyAlarmParam(int alarm,
+                             int severity);
+  asynStatus doArrayCallbacks(uint8_t *data,
+                              size_t   bytes);
+
+  // Executed by the param publisher thread (deferred publication)
+  static void deferredApply(void    *obj,
+                            uint8_t *data,
+                            size_t   bytes,
+                            int      type);
 
   asynStatus readGeneric(uint8_t      *data,
                          size_t        bytesToRead,
@@ -214,13 +291,38 @@ private:
                           size_t        bytes,
                           asynParamType type,
                           size_t       *writtenBytes);
+  asynStatus applyWrite(uint8_t      *data,
+                        size_t        bytes,
+                        asynParamType type,
+                        size_t       *writtenBytes);
+
+  // Executed in rt when writes are posted to the command mailbox
+  static void mailboxWrite(void    *obj,
+                           uint8_t *data,
+                           size_t   bytes,
+                           int      type);
+  static int  callWrite(void *arg);
+
+  void       initVars();
 
   // variables
+  // Hot (accessed in each refreshParam())
   ecmcAsynPortDriver *asynPortDriver_;
+  ecmcParamRt rt_;
+  ecmcAsynArrayBuffer *arrayBuffer_;
+
+  // Deferred publication (rt -> param publisher, lock free rt thread)
+  uint64_t deferValue_;    // Scalar, written under deferSeq_
+  size_t deferBytes_;
+  size_t deferSeq_;        // epicsAtomic, odd while written
+  int deferAlarm_;         // epicsAtomic, alarm << 16 | severity
+  int deferValuePending_;  // epicsAtomic
+  int deferAlarmPending_;  // epicsAtomic
+  int deferQueued_;        // epicsAtomic
 
-  ecmcParamInfo paramInfo_;
+  // Cold
+  ecmcParamInfo *paramInfo_;
   asynParamType supportedTypes_[ERROR_ASYN_MAX_SUPPORTED_TYPES_COUNT];
-  int asynUpdateCycleCounter_;
   int supportedTypesCounter_;
 
   // Add function to allow action on writes
@@ -230,6 +332,7 @@ private:
                               void         *userObj);
   bool useExeCmdFunc_;
   void *exeCmdUserObj_;
+  bool allowScheduler_;
 
   // Baseclass virtuals from ecmcDataItem class
   void refresh();
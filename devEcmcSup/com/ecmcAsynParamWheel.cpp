@@ -0,0 +1,134 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAsynParamWheel.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcAsynParamWheel.h"
+#include <stdio.h>
+#include <inttypes.h>
+#include <map>
+
+ecmcAsynParamWheel::ecmcAsynParamWheel() {
+  scheduledCount_ = 0;
+  cycle_          = 0;
+  published_      = 0;
+  maxDuePerCycle_ = 0;
+}
+
+ecmcAsynParamWheel::~ecmcAsynParamWheel() {}
+
+int ecmcAsynParamWheel::build(ecmcAsynDataItem **params, int count) {
+  clear();
+
+  // Group linked parameters by sample time
+  std::map<int, std::vector<ecmcAsynDataItem *> > groups;
+
+  for (int i = 0; i < count; i++) {
+    ecmcAsynDataItem *param = params[i];
+
+    if (!param || !param->linkedToAsynClient() ||
+        !param->getAllowScheduler()) {
+      continue;
+    }
+
+    const int32_t cycles = param->getSampleTimeCycles();
+
+    if (cycles < 0) {  // Only forced refresh
+      continue;
+    }
+    groups[cycles > 1 ? cycles : 1].push_back(param);
+  }
+
+  for (std::map<int, std::vector<ecmcAsynDataItem *> >::iterator it =
+         groups.begin(); it != groups.end(); ++it) {
+    ecmcAsynParamWheelRing ring;
+    const int period = it->first;
+    std::vector<ecmcAsynDataItem *>& group = it->second;
+    const int groupCount = (int)group.size();
+
+    ring.period = period;
+    ring.slotStart.assign(period + 1, 0);
+    ring.params.resize(groupCount);
+
+    // Spread over slots (param i in slot i % period), counting sort by slot
+    for (int i = 0; i < groupCount; i++) {
+      ring.slotStart[i % period + 1]++;
+    }
+
+    for (int slot = 0; slot < period; slot++) {
+      ring.slotStart[slot + 1] += ring.slotStart[slot];
+    }
+
+    std::vector<int> fill(ring.slotStart.begin(), ring.slotStart.end() - 1);
+
+    for (int i = 0; i < groupCount; i++) {
+      ring.params[fill[i % period]++] = group[i];
+      group[i]->setScheduled(true);
+    }
+    scheduledCount_ += groupCount;
+    rings_.push_back(ring);
+  }
+
+  return 0;
+}
+
+void ecmcAsynParamWheel::clear() {
+  for (size_t r = 0; r < rings_.size(); r++) {
+    for (size_t i = 0; i < rings_[r].params.size(); i++) {
+      rings_[r].params[i]->setScheduled(false);
+    }
+  }
+  rings_.clear();
+  scheduledCount_ = 0;
+}
+
+int ecmcAsynParamWheel::execute() {
+  int due = 0;
+  const size_t ringCount = rings_.size();
+
+  for (size_t r = 0; r < ringCount; r++) {
+    ecmcAsynParamWheelRing& ring = rings_[r];
+    const int slot  = (int)(cycle_ % (uint64_t)ring.period);
+    const int start = ring.slotStart[slot];
+    const int end   = ring.slotStart[slot + 1];
+    ecmcAsynDataItem **params = ring.params.data();
+
+    for (int i = start; i < end; i++) {
+      params[i]->refreshParamScheduled();
+    }
+    due += end - start;
+  }
+
+  cycle_++;
+  published_ += due;
+
+  if (due > maxDuePerCycle_) {
+    maxDuePerCycle_ = due;
+  }
+  return due;
+}
+
+int ecmcAsynParamWheel::getScheduledCount() {
+  return scheduledCount_;
+}
+
+void ecmcAsynParamWheel::printStatus() {
+  printf("Asyn parameter wheel:\n");
+  printf("  scheduled params:  %d\n",  scheduledCount_);
+  printf("  cycles:            %" PRIu64 "\n", cycle_);
+  printf("  published:         %" PRIu64 "\n", published_);
+  printf("  max due per cycle: %d\n",  maxDuePerCycle_);
+
+  for (size_t r = 0; r < rings_.size(); r++) {
+    printf("  period %6d cycles: %zu params\n",
+           rings_[r].period,
+           rings_[r].params.size());
+  }
+}
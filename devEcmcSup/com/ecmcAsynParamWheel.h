@@ -0,0 +1,57 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAsynParamWheel.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Scheduler for publishing of asyn parameters at their sample time.
+* One wheel per distinct sample time (in cycles) with one slot per cycle.
+* The linked parameters are spread over the slots and stored sorted by slot
+* in one contiguous array, so each cycle only the parameters that are due are
+* visited (one contiguous range per wheel). Built once when the records are
+* linked (ioc running), sample times are fixed after that.
+*
+\*************************************************************************/
+
+#ifndef ECMC_ASYN_PARAM_WHEEL_H_
+#define ECMC_ASYN_PARAM_WHEEL_H_
+
+#include <stdint.h>
+#include <vector>
+#include "ecmcAsynDataItem.h"
+
+struct ecmcAsynParamWheelRing {
+  int                period;    // cycles
+  std::vector<int>   slotStart; // period + 1 offsets into params
+  std::vector<ecmcAsynDataItem *> params;
+};
+
+class ecmcAsynParamWheel {
+public:
+  ecmcAsynParamWheel();
+  ~ecmcAsynParamWheel();
+
+  // Not in rt. Marks the scheduled parameters.
+  int  build(ecmcAsynDataItem **params,
+             int                count);
+  void clear();
+
+  // Rt. Publish due parameters, returns number of published parameters.
+  int  execute();
+
+  int  getScheduledCount();
+  void printStatus();
+
+private:
+  std::vector<ecmcAsynParamWheelRing> rings_;
+  int scheduledCount_;
+  uint64_t cycle_;
+  uint64_t published_;
+  int maxDuePerCycle_;
+};
+
+#endif  /* ECMC_ASYN_PARAM_WHEEL_H_ */
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <string>
+#include <map>
 #include <stdio.h>
 #include <errno.h>
 #include <math.h>
@@ -27,6 +28,7 @@
 #include <epicsMutex.h>
 #include <epicsExport.h>
 #include <epicsEvent.h>
+#include <epicsAtomic.h>
 #include <envDefs.h>
 #include <dbCommon.h>
 #include <dbBase.h>
@@ -45,6 +47,8 @@
 #include "ecmcEthercat.h"
 #include "ecmcGeneral.h"
 #include "ecmcCom.h"
+#include "ecmcThreadCfg.h"
+#include "ecmcCfgTiming.h"
 
 #include "exprtkWrap.h"  // Other module
 
@@ -57,12 +61,24 @@ extern int epicsHookState;
 
 static initHookState currentEpicsState     = initHookAtIocBuild;
 static ecmcAsynPortDriver *ecmcAsynPortObj = NULL;
+static double iocInitStartTime             = 0;
 
 /** Callback hook for EPICS state.
  * \param[in] state EPICS state
  * \return void
  * Will be called by the EPICS framework with the current EPICS state as it changes.
  */
+// Ioc running, objects shared with the rt thread (see getEpicsState())
+static int ecmcAsynIocRunningRT(void *arg) {
+  ecmcAsynPortDriver *port = (ecmcAsynPortDriver *)arg;
+
+  port->calcFastestUpdateRate();
+  port->buildParamWheel();
+  port->bufferDeferredArrays();
+  port->refreshAllInUseParamsRT();
+  return 0;
+}
+
 static void getEpicsState(initHookState state) {
   const char *functionName = "getEpicsState";
   
@@ -77,16 +93,36 @@ static void getEpicsState(initHookState state) {
   ecmcAsynPortObj->setEpicsState(state);
 
   switch (state) {
+  case initHookAtIocBuild:
+    iocInitStartTime = cfgTimingNow();
+    break;
+
   // case initHookAfterScanInit:
   case initHookAfterIocRunning:
     allowCallbackEpicsState = 1;
-    ecmcAsynPortObj->calcFastestUpdateRate();
 
-    /** Make all callbacks if data arrived from callback before interrupts
-      were registered (before allowCallbackEpicsState==1)
-      */
-    ecmcAsynPortObj->refreshAllInUseParamsRT();
+    // Lock free rt thread already running: executed by the rt thread
+    if (ecmcRTLockFree()) {
+      if (ecmcRTExec(ecmcAsynIocRunningRT, ecmcAsynPortObj)) {
+        printf("%s:%s: ERROR: Parameter update setup not executed by the rt thread\n",
+               driverName, functionName);
+      }
+      ecmcAsynPortObj->startArrayPublisher();
+    } else {
+      ecmcAsynPortObj->calcFastestUpdateRate();
+      ecmcAsynPortObj->buildParamWheel();
+      ecmcAsynPortObj->bufferDeferredArrays();
+      ecmcAsynPortObj->startArrayPublisher();
+
+      /** Make all callbacks if data arrived from callback before interrupts
+        were registered (before allowCallbackEpicsState==1)
+        */
+      ecmcAsynPortObj->refreshAllInUseParamsRT();
+    }
 
+    if (iocInitStartTime > 0) {
+      cfgTimingAddPhase("iocInit", iocInitStartTime);
+    }
     break;
 
   default:
@@ -240,6 +276,28 @@ ecmcAsynPortDriver::ecmcAsynPortDriver(
 }
 
 ecmcAsynPortDriver::~ecmcAsynPortDriver() {
+  if (paramPublisherStarted_) {
+    paramPublisherExit_ = true;
+    epicsEventWaitWithTimeout(paramPublisherDoneEvent_, 1.0);
+  }
+
+  if (paramPublisherDoneEvent_) {
+    epicsEventDestroy(paramPublisherDoneEvent_);
+    paramPublisherDoneEvent_ = NULL;
+  }
+  delete deferQueue_;
+  deferQueue_ = NULL;
+
+  if (arrayPublisherStarted_) {
+    arrayPublisherExit_ = true;
+    epicsEventWaitWithTimeout(arrayPublisherDoneEvent_, 1.0);
+  }
+
+  if (arrayPublisherDoneEvent_) {
+    epicsEventDestroy(arrayPublisherDoneEvent_);
+    arrayPublisherDoneEvent_ = NULL;
+  }
+
   delete[] pEcmcParamInUseArray_;
   pEcmcParamInUseArray_ = NULL;
   delete[] pEcmcParamAvailArray_;
@@ -253,6 +311,23 @@ ecmcAsynPortDriver::~ecmcAsynPortDriver() {
  */
 void ecmcAsynPortDriver::initVars() {
   allowRtThreadCom_      = 0;
+  cmdMailbox_            = NULL;
+  paramWheel_            = NULL;
+  paramWheelEnable_      = false;
+  paramsChanged_         = 0;
+  deferredPublish_       = false;
+  deferQueue_            = NULL;
+  callbacksQueued_       = 0;
+  timeStampRTSeq_        = 0;
+  memset(&timeStampRT_, 0, sizeof(timeStampRT_));
+  paramPublisherStarted_ = false;
+  paramPublisherExit_    = false;
+  paramPublisherDoneEvent_ = NULL;
+  arrayBufferedCount_    = 0;
+  arrayPublisherStarted_ = false;
+  arrayPublisherExit_    = false;
+  arrayPublisherDoneEvent_ = NULL;
+  arrayPublishedCount_   = 0;
   pEcmcParamInUseArray_  = NULL;
   pEcmcParamAvailArray_  = NULL;
   ecmcParamInUseCount_   = 0;
@@ -396,6 +471,48 @@ ecmcDataItem * ecmcAsynPortDriver::findAvailDataItem(const char *name) {
   return NULL;
 }
 
+/** Find many emcDataItems by name in one pass\n
+  * \param[in] names Array of parameter names\n
+  * \param[in] count Number of names\n
+  * \param[out] items Array (count elements) of found items (NULL if not found)\n
+  *
+  * returns number of names not found\n
+  * \Note: A name index is built once so that resolving hundreds of names
+  * does not scan the parameter list for each name.
+  **/
+int ecmcAsynPortDriver::findAvailDataItems(const char   **names,
+                                           int            count,
+                                           ecmcDataItem **items) {
+  std::map<std::string, ecmcDataItem *> index;
+
+  for (int i = 0; i < ecmcParamAvailCount_; i++) {
+    if (pEcmcParamAvailArray_[i]) {
+      // keep first match (same as findAvailDataItem())
+      index.insert(std::make_pair(std::string(pEcmcParamAvailArray_[i]->getName()),
+                                  (ecmcDataItem *)pEcmcParamAvailArray_[i]));
+    }
+  }
+
+  int notFound = 0;
+
+  for (int i = 0; i < count; i++) {
+    items[i] = NULL;
+
+    if (names[i]) {
+      std::map<std::string, ecmcDataItem *>::iterator it = index.find(names[i]);
+
+      if (it != index.end()) {
+        items[i] = it->second;
+      }
+    }
+
+    if (!items[i]) {
+      notFound++;
+    }
+  }
+  return notFound;
+}
+
 ecmcAsynDataItem * ecmcAsynPortDriver::addNewAvailParam(const char    *name,
                                                         asynParamType  type,
                                                         uint8_t       *data,
@@ -522,8 +639,10 @@ asynStatus ecmcAsynPortDriver::readOctet(asynUser *pasynUser,
 
   *value = '\0';
 
-  // lock();
-  if (CMDreadIt(value, maxChars)) status = asynError;
+  // Response buffer of this client
+  if (CMDreadItCtx(CMDgetContext(pasynUser), value, maxChars)) {
+    status = asynError;
+  }
 
   if (status == asynSuccess) {
     thisRead = strlen(value);
@@ -554,8 +673,6 @@ asynStatus ecmcAsynPortDriver::readOctet(asynUser *pasynUser,
             thisRead,
             value);
 
-  // unlock();
-
   return status;
 }
 
@@ -584,14 +701,13 @@ asynStatus ecmcAsynPortDriver::writeOctet(asynUser   *pasynUser,
     return asynSuccess;
   }
 
-  // lock();
-  if (!(CMDwriteIt(value, maxChars))) {
+  // Input/response buffers of this client
+  if (!(CMDwriteItCtx(CMDgetContext(pasynUser), value, maxChars))) {
     thisWrite = maxChars;
     *nActual  = thisWrite;
     status    = asynSuccess;
   }
 
-  // unlock();
   asynPrint(pasynUser,
             ASYN_TRACE_FLOW,
             "%s wrote %zu return %s.\n",
@@ -973,6 +1089,360 @@ bool ecmcAsynPortDriver::getAllowRtThreadCom() {
   return allowRtThreadCom_;
 }
 
+void ecmcAsynPortDriver::setCmdMailbox(ecmcCmdMailbox *mailbox) {
+  cmdMailbox_ = mailbox;
+}
+
+ecmcCmdMailbox * ecmcAsynPortDriver::getCmdMailbox() {
+  return cmdMailbox_;
+}
+
+void ecmcAsynPortDriver::setParamWheelEnable(bool enable) {
+  paramWheelEnable_ = enable;
+}
+
+bool ecmcAsynPortDriver::getParamWheelEnable() {
+  return paramWheelEnable_;
+}
+
+/** Build parameter wheel from the linked parameters.
+ * Called when ioc is running (all records linked). Locks the port so the
+ * rt thread is not executing the wheel meanwhile.
+ */
+int ecmcAsynPortDriver::buildParamWheel() {
+  if (!paramWheelEnable_) {
+    return 0;
+  }
+
+  lock();
+
+  if (!paramWheel_) {
+    paramWheel_ = new ecmcAsynParamWheel();
+  }
+
+  int errorCode = paramWheel_->build(pEcmcParamInUseArray_,
+                                     ecmcParamInUseCount_);
+  unlock();
+  return errorCode;
+}
+
+int ecmcAsynPortDriver::executeParamWheel() {
+  if (!paramWheel_) {
+    return 0;
+  }
+  return paramWheel_->execute();
+}
+
+void ecmcAsynPortDriver::printParamWheel() {
+  if (!paramWheel_) {
+    printf("Asyn parameter wheel not in use (enabled=%d).\n",
+           paramWheelEnable_);
+    return;
+  }
+  paramWheel_->printStatus();
+}
+
+void ecmcAsynPortDriver::setParamsChanged() {
+  epicsAtomicSetIntT(&paramsChanged_, 1);
+}
+
+bool ecmcAsynPortDriver::getParamsChanged() {
+  return epicsAtomicGetIntT(&paramsChanged_) != 0;
+}
+
+void ecmcAsynPortDriver::clearParamsChanged() {
+  epicsAtomicSetIntT(&paramsChanged_, 0);
+}
+
+static void ecmcAsynParamPublisherTask(void *arg) {
+  ecmcAsynPortDriver *port = reinterpret_cast<ecmcAsynPortDriver *>(arg);
+
+  port->paramPublisherTask();
+}
+
+static void ecmcAsynDeferredCallbacks(void    *obj,
+                                      uint8_t *data,
+                                      size_t   bytes,
+                                      int      type) {
+  ecmcAsynPortDriver *port = reinterpret_cast<ecmcAsynPortDriver *>(obj);
+
+  port->publishDeferredCallbacks();
+}
+
+/** Defer publication to the param publisher thread.
+ * Used when the rt thread runs without the port lock (command mailbox).
+ * The rt thread (and other non locked owners) then only store the values
+ * and queue the items, the publisher thread writes them to the parameter
+ * library and makes the callbacks with the port locked.
+ * Not in rt. Set before the rt thread is started, cleared after it stopped.
+ */
+int ecmcAsynPortDriver::setDeferredPublish(bool defer) {
+  if (!defer || paramPublisherStarted_) {
+    deferredPublish_ = defer;
+    return 0;
+  }
+
+  // Each item is queued at most once
+  deferQueue_ = new ecmcCmdMailbox(paramTableSize_ +
+                                   ECMC_ASYN_PAR_PUB_QUEUE_EXTRA);
+  paramPublisherDoneEvent_ = epicsEventCreate(epicsEventEmpty);
+
+  if (!paramPublisherDoneEvent_ ||
+      (epicsThreadCreate(ECMC_ASYN_PAR_PUB_THREAD_NAME,
+                         epicsThreadPriorityMedium,
+                         epicsThreadGetStackSize(epicsThreadStackMedium),
+                         ecmcAsynParamPublisherTask,
+                         this) == NULL)) {
+    asynPrint(pasynUserSelf,
+              ASYN_TRACE_ERROR,
+              "%s:%s: ERROR: Failed to create param publisher thread.\n",
+              driverName,
+              "setDeferredPublish");
+    return ERROR_ASYN_DEFER_THREAD_FAIL;
+  }
+
+  paramPublisherStarted_ = true;
+  deferredPublish_       = true;
+
+  // Records already linked (rt started after iocInit)
+  if (epicsState_ >= initHookAfterIocRunning) {
+    bufferDeferredArrays();
+    startArrayPublisher();
+  }
+  return 0;
+}
+
+bool ecmcAsynPortDriver::getDeferredPublish() {
+  return deferredPublish_;
+}
+
+// Any thread
+int ecmcAsynPortDriver::postDeferred(ecmcCmdMailboxFunc func, void *obj) {
+  if (!deferQueue_) {
+    return ERROR_ASYN_PORT_NULL;
+  }
+  return deferQueue_->post(func, obj, NULL, 0, 0);
+}
+
+/** Parameter callbacks from rt.
+ * Made directly (port locked by rt thread) or, if deferred, by the param
+ * publisher thread after the values queued before have been published.
+ */
+asynStatus ecmcAsynPortDriver::callParamCallbacksRT() {
+  if (!deferredPublish_) {
+    return callParamCallbacks(ECMC_ASYN_DEFAULT_LIST, ECMC_ASYN_DEFAULT_ADDR);
+  }
+
+  if (epicsAtomicCmpAndSwapIntT(&callbacksQueued_, 0, 1) != 0) {
+    return asynSuccess;
+  }
+
+  if (postDeferred(ecmcAsynDeferredCallbacks, this)) {
+    epicsAtomicSetIntT(&callbacksQueued_, 0);
+    return asynError;
+  }
+  return asynSuccess;
+}
+
+// Param publisher thread (port locked)
+void ecmcAsynPortDriver::publishDeferredCallbacks() {
+  epicsAtomicSetIntT(&callbacksQueued_, 0);
+  applyTimeStampRT();
+  callParamCallbacks(ECMC_ASYN_DEFAULT_LIST, ECMC_ASYN_DEFAULT_ADDR);
+}
+
+/** Time stamp of the current cycle (rt thread).
+ * Set directly (port locked by rt thread) or, if deferred, stored for the
+ * publisher threads (see applyTimeStampRT()).
+ */
+void ecmcAsynPortDriver::setTimeStampRT(const epicsTimeStamp *timeStamp) {
+  if (!deferredPublish_) {
+    setTimeStamp(timeStamp);
+    return;
+  }
+
+  // Single writer
+  epicsAtomicSetSizeT(&timeStampRTSeq_, timeStampRTSeq_ + 1);
+  epicsAtomicWriteMemoryBarrier();
+  timeStampRT_ = *timeStamp;
+  epicsAtomicWriteMemoryBarrier();
+  epicsAtomicSetSizeT(&timeStampRTSeq_, timeStampRTSeq_ + 1);
+}
+
+// Publisher threads (port locked)
+void ecmcAsynPortDriver::applyTimeStampRT() {
+  if (!deferredPublish_) {
+    return;
+  }
+
+  epicsTimeStamp timeStamp;
+  size_t seq = 0;
+
+  do {
+    seq = epicsAtomicGetSizeT(&timeStampRTSeq_);
+    epicsAtomicReadMemoryBarrier();
+    timeStamp = timeStampRT_;
+    epicsAtomicReadMemoryBarrier();
+  } while ((seq & 1) || (seq != epicsAtomicGetSizeT(&timeStampRTSeq_)));
+
+  setTimeStamp(&timeStamp);
+}
+
+/** Param publisher thread.
+ * Publishes the values queued by the rt thread (port locked).
+ */
+void ecmcAsynPortDriver::paramPublisherTask() {
+  registerHelperThread(ECMC_ASYN_PAR_PUB_THREAD_NAME);
+
+  while (!paramPublisherExit_) {
+    if (deferQueue_->getPending() > 0) {
+      lock();
+      deferQueue_->drainAll();
+      unlock();
+    }
+    epicsThreadSleep(ECMC_ASYN_PAR_PUB_PERIOD_MS / 1000);
+  }
+
+  unregisterHelperThread();
+  epicsEventSignal(paramPublisherDoneEvent_);
+}
+
+static void ecmcAsynArrayPublisherTask(void *arg) {
+  ecmcAsynPortDriver *port = reinterpret_cast<ecmcAsynPortDriver *>(arg);
+
+  port->arrayPublisherTask();
+}
+
+/** Register parameter for publication by the array publisher thread.
+ * Only allowed before the ioc is running.
+ */
+int ecmcAsynPortDriver::addArrayBufferedParam(ecmcAsynDataItem *param) {
+  if (arrayPublisherStarted_) {
+    return ERROR_ASYN_ARRAY_BUFFER_LIST_FULL;
+  }
+
+  if (arrayBufferedCount_ >= ECMC_ASYN_MAX_ARRAY_BUFFERED) {
+    return ERROR_ASYN_ARRAY_BUFFER_LIST_FULL;
+  }
+
+  arrayBufferedParams_[arrayBufferedCount_] = param;
+  arrayBufferedCount_++;
+  return 0;
+}
+
+/** Start array publisher thread (if array buffered parameters exist).
+ * Called when ioc is running (all records linked).
+ */
+int ecmcAsynPortDriver::startArrayPublisher() {
+  if ((arrayBufferedCount_ == 0) || arrayPublisherStarted_) {
+    return 0;
+  }
+
+  arrayPublisherDoneEvent_ = epicsEventCreate(epicsEventEmpty);
+
+  if (!arrayPublisherDoneEvent_ ||
+      (epicsThreadCreate(ECMC_ASYN_ARRAY_PUB_THREAD_NAME,
+                         epicsThreadPriorityMedium,
+                         epicsThreadGetStackSize(epicsThreadStackMedium),
+                         ecmcAsynArrayPublisherTask,
+                         this) == NULL)) {
+    asynPrint(pasynUserSelf,
+              ASYN_TRACE_ERROR,
+              "%s:%s: ERROR: Failed to create array publisher thread.\n",
+              driverName,
+              "startArrayPublisher");
+    return ERROR_ASYN_ARRAY_BUFFER_ALLOC_FAIL;
+  }
+
+  arrayPublisherStarted_ = true;
+  return 0;
+}
+
+/** Array publisher thread.
+ * Polls the array buffers and makes the doCallbacks*Array() calls for new
+ * data. The triple buffer guarantees that the rt thread does not write the
+ * published buffer. The port is locked for each array (time stamp and alarm
+ * status), so a rt thread that takes the port lock waits for at most one
+ * array callback (never with the command mailbox, see setDeferredPublish()).
+ */
+void ecmcAsynPortDriver::arrayPublisherTask() {
+  registerHelperThread(ECMC_ASYN_ARRAY_PUB_THREAD_NAME);
+
+  // Poll at the fastest sample time of the buffered parameters
+  double periodMs = ECMC_ASYN_ARRAY_PUB_MAX_PERIOD_MS;
+
+  for (int i = 0; i < arrayBufferedCount_; i++) {
+    double sampleTimeMs = arrayBufferedParams_[i]->getSampleTimeMs();
+
+    if (sampleTimeMs < periodMs) {
+      periodMs = sampleTimeMs;
+    }
+  }
+
+  if (periodMs < ECMC_ASYN_ARRAY_PUB_MIN_PERIOD_MS) {
+    periodMs = ECMC_ASYN_ARRAY_PUB_MIN_PERIOD_MS;
+  }
+
+  while (!arrayPublisherExit_) {
+    for (int i = 0; i < arrayBufferedCount_; i++) {
+      lock();
+      applyTimeStampRT();
+      if (arrayBufferedParams_[i]->publishArrayBuffer() == 0) {
+        arrayPublishedCount_++;
+      }
+      unlock();
+    }
+    epicsThreadSleep(periodMs / 1000);
+  }
+
+  unregisterHelperThread();
+  epicsEventSignal(arrayPublisherDoneEvent_);
+}
+
+/** Arrays are only published from the array publisher thread when the
+ * publication is deferred (lock free rt thread). Buffer all linked arrays.
+ * Called when ioc is running (all records linked).
+ */
+int ecmcAsynPortDriver::bufferDeferredArrays() {
+  if (!deferredPublish_) {
+    return 0;
+  }
+
+  int errorCode = 0;
+
+  for (int i = 0; i < ecmcParamInUseCount_; i++) {
+    ecmcAsynDataItem *param = pEcmcParamInUseArray_[i];
+
+    if (!param || !param->getParamInfo()->dataIsArray ||
+        !param->linkedToAsynClient() || param->getArrayBuffered()) {
+      continue;
+    }
+
+    errorCode = param->setArrayBuffered(1);
+
+    if (errorCode) {
+      asynPrint(pasynUserSelf,
+                ASYN_TRACE_ERROR,
+                "%s:%s: ERROR: %s not buffered, not published (0x%x).\n",
+                driverName,
+                "bufferDeferredArrays",
+                param->getName(),
+                errorCode);
+    }
+  }
+  return errorCode;
+}
+
+void ecmcAsynPortDriver::printArrayBuffered() {
+  printf("Array buffered parameters (publisher %s):\n",
+         arrayPublisherStarted_ ? "running" : "not started");
+
+  for (int i = 0; i < arrayBufferedCount_; i++) {
+    printf("  %s\n", arrayBufferedParams_[i]->getName());
+  }
+  printf("  published arrays: %" PRIu64 "\n", arrayPublishedCount_);
+}
+
 /** Overrides asynPortDriver::drvUserCreate.
  * This function is called by the asyn-framework for each record that is linked to this asyn port.
  * \param[in] pasynUser Pointer to asyn user structure
@@ -1075,6 +1545,7 @@ asynStatus ecmcAsynPortDriver::drvUserCreate(asynUser    *pasynUser,
       newParam->getParamInfo()->cmdInt64ToFloat64;
     param->getParamInfo()->cmdUint64ToFloat64 =
       newParam->getParamInfo()->cmdUint64ToFloat64;
+    param->syncParamInfo();
 
     // Add parameter to In use list
     status = appendInUseParam(param, 0);
@@ -1221,6 +1692,7 @@ asynStatus ecmcAsynPortDriver::drvUserCreate(asynUser    *pasynUser,
   delete newParam;
 
   existentParInfo->initialized = 1;
+  pEcmcParamInUseArray_[index]->syncParamInfo();
   pEcmcParamInUseArray_[index]->refreshParam(1);
   callParamCallbacks(ECMC_ASYN_DEFAULT_LIST, ECMC_ASYN_DEFAULT_ADDR);
 
@@ -1720,6 +2192,7 @@ static void initCallFunc_2(const iocshArgBuf *args) {
 
 /* EPICS iocsh shell command:  ecmcConfigOrDie*/
 static ecmcOutputBufferType ecmcConfigBuffer;
+
 int ecmcConfigOrDie(const char *ecmcCommand) {
   if (!ecmcAsynPortObj) {
     printf(
@@ -1738,7 +2211,9 @@ int ecmcConfigOrDie(const char *ecmcCommand) {
   ecmcAsynPortObj->lock();
 
   clearBuffer(&ecmcConfigBuffer);
-  int errorCode = motorHandleOneArg(ecmcCommand, &ecmcConfigBuffer);
+  double startTime = cfgTimingNow();
+  int errorCode    = ecmcCmdHandleOneArg(ecmcCommand, &ecmcConfigBuffer);
+  cfgTimingAddCmd(ecmcCommand, startTime);
 
   ecmcAsynPortObj->unlock();
 
@@ -1801,7 +2276,9 @@ int ecmcConfig(const char *ecmcCommand) {
   ecmcAsynPortObj->lock();
 
   clearBuffer(&ecmcConfigBuffer);
-  int errorCode = motorHandleOneArg(ecmcCommand, &ecmcConfigBuffer);
+  double startTime = cfgTimingNow();
+  int errorCode    = ecmcCmdHandleOneArg(ecmcCommand, &ecmcConfigBuffer);
+  cfgTimingAddCmd(ecmcCommand, startTime);
 
   ecmcAsynPortObj->unlock();
 
@@ -35,6 +35,16 @@
 
 #include "ecmcAsynDataItem.h"
 #include "ecmcDefinitions.h"
+#include "ecmcCmdMailbox.h"
+#include "ecmcAsynParamWheel.h"
+
+#define ECMC_ASYN_MAX_ARRAY_BUFFERED 256
+#define ECMC_ASYN_ARRAY_PUB_THREAD_NAME "ecmcAsynArrPub"
+#define ECMC_ASYN_ARRAY_PUB_MIN_PERIOD_MS 1.0
+#define ECMC_ASYN_ARRAY_PUB_MAX_PERIOD_MS 100.0
+#define ECMC_ASYN_PAR_PUB_THREAD_NAME "ecmcAsynParPub"
+#define ECMC_ASYN_PAR_PUB_PERIOD_MS 1.0
+#define ECMC_ASYN_PAR_PUB_QUEUE_EXTRA 64  // Callback requests
 
 class ecmcAsynPortDriver : public asynPortDriver {
 public:
@@ -132,6 +142,32 @@ public:
                                const char *pattern);
   void              setAllowRtThreadCom(bool allowRtCom);
   bool              getAllowRtThreadCom();
+  void              setCmdMailbox(ecmcCmdMailbox *mailbox);
+  ecmcCmdMailbox*   getCmdMailbox();
+  void              setParamWheelEnable(bool enable);
+  bool              getParamWheelEnable();
+  int               buildParamWheel();
+  int               executeParamWheel();
+  void              printParamWheel();
+  void              setParamsChanged();
+  bool              getParamsChanged();
+  void              clearParamsChanged();
+  int               addArrayBufferedParam(ecmcAsynDataItem *param);
+  int               startArrayPublisher();
+  void              arrayPublisherTask();
+  void              printArrayBuffered();
+  int               bufferDeferredArrays();
+
+  // Lock free rt thread: publication by the param publisher thread
+  int               setDeferredPublish(bool defer);
+  bool              getDeferredPublish();
+  int               postDeferred(ecmcCmdMailboxFunc func,
+                                 void              *obj);
+  asynStatus        callParamCallbacksRT();
+  void              publishDeferredCallbacks();
+  void              setTimeStampRT(const epicsTimeStamp *timeStamp);
+  void              applyTimeStampRT();
+  void              paramPublisherTask();
   asynUser*         getTraceAsynUser();
   ecmcAsynDataItem* addNewAvailParam(const char    *name,
                                      asynParamType  type,
@@ -154,6 +190,9 @@ public:
   void              setEpicsState(int state);
 
   ecmcDataItem*     findAvailDataItem(const char *name);
+  int               findAvailDataItems(const char   **names,
+                                       int            count,
+                                       ecmcDataItem **items);
   ecmcAsynDataItem* findAvailParam(const char *name);
   bool              checkParamExist(const char *name);
 
@@ -174,6 +213,24 @@ private:
                                     int               listIndex,
                                     int               details);
   bool allowRtThreadCom_;
+  ecmcCmdMailbox *cmdMailbox_;
+  ecmcAsynParamWheel *paramWheel_;
+  bool paramWheelEnable_;
+  int paramsChanged_;  // epicsAtomic
+  bool deferredPublish_;
+  ecmcCmdMailbox *deferQueue_;
+  int callbacksQueued_;  // epicsAtomic
+  epicsTimeStamp timeStampRT_;  // Written by rt if deferred (see setTimeStampRT())
+  size_t timeStampRTSeq_;  // epicsAtomic, odd while written
+  bool paramPublisherStarted_;
+  volatile bool paramPublisherExit_;
+  epicsEventId paramPublisherDoneEvent_;
+  ecmcAsynDataItem *arrayBufferedParams_[ECMC_ASYN_MAX_ARRAY_BUFFERED];
+  int arrayBufferedCount_;
+  bool arrayPublisherStarted_;
+  volatile bool arrayPublisherExit_;
+  epicsEventId arrayPublisherDoneEvent_;
+  uint64_t arrayPublishedCount_;
   ecmcAsynDataItem **pEcmcParamAvailArray_;
   ecmcAsynDataItem **pEcmcParamInUseArray_;
   int ecmcParamAvailCount_;
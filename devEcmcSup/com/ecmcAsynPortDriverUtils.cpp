@@ -600,6 +600,14 @@ int getAxEncFuncType(char *objPath,
         *objectFunction = ECMC_ENCODER_ENTRY_INDEX_STAT_HOME;
         return 0;
       }
+
+      // timestamp
+      nvals = strcmp(objectFunctionStr, ECMC_ENC_TIMESTAMP_STR);
+
+      if (nvals == 0) {
+        *objectFunction = ECMC_ENCODER_ENTRY_INDEX_TIMESTAMP;
+        return 0;
+      }
     }
   }
 
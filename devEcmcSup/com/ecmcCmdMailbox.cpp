@@ -0,0 +1,273 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcCmdMailbox.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcCmdMailbox.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <epicsAtomic.h>
+#include <epicsThread.h>
+
+enum ecmcCmdMailboxCallState {
+  ECMC_CMD_MAILBOX_CALL_PENDING   = 0,
+  ECMC_CMD_MAILBOX_CALL_RUNNING   = 1,
+  ECMC_CMD_MAILBOX_CALL_DONE      = 2,
+  ECMC_CMD_MAILBOX_CALL_CANCELLED = 3,
+};
+
+// Shared by caller and consumer (freed by the last one, caller may time out)
+struct ecmcCmdMailboxCall {
+  ecmcCmdMailboxCallFunc func;
+  void                  *arg;
+  int                    result;
+  int                    state;  // epicsAtomic
+  int                    refs;   // epicsAtomic
+};
+
+static void releaseCall(ecmcCmdMailboxCall *call) {
+  if (epicsAtomicDecrIntT(&call->refs) == 0) {
+    delete call;
+  }
+}
+
+// Executed by the consumer
+static void executeCall(void    *obj,
+                        uint8_t *data,
+                        size_t   bytes,
+                        int      type) {
+  ecmcCmdMailboxCall *call = (ecmcCmdMailboxCall *)obj;
+
+  if (epicsAtomicCmpAndSwapIntT(&call->state,
+                                ECMC_CMD_MAILBOX_CALL_PENDING,
+                                ECMC_CMD_MAILBOX_CALL_RUNNING) ==
+      ECMC_CMD_MAILBOX_CALL_PENDING) {
+    call->result = call->func(call->arg);
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetIntT(&call->state, ECMC_CMD_MAILBOX_CALL_DONE);
+  }
+  releaseCall(call);
+}
+
+ecmcCmdMailbox::ecmcCmdMailbox(int size) {
+  size_t cells = 2;
+
+  while ((cells < (size_t)size) && (cells < ECMC_CMD_MAILBOX_MAX_SIZE)) {
+    cells <<= 1;
+  }
+
+  size_       = cells;
+  mask_       = cells - 1;
+  cells_      = new ecmcCmdMailboxCell[cells];
+  enqueuePos_ = 0;
+  dequeuePos_ = 0;
+  budget_     = ECMC_CMD_MAILBOX_DEFAULT_BUDGET;
+  posted_     = 0;
+  rejected_   = 0;
+  executed_   = 0;
+  budgetHits_ = 0;
+  maxDepth_   = 0;
+
+  memset(cells_, 0, sizeof(ecmcCmdMailboxCell) * cells);
+
+  for (size_t i = 0; i < cells; i++) {
+    cells_[i].sequence = i;
+  }
+}
+
+ecmcCmdMailbox::~ecmcCmdMailbox() {
+  delete[] cells_;
+}
+
+int ecmcCmdMailbox::post(ecmcCmdMailboxFunc func,
+                         void              *obj,
+                         const uint8_t     *data,
+                         size_t             bytes,
+                         int                type) {
+  if (bytes > ECMC_CMD_MAILBOX_MAX_PAYLOAD) {
+    return ERROR_CMD_MAILBOX_PAYLOAD_TO_LARGE;
+  }
+
+  ecmcCmdMailboxCell *cell = NULL;
+  size_t pos               = epicsAtomicGetSizeT(&enqueuePos_);
+
+  // Reserve a cell
+  for (;;) {
+    cell = &cells_[pos & mask_];
+    size_t seq = epicsAtomicGetSizeT(&cell->sequence);
+    epicsAtomicReadMemoryBarrier();
+    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+    if (diff == 0) {
+      if (epicsAtomicCmpAndSwapSizeT(&enqueuePos_, pos, pos + 1) == pos) {
+        break;
+      }
+      pos = epicsAtomicGetSizeT(&enqueuePos_);
+    } else if (diff < 0) {
+      epicsAtomicIncrSizeT(&rejected_);
+      return ERROR_CMD_MAILBOX_FULL;
+    } else {
+      pos = epicsAtomicGetSizeT(&enqueuePos_);
+    }
+  }
+
+  cell->func  = func;
+  cell->obj   = obj;
+  cell->bytes = bytes;
+  cell->type  = type;
+
+  if (bytes > 0) {
+    memcpy(cell->data, data, bytes);
+  }
+
+  // Publish to consumer
+  epicsAtomicWriteMemoryBarrier();
+  epicsAtomicSetSizeT(&cell->sequence, pos + 1);
+  epicsAtomicIncrSizeT(&posted_);
+  return 0;
+}
+
+int ecmcCmdMailbox::call(ecmcCmdMailboxCallFunc func,
+                         void                  *arg,
+                         double                 timeoutS,
+                         int                   *result) {
+  ecmcCmdMailboxCall *call = new ecmcCmdMailboxCall();
+
+  call->func   = func;
+  call->arg    = arg;
+  call->result = 0;
+  call->state  = ECMC_CMD_MAILBOX_CALL_PENDING;
+  call->refs   = 2;
+
+  int errorCode = post(executeCall, call, NULL, 0, 0);
+
+  if (errorCode) {
+    delete call;
+    return errorCode;
+  }
+
+  double waitS = 0;
+
+  for (;;) {
+    int state = epicsAtomicGetIntT(&call->state);
+
+    if (state == ECMC_CMD_MAILBOX_CALL_DONE) {
+      epicsAtomicReadMemoryBarrier();
+      *result = call->result;
+      break;
+    }
+
+    // Withdraw if not picked up (a running call is always waited for)
+    if ((waitS >= timeoutS) &&
+        (epicsAtomicCmpAndSwapIntT(&call->state,
+                                   ECMC_CMD_MAILBOX_CALL_PENDING,
+                                   ECMC_CMD_MAILBOX_CALL_CANCELLED) ==
+         ECMC_CMD_MAILBOX_CALL_PENDING)) {
+      errorCode = ERROR_CMD_MAILBOX_CALL_TIMEOUT;
+      break;
+    }
+    epicsThreadSleep(ECMC_CMD_MAILBOX_CALL_POLL_S);
+    waitS += ECMC_CMD_MAILBOX_CALL_POLL_S;
+  }
+
+  releaseCall(call);
+  return errorCode;
+}
+
+int ecmcCmdMailbox::drain(int budget) {
+  int count = 0;
+
+  while (count < budget) {
+    ecmcCmdMailboxCell *cell = &cells_[dequeuePos_ & mask_];
+    size_t seq               = epicsAtomicGetSizeT(&cell->sequence);
+
+    if ((intptr_t)seq - (intptr_t)(dequeuePos_ + 1) < 0) {
+      break;  // empty
+    }
+
+    epicsAtomicReadMemoryBarrier();
+    cell->func(cell->obj, cell->data, cell->bytes, cell->type);
+
+    // Release cell to producers
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetSizeT(&cell->sequence, dequeuePos_ + mask_ + 1);
+    dequeuePos_++;
+    count++;
+  }
+
+  if (count) {
+    executed_ += count;
+
+    // Commands left when budget is spent (executed next cycle)
+    size_t depth = epicsAtomicGetSizeT(&enqueuePos_) - dequeuePos_;
+
+    if ((int)(depth + count) > maxDepth_) {
+      maxDepth_ = (int)(depth + count);
+    }
+
+    if ((count >= budget) && depth) {
+      budgetHits_++;
+    }
+  }
+
+  return count;
+}
+
+int ecmcCmdMailbox::drainAll() {
+  return drain((int)size_);
+}
+
+void ecmcCmdMailbox::setBudget(int budget) {
+  budget_ = budget > 0 ? budget : 1;
+}
+
+int ecmcCmdMailbox::getBudget() {
+  return budget_;
+}
+
+int ecmcCmdMailbox::getSize() {
+  return (int)size_;
+}
+
+uint64_t ecmcCmdMailbox::getPosted() {
+  return epicsAtomicGetSizeT(&posted_);
+}
+
+uint64_t ecmcCmdMailbox::getExecuted() {
+  return executed_;
+}
+
+uint64_t ecmcCmdMailbox::getRejected() {
+  return epicsAtomicGetSizeT(&rejected_);
+}
+
+int ecmcCmdMailbox::getPending() {
+  return (int)(epicsAtomicGetSizeT(&enqueuePos_) - dequeuePos_);
+}
+
+uint64_t ecmcCmdMailbox::getBudgetHits() {
+  return budgetHits_;
+}
+
+int ecmcCmdMailbox::getMaxDepth() {
+  return maxDepth_;
+}
+
+void ecmcCmdMailbox::printStatus() {
+  printf("Command mailbox:\n");
+  printf("  size:        %zu\n", size_);
+  printf("  budget:      %d\n", budget_);
+  printf("  posted:      %" PRIu64 "\n", getPosted());
+  printf("  executed:    %" PRIu64 "\n", executed_);
+  printf("  rejected:    %" PRIu64 "\n", getRejected());
+  printf("  budget hits: %" PRIu64 "\n", budgetHits_);
+  printf("  max depth:   %d\n", maxDepth_);
+}
@@ -0,0 +1,111 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcCmdMailbox.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Bounded lock-free multi producer single consumer command queue.
+* Non rt threads (asyn writes) post small commands (function, object and a
+* copy of the data) and the rt thread executes them at a fixed point in the
+* cycle, at most "budget" commands per cycle. Posting never blocks, if the
+* queue is full the command is rejected and counted.
+* Implemented as a ring of cells with sequence numbers (epicsAtomic).
+* call() posts a command and waits until the consumer has executed it
+* (used by writers that need the result or pass data by reference).
+*
+\*************************************************************************/
+
+#ifndef ECMCCMDMAILBOX_H_
+#define ECMCCMDMAILBOX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ERROR_CMD_MAILBOX_FULL 0x221000
+#define ERROR_CMD_MAILBOX_PAYLOAD_TO_LARGE 0x221001
+#define ERROR_CMD_MAILBOX_INVALID_SIZE 0x221002
+#define ERROR_CMD_MAILBOX_INVALID_BUDGET 0x221003
+#define ERROR_CMD_MAILBOX_CALL_TIMEOUT 0x221004
+
+#define ECMC_CMD_MAILBOX_DEFAULT_SIZE 256
+#define ECMC_CMD_MAILBOX_MAX_SIZE 65536
+#define ECMC_CMD_MAILBOX_DEFAULT_BUDGET 32
+#define ECMC_CMD_MAILBOX_MAX_PAYLOAD 64
+#define ECMC_CMD_MAILBOX_CALL_TIMEOUT_S 5.0
+#define ECMC_CMD_MAILBOX_CALL_POLL_S 0.0002
+
+// Executed in rt
+typedef void (*ecmcCmdMailboxFunc)(void    *obj,
+                                   uint8_t *data,
+                                   size_t   bytes,
+                                   int      type);
+
+// Executed by the consumer for call(), return value handed to the caller
+typedef int (*ecmcCmdMailboxCallFunc)(void *arg);
+
+struct ecmcCmdMailboxCell {
+  size_t             sequence;
+  ecmcCmdMailboxFunc func;
+  void              *obj;
+  size_t             bytes;
+  int                type;
+  uint8_t            data[ECMC_CMD_MAILBOX_MAX_PAYLOAD];
+};
+
+class ecmcCmdMailbox {
+public:
+  // size is rounded up to a power of 2
+  explicit ecmcCmdMailbox(int size);
+  ~ecmcCmdMailbox();
+
+  // Any thread. Returns 0 or error code (full, payload to large)
+  int      post(ecmcCmdMailboxFunc func,
+                void              *obj,
+                const uint8_t     *data,
+                size_t             bytes,
+                int                type);
+
+  // Not rt. Post func and wait until executed by the consumer. Returns 0 and
+  // the return value of func in result, or error code (full, timeout). Not
+  // executed if the consumer did not pick it up within timeoutS.
+  int      call(ecmcCmdMailboxCallFunc func,
+                void                  *arg,
+                double                 timeoutS,
+                int                   *result);
+
+  // Single consumer (rt). Returns number of executed commands.
+  int      drain(int budget);
+  int      drainAll();
+
+  void     setBudget(int budget);
+  int      getBudget();
+  int      getSize();
+  uint64_t getPosted();
+  uint64_t getExecuted();
+  uint64_t getRejected();
+  int      getPending();  // Consumer
+  uint64_t getBudgetHits();
+  int      getMaxDepth();
+  void     printStatus();
+
+private:
+  ecmcCmdMailboxCell *cells_;
+  size_t size_;
+  size_t mask_;
+  size_t enqueuePos_;  // shared by producers (epicsAtomic)
+  size_t dequeuePos_;  // consumer only
+  int budget_;
+
+  // Statistics
+  size_t posted_;      // epicsAtomic
+  size_t rejected_;    // epicsAtomic
+  uint64_t executed_;
+  uint64_t budgetHits_;
+  int maxDepth_;
+};
+
+#endif  /* ECMCCMDMAILBOX_H_ */
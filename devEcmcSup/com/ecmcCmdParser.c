@@ -24,6 +24,7 @@
 #include <string.h>
 #include <math.h>
 #include "ecmcCmdParser.h"
+#include "ecmcCmdSnapshot.h"
 #include "ecmcOctetIF.h"
 #include "ecmcMainThread.h"
 #include "ecmcErrorsList.h"
@@ -34,6 +35,9 @@
 #include "ecmcCom.h"
 #include "ecmcPLC.h"
 #include "ecmcPlugin.h"
+#include "ecmcThreadCfg.h"
+#include "ecmcCfgTiming.h"
+#include "ecmcExeOrder.h"
 #include <iocsh.h>
 
 extern int blockCmdParserInRt;
@@ -52,7 +56,8 @@ typedef struct
   double   manualVelocityFast;
 } cmd_Motor_cmd_type;
 
-static cmd_Motor_cmd_type cmd_Motor_cmd[ECMC_MAX_AXES];
+// Covers the full ADS axis index group range (0x4000..0x4FFF)
+static cmd_Motor_cmd_type cmd_Motor_cmd[0x1000];
 static int ecmcInitDone = 0;
 
 extern double mcuFrequency;
@@ -64,7 +69,6 @@ static char cIdBuffer[ECMC_CMD_MAX_SINGLE_CMD_LENGTH];
 static char cIdBuffer2[ECMC_CMD_MAX_SINGLE_CMD_LENGTH];
 static char cIdBuffer3[ECMC_CMD_MAX_SINGLE_CMD_LENGTH];
 static char cPlcExprBuffer[ECMC_CMD_MAX_SINGLE_CMD_LENGTH];
-static char cOneCommand[ECMC_CMD_MAX_SINGLE_CMD_LENGTH];
 
 // TODO: Cleanup macros.. should not need different for different types
 #define SEND_OK_OR_ERROR_AND_RETURN(function)\
@@ -761,6 +765,56 @@ static int handleCfgCommand(const char *myarg_1) {
     return setSamplePeriodMs(dValue);
   }
 
+  /// "Cfg.SetEnableCntrlBatch(enable)"
+  nvals = sscanf(myarg_1, "SetEnableCntrlBatch(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetEnableCntrlBatch");
+    return setEnableCntrlBatch(iValue);
+  }
+
+  /// "Cfg.SetCntrlBatchVerify(verify)"
+  nvals = sscanf(myarg_1, "SetCntrlBatchVerify(%d)", &iValue);
+
+  if (nvals == 1) {
+    return setCntrlBatchVerify(iValue);
+  }
+
+  /*int Cfg.SetAxisFlightRecorderSize(int axis_no, int samples);*/
+  nvals = sscanf(myarg_1,
+                 "SetAxisFlightRecorderSize(%d,%d)",
+                 &iValue,
+                 &iValue2);
+
+  if (nvals == 2) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetAxisFlightRecorderSize");
+    return setAxisFlightRecorderSize(iValue, iValue2);
+  }
+
+  /*int Cfg.SetAxisFlightRecorderPostTrigger(int axis_no, int samples);*/
+  nvals = sscanf(myarg_1,
+                 "SetAxisFlightRecorderPostTrigger(%d,%d)",
+                 &iValue,
+                 &iValue2);
+
+  if (nvals == 2) {
+    return setAxisFlightRecorderPostTrigger(iValue, iValue2);
+  }
+
+  /*int Cfg.ArmAxisFlightRecorder(int axis_no);*/
+  nvals = sscanf(myarg_1, "ArmAxisFlightRecorder(%d)", &iValue);
+
+  if (nvals == 1) {
+    return armAxisFlightRecorder(iValue);
+  }
+
+  /*int Cfg.PrintAxisFlightRecorder(int axis_no);*/
+  nvals = sscanf(myarg_1, "PrintAxisFlightRecorder(%d)", &iValue);
+
+  if (nvals == 1) {
+    return printAxisFlightRecorder(iValue);
+  }
+
   /// "Cfg.SetPVTControllerTrgDurMs(double durationMs)"
   nvals = sscanf(myarg_1, "SetPVTControllerTrgDurMs(%lf)", &dValue);
 
@@ -858,6 +912,101 @@ static int handleCfgCommand(const char *myarg_1) {
     return addAxisToGroupByIndex(iValue,iValue2);
   }
 
+  /// "Cfg.CreateAxisGroupTransform(virtGroupName,realGroupName,type)"
+  cIdBuffer[0]  = '\0';
+  cIdBuffer2[0] = '\0';
+  nvals = sscanf(myarg_1, "CreateAxisGroupTransform(%[^,],%[^,],%d)",
+                 cIdBuffer,
+                 cIdBuffer2,
+                 &iValue);
+  if (nvals == 3) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("CreateAxisGroupTransform");
+    return createAxisGroupTransform(cIdBuffer,cIdBuffer2,iValue);
+  }
+
+  /// "Cfg.SetAxisGroupTransformParam(virtGroupName,index,value)"
+  cIdBuffer[0]  = '\0';
+  nvals = sscanf(myarg_1, "SetAxisGroupTransformParam(%[^,],%d,%lf)",
+                 cIdBuffer,
+                 &iValue,
+                 &dValue);
+  if (nvals == 3) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetAxisGroupTransformParam");
+    return setAxisGroupTransformParam(cIdBuffer,iValue,dValue);
+  }
+
+  /// "Cfg.SetAxisGroupTransformSolver(virtGroupName,maxIterations,tolerance)"
+  cIdBuffer[0]  = '\0';
+  nvals = sscanf(myarg_1, "SetAxisGroupTransformSolver(%[^,],%d,%lf)",
+                 cIdBuffer,
+                 &iValue,
+                 &dValue);
+  if (nvals == 3) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetAxisGroupTransformSolver");
+    return setAxisGroupTransformSolver(cIdBuffer,iValue,dValue);
+  }
+
+  /// "Cfg.PrintAxisGroupTransform(virtGroupName)"
+  cIdBuffer[0]  = '\0';
+  nvals = sscanf(myarg_1, "PrintAxisGroupTransform(%[^)])",
+                 cIdBuffer);
+  if (nvals == 1) {
+    return printAxisGroupTransform(cIdBuffer);
+  }
+
+  /// "Cfg.CreateAxisGear(slaveAxisIndex,masterAxisIndex,masterSource)"
+  nvals = sscanf(myarg_1, "CreateAxisGear(%d,%d,%d)",
+                 &iValue,
+                 &iValue2,
+                 &iValue3);
+  if (nvals == 3) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("CreateAxisGear");
+    return createAxisGear(iValue, iValue2, iValue3);
+  }
+
+  /// "Cfg.SetAxisGearRatio(slaveAxisIndex,ratio)"
+  nvals = sscanf(myarg_1, "SetAxisGearRatio(%d,%lf)", &iValue, &dValue);
+  if (nvals == 2) {
+    return setAxisGearRatio(iValue, dValue);
+  }
+
+  /// "Cfg.SetAxisGearCamLUT(slaveAxisIndex,lutIndex)"
+  nvals = sscanf(myarg_1, "SetAxisGearCamLUT(%d,%d)", &iValue, &iValue2);
+  if (nvals == 2) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetAxisGearCamLUT");
+    return setAxisGearCamLUT(iValue, iValue2);
+  }
+
+  /// "Cfg.SetAxisGearEngageDist(slaveAxisIndex,distance)"
+  nvals = sscanf(myarg_1, "SetAxisGearEngageDist(%d,%lf)", &iValue, &dValue);
+  if (nvals == 2) {
+    return setAxisGearEngageDist(iValue, dValue);
+  }
+
+  /// "Cfg.SetAxisGearPhase(slaveAxisIndex,phase)"
+  nvals = sscanf(myarg_1, "SetAxisGearPhase(%d,%lf)", &iValue, &dValue);
+  if (nvals == 2) {
+    return setAxisGearPhase(iValue, dValue);
+  }
+
+  /// "Cfg.SetAxisGearPhaseVelo(slaveAxisIndex,velocity)"
+  nvals = sscanf(myarg_1, "SetAxisGearPhaseVelo(%d,%lf)", &iValue, &dValue);
+  if (nvals == 2) {
+    return setAxisGearPhaseVelo(iValue, dValue);
+  }
+
+  /// "Cfg.SetAxisGearEngage(slaveAxisIndex,engage)"
+  nvals = sscanf(myarg_1, "SetAxisGearEngage(%d,%d)", &iValue, &iValue2);
+  if (nvals == 2) {
+    return setAxisGearEngage(iValue, iValue2);
+  }
+
+  /// "Cfg.PrintAxisGear(slaveAxisIndex)"
+  nvals = sscanf(myarg_1, "PrintAxisGear(%d)", &iValue);
+  if (nvals == 1) {
+    return printAxisGear(iValue);
+  }
+
   /// "Cfg.CreatePLC(int index, double cycleTimeMs)"
   nvals = sscanf(myarg_1, "CreatePLC(%d,%lf)", &iValue, &dValue);
 
@@ -1799,6 +1948,72 @@ static int handleCfgCommand(const char *myarg_1) {
     return ecSetDelayECOkAtStartup(iValue);
   }
 
+  /*Cfg.EcSetDcDiag(int enable)*/
+  nvals = sscanf(myarg_1, "EcSetDcDiag(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("EcSetDcDiag");
+    return ecSetDcDiag(iValue);
+  }
+
+  /*Cfg.EcSetDcWakeupCtrl(int enable, double phaseUs, double kp, double ki, double maxAdjustUs)*/
+  nvals = sscanf(myarg_1,
+                 "EcSetDcWakeupCtrl(%d,%lf,%lf,%lf,%lf)",
+                 &iValue,
+                 &dValue,
+                 &dValue2,
+                 &dValue3,
+                 &dValue4);
+
+  if (nvals == 5) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("EcSetDcWakeupCtrl");
+    return ecSetDcWakeupCtrl(iValue, dValue, dValue2, dValue3, dValue4);
+  }
+
+  /*Cfg.EcPrintDcDiag()*/
+  if (0 == strcmp(myarg_1, "EcPrintDcDiag()")) {
+    return ecPrintDcDiag();
+  }
+
+  /*Cfg.EcCreateEdgeCapture(int index, int fifoSize)*/
+  nvals = sscanf(myarg_1, "EcCreateEdgeCapture(%d,%d)", &iValue, &iValue2);
+
+  if (nvals == 2) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("EcCreateEdgeCapture");
+    return ecCreateEdgeCapture(iValue, iValue2);
+  }
+
+  /*Cfg.EcAddEdgeCaptureBit(int index, int edges, char *ecPath)*/
+  nvals = sscanf(myarg_1,
+                 "EcAddEdgeCaptureBit(%d,%d,%[^)])",
+                 &iValue,
+                 &iValue2,
+                 cExprBuffer);
+
+  if (nvals == 3) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("EcAddEdgeCaptureBit");
+    return ecAddEdgeCaptureBit(iValue, iValue2, cExprBuffer);
+  }
+
+  /*Cfg.EcAddEdgeCaptureTimestamp(int index, int edge, char *ecPath)*/
+  nvals = sscanf(myarg_1,
+                 "EcAddEdgeCaptureTimestamp(%d,%d,%[^)])",
+                 &iValue,
+                 &iValue2,
+                 cExprBuffer);
+
+  if (nvals == 3) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("EcAddEdgeCaptureTimestamp");
+    return ecAddEdgeCaptureTimestamp(iValue, iValue2, cExprBuffer);
+  }
+
+  /*Cfg.EcPrintEdgeCapture(int index)*/
+  nvals = sscanf(myarg_1, "EcPrintEdgeCapture(%d)", &iValue);
+
+  if (nvals == 1) {
+    return ecPrintEdgeCapture(iValue);
+  }
+
   parse_cfg_axis_commands:
 
   if (cfgFastSetAxisEnc) {
@@ -2925,6 +3140,175 @@ parse_cfg_setaxisdrv:
     return setEnableTimeDiag(iValue);
   }
 
+  /*int Cfg.SetMaxAxes(int count);*/
+  nvals = sscanf(myarg_1, "SetMaxAxes(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetMaxAxes");
+    return setMaxAxes(iValue);
+  }
+
+  /*int Cfg.SetMaxPLCs(int count);*/
+  nvals = sscanf(myarg_1, "SetMaxPLCs(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetMaxPLCs");
+    return setMaxPLCs(iValue);
+  }
+
+  /*int Cfg.SetMaxDataStorages(int count);*/
+  nvals = sscanf(myarg_1, "SetMaxDataStorages(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetMaxDataStorages");
+    return setMaxDataStorages(iValue);
+  }
+
+  /*int Cfg.SetMaxPlugins(int count);*/
+  nvals = sscanf(myarg_1, "SetMaxPlugins(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetMaxPlugins");
+    return setMaxPlugins(iValue);
+  }
+
+  /*int Cfg.SetMaxLuts(int count);*/
+  nvals = sscanf(myarg_1, "SetMaxLuts(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetMaxLuts");
+    return setMaxLuts(iValue);
+  }
+
+  /*int Cfg.SetEnableCmdMailbox(int enable);*/
+  nvals = sscanf(myarg_1, "SetEnableCmdMailbox(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetEnableCmdMailbox");
+    return setEnableCmdMailbox(iValue);
+  }
+
+  /*int Cfg.SetCmdMailboxSize(int size);*/
+  nvals = sscanf(myarg_1, "SetCmdMailboxSize(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetCmdMailboxSize");
+    return setCmdMailboxSize(iValue);
+  }
+
+  /*int Cfg.SetCmdMailboxBudget(int budget);*/
+  nvals = sscanf(myarg_1, "SetCmdMailboxBudget(%d)", &iValue);
+
+  if (nvals == 1) {
+    return setCmdMailboxBudget(iValue);
+  }
+
+  /*int Cfg.SetRtThreadAffinity(char *cpuList);*/
+  nvals = sscanf(myarg_1, "SetRtThreadAffinity(%[^)])", cIdBuffer);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetRtThreadAffinity");
+    return setRtThreadAffinity(cIdBuffer);
+  }
+
+  /*int Cfg.SetRtThreadSchedPolicy(char *policy);*/
+  nvals = sscanf(myarg_1, "SetRtThreadSchedPolicy(%[^)])", cIdBuffer);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetRtThreadSchedPolicy");
+    return setRtThreadSchedPolicy(cIdBuffer);
+  }
+
+  /*int Cfg.SetRtThreadPriority(int priority);*/
+  nvals = sscanf(myarg_1, "SetRtThreadPriority(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetRtThreadPriority");
+    return setRtThreadPriority(iValue);
+  }
+
+  /*int Cfg.SetRtThreadDeadlineRuntimeUs(int runtimeUs);*/
+  nvals = sscanf(myarg_1, "SetRtThreadDeadlineRuntimeUs(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetRtThreadDeadlineRuntimeUs");
+    return setRtThreadDeadlineRuntimeUs(iValue);
+  }
+
+  /*int Cfg.SetHelperThreadAffinity(char *cpuList);*/
+  nvals = sscanf(myarg_1, "SetHelperThreadAffinity(%[^)])", cIdBuffer);
+
+  if (nvals == 1) {
+    return setHelperThreadAffinity(cIdBuffer);
+  }
+
+  /*int Cfg.SetHelperThreadPriority(int priority);*/
+  nvals = sscanf(myarg_1, "SetHelperThreadPriority(%d)", &iValue);
+
+  if (nvals == 1) {
+    return setHelperThreadPriority(iValue);
+  }
+
+  /*int Cfg.PrintRtSystemCheck();*/
+  if (0 == strcmp(myarg_1, "PrintRtSystemCheck()")) {
+    return printRtSystemCheck();
+  }
+
+  /*int Cfg.SetEnableAsynParamWheel(int enable);*/
+  nvals = sscanf(myarg_1, "SetEnableAsynParamWheel(%d)", &iValue);
+
+  if (nvals == 1) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetEnableAsynParamWheel");
+    return setEnableAsynParamWheel(iValue);
+  }
+
+  /*int Cfg.PrintAsynParamWheel();*/
+  if (0 == strcmp(myarg_1, "PrintAsynParamWheel()")) {
+    return printAsynParamWheel();
+  }
+
+  /*int Cfg.SetAsynArrayBuffered(char *paramName, int decimation);*/
+  nvals = sscanf(myarg_1, "SetAsynArrayBuffered(%[^,],%d)", cIdBuffer,
+                 &iValue);
+
+  if (nvals == 2) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetAsynArrayBuffered");
+    return setAsynArrayBuffered(cIdBuffer, iValue);
+  }
+
+  /*int Cfg.PrintAsynArrayBuffered();*/
+  if (0 == strcmp(myarg_1, "PrintAsynArrayBuffered()")) {
+    return printAsynArrayBuffered();
+  }
+
+  /*int Cfg.PrintCfgTimingReport();*/
+  if (0 == strcmp(myarg_1, "PrintCfgTimingReport()")) {
+    return printCfgTimingReport();
+  }
+
+  /*int Cfg.PrintExeOrder();*/
+  if (0 == strcmp(myarg_1, "PrintExeOrder()")) {
+    return printExeOrder();
+  }
+
+  /*int Cfg.SetCmdSnapshotEnable(int enable);*/
+  nvals = sscanf(myarg_1, "SetCmdSnapshotEnable(%d)", &iValue);
+
+  if (nvals == 1) {
+    return setCmdSnapshotEnable(iValue);
+  }
+
+  /*int Cfg.PrintCmdContexts();*/
+  if (0 == strcmp(myarg_1, "PrintCmdContexts()")) {
+    CMDprintContexts();
+    return 0;
+  }
+
+  /*int Cfg.PrintCmdMailboxStatus();*/
+  if (0 == strcmp(myarg_1, "PrintCmdMailboxStatus()")) {
+    return printCmdMailboxStatus();
+  }
+
   /*int Cfg.SetAxisBlockCom(int axis_no, int block);*/
   nvals = sscanf(myarg_1, "SetAxisBlockCom(%d,%d)", &iValue, &iValue2);
 
@@ -3072,6 +3456,17 @@ parse_cfg_setaxisdrv:
       return setAxisEncVelFilterEnable(iValue, iValue2);
     }
 
+    /*int Cfg.SetAxisEncVelEstimator(int axis_no, int type, double timeConstMs);*/
+    nvals = sscanf(myarg_1,
+                   "SetAxisEncVelEstimator(%d,%d,%lf)",
+                   &iValue,
+                   &iValue2,
+                   &dValue);
+
+    if (nvals == 3) {
+      return setAxisEncVelEstimator(iValue, iValue2, dValue);
+    }
+
     /*int Cfg.SetAxisEncPosFilterSize(int axis_no, int size);*/
     nvals = sscanf(myarg_1,
                    "SetAxisEncPosFilterSize(%d,%d)",
@@ -3192,7 +3587,7 @@ parse_cfg_setaxisdrv:
     }
 
     // Axis plcs is indexed "above" normal PLCs in the PLC array
-    return appendPLCExpr(iValue + ECMC_MAX_PLCS, cExprBuffer);
+    return appendPLCExpr(AXIS_PLC_ID_TO_PLC_ID(iValue), cExprBuffer);
   }
 
   /*int Cfg.LoadAxisPLCFile(int index,char *cExpr); */
@@ -3201,7 +3596,7 @@ parse_cfg_setaxisdrv:
   if (nvals == 2) {
     RETURN_ERROR_IF_RUNTIME_CFG_CMD("LoadAxisPLCFile");
     // Axis plcs is indexed "above" normal PLCs in the PLC array
-    return loadPLCFile(iValue + ECMC_MAX_PLCS, cExprBuffer);
+    return loadPLCFile(AXIS_PLC_ID_TO_PLC_ID(iValue), cExprBuffer);
   }
 
   /*int Cfg.LoadPLCFile(int index,char *cExpr); */
@@ -3212,6 +3607,93 @@ parse_cfg_setaxisdrv:
     return loadPLCFile(iValue, cExprBuffer);
   }
 
+  /*int Cfg.LoadPLCFileOnline(int index,char *cExpr); */
+  nvals = sscanf(myarg_1, "LoadPLCFileOnline(%d,%[^)])", &iValue, cExprBuffer);
+
+  if (nvals == 2) {
+    // Before runtime the code is compiled during validation
+    if (appModeStat != ECMC_MODE_RUNTIME) {
+      int errorCode = clearPLCExpr(iValue);
+
+      if (errorCode) {
+        return errorCode;
+      }
+      return loadPLCFile(iValue, cExprBuffer);
+    }
+    return loadPLCFileOnline(iValue, cExprBuffer);
+  }
+
+  /*int Cfg.PrintPLCOnlineChangeStatus();*/
+  if (0 == strcmp(myarg_1, "PrintPLCOnlineChangeStatus()")) {
+    return printPLCOnlineChangeStatus();
+  }
+
+  /*int Cfg.SetPLCTimeBudget(int index, double budgetUs);*/
+  nvals = sscanf(myarg_1, "SetPLCTimeBudget(%d,%lf)", &iValue, &dValue);
+
+  if (nvals == 2) {
+    return setPLCTimeBudget(iValue, dValue);
+  }
+
+  /*int Cfg.SetAxisPLCTimeBudget(int axisIndex, double budgetUs);*/
+  nvals = sscanf(myarg_1, "SetAxisPLCTimeBudget(%d,%lf)", &iValue, &dValue);
+
+  if (nvals == 2) {
+    return setPLCTimeBudget(AXIS_PLC_ID_TO_PLC_ID(iValue), dValue);
+  }
+
+  /*int Cfg.SetPLCBudgetDemotion(int index, int overrunLimit,
+    int skipCycles);*/
+  nvals = sscanf(myarg_1,
+                 "SetPLCBudgetDemotion(%d,%d,%d)",
+                 &iValue,
+                 &iValue2,
+                 &iValue3);
+
+  if (nvals == 3) {
+    return setPLCBudgetDemotion(iValue, iValue2, iValue3);
+  }
+
+  /*int Cfg.SetAxisPLCBudgetDemotion(int axisIndex, int overrunLimit,
+    int skipCycles);*/
+  nvals = sscanf(myarg_1,
+                 "SetAxisPLCBudgetDemotion(%d,%d,%d)",
+                 &iValue,
+                 &iValue2,
+                 &iValue3);
+
+  if (nvals == 3) {
+    return setPLCBudgetDemotion(AXIS_PLC_ID_TO_PLC_ID(iValue),
+                                iValue2,
+                                iValue3);
+  }
+
+  /*int Cfg.PrintPLCProfile();*/
+  if (0 == strcmp(myarg_1, "PrintPLCProfile()")) {
+    return printPLCProfile();
+  }
+
+  /*int Cfg.SetPLCNative(int index, int mode);*/
+  nvals = sscanf(myarg_1, "SetPLCNative(%d,%d)", &iValue, &iValue2);
+
+  if (nvals == 2) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetPLCNative");
+    return setPLCNativeMode(iValue, iValue2);
+  }
+
+  /*int Cfg.SetAxisPLCNative(int axisIndex, int mode);*/
+  nvals = sscanf(myarg_1, "SetAxisPLCNative(%d,%d)", &iValue, &iValue2);
+
+  if (nvals == 2) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetAxisPLCNative");
+    return setPLCNativeMode(AXIS_PLC_ID_TO_PLC_ID(iValue), iValue2);
+  }
+
+  /*int Cfg.PrintPLCNativeStatus();*/
+  if (0 == strcmp(myarg_1, "PrintPLCNativeStatus()")) {
+    return printPLCNativeStatus();
+  }
+
   /*int Cfg.LoadPLCLibFile(int index,char *cExpr); */
   nvals = sscanf(myarg_1, "LoadPLCLibFile(%d,%[^)])", &iValue, cExprBuffer);
 
@@ -3386,6 +3868,36 @@ parse_cfg_setaxisdrv:
     return printStorageBuffer(iValue);
   }
 
+  /*int Cfg.SetDataStorageStream(int indexStorage, int blockSize, int blockCount, char *fileName);*/
+  nvals = sscanf(myarg_1,
+                 "SetDataStorageStream(%d,%d,%d,%[^)])",
+                 &iValue,
+                 &iValue2,
+                 &iValue3,
+                 cExprBuffer);
+
+  if (nvals == 4) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("SetDataStorageStream");
+    return setDataStorageStream(iValue, iValue2, iValue3, cExprBuffer);
+  }
+
+  /*int Cfg.SetDataStorageStreamEnable(int indexStorage, int enable);*/
+  nvals = sscanf(myarg_1,
+                 "SetDataStorageStreamEnable(%d,%d)",
+                 &iValue,
+                 &iValue2);
+
+  if (nvals == 2) {
+    return setDataStorageStreamEnable(iValue, iValue2);
+  }
+
+  /*int Cfg.PrintDataStorageStream(int indexStorage);*/
+  nvals = sscanf(myarg_1, "PrintDataStorageStream(%d)", &iValue);
+
+  if (nvals == 1) {
+    return printDataStorageStream(iValue);
+  }
+
   /*int Cfg.SetDataStorageCurrentDataIndex(0,10)"*/
   nvals = sscanf(myarg_1,
                  "SetDataStorageCurrentDataIndex(%d,%d)",
@@ -3412,6 +3924,68 @@ parse_cfg_setaxisdrv:
     return loadLUT(iValue, cExprBuffer);
   }
 
+  /*int Cfg.CreateCapture(int index, int samples, int preTriggerSamples, int decimation); */
+  nvals = sscanf(myarg_1,
+                 "CreateCapture(%d,%d,%d,%d)",
+                 &iValue,
+                 &iValue2,
+                 &iValue3,
+                 &iValue4);
+
+  if (nvals == 4) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("CreateCapture");
+    return createCapture(iValue, iValue2, iValue3, iValue4);
+  }
+
+  cExprBuffer[0] = '\0';
+  /*int Cfg.AddCaptureChannel(int index, char *dataItemName); */
+  nvals = sscanf(myarg_1, "AddCaptureChannel(%d,%[^)])", &iValue, cExprBuffer);
+
+  if (nvals == 2) {
+    RETURN_ERROR_IF_RUNTIME_CFG_CMD("AddCaptureChannel");
+    return addCaptureChannel(iValue, cExprBuffer);
+  }
+
+  /*int Cfg.SetCaptureTrigger(int index, int channel, int type, double level); */
+  nvals = sscanf(myarg_1,
+                 "SetCaptureTrigger(%d,%d,%d,%lf)",
+                 &iValue,
+                 &iValue2,
+                 &iValue3,
+                 &dValue);
+
+  if (nvals == 4) {
+    return setCaptureTrigger(iValue, iValue2, iValue3, dValue);
+  }
+
+  /*int Cfg.SetCaptureMode(int index, int mode); */
+  nvals = sscanf(myarg_1, "SetCaptureMode(%d,%d)", &iValue, &iValue2);
+
+  if (nvals == 2) {
+    return setCaptureMode(iValue, iValue2);
+  }
+
+  /*int Cfg.ArmCapture(int index); */
+  nvals = sscanf(myarg_1, "ArmCapture(%d)", &iValue);
+
+  if (nvals == 1) {
+    return armCapture(iValue);
+  }
+
+  /*int Cfg.TriggerCapture(int index); */
+  nvals = sscanf(myarg_1, "TriggerCapture(%d)", &iValue);
+
+  if (nvals == 1) {
+    return triggerCapture(iValue);
+  }
+
+  /*int Cfg.PrintCapture(int index); */
+  nvals = sscanf(myarg_1, "PrintCapture(%d)", &iValue);
+
+  if (nvals == 1) {
+    return printCapture(iValue);
+  }
+
   /*int Cfg.IocshCmd=<command string>*/
   nvals = sscanf(myarg_1, "IocshCmd=%[^\n]", cExprBuffer);
 
@@ -3812,12 +4386,6 @@ int motorHandleOneArg(const char *myarg_1, ecmcOutputBufferType *buffer) {
     return ERROR_MAIN_PARSER_CMD_TO_LONG;
   }
 
-  if ((appModeStat == ECMC_MODE_RUNTIME) &&
-      (strncmp(rawCmd, "Cfg.", 4) == 0)) {
-    printf("ecmcCmdParser: %s\n", rawCmd);
-    fflush(stdout);
-  }
-
   /* Main.*/
   if (!strncmp(myarg_1, Main_dot_str, strlen(Main_dot_str))) {
     myarg_1 += strlen(Main_dot_str);
@@ -3905,6 +4473,16 @@ int motorHandleOneArg(const char *myarg_1, ecmcOutputBufferType *buffer) {
     return 0;
   }
 
+  /* GetCntrlBatchVerifyErrors() */
+  if (!strcmp(myarg_1, "GetCntrlBatchVerifyErrors()")) {
+    SEND_RESULT_OR_ERROR_AND_RETURN_UINT64(getCntrlBatchVerifyErrors(&u64Value));
+  }
+
+  /* GetCmdMailboxRejected() */
+  if (!strcmp(myarg_1, "GetCmdMailboxRejected()")) {
+    SEND_RESULT_OR_ERROR_AND_RETURN_UINT64(getCmdMailboxRejected(&u64Value));
+  }
+
   /*ReadEcEntry(int nSlave, int nEntry)*/
   nvals = sscanf(myarg_1, "ReadEcEntry(%d,%d)", &iValue, &iValue2);
 
@@ -5290,6 +5868,24 @@ parse_getaxisdrv:
     SEND_OK_OR_ERROR_AND_RETURN(stopMotion(iValue, 0));
   }
 
+  /*uint64 GetDataStorageStreamWrittenBlocks(int storageIndex)*/
+  nvals = sscanf(myarg_1, "GetDataStorageStreamWrittenBlocks(%d)", &iValue);
+
+  if (nvals == 1) {
+    SEND_RESULT_OR_ERROR_AND_RETURN_UINT64(getDataStorageStreamWrittenBlocks(
+                                             iValue,
+                                             &u64Value));
+  }
+
+  /*uint64 GetDataStorageStreamDroppedBlocks(int storageIndex)*/
+  nvals = sscanf(myarg_1, "GetDataStorageStreamDroppedBlocks(%d)", &iValue);
+
+  if (nvals == 1) {
+    SEND_RESULT_OR_ERROR_AND_RETURN_UINT64(getDataStorageStreamDroppedBlocks(
+                                             iValue,
+                                             &u64Value));
+  }
+
   /*int GetStorageDataIndex(int axis_no)*/
   nvals = sscanf(myarg_1, "GetStorageDataIndex(%d)", &motor_axis_no);
 
@@ -5363,35 +5959,95 @@ parse_getaxisdrv:
   SEND_OK_OR_ERROR_AND_RETURN(ERROR_MAIN_PARSER_UNKOWN_CMD);
 }
 
+/*
+ * Commands executed by the calling thread also when the rt thread runs lock
+ * free (command mailbox): they block (bus access, file access, printouts)
+ * and only read the objects or post the object changes themselves (see
+ * ecmcRTExec()). With or without Cfg. prefix.
+ */
+static const char *const callerThreadCmds[] = {
+  "EcReadSdo(",
+  "EcWriteSdo(",
+  "EcVerifySdo(",
+  "EcReadSoE(",
+  "EcWriteSoE(",
+  "LoadPLCFileOnline(",
+  "Print",
+  "EcPrint",
+  "ReportPlugin(",
+};
+
+static int cmdRunsInCaller(const char *cmd) {
+  size_t i;
+
+  if (!strncmp(cmd, Cfg_dot_str, strlen(Cfg_dot_str))) {
+    cmd += strlen(Cfg_dot_str);
+  }
+
+  for (i = 0; i < sizeof(callerThreadCmds) / sizeof(callerThreadCmds[0]);
+       i++) {
+    if (!strncmp(cmd, callerThreadCmds[i], strlen(callerThreadCmds[i]))) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+typedef struct ecmcCmdOneArgCall {
+  const char           *cmd;
+  ecmcOutputBufferType *buffer;
+} ecmcCmdOneArgCall;
+
+static int cmdOneArgCall(void *arg) {
+  ecmcCmdOneArgCall *call = (ecmcCmdOneArgCall *)arg;
+
+  return motorHandleOneArg(call->cmd, call->buffer);
+}
+
+int ecmcCmdHandleOneArg(const char *cmd, ecmcOutputBufferType *buffer) {
+  if ((appModeStat == ECMC_MODE_RUNTIME) &&
+      (strncmp(cmd, Cfg_dot_str, strlen(Cfg_dot_str)) == 0)) {
+    printf("ecmcCmdParser: %s\n", cmd);
+    fflush(stdout);
+  }
+
+  if (!ecmcRTLockFree() || cmdRunsInCaller(cmd)) {
+    return motorHandleOneArg(cmd, buffer);
+  }
+
+  ecmcCmdOneArgCall call = { cmd, buffer };
+  return ecmcRTExec(cmdOneArgCall, &call);
+}
+
 /*int ecmcCmdParser(int             argc,
             const char           *argv[],
             const char           *sepv[],
             ecmcOutputBufferType *buffer) {*/
-int ecmcCmdParser(const char           *cmdline,
+int ecmcCmdParser(char                 *cmdline,
                   int                   inLen,
                   ecmcOutputBufferType *buffer) {
   int   cmdCounter = 0;
   int   multiCmd   = 0;
   int   done       = 0;
-  char *nextStart  = (char *)cmdline;
+  char *nextStart  = cmdline;
   char *nextEnd    = strchr(nextStart, ';'); // check if multline
 
   if (nextEnd) {
     multiCmd = 1;
   }
-  char *nextCmd = (char *)cmdline;
+  char *nextCmd = cmdline;
 
   while (!done) {
     if (nextEnd) {
-      memcpy(cOneCommand, nextStart, nextEnd - nextStart);
-      cOneCommand[nextEnd - nextStart] = '\0';
-      nextCmd                          = cOneCommand; // Use local buffer
+      // Split in place (cmdline is the input buffer of the client)
+      *nextEnd = '\0';
+      nextCmd  = nextStart;
     } else {   // Only one cmd
       nextCmd  = nextStart;
       multiCmd = 0;
       done     = 1;
     }
-    int errorCode = motorHandleOneArg(nextCmd, buffer);
+    int errorCode = ecmcCmdHandleOneArg(nextCmd, buffer);
     cmdCounter++;
 
     if (errorCode) {
@@ -5407,7 +6063,7 @@ int ecmcCmdParser(const char           *cmdline,
     if (multiCmd) {
       cmd_buf_printf(buffer, "%s", ";");
 
-      if (strlen(nextEnd) > 1) {
+      if (nextEnd[1] != '\0') {
         nextStart = nextEnd + 1;
         nextEnd   = strchr(nextStart, ';'); // check if multline
       } else {
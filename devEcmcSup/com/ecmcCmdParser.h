@@ -23,13 +23,19 @@ extern "C" {
                   const char           *argv[],
                   const char           *seperator[],
                 ecmcOutputBufferType *buffer);*/
-int ecmcCmdParser(const char           *cmdline,
+int ecmcCmdParser(char                 *cmdline,
                   int                   inLen,
                   ecmcOutputBufferType *buffer);
 
 int motorHandleOneArg(const char           *myarg_1,
                       ecmcOutputBufferType *buffer);
 
+/* Handle one command. If the rt thread runs lock free (command mailbox) the
+ * command is executed by the rt thread, except blocking commands (bus and
+ * file access, printouts) that are executed by the caller. */
+int ecmcCmdHandleOneArg(const char           *cmd,
+                        ecmcOutputBufferType *buffer);
+
 # ifdef __cplusplus
 }
 # endif /* ifdef __cplusplus */
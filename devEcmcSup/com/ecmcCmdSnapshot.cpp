@@ -0,0 +1,522 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcCmdSnapshot.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcCmdSnapshot.h"
+#include <stdio.h>
+#include <string.h>
+#include <epicsAtomic.h>
+#include "ecmcAxisBase.h"
+#include "ecmcGeneral.h"
+
+enum ecmcCmdSnapshotField {
+  ECMC_CMD_SNAP_STATUS = 0,
+  ECMC_CMD_SNAP_BUSY,
+  ECMC_CMD_SNAP_ERROR,
+  ECMC_CMD_SNAP_ERROR_ID,
+  ECMC_CMD_SNAP_ERROR_MSG,
+  ECMC_CMD_SNAP_ENABLE,
+  ECMC_CMD_SNAP_ENABLED,
+  ECMC_CMD_SNAP_EXECUTE,
+  ECMC_CMD_SNAP_RESET,
+  ECMC_CMD_SNAP_HOME_SENSOR,
+  ECMC_CMD_SNAP_LIMIT_BWD,
+  ECMC_CMD_SNAP_LIMIT_FWD,
+  ECMC_CMD_SNAP_HOMED,
+  ECMC_CMD_SNAP_DONE,
+  ECMC_CMD_SNAP_ACT_POS,
+  ECMC_CMD_SNAP_ACT_VEL,
+  ECMC_CMD_SNAP_TARGET_VEL,
+  ECMC_CMD_SNAP_TARGET_POS,
+  ECMC_CMD_SNAP_COMMAND,
+  ECMC_CMD_SNAP_CMD_DATA,
+  ECMC_CMD_SNAP_ACC,
+  ECMC_CMD_SNAP_DEC,
+  ECMC_CMD_SNAP_CNTRL_ERROR,
+};
+
+struct ecmcCmdSnapshotName {
+  const char *name;
+  int         field;
+};
+
+// "Main.M<n>.<name>"
+static const ecmcCmdSnapshotName mainNames[] = {
+  { "stAxisStatus?",  ECMC_CMD_SNAP_STATUS      },
+  { "bBusy?",         ECMC_CMD_SNAP_BUSY        },
+  { "bError?",        ECMC_CMD_SNAP_ERROR       },
+  { "nErrorId?",      ECMC_CMD_SNAP_ERROR_ID    },
+  { "sErrorMessage?", ECMC_CMD_SNAP_ERROR_MSG   },
+  { "bEnable?",       ECMC_CMD_SNAP_ENABLE      },
+  { "bEnabled?",      ECMC_CMD_SNAP_ENABLED     },
+  { "bExecute?",      ECMC_CMD_SNAP_EXECUTE     },
+  { "bReset?",        ECMC_CMD_SNAP_RESET       },
+  { "bHomeSensor?",   ECMC_CMD_SNAP_HOME_SENSOR },
+  { "bLimitBwd?",     ECMC_CMD_SNAP_LIMIT_BWD   },
+  { "bLimitFwd?",     ECMC_CMD_SNAP_LIMIT_FWD   },
+  { "bHomed?",        ECMC_CMD_SNAP_HOMED       },
+  { "bDone?",         ECMC_CMD_SNAP_DONE        },
+  { "fActPosition?",  ECMC_CMD_SNAP_ACT_POS     },
+  { "fActVelocity?",  ECMC_CMD_SNAP_ACT_VEL     },
+  { "fVelocity?",     ECMC_CMD_SNAP_TARGET_VEL  },
+  { "fPosition?",     ECMC_CMD_SNAP_TARGET_POS  },
+  { "nCommand?",      ECMC_CMD_SNAP_COMMAND     },
+  { "nCmdData?",      ECMC_CMD_SNAP_CMD_DATA    },
+  { "fAcceleration?", ECMC_CMD_SNAP_ACC         },
+  { "fDeceleration?", ECMC_CMD_SNAP_DEC         },
+};
+
+// "<name>(<n>)"
+static const ecmcCmdSnapshotName getAxisNames[] = {
+  { "GetAxisAtHardBwd",  ECMC_CMD_SNAP_LIMIT_BWD   },
+  { "GetAxisAtHardFwd",  ECMC_CMD_SNAP_LIMIT_FWD   },
+  { "GetAxisAtHome",     ECMC_CMD_SNAP_HOME_SENSOR },
+  { "GetAxisCntrlError", ECMC_CMD_SNAP_CNTRL_ERROR },
+  { "GetAxisEncPosAct",  ECMC_CMD_SNAP_ACT_POS     },
+  { "GetAxisEncVelAct",  ECMC_CMD_SNAP_ACT_VEL     },
+  { "GetAxisVel",        ECMC_CMD_SNAP_TARGET_VEL  },
+  { "GetAxisAcc",        ECMC_CMD_SNAP_ACC         },
+  { "GetAxisDec",        ECMC_CMD_SNAP_DEC         },
+};
+
+struct ecmcCmdAxisSnapshot {
+  int    seq;    // Odd while written by rt (epicsAtomic)
+  int    valid;
+  int    gen;    // writeGen when published
+  int    enable;
+  int    enabled;
+  int    execute;
+  int    reset;
+  int    command;
+  int    cmdData;
+  int    atHardFwd;
+  int    atHardBwd;
+  int    atHome;
+  int    error;
+  int    errorId;
+  int    homed;
+  int    busy;
+  int    done;
+  double targetVel;
+  double targetPos;
+  double acc;
+  double dec;
+  double actPos;
+  double actVel;
+  double cntrlError;
+};
+
+static ecmcCmdAxisSnapshot snapshots[ECMC_CMD_SNAPSHOT_MAX_AXES];
+static int snapshotEnable = 1;
+
+// Incremented when a (possibly) writing command line is done. A snapshot
+// published before is stale, the parser serves the axis until republished.
+static int writeGen = 0;
+
+void ecmcCmdSnapshotPublish(ecmcAxisBase *axis) {
+  if (!snapshotEnable || !axis) {
+    return;
+  }
+
+  const int index = axis->getAxisID();
+
+  if ((index < 0) || (index >= ECMC_CMD_SNAPSHOT_MAX_AXES)) {
+    return;
+  }
+
+  ecmcCmdAxisSnapshot *s = &snapshots[index];
+
+  epicsAtomicIncrIntT(&s->seq);
+  epicsAtomicWriteMemoryBarrier();
+
+  s->valid = 0;
+  s->gen   = epicsAtomicGetIntT(&writeGen);
+
+  if (axis->getSeq() && axis->getTraj() && axis->getMon()) {
+    bool homed = false;
+    int  errorCode = axis->getPosAct(&s->actPos);
+    errorCode = errorCode || axis->getVelAct(&s->actVel);
+    errorCode = errorCode || axis->getPosSet(&s->targetPos);
+    errorCode = errorCode || axis->getCntrlError(&s->cntrlError);
+    errorCode = errorCode || axis->getAxisHomed(&homed);
+
+    s->enable    = axis->getEnable() > 0;
+    s->enabled   = axis->getEnabled() > 0;
+    s->execute   = axis->getExecute() > 0;
+    s->reset     = axis->getReset() > 0;
+    s->command   = static_cast<int>(axis->getSeq()->getCommand());
+    s->cmdData   = axis->getSeq()->getCmdData();
+    s->targetVel = axis->getSeq()->getTargetVel();
+    s->done      = !axis->getSeq()->getBusy();
+    s->acc       = axis->getTraj()->getAcc();
+    s->dec       = axis->getTraj()->getDec();
+    s->atHardFwd = axis->getMon()->getHardLimitFwd() > 0;
+    s->atHardBwd = axis->getMon()->getHardLimitBwd() > 0;
+    s->atHome    = axis->getMon()->getHomeSwitch() > 0;
+    s->error     = axis->getError();
+    s->errorId   = axis->getErrorID();
+    s->homed     = homed;
+    s->busy      = axis->getBusy() > 0;
+
+    // Getter errors are reported by the parser
+    s->valid = !errorCode;
+  }
+
+  epicsAtomicWriteMemoryBarrier();
+  epicsAtomicIncrIntT(&s->seq);
+}
+
+void ecmcCmdSnapshotInvalidate(void) {
+  for (int i = 0; i < ECMC_CMD_SNAPSHOT_MAX_AXES; i++) {
+    epicsAtomicIncrIntT(&snapshots[i].seq);
+    epicsAtomicWriteMemoryBarrier();
+    snapshots[i].valid = 0;
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicIncrIntT(&snapshots[i].seq);
+  }
+}
+
+int setCmdSnapshotEnable(int enable) {
+  snapshotEnable = enable;
+
+  if (!enable) {
+    ecmcCmdSnapshotInvalidate();
+  }
+  return 0;
+}
+
+/* Consistent copy of the snapshot of one axis (seqlock read) */
+static int readSnapshot(int axis, ecmcCmdAxisSnapshot *copy) {
+  if ((axis < 0) || (axis >= ECMC_CMD_SNAPSHOT_MAX_AXES)) {
+    return 0;
+  }
+
+  const ecmcCmdAxisSnapshot *s = &snapshots[axis];
+
+  for (int i = 0; i < ECMC_CMD_SNAPSHOT_READ_RETRIES; i++) {
+    const int seq = epicsAtomicGetIntT(&s->seq);
+
+    if (seq & 1) {
+      continue;
+    }
+    epicsAtomicReadMemoryBarrier();
+    memcpy(copy, s, sizeof(*copy));
+    epicsAtomicReadMemoryBarrier();
+
+    if (epicsAtomicGetIntT(&s->seq) == seq) {
+      return copy->valid && (copy->gen == epicsAtomicGetIntT(&writeGen));
+    }
+  }
+  return 0;
+}
+
+static int lookupName(const ecmcCmdSnapshotName *names,
+                      size_t                     count,
+                      const char                *name,
+                      size_t                     len) {
+  for (size_t i = 0; i < count; i++) {
+    if ((strlen(names[i].name) == len) &&
+        !strncmp(names[i].name, name, len)) {
+      return names[i].field;
+    }
+  }
+  return -1;
+}
+
+/* One command (without ";"). Returns 1 if covered by the snapshot. */
+static int parseCmd(const char *cmd, size_t len, int *axis, int *field) {
+  char buffer[ECMC_CMD_MAX_SINGLE_CMD_LENGTH];
+  int  consumed = 0;
+
+  if (len >= sizeof(buffer)) {
+    return 0;
+  }
+  memcpy(buffer, cmd, len);
+  buffer[len] = '\0';
+
+  const char *arg = buffer;
+
+  /* ADSPORT=<port>/ (not .ADR commands) */
+  if (!strncmp(arg, "ADSPORT=", 8)) {
+    arg = strchr(arg, '/');
+
+    if (!arg) {
+      return 0;
+    }
+    arg++;
+  }
+
+  /* Main.M<n>.<name> */
+  if ((sscanf(arg, "Main.M%d.%n", axis, &consumed) == 1) && consumed) {
+    arg   += consumed;
+    *field = lookupName(mainNames,
+                        sizeof(mainNames) / sizeof(mainNames[0]),
+                        arg,
+                        strlen(arg));
+
+    // Axis 0 is not served by the parser either
+    return *field >= 0 && *axis > 0;
+  }
+
+  /* GetAxis<name>(<n>) */
+  if (strncmp(arg, "GetAxis", 7)) {
+    return 0;
+  }
+
+  const char *bracket = strchr(arg, '(');
+
+  if (!bracket) {
+    return 0;
+  }
+  *field = lookupName(getAxisNames,
+                      sizeof(getAxisNames) / sizeof(getAxisNames[0]),
+                      arg,
+                      bracket - arg);
+  consumed = 0;
+
+  if ((*field < 0) ||
+      (sscanf(bracket, "(%d)%n", axis, &consumed) != 1) ||
+      (bracket[consumed] != '\0')) {
+    return 0;
+  }
+  return 1;
+}
+
+static void printField(ecmcOutputBufferType      *buffer,
+                       int                        axis,
+                       int                        field,
+                       const ecmcCmdAxisSnapshot *s) {
+  switch (field) {
+  case ECMC_CMD_SNAP_STATUS:
+    // Same format as the parser
+    cmd_buf_printf(buffer, "Main.M%d.stAxisStatus="
+                           "%d,%d,%d,%u,%u,%g,%g,%g,%g,%d,"
+                           "%d,%d,%d,%g,%d,%d,%d,%u,%g,%g,%g,%d,%d",
+                   axis,
+                   s->enabled,
+                   0,
+                   s->execute,
+                   (unsigned)s->command,
+                   (unsigned)s->cmdData,
+                   s->targetVel,
+                   s->targetPos,
+                   s->acc,
+                   s->dec,
+                   0,
+                   0,
+                   s->atHardFwd,
+                   s->atHardBwd,
+                   100.0,
+                   s->atHome,
+                   s->enabled,
+                   s->error,
+                   (unsigned)s->errorId,
+                   s->actVel,
+                   s->actPos,
+                   s->cntrlError,
+                   s->homed,
+                   s->busy);
+    break;
+
+  case ECMC_CMD_SNAP_BUSY:
+    cmd_buf_printf(buffer, "%d", s->busy);
+    break;
+
+  case ECMC_CMD_SNAP_ERROR:
+    cmd_buf_printf(buffer, "%d", s->error);
+    break;
+
+  case ECMC_CMD_SNAP_ERROR_ID:
+    cmd_buf_printf(buffer, "%d", s->errorId);
+    break;
+
+  case ECMC_CMD_SNAP_ERROR_MSG:
+    cmd_buf_printf(buffer, "%s", getErrorString(s->errorId));
+    break;
+
+  case ECMC_CMD_SNAP_ENABLE:
+    cmd_buf_printf(buffer, "%d", s->enable);
+    break;
+
+  case ECMC_CMD_SNAP_ENABLED:
+    cmd_buf_printf(buffer, "%d", s->enabled);
+    break;
+
+  case ECMC_CMD_SNAP_EXECUTE:
+    cmd_buf_printf(buffer, "%d", s->execute);
+    break;
+
+  case ECMC_CMD_SNAP_RESET:
+    cmd_buf_printf(buffer, "%d", s->reset);
+    break;
+
+  case ECMC_CMD_SNAP_HOME_SENSOR:
+    cmd_buf_printf(buffer, "%d", s->atHome);
+    break;
+
+  case ECMC_CMD_SNAP_LIMIT_BWD:
+    cmd_buf_printf(buffer, "%d", s->atHardBwd);
+    break;
+
+  case ECMC_CMD_SNAP_LIMIT_FWD:
+    cmd_buf_printf(buffer, "%d", s->atHardFwd);
+    break;
+
+  case ECMC_CMD_SNAP_HOMED:
+    cmd_buf_printf(buffer, "%d", s->homed);
+    break;
+
+  case ECMC_CMD_SNAP_DONE:
+    cmd_buf_printf(buffer, "%d", s->done);
+    break;
+
+  case ECMC_CMD_SNAP_ACT_POS:
+    cmd_buf_printf(buffer, "%lf", s->actPos);
+    break;
+
+  case ECMC_CMD_SNAP_ACT_VEL:
+    cmd_buf_printf(buffer, "%lf", s->actVel);
+    break;
+
+  case ECMC_CMD_SNAP_TARGET_VEL:
+    cmd_buf_printf(buffer, "%lf", s->targetVel);
+    break;
+
+  case ECMC_CMD_SNAP_TARGET_POS:
+    cmd_buf_printf(buffer, "%lf", s->targetPos);
+    break;
+
+  case ECMC_CMD_SNAP_COMMAND:
+    cmd_buf_printf(buffer, "%d", s->command);
+    break;
+
+  case ECMC_CMD_SNAP_CMD_DATA:
+    cmd_buf_printf(buffer, "%d", s->cmdData);
+    break;
+
+  case ECMC_CMD_SNAP_ACC:
+    cmd_buf_printf(buffer, "%lf", s->acc);
+    break;
+
+  case ECMC_CMD_SNAP_DEC:
+    cmd_buf_printf(buffer, "%lf", s->dec);
+    break;
+
+  case ECMC_CMD_SNAP_CNTRL_ERROR:
+    cmd_buf_printf(buffer, "%lf", s->cntrlError);
+    break;
+  }
+}
+
+/* Query: "<name>?" or "Get<name>(..)" (optional "Cfg."/"Main." prefix) */
+static int isQuery(const char *cmd, size_t len) {
+  while (len && (cmd[len - 1] == ' ')) {
+    len--;
+  }
+
+  if (len && (cmd[len - 1] == '?')) {
+    return 1;
+  }
+
+  const char *slash = (const char *)memchr(cmd, '/', len);
+
+  if (slash && !strncmp(cmd, "ADSPORT=", 8)) {
+    len -= slash + 1 - cmd;
+    cmd  = slash + 1;
+  }
+
+  static const char *prefixes[] = { "Cfg.", "Main." };
+
+  for (size_t i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); i++) {
+    size_t prefixLen = strlen(prefixes[i]);
+
+    if ((len > prefixLen) && !strncmp(cmd, prefixes[i], prefixLen)) {
+      cmd += prefixLen;
+      len -= prefixLen;
+      break;
+    }
+  }
+  return (len > 3) && !strncmp(cmd, "Get", 3) && memchr(cmd, '(', len);
+}
+
+int ecmcCmdSnapshotIsWrite(const char *cmdline) {
+  if (!cmdline) {
+    return 0;
+  }
+
+  const char *start = cmdline;
+
+  while (*start) {
+    const char *end = strchr(start, ';');
+    size_t len      = end ? (size_t)(end - start) : strlen(start);
+
+    if (len && !isQuery(start, len)) {
+      return 1;
+    }
+
+    if (!end) {
+      break;
+    }
+    start = end + 1;
+  }
+  return 0;
+}
+
+void ecmcCmdSnapshotWriteDone(void) {
+  epicsAtomicIncrIntT(&writeGen);
+}
+
+int ecmcCmdSnapshotHandle(const char           *cmdline,
+                          ecmcOutputBufferType *buffer) {
+  if (!snapshotEnable || !cmdline || !buffer) {
+    return 0;
+  }
+
+  ecmcCmdAxisSnapshot copies[ECMC_CMD_SNAPSHOT_MAX_CMDS];
+  int  axes[ECMC_CMD_SNAPSHOT_MAX_CMDS];
+  int  fields[ECMC_CMD_SNAPSHOT_MAX_CMDS];
+  bool terminated[ECMC_CMD_SNAPSHOT_MAX_CMDS];
+  int  count        = 0;
+  const char *start = cmdline;
+
+  // All commands must be covered, otherwise the parser handles the line
+  while (*start) {
+    const char *end = strchr(start, ';');
+    size_t len      = end ? (size_t)(end - start) : strlen(start);
+
+    if ((count >= ECMC_CMD_SNAPSHOT_MAX_CMDS) ||
+        !parseCmd(start, len, &axes[count], &fields[count]) ||
+        !readSnapshot(axes[count], &copies[count])) {
+      return 0;
+    }
+    terminated[count] = end != NULL;
+    count++;
+
+    if (!end) {
+      break;
+    }
+    start = end + 1;
+  }
+
+  if (count == 0) {
+    return 0;
+  }
+
+  // Respond like the parser (";" after each command terminated by ";")
+  for (int i = 0; i < count; i++) {
+    printField(buffer, axes[i], fields[i], &copies[i]);
+
+    if (terminated[i]) {
+      cmd_buf_printf(buffer, "%s", ";");
+    }
+  }
+  return 1;
+}
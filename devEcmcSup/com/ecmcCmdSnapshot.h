@@ -0,0 +1,87 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcCmdSnapshot.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Snapshot of axis status for command clients. The rt thread publishes the
+* status of one axis per cycle (round robin over the active axes) into a
+* per axis record guarded by a sequence counter. Read only status queries
+* ("Main.M<n>.<field>?" and the corresponding "GetAxis*(<n>)") are served
+* from the snapshot by the octet interface, without the command parser and
+* without touching the axis objects. Queries that are not covered, or axes
+* without a valid snapshot, fall back to the command parser.
+* After a command line that can write (not only queries) all snapshots are
+* stale until republished by the rt thread, so a query after a write is
+* served by the parser (read after write consistent).
+* The octet interface still runs in the port thread with the port locked.
+*
+\*************************************************************************/
+
+#ifndef ECMC_CMD_SNAPSHOT_H_
+#define ECMC_CMD_SNAPSHOT_H_
+
+#include "ecmcOctetIF.h"
+
+#define ECMC_CMD_SNAPSHOT_MAX_AXES 128
+#define ECMC_CMD_SNAPSHOT_READ_RETRIES 8
+#define ECMC_CMD_SNAPSHOT_MAX_CMDS 16  // Per command line
+
+#ifdef __cplusplus
+class ecmcAxisBase;
+
+// Rt
+void ecmcCmdSnapshotPublish(ecmcAxisBase *axis);
+
+extern "C" {
+#endif  // ifdef __cplusplus
+
+/** \brief Serve a command line from the axis status snapshot.\n
+ *
+ * All commands of the line (";" separated) must be covered by the
+ * snapshot, otherwise nothing is written to the buffer.\n
+ *
+ * \param[in] cmdline Command line.\n
+ * \param[out] buffer Response buffer.\n
+ *
+ * \return 1 if served, 0 if the command parser is needed.\n
+ */
+int ecmcCmdSnapshotHandle(const char           *cmdline,
+                          ecmcOutputBufferType *buffer);
+
+/** \brief Check if a command line can write (not only queries).\n
+ *
+ * \param[in] cmdline Command line (before parsed).\n
+ *
+ * \return 1 if any command is not a query ("<name>?" or "Get<name>()").\n
+ */
+int ecmcCmdSnapshotIsWrite(const char *cmdline);
+
+/** \brief A writing command line is done, all snapshots are stale.\n
+ */
+void ecmcCmdSnapshotWriteDone(void);
+
+/** \brief Invalidate the snapshot of all axes (rt thread stopped).\n
+ */
+void ecmcCmdSnapshotInvalidate(void);
+
+/** \brief Enable serving of status queries from the snapshot.\n
+ *
+ * \param[in] enable Enable (default 1).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Serve all status queries by the command parser.\n
+ *  "Cfg.SetCmdSnapshotEnable(0)" //Command string to ecmcCmdParser.c\n
+ */
+int setCmdSnapshotEnable(int enable);
+
+#ifdef __cplusplus
+}
+#endif  // ifdef __cplusplus
+
+#endif  /* ECMC_CMD_SNAPSHOT_H_ */
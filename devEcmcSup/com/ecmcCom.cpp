@@ -16,6 +16,7 @@
 #include "ecmcErrorsList.h"
 #include "ecmcDefinitions.h"
 #include "ecmcMainThread.h"
+#include "ecmcThreadCfg.h"
 #include <sys/ipc.h>
 #include <sys/shm.h>
 #include <unistd.h>
@@ -53,10 +54,13 @@ static void ecmcSigIntHandler(int signum) {
 }
 
 static void ecmcShutdownTask(void *arg) {
+  registerHelperThread("ecmcSigMon");
+
   while (1) {
     if (ecmcShutdownRequested) {
       int signum = ecmcShutdownRequested;
       ecmcShutdownRequested = 0;
+      unregisterHelperThread();
       ecmcCleanup(signum);
       return;
     }
@@ -328,23 +332,33 @@ void ecmcCleanup(int signum) {
   delete plcs;
   plcs = NULL;
 
-  for (int i = 0; i < ECMC_MAX_DATA_STORAGE_OBJECTS; i++) {
+  for (int i = 0; i < dataStorages.size(); i++) {
     delete dataStorages[i];
-    dataStorages[i] = NULL;
   }
+  dataStorages.clear();
 
-  for (int i = 0; i < ECMC_MAX_PLUGINS; i++) {
+  for (int i = 0; i < plugins.size(); i++) {
     if (plugins[i]) {
       plugins[i]->exeDestructFunc();
     }
     delete plugins[i];
-    plugins[i] = NULL;
   }
+  plugins.clear();
 
-  for (int i = 0; i < ECMC_MAX_LUTS; i++) {
+  for (int i = 0; i < luts.size(); i++) {
     delete luts[i];
-    luts[i] = NULL;
   }
+  luts.clear();
+
+  for (int i = 0; i < captures.size(); i++) {
+    delete captures[i];
+  }
+  captures.clear();
+
+  for (int i = 0; i < edgeCaptures.size(); i++) {
+    delete edgeCaptures[i];
+  }
+  edgeCaptures.clear();
 
   if (shmObj.valid) {
     // detach from shared memory
@@ -424,6 +438,7 @@ int ecmcAddDefaultAsynParams() {
     return ERROR_MAIN_ASYN_CREATE_PARAM_FAIL;
   }
   paramTemp->setAllowWriteToEcmc(false);
+  paramTemp->setAllowScheduler(false);  // Min/max reset when refreshed
   paramTemp->refreshParam(1);
   mainAsynParams[ECMC_ASYN_MAIN_PAR_LATENCY_MIN_ID] = paramTemp;
 
@@ -446,6 +461,7 @@ int ecmcAddDefaultAsynParams() {
     return ERROR_MAIN_ASYN_CREATE_PARAM_FAIL;
   }
   paramTemp->setAllowWriteToEcmc(false);
+  paramTemp->setAllowScheduler(false);  // Min/max reset when refreshed
   paramTemp->refreshParam(1);
   mainAsynParams[ECMC_ASYN_MAIN_PAR_LATENCY_MAX_ID] = paramTemp;
 
@@ -468,6 +484,7 @@ int ecmcAddDefaultAsynParams() {
     return ERROR_MAIN_ASYN_CREATE_PARAM_FAIL;
   }
   paramTemp->setAllowWriteToEcmc(false);
+  paramTemp->setAllowScheduler(false);  // Min/max reset when refreshed
   paramTemp->refreshParam(1);
   mainAsynParams[ECMC_ASYN_MAIN_PAR_PERIOD_MIN_ID] = paramTemp;
 
@@ -490,6 +507,7 @@ int ecmcAddDefaultAsynParams() {
     return ERROR_MAIN_ASYN_CREATE_PARAM_FAIL;
   }
   paramTemp->setAllowWriteToEcmc(false);
+  paramTemp->setAllowScheduler(false);  // Min/max reset when refreshed
   paramTemp->refreshParam(1);
   mainAsynParams[ECMC_ASYN_MAIN_PAR_PERIOD_MAX_ID] = paramTemp;
 
@@ -512,6 +530,7 @@ int ecmcAddDefaultAsynParams() {
     return ERROR_MAIN_ASYN_CREATE_PARAM_FAIL;
   }
   paramTemp->setAllowWriteToEcmc(false);
+  paramTemp->setAllowScheduler(false);  // Min/max reset when refreshed
   paramTemp->refreshParam(1);
   mainAsynParams[ECMC_ASYN_MAIN_PAR_EXECUTE_MIN_ID] = paramTemp;
 
@@ -534,6 +553,7 @@ int ecmcAddDefaultAsynParams() {
     return ERROR_MAIN_ASYN_CREATE_PARAM_FAIL;
   }
   paramTemp->setAllowWriteToEcmc(false);
+  paramTemp->setAllowScheduler(false);  // Min/max reset when refreshed
   paramTemp->refreshParam(1);
   mainAsynParams[ECMC_ASYN_MAIN_PAR_EXECUTE_MAX_ID] = paramTemp;
 
@@ -556,6 +576,7 @@ int ecmcAddDefaultAsynParams() {
     return ERROR_MAIN_ASYN_CREATE_PARAM_FAIL;
   }
   paramTemp->setAllowWriteToEcmc(false);
+  paramTemp->setAllowScheduler(false);  // Min/max reset when refreshed
   paramTemp->refreshParam(1);
   mainAsynParams[ECMC_ASYN_MAIN_PAR_SEND_MIN_ID] = paramTemp;
 
@@ -578,6 +599,7 @@ int ecmcAddDefaultAsynParams() {
     return ERROR_MAIN_ASYN_CREATE_PARAM_FAIL;
   }
   paramTemp->setAllowWriteToEcmc(false);
+  paramTemp->setAllowScheduler(false);  // Min/max reset when refreshed
   paramTemp->refreshParam(1);
   mainAsynParams[ECMC_ASYN_MAIN_PAR_SEND_MAX_ID] = paramTemp;
 
@@ -12,15 +12,14 @@
 
 #include "ecmcDataItem.h"
 #include "string.h"
+#include <epicsAtomic.h>
 
 ecmcDataItem::ecmcDataItem(const char *name) {
   memset(&dataItem_, 0, sizeof(dataItem_));
-
-  for (int i = 0; i < ECMC_DATA_ITEM_MAX_CALLBACK_FUNCS; ++i) {
-    callbackFuncs_[i] = NULL;
-    callbackObjs_[i]  = NULL;
-  }
+  callbacks_                 = NULL;
   callbackFuncsMaxIndex_     = -1;
+  updateSeq_                 = 0;
+  updateSeqPolled_           = false;
   checkIntRange_             = 0;
   intMax_                    = 0;
   intMin_                    = 0;
@@ -32,6 +31,7 @@ ecmcDataItem::ecmcDataItem(const char *name) {
 
 ecmcDataItem::~ecmcDataItem() {
   free(dataItem_.name);
+  delete callbacks_;
 }
 
 void ecmcDataItem::setEcmcMaxValueInt(int64_t intMax) {
@@ -125,15 +125,20 @@ size_t ecmcDataItem::getEcmcDataMaxSize() {
 }
 
 void ecmcDataItem::refresh() {
+  // polling subscribers
+  // Data written before the new sequence number is visible (single writer)
+  epicsAtomicWriteMemoryBarrier();
+  epicsAtomicSetSizeT(&updateSeq_, updateSeq_ + 1);
+
   // call callbacks to subscribers here
   const int maxCallbackIndex = callbackFuncsMaxIndex_;
   for (int i = 0; i <= maxCallbackIndex; ++i) {
-    ecmcDataUpdatedCallback callback = callbackFuncs_[i];
+    ecmcDataUpdatedCallback callback = callbacks_->funcs[i];
     if (callback) {
       callback(dataItem_.data,
                         dataItem_.dataSize,
                         dataItem_.dataType,
-                        callbackObjs_[i]);
+                        callbacks_->objs[i]);
     }
   }
 }
@@ -160,11 +165,16 @@ int ecmcDataItem::read(uint8_t *data,
 */
 int ecmcDataItem::regDataUpdatedCallback(ecmcDataUpdatedCallback func,
                                          void                   *callingObj) {
+  // Most items have no subscribers so allocate on first registration
+  if (!callbacks_) {
+    callbacks_ = new ecmcDataItemCallbacks();
+  }
+
   // Add to first avilable element
   for (int i = 0; i < ECMC_DATA_ITEM_MAX_CALLBACK_FUNCS; ++i) {
-    if (!callbackFuncs_[i]) {
-      callbackFuncs_[i] = func;
-      callbackObjs_[i]  = callingObj;
+    if (!callbacks_->funcs[i]) {
+      callbacks_->objs[i]  = callingObj;
+      callbacks_->funcs[i] = func;
 
       if (i > callbackFuncsMaxIndex_) {
         callbackFuncsMaxIndex_ = i;
@@ -181,19 +191,20 @@ int ecmcDataItem::regDataUpdatedCallback(ecmcDataUpdatedCallback func,
 * (retuned by regDataUpdatedCallback())
 */
 void ecmcDataItem::deregDataUpdatedCallback(int handle) {
-  if ((handle < 0) || (handle >= ECMC_DATA_ITEM_MAX_CALLBACK_FUNCS)) {
+  if ((handle < 0) || (handle >= ECMC_DATA_ITEM_MAX_CALLBACK_FUNCS) ||
+      !callbacks_) {
     return;
   }
 
-  if (callbackFuncs_[handle]) {
-    callbackFuncs_[handle] = NULL;
-    callbackObjs_[handle]  = NULL;
+  if (callbacks_->funcs[handle]) {
+    callbacks_->funcs[handle] = NULL;
+    callbacks_->objs[handle]  = NULL;
   }
 
   // find highest assigned index (update callbackFuncsMaxIndex_)
   callbackFuncsMaxIndex_ = -1;
   for (int i = 0; i < ECMC_DATA_ITEM_MAX_CALLBACK_FUNCS; ++i) {
-    if (callbackFuncs_[i]) {
+    if (callbacks_->funcs[i]) {
       callbackFuncsMaxIndex_ = i;
     }
   }
@@ -203,6 +214,19 @@ bool ecmcDataItem::hasDataUpdatedCallbacks() const {
   return callbackFuncsMaxIndex_ >= 0;
 }
 
+size_t ecmcDataItem::getUpdateSeq() const {
+  return epicsAtomicGetSizeT(&updateSeq_);
+}
+
+bool ecmcDataItem::hasSubscribers() const {
+  return callbackFuncsMaxIndex_ >= 0 || updateSeqPolled_;
+}
+
+const size_t * ecmcDataItem::getUpdateSeqPtr() const {
+  updateSeqPolled_ = true;
+  return &updateSeq_;
+}
+
 char * ecmcDataItem::getDataPtr() {
   return (char *)dataItem_.data;
 }
@@ -48,6 +48,12 @@ typedef void (*ecmcDataUpdatedCallback)(uint8_t *,
                                         ecmcEcDataType,
                                         void *);
 
+// Subscribers of a data item (see regDataUpdatedCallback())
+struct ecmcDataItemCallbacks {
+  ecmcDataUpdatedCallback funcs[ECMC_DATA_ITEM_MAX_CALLBACK_FUNCS];
+  void                   *objs[ECMC_DATA_ITEM_MAX_CALLBACK_FUNCS];
+};
+
 /**
 *  Class for generic access to all registered data items in ecmc (base class to asynDataItem).
 *  All ecmc related information is handled in this class. All asyn related
@@ -102,19 +108,32 @@ public:
   void         deregDataUpdatedCallback(int handle);
   bool         hasDataUpdatedCallbacks() const;
 
+  /** Callbacks registered or update sequence handed out (polling) */
+  bool         hasSubscribers() const;
+
+  /** Update sequence number, incremented each time refresh() is called.
+  *   Allows polling clients (plugins) to detect new data without callbacks.
+  *   Written with epicsAtomic (write barrier before), read with
+  *   epicsAtomicGetSizeT() followed by epicsAtomicReadMemoryBarrier() */
+  size_t                   getUpdateSeq() const;
+  const size_t*            getUpdateSeqPtr() const;
+
 protected:
   virtual void refresh();
 
+  // Hot (accessed in each refresh)
   ecmcDataItemInfo dataItem_;
-  int checkIntRange_;
+  size_t updateSeq_;  // epicsAtomic (rt -> plugins)
+  int callbackFuncsMaxIndex_;
   int arrayCheckSize_;
-  int64_t intMax_;
-  int64_t intMin_;
   size_t ecmcMaxSize_;
 
-  ecmcDataUpdatedCallback callbackFuncs_[ECMC_DATA_ITEM_MAX_CALLBACK_FUNCS];
-  void *callbackObjs_[ECMC_DATA_ITEM_MAX_CALLBACK_FUNCS];
-  int callbackFuncsMaxIndex_;
+  // Cold
+  ecmcDataItemCallbacks *callbacks_;  // Allocated at first registration
+  mutable bool updateSeqPolled_;  // Set by getUpdateSeqPtr()
+  int checkIntRange_;
+  int64_t intMax_;
+  int64_t intMin_;
 };
 
 #endif  /* ECMCDATAITEM_H_ */
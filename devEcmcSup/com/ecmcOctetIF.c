@@ -16,19 +16,31 @@
 #include <stdlib.h>
 #include <stdarg.h>
 
+#include <epicsMutex.h>
+#include <epicsThread.h>
+
 #include "ecmcOctetIF.h"
 #include "ecmcCmdParser.h"
+#include "ecmcCmdSnapshot.h"
+#include "ecmcMainThread.h"
 #include "ecmcErrorsList.h"
 
 unsigned int debug_print_flags      = 0; // 65535;
 unsigned int die_on_error_flags     = 1;
 unsigned int argv0_semicolon_is_sep = 0;
 
-static ecmcOutputBufferType outputBuffer =
-{ .bufferSize = ECMC_CMD_BUFFER_SIZE, .bytesUsed = 0 };
-static int initDone = 0;
+struct ecmcCmdContext {
+  const void          *owner;      // asynUser of client, NULL = shared
+  unsigned long        cmdCount;
+  char                 inputBuffer[ECMC_CMD_BUFFER_SIZE];
+  ecmcOutputBufferType outputBuffer;
+};
 
-static char inputBuffer[ECMC_CMD_BUFFER_SIZE] = { 0 };
+static ecmcCmdContext  sharedContext;
+static ecmcCmdContext *contexts[ECMC_CMD_MAX_CONTEXTS] = { 0 };
+static epicsMutexId    contextLock = NULL;
+static unsigned long   contextsRejected = 0;
+static epicsThreadOnceId initOnce = EPICS_THREAD_ONCE_INIT;
 
 /*****************************************************************************/
 
@@ -100,14 +112,96 @@ int clearBuffer(ecmcOutputBufferType *buffer) {
 /*****************************************************************************/
 
 static ecmcOutputBufferType* getEpicsBuffer() {
-  return &outputBuffer;
+  return &sharedContext.outputBuffer;
 }
 
 /*****************************************************************************/
 
-void init() {
+static void initOnceFunc(void *arg) {
   clearBuffer(getEpicsBuffer());
-  initDone = 1;
+  contextLock = epicsMutexMustCreate();
+}
+
+void init() {
+  epicsThreadOnce(&initOnce, initOnceFunc, NULL);
+}
+
+/*****************************************************************************/
+
+/* Context of a client (asynUser). Allocated at first use, owned by the
+ * client for good (never taken over). NULL if all contexts are owned. */
+ecmcCmdContext* CMDgetContext(const void *owner) {
+  ecmcCmdContext *ctx   = NULL;
+  int             freeSlot = -1;
+  int             i;
+
+  init();
+
+  if (!owner) {
+    return &sharedContext;
+  }
+
+  epicsMutexLock(contextLock);
+
+  for (i = 0; i < ECMC_CMD_MAX_CONTEXTS; i++) {
+    if (!contexts[i]) {
+      if (freeSlot < 0) {
+        freeSlot = i;
+      }
+      continue;
+    }
+
+    if (contexts[i]->owner == owner) {
+      ctx = contexts[i];
+      break;
+    }
+  }
+
+  if (!ctx && (freeSlot >= 0)) {
+    ctx = (ecmcCmdContext *)calloc(1, sizeof(ecmcCmdContext));
+
+    if (ctx) {
+      ctx->owner         = owner;
+      contexts[freeSlot] = ctx;
+    }
+  }
+
+  // Rejected, reported once (see CMDprintContexts())
+  if (!ctx && (contextsRejected++ == 0)) {
+    LOGERR("%s/%s:%d: ERROR: No free command context (max %d clients), command rejected.\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           ECMC_CMD_MAX_CONTEXTS);
+  }
+  epicsMutexUnlock(contextLock);
+  return ctx;
+}
+
+/*****************************************************************************/
+
+void CMDprintContexts(void) {
+  int i;
+
+  init();
+  epicsMutexLock(contextLock);
+  printf("Command contexts (max %d, rejected commands %lu):\n",
+         ECMC_CMD_MAX_CONTEXTS,
+         contextsRejected);
+  printf("  shared: commands %lu, pending response bytes %d\n",
+         sharedContext.cmdCount,
+         sharedContext.outputBuffer.bytesUsed);
+
+  for (i = 0; i < ECMC_CMD_MAX_CONTEXTS; i++) {
+    if (contexts[i]) {
+      printf("  %2d: client %p, commands %lu, pending response bytes %d\n",
+             i,
+             contexts[i]->owner,
+             contexts[i]->cmdCount,
+             contexts[i]->outputBuffer.bytesUsed);
+    }
+  }
+  epicsMutexUnlock(contextLock);
 }
 
 /*****************************************************************************/
@@ -144,12 +238,26 @@ void cmd_dump_to_std(const char *buf, unsigned len) {
 
 /* from EPICS into MCU */
 int CMDwriteIt(const char *inbuf, size_t inlen) {
+  return CMDwriteItCtx(CMDgetContext(NULL), inbuf, inlen);
+}
+
+/* from MCU into EPICS */
+int CMDreadIt(char *outbuf, size_t outlen) {
+  return CMDreadItCtx(CMDgetContext(NULL), outbuf, outlen);
+}
+
+/*
+ * Commands handled by the parser are serialized by the caller (asyn port
+ * lock, also taken by the rt thread). If the rt thread runs lock free
+ * (command mailbox) each command is executed by the rt thread instead,
+ * except blocking ones (see ecmcCmdHandleOneArg()). Read only status
+ * queries are served from the axis status snapshot without the parser.
+ */
+static int writeItCtx(ecmcCmdContext *ctx, const char *inbuf, size_t inlen) {
   int had_cr = 0;
   int had_lf = 0;
-
-  if (!initDone) {
-    init();
-  }
+  char *inputBuffer = ctx->inputBuffer;
+  ecmcOutputBufferType *outputBuffer = &ctx->outputBuffer;
 
   if (!inbuf || !inlen) return -1;
 
@@ -171,8 +279,10 @@ int CMDwriteIt(const char *inbuf, size_t inlen) {
 
   int copyLength = inlen + 1;
 
-  // Work with local input buffer
-  memcpy(inputBuffer, inbuf, copyLength);
+  // Work with input buffer of client
+  memcpy(inputBuffer, inbuf, inlen);
+  inputBuffer[inlen] = '\0';
+  ctx->cmdCount++;
 
   // Check LF and or CR
   if ((inlen > 1) && (inputBuffer[inlen - 1] == '\n')) {
@@ -187,10 +297,21 @@ int CMDwriteIt(const char *inbuf, size_t inlen) {
     }
   }
 
-  int errorCode = ecmcCmdParser(inputBuffer, inlen, getEpicsBuffer());
+  int errorCode = 0;
+
+  if (!ecmcCmdSnapshotHandle(inputBuffer, outputBuffer)) {
+    // Before parsed (split in place)
+    int write = ecmcCmdSnapshotIsWrite(inputBuffer);
+
+    errorCode = ecmcCmdParser(inputBuffer, inlen, outputBuffer);
+
+    if (write) {
+      ecmcCmdSnapshotWriteDone();
+    }
+  }
 
   if (errorCode) {
-    RETURN_ERROR_OR_DIE(getEpicsBuffer(),
+    RETURN_ERROR_OR_DIE(outputBuffer,
                         __LINE__,
                         "%s/%s:%d ecmcCmdParser returned error: %x.",
                         __FILE__,
@@ -202,13 +323,13 @@ int CMDwriteIt(const char *inbuf, size_t inlen) {
   // clear buffer
   memset(inputBuffer, 0, copyLength);
 
-  errorCode = cmd_buf_printf(getEpicsBuffer(),
+  errorCode = cmd_buf_printf(outputBuffer,
                              "%s%s",
                              had_cr ? "\r" : "",
                              had_lf ? "\n" : "");
 
   if (errorCode) {
-    RETURN_ERROR_OR_DIE(getEpicsBuffer(),
+    RETURN_ERROR_OR_DIE(outputBuffer,
                         __LINE__,
                         "%s/%s:%d cmd_buf_printf returned error: %x.",
                         __FILE__,
@@ -220,18 +341,25 @@ int CMDwriteIt(const char *inbuf, size_t inlen) {
   return 0;
 }
 
-/* from MCU into EPICS */
-int CMDreadIt(char *outbuf, size_t outlen) {
+int CMDwriteItCtx(ecmcCmdContext *ctx, const char *inbuf, size_t inlen) {
+  if (!ctx) return -1;
+
+  return writeItCtx(ctx, inbuf, inlen);
+}
+
+int CMDreadItCtx(ecmcCmdContext *ctx, char *outbuf, size_t outlen) {
   int ret;
 
-  if (!outbuf || !outlen) return -1;
+  if (!ctx || !outbuf || !outlen) return -1;
+
+  ecmcOutputBufferType *outputBuffer = &ctx->outputBuffer;
 
   // snprintf size must match the actual destination buffer size.
-  ret = snprintf(outbuf, outlen, "%s", getEpicsBuffer()->buffer);
+  ret = snprintf(outbuf, outlen, "%s", outputBuffer->buffer);
 
   if (ret < 0) {
     // printf("RET <0");
-    clearBuffer(getEpicsBuffer());
+    clearBuffer(outputBuffer);
     return ret;
   }
 
@@ -244,7 +372,7 @@ int CMDreadIt(char *outbuf, size_t outlen) {
   if (ret >= (int)outlen) {
     ret = (int)outlen - 1;  // snprintf writes at most outlen-1 chars.
   }
-  removeFromBuffer(getEpicsBuffer(), ret);
+  removeFromBuffer(outputBuffer, ret);
 
   if (PRINT_STDOUT_BIT1() && stdout) {
     fprintf(stdout, "%s/%s:%d OUT2=\"", __FILE__, __FUNCTION__, __LINE__);
@@ -255,17 +255,38 @@ typedef struct {
   char buffer[ECMC_CMD_BUFFER_SIZE];
 } ecmcOutputBufferType;
 
+/*
+ * Command context of one client (asynUser). Each client has its own input
+ * and output buffer so that responses of different clients are not mixed.
+ * Contexts are allocated at first use and kept by the client. If all
+ * contexts are owned, commands of further clients are rejected
+ * (CMDgetContext() returns NULL). The commands are still executed one at
+ * a time by the port thread.
+ */
+# define ECMC_CMD_MAX_CONTEXTS 32
+
+typedef struct ecmcCmdContext ecmcCmdContext;
+
 /*
  * Interface from EPICS to the Motion Controller:
  * Send a command in, and get the response text in outbuf
  * The function returns normally 0.
  * If not, something serious went wrong.
+ * CMDwriteIt()/CMDreadIt() use the shared context.
  */
 
 extern int  CMDwriteIt(const char *inbuf,
                        size_t      inlen);
 extern int  CMDreadIt(char  *outbuf,
                       size_t outlen);
+extern ecmcCmdContext* CMDgetContext(const void *owner);
+extern int  CMDwriteItCtx(ecmcCmdContext *ctx,
+                          const char     *inbuf,
+                          size_t          inlen);
+extern int  CMDreadItCtx(ecmcCmdContext *ctx,
+                         char           *outbuf,
+                         size_t          outlen);
+extern void CMDprintContexts(void);
 extern void cmd_dump_to_std(const char *buf,
                             unsigned    len);
 extern int  clearBuffer(ecmcOutputBufferType *buffer);
@@ -16,6 +16,8 @@
 #include <string>
 #include "ecmcErrorsList.h"
 
+extern double mcuPeriod;
+
 ecmcEc::ecmcEc(ecmcAsynPortDriver *asynPortDriver) {
   initVars();
   setErrorID(ERROR_EC_STATUS_NOT_OK);
@@ -45,6 +47,9 @@ void ecmcEc::initVars() {
   startupCounter_        = 0;
   domainCounter_         = 0;
   allowOffline_          = 0;
+  dcDiag_                = NULL;
+  dcDiagEnable_          = false;
+  lastAppTimeNs_         = 0;
   epicsTimeGetCurrent(&epicsTime_);
   clock_gettime(CLOCK_REALTIME, &timeRel_);
   clock_gettime(CLOCK_REALTIME, &timeAbs_);
@@ -153,6 +158,9 @@ ecmcEc::~ecmcEc() {
     ecAsynParams_[i] = NULL;
   }
 
+  delete dcDiag_;
+  dcDiag_ = NULL;
+
   if (master_) {
     ecrt_release_master(master_);
   }
@@ -194,6 +202,9 @@ int ecmcEc::addSlave(
                                                  position,
                                                  vendorId,
                                                  productCode);
+
+    // Keep first slave if position is used more than once
+    slaveIndexByPosition_.emplace(position, slaveCounter_);
     slaveCounter_++;
 
     ecAsynParams_[ECMC_ASYN_EC_PAR_SLAVE_COUNT_ID]->refreshParam(1);
@@ -264,6 +275,15 @@ int ecmcEc::activate() {
                       ERROR_EC_MAIN_MASTER_ACTIVATE_FAILED);
   }
 
+  // SYNC0 grid starts at the application time set before activation
+  if (dcDiag_) {
+    ec_master_info_t masterInfo;
+
+    if (ecrt_master(master_, &masterInfo) == 0) {
+      dcDiag_->setStartTime(masterInfo.app_time);
+    }
+  }
+
   LOGINFO5("%s/%s:%d: INFO: Writing process data offsets to entries.\n",
            __FILE__,
            __FUNCTION__,
@@ -553,22 +573,38 @@ void ecmcEc::send(timespec timeOffset) {
     domains_[i]->queue();
   }
 
+  // Reference clock time of last cycle vs last application time
+  if (dcDiagEnable_) {
+    dcDiag_->execute(lastAppTimeNs_);
+  }
+
   if (useClockRealtime_) {
     clock_gettime(CLOCK_REALTIME, &timeAbs_);
   } else {
     clock_gettime(CLOCK_MONOTONIC, &timeRel_);
     timeAbs_ = timespecAdd(timeRel_, timeOffset_);
   }
+  addDcTimeCorr(&timeAbs_);
+
+  lastAppTimeNs_ = TIMESPEC2NS(timeAbs_);
+  ecrt_master_application_time(master_, lastAppTimeNs_);
 
-  ecrt_master_application_time(master_, TIMESPEC2NS(timeAbs_));
-  ecrt_master_sync_reference_clock(master_);
+  // With wakeup control the master follows the reference clock instead
+  // (application time steered to the reference clock, addDcTimeCorr())
+  if (!dcDiagEnable_ || !dcDiag_->getWakeupCtrlEnable()) {
+    ecrt_master_sync_reference_clock(master_);
+  }
   ecrt_master_sync_slave_clocks(master_);
 
   ecrt_master_send(master_);
 
+  if (dcDiagEnable_) {
+    dcDiag_->updateAsyn(0);
+  }
+
   // Update asyn time
   epicsTimeFromTimespec(&epicsTime_, &timeAbs_);
-  asynPortDriver_->setTimeStamp(&epicsTime_);
+  asynPortDriver_->setTimeStampRT(&epicsTime_);
 
   // Delay ecOK at startup for delayEcOKCycles_ after ecOK
   if (inStartupPhase_) {
@@ -1008,15 +1044,13 @@ ecmcEcSlave * ecmcEc::findSlave(int busPosition) {
     return simSlave_;
   }
 
-  for (int i = 0; i < slaveCounter_; i++) {
-    ecmcEcSlave * const slave = slaveArray_[i];
-    if (slave != NULL) {
-      if (slave->getSlaveBusPosition() == busPosition) {
-        return slave;
-      }
-    }
+  std::unordered_map<int, int>::const_iterator it =
+    slaveIndexByPosition_.find(busPosition);
+
+  if (it == slaveIndexByPosition_.end()) {
+    return NULL;
   }
-  return NULL;
+  return slaveArray_[it->second];
 }
 
 int ecmcEc::findSlaveIndex(int busPosition, int *slaveIndex) {
@@ -1025,14 +1059,12 @@ int ecmcEc::findSlaveIndex(int busPosition, int *slaveIndex) {
     return 0;
   }
 
-  for (int i = 0; i < slaveCounter_; i++) {
-    ecmcEcSlave * const slave = slaveArray_[i];
-    if (slave != NULL) {
-      if (slave->getSlaveBusPosition() == busPosition) {
-        *slaveIndex = i;
-        return 0;
-      }
-    }
+  std::unordered_map<int, int>::const_iterator it =
+    slaveIndexByPosition_.find(busPosition);
+
+  if (it != slaveIndexByPosition_.end()) {
+    *slaveIndex = it->second;
+    return 0;
   }
   LOGERR("%s/%s:%d: ERROR: Slave NULL (0x%x).\n",
          __FILE__,
@@ -1097,6 +1129,28 @@ int ecmcEc::reset() {
   return 0;
 }
 
+// Application time correction of the wakeup control (see ecmcEcDcDiag)
+void ecmcEc::addDcTimeCorr(timespec *time) {
+  int64_t corrNs = dcDiagEnable_ ? dcDiag_->getTimeCorrNs() : 0;
+
+  if (!corrNs) {
+    return;
+  }
+
+  int64_t nsec = (int64_t)time->tv_nsec + corrNs % MCU_NSEC_PER_SEC;
+
+  time->tv_sec += corrNs / MCU_NSEC_PER_SEC;
+
+  if (nsec >= MCU_NSEC_PER_SEC) {
+    nsec -= MCU_NSEC_PER_SEC;
+    time->tv_sec++;
+  } else if (nsec < 0) {
+    nsec += MCU_NSEC_PER_SEC;
+    time->tv_sec--;
+  }
+  time->tv_nsec = nsec;
+}
+
 timespec ecmcEc::timespecAdd(timespec time1, timespec time2) {
   timespec result;
 
@@ -1178,6 +1232,7 @@ int ecmcEc::addMemMap(uint16_t       startEntryBusPosition,
     return setErrorID(__FILE__, __FUNCTION__, __LINE__, ERROR_EC_MEM_MAP_NULL);
   }
 
+  memMapIndexById_.emplace(memMapIDString, ecMemMapArrayCounter_);
   ecMemMapArrayCounter_++;
   if (direction == EC_DIR_INPUT) {
     ecMemMapRtInput_[ecMemMapRtInputCounter_] =
@@ -1253,31 +1308,22 @@ int ecmcEc::addDataItem(uint16_t       startEntryBusPosition,
 }
 
 ecmcEcMemMap * ecmcEc::findMemMap(std::string name) {
-  ecmcEcMemMap *temp = NULL;
+  int index = findMemMapId(name);
 
-  for (int i = 0; i < ecMemMapArrayCounter_; i++) {
-    if (ecMemMapArray_[i]) {
-      if (ecMemMapArray_[i]->getIdentificationName().compare(name) == 0) {
-        temp = ecMemMapArray_[i];
-        break;
-      }
-    }
+  if (index < 0) {
+    return NULL;
   }
-  return temp;
+  return ecMemMapArray_[index];
 }
 
 int ecmcEc::findMemMapId(std::string name) {
-  int temp = -1;
+  std::unordered_map<std::string, int>::const_iterator it =
+    memMapIndexById_.find(name);
 
-  for (int i = 0; i < ecMemMapArrayCounter_; i++) {
-    if (ecMemMapArray_[i]) {
-      if (ecMemMapArray_[i]->getIdentificationName().compare(name) == 0) {
-        temp = i;
-        break;
-      }
-    }
+  if (it == memMapIndexById_.end()) {
+    return -1;
   }
-  return temp;
+  return it->second;
 }
 
 ecmcEcMemMap * ecmcEc::getMemMap(int index) {
@@ -2030,6 +2076,7 @@ uint64_t ecmcEc::getTimeNs() {
     clock_gettime(CLOCK_MONOTONIC, &timeRel);
     timeAbs = timespecAdd(timeRel, timeOffset_);
   }
+  addDcTimeCorr(&timeAbs);
 
   return TIMESPEC2NS(timeAbs);
 }
@@ -2048,10 +2095,16 @@ uint64_t ecmcEc::getTimeNs(int clock_id) {
 }
 
 uint64_t ecmcEc::getTimeOffsetNs() {
+  int64_t corrNs = dcDiagEnable_ ? dcDiag_->getTimeCorrNs() : 0;
+
   if (useClockRealtime_) {
-   return 0;
+   return corrNs;
   }
-  return TIMESPEC2NS(timeOffset_);
+  return TIMESPEC2NS(timeOffset_) + corrNs;
+}
+
+uint64_t ecmcEc::getLastAppTimeNs() {
+  return lastAppTimeNs_;
 }
 
 uint32_t ecmcEc::getSlaveVendorId(uint16_t alias,  /**< Slave alias. */
@@ -2451,3 +2504,57 @@ int ecmcEc::addSimEntry(int            position,     // Slave position.
 
   return 0;
 }
+
+int ecmcEc::setDcDiag(int enable) {
+  if (enable && !dcDiag_) {
+    dcDiag_ = new ecmcEcDcDiag(master_,
+                               masterIndex_,
+                               (int32_t)mcuPeriod,
+                               asynPortDriver_);
+
+    if (dcDiag_->getErrorID()) {
+      return setErrorID(__FILE__,
+                        __FUNCTION__,
+                        __LINE__,
+                        dcDiag_->getErrorID());
+    }
+  }
+
+  dcDiagEnable_ = enable && dcDiag_;
+  return 0;
+}
+
+int ecmcEc::setDcWakeupCtrl(int    enable,
+                            double phaseUs,
+                            double kp,
+                            double ki,
+                            double maxAdjustUs) {
+  // Control needs the diagnostics (phase measurement)
+  if (enable) {
+    int errorCode = setDcDiag(1);
+
+    if (errorCode) {
+      return errorCode;
+    }
+  }
+
+  if (!dcDiag_) {
+    return 0;
+  }
+
+  return dcDiag_->setWakeupCtrl(enable, phaseUs, kp, ki, maxAdjustUs);
+}
+
+int32_t ecmcEc::getDcWakeupAdjustNs() {
+  return dcDiagEnable_ ? dcDiag_->getWakeupAdjustNs() : 0;
+}
+
+int ecmcEc::printDcDiag() {
+  if (!dcDiag_) {
+    printf("DC diagnostics master %d: Not enabled (Cfg.EcSetDcDiag(1)).\n",
+           masterIndex_);
+    return 0;
+  }
+  dcDiag_->print();
+  return 0;
+}
@@ -24,7 +24,9 @@
 #include "ecmcEcSDO.h"
 #include "ecmcEcSlave.h"
 #include "ecmcEcMemMap.h"
+#include "ecmcEcDcDiag.h"
 #include <vector>
+#include <unordered_map>
 
 // EC ERRORS
 #define ERROR_EC_MAIN_REQUEST_FAILED 0x26000
@@ -197,6 +199,7 @@ public:
   uint64_t getTimeNs();
   uint64_t getTimeNs(int clock);  // Get time from a sepcific clock (CLOCK_REALTIME, CLOCK_MONOMTONIC)
   uint64_t getTimeOffsetNs(); // Get time offset if monotonic
+  uint64_t getLastAppTimeNs(); // Application (dc) time of last send
 
   uint32_t getSlaveVendorId(uint16_t alias,       /**< Slave alias. */
                             uint16_t slavePos /**< Slave position. */);
@@ -217,10 +220,21 @@ public:
   int      getDomAllowOffline(int *allow);
   int      getEcAllowOffline();
 
+  // Distributed clock diagnostics and wakeup control (see ecmcEcDcDiag)
+  int      setDcDiag(int enable);
+  int      setDcWakeupCtrl(int    enable,
+                           double phaseUs,
+                           double kp,
+                           double ki,
+                           double maxAdjustUs);
+  int32_t  getDcWakeupAdjustNs();
+  int      printDcDiag();
+
 private:
   void     initVars();
   int      updateInputProcessImage();
   int      updateOutProcessImage();
+  void     addDcTimeCorr(timespec *time);
   timespec timespecAdd(timespec time1,
                        timespec time2);
   bool     validEntryType(ecmcEcDataType dt);
@@ -230,6 +244,10 @@ private:
   int slaveCounter_;
   int entryCounter_;
   ecmcEcSlave *slaveArray_[EC_MAX_SLAVES];
+
+  // Cfg lookups: bus position to index in slaveArray_, id to memmap index
+  std::unordered_map<int, int> slaveIndexByPosition_;
+  std::unordered_map<std::string, int> memMapIndexById_;
   ec_pdo_entry_reg_t slaveEntriesReg_[EC_MAX_ENTRIES];
   unsigned int pdoByteOffsetArray_[EC_MAX_ENTRIES];
   unsigned int pdoBitOffsetArray_[EC_MAX_ENTRIES];
@@ -270,5 +288,8 @@ private:
   int startupCounter_;
   ecmcEcDomain *currentDomain_;
   int allowOffline_;
+  ecmcEcDcDiag *dcDiag_;
+  bool dcDiagEnable_;
+  uint64_t lastAppTimeNs_;
 };
 #endif  /* ECMCEC_H_ */
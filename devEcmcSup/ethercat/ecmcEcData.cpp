@@ -78,6 +78,8 @@ ecmcEcData::ecmcEcData(ecmcAsynPortDriver *asynPortDriver,
   entryByteOffset_ = entryByteOffset;
   entryBitOffset_  = entryBitOffset;
   byteSize_        = getEcDataTypeByteSize(dataType_);
+  custom_          = true;
+  setRtFlags();
 }
 
 void ecmcEcData::initVars() {
@@ -85,6 +87,7 @@ void ecmcEcData::initVars() {
   entryByteOffset_ = 0;
   entryBitOffset_  = 0;
   byteSize_        = 0;
+  adr_             = NULL;
   direction_       = EC_DIR_INVALID;
 }
 
@@ -95,64 +98,64 @@ int ecmcEcData::updateInputProcessImage() {
     return 0;
   }
 
-  buffer_ = 0;
+  rt_->value.u64 = 0;
 
   // Read data from ethercat memory area
   switch (dataType_) {
   case ECMC_EC_B1:
-    *uint8Ptr_ = ecmcEcData::read_1_bit_offset(adr_, 0, entryBitOffset_);
+    rt_->value.u8 = ecmcEcData::read_1_bit_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_B2:
-    *uint8Ptr_ = ecmcEcData::read_2_bit_offset(adr_, 0, entryBitOffset_);
+    rt_->value.u8 = ecmcEcData::read_2_bit_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_B3:
-    *uint8Ptr_ = ecmcEcData::read_3_bit_offset(adr_, 0, entryBitOffset_);
+    rt_->value.u8 = ecmcEcData::read_3_bit_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_B4:
-    *uint8Ptr_ = ecmcEcData::read_4_bit_offset(adr_, 0, entryBitOffset_);
+    rt_->value.u8 = ecmcEcData::read_4_bit_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_U8:
-    *uint8Ptr_ = ecmcEcData::read_uint8_offset(adr_, 0, entryBitOffset_);
+    rt_->value.u8 = ecmcEcData::read_uint8_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_S8:
-    *int8Ptr_ = ecmcEcData::read_int8_offset(adr_, 0, entryBitOffset_);
+    rt_->value.s8 = ecmcEcData::read_int8_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_U16:
-    *uint16Ptr_ = ecmcEcData::read_uint16_offset(adr_, 0, entryBitOffset_);
+    rt_->value.u16 = ecmcEcData::read_uint16_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_S16:
-    *int16Ptr_ = ecmcEcData::read_int16_offset(adr_, 0, entryBitOffset_);
+    rt_->value.s16 = ecmcEcData::read_int16_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_U32:
-    *uint32Ptr_ = ecmcEcData::read_uint32_offset(adr_, 0, entryBitOffset_);
+    rt_->value.u32 = ecmcEcData::read_uint32_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_S32:
-    *int32Ptr_ = ecmcEcData::read_int32_offset(adr_, 0, entryBitOffset_);
+    rt_->value.s32 = ecmcEcData::read_int32_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_U64:
-    *uint64Ptr_ = ecmcEcData::read_uint64_offset(adr_, 0, entryBitOffset_);
+    rt_->value.u64 = ecmcEcData::read_uint64_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_S64:
-    *int64Ptr_ = ecmcEcData::read_int64_offset(adr_, 0, entryBitOffset_);
+    rt_->value.s64 = ecmcEcData::read_int64_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_F32:
-    *float32Ptr_ = ecmcEcData::read_float_offset(adr_, 0, entryBitOffset_);
+    rt_->value.f32 = ecmcEcData::read_float_offset(adr_, 0, entryBitOffset_);
     break;
 
   case ECMC_EC_F64:
-    *float64Ptr_ = ecmcEcData::read_double_offset(adr_, 0, entryBitOffset_);
+    rt_->value.f64 = ecmcEcData::read_double_offset(adr_, 0, entryBitOffset_);
     break;
 
   default:
@@ -172,59 +175,59 @@ int ecmcEcData::updateOutProcessImage() {
   // No endians check...
   switch (dataType_) {
   case ECMC_EC_B1:
-    ecmcEcData::write_1_bit_offset(adr_, 0, entryBitOffset_, *uint8Ptr_);
+    ecmcEcData::write_1_bit_offset(adr_, 0, entryBitOffset_, rt_->value.u8);
     break;
 
   case ECMC_EC_B2:
-    ecmcEcData::write_2_bit_offset(adr_, 0, entryBitOffset_, *uint8Ptr_);
+    ecmcEcData::write_2_bit_offset(adr_, 0, entryBitOffset_, rt_->value.u8);
     break;
 
   case ECMC_EC_B3:
-    ecmcEcData::write_3_bit_offset(adr_, 0, entryBitOffset_, *uint8Ptr_);
+    ecmcEcData::write_3_bit_offset(adr_, 0, entryBitOffset_, rt_->value.u8);
     break;
 
   case ECMC_EC_B4:
-    ecmcEcData::write_4_bit_offset(adr_, 0, entryBitOffset_, *uint8Ptr_);
+    ecmcEcData::write_4_bit_offset(adr_, 0, entryBitOffset_, rt_->value.u8);
     break;
 
   case ECMC_EC_U8:
-    ecmcEcData::write_uint8_offset(adr_, 0, entryBitOffset_, *uint8Ptr_);
+    ecmcEcData::write_uint8_offset(adr_, 0, entryBitOffset_, rt_->value.u8);
     break;
 
   case ECMC_EC_S8:
-    ecmcEcData::write_int8_offset(adr_, 0, entryBitOffset_, *int8Ptr_);
+    ecmcEcData::write_int8_offset(adr_, 0, entryBitOffset_, rt_->value.s8);
     break;
 
   case ECMC_EC_U16:
-    ecmcEcData::write_uint16_offset(adr_, 0, entryBitOffset_, *uint16Ptr_);
+    ecmcEcData::write_uint16_offset(adr_, 0, entryBitOffset_, rt_->value.u16);
     break;
 
   case ECMC_EC_S16:
-    ecmcEcData::write_int16_offset(adr_, 0, entryBitOffset_, *int16Ptr_);
+    ecmcEcData::write_int16_offset(adr_, 0, entryBitOffset_, rt_->value.s16);
     break;
 
   case ECMC_EC_U32:
-    ecmcEcData::write_uint32_offset(adr_, 0, entryBitOffset_, *uint32Ptr_);
+    ecmcEcData::write_uint32_offset(adr_, 0, entryBitOffset_, rt_->value.u32);
     break;
 
   case ECMC_EC_S32:
-    ecmcEcData::write_int32_offset(adr_, 0, entryBitOffset_, *int32Ptr_);
+    ecmcEcData::write_int32_offset(adr_, 0, entryBitOffset_, rt_->value.s32);
     break;
 
   case ECMC_EC_U64:
-    ecmcEcData::write_uint64_offset(adr_, 0, entryBitOffset_, *uint64Ptr_);
+    ecmcEcData::write_uint64_offset(adr_, 0, entryBitOffset_, rt_->value.u64);
     break;
 
   case ECMC_EC_S64:
-    ecmcEcData::write_int64_offset(adr_, 0, entryBitOffset_, *int64Ptr_);
+    ecmcEcData::write_int64_offset(adr_, 0, entryBitOffset_, rt_->value.s64);
     break;
 
   case ECMC_EC_F32:
-    ecmcEcData::write_float_offset(adr_, 0, entryBitOffset_, *float32Ptr_);
+    ecmcEcData::write_float_offset(adr_, 0, entryBitOffset_, rt_->value.f32);
     break;
 
   case ECMC_EC_F64:
-    ecmcEcData::write_double_offset(adr_, 0, entryBitOffset_, *float64Ptr_);
+    ecmcEcData::write_double_offset(adr_, 0, entryBitOffset_, rt_->value.f64);
     break;
 
   default:
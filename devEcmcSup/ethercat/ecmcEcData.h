@@ -54,6 +54,7 @@ private:
   size_t entryByteOffset_;
   size_t entryBitOffset_;
   size_t byteSize_;
+  uint8_t *adr_;
   ecmcEcEntry *startEntry_;
   static uint8_t read_1_bit_offset(uint8_t *buffer,
                                    int      byteOffset,
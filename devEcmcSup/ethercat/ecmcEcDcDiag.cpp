@@ -0,0 +1,361 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcEcDcDiag.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcEcDcDiag.h"
+#include <limits.h>
+#include <inttypes.h>
+#include "ecmcDefinitions.h"
+#include "ecmcOctetIF.h"  // Log Macros
+
+ecmcEcDcDiag::ecmcEcDcDiag(ec_master_t        *master,
+                           int                 masterIndex,
+                           int32_t             periodNs,
+                           ecmcAsynPortDriver *asynPortDriver) {
+  errorReset();
+  master_           = master;
+  masterIndex_      = masterIndex;
+  asynPortDriver_   = asynPortDriver;
+  periodNs_         = periodNs > 0 ? periodNs : 1;
+  startTimeNs_      = 0;
+  refTimeNs_        = 0;
+  lastRefTime_      = 0;
+  refValid_         = false;
+  cycles_           = 0;
+  refDiffNs_        = 0;
+  driftNs_          = 0;
+  driftMaxNs_       = 0;
+  phaseNs_          = 0;
+  phaseErrNs_       = 0;
+  phaseErrMaxNs_    = 0;
+  adjustNs_         = 0;
+  ctrlEnable_       = 0;
+  invalidCount_     = 0;
+  driftMaxTotNs_    = 0;
+  phaseErrMinTotNs_ = INT_MAX;
+  phaseErrMaxTotNs_ = INT_MIN;
+  phaseSetNs_       = 0;
+  kp_               = 0;
+  ki_               = 0;
+  maxAdjustNs_      = 0;
+  integral_         = 0;
+  timeCorrNs_       = 0;
+
+  for (int i = 0; i < ECMC_EC_DC_PHASE_HIST_BINS; i++) {
+    phaseHist_[i] = 0;
+  }
+
+  for (int i = 0; i < ECMC_EC_DC_DRIFT_HIST_BINS; i++) {
+    driftHist_[i] = 0;
+  }
+
+  for (int i = 0; i < ECMC_EC_DC_PAR_COUNT; i++) {
+    params_[i] = NULL;
+  }
+
+  int errorCode = initAsyn();
+
+  if (errorCode) {
+    setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+}
+
+ecmcEcDcDiag::~ecmcEcDcDiag() {}
+
+void ecmcEcDcDiag::setStartTime(uint64_t appTimeNs) {
+  startTimeNs_ = appTimeNs;
+}
+
+void ecmcEcDcDiag::execute(uint64_t lastAppTimeNs) {
+  uint32_t refTime = 0;
+
+  // Time read by ecrt_master_sync_slave_clocks() of last cycle
+  if ((lastAppTimeNs == 0) ||
+      ecrt_master_reference_clock_time(master_, &refTime)) {
+    invalidCount_++;
+    adjustNs_ = 0;
+    return;
+  }
+
+  int32_t refDiff = (int32_t)((uint32_t)lastAppTimeNs - refTime);
+
+  if (refValid_) {
+    refTimeNs_ += (uint32_t)(refTime - lastRefTime_);
+    driftNs_    = refDiff - refDiffNs_;
+  } else {
+    refTimeNs_ = lastAppTimeNs - refDiff;
+    driftNs_   = 0;
+    refValid_  = true;
+  }
+  lastRefTime_ = refTime;
+  refDiffNs_   = refDiff;
+  cycles_++;
+
+  // Phase relative to the SYNC0 grid
+  int64_t phase = (int64_t)(refTimeNs_ - startTimeNs_) % periodNs_;
+
+  if (phase < 0) {
+    phase += periodNs_;
+  }
+  phaseNs_ = (int32_t)phase;
+
+  int32_t phaseErr = phaseNs_ - phaseSetNs_;
+
+  if (phaseErr >= periodNs_ / 2) {
+    phaseErr -= periodNs_;
+  } else if (phaseErr < -periodNs_ / 2) {
+    phaseErr += periodNs_;
+  }
+  phaseErrNs_ = phaseErr;
+
+  int32_t driftAbs    = driftNs_ < 0 ? -driftNs_ : driftNs_;
+  int32_t phaseErrAbs = phaseErr < 0 ? -phaseErr : phaseErr;
+
+  if (driftAbs > driftMaxNs_) driftMaxNs_ = driftAbs;
+
+  if (driftAbs > driftMaxTotNs_) driftMaxTotNs_ = driftAbs;
+
+  if (phaseErrAbs > phaseErrMaxNs_) phaseErrMaxNs_ = phaseErrAbs;
+
+  if (phaseErr < phaseErrMinTotNs_) phaseErrMinTotNs_ = phaseErr;
+
+  if (phaseErr > phaseErrMaxTotNs_) phaseErrMaxTotNs_ = phaseErr;
+
+  phaseHist_[(int64_t)phaseNs_ * ECMC_EC_DC_PHASE_HIST_BINS / periodNs_]++;
+
+  int32_t drift = driftAbs >> ECMC_EC_DC_DRIFT_HIST_SHIFT;
+  int     bin   = 0;
+
+  while (drift && (bin < ECMC_EC_DC_DRIFT_HIST_BINS - 1)) {
+    drift >>= 1;
+    bin++;
+  }
+  driftHist_[bin]++;
+
+  if (!ctrlEnable_) {
+    adjustNs_ = 0;
+    return;
+  }
+
+  // Reference clock is not synced to the application time, steer the
+  // application time to the reference clock instead (kept if disabled)
+  int64_t step = -(int64_t)refDiff;
+
+  if ((step < ECMC_EC_DC_TIME_STEER_JUMP_NS) &&
+      (step > -ECMC_EC_DC_TIME_STEER_JUMP_NS)) {
+    step /= 1 << ECMC_EC_DC_TIME_STEER_SHIFT;
+
+    if (step > ECMC_EC_DC_TIME_STEER_MAX_STEP_NS) {
+      step = ECMC_EC_DC_TIME_STEER_MAX_STEP_NS;
+    }
+
+    if (step < -ECMC_EC_DC_TIME_STEER_MAX_STEP_NS) {
+      step = -ECMC_EC_DC_TIME_STEER_MAX_STEP_NS;
+    }
+  }
+  timeCorrNs_ += step;
+
+  // Frame late (positive error): wake up earlier
+  integral_ += ki_ * phaseErr;
+
+  if (integral_ > maxAdjustNs_) integral_ = maxAdjustNs_;
+
+  if (integral_ < -maxAdjustNs_) integral_ = -maxAdjustNs_;
+
+  double adjust = -(kp_ * phaseErr + integral_);
+
+  if (adjust > maxAdjustNs_) adjust = maxAdjustNs_;
+
+  if (adjust < -maxAdjustNs_) adjust = -maxAdjustNs_;
+
+  adjustNs_ = (int32_t)adjust;
+}
+
+int32_t ecmcEcDcDiag::getWakeupAdjustNs() {
+  return adjustNs_;
+}
+
+int64_t ecmcEcDcDiag::getTimeCorrNs() {
+  return timeCorrNs_;
+}
+
+bool ecmcEcDcDiag::getWakeupCtrlEnable() {
+  return ctrlEnable_ != 0;
+}
+
+int ecmcEcDcDiag::setWakeupCtrl(int    enable,
+                                double phaseUs,
+                                double kp,
+                                double ki,
+                                double maxAdjustUs) {
+  if (enable && ((phaseUs < 0) || (phaseUs * 1000 >= periodNs_) ||
+                 (kp < 0) || (ki < 0) || (maxAdjustUs <= 0) ||
+                 (maxAdjustUs * 1000 > periodNs_ / 2))) {
+    LOGERR(
+      "%s/%s:%d: ERROR: Master %d invalid wakeup control (phase=%lfus, kp=%lf, ki=%lf, maxAdjust=%lfus) (0x%x).\n",
+      __FILE__,
+      __FUNCTION__,
+      __LINE__,
+      masterIndex_,
+      phaseUs,
+      kp,
+      ki,
+      maxAdjustUs,
+      ERROR_EC_DC_WAKEUP_CTRL_INVALID);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_EC_DC_WAKEUP_CTRL_INVALID);
+  }
+
+  phaseSetNs_  = (int32_t)(phaseUs * 1000);
+  kp_          = kp;
+  ki_          = ki;
+  maxAdjustNs_ = maxAdjustUs * 1000;
+  integral_    = 0;
+  adjustNs_    = 0;
+  ctrlEnable_  = enable != 0;
+  return 0;
+}
+
+void ecmcEcDcDiag::resetPar(int parId) {
+  switch (parId) {
+  case ECMC_EC_DC_PAR_DRIFT_MAX:
+    driftMaxNs_ = 0;
+    break;
+
+  case ECMC_EC_DC_PAR_PHASE_ERR_MAX:
+    phaseErrMaxNs_ = 0;
+    break;
+
+  default:
+    break;
+  }
+}
+
+void ecmcEcDcDiag::updateAsyn(int force) {
+  for (int i = 0; i < ECMC_EC_DC_PAR_COUNT; i++) {
+    if (params_[i] && (params_[i]->refreshParamRT(force) == 0)) {
+      // Max reset after successful write
+      resetPar(i);
+    }
+  }
+}
+
+void ecmcEcDcDiag::print() {
+  printf("DC diagnostics master %d (cycle %dns, %" PRIu64 " cycles, %d invalid):\n",
+         masterIndex_,
+         periodNs_,
+         cycles_,
+         invalidCount_);
+  printf("  refdiff %dns, drift %dns (max abs %dns)\n",
+         refDiffNs_,
+         driftNs_,
+         driftMaxTotNs_);
+  printf("  phase %dns, setpoint %dns, error %dns (min %dns, max %dns)\n",
+         phaseNs_,
+         phaseSetNs_,
+         phaseErrNs_,
+         phaseErrMinTotNs_ == INT_MAX ? 0 : phaseErrMinTotNs_,
+         phaseErrMaxTotNs_ == INT_MIN ? 0 : phaseErrMaxTotNs_);
+  printf("  wakeup control %s (kp %lf, ki %lf, max adjust %.0lfns), adjust %dns\n",
+         ctrlEnable_ ? "on" : "off",
+         kp_,
+         ki_,
+         maxAdjustNs_,
+         adjustNs_);
+  printf("  application time correction %" PRId64 "ns\n", timeCorrNs_);
+  printf("  phase histogram (%dns/bin):\n", periodNs_ / ECMC_EC_DC_PHASE_HIST_BINS);
+
+  for (int i = 0; i < ECMC_EC_DC_PHASE_HIST_BINS; i++) {
+    if (phaseHist_[i]) {
+      printf("    %8d: %d\n", i * (periodNs_ / ECMC_EC_DC_PHASE_HIST_BINS),
+             phaseHist_[i]);
+    }
+  }
+  printf("  drift histogram (abs, ns):\n");
+
+  for (int i = 0; i < ECMC_EC_DC_DRIFT_HIST_BINS; i++) {
+    if (driftHist_[i]) {
+      printf("    < %8d: %d\n", 1 << (ECMC_EC_DC_DRIFT_HIST_SHIFT + i),
+             driftHist_[i]);
+    }
+  }
+}
+
+int ecmcEcDcDiag::initAsyn() {
+  if (!asynPortDriver_) {
+    return 0;
+  }
+
+  struct {
+    const char   *name;
+    asynParamType type;
+    int32_t      *data;
+    size_t        bytes;
+  } pars[ECMC_EC_DC_PAR_COUNT] = {
+    { ECMC_EC_DC_REF_DIFF_STR,      asynParamInt32,      &refDiffNs_,     sizeof(refDiffNs_)     },
+    { ECMC_EC_DC_DRIFT_STR,         asynParamInt32,      &driftNs_,       sizeof(driftNs_)       },
+    { ECMC_EC_DC_DRIFT_MAX_STR,     asynParamInt32,      &driftMaxNs_,    sizeof(driftMaxNs_)    },
+    { ECMC_EC_DC_PHASE_STR,         asynParamInt32,      &phaseNs_,       sizeof(phaseNs_)       },
+    { ECMC_EC_DC_PHASE_ERR_STR,     asynParamInt32,      &phaseErrNs_,    sizeof(phaseErrNs_)    },
+    { ECMC_EC_DC_PHASE_ERR_MAX_STR, asynParamInt32,      &phaseErrMaxNs_, sizeof(phaseErrMaxNs_) },
+    { ECMC_EC_DC_ADJUST_STR,        asynParamInt32,      &adjustNs_,      sizeof(adjustNs_)      },
+    { ECMC_EC_DC_CTRL_ENABLE_STR,   asynParamInt32,      &ctrlEnable_,    sizeof(ctrlEnable_)    },
+    { ECMC_EC_DC_INVALID_STR,       asynParamInt32,      &invalidCount_,  sizeof(invalidCount_)  },
+    { ECMC_EC_DC_PHASE_HIST_STR,    asynParamInt32Array, phaseHist_,      sizeof(phaseHist_)     },
+    { ECMC_EC_DC_DRIFT_HIST_STR,    asynParamInt32Array, driftHist_,      sizeof(driftHist_)     },
+  };
+
+  char name[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  for (int i = 0; i < ECMC_EC_DC_PAR_COUNT; i++) {
+    // "ec<index>.dc.<name>"
+    int chars = snprintf(name,
+                         sizeof(name),
+                         ECMC_EC_STR "%d." ECMC_EC_DC_STR ".%s",
+                         masterIndex_,
+                         pars[i].name);
+
+    if (chars >= (int)sizeof(name) - 1) {
+      return ERROR_EC_DC_DIAG_ASYN_PARAM_FAIL;
+    }
+
+    ecmcAsynDataItem *paramTemp =
+      asynPortDriver_->addNewAvailParam(name,
+                                        pars[i].type,
+                                        (uint8_t *)pars[i].data,
+                                        pars[i].bytes,
+                                        ECMC_EC_S32,
+                                        0);
+
+    if (!paramTemp) {
+      LOGERR(
+        "%s/%s:%d: ERROR: Add create default parameter for %s failed (0x%x).\n",
+        __FILE__,
+        __FUNCTION__,
+        __LINE__,
+        name,
+        ERROR_EC_DC_DIAG_ASYN_PARAM_FAIL);
+      return ERROR_EC_DC_DIAG_ASYN_PARAM_FAIL;
+    }
+    paramTemp->setAllowWriteToEcmc(false);
+    paramTemp->setAllowScheduler(false);  // Max reset when refreshed
+
+    if (pars[i].type == asynParamInt32Array) {
+      paramTemp->setArrayCheckSize(false);
+    }
+    paramTemp->refreshParam(1);
+    params_[i] = paramTemp;
+  }
+
+  return 0;
+}
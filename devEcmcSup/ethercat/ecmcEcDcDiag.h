@@ -0,0 +1,154 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcEcDcDiag.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Distributed clock diagnostics of one master. Each cycle the reference
+* clock time (read back by ecrt_master_sync_slave_clocks()) is compared to
+* the application time of the previous cycle:
+*  - refdiff: application time - reference clock time
+*  - drift:   change of refdiff since last cycle (send time jitter)
+*  - phase:   time when the frame passed the reference clock, relative to
+*             the SYNC0 grid (shift 0, same cycle time as the rt thread)
+*
+* Optional wakeup control: the master follows the reference clock instead
+* of the opposite. The wakeup of the rt thread is shifted (PI control) so
+* that the frames pass the reference clock at a fixed phase. The reference
+* clock is then not synced to the application time, instead the
+* application time is steered to the reference clock (refdiff towards 0)
+* by a correction added in ecmcEc::send().
+*
+\*************************************************************************/
+
+#ifndef ECMC_EC_DC_DIAG_H_
+#define ECMC_EC_DC_DIAG_H_
+
+#include <stdint.h>
+#include "ecrt.h"
+#include "ecmcAsynPortDriver.h"
+#include "ecmcError.h"
+
+#define ERROR_EC_DC_DIAG_ASYN_PARAM_FAIL 0x26029
+#define ERROR_EC_DC_WAKEUP_CTRL_INVALID 0x2602A
+
+// Phase histogram: linear bins over one cycle
+#define ECMC_EC_DC_PHASE_HIST_BINS 32
+
+// Application time steering (wakeup control): step refdiff/2^shift per
+// cycle, limited to max step, one jump if refdiff is larger than jump
+#define ECMC_EC_DC_TIME_STEER_SHIFT 4
+#define ECMC_EC_DC_TIME_STEER_MAX_STEP_NS 1000
+#define ECMC_EC_DC_TIME_STEER_JUMP_NS 1000000
+
+// Drift histogram: bin 0 < 64ns, bin n < 64ns * 2^n, last bin rest
+#define ECMC_EC_DC_DRIFT_HIST_BINS 16
+#define ECMC_EC_DC_DRIFT_HIST_SHIFT 6
+
+#define ECMC_EC_DC_STR "dc"
+#define ECMC_EC_DC_REF_DIFF_STR "refdiff"
+#define ECMC_EC_DC_DRIFT_STR "drift"
+#define ECMC_EC_DC_DRIFT_MAX_STR "driftmax"
+#define ECMC_EC_DC_PHASE_STR "phase"
+#define ECMC_EC_DC_PHASE_ERR_STR "phaseerr"
+#define ECMC_EC_DC_PHASE_ERR_MAX_STR "phaseerrmax"
+#define ECMC_EC_DC_ADJUST_STR "wakeupadjust"
+#define ECMC_EC_DC_CTRL_ENABLE_STR "wakeupctrl"
+#define ECMC_EC_DC_INVALID_STR "invalidcount"
+#define ECMC_EC_DC_PHASE_HIST_STR "phasehist"
+#define ECMC_EC_DC_DRIFT_HIST_STR "drifthist"
+
+enum ecmcEcDcDiagPar {
+  ECMC_EC_DC_PAR_REF_DIFF = 0,
+  ECMC_EC_DC_PAR_DRIFT,
+  ECMC_EC_DC_PAR_DRIFT_MAX,
+  ECMC_EC_DC_PAR_PHASE,
+  ECMC_EC_DC_PAR_PHASE_ERR,
+  ECMC_EC_DC_PAR_PHASE_ERR_MAX,
+  ECMC_EC_DC_PAR_ADJUST,
+  ECMC_EC_DC_PAR_CTRL_ENABLE,
+  ECMC_EC_DC_PAR_INVALID,
+  ECMC_EC_DC_PAR_PHASE_HIST,
+  ECMC_EC_DC_PAR_DRIFT_HIST,
+  ECMC_EC_DC_PAR_COUNT
+};
+
+class ecmcEcDcDiag : public ecmcError {
+public:
+  ecmcEcDcDiag(ec_master_t        *master,
+               int                 masterIndex,
+               int32_t             periodNs,
+               ecmcAsynPortDriver *asynPortDriver);
+  ~ecmcEcDcDiag();
+
+  // Application time at activation (start of the SYNC0 grid)
+  void    setStartTime(uint64_t appTimeNs);
+
+  // Rt, called in ecmcEc::send() before the new application time is set
+  void    execute(uint64_t lastAppTimeNs);
+  void    updateAsyn(int force);
+
+  // Shift of next wakeup of the rt thread [ns]
+  int32_t getWakeupAdjustNs();
+
+  // Correction of the application time (wakeup control) [ns]
+  int64_t getTimeCorrNs();
+  bool    getWakeupCtrlEnable();
+
+  // Phase setpoint relative to the SYNC0 grid (0..cycle time)
+  int     setWakeupCtrl(int    enable,
+                        double phaseUs,
+                        double kp,
+                        double ki,
+                        double maxAdjustUs);
+  void    print();
+
+private:
+  int     initAsyn();
+  void    resetPar(int parId);
+
+  ec_master_t *master_;
+  int masterIndex_;
+  ecmcAsynPortDriver *asynPortDriver_;
+  ecmcAsynDataItem *params_[ECMC_EC_DC_PAR_COUNT];
+  int32_t periodNs_;
+  uint64_t startTimeNs_;
+
+  // Reference clock time unwrapped to 64bit
+  uint64_t refTimeNs_;
+  uint32_t lastRefTime_;
+  bool refValid_;
+  uint64_t cycles_;
+
+  // Nano seconds
+  int32_t refDiffNs_;
+  int32_t driftNs_;
+  int32_t driftMaxNs_;
+  int32_t phaseNs_;
+  int32_t phaseErrNs_;
+  int32_t phaseErrMaxNs_;
+  int32_t adjustNs_;
+  int32_t ctrlEnable_;
+  int32_t invalidCount_;
+  int32_t phaseHist_[ECMC_EC_DC_PHASE_HIST_BINS];
+  int32_t driftHist_[ECMC_EC_DC_DRIFT_HIST_BINS];
+
+  // Min/max since start (print), the above are reset when published
+  int32_t driftMaxTotNs_;
+  int32_t phaseErrMinTotNs_;
+  int32_t phaseErrMaxTotNs_;
+
+  // Wakeup control
+  int32_t phaseSetNs_;
+  double kp_;
+  double ki_;
+  double maxAdjustNs_;
+  double integral_;
+  int64_t timeCorrNs_;
+};
+
+#endif  /* ECMC_EC_DC_DIAG_H_ */
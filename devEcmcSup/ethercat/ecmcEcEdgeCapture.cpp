@@ -0,0 +1,506 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcEcEdgeCapture.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcEcEdgeCapture.h"
+#include "ecmcErrorsList.h"
+#include "ecmcOctetIF.h"
+#include <string.h>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <epicsAtomic.h>
+
+ecmcEcEdgeCapture::ecmcEcEdgeCapture(ecmcAsynPortDriver *asynPortDriver,
+                                     int                 index,
+                                     int                 fifoSize) {
+  asynPortDriver_ = asynPortDriver;
+  index_          = index;
+  errorCode_      = 0;
+  fifoSize_       = 1;
+  fifoMask_       = 0;
+  channelCount_   = 0;
+  words_          = NULL;
+  wordCount_      = 0;
+  stamps_         = NULL;
+  stampCount_     = 0;
+  active_         = false;
+  firstCycle_     = true;
+  anyUpdated_     = false;
+  memset(channels_, 0, sizeof(channels_));
+
+  if ((fifoSize < 1) || (fifoSize > ECMC_EC_EDGE_CAPTURE_MAX_FIFO)) {
+    LOGERR("%s/%s:%d: ERROR: Edge capture %d: Fifo size %d out of range (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           fifoSize,
+           ERROR_EC_EDGE_CAPTURE_INVALID_CFG);
+    errorCode_ = ERROR_EC_EDGE_CAPTURE_INVALID_CFG;
+    return;
+  }
+
+  // Round up to power of 2
+  while (fifoSize_ < (size_t)fifoSize) {
+    fifoSize_ <<= 1;
+  }
+  fifoMask_ = fifoSize_ - 1;
+}
+
+ecmcEcEdgeCapture::~ecmcEcEdgeCapture() {
+  for (int i = 0; i < channelCount_; i++) {
+    delete[] channels_[i].slots;
+  }
+  delete[] words_;
+  delete[] stamps_;
+}
+
+int ecmcEcEdgeCapture::getErrorCode() {
+  return errorCode_;
+}
+
+int ecmcEcEdgeCapture::addBitChannel(ecmcEcEntry *entry,
+                                     int          bit,
+                                     int          edges) {
+  if (entry && ((bit < 0) || (bit >= entry->getBits()))) {
+    LOGERR("%s/%s:%d: ERROR: Edge capture %d: Bit %d out of range (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           bit,
+           ERROR_EC_EDGE_CAPTURE_BIT_OUT_OF_RANGE);
+    return ERROR_EC_EDGE_CAPTURE_BIT_OUT_OF_RANGE;
+  }
+
+  if ((edges < ECMC_EC_EDGE_RISING) || (edges > ECMC_EC_EDGE_BOTH)) {
+    return ERROR_EC_EDGE_CAPTURE_INVALID_CFG;
+  }
+
+  for (int i = 0; i < channelCount_; i++) {
+    if ((channels_[i].type == ECMC_EC_EDGE_CHANNEL_BIT) &&
+        (channels_[i].entry == entry) && (channels_[i].bit == bit)) {
+      return ERROR_EC_EDGE_CAPTURE_CHANNEL_EXISTS;
+    }
+  }
+
+  return addChannel(ECMC_EC_EDGE_CHANNEL_BIT, entry, bit, edges);
+}
+
+int ecmcEcEdgeCapture::addTimestampChannel(ecmcEcEntry *entry,
+                                           int          edge) {
+  if (entry && (entry->getBits() != 32) && (entry->getBits() != 64)) {
+    LOGERR("%s/%s:%d: ERROR: Edge capture %d: Timestamp entry must be 32 or 64 bit (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           ERROR_EC_EDGE_CAPTURE_ENTRY_INVALID);
+    return ERROR_EC_EDGE_CAPTURE_ENTRY_INVALID;
+  }
+
+  if ((edge != ECMC_EC_EDGE_RISING) && (edge != ECMC_EC_EDGE_FALLING)) {
+    return ERROR_EC_EDGE_CAPTURE_INVALID_CFG;
+  }
+
+  return addChannel(ECMC_EC_EDGE_CHANNEL_TIMESTAMP, entry, 0, edge);
+}
+
+int ecmcEcEdgeCapture::addChannel(int          type,
+                                  ecmcEcEntry *entry,
+                                  int          bit,
+                                  int          edges) {
+  if (!entry || (entry->getDirection() != EC_DIR_INPUT) ||
+      entry->getSimEntry()) {
+    LOGERR("%s/%s:%d: ERROR: Edge capture %d: Entry must be an EtherCAT input (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           ERROR_EC_EDGE_CAPTURE_ENTRY_INVALID);
+    return ERROR_EC_EDGE_CAPTURE_ENTRY_INVALID;
+  }
+
+  if (channelCount_ >= ECMC_EC_EDGE_CAPTURE_MAX_CHANNELS) {
+    return ERROR_EC_EDGE_CAPTURE_CHANNEL_COUNT_OUT_OF_RANGE;
+  }
+
+  ecmcEcEdgeChannel *ch = &channels_[channelCount_];
+
+  ch->slots = new (std::nothrow) ecmcEcEdgeSlot[fifoSize_]();
+
+  if (!ch->slots) {
+    return ERROR_EC_EDGE_CAPTURE_ALLOC_FAIL;
+  }
+  ch->type  = type;
+  ch->edges = edges;
+  ch->entry = entry;
+  ch->bit   = bit;
+
+  int errorCode = initAsyn(channelCount_);
+
+  if (errorCode) {
+    delete[] ch->slots;
+    memset(ch, 0, sizeof(*ch));
+    return errorCode;
+  }
+  channelCount_++;
+  return 0;
+}
+
+int ecmcEcEdgeCapture::getChannelCount() {
+  return channelCount_;
+}
+
+int ecmcEcEdgeCapture::activate() {
+  std::vector<ecmcEcEdgeBitRef> refs;
+  std::vector<ecmcEcEdgeStamp>  stamps;
+
+  active_ = false;
+
+  for (int i = 0; i < channelCount_; i++) {
+    ecmcEcEntryRt *rt = channels_[i].entry->getRt();
+
+    // Process image handled by owner (no address)
+    if (!rt || (rt->flags & ECMC_EC_ENTRY_RT_CUSTOM) || !rt->adr) {
+      LOGERR("%s/%s:%d: ERROR: Edge capture %d: Channel %d not in process image (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             index_,
+             i,
+             ERROR_EC_EDGE_CAPTURE_ENTRY_INVALID);
+      return ERROR_EC_EDGE_CAPTURE_ENTRY_INVALID;
+    }
+
+    if (channels_[i].type == ECMC_EC_EDGE_CHANNEL_BIT) {
+      int bit = rt->bitOffset + channels_[i].bit;
+      ecmcEcEdgeBitRef ref = { rt->adr + bit / 8, bit % 8, i };
+      refs.push_back(ref);
+    } else {
+      ecmcEcEdgeStamp stamp = {};
+      stamp.adr     = rt->adr;
+      stamp.bytes   = channels_[i].entry->getBits() / 8;
+      stamp.channel = i;
+      stamps.push_back(stamp);
+    }
+  }
+
+  // Pack bits into words of up to 8 bytes
+  std::vector<ecmcEcEdgeWord> words;
+
+  if (edgeWordsPack(refs, &words)) {
+    return ERROR_EC_EDGE_CAPTURE_CHANNEL_EXISTS;
+  }
+
+  delete[] words_;
+  delete[] stamps_;
+  words_      = NULL;
+  stamps_     = NULL;
+  wordCount_  = (int)words.size();
+  stampCount_ = (int)stamps.size();
+
+  if (wordCount_) {
+    words_ = new (std::nothrow) ecmcEcEdgeWord[wordCount_];
+  }
+
+  if (stampCount_) {
+    stamps_ = new (std::nothrow) ecmcEcEdgeStamp[stampCount_];
+  }
+
+  if ((wordCount_ && !words_) || (stampCount_ && !stamps_)) {
+    return ERROR_EC_EDGE_CAPTURE_ALLOC_FAIL;
+  }
+  std::copy(words.begin(), words.end(), words_);
+  std::copy(stamps.begin(), stamps.end(), stamps_);
+
+  firstCycle_ = true;
+  active_     = true;
+  return 0;
+}
+
+void ecmcEcEdgeCapture::push(ecmcEcEdgeChannel *ch,
+                             uint64_t           timeNs,
+                             int                edge) {
+  size_t n             = ch->head;
+  ecmcEcEdgeSlot *slot = &ch->slots[n & fifoMask_];
+
+  epicsAtomicSetSizeT(&slot->seq, 0);
+  epicsAtomicWriteMemoryBarrier();
+  slot->timeNs = timeNs;
+  slot->edge   = edge;
+  epicsAtomicWriteMemoryBarrier();
+  epicsAtomicSetSizeT(&slot->seq, n + 1);
+  epicsAtomicSetSizeT(&ch->head, n + 1);
+
+  ch->asynCount++;
+  ch->asynEdge   = edge;
+  ch->asynTimeNs = timeNs;
+  ch->updated    = true;
+  anyUpdated_    = true;
+}
+
+void ecmcEcEdgeCapture::execute(uint64_t cycleTimeNs) {
+  if (!active_) {
+    return;
+  }
+
+  // No edges from the first process image
+  if (firstCycle_) {
+    for (int i = 0; i < wordCount_; i++) {
+      words_[i].old = edgeWordLoad(words_[i].adr, words_[i].bytes);
+    }
+
+    for (int i = 0; i < stampCount_; i++) {
+      stamps_[i].old = edgeWordLoad(stamps_[i].adr, stamps_[i].bytes);
+    }
+    firstCycle_ = false;
+    return;
+  }
+
+  for (int i = 0; i < wordCount_; i++) {
+    ecmcEcEdgeWord *word = &words_[i];
+    uint64_t value       = 0;
+    uint64_t changed     = edgeWordChanged(word, &value);
+
+    while (changed) {
+      int pos = __builtin_ctzll(changed);
+      changed &= changed - 1;
+
+      ecmcEcEdgeChannel *ch = &channels_[word->channel[pos]];
+      int edge              = (value >> pos) & 1 ? ECMC_EC_EDGE_RISING :
+                              ECMC_EC_EDGE_FALLING;
+
+      if (ch->edges & edge) {
+        push(ch, cycleTimeNs, edge);
+      }
+    }
+  }
+
+  for (int i = 0; i < stampCount_; i++) {
+    ecmcEcEdgeStamp *stamp = &stamps_[i];
+    uint64_t value         = edgeWordLoad(stamp->adr, stamp->bytes);
+
+    if (value == stamp->old) {
+      continue;
+    }
+    stamp->old = value;
+
+    // Extend 32 bit DC time with the application time (closest)
+    if (stamp->bytes == 4) {
+      value = (cycleTimeNs & ~0xFFFFFFFFULL) | value;
+
+      if (value > cycleTimeNs + 0x80000000ULL) {
+        value -= 0x100000000ULL;
+      } else if (value + 0x80000000ULL < cycleTimeNs) {
+        value += 0x100000000ULL;
+      }
+    }
+    ecmcEcEdgeChannel *ch = &channels_[stamp->channel];
+    push(ch, value, ch->edges);
+  }
+
+  if (anyUpdated_) {
+    refreshAsyn();
+  }
+}
+
+void ecmcEcEdgeCapture::refreshAsyn() {
+  for (int i = 0; i < channelCount_; i++) {
+    if (!channels_[i].updated) {
+      continue;
+    }
+    channels_[i].updated = false;
+
+    for (int j = 0; j < 3; j++) {
+      if (channels_[i].asynItems[j]) {
+        channels_[i].asynItems[j]->refreshParamRT(0);
+      }
+    }
+  }
+  anyUpdated_ = false;
+}
+
+int ecmcEcEdgeCapture::readEvent(int       channel,
+                                 size_t   *cursor,
+                                 uint64_t *timeNs,
+                                 int      *edge) {
+  if ((channel < 0) || (channel >= channelCount_) || !cursor) {
+    return 0;
+  }
+
+  ecmcEcEdgeChannel *ch = &channels_[channel];
+
+  for (;;) {
+    size_t head = epicsAtomicGetSizeT(&ch->head);
+    epicsAtomicReadMemoryBarrier();
+
+    if (*cursor >= head) {
+      *cursor = head;
+      return 0;
+    }
+
+    // Overwritten, continue with oldest
+    if (head - *cursor > fifoSize_) {
+      *cursor = head - fifoSize_;
+    }
+
+    ecmcEcEdgeSlot *slot = &ch->slots[*cursor & fifoMask_];
+    size_t seq           = epicsAtomicGetSizeT(&slot->seq);
+    epicsAtomicReadMemoryBarrier();
+    uint64_t slotTimeNs = slot->timeNs;
+    int      slotEdge   = slot->edge;
+    epicsAtomicReadMemoryBarrier();
+
+    if ((seq == *cursor + 1) && (epicsAtomicGetSizeT(&slot->seq) == seq)) {
+      if (timeNs) {
+        *timeNs = slotTimeNs;
+      }
+
+      if (edge) {
+        *edge = slotEdge;
+      }
+      (*cursor)++;
+      return 1;
+    }
+
+    // Overwritten while reading
+    (*cursor)++;
+  }
+}
+
+size_t ecmcEcEdgeCapture::getEventCount(int channel) {
+  if ((channel < 0) || (channel >= channelCount_)) {
+    return 0;
+  }
+  return epicsAtomicGetSizeT(&channels_[channel].head);
+}
+
+int ecmcEcEdgeCapture::plcPop(int channel) {
+  if ((channel < 0) || (channel >= channelCount_)) {
+    return 0;
+  }
+
+  ecmcEcEdgeChannel *ch = &channels_[channel];
+  uint64_t timeNs       = 0;
+  int edge              = ECMC_EC_EDGE_NONE;
+
+  if (readEvent(channel, &ch->plcCursor, &timeNs, &edge)) {
+    ch->plcTimeNs = timeNs;
+    return edge;
+  }
+  return ECMC_EC_EDGE_NONE;
+}
+
+uint64_t ecmcEcEdgeCapture::plcGetTime(int channel) {
+  if ((channel < 0) || (channel >= channelCount_)) {
+    return 0;
+  }
+  return channels_[channel].plcTimeNs;
+}
+
+void ecmcEcEdgeCapture::print() {
+  const char *edgeStr[] = { "none", "rising", "falling", "both" };
+
+  printf("Edge capture %d (fifo %zu events per channel%s):\n",
+         index_,
+         fifoSize_,
+         active_ ? "" : ", not active");
+
+  for (int i = 0; i < channelCount_; i++) {
+    ecmcEcEdgeChannel *ch = &channels_[i];
+
+    if (ch->type == ECMC_EC_EDGE_CHANNEL_BIT) {
+      printf("  " ECMC_EC_EDGE_CAPTURE_CHANNEL_STR "%d: bit %d of s%d.%s, %s, events %zu\n",
+             i,
+             ch->bit,
+             ch->entry->getSlaveId(),
+             ch->entry->getIdentificationName().c_str(),
+             edgeStr[ch->edges],
+             getEventCount(i));
+    } else {
+      printf("  " ECMC_EC_EDGE_CAPTURE_CHANNEL_STR "%d: timestamp s%d.%s (%d bit), %s, events %zu\n",
+             i,
+             ch->entry->getSlaveId(),
+             ch->entry->getIdentificationName().c_str(),
+             ch->entry->getBits(),
+             edgeStr[ch->edges],
+             getEventCount(i));
+    }
+  }
+
+  if (active_) {
+    printf("  %d bit words, %d timestamp entries\n", wordCount_, stampCount_);
+  }
+}
+
+int ecmcEcEdgeCapture::initAsyn(int channel) {
+  if (!asynPortDriver_) {
+    return 0;
+  }
+
+  ecmcEcEdgeChannel *ch = &channels_[channel];
+
+  struct {
+    const char    *name;
+    asynParamType  type;
+    ecmcEcDataType ecmcType;
+    uint8_t       *data;
+    size_t         bytes;
+  } pars[3] = {
+    { ECMC_EC_EDGE_CAPTURE_COUNT_STR, asynParamInt32,   ECMC_EC_S32, (uint8_t *)&ch->asynCount,  sizeof(ch->asynCount)  },
+    { ECMC_EC_EDGE_CAPTURE_EDGE_STR,  asynParamInt32,   ECMC_EC_S32, (uint8_t *)&ch->asynEdge,   sizeof(ch->asynEdge)   },
+    { ECMC_EC_EDGE_CAPTURE_TIME_STR,  asynParamFloat64, ECMC_EC_U64, (uint8_t *)&ch->asynTimeNs, sizeof(ch->asynTimeNs) },
+  };
+
+  char name[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  for (int i = 0; i < 3; i++) {
+    // "edgecap<index>.ch<channel>.<name>"
+    snprintf(name,
+             sizeof(name),
+             ECMC_EC_EDGE_CAPTURE_STR "%d." ECMC_EC_EDGE_CAPTURE_CHANNEL_STR "%d.%s",
+             index_,
+             channel,
+             pars[i].name);
+
+    ecmcAsynDataItem *paramTemp =
+      asynPortDriver_->addNewAvailParam(name,
+                                        pars[i].type,
+                                        pars[i].data,
+                                        pars[i].bytes,
+                                        pars[i].ecmcType,
+                                        0);
+
+    if (!paramTemp) {
+      LOGERR("%s/%s:%d: ERROR: Edge capture %d. Add parameter %s failed (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             index_,
+             name,
+             ERROR_EC_EDGE_CAPTURE_ASYN_PARAM_FAIL);
+      return ERROR_EC_EDGE_CAPTURE_ASYN_PARAM_FAIL;
+    }
+
+#ifdef ECMC_ASYN_ASYNPARAMINT64
+    if (pars[i].ecmcType == ECMC_EC_U64) {
+      paramTemp->addSupportedAsynType(asynParamInt64);
+    }
+#endif // ECMC_ASYN_ASYNPARAMINT64
+
+    paramTemp->setAllowWriteToEcmc(false);
+    paramTemp->refreshParam(1);
+    ch->asynItems[i] = paramTemp;
+  }
+  return 0;
+}
@@ -0,0 +1,174 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcEcEdgeCapture.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Edge capture of EtherCAT inputs. Channels are either
+*  - bit: one bit of an input entry. The channels are packed into words of
+*         up to 8 process image bytes (bits of neighbouring entries share a
+*         word). Each cycle a word is compared to the previous cycle
+*         (xor and mask), so the cost is one load per word when nothing
+*         changed. Edges are timestamped with the application time of the
+*         cycle that carried the data (cycle resolution).
+*  - timestamp: a latch/timestamp entry (32 or 64 bit DC time) of a
+*         timestamp capable terminal. A new event is detected when the
+*         value changes and is timestamped with the latched DC time (32 bit
+*         values are extended with the upper bits of the application time).
+* Events are written by the rt thread to a per channel ring (power of 2,
+* oldest overwritten). Readers (plc, plugins, asyn) have their own cursor,
+* so several readers can consume the same channel. Slots are guarded by a
+* sequence number and can be read from any thread.
+* Status of each channel in "edgecap<index>.ch<channel>.count|edge|time"
+* (refreshed only when the channel got events).
+*
+\*************************************************************************/
+
+#ifndef ECMC_EC_EDGE_CAPTURE_H_
+#define ECMC_EC_EDGE_CAPTURE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ecmcAsynPortDriver.h"
+#include "ecmcEcEntry.h"
+#include "ecmcEcEdgeWords.h"
+
+#define ERROR_EC_EDGE_CAPTURE_ALLOC_FAIL 0x26030
+#define ERROR_EC_EDGE_CAPTURE_INVALID_CFG 0x26031
+#define ERROR_EC_EDGE_CAPTURE_ENTRY_INVALID 0x26032
+#define ERROR_EC_EDGE_CAPTURE_BIT_OUT_OF_RANGE 0x26033
+#define ERROR_EC_EDGE_CAPTURE_CHANNEL_COUNT_OUT_OF_RANGE 0x26034
+#define ERROR_EC_EDGE_CAPTURE_CHANNEL_OUT_OF_RANGE 0x26035
+#define ERROR_EC_EDGE_CAPTURE_ASYN_PARAM_FAIL 0x26036
+#define ERROR_EC_EDGE_CAPTURE_NULL 0x26037
+#define ERROR_EC_EDGE_CAPTURE_INDEX_OUT_OF_RANGE 0x26038
+#define ERROR_EC_EDGE_CAPTURE_CHANNEL_EXISTS 0x26039
+
+#define ECMC_EC_EDGE_CAPTURE_MAX_CHANNELS 64
+#define ECMC_EC_EDGE_CAPTURE_MAX_FIFO 65536
+
+#define ECMC_EC_EDGE_CAPTURE_STR "edgecap"
+#define ECMC_EC_EDGE_CAPTURE_CHANNEL_STR "ch"
+#define ECMC_EC_EDGE_CAPTURE_COUNT_STR "count"
+#define ECMC_EC_EDGE_CAPTURE_EDGE_STR "edge"
+#define ECMC_EC_EDGE_CAPTURE_TIME_STR "time"
+
+// Edge of an event, also used as bit mask for the edges to capture
+enum ecmcEcEdge {
+  ECMC_EC_EDGE_NONE    = 0,
+  ECMC_EC_EDGE_RISING  = 1,
+  ECMC_EC_EDGE_FALLING = 2,
+  ECMC_EC_EDGE_BOTH    = 3,
+};
+
+enum ecmcEcEdgeChannelType {
+  ECMC_EC_EDGE_CHANNEL_BIT       = 0,
+  ECMC_EC_EDGE_CHANNEL_TIMESTAMP = 1,
+};
+
+struct ecmcEcEdgeSlot {
+  size_t   seq;     // Event number + 1 (0 while written)
+  uint64_t timeNs;
+  int      edge;
+};
+
+struct ecmcEcEdgeChannel {
+  int               type;
+  int               edges;   // Bit channel: edges to capture, timestamp: edge
+  ecmcEcEntry      *entry;
+  int               bit;
+  ecmcEcEdgeSlot   *slots;
+  size_t            head;    // Events written (epicsAtomic)
+  bool              updated;
+
+  // Plc reader
+  size_t            plcCursor;
+  uint64_t          plcTimeNs;
+
+  // Asyn
+  int32_t           asynCount;
+  int32_t           asynEdge;
+  uint64_t          asynTimeNs;
+  ecmcAsynDataItem *asynItems[3];
+};
+
+struct ecmcEcEdgeStamp {
+  const uint8_t *adr;
+  int            bytes;  // 4 or 8
+  uint64_t       old;
+  int            channel;
+};
+
+class ecmcEcEdgeCapture {
+public:
+  ecmcEcEdgeCapture(ecmcAsynPortDriver *asynPortDriver,
+                    int                 index,
+                    int                 fifoSize);
+  ~ecmcEcEdgeCapture();
+
+  // Returns 0 if created (fifo size valid)
+  int  getErrorCode();
+
+  // Config. Channel index in order added.
+  int  addBitChannel(ecmcEcEntry *entry,
+                     int          bit,
+                     int          edges);
+  int  addTimestampChannel(ecmcEcEntry *entry,
+                           int          edge);
+  int  getChannelCount();
+
+  // Bind to the process image (after master activation)
+  int  activate();
+
+  // Rt, cycleTimeNs = application time of the cycle of the inputs
+  void execute(uint64_t cycleTimeNs);
+
+  // Any thread. Returns 1 if an event was read, 0 if no new event.
+  // cursor is the number of the next event and is advanced past
+  // overwritten events.
+  int  readEvent(int       channel,
+                 size_t   *cursor,
+                 uint64_t *timeNs,
+                 int      *edge);
+  size_t getEventCount(int channel);
+
+  // Plc (rt), own cursor per channel
+  int      plcPop(int channel);
+  uint64_t plcGetTime(int channel);
+
+  void print();
+
+private:
+  int  addChannel(int          type,
+                  ecmcEcEntry *entry,
+                  int          bit,
+                  int          edges);
+  int  initAsyn(int channel);
+  void push(ecmcEcEdgeChannel *ch,
+            uint64_t           timeNs,
+            int                edge);
+  void refreshAsyn();
+
+  ecmcAsynPortDriver *asynPortDriver_;
+  int index_;
+  int errorCode_;
+  size_t fifoSize_;
+  size_t fifoMask_;
+  int channelCount_;
+  ecmcEcEdgeChannel channels_[ECMC_EC_EDGE_CAPTURE_MAX_CHANNELS];
+
+  // Rt
+  ecmcEcEdgeWord *words_;
+  int wordCount_;
+  ecmcEcEdgeStamp *stamps_;
+  int stampCount_;
+  bool active_;
+  bool firstCycle_;
+  bool anyUpdated_;
+};
+
+#endif  /* ECMC_EC_EDGE_CAPTURE_H_ */
@@ -0,0 +1,47 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcEcEdgeWords.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcEcEdgeWords.h"
+#include <algorithm>
+
+static bool edgeBitRefCompare(const ecmcEcEdgeBitRef& a,
+                              const ecmcEcEdgeBitRef& b) {
+  return a.adr < b.adr || (a.adr == b.adr && a.bit < b.bit);
+}
+
+int edgeWordsPack(std::vector<ecmcEcEdgeBitRef> refs,
+                  std::vector<ecmcEcEdgeWord> *words) {
+  words->clear();
+  std::sort(refs.begin(), refs.end(), edgeBitRefCompare);
+
+  for (size_t i = 0; i < refs.size(); i++) {
+    if (words->empty() || (refs[i].adr - words->back().adr >= 8)) {
+      ecmcEcEdgeWord word = {};
+      word.adr = refs[i].adr;
+      memset(word.channel, -1, sizeof(word.channel));
+      words->push_back(word);
+    }
+
+    ecmcEcEdgeWord& word = words->back();
+    int byte = (int)(refs[i].adr - word.adr);
+    int pos  = byte * 8 + refs[i].bit;
+
+    // Same process image bit from two channels
+    if (word.mask & (1ULL << pos)) {
+      return -1;
+    }
+    word.mask        |= 1ULL << pos;
+    word.channel[pos] = (int8_t)refs[i].channel;
+    word.bytes        = byte + 1;
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcEcEdgeWords.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+/**
+\file
+    @brief Packing of edge capture bit channels into process image words
+    (no dependencies to the ecmc objects, see ecmcEcEdgeCapture.h)
+*/
+
+#ifndef ECMC_EC_EDGE_WORDS_H_
+#define ECMC_EC_EDGE_WORDS_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// Bit of a bit channel in the process image
+struct ecmcEcEdgeBitRef {
+  const uint8_t *adr;
+  int            bit;  // 0..7
+  int            channel;
+};
+
+// Up to 8 process image bytes of bit channels
+struct ecmcEcEdgeWord {
+  const uint8_t *adr;
+  int            bytes;
+  uint64_t       mask;
+  uint64_t       old;
+  int8_t         channel[64];  // Channel of each bit
+};
+
+/** \brief Pack bits into words of up to 8 bytes.\n
+ *
+ * A word starts at the lowest address not covered by the previous word
+ * and only spans the bytes up to its last used bit (never loads past the
+ * last channel).\n
+ *
+ * \param[in] refs Bits of the channels (any order).\n
+ * \param[out] words Words in address order.\n
+ *
+ * \return 0 or -1 if two channels use the same bit.
+ */
+int edgeWordsPack(std::vector<ecmcEcEdgeBitRef> refs,
+                  std::vector<ecmcEcEdgeWord> *words);
+
+// Process image is little endian (as the host)
+inline uint64_t edgeWordLoad(const uint8_t *adr,
+                             int            bytes) {
+  uint64_t value = 0;
+
+  memcpy(&value, adr, bytes);
+  return value;
+}
+
+// Changed bits of the channels since last call, value = new word
+inline uint64_t edgeWordChanged(ecmcEcEdgeWord *word,
+                                uint64_t       *value) {
+  *value = edgeWordLoad(word->adr, word->bytes);
+  uint64_t changed = (*value ^ word->old) & word->mask;
+
+  word->old = *value;
+  return changed;
+}
+
+#endif  /* ECMC_EC_EDGE_WORDS_H_ */
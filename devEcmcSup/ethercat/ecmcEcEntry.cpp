@@ -12,6 +12,8 @@
 
 #include "ecmcEcEntry.h"
 #include <stdlib.h>
+#include <string.h>
+#include <vector>
 #include "ecmcErrorsList.h"
 
 #define EC_MASK_B2 0x03
@@ -46,6 +48,13 @@
           *((uint8_t *)(DATA)) |= ((VAL &EC_MASK_B4) << (POS));\
         } while (0)
 
+// Blocks of hot records (see ecmcEcEntryRt). Records are never moved since
+// asyn parameters and plugins hold pointers to the value. The blocks are
+// freed when the last entry is deleted.
+static std::vector<ecmcEcEntryRt *> rtBlocks;
+static size_t rtBlockUsed = ECMC_EC_ENTRY_RT_BLOCK_SIZE;
+static size_t rtCount     = 0;
+
 ecmcEcEntry::ecmcEcEntry(ecmcAsynPortDriver *asynPortDriver,
                          int                 masterId,
                          int                 slaveId,
@@ -58,6 +67,7 @@ ecmcEcEntry::ecmcEcEntry(ecmcAsynPortDriver *asynPortDriver,
                          ecmcEcDataType      dt,
                          std::string         id,
                          int                 useInRealtime) {
+  allocRt();
   initVars();
   asynPortDriver_   = asynPortDriver;
   masterId_         = masterId;
@@ -68,13 +78,12 @@ ecmcEcEntry::ecmcEcEntry(ecmcAsynPortDriver *asynPortDriver,
   direction_        = direction;
   sim_              = false;
   idString_         = id;
-  idStringChar_     = strdup(idString_.c_str());
   domain_           = domain;
   pdoIndex_         = pdoIndex;
   slave_            = slave;
   dataType_         = dt;
-  updateInRealTime_ = useInRealtime;
-  bindProcessImageHandlers();
+  setUpdateInRealtime(useInRealtime);
+  setRtFlags();
   int errorCode = ecrt_slave_config_pdo_mapping_add(slave,
                                                     pdoIndex_,
                                                     entryIndex_,
@@ -114,6 +123,7 @@ ecmcEcEntry::ecmcEcEntry(ecmcAsynPortDriver *asynPortDriver,
                          uint8_t            *domainAdr,
                          ecmcEcDataType      dt,
                          std::string         id) {
+  allocRt();
   initVars();
   asynPortDriver_ = asynPortDriver;
   masterId_       = masterId;
@@ -122,57 +132,82 @@ ecmcEcEntry::ecmcEcEntry(ecmcAsynPortDriver *asynPortDriver,
   sim_            = true;
   direction_      = EC_DIR_OUTPUT;
   idString_       = id;
-  idStringChar_   = strdup(idString_.c_str());
-  adr_            = 0;
   dataType_       = dt;
   bitLength_      = getEcDataTypeBits(dt);
-  bindProcessImageHandlers();
+  setRtFlags();
   initAsyn();
 }
 
 void ecmcEcEntry::initVars() {
   errorReset();
-  asynPortDriver_   = NULL;
-  masterId_         = -1;
-  slaveId_          = -1;
-  entryAsynParam_   = NULL;
-  domainAdr_        = NULL;
-  bitOffset_        = 0;
-  byteOffset_       = 0;
-  entryIndex_       = 0;
-  entrySubIndex_    = 0;
-  direction_        = EC_DIR_INVALID;
-  sim_              = false;
-  idString_         = "";
-  idStringChar_     = NULL;
-  asynPortDriver_   = NULL;
-  updateInRealTime_ = 1;
-  domain_           = NULL;
-  pdoIndex_         = 0;
-  slave_            = NULL;
-  buffer_           = 0;
-  dataType_         = ECMC_EC_NONE;
-  bitLength_        = 0;
-  int8Ptr_          = (int8_t *)&buffer_;
-  uint8Ptr_         = (uint8_t *)&buffer_;
-  int16Ptr_         = (int16_t *)&buffer_;
-  uint16Ptr_        = (uint16_t *)&buffer_;
-  int32Ptr_         = (int32_t *)&buffer_;
-  uint32Ptr_        = (uint32_t *)&buffer_;
-  int64Ptr_         = (int64_t *)&buffer_;
-  uint64Ptr_        = (uint64_t *)&buffer_;
-  float32Ptr_       = (float *)&buffer_;
-  float64Ptr_       = (double *)&buffer_;
-  usedSizeBytes_    = 0;
-  processImageReadFunc_ = &ecmcEcEntry::readNone;
-  processImageWriteFunc_ = &ecmcEcEntry::writeNone;
+  memset(rt_, 0, sizeof(ecmcEcEntryRt));
+  rt_->flags      = ECMC_EC_ENTRY_RT_UPDATE;
+  asynPortDriver_ = NULL;
+  masterId_       = -1;
+  slaveId_        = -1;
+  domainAdr_      = NULL;
+  bitOffset_      = 0;
+  byteOffset_     = 0;
+  entryIndex_     = 0;
+  entrySubIndex_  = 0;
+  direction_      = EC_DIR_INVALID;
+  sim_            = false;
+  custom_         = false;
+  idString_       = "";
+  domain_         = NULL;
+  pdoIndex_       = 0;
+  slave_          = NULL;
+  dataType_       = ECMC_EC_NONE;
+  bitLength_      = 0;
 }
 
 ecmcEcEntry::~ecmcEcEntry() {
-  free(idStringChar_);
-  idStringChar_ = NULL;
-  delete entryAsynParam_;
-  entryAsynParam_ = NULL;
+  delete rt_->asynParam;
+  rt_->asynParam = NULL;
+  rt_->flags     = 0;
+  rtCount--;
+
+  if (rtCount == 0) {
+    for (size_t i = 0; i < rtBlocks.size(); i++) {
+      delete[] rtBlocks[i];
+    }
+    rtBlocks.clear();
+    rtBlockUsed = ECMC_EC_ENTRY_RT_BLOCK_SIZE;
+  }
+}
+
+void ecmcEcEntry::allocRt() {
+  if (rtBlockUsed >= ECMC_EC_ENTRY_RT_BLOCK_SIZE) {
+    rtBlocks.push_back(new ecmcEcEntryRt[ECMC_EC_ENTRY_RT_BLOCK_SIZE]());
+    rtBlockUsed = 0;
+  }
+  rt_ = &rtBlocks.back()[rtBlockUsed];
+  rtBlockUsed++;
+  rtCount++;
+}
+
+// Mirror of the cold configuration used by the realtime loops
+void ecmcEcEntry::setRtFlags() {
+  uint8_t flags = rt_->flags & ECMC_EC_ENTRY_RT_UPDATE;
+
+  if (direction_ == EC_DIR_INPUT) {
+    flags |= ECMC_EC_ENTRY_RT_INPUT;
+  }
+
+  if ((direction_ == EC_DIR_OUTPUT) || sim_) {
+    flags |= ECMC_EC_ENTRY_RT_OUTPUT;
+  }
+
+  if (custom_) {
+    flags    |= ECMC_EC_ENTRY_RT_CUSTOM;
+    rt_->owner = this;
+  }
+  rt_->flags  = flags;
+  rt_->decode = (uint8_t)dataType_;
+}
+
+ecmcEcEntryRt * ecmcEcEntry::getRt() {
+  return rt_;
 }
 
 void ecmcEcEntry::setDomainAdr() {
@@ -213,39 +248,39 @@ int ecmcEcEntry::getBits() {
 }
 
 int ecmcEcEntry::writeValue(uint64_t value) {
-  buffer_ = value;
+  rt_->value.u64 = value;
   return updateAsyn(0);
 }
 
 int ecmcEcEntry::writeDouble(double value) {
   switch (dataType_) {
   case ECMC_EC_S8:
-    *int8Ptr_ = (int8_t)value;
+    rt_->value.s8 = (int8_t)value;
     break;
 
   case ECMC_EC_S16:
-    *int16Ptr_ = (int16_t)value;
+    rt_->value.s16 = (int16_t)value;
     break;
 
   case ECMC_EC_S32:
-    *int32Ptr_ = (int32_t)value;
+    rt_->value.s32 = (int32_t)value;
     break;
 
   case ECMC_EC_S64:
-    *int64Ptr_ = (int64_t)value;
+    rt_->value.s64 = (int64_t)value;
     break;
 
   case ECMC_EC_F32:
-    *float32Ptr_ = (float)value;
+    rt_->value.f32 = (float)value;
     break;
 
   case ECMC_EC_F64:
-    *float64Ptr_ = value;
+    rt_->value.f64 = value;
     break;
 
   default:
     // All unsigned and bits
-    buffer_ = (uint64_t)value;
+    rt_->value.u64 = (uint64_t)value;
     break;
   }
 
@@ -253,7 +288,7 @@ int ecmcEcEntry::writeDouble(double value) {
 }
 
 int ecmcEcEntry::writeValueForce(uint64_t value) {
-  buffer_ = value;
+  rt_->value.u64 = value;
   return updateAsyn(1);
 }
 
@@ -264,49 +299,49 @@ int ecmcEcEntry::writeBitForce(int bitNumber, uint64_t value) {
 
 int ecmcEcEntry::writeBit(int bitNumber, uint64_t value) {
   if (value) {
-    BIT_SET(buffer_, bitNumber);
+    BIT_SET(rt_->value.u64, bitNumber);
   } else {
-    BIT_CLEAR(buffer_, bitNumber);
+    BIT_CLEAR(rt_->value.u64, bitNumber);
   }
 
   return 0;
 }
 
 int ecmcEcEntry::readValue(uint64_t *value) {
-  *value = buffer_;
+  *value = rt_->value.u64;
   return 0;
 }
 
 int ecmcEcEntry::readDouble(double *value) {
   switch (dataType_) {
   case ECMC_EC_S8:
-    *value = (double)(*int8Ptr_);
+    *value = (double)(rt_->value.s8);
     break;
 
   case ECMC_EC_S16:
-    *value = (double)(*int16Ptr_);
+    *value = (double)(rt_->value.s16);
     break;
 
   case ECMC_EC_S32:
-    *value = (double)(*int32Ptr_);
+    *value = (double)(rt_->value.s32);
     break;
 
   case ECMC_EC_S64:
-    *value = (double)(*int64Ptr_);
+    *value = (double)(rt_->value.s64);
     break;
 
   case ECMC_EC_F32:
 
-    *value = (double)(*float32Ptr_);
+    *value = (double)(rt_->value.f32);
     break;
 
   case ECMC_EC_F64:
-    *value = *float64Ptr_;
+    *value = rt_->value.f64;
     break;
 
   default:
     // All unsigned and bits
-    *value = (double)(*uint64Ptr_);
+    *value = (double)(rt_->value.u64);
     break;
   }
 
@@ -314,198 +349,205 @@ int ecmcEcEntry::readDouble(double *value) {
 }
 
 int ecmcEcEntry::readBit(int bitNumber, uint64_t *value) {
-  *value = BIT_CHECK(buffer_, bitNumber) > 0;
+  *value = BIT_CHECK(rt_->value.u64, bitNumber) > 0;
   return 0;
 }
 
-void ecmcEcEntry::bindProcessImageHandlers() {
-  processImageReadFunc_  = &ecmcEcEntry::readNone;
-  processImageWriteFunc_ = &ecmcEcEntry::writeNone;
+void ecmcEcEntry::readRt(ecmcEcEntryRt *rt) {
+  uint8_t *adr = rt->adr;
 
-  switch (dataType_) {
-  case ECMC_EC_NONE:
-    break;
+  rt->value.u64 = 0;
+
+  switch (rt->decode) {
   case ECMC_EC_B1:
-    processImageReadFunc_  = &ecmcEcEntry::readB1;
-    processImageWriteFunc_ = &ecmcEcEntry::writeB1;
+    rt->value.u64 = (uint64_t)EC_READ_BIT(adr, rt->bitOffset);
     break;
   case ECMC_EC_B2:
-    processImageReadFunc_  = &ecmcEcEntry::readB2;
-    processImageWriteFunc_ = &ecmcEcEntry::writeB2;
+    rt->value.u64 = (uint64_t)EC_READ_B2(adr, rt->bitOffset);
     break;
   case ECMC_EC_B3:
-    processImageReadFunc_  = &ecmcEcEntry::readB3;
-    processImageWriteFunc_ = &ecmcEcEntry::writeB3;
+    rt->value.u64 = (uint64_t)EC_READ_B3(adr, rt->bitOffset);
     break;
   case ECMC_EC_B4:
-    processImageReadFunc_  = &ecmcEcEntry::readB4;
-    processImageWriteFunc_ = &ecmcEcEntry::writeB4;
+    rt->value.u64 = (uint64_t)EC_READ_B4(adr, rt->bitOffset);
     break;
   case ECMC_EC_U8:
-    processImageReadFunc_  = &ecmcEcEntry::readU8;
-    processImageWriteFunc_ = &ecmcEcEntry::writeU8;
+    rt->value.u64 = (uint64_t)EC_READ_U8(adr);
     break;
   case ECMC_EC_S8:
-    processImageReadFunc_  = &ecmcEcEntry::readS8;
-    processImageWriteFunc_ = &ecmcEcEntry::writeS8;
+    rt->value.u64 = (uint64_t)EC_READ_S8(adr);
     break;
   case ECMC_EC_S8_TO_U8:
-    processImageReadFunc_  = &ecmcEcEntry::readS8ToU8;
-    processImageWriteFunc_ = &ecmcEcEntry::writeS8ToU8;
+    rt->value.u64 = (uint64_t)(EC_READ_S8(adr) ^ 0x80u);
     break;
   case ECMC_EC_U16:
-    processImageReadFunc_  = &ecmcEcEntry::readU16;
-    processImageWriteFunc_ = &ecmcEcEntry::writeU16;
+    rt->value.u64 = (uint64_t)EC_READ_U16(adr);
     break;
   case ECMC_EC_S16:
-    processImageReadFunc_  = &ecmcEcEntry::readS16;
-    processImageWriteFunc_ = &ecmcEcEntry::writeS16;
+    rt->value.u64 = (uint64_t)EC_READ_S16(adr);
     break;
   case ECMC_EC_S16_TO_U16:
-    processImageReadFunc_  = &ecmcEcEntry::readS16ToU16;
-    processImageWriteFunc_ = &ecmcEcEntry::writeS16ToU16;
+    rt->value.u64 = (uint64_t)(EC_READ_S16(adr) ^ 0x8000u);
     break;
   case ECMC_EC_U32:
-    processImageReadFunc_  = &ecmcEcEntry::readU32;
-    processImageWriteFunc_ = &ecmcEcEntry::writeU32;
+    rt->value.u64 = (uint64_t)EC_READ_U32(adr);
     break;
   case ECMC_EC_S32:
-    processImageReadFunc_  = &ecmcEcEntry::readS32;
-    processImageWriteFunc_ = &ecmcEcEntry::writeS32;
+    rt->value.u64 = (uint64_t)EC_READ_S32(adr);
     break;
   case ECMC_EC_S32_TO_U32:
-    processImageReadFunc_  = &ecmcEcEntry::readS32ToU32;
-    processImageWriteFunc_ = &ecmcEcEntry::writeS32ToU32;
+    rt->value.u64 = (uint64_t)(EC_READ_S32(adr) ^ 0x80000000u);
     break;
-  case ECMC_EC_U64:
 #ifdef EC_READ_U64
-    processImageReadFunc_  = &ecmcEcEntry::readU64;
-#endif
-#ifdef EC_WRITE_U64
-    processImageWriteFunc_ = &ecmcEcEntry::writeU64;
-#endif
+  case ECMC_EC_U64:
+    rt->value.u64 = (uint64_t)EC_READ_U64(adr);
     break;
-  case ECMC_EC_S64:
-#ifdef EC_READ_S64
-    processImageReadFunc_  = &ecmcEcEntry::readS64;
-#endif
-#ifdef EC_WRITE_S64
-    processImageWriteFunc_ = &ecmcEcEntry::writeS64;
 #endif
+#ifdef EC_READ_S64
+  case ECMC_EC_S64:
+    rt->value.u64 = (uint64_t)EC_READ_S64(adr);
     break;
   case ECMC_EC_S64_TO_U64:
-#ifdef EC_READ_S64
-    processImageReadFunc_  = &ecmcEcEntry::readS64ToU64;
-#endif
-#ifdef EC_WRITE_S64
-    processImageWriteFunc_ = &ecmcEcEntry::writeS64ToU64;
-#endif
+    rt->value.u64 = (uint64_t)(EC_READ_S64(adr) ^ 0x8000000000000000ull);
     break;
-  case ECMC_EC_F32:
-#ifdef EC_READ_REAL
-    processImageReadFunc_  = &ecmcEcEntry::readF32;
-#endif
-#ifdef EC_WRITE_REAL
-    processImageWriteFunc_ = &ecmcEcEntry::writeF32;
 #endif
+#ifdef EC_READ_REAL
+  case ECMC_EC_F32:
+    rt->value.f32 = EC_READ_REAL(adr);
     break;
-  case ECMC_EC_F64:
-#ifdef EC_READ_LREAL
-    processImageReadFunc_  = &ecmcEcEntry::readF64;
-#endif
-#ifdef EC_WRITE_LREAL
-    processImageWriteFunc_ = &ecmcEcEntry::writeF64;
 #endif
+#ifdef EC_READ_LREAL
+  case ECMC_EC_F64:
+    rt->value.f64 = EC_READ_LREAL(adr);
     break;
+#endif
   default:
     break;
   }
 }
 
-void ecmcEcEntry::readNone() { buffer_ = 0; }
-void ecmcEcEntry::readB1() { buffer_ = (uint64_t)EC_READ_BIT(adr_, bitOffset_); }
-void ecmcEcEntry::readB2() { buffer_ = (uint64_t)EC_READ_B2(adr_, bitOffset_); }
-void ecmcEcEntry::readB3() { buffer_ = (uint64_t)EC_READ_B3(adr_, bitOffset_); }
-void ecmcEcEntry::readB4() { buffer_ = (uint64_t)EC_READ_B4(adr_, bitOffset_); }
-void ecmcEcEntry::readU8() { buffer_ = (uint64_t)EC_READ_U8(adr_); }
-void ecmcEcEntry::readS8() { buffer_ = (uint64_t)EC_READ_S8(adr_); }
-void ecmcEcEntry::readS8ToU8() { buffer_ = (uint64_t)(EC_READ_S8(adr_) ^ 0x80u); }
-void ecmcEcEntry::readU16() { buffer_ = (uint64_t)EC_READ_U16(adr_); }
-void ecmcEcEntry::readS16() { buffer_ = (uint64_t)EC_READ_S16(adr_); }
-void ecmcEcEntry::readS16ToU16() { buffer_ = (uint64_t)(EC_READ_S16(adr_) ^ 0x8000u); }
-void ecmcEcEntry::readU32() { buffer_ = (uint64_t)EC_READ_U32(adr_); }
-void ecmcEcEntry::readS32() { buffer_ = (uint64_t)EC_READ_S32(adr_); }
-void ecmcEcEntry::readS32ToU32() { buffer_ = (uint64_t)(EC_READ_S32(adr_) ^ 0x80000000u); }
-#ifdef EC_READ_U64
-void ecmcEcEntry::readU64() { buffer_ = (uint64_t)EC_READ_U64(adr_); }
-#endif
-#ifdef EC_READ_S64
-void ecmcEcEntry::readS64() { buffer_ = (uint64_t)EC_READ_S64(adr_); }
-void ecmcEcEntry::readS64ToU64() { buffer_ = (uint64_t)(EC_READ_S64(adr_) ^ 0x8000000000000000ull); }
-#endif
-#ifdef EC_READ_REAL
-void ecmcEcEntry::readF32() { *float32Ptr_ = EC_READ_REAL(adr_); }
-#endif
-#ifdef EC_READ_LREAL
-void ecmcEcEntry::readF64() { *float64Ptr_ = EC_READ_LREAL(adr_); }
-#endif
+void ecmcEcEntry::writeRt(ecmcEcEntryRt *rt) {
+  uint8_t *adr = rt->adr;
 
-void ecmcEcEntry::writeNone() { buffer_ = 0; }
-void ecmcEcEntry::writeB1() { EC_WRITE_BIT(adr_, bitOffset_, buffer_); }
-void ecmcEcEntry::writeB2() { EC_WRITE_B2(adr_, bitOffset_, buffer_); }
-void ecmcEcEntry::writeB3() { EC_WRITE_B3(adr_, bitOffset_, buffer_); }
-void ecmcEcEntry::writeB4() { EC_WRITE_B4(adr_, bitOffset_, buffer_); }
-void ecmcEcEntry::writeU8() { EC_WRITE_U8(adr_, buffer_); }
-void ecmcEcEntry::writeS8() { EC_WRITE_S8(adr_, buffer_); }
-void ecmcEcEntry::writeS8ToU8() { EC_WRITE_S8(adr_, buffer_ ^ 0x80u); }
-void ecmcEcEntry::writeU16() { EC_WRITE_U16(adr_, buffer_); }
-void ecmcEcEntry::writeS16() { EC_WRITE_S16(adr_, buffer_); }
-void ecmcEcEntry::writeS16ToU16() { EC_WRITE_S16(adr_, buffer_ ^ 0x8000u); }
-void ecmcEcEntry::writeU32() { EC_WRITE_U32(adr_, buffer_); }
-void ecmcEcEntry::writeS32() { EC_WRITE_S32(adr_, buffer_); }
-void ecmcEcEntry::writeS32ToU32() { EC_WRITE_S32(adr_, buffer_ ^ 0x80000000u); }
+  switch (rt->decode) {
+  case ECMC_EC_B1:
+    EC_WRITE_BIT(adr, rt->bitOffset, rt->value.u64);
+    break;
+  case ECMC_EC_B2:
+    EC_WRITE_B2(adr, rt->bitOffset, rt->value.u64);
+    break;
+  case ECMC_EC_B3:
+    EC_WRITE_B3(adr, rt->bitOffset, rt->value.u64);
+    break;
+  case ECMC_EC_B4:
+    EC_WRITE_B4(adr, rt->bitOffset, rt->value.u64);
+    break;
+  case ECMC_EC_U8:
+    EC_WRITE_U8(adr, rt->value.u64);
+    break;
+  case ECMC_EC_S8:
+    EC_WRITE_S8(adr, rt->value.u64);
+    break;
+  case ECMC_EC_S8_TO_U8:
+    EC_WRITE_S8(adr, rt->value.u64 ^ 0x80u);
+    break;
+  case ECMC_EC_U16:
+    EC_WRITE_U16(adr, rt->value.u64);
+    break;
+  case ECMC_EC_S16:
+    EC_WRITE_S16(adr, rt->value.u64);
+    break;
+  case ECMC_EC_S16_TO_U16:
+    EC_WRITE_S16(adr, rt->value.u64 ^ 0x8000u);
+    break;
+  case ECMC_EC_U32:
+    EC_WRITE_U32(adr, rt->value.u64);
+    break;
+  case ECMC_EC_S32:
+    EC_WRITE_S32(adr, rt->value.u64);
+    break;
+  case ECMC_EC_S32_TO_U32:
+    EC_WRITE_S32(adr, rt->value.u64 ^ 0x80000000u);
+    break;
 #ifdef EC_WRITE_U64
-void ecmcEcEntry::writeU64() { EC_WRITE_U64(adr_, buffer_); }
+  case ECMC_EC_U64:
+    EC_WRITE_U64(adr, rt->value.u64);
+    break;
 #endif
 #ifdef EC_WRITE_S64
-void ecmcEcEntry::writeS64() { EC_WRITE_S64(adr_, buffer_); }
-void ecmcEcEntry::writeS64ToU64() { EC_WRITE_S64(adr_, buffer_ ^ 0x8000000000000000ull); }
+  case ECMC_EC_S64:
+    EC_WRITE_S64(adr, rt->value.u64);
+    break;
+  case ECMC_EC_S64_TO_U64:
+    EC_WRITE_S64(adr, rt->value.u64 ^ 0x8000000000000000ull);
+    break;
 #endif
 #ifdef EC_WRITE_REAL
-void ecmcEcEntry::writeF32() { EC_WRITE_REAL(adr_, *float32Ptr_); }
+  case ECMC_EC_F32:
+    EC_WRITE_REAL(adr, rt->value.f32);
+    break;
 #endif
 #ifdef EC_WRITE_LREAL
-void ecmcEcEntry::writeF64() { EC_WRITE_LREAL(adr_, *float64Ptr_); }
+  case ECMC_EC_F64:
+    EC_WRITE_LREAL(adr, rt->value.f64);
+    break;
 #endif
+  default:
+    // No handler for data type
+    rt->value.u64 = 0;
+    break;
+  }
+}
 
-int ecmcEcEntry::updateInputProcessImage() {
-  if (!updateInRealTime_) {
-    return 0;
+// Types of asynParam are restricted to the supported ones when linked
+void ecmcEcEntry::updateAsynRt(ecmcEcEntryRt *rt, bool force) {
+  if (rt->asynParam) {
+    rt->asynParam->refreshParamRT(force, (uint8_t *)&rt->value, rt->sizeBytes);
   }
+}
 
-  if (direction_ != EC_DIR_INPUT) {
-    return 0;
+void ecmcEcEntry::updateInputProcessImageRt(ecmcEcEntryRt *rt) {
+  const uint8_t flags = rt->flags;
+
+  if (flags & ECMC_EC_ENTRY_RT_CUSTOM) {
+    rt->owner->updateInputProcessImage();
+    return;
   }
 
-  buffer_ = 0;
-  (this->*processImageReadFunc_)();
+  if ((flags & (ECMC_EC_ENTRY_RT_UPDATE | ECMC_EC_ENTRY_RT_INPUT)) !=
+      (ECMC_EC_ENTRY_RT_UPDATE | ECMC_EC_ENTRY_RT_INPUT)) {
+    return;
+  }
 
-  updateAsyn(0);
-  return 0;
+  readRt(rt);
+  updateAsynRt(rt, 0);
 }
 
-int ecmcEcEntry::updateOutProcessImage() {
-  if (!updateInRealTime_) {
-    return 0;
+void ecmcEcEntry::updateOutProcessImageRt(ecmcEcEntryRt *rt) {
+  const uint8_t flags = rt->flags;
+
+  if (flags & ECMC_EC_ENTRY_RT_CUSTOM) {
+    rt->owner->updateOutProcessImage();
+    return;
   }
 
-  if ((direction_ != EC_DIR_OUTPUT) && !sim_) {
-    return 0;
+  if ((flags & (ECMC_EC_ENTRY_RT_UPDATE | ECMC_EC_ENTRY_RT_OUTPUT)) !=
+      (ECMC_EC_ENTRY_RT_UPDATE | ECMC_EC_ENTRY_RT_OUTPUT)) {
+    return;
   }
 
-  (this->*processImageWriteFunc_)();
+  writeRt(rt);
+  updateAsynRt(rt, 0);
+}
+
+// Overridden by classes with custom process image handling
+int ecmcEcEntry::updateInputProcessImage() {
+  updateInputProcessImageRt(rt_);
+  return 0;
+}
 
-  updateAsyn(0);
+int ecmcEcEntry::updateOutProcessImage() {
+  updateOutProcessImageRt(rt_);
   return 0;
 }
 
@@ -514,37 +556,19 @@ std::string ecmcEcEntry::getIdentificationName() {
 }
 
 int ecmcEcEntry::updateAsyn(bool force) {
-  if (!entryAsynParam_) {
+  if (!rt_->asynParam) {
     return 0;
   }
 
-  switch (entryAsynParam_->getAsynParameterType()) {
+  switch (rt_->asynParam->getAsynParameterType()) {
   case asynParamInt32:
-
-    entryAsynParam_->refreshParamRT(force, (uint8_t *)&buffer_,
-                                    usedSizeBytes_);
-    break;
-
   case asynParamUInt32Digital:
-
-    entryAsynParam_->refreshParamRT(force, (uint8_t *)&buffer_,
-                                    usedSizeBytes_);
-    break;
-
   case asynParamFloat64:
-
-    entryAsynParam_->refreshParamRT(force, (uint8_t *)&buffer_,
-                                    usedSizeBytes_);
-    break;
-
 #ifdef ECMC_ASYN_ASYNPARAMINT64
-
   case asynParamInt64:
-
-    entryAsynParam_->refreshParamRT(force, (uint8_t *)&buffer_,
-                                    usedSizeBytes_);
-    break;
 #endif //ECMC_ASYN_ASYNPARAMINT64
+    updateAsynRt(rt_, force);
+    break;
 
   default:
     return setErrorID(__FILE__,
@@ -566,12 +590,16 @@ uint8_t * ecmcEcEntry::getDomainAdr() {
 }
 
 int ecmcEcEntry::setUpdateInRealtime(int update) {
-  updateInRealTime_ = update;
+  if (update) {
+    rt_->flags |= ECMC_EC_ENTRY_RT_UPDATE;
+  } else {
+    rt_->flags &= ~ECMC_EC_ENTRY_RT_UPDATE;
+  }
   return 0;
 }
 
 int ecmcEcEntry::getUpdateInRealtime() {
-  return updateInRealTime_;
+  return (rt_->flags & ECMC_EC_ENTRY_RT_UPDATE) != 0;
 }
 
 int ecmcEcEntry::compileRegInfo() {
@@ -658,7 +686,8 @@ int ecmcEcEntry::validate() {
   }
 
   // Calculate final address
-  adr_ = domainAdr_ + byteOffset_;
+  rt_->adr       = domainAdr_ + byteOffset_;
+  rt_->bitOffset = (uint8_t)bitOffset_;
 
   return 0;
 }
@@ -678,7 +707,7 @@ int ecmcEcEntry::initAsyn() {
                                     ECMC_EC_STR "%d." ECMC_SLAVE_CHAR "%d.%s",
                                     masterId_,
                                     slaveId_,
-                                    idStringChar_);
+                                    idString_.c_str());
 
   if (charCount >= sizeof(buffer) - 1) {
     LOGERR(
@@ -692,15 +721,15 @@ int ecmcEcEntry::initAsyn() {
                       __LINE__,
                       ERROR_EC_ENTRY_REGISTER_FAIL);
   }
-  name            = buffer;
-  entryAsynParam_ = asynPortDriver_->addNewAvailParam(name,
-                                                      asynParamInt32, // default type
-                                                      (uint8_t *)&(buffer_),
-                                                      sizeof(buffer_),
-                                                      dataType_,
-                                                      0);
-
-  if (!entryAsynParam_) {
+  name           = buffer;
+  rt_->asynParam = asynPortDriver_->addNewAvailParam(name,
+                                                     asynParamInt32, // default type
+                                                     (uint8_t *)&rt_->value,
+                                                     sizeof(rt_->value),
+                                                     dataType_,
+                                                     0);
+
+  if (!rt_->asynParam) {
     LOGERR(
       "%s/%s:%d: ERROR: Add create default parameter for %s failed.\n",
       __FILE__,
@@ -721,150 +750,150 @@ int ecmcEcEntry::initAsyn() {
     break;
 
   case ECMC_EC_B1:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 1;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 1;
     break;
 
   case ECMC_EC_B2:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 1;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 1;
     break;
 
   case ECMC_EC_B3:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 1;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 1;
     break;
 
   case ECMC_EC_B4:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 1;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 1;
     break;
 
   case ECMC_EC_U8:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 1;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 1;
     break;
 
   case ECMC_EC_S8:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 1;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 1;
     break;
 
   case ECMC_EC_S8_TO_U8:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 1;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 1;
     break;
 
   case ECMC_EC_U16:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 2;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 2;
     break;
 
   case ECMC_EC_S16:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 2;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 2;
     break;
 
   case ECMC_EC_S16_TO_U16:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 2;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 2;
     break;
 
   case ECMC_EC_U32:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 4;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 4;
     break;
 
   case ECMC_EC_S32:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 4;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 4;
     break;
 
   case ECMC_EC_S32_TO_U32:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 4;
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 4;
     break;
 
   case ECMC_EC_U64:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
 
 #ifdef ECMC_ASYN_ASYNPARAMINT64
-    entryAsynParam_->addSupportedAsynType(asynParamInt64);
+    rt_->asynParam->addSupportedAsynType(asynParamInt64);
 #endif //ECMC_ASYN_ASYNPARAMINT64
 
-    usedSizeBytes_ = 8;
+    rt_->sizeBytes = 8;
     break;
 
   case ECMC_EC_S64:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
 
 #ifdef ECMC_ASYN_ASYNPARAMINT64
-    entryAsynParam_->addSupportedAsynType(asynParamInt64);
+    rt_->asynParam->addSupportedAsynType(asynParamInt64);
 #endif //ECMC_ASYN_ASYNPARAMINT64
 
-    usedSizeBytes_ = 8;
+    rt_->sizeBytes = 8;
     break;
 
   case ECMC_EC_S64_TO_U64:
-    entryAsynParam_->addSupportedAsynType(asynParamInt32);
-    entryAsynParam_->addSupportedAsynType(asynParamUInt32Digital);
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
+    rt_->asynParam->addSupportedAsynType(asynParamInt32);
+    rt_->asynParam->addSupportedAsynType(asynParamUInt32Digital);
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
 
 #ifdef ECMC_ASYN_ASYNPARAMINT64
-    entryAsynParam_->addSupportedAsynType(asynParamInt64);
+    rt_->asynParam->addSupportedAsynType(asynParamInt64);
 #endif //ECMC_ASYN_ASYNPARAMINT64
 
-    usedSizeBytes_ = 8;
+    rt_->sizeBytes = 8;
     break;
 
   case ECMC_EC_F32:
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 4;
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 4;
     break;
 
   case ECMC_EC_F64:
-    entryAsynParam_->addSupportedAsynType(asynParamFloat64);
-    usedSizeBytes_ = 8;
+    rt_->asynParam->addSupportedAsynType(asynParamFloat64);
+    rt_->sizeBytes = 8;
     break;
   }
-  entryAsynParam_->setEcmcDataSize(usedSizeBytes_);
+  rt_->asynParam->setEcmcDataSize(rt_->sizeBytes);
 
-  entryAsynParam_->setAllowWriteToEcmc(direction_ == EC_DIR_OUTPUT || sim_);
-  entryAsynParam_->setEcmcBitCount(bitLength_);
-  entryAsynParam_->setEcmcMinValueInt(getEcDataTypeMinVal(dataType_));
-  entryAsynParam_->setEcmcMaxValueInt(getEcDataTypeMaxVal(dataType_));
+  rt_->asynParam->setAllowWriteToEcmc(direction_ == EC_DIR_OUTPUT || sim_);
+  rt_->asynParam->setEcmcBitCount(bitLength_);
+  rt_->asynParam->setEcmcMinValueInt(getEcDataTypeMinVal(dataType_));
+  rt_->asynParam->setEcmcMaxValueInt(getEcDataTypeMaxVal(dataType_));
 
-  entryAsynParam_->refreshParam(1);
+  rt_->asynParam->refreshParam(1);
   asynPortDriver_->callParamCallbacks(ECMC_ASYN_DEFAULT_LIST,
                                       ECMC_ASYN_DEFAULT_ADDR);
   return 0;
@@ -873,14 +902,14 @@ int ecmcEcEntry::initAsyn() {
 int ecmcEcEntry::setComAlarm(bool alarm) {
   asynStatus stat;
 
-  if (entryAsynParam_ == NULL) {
+  if (rt_->asynParam == NULL) {
     return 0;
   }
 
   if (alarm) {
-    stat = entryAsynParam_->setAlarmParam(COMM_ALARM, INVALID_ALARM);
+    stat = rt_->asynParam->setAlarmParam(COMM_ALARM, INVALID_ALARM);
   } else {
-    stat = entryAsynParam_->setAlarmParam(NO_ALARM, NO_ALARM);
+    stat = rt_->asynParam->setAlarmParam(NO_ALARM, NO_ALARM);
   }
 
   if (stat != asynSuccess) {
@@ -939,9 +968,9 @@ int ecmcEcEntry::writeBits(int startBitNumber, int bits,
   const uint64_t fieldMask = lowMask << static_cast<uint64_t>(startBitNumber);
  
   // Clear target field and OR in the new bits
-  const uint64_t cleared   = static_cast<uint64_t>(buffer_) & ~fieldMask;
+  const uint64_t cleared   = static_cast<uint64_t>(rt_->value.u64) & ~fieldMask;
   const uint64_t result    = cleared | (writePart << static_cast<uint64_t>(startBitNumber));
-  buffer_ =static_cast<uint64_t>(result);
+  rt_->value.u64 =static_cast<uint64_t>(result);
   return 0;
 }
 
@@ -960,7 +989,7 @@ int ecmcEcEntry::readBits(int startBitNumber, int bits, uint64_t *result) {
   const uint64_t lowMask = (bits == 64) ? ~uint64_t(0) : ((uint64_t(1) << bits) - 1u);
  
   // Shift down and mask
-  *result = (buffer_ >> static_cast<uint64_t>(startBitNumber)) & lowMask;
+  *result = (rt_->value.u64 >> static_cast<uint64_t>(startBitNumber)) & lowMask;
  
   return 0;
 }
@@ -61,6 +61,46 @@
 #define ERROR_EC_ENTRY_SIZE_OUT_OF_RANGE 0x21010
 
 
+// Flags of ecmcEcEntryRt
+#define ECMC_EC_ENTRY_RT_UPDATE 0x01  // Update in realtime
+#define ECMC_EC_ENTRY_RT_INPUT 0x02
+#define ECMC_EC_ENTRY_RT_OUTPUT 0x04  // Output or simulation entry
+#define ECMC_EC_ENTRY_RT_CUSTOM 0x08  // Process image handled by owner
+
+// Hot records are allocated in blocks of this size (in creation order)
+#define ECMC_EC_ENTRY_RT_BLOCK_SIZE 256
+
+class ecmcEcEntry;
+
+/**
+*  Per cycle data of an entry (32 bytes). The records are allocated
+*  contiguously by ecmcEcEntry and the slave realtime loops only touch these.
+*  Names and configuration stay in ecmcEcEntry (cold).
+*/
+struct ecmcEcEntryRt {
+  union {
+    uint64_t u64;
+    int64_t  s64;
+    uint32_t u32;
+    int32_t  s32;
+    uint16_t u16;
+    int16_t  s16;
+    uint8_t  u8;
+    int8_t   s8;
+    float    f32;
+    double   f64;
+  } value;
+  union {
+    uint8_t     *adr;    // Process image address
+    ecmcEcEntry *owner;  // ECMC_EC_ENTRY_RT_CUSTOM
+  };
+  ecmcAsynDataItem *asynParam;
+  uint8_t           bitOffset;
+  uint8_t           decode;     // ecmcEcDataType
+  uint8_t           flags;
+  uint8_t           sizeBytes;  // Bytes of value used by asynParam
+};
+
 class ecmcEcEntry : public ecmcError {
 public:
   ecmcEcEntry(ecmcAsynPortDriver *asynPortDriver,
@@ -124,101 +164,42 @@ public:
   virtual int           getDomainOK();
   virtual ecmcEcDomain* getDomain();
   ec_direction_t        getDirection();
+  ecmcEcEntryRt*        getRt();
 
-protected:
-  typedef void (ecmcEcEntry::*processImageReadFuncPtr)();
-  typedef void (ecmcEcEntry::*processImageWriteFuncPtr)();
+  // Realtime loops of slave (dispatch to owner if ECMC_EC_ENTRY_RT_CUSTOM)
+  static void           updateInputProcessImageRt(ecmcEcEntryRt *rt);
+  static void           updateOutProcessImageRt(ecmcEcEntryRt *rt);
 
+protected:
   void                  setDomainAdr();
   int                   initAsyn();
-  void                  bindProcessImageHandlers();
-  void                  readNone();
-  void                  readB1();
-  void                  readB2();
-  void                  readB3();
-  void                  readB4();
-  void                  readU8();
-  void                  readS8();
-  void                  readS8ToU8();
-  void                  readU16();
-  void                  readS16();
-  void                  readS16ToU16();
-  void                  readU32();
-  void                  readS32();
-  void                  readS32ToU32();
-#ifdef EC_READ_U64
-  void                  readU64();
-#endif
-#ifdef EC_READ_S64
-  void                  readS64();
-  void                  readS64ToU64();
-#endif
-#ifdef EC_READ_REAL
-  void                  readF32();
-#endif
-#ifdef EC_READ_LREAL
-  void                  readF64();
-#endif
-  void                  writeNone();
-  void                  writeB1();
-  void                  writeB2();
-  void                  writeB3();
-  void                  writeB4();
-  void                  writeU8();
-  void                  writeS8();
-  void                  writeS8ToU8();
-  void                  writeU16();
-  void                  writeS16();
-  void                  writeS16ToU16();
-  void                  writeU32();
-  void                  writeS32();
-  void                  writeS32ToU32();
-#ifdef EC_WRITE_U64
-  void                  writeU64();
-#endif
-#ifdef EC_WRITE_S64
-  void                  writeS64();
-  void                  writeS64ToU64();
-#endif
-#ifdef EC_WRITE_REAL
-  void                  writeF32();
-#endif
-#ifdef EC_WRITE_LREAL
-  void                  writeF64();
-#endif
+  void                  allocRt();
+  void                  setRtFlags();
+  static void           readRt(ecmcEcEntryRt *rt);
+  static void           writeRt(ecmcEcEntryRt *rt);
+  static void           updateAsynRt(ecmcEcEntryRt *rt,
+                                     bool           force);
+
+  // Hot
+  ecmcEcEntryRt *rt_;
+
+  // Cold
   uint8_t *domainAdr_;
-  uint8_t *adr_;
   uint16_t entryIndex_;
   uint8_t entrySubIndex_;
   int16_t pdoIndex_;
   uint bitOffset_;
   bool sim_;
+  bool custom_;
   std::string idString_;
-  char *idStringChar_;
-  int updateInRealTime_;
   int masterId_;
   int slaveId_;
   int bitLength_;
   int byteOffset_;
   ecmcAsynPortDriver *asynPortDriver_;
-  ecmcAsynDataItem *entryAsynParam_;
   ecmcEcDataType dataType_;
   ec_slave_config_t *slave_;
   ecmcEcDomain *domain_;
   ec_direction_t direction_;
-  uint64_t buffer_;
-  int8_t *int8Ptr_;
-  uint8_t *uint8Ptr_;
-  int16_t *int16Ptr_;
-  uint16_t *uint16Ptr_;
-  int32_t *int32Ptr_;
-  uint32_t *uint32Ptr_;
-  int64_t *int64Ptr_;
-  uint64_t *uint64Ptr_;
-  float *float32Ptr_;
-  double *float64Ptr_;
-  size_t usedSizeBytes_;
-  processImageReadFuncPtr processImageReadFunc_;
-  processImageWriteFuncPtr processImageWriteFunc_;
 };
 #endif  /* ECMCECENTRY_H_ */
@@ -32,7 +32,8 @@ ecmcEcMemMap::ecmcEcMemMap(ecmcAsynPortDriver *asynPortDriver,
   direction_       = nDirection;
   idString_        = id;
   idStringChar_    = strdup(idString_.c_str());
-  buffer_          = new uint8_t[byteSize_];
+  bufferAlloc_     = new uint8_t[byteSize_];
+  buffer_          = bufferAlloc_;
   slaveId_         = slaveId;
   dataType_        = dt;
   bytesPerElement_ = getEcDataTypeByteSize(dataType_);
@@ -53,6 +54,7 @@ void ecmcEcMemMap::initVars() {
   startEntry_      = NULL;
   byteSize_        = 0;
   buffer_          = NULL;
+  bufferAlloc_     = NULL;
   domainSize_      = 0;
   adr_             = 0;
   memMapAsynParam_ = NULL;
@@ -73,8 +75,9 @@ void ecmcEcMemMap::initVars() {
 }
 
 ecmcEcMemMap::~ecmcEcMemMap() {
-  delete[] buffer_;
-  buffer_ = NULL;
+  delete[] bufferAlloc_;
+  bufferAlloc_ = NULL;
+  buffer_      = NULL;
   free(idStringChar_);
   idStringChar_ = NULL;
   delete memMapAsynParam_;
@@ -112,6 +115,14 @@ int ecmcEcMemMap::updateInputProcessImage() {
     return 0;
   }
 
+  // Array buffered asyn param: copy directly to the buffer handed over to
+  // the publisher thread (no extra copy in rt)
+  uint8_t *writeBuffer = memMapAsynParam_->getArrayWriteBuffer();
+
+  if (writeBuffer) {
+    buffer_ = writeBuffer;
+  }
+
   memcpy(buffer_, adr_, byteSize_);
   updateAsyn(0);
   return 0;
@@ -136,7 +147,7 @@ int ecmcEcMemMap::setDomainSize() {
 }
 
 int ecmcEcMemMap::updateAsyn(bool force) {
-  memMapAsynParam_->refreshParamRT(force);
+  memMapAsynParam_->refreshParamRT(force, buffer_, byteSize_);
   return 0;
 }
 
@@ -73,7 +73,8 @@ private:
   int slaveId_;
   uint8_t *domainAdr_;
   uint8_t *adr_;
-  uint8_t *buffer_;
+  uint8_t *buffer_;       // Current buffer (array buffer if asyn buffered)
+  uint8_t *bufferAlloc_;
   ec_direction_t direction_;
   std::string idString_;
   char *idStringChar_;
@@ -523,7 +523,7 @@ ecmcEcEntry * ecmcEcSlave::getEntry(int entryIndex) {
 int ecmcEcSlave::updateInputProcessImage() {
   const uint entryCountInUse = entryCounterRtInput_;
   for (uint i = 0; i < entryCountInUse; i++) {
-    entryListRtInput_[i]->updateInputProcessImage();
+    ecmcEcEntry::updateInputProcessImageRt(entryListRtInput_[i]);
   }
 
   // Execute async SDOs
@@ -538,7 +538,7 @@ int ecmcEcSlave::updateInputProcessImage() {
 int ecmcEcSlave::updateOutProcessImage() {
   const uint entryCountInUse = entryCounterRtOutput_;
   for (uint i = 0; i < entryCountInUse; i++) {
-    entryListRtOutput_[i]->updateOutProcessImage();
+    ecmcEcEntry::updateOutProcessImageRt(entryListRtOutput_[i]);
   }
 
   return 0;
@@ -697,52 +697,24 @@ int ecmcEcSlave::configDC(
 }
 
 ecmcEcEntry * ecmcEcSlave::findEntry(std::string id) {
-  for (uint i = 0; i < entryCounter_; i++) {
-    if (entryList_[i]) {
-      if (entryList_[i]->getIdentificationName().compare(id) == 0) {
-        return entryList_[i];
-      }
-    }
-  }
-
-  // for (int i = 0; i < syncManCounter_; i++) {
-  //  temp = syncManagerArray_[i]->findEntry(id);
-  //
-  //  if (temp) {
-  //    return temp;
-  //  }
-  // }
+  // All entries (also simulation entries) are in entryList_
+  std::unordered_map<std::string, int>::const_iterator it =
+    entryIndexByAlias_.find(id);
 
-  // Simulation entries
-  for (int i = 0; i < SIMULATION_ENTRIES; i++) {
-    if (simEntries_[i] != NULL) {
-      if (simEntries_[i]->getIdentificationName().compare(id) == 0) {
-        return simEntries_[i];
-      }
-    }
+  if (it == entryIndexByAlias_.end()) {
+    return NULL;
   }
-  return NULL;
+  return entryList_[it->second];
 }
 
 int ecmcEcSlave::findEntryIndex(std::string id) {
-  // Real entries
-  const int realEntryCount = entryCounter_;
-  for (int i = 0; i < realEntryCount; i++) {
-    if (entryList_[i] != NULL) {
-      if (entryList_[i]->getIdentificationName().compare(id) == 0) {
-        return i;
-      }
-    }
-  }
+  std::unordered_map<std::string, int>::const_iterator it =
+    entryIndexByAlias_.find(id);
 
-  // Simulation entries
-  for (int i = 0; i < SIMULATION_ENTRIES; i++) {
-    if (simEntries_[i] != NULL) {
-      if (simEntries_[i]->getIdentificationName().compare(id) == 0) {
-        return i;
-      }
-    }
+  if (it != entryIndexByAlias_.end()) {
+    return it->second;
   }
+
   LOGERR("%s/%s:%d: ERROR: Slave %d (0x%x,0x%x): Entry not found (0x%x).\n",
          __FILE__,
          __FUNCTION__,
@@ -930,6 +902,9 @@ int ecmcEcSlave::appendEntryToList(ecmcEcEntry *entry, bool useInRealTime) {
     return ERROR_EC_SLAVE_ENTRY_INDEX_OUT_OF_RANGE;
   }
   entryList_[entryCounter_] = entry;
+
+  // Keep first entry if alias is used more than once
+  entryIndexByAlias_.emplace(entry->getIdentificationName(), entryCounter_);
   entryCounter_++;
 
   // Only add to real-time lists if in real-time.
@@ -938,13 +913,13 @@ int ecmcEcSlave::appendEntryToList(ecmcEcEntry *entry, bool useInRealTime) {
       if (entryCounterRtInput_ >= EC_MAX_ENTRIES) {
         return ERROR_EC_SLAVE_ENTRY_INDEX_OUT_OF_RANGE;
       }
-      entryListRtInput_[entryCounterRtInput_] = entry;
+      entryListRtInput_[entryCounterRtInput_] = entry->getRt();
       entryCounterRtInput_++;
     } else if (entry->getDirection() == EC_DIR_OUTPUT || entry->getSimEntry()) {
       if (entryCounterRtOutput_ >= EC_MAX_ENTRIES) {
         return ERROR_EC_SLAVE_ENTRY_INDEX_OUT_OF_RANGE;
       }
-      entryListRtOutput_[entryCounterRtOutput_] = entry;
+      entryListRtOutput_[entryCounterRtOutput_] = entry->getRt();
       entryCounterRtOutput_++;
     }
   }
@@ -16,6 +16,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include "stdio.h"
 #include "ecrt.h"
 #include "ecmcDefinitions.h"
@@ -204,8 +205,12 @@ private:
   ecmcEcSyncManager *syncManagerArray_[EC_MAX_SYNC_MANAGERS];
   ecmcEcEntry *entryList_[EC_MAX_ENTRIES];
   uint32_t entryCounter_;
-  ecmcEcEntry *entryListRtInput_[EC_MAX_ENTRIES];
-  ecmcEcEntry *entryListRtOutput_[EC_MAX_ENTRIES];
+
+  // Alias to index in entryList_ (first entry with alias, cfg lookups)
+  std::unordered_map<std::string, int> entryIndexByAlias_;
+  // Hot records of entries updated in realtime (see ecmcEcEntryRt)
+  ecmcEcEntryRt *entryListRtInput_[EC_MAX_ENTRIES];
+  ecmcEcEntryRt *entryListRtOutput_[EC_MAX_ENTRIES];
   uint32_t entryCounterRtInput_;
   uint32_t entryCounterRtOutput_;
   int pdosArrayIndex_;
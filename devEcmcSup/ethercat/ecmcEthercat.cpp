@@ -22,6 +22,20 @@
 #include "ecmcEcEntry.h"
 
 #include "ecmcGlobalsExtern.h"
+#include <new>
+
+#define CHECK_EDGE_CAPTURE_RETURN_IF_ERROR(edgeCaptureIndex)\
+        {\
+          if (!edgeCaptures.validIndex(edgeCaptureIndex)) {\
+            LOGERR("ERROR: Edge capture index out of range.\n");\
+            return ERROR_EC_EDGE_CAPTURE_INDEX_OUT_OF_RANGE;\
+          }\
+          if (edgeCaptures[edgeCaptureIndex] == NULL) {\
+            LOGERR("ERROR: Edge capture object NULL.\n");\
+            return ERROR_EC_EDGE_CAPTURE_NULL;\
+          }\
+        }\
+
 
 int ecSetMaster(int masterIndex) {
   LOGINFO4("%s/%s:%d masterIndex=%d \n",
@@ -1097,6 +1111,181 @@ int ecSetDelayECOkAtStartup(int milliseconds) {
   return ec->setEcOkDelayCycles((int)(milliseconds / ((mcuPeriod / 1E6))));
 }
 
+int ecSetDcDiag(int enable) {
+  LOGINFO4("%s/%s:%d enable=%d\n", __FILE__, __FUNCTION__, __LINE__, enable);
+  return ec->setDcDiag(enable);
+}
+
+int ecSetDcWakeupCtrl(int    enable,
+                      double phaseUs,
+                      double kp,
+                      double ki,
+                      double maxAdjustUs) {
+  LOGINFO4("%s/%s:%d enable=%d phaseUs=%lf kp=%lf ki=%lf maxAdjustUs=%lf\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           enable,
+           phaseUs,
+           kp,
+           ki,
+           maxAdjustUs);
+  return ec->setDcWakeupCtrl(enable, phaseUs, kp, ki, maxAdjustUs);
+}
+
+int ecPrintDcDiag() {
+  LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
+  return ec->printDcDiag();
+}
+
+int ecCreateEdgeCapture(int index,
+                        int fifoSize) {
+  LOGINFO4("%s/%s:%d index=%d fifoSize=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           fifoSize);
+
+  if ((index < 0) || (index >= ECMC_REGISTRY_MAX_SIZE)) {
+    return ERROR_EC_EDGE_CAPTURE_INDEX_OUT_OF_RANGE;
+  }
+
+  int errorCode = edgeCaptures.resize(index + 1);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  if (edgeCaptures[index]) {
+    delete edgeCaptures[index];
+    edgeCaptures.set(index, NULL);
+  }
+
+  ecmcEcEdgeCapture *edgeCapture = NULL;
+
+  try {
+    edgeCapture = new ecmcEcEdgeCapture(asynPort, index, fifoSize);
+  }
+  catch (std::bad_alloc& ex) {
+    LOGERR("%s/%s:%d: ERROR: Mem alloc error (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           ERROR_EC_EDGE_CAPTURE_ALLOC_FAIL);
+    return ERROR_EC_EDGE_CAPTURE_ALLOC_FAIL;
+  }
+
+  errorCode = edgeCapture->getErrorCode();
+
+  if (errorCode) {
+    delete edgeCapture;
+    return errorCode;
+  }
+  edgeCaptures.set(index, edgeCapture);
+  return 0;
+}
+
+/* Find entry of "ec<m>.s<n>.<alias>[.<bit>]" (bit -1 if not in path) */
+static int findEcPathEntry(const char   *ecPath,
+                           ecmcEcEntry **entry,
+                           int          *bitIndex) {
+  int  masterId   = -1;
+  int  slaveIndex = -1;
+  char alias[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+  char path[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  snprintf(path, sizeof(path), "%s", ecPath);
+
+  int errorCode =
+    parseEcPath(path, &masterId, &slaveIndex, alias, bitIndex);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  if (!ec->getInitDone()) return ERROR_MAIN_EC_NOT_INITIALIZED;
+
+  ecmcEcSlave *slave = NULL;
+
+  if (slaveIndex >= 0) {
+    slave = ec->findSlave(slaveIndex);
+  } else {    // simulation slave
+    slave = ec->getSlave(slaveIndex);
+  }
+
+  if (slave == NULL) return ERROR_MAIN_EC_SLAVE_NULL;
+
+  *entry = slave->findEntry(std::string(alias));
+
+  if (*entry == NULL) return ERROR_MAIN_EC_ENTRY_NULL;
+
+  return 0;
+}
+
+int ecAddEdgeCaptureBit(int         index,
+                        int         edges,
+                        const char *ecPath) {
+  LOGINFO4("%s/%s:%d index=%d edges=%d ecPath=%s\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           edges,
+           ecPath);
+  CHECK_EDGE_CAPTURE_RETURN_IF_ERROR(index);
+
+  ecmcEcEntry *entry = NULL;
+  int bitIndex       = -1;
+  int errorCode      = findEcPathEntry(ecPath, &entry, &bitIndex);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  // Bit optional for 1 bit entries
+  if ((bitIndex < 0) && (entry->getBits() == 1)) {
+    bitIndex = 0;
+  }
+
+  return edgeCaptures[index]->addBitChannel(entry, bitIndex, edges);
+}
+
+int ecAddEdgeCaptureTimestamp(int         index,
+                              int         edge,
+                              const char *ecPath) {
+  LOGINFO4("%s/%s:%d index=%d edge=%d ecPath=%s\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           edge,
+           ecPath);
+  CHECK_EDGE_CAPTURE_RETURN_IF_ERROR(index);
+
+  ecmcEcEntry *entry = NULL;
+  int bitIndex       = -1;
+  int errorCode      = findEcPathEntry(ecPath, &entry, &bitIndex);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  if (bitIndex >= 0) {
+    return ERROR_EC_EDGE_CAPTURE_ENTRY_INVALID;
+  }
+
+  return edgeCaptures[index]->addTimestampChannel(entry, edge);
+}
+
+int ecPrintEdgeCapture(int index) {
+  LOGINFO4("%s/%s:%d index=%d\n", __FILE__, __FUNCTION__, __LINE__, index);
+  CHECK_EDGE_CAPTURE_RETURN_IF_ERROR(index);
+
+  edgeCaptures[index]->print();
+  return 0;
+}
+
 int ecPrintAllHardware() {
   LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
   return ec->printAllConfig();
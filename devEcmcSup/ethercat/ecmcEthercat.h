@@ -1133,6 +1133,139 @@ int ecEnablePrintouts(int value);
  */
 int ecSetDelayECOkAtStartup(int milliseconds);
 
+/** \brief Enable distributed clock diagnostics
+ *
+ * Each cycle the reference clock time is compared to the application time\n
+ * of the previous cycle. Published as asyn parameters "ec<master>.dc.*":\n
+ *  refdiff:      Application time - reference clock time [ns].\n
+ *  drift:        Change of refdiff since last cycle [ns].\n
+ *  driftmax:     Max abs drift since last publish [ns].\n
+ *  phase:        Time when the frame passed the reference clock, relative\n
+ *                to the SYNC0 grid (shift 0, rt thread cycle time) [ns].\n
+ *  phaseerr:     Phase - phase setpoint of wakeup control [ns].\n
+ *  phaseerrmax:  Max abs phase error since last publish [ns].\n
+ *  wakeupadjust: Shift of rt thread wakeup [ns].\n
+ *  wakeupctrl:   Wakeup control enabled.\n
+ *  invalidcount: Cycles without valid reference clock time.\n
+ *  phasehist:    Histogram of phase (32 bins over one cycle).\n
+ *  drifthist:    Histogram of abs drift (bin 0 < 64ns, bin n < 64ns*2^n).\n
+ *
+ * \param[in] enable Enable diagnostics.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Enable DC diagnostics.\n
+ *  "Cfg.EcSetDcDiag(1)" //Command string to ecmcCmdParser.c\n
+ */
+int ecSetDcDiag(int enable);
+
+/** \brief Shift rt thread wakeup to keep frames at a fixed phase to SYNC0
+ *
+ * The master follows the reference clock instead of the opposite\n
+ * (ecrt_master_sync_reference_clock() is no longer called). The wakeup of\n
+ * the rt thread is shifted by a PI controller so that the frames pass the\n
+ * reference clock at phaseUs relative to the SYNC0 grid (shift 0). The\n
+ * application time (and the asyn time stamps) is steered to the reference\n
+ * clock by the measured refdiff (max 1us per cycle, one step if more than\n
+ * 1ms off). A slave\n
+ * with SYNC0 shift S needs the frame before S, for instance with 50us\n
+ * margin: phaseUs = S - 50us (modulo cycle time).\n
+ * Enables the DC diagnostics (see ecSetDcDiag()).\n
+ *
+ * \param[in] enable Enable control.\n
+ * \param[in] phaseUs Phase setpoint, 0..cycle time [us].\n
+ * \param[in] kp Proportional gain (>= 0, typically 0.1).\n
+ * \param[in] ki Integral gain (>= 0, typically 0.005).\n
+ * \param[in] maxAdjustUs Max wakeup shift per cycle, max half cycle [us].\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Frames at 800us in the cycle, max 5us shift per cycle.\n
+ *  "Cfg.EcSetDcWakeupCtrl(1,800,0.1,0.005,5)" //Command string to ecmcCmdParser.c\n
+ */
+int ecSetDcWakeupCtrl(int    enable,
+                      double phaseUs,
+                      double kp,
+                      double ki,
+                      double maxAdjustUs);
+
+/** \brief Print distributed clock diagnostics and histograms
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print DC diagnostics.\n
+ *  "Cfg.EcPrintDcDiag()" //Command string to ecmcCmdParser.c\n
+ */
+int ecPrintDcDiag();
+
+/** \brief Create an edge capture object
+ *
+ * Captures timestamped edges of EtherCAT inputs into a ring per channel\n
+ * (oldest events overwritten). Edges are read by plcs (ec_edge_pop()),\n
+ * plugins (readEcmcEdgeEvent()) and asyn parameters\n
+ * "edgecap<index>.ch<channel>.count|edge|time".\n
+ *
+ * \param[in] index Index of edge capture object to create.\n
+ * \param[in] fifoSize Events per channel (rounded up to power of 2).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Create edge capture 0 with 64 events per channel.\n
+ *  "Cfg.EcCreateEdgeCapture(0,64)" //Command string to ecmcCmdParser.c\n
+ */
+int ecCreateEdgeCapture(int index,
+                        int fifoSize);
+
+/** \brief Add a bit channel to an edge capture object
+ *
+ * Edges of one bit of an input entry are timestamped with the application\n
+ * time of the cycle that carried the data (cycle resolution).\n
+ * Channel index in the order added.\n
+ *
+ * \param[in] index Index of edge capture object.\n
+ * \param[in] edges Edges to capture (1=rising, 2=falling, 3=both).\n
+ * \param[in] ecPath EtherCAT path "ec<m>.s<n>.<alias>[.<bit>]" (bit\n
+ *                   optional for 1 bit entries).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Capture both edges of bit 3 of "inputs" of slave 2.\n
+ *  "Cfg.EcAddEdgeCaptureBit(0,3,ec0.s2.inputs.3)" //Command string to ecmcCmdParser.c\n
+ */
+int ecAddEdgeCaptureBit(int         index,
+                        int         edges,
+                        const char *ecPath);
+
+/** \brief Add a timestamp channel to an edge capture object
+ *
+ * Events of a latch/timestamp entry (32 or 64 bit DC time, for instance\n
+ * of EL1252) are detected when the value changes and timestamped with\n
+ * the latched time.\n
+ *
+ * \param[in] index Index of edge capture object.\n
+ * \param[in] edge Edge of the timestamp (1=rising, 2=falling).\n
+ * \param[in] ecPath EtherCAT path "ec<m>.s<n>.<alias>".\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Rising edge timestamps of slave 4.\n
+ *  "Cfg.EcAddEdgeCaptureTimestamp(0,1,ec0.s4.latchPos01)" //Command string to ecmcCmdParser.c\n
+ */
+int ecAddEdgeCaptureTimestamp(int         index,
+                              int         edge,
+                              const char *ecPath);
+
+/** \brief Print edge capture channels and event counts
+ *
+ * \param[in] index Index of edge capture object.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print edge capture 0.\n
+ *  "Cfg.EcPrintEdgeCapture(0)" //Command string to ecmcCmdParser.c\n
+ */
+int ecPrintEdgeCapture(int index);
+
 /** \brief Prints all hardware connected to selected master.\n
  *
  *
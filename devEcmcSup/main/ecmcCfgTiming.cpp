@@ -0,0 +1,121 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcCfgTiming.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+*  Only called from the configuration thread (iocsh, port locked).
+*
+\*************************************************************************/
+
+#include "ecmcCfgTiming.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+struct ecmcCfgTimingStat {
+  int    count;
+  double totalS;
+  double maxS;
+};
+
+typedef std::pair<std::string, ecmcCfgTimingStat> ecmcCfgTimingEntry;
+
+static std::map<std::string, ecmcCfgTimingStat> cmdStats;
+static std::vector<std::pair<std::string, double> > phases;
+static double firstCmdTime = -1;
+static double cmdTotalS    = 0;
+static int    cmdCount     = 0;
+
+static bool cfgTimingCompareTotal(const ecmcCfgTimingEntry& a,
+                                  const ecmcCfgTimingEntry& b) {
+  return a.second.totalS > b.second.totalS;
+}
+
+double cfgTimingNow() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void cfgTimingAddCmd(const char *cmd, double startTime) {
+  if (!cmd) {
+    return;
+  }
+
+  double duration = cfgTimingNow() - startTime;
+
+  if (firstCmdTime < 0) {
+    firstCmdTime = startTime;
+  }
+
+  size_t len = strcspn(cmd, "(=");
+
+  if (len > ECMC_CFG_TIMING_MAX_KEY_CHARS) {
+    len = ECMC_CFG_TIMING_MAX_KEY_CHARS;
+  }
+
+  ecmcCfgTimingStat& stat = cmdStats[std::string(cmd, len)];
+
+  stat.count++;
+  stat.totalS += duration;
+
+  if (duration > stat.maxS) {
+    stat.maxS = duration;
+  }
+
+  cmdTotalS += duration;
+  cmdCount++;
+}
+
+void cfgTimingAddPhase(const char *phase, double startTime) {
+  if (!phase) {
+    return;
+  }
+  phases.push_back(std::make_pair(std::string(phase),
+                                  cfgTimingNow() - startTime));
+}
+
+int printCfgTimingReport() {
+  std::vector<ecmcCfgTimingEntry> sorted(cmdStats.begin(), cmdStats.end());
+
+  std::sort(sorted.begin(), sorted.end(), cfgTimingCompareTotal);
+
+  printf("Configuration timing report:\n");
+  printf("  Phases:\n");
+
+  for (size_t i = 0; i < phases.size(); i++) {
+    printf("    %-40s %10.1f ms\n",
+           phases[i].first.c_str(),
+           phases[i].second * 1e3);
+  }
+
+  printf("  Commands (sorted by total time):\n");
+  printf("    %-40s %8s %12s %10s\n", "command", "count", "total [ms]",
+         "max [ms]");
+
+  for (size_t i = 0; i < sorted.size(); i++) {
+    printf("    %-40s %8d %12.1f %10.2f\n",
+           sorted[i].first.c_str(),
+           sorted[i].second.count,
+           sorted[i].second.totalS * 1e3,
+           sorted[i].second.maxS * 1e3);
+  }
+
+  printf("  Total: %d commands in %.1f ms", cmdCount, cmdTotalS * 1e3);
+
+  if (firstCmdTime >= 0) {
+    printf(", %.2f s since first command", cfgTimingNow() - firstCmdTime);
+  }
+  printf("\n");
+  return 0;
+}
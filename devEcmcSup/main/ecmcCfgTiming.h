@@ -0,0 +1,67 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcCfgTiming.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+/**
+\file
+    @brief Timing of the configuration phase (ioc startup)
+*/
+
+#ifndef ECMC_CFG_TIMING_H_
+#define ECMC_CFG_TIMING_H_
+
+#define ECMC_CFG_TIMING_MAX_KEY_CHARS 64
+
+# ifdef __cplusplus
+extern "C" {
+# endif  // ifdef __cplusplus
+
+/** \brief Monotonic time [s] (start time for the functions below).\n
+ */
+double cfgTimingNow();
+
+/** \brief Add execution time of a configuration command.\n
+ *
+ * Commands are grouped by name (command string up to the first "(" or
+ * "=").\n
+ *
+ * \param[in] cmd Command string.\n
+ * \param[in] startTime Start time from cfgTimingNow().\n
+ */
+void   cfgTimingAddCmd(const char *cmd,
+                       double      startTime);
+
+/** \brief Add execution time of a startup phase (like master activation or
+ *  ioc init).\n
+ *
+ * \param[in] phase Phase name.\n
+ * \param[in] startTime Start time from cfgTimingNow().\n
+ */
+void   cfgTimingAddPhase(const char *phase,
+                         double      startTime);
+
+/** \brief Print configuration timing report.\n
+ *
+ * Lists the startup phases and the configuration commands sorted by
+ * total execution time (count, total and max time per command).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print report.\n
+ *  "Cfg.PrintCfgTimingReport()" //Command string to ecmcCmdParser.c\n
+ */
+int    printCfgTimingReport();
+
+# ifdef __cplusplus
+}
+# endif  // ifdef __cplusplus
+
+#endif  /* ECMC_CFG_TIMING_H_ */
@@ -30,8 +30,9 @@
 #define MCU_MIN_PERIOD_NS (MCU_NSEC_PER_SEC / MCU_MAX_FREQUENCY)
 #define MCU_MAX_PERIOD_NS (MCU_NSEC_PER_SEC / MCU_MIN_FREQUENCY)
 
-#define ECMC_MAX_AXES 128
-#define ECMC_MAX_PLCS 16
+// Default registry sizes (registries grow during configuration, see ecmcRegistry.h)
+#define ECMC_DEFAULT_AXES 128
+#define ECMC_DEFAULT_PLCS 16
 
 #define ECMC_ASYN_DEFAULT_LIST 0
 #define ECMC_ASYN_DEFAULT_ADDR 0
@@ -59,7 +60,6 @@
 #define AX_MAX_DIAG_STRING_CHAR_LENGTH 1024
 
 // Transforms
-#define MAX_TRANSFORM_INPUTS ECMC_MAX_AXES *2
 #define TRANSFORM_EXPR_LINE_END_CHAR '|'
 
 // EtherCAT
@@ -108,6 +108,7 @@
 #define ECMC_ENCODER_ENTRY_INDEX_READY 9
 #define ECMC_ENCODER_ENTRY_INDEX_TRIGG_HOME 10
 #define ECMC_ENCODER_ENTRY_INDEX_STAT_HOME 11
+#define ECMC_ENCODER_ENTRY_INDEX_TIMESTAMP 12
 
 // Encoders
 #define ECMC_MAX_ENCODERS 8
@@ -122,17 +123,23 @@
 // Data recording
 #define ECMC_MAX_DATA_RECORDERS_OBJECTS 10
 #define ECMC_MAX_EVENT_OBJECTS 10
-#define ECMC_MAX_DATA_STORAGE_OBJECTS 32
+#define ECMC_DEFAULT_DATA_STORAGE_OBJECTS 32
 #define ECMC_DEFAULT_DATA_STORAGE_SIZE 1000
 #define ECMC_MAX_EVENT_CONSUMERS 10
 #define ECMC_MAX_COMMANDS_LISTS 10
 #define ECMC_MAX_COMMANDS_IN_COMMANDS_LISTS 100
 
 // Plugins
-#define ECMC_MAX_PLUGINS 16
+#define ECMC_DEFAULT_PLUGINS 16
 
 // Lookup tables
-#define ECMC_MAX_LUTS 16
+#define ECMC_DEFAULT_LUTS 16
+
+// Captures (triggered recording of data items)
+#define ECMC_DEFAULT_CAPTURES 8
+
+// Edge captures (timestamped edges of EtherCAT inputs)
+#define ECMC_DEFAULT_EDGE_CAPTURES 8
 
 // master slave state machines
 #define ECMC_MAX_MST_SLVS_SMS 16
@@ -248,6 +255,7 @@
 // Asyn params for encoder
 #define ECMC_ASYN_ENC_ACT_POS_NAME "actpos"
 #define ECMC_ASYN_ENC_ACT_VEL_NAME "actvel"
+#define ECMC_ASYN_ENC_ACT_ACC_NAME "actacc"
 #define ECMC_ASYN_ENC_ERR_ID_NAME "enc.errid"
 
 // Asyn params for controller
@@ -400,7 +408,10 @@ enum axisSubObjectType {
 };
 
 
-#define AXIS_PLC_ID_TO_PLC_ID(axisId) (axisId) + ECMC_MAX_PLCS
+/* Normal PLCs are indexed 0..maxPlcCount-1, axis PLCs are indexed above.
+   maxPlcCount is defined in ecmcGlobals.h and fixed when the first PLC is created */
+extern int maxPlcCount;
+#define AXIS_PLC_ID_TO_PLC_ID(axisId) ((axisId) + maxPlcCount)
 
 #define ECMC_MAIN_STR "main"
 #define ECMC_THREAD_STR "thread"
@@ -478,6 +489,7 @@ enum axisSubObjectType {
 #define ECMC_ENC_READY_STR "ready"
 #define ECMC_ENC_TRIGG_HOME_STR "homing_trigg"
 #define ECMC_ENC_STAT_HOME_STR "homing_stat"
+#define ECMC_ENC_TIMESTAMP_STR "timestamp"
 
 #define ECMC_MON_STR "mon"
 #define ECMC_MON_LOWLIM_STR "lowlim"
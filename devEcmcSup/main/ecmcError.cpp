@@ -813,6 +813,21 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
 
     break;
 
+  case 0x1441D:
+    return "ERROR_ENC_TIMESTAMP_BITS_INVALID";
+
+    break;
+
+  case 0x14430:
+    return "ERROR_VEL_EST_TYPE_INVALID";
+
+    break;
+
+  case 0x14431:
+    return "ERROR_VEL_EST_TIME_CONST_INVALID";
+
+    break;
+
   case 0x14C00:  // MONITOR
     return "ERROR_MON_ASSIGN_ENTRY_FAILED";
 
@@ -1287,6 +1302,16 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
 
     break;
 
+  case 0x14510:
+    return "ERROR_PID_BATCH_FULL";
+
+    break;
+
+  case 0x14511:
+    return "ERROR_PID_BATCH_ALLOC_FAIL";
+
+    break;
+
   case 0x15000:    // CONTROLLER
     return "ERROR_CNTRL_INVALID_SAMPLE_TIME";
 
@@ -1306,6 +1331,111 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
     return "ERROR_AXISGRP_NAME_ALREADY_EXISTS";
   
     break;
+
+  case 0x16100:
+    return "ERROR_GRP_TRANSFORM_TYPE_INVALID";
+
+    break;
+
+  case 0x16101:
+    return "ERROR_GRP_TRANSFORM_DOF_MISMATCH";
+
+    break;
+
+  case 0x16102:
+    return "ERROR_GRP_TRANSFORM_PARAM_INDEX_OUT_OF_RANGE";
+
+    break;
+
+  case 0x16103:
+    return "ERROR_GRP_TRANSFORM_PARAMS_MISSING";
+
+    break;
+
+  case 0x16104:
+    return "ERROR_GRP_TRANSFORM_SINGULAR";
+
+    break;
+
+  case 0x16105:
+    return "ERROR_GRP_TRANSFORM_ASYN_PARAM_FAIL";
+
+    break;
+
+  case 0x16106:
+    return "ERROR_GRP_TRANSFORM_ALREADY_CREATED";
+
+    break;
+
+  case 0x16107:
+    return "ERROR_GRP_TRANSFORM_NULL";
+
+    break;
+
+  case 0x16108:
+    return "ERROR_GRP_TRANSFORM_SOLVER_INVALID";
+
+    break;
+
+  case 0x16200:
+    return "ERROR_AXIS_GEAR_NULL";
+
+    break;
+
+  case 0x16201:
+    return "ERROR_AXIS_GEAR_MASTER_INVALID";
+
+    break;
+
+  case 0x16202:
+    return "ERROR_AXIS_GEAR_LUT_INVALID";
+
+    break;
+
+  case 0x16203:
+    return "ERROR_AXIS_GEAR_SOURCE_NOT_EXTERNAL";
+
+    break;
+
+  case 0x16204:
+    return "ERROR_AXIS_GEAR_ASYN_PARAM_FAIL";
+
+    break;
+
+  case 0x16205:
+    return "ERROR_AXIS_GEAR_MASTER_SOURCE_INVALID";
+
+    break;
+
+  case 0x16206:
+    return "ERROR_AXIS_GEAR_VALUE_OUT_OF_RANGE";
+
+    break;
+
+  case 0x16300:
+    return "ERROR_AXIS_GROUP_CMD_AXIS_NULL";
+
+    break;
+
+  case 0x16301:
+    return "ERROR_AXIS_GROUP_CMD_TYPE_INVALID";
+
+    break;
+
+  case 0x16302:
+    return "ERROR_AXIS_GROUP_CMD_COUNT_MISMATCH";
+
+    break;
+
+  case 0x16303:
+    return "ERROR_AXIS_GROUP_CMD_COM_BLOCKED";
+
+    break;
+
+  case 0x16304:
+    return "ERROR_AXIS_GROUP_CMD_REJECTED";
+
+    break;
   
   case 0x17000:
     return "ERROR_MST_SLV_SM_GRP_NULL";
@@ -1322,6 +1452,21 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
 
     break;
 
+  case 0x18000:
+    return "ERROR_AXIS_FR_ALLOC_FAIL";
+
+    break;
+
+  case 0x18001:
+    return "ERROR_AXIS_FR_INVALID_SIZE";
+
+    break;
+
+  case 0x18002:
+    return "ERROR_AXIS_FR_ASYN_PARAM_FAIL";
+
+    break;
+
   case 0x30000:    // TRANSFORM
     return "ERROR_TRANSFORM_EXPR_NOT_COMPILED";
 
@@ -1902,6 +2047,66 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
 
     break;
 
+  case 0x26029:
+    return "ERROR_EC_DC_DIAG_ASYN_PARAM_FAIL";
+
+    break;
+
+  case 0x2602A:
+    return "ERROR_EC_DC_WAKEUP_CTRL_INVALID";
+
+    break;
+
+  case 0x26030:
+    return "ERROR_EC_EDGE_CAPTURE_ALLOC_FAIL";
+
+    break;
+
+  case 0x26031:
+    return "ERROR_EC_EDGE_CAPTURE_INVALID_CFG";
+
+    break;
+
+  case 0x26032:
+    return "ERROR_EC_EDGE_CAPTURE_ENTRY_INVALID";
+
+    break;
+
+  case 0x26033:
+    return "ERROR_EC_EDGE_CAPTURE_BIT_OUT_OF_RANGE";
+
+    break;
+
+  case 0x26034:
+    return "ERROR_EC_EDGE_CAPTURE_CHANNEL_COUNT_OUT_OF_RANGE";
+
+    break;
+
+  case 0x26035:
+    return "ERROR_EC_EDGE_CAPTURE_CHANNEL_OUT_OF_RANGE";
+
+    break;
+
+  case 0x26036:
+    return "ERROR_EC_EDGE_CAPTURE_ASYN_PARAM_FAIL";
+
+    break;
+
+  case 0x26037:
+    return "ERROR_EC_EDGE_CAPTURE_NULL";
+
+    break;
+
+  case 0x26038:
+    return "ERROR_EC_EDGE_CAPTURE_INDEX_OUT_OF_RANGE";
+
+    break;
+
+  case 0x26039:
+    return "ERROR_EC_EDGE_CAPTURE_CHANNEL_EXISTS";
+
+    break;
+
   case 0x20000:
     return "ERROR_MAIN_DEMO_EC_ACITVATE_FAILED";
 
@@ -2398,6 +2603,46 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
 
     break;
 
+  case 0x20064:
+    return "ERROR_MAIN_REGISTRY_FROZEN";
+
+    break;
+
+  case 0x20065:
+    return "ERROR_MAIN_REGISTRY_SIZE_OUT_OF_RANGE";
+
+    break;
+
+  case 0x20066:
+    return "ERROR_MAIN_PLC_COUNT_LOCKED";
+
+    break;
+
+  case 0x20067:
+    return "ERROR_MAIN_THREAD_INVALID_CPU_LIST";
+
+    break;
+
+  case 0x20068:
+    return "ERROR_MAIN_THREAD_INVALID_SCHED_POLICY";
+
+    break;
+
+  case 0x20069:
+    return "ERROR_MAIN_THREAD_INVALID_PRIORITY";
+
+    break;
+
+  case 0x2006A:
+    return "ERROR_MAIN_THREAD_INVALID_RUNTIME";
+
+    break;
+
+  case 0x2006B:
+    return "ERROR_MAIN_THREAD_ATTR_APPLY_FAIL";
+
+    break;
+
   case 0x20100:   // Data Recorder
     return "ERROR_DATA_RECORDER_BUFFER_NULL";
 
@@ -2458,6 +2703,86 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
 
     break;
 
+  case 0x20210:
+    return "ERROR_DATA_STORAGE_STREAM_FILE_OPEN_FAIL";
+
+    break;
+
+  case 0x20211:
+    return "ERROR_DATA_STORAGE_STREAM_ALLOC_FAIL";
+
+    break;
+
+  case 0x20212:
+    return "ERROR_DATA_STORAGE_STREAM_THREAD_FAIL";
+
+    break;
+
+  case 0x20213:
+    return "ERROR_DATA_STORAGE_STREAM_INVALID_CFG";
+
+    break;
+
+  case 0x20214:
+    return "ERROR_DATA_STORAGE_STREAM_NULL";
+
+    break;
+
+  case 0x20215:
+    return "ERROR_DATA_STORAGE_STREAM_FILE_WRITE_FAIL";
+
+    break;
+
+  case 0x20220:
+    return "ERROR_CAPTURE_ALLOC_FAIL";
+
+    break;
+
+  case 0x20221:
+    return "ERROR_CAPTURE_INVALID_CFG";
+
+    break;
+
+  case 0x20222:
+    return "ERROR_CAPTURE_CHANNEL_NOT_FOUND";
+
+    break;
+
+  case 0x20223:
+    return "ERROR_CAPTURE_CHANNEL_TYPE_INVALID";
+
+    break;
+
+  case 0x20224:
+    return "ERROR_CAPTURE_CHANNEL_COUNT_OUT_OF_RANGE";
+
+    break;
+
+  case 0x20225:
+    return "ERROR_CAPTURE_ASYN_PARAM_FAIL";
+
+    break;
+
+  case 0x20226:
+    return "ERROR_CAPTURE_THREAD_FAIL";
+
+    break;
+
+  case 0x20227:
+    return "ERROR_CAPTURE_NULL";
+
+    break;
+
+  case 0x20228:
+    return "ERROR_CAPTURE_INDEX_OUT_OF_RANGE";
+
+    break;
+
+  case 0x20229:
+    return "ERROR_CAPTURE_TRIGGER_INVALID";
+
+    break;
+
   case 0x20300:   // Event
     return "ERROR_EVENT_DATA_ECENTRY_NULL";
 
@@ -2623,6 +2948,46 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
 
     break;
 
+  case 0x20511:
+    return "ERROR_PLC_PROFILER_ASYN_PARAM_FAIL";
+
+    break;
+
+  case 0x20512:
+    return "ERROR_PLC_PROFILER_BUDGET_INVALID";
+
+    break;
+
+  case 0x20513:
+    return "ERROR_PLC_PROFILER_DEMOTION_INVALID";
+
+    break;
+
+  case 0x20514:
+    return "ERROR_PLC_NATIVE_TRANSLATE_FAIL";
+
+    break;
+
+  case 0x20515:
+    return "ERROR_PLC_NATIVE_COMPILE_FAIL";
+
+    break;
+
+  case 0x20516:
+    return "ERROR_PLC_NATIVE_LOAD_FAIL";
+
+    break;
+
+  case 0x20517:
+    return "ERROR_PLC_NATIVE_MODE_INVALID";
+
+    break;
+
+  case 0x20518:
+    return "ERROR_PLC_NATIVE_VERIFY_FUNCS";
+
+    break;
+
   case 0x20600:   // ecmcPLCDataIF
     return "ERROR_PLC_AXIS_DATA_TYPE_ERROR";
 
@@ -2743,6 +3108,26 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
 
     break;
 
+  case 0x2070C:
+    return "ERROR_PLCS_ONLINE_CHANGE_BUSY";
+
+    break;
+
+  case 0x2070D:
+    return "ERROR_PLCS_ONLINE_CHANGE_AXIS_PLC";
+
+    break;
+
+  case 0x2070E:
+    return "ERROR_PLCS_ONLINE_CHANGE_TIMEOUT";
+
+    break;
+
+  case 0x2070F:
+    return "ERROR_PLCS_ONLINE_CHANGE_THREAD_FAIL";
+
+    break;
+
   case 0x20800:
     return "ERROR_PLC_EC_LIB_BITS_OUT_OF_RANGE";
 
@@ -2850,6 +3235,61 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
 
     break;
 
+  case 0x22000A:
+    return "ERROR_ASYN_ARRAY_BUFFER_NOT_ARRAY";
+
+    break;
+
+  case 0x22000B:
+    return "ERROR_ASYN_ARRAY_BUFFER_ALLOC_FAIL";
+
+    break;
+
+  case 0x22000C:
+    return "ERROR_ASYN_ARRAY_BUFFER_LIST_FULL";
+
+    break;
+
+  case 0x22000D:
+    return "ERROR_ASYN_ARRAY_BUFFER_PARAM_NOT_FOUND";
+
+    break;
+
+  case 0x22000E:
+    return "ERROR_ASYN_DEFER_QUEUE_FULL";
+
+    break;
+
+  case 0x22000F:
+    return "ERROR_ASYN_DEFER_THREAD_FAIL";
+
+    break;
+
+  case 0x221000:
+    return "ERROR_CMD_MAILBOX_FULL";
+
+    break;
+
+  case 0x221001:
+    return "ERROR_CMD_MAILBOX_PAYLOAD_TO_LARGE";
+
+    break;
+
+  case 0x221002:
+    return "ERROR_CMD_MAILBOX_INVALID_SIZE";
+
+    break;
+
+  case 0x221003:
+    return "ERROR_CMD_MAILBOX_INVALID_BUDGET";
+
+    break;
+
+  case 0x221004:
+    return "ERROR_CMD_MAILBOX_CALL_TIMEOUT";
+
+    break;
+
   case 0x230000:
     return "ERROR_AXIS_FILTER_ALLOC_FAIL";
 
@@ -2895,6 +3335,21 @@ const char * ecmcError::convertErrorIdToString(int errorId) {
 
     break;
 
+  case 0x231100:
+    return "ERROR_PLUGIN_CLIENT_ARG_NULL";
+
+    break;
+
+  case 0x231101:
+    return "ERROR_PLUGIN_CLIENT_DATA_ITEM_NOT_FOUND";
+
+    break;
+
+  case 0x231102:
+    return "ERROR_PLUGIN_CLIENT_ASYN_PORT_NULL";
+
+    break;
+
   // lookupTable
   case 0x241000:
     return "ERROR_LOOKUP_TABLE_ERROR";
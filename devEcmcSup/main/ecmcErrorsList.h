@@ -99,6 +99,7 @@
 #define ERROR_ENC_LOOKUP_TABLE_LOAD_ERROR 0x1441A
 #define ERROR_ENC_LOOKUP_TABLE_NOT_LOADED 0x1441B
 #define ERROR_ENC_LOOKUP_TABLE_NOT_VALID 0x1441C
+#define ERROR_ENC_TIMESTAMP_BITS_INVALID 0x1441D
 
 #define WARNING_ENC_NOT_READY 0x114417
 
@@ -361,6 +362,14 @@
 #define ERROR_MST_SLV_SM_INDEX_OUT_OF_RANGE 0x20061
 #define ERROR_MAIN_RT_MEMORY_ALLOC_FAILED 0x20062
 #define ERROR_MAIN_PARSER_CMD_BLOCKED_IN_RUNTIME 0x20063
+#define ERROR_MAIN_REGISTRY_FROZEN 0x20064
+#define ERROR_MAIN_REGISTRY_SIZE_OUT_OF_RANGE 0x20065
+#define ERROR_MAIN_PLC_COUNT_LOCKED 0x20066
+#define ERROR_MAIN_THREAD_INVALID_CPU_LIST 0x20067
+#define ERROR_MAIN_THREAD_INVALID_SCHED_POLICY 0x20068
+#define ERROR_MAIN_THREAD_INVALID_PRIORITY 0x20069
+#define ERROR_MAIN_THREAD_INVALID_RUNTIME 0x2006A
+#define ERROR_MAIN_THREAD_ATTR_APPLY_FAIL 0x2006B
 
 // Other errors moved heer since used in many objects
 #define ERROR_EC_MAIN_ENTRY_NULL 0x26006
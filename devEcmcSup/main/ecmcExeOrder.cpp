@@ -0,0 +1,306 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcExeOrder.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+*  Only called from the configuration thread (iocsh, port locked). The rt
+*  thread reads the order once at start (registries are frozen).
+*
+\*************************************************************************/
+
+#include "ecmcExeOrder.h"
+#include "ecmcExeOrderSort.h"
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "ecmcOctetIF.h"        // Log Macros
+#include "ecmcGlobalsExtern.h"
+#include "ecmcAxisGroupTransform.h"
+#include "ecmcAxisGear.h"
+
+static std::vector<ecmcExeNode> exeNodes;
+static std::vector<int>         exeBatchCollect;
+static std::vector<std::string> exeCycles;
+
+static std::string exeNodeName(const ecmcExeNode& node) {
+  char buffer[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  switch (node.type) {
+  case ECMC_EXE_NODE_AXIS_PLC:
+    snprintf(buffer, sizeof(buffer), ECMC_AX_STR "%d.plc", node.index);
+    break;
+
+  case ECMC_EXE_NODE_AXIS:
+    snprintf(buffer, sizeof(buffer), ECMC_AX_STR "%d", node.index);
+    break;
+
+  case ECMC_EXE_NODE_MST_SLV_SM:
+    snprintf(buffer,
+             sizeof(buffer),
+             "mst_slv_sm%d (%s)",
+             node.index,
+             masterSlaveSMs[node.index] ?
+             masterSlaveSMs[node.index]->getName() : "");
+    break;
+
+  case ECMC_EXE_NODE_GRP_TRANSFORM_FWD:
+    snprintf(buffer,
+             sizeof(buffer),
+             ECMC_GRP_STR "%d." ECMC_GRP_TRANSFORM_STR ".fwd",
+             node.index);
+    break;
+
+  case ECMC_EXE_NODE_GRP_TRANSFORM_INV:
+    snprintf(buffer,
+             sizeof(buffer),
+             ECMC_GRP_STR "%d." ECMC_GRP_TRANSFORM_STR ".inv",
+             node.index);
+    break;
+
+  case ECMC_EXE_NODE_AXIS_GEAR:
+    snprintf(buffer,
+             sizeof(buffer),
+             ECMC_AX_STR "%d." ECMC_AXIS_GEAR_STR,
+             node.index);
+    break;
+
+  default:
+    buffer[0] = '\0';
+    break;
+  }
+  return buffer;
+}
+
+static void addEdge(std::vector<std::vector<int> > *producers,
+                    int                             producer,
+                    int                             consumer) {
+  if ((producer < 0) || (consumer < 0) || (producer == consumer)) {
+    return;
+  }
+
+  std::vector<int>& prod = (*producers)[consumer];
+
+  if (std::find(prod.begin(), prod.end(), producer) == prod.end()) {
+    prod.push_back(producer);
+  }
+}
+
+int exeOrderBuild() {
+  LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
+
+  // Nodes in default order (axis plc, axis, gears of the axis (master),
+  // .. then state machines, then transforms)
+  std::vector<ecmcExeNode> nodes;
+  std::vector<int> axisNode(axes.size(), -1);
+  std::vector<int> plcNode(axes.size(), -1);
+  std::vector<std::vector<int> > plcAccess(axes.size());
+  std::vector<int> gearNode(axes.size(), -1);  // Index by slave axis
+
+  for (int i = 0; i < axes.size(); i++) {
+    if (axes[i] == NULL) {
+      continue;
+    }
+
+    if (plcs &&
+        (plcs->getAxisAccess(AXIS_PLC_ID_TO_PLC_ID(i), &plcAccess[i]) == 0)) {
+      plcNode[i] = (int)nodes.size();
+      nodes.push_back({ ECMC_EXE_NODE_AXIS_PLC, i });
+    }
+    axisNode[i] = (int)nodes.size();
+    nodes.push_back({ ECMC_EXE_NODE_AXIS, i });
+
+    // Gears right after master axis
+    for (int s = 0; s < axes.size(); s++) {
+      if (axes[s] && axes[s]->getGear() &&
+          (axes[s]->getGear()->getMaster() == axes[i])) {
+        gearNode[s] = (int)nodes.size();
+        nodes.push_back({ ECMC_EXE_NODE_AXIS_GEAR, s });
+      }
+    }
+  }
+
+  std::vector<int> smNode(ECMC_MAX_MST_SLVS_SMS, -1);
+
+  for (int i = 0; i < ECMC_MAX_MST_SLVS_SMS; i++) {
+    if (masterSlaveSMs[i] != NULL) {
+      smNode[i] = (int)nodes.size();
+      nodes.push_back({ ECMC_EXE_NODE_MST_SLV_SM, i });
+    }
+  }
+
+  std::vector<int> fwdNode(axisGroups.size(), -1);
+  std::vector<int> invNode(axisGroups.size(), -1);
+
+  for (int g = 0; g < axisGroups.size(); g++) {
+    if ((axisGroups[g] != NULL) && axisGroups[g]->getTransform()) {
+      fwdNode[g] = (int)nodes.size();
+      nodes.push_back({ ECMC_EXE_NODE_GRP_TRANSFORM_FWD, g });
+      invNode[g] = (int)nodes.size();
+      nodes.push_back({ ECMC_EXE_NODE_GRP_TRANSFORM_INV, g });
+    }
+  }
+
+  // Edges (producers of each node)
+  std::vector<std::vector<int> > producers(nodes.size());
+
+  for (int n = 0; n < axes.size(); n++) {
+    if (plcNode[n] < 0) {
+      continue;
+    }
+    addEdge(&producers, plcNode[n], axisNode[n]);
+
+    for (int m = 0; m < (int)plcAccess[n].size(); m++) {
+      if (plcAccess[n][m] & ECMC_PLC_AXIS_ACCESS_WRITE) {
+        addEdge(&producers, plcNode[n], axisNode[m]);
+      } else if ((plcAccess[n][m] & ECMC_PLC_AXIS_ACCESS_READ) && (m != n)) {
+        addEdge(&producers, axisNode[m], plcNode[n]);
+      }
+    }
+  }
+
+  for (int j = 0; j < ECMC_MAX_MST_SLVS_SMS; j++) {
+    if (smNode[j] < 0) {
+      continue;
+    }
+    ecmcAxisGroup *masterGrp = masterSlaveSMs[j]->getMasterGrp();
+    ecmcAxisGroup *slaveGrp  = masterSlaveSMs[j]->getSlaveGrp();
+
+    for (int a = 0; a < axes.size(); a++) {
+      if (axisNode[a] < 0) {
+        continue;
+      }
+      bool inMasterGrp = masterGrp && masterGrp->inGroup(a);
+      bool inSlaveGrp  = slaveGrp && slaveGrp->inGroup(a);
+
+      if (inMasterGrp && !inSlaveGrp) {
+        addEdge(&producers, axisNode[a], smNode[j]);
+      } else if (inSlaveGrp && !inMasterGrp) {
+        addEdge(&producers, smNode[j], axisNode[a]);
+      }
+    }
+  }
+
+  for (int g = 0; g < axisGroups.size(); g++) {
+    if (fwdNode[g] < 0) {
+      continue;
+    }
+    ecmcAxisGroup *virtGrp = axisGroups[g]->getTransform()->getVirtGrp();
+    ecmcAxisGroup *realGrp = axisGroups[g]->getTransform()->getRealGrp();
+
+    for (size_t k = 0; k < virtGrp->size(); k++) {
+      int a = virtGrp->getAxis(k)->getAxisID();
+      addEdge(&producers, fwdNode[g], axisNode[a]);
+      addEdge(&producers, axisNode[a], invNode[g]);
+    }
+
+    for (size_t k = 0; k < realGrp->size(); k++) {
+      int a = realGrp->getAxis(k)->getAxisID();
+      addEdge(&producers, invNode[g], axisNode[a]);
+    }
+  }
+
+  for (int s = 0; s < axes.size(); s++) {
+    if (gearNode[s] < 0) {
+      continue;
+    }
+    int m = axes[s]->getGear()->getMaster()->getAxisID();
+    addEdge(&producers, axisNode[m], gearNode[s]);
+    addEdge(&producers, gearNode[s], axisNode[s]);
+  }
+
+  // Stable topological sort, cycles broken at the first node left
+  std::vector<int> order;
+  std::vector<int> breaks;
+  std::vector<bool> done(nodes.size(), false);
+
+  exeOrderSort(producers, &order, &breaks);
+  exeNodes.clear();
+  exeCycles.clear();
+
+  // Axes are completed when the controller batch is collected (batch mode)
+  std::vector<bool> batched(nodes.size(), false);
+  std::vector<bool> collect;
+
+  for (size_t n = 0; n < nodes.size(); n++) {
+    batched[n] = nodes[n].type == ECMC_EXE_NODE_AXIS;
+  }
+  exeOrderBatchCollect(producers, order, batched, &collect);
+  exeBatchCollect.assign(collect.begin(), collect.end());
+
+  for (size_t k = 0; k < order.size(); k++) {
+    int next = order[k];
+
+    if (std::find(breaks.begin(), breaks.end(), next) != breaks.end()) {
+      std::string cycle = exeNodeName(nodes[next]) +
+                          " executes before producer(s):";
+
+      for (size_t p = 0; p < producers[next].size(); p++) {
+        if (!done[producers[next][p]]) {
+          cycle += " " + exeNodeName(nodes[producers[next][p]]);
+        }
+      }
+      exeCycles.push_back(cycle);
+      LOGERR("%s/%s:%d: WARNING: Data flow cycle, %s.\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             cycle.c_str());
+    }
+    done[next] = true;
+    exeNodes.push_back(nodes[next]);
+  }
+
+  for (size_t i = 0; i < exeNodes.size(); i++) {
+    LOGINFO4("%s/%s:%d: Execution order %zu: %s\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             i,
+             exeNodeName(exeNodes[i]).c_str());
+  }
+
+  return 0;
+}
+
+int exeOrderGetCount() {
+  return (int)exeNodes.size();
+}
+
+const ecmcExeNode* exeOrderGetNodes() {
+  return exeNodes.data();
+}
+
+const int* exeOrderGetBatchCollect() {
+  return exeBatchCollect.data();
+}
+
+int printExeOrder() {
+  printf(
+    "Execution order (axis plcs, axes, gears, master slave state machines and transforms):\n");
+
+  if (exeNodes.empty()) {
+    printf("  Not built (built when entering runtime)\n");
+    return 0;
+  }
+
+  for (size_t i = 0; i < exeNodes.size(); i++) {
+    printf("  %3zu: %s%s\n",
+           i,
+           exeNodeName(exeNodes[i]).c_str(),
+           cntrlBatchMode && exeBatchCollect[i] ?
+           " (controller batch collected before)" : "");
+  }
+
+  printf("  Cycles: %zu\n", exeCycles.size());
+
+  for (size_t i = 0; i < exeCycles.size(); i++) {
+    printf("    %s\n", exeCycles[i].c_str());
+  }
+  return 0;
+}
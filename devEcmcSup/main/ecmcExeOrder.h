@@ -0,0 +1,90 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcExeOrder.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+/**
+\file
+    @brief Execution order of axes, axis plcs, master slave state
+    machines, axis group transforms and gears (data flow graph)
+*/
+
+#ifndef ECMC_EXE_ORDER_H_
+#define ECMC_EXE_ORDER_H_
+
+typedef enum {
+  ECMC_EXE_NODE_AXIS_PLC   = 0,
+  ECMC_EXE_NODE_AXIS       = 1,
+  ECMC_EXE_NODE_MST_SLV_SM = 2,
+  ECMC_EXE_NODE_GRP_TRANSFORM_FWD = 3,
+  ECMC_EXE_NODE_GRP_TRANSFORM_INV = 4,
+  ECMC_EXE_NODE_AXIS_GEAR         = 5,
+} ecmcExeNodeType;
+
+typedef struct {
+  ecmcExeNodeType type;
+  int             index;  // Axis (slave for gear), state machine or group
+} ecmcExeNode;
+
+# ifdef __cplusplus
+extern "C" {
+# endif  // ifdef __cplusplus
+
+/** \brief Build the execution order (called in validateConfig()).\n
+ *
+ * Nodes are the axis plcs, the axes, the master slave state machines and
+ * the forward/inverse axis group transforms and the gears.
+ * Edges (producer before consumer):\n
+ *  - axis plc n before axis n.\n
+ *  - plc writing ax<m>.* before axis m.\n
+ *  - axis m before plc only reading ax<m>.* (not for the own axis).\n
+ *  - master axes before state machine before slave axes.\n
+ *  - forward transform before virtual axes before inverse transform
+ *    before real axes (forward uses real actual positions of last
+ *    cycle).\n
+ *  - master axis before gear before slave axis.\n
+ * The nodes are sorted topologically. Nodes without dependencies keep the
+ * default order (axis index). A cycle is reported and broken at the node
+ * first in default order (executed before some of its producers, like
+ * before).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ */
+int                exeOrderBuild();
+
+/** \brief Number of nodes in execution order.\n
+ */
+int                exeOrderGetCount();
+
+/** \brief Nodes in execution order (exeOrderGetCount() nodes).\n
+ */
+const ecmcExeNode* exeOrderGetNodes();
+
+/** \brief Collect the controller batch before the node (batch mode).\n
+ *
+ * Set for the first node consuming an axis executed since the last
+ * collect (see exeOrderBatchCollect()). exeOrderGetCount() entries.\n
+ */
+const int*         exeOrderGetBatchCollect();
+
+/** \brief Print execution order and cycles.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print execution order.\n
+ *  "Cfg.PrintExeOrder()" //Command string to ecmcCmdParser.c\n
+ */
+int                printExeOrder();
+
+# ifdef __cplusplus
+}
+# endif  // ifdef __cplusplus
+
+#endif  /* ECMC_EXE_ORDER_H_ */
@@ -0,0 +1,91 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcExeOrderSort.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcExeOrderSort.h"
+#include <stddef.h>
+
+void exeOrderSort(const std::vector<std::vector<int> >& producers,
+                  std::vector<int>                     *order,
+                  std::vector<int>                     *breaks) {
+  size_t count = producers.size();
+  std::vector<bool> done(count, false);
+
+  order->clear();
+  breaks->clear();
+
+  for (size_t k = 0; k < count; k++) {
+    int next  = -1;
+    int first = -1;
+
+    for (size_t i = 0; i < count && next < 0; i++) {
+      if (done[i]) {
+        continue;
+      }
+
+      if (first < 0) {
+        first = (int)i;
+      }
+      bool ready = true;
+
+      for (size_t p = 0; p < producers[i].size(); p++) {
+        if (!done[producers[i][p]]) {
+          ready = false;
+          break;
+        }
+      }
+
+      if (ready) {
+        next = (int)i;
+      }
+    }
+
+    if (next < 0) {
+      next = first;
+      breaks->push_back(next);
+    }
+    done[next] = true;
+    order->push_back(next);
+  }
+}
+
+void exeOrderBatchCollect(const std::vector<std::vector<int> >& producers,
+                          const std::vector<int>&                order,
+                          const std::vector<bool>&               batched,
+                          std::vector<bool>                     *collect) {
+  std::vector<bool> pending(producers.size(), false);
+  std::vector<int>  pendingNodes;
+
+  collect->assign(order.size(), false);
+
+  for (size_t k = 0; k < order.size(); k++) {
+    int node = order[k];
+
+    for (size_t p = 0; p < producers[node].size(); p++) {
+      if (pending[producers[node][p]]) {
+        (*collect)[k] = true;
+        break;
+      }
+    }
+
+    if ((*collect)[k]) {
+      for (size_t i = 0; i < pendingNodes.size(); i++) {
+        pending[pendingNodes[i]] = false;
+      }
+      pendingNodes.clear();
+    }
+
+    if (batched[node]) {
+      pending[node] = true;
+      pendingNodes.push_back(node);
+    }
+  }
+}
@@ -0,0 +1,56 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcExeOrderSort.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+/**
+\file
+    @brief Stable topological sort of the execution order graph (no
+    dependencies to the ecmc objects, see ecmcExeOrder.h)
+*/
+
+#ifndef ECMC_EXE_ORDER_SORT_H_
+#define ECMC_EXE_ORDER_SORT_H_
+
+#include <vector>
+
+/** \brief Sort nodes 0..n-1 so that producers execute first.\n
+ *
+ * Always takes the first node (default order, index) with all producers
+ * done. If there is none (cycle) the first node left is taken and added to
+ * breaks.\n
+ *
+ * \param[in] producers Producers of each node (n entries).\n
+ * \param[out] order Node indices in execution order.\n
+ * \param[out] breaks Nodes executed before some of their producers.\n
+ */
+void exeOrderSort(const std::vector<std::vector<int> >& producers,
+                  std::vector<int>                     *order,
+                  std::vector<int>                     *breaks);
+
+/** \brief Collect points of batched nodes in an execution order.\n
+ *
+ * A batched node is only completed when the batch is collected (controller
+ * batch, see ecmcPIDBatch). The batch is collected before the first node
+ * that consumes a batched node executed since the last collect, so that
+ * every node sees the same data as without batching. Batched nodes left
+ * at the end are collected after the last node.\n
+ *
+ * \param[in] producers Producers of each node (n entries).\n
+ * \param[in] order Node indices in execution order.\n
+ * \param[in] batched Batched nodes (n entries).\n
+ * \param[out] collect Collect before order position k (order entries).\n
+ */
+void exeOrderBatchCollect(const std::vector<std::vector<int> >& producers,
+                          const std::vector<int>&                order,
+                          const std::vector<bool>&               batched,
+                          std::vector<bool>                     *collect);
+
+#endif  /* ECMC_EXE_ORDER_SORT_H_ */
@@ -15,6 +15,7 @@
 
 // TODO: REMOVE GLOBALS
 #include "ecmcGlobalsExtern.h"
+#include "ecmcAsynPortDriver.h"
 #include "ecmcAsynPortDriverUtils.h"
 #include "ecmcOctetIF.h"        // Log Macros
 #include "ecmcErrorsList.h"
@@ -29,11 +30,9 @@ int getControllerError() {
   }
 
   // Data Storages
-  for (int i = 0; i < ECMC_MAX_DATA_STORAGE_OBJECTS; i++) {
-    if (dataStorages[i] != NULL) {
-      if (dataStorages[i]->getError()) {
-        return dataStorages[i]->getErrorID();
-      }
+  for (int i = 0; i < dataStorages.activeCount(); i++) {
+    if (dataStorages.active(i)->getError()) {
+      return dataStorages.active(i)->getErrorID();
     }
   }
 
@@ -45,11 +44,9 @@ int getControllerError() {
   }
 
   // Axes
-  for (int i = 0; i < ECMC_MAX_AXES; i++) {
-    if (axes[i] != NULL) {
-      if (axes[i]->getError()) {
-        return axes[i]->getErrorID();
-      }
+  for (int i = 0; i < axes.activeCount(); i++) {
+    if (axes.active(i)->getError()) {
+      return axes.active(i)->getErrorID();
     }
   }
 
@@ -61,11 +58,9 @@ int getControllerError() {
   }
 
   // Plugin objects
-  for (int i = 0; i < ECMC_MAX_PLUGINS; i++) {
-    if (plugins[i]) {
-      if (plugins[i]->getError()) {
-        return plugins[i]->getErrorID();
-      }
+  for (int i = 0; i < plugins.activeCount(); i++) {
+    if (plugins.active(i)->getError()) {
+      return plugins.active(i)->getErrorID();
     }
   }
 
@@ -89,14 +84,14 @@ int controllerErrorReset() {
   ec->errorReset();
 
   // Data Storages
-  for (int i = 0; i < ECMC_MAX_DATA_STORAGE_OBJECTS; i++) {
+  for (int i = 0; i < dataStorages.size(); i++) {
     if (dataStorages[i] != NULL) {
       dataStorages[i]->errorReset();
     }
   }
 
   // Axes
-  for (int i = 0; i < ECMC_MAX_AXES; i++) {
+  for (int i = 0; i < axes.size(); i++) {
     if (axes[i] != NULL) {
       axes[i]->errorReset();
     }
@@ -108,7 +103,7 @@ int controllerErrorReset() {
   }
 
   // Plugin objects
-  for (int i = 0; i < ECMC_MAX_PLUGINS; i++) {
+  for (int i = 0; i < plugins.size(); i++) {
     if (plugins[i]) {
       plugins[i]->errorReset();
     }
@@ -338,3 +333,177 @@ int linkEcEntryToObject(char *ecPath, char *objPath) {
 
   return ERROR_MAIN_ECMC_LINK_INVALID;
 }
+
+int setMaxAxes(int count) {
+  LOGINFO4("%s/%s:%d count=%d\n", __FILE__, __FUNCTION__, __LINE__, count);
+
+  int errorCode = axes.resize(count);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  return axisGroups.resize(count);
+}
+
+int getMaxAxes() {
+  return axes.size();
+}
+
+int setMaxPLCs(int count) {
+  LOGINFO4("%s/%s:%d count=%d\n", __FILE__, __FUNCTION__, __LINE__, count);
+
+  // Axis PLC indices depend on the PLC count
+  if (plcs) {
+    return ERROR_MAIN_PLC_COUNT_LOCKED;
+  }
+
+  if ((count <= 0) || (count > ECMC_REGISTRY_MAX_SIZE)) {
+    return ERROR_MAIN_REGISTRY_SIZE_OUT_OF_RANGE;
+  }
+
+  maxPlcCount = count;
+  return 0;
+}
+
+int setMaxDataStorages(int count) {
+  LOGINFO4("%s/%s:%d count=%d\n", __FILE__, __FUNCTION__, __LINE__, count);
+  return dataStorages.resize(count);
+}
+
+int setMaxPlugins(int count) {
+  LOGINFO4("%s/%s:%d count=%d\n", __FILE__, __FUNCTION__, __LINE__, count);
+  return plugins.resize(count);
+}
+
+int setMaxLuts(int count) {
+  LOGINFO4("%s/%s:%d count=%d\n", __FILE__, __FUNCTION__, __LINE__, count);
+  return luts.resize(count);
+}
+
+int setEnableCmdMailbox(int enable) {
+  LOGINFO4("%s/%s:%d enable=%d\n", __FILE__, __FUNCTION__, __LINE__, enable);
+
+  cmdMailboxMode = enable;
+
+  // Only in config mode (rt thread not running)
+  if (!enable && cmdMailbox) {
+    delete cmdMailbox;
+    cmdMailbox = NULL;
+  }
+  return 0;
+}
+
+int setCmdMailboxSize(int size) {
+  LOGINFO4("%s/%s:%d size=%d\n", __FILE__, __FUNCTION__, __LINE__, size);
+
+  if ((size <= 0) || (size > ECMC_CMD_MAILBOX_MAX_SIZE)) {
+    return ERROR_CMD_MAILBOX_INVALID_SIZE;
+  }
+
+  cmdMailboxSize = size;
+
+  // Recreated at next transition to runtime
+  if (cmdMailbox) {
+    delete cmdMailbox;
+    cmdMailbox = NULL;
+  }
+  return 0;
+}
+
+int setCmdMailboxBudget(int budget) {
+  LOGINFO4("%s/%s:%d budget=%d\n", __FILE__, __FUNCTION__, __LINE__, budget);
+
+  if (budget <= 0) {
+    return ERROR_CMD_MAILBOX_INVALID_BUDGET;
+  }
+
+  cmdMailboxBudget = budget;
+
+  if (cmdMailbox) {
+    cmdMailbox->setBudget(budget);
+  }
+  return 0;
+}
+
+int getCmdMailboxRejected(uint64_t *count) {
+  LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
+
+  *count = 0;
+
+  if (cmdMailbox) {
+    *count = cmdMailbox->getRejected();
+  }
+  return 0;
+}
+
+int printCmdMailboxStatus() {
+  LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
+
+  if (!cmdMailbox) {
+    printf("Command mailbox not in use (enabled=%d).\n", cmdMailboxMode);
+    return 0;
+  }
+  cmdMailbox->printStatus();
+  return 0;
+}
+
+int setEnableAsynParamWheel(int enable) {
+  LOGINFO4("%s/%s:%d enable=%d\n", __FILE__, __FUNCTION__, __LINE__, enable);
+
+  if (!asynPort) {
+    return ERROR_MAIN_ASYN_PORT_DRIVER_NULL;
+  }
+
+  asynPort->setParamWheelEnable(enable);
+  return 0;
+}
+
+int printAsynParamWheel() {
+  LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
+
+  if (!asynPort) {
+    return ERROR_MAIN_ASYN_PORT_DRIVER_NULL;
+  }
+
+  asynPort->printParamWheel();
+  return 0;
+}
+
+int setAsynArrayBuffered(const char *paramName, int decimation) {
+  LOGINFO4("%s/%s:%d paramName=%s, decimation=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           paramName,
+           decimation);
+
+  if (!asynPort) {
+    return ERROR_MAIN_ASYN_PORT_DRIVER_NULL;
+  }
+
+  ecmcAsynDataItem *param = asynPort->findAvailParam(paramName);
+
+  if (!param) {
+    LOGERR("%s/%s:%d: ERROR: Parameter %s not found (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           paramName,
+           ERROR_ASYN_ARRAY_BUFFER_PARAM_NOT_FOUND);
+    return ERROR_ASYN_ARRAY_BUFFER_PARAM_NOT_FOUND;
+  }
+
+  return param->setArrayBuffered(decimation);
+}
+
+int printAsynArrayBuffered() {
+  LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
+
+  if (!asynPort) {
+    return ERROR_MAIN_ASYN_PORT_DRIVER_NULL;
+  }
+
+  asynPort->printArrayBuffered();
+  return 0;
+}
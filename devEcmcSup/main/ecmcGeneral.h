@@ -18,6 +18,8 @@
 #ifndef ECMC_GENERAL_H_
 #define ECMC_GENERAL_H_
 
+#include <stdint.h>
+
 # ifdef __cplusplus
 extern "C" {
 # endif  // ifdef __cplusplus
@@ -118,6 +120,204 @@ int setEnableTimeDiag(int value);
  */
 int setEnableFunctionCallDiag(int value);
 
+/** \brief Set number of axis slots (axis index range 0..count-1).\n
+ *
+ * The axis registry grows automatically when an axis with a higher index is
+ * created. Setting the size explicitly preallocates the registry and is
+ * needed if the motor record controller should handle more than the
+ * default number of axes (call before ecmcMotorRecordCreateController).
+ * The size can only be increased and is frozen when entering runtime.\n
+ *
+ * \param[in] count Number of axis slots.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Allow 300 axes.\n
+ *  "Cfg.SetMaxAxes(300)" //Command string to ecmcCmdParser.c\n
+ */
+int setMaxAxes(int count);
+
+/** \brief Get number of axis slots.\n */
+int getMaxAxes();
+
+/** \brief Set number of normal PLC slots (PLC index range 0..count-1).\n
+ *
+ * Axis PLCs are indexed above the normal PLCs so the count can only be
+ * changed before the first PLC (or axis PLC) is created.\n
+ *
+ * \param[in] count Number of PLC slots.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Allow 32 PLCs.\n
+ *  "Cfg.SetMaxPLCs(32)" //Command string to ecmcCmdParser.c\n
+ */
+int setMaxPLCs(int count);
+
+/** \brief Set number of data storage slots.\n
+ *
+ * \param[in] count Number of data storage slots.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Allow 64 data storages.\n
+ *  "Cfg.SetMaxDataStorages(64)" //Command string to ecmcCmdParser.c\n
+ */
+int setMaxDataStorages(int count);
+
+/** \brief Set number of plugin slots.\n
+ *
+ * \param[in] count Number of plugin slots.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Allow 32 plugins.\n
+ *  "Cfg.SetMaxPlugins(32)" //Command string to ecmcCmdParser.c\n
+ */
+int setMaxPlugins(int count);
+
+/** \brief Set number of lookup table slots.\n
+ *
+ * \param[in] count Number of lookup table slots.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Allow 32 lookup tables.\n
+ *  "Cfg.SetMaxLuts(32)" //Command string to ecmcCmdParser.c\n
+ */
+int setMaxLuts(int count);
+
+/** \brief Route asyn writes through the command mailbox.\n
+ *
+ * When enabled, asyn writes to ecmc objects (with a payload of up to
+ * 64 bytes) are not executed in the asyn thread. Instead they are posted to
+ * a bounded lock-free queue and executed by the realtime thread directly
+ * after the EtherCAT frame has been received (at most "budget" commands per
+ * cycle, see Cfg.SetCmdMailboxBudget()). Writes are rejected with an error
+ * if the queue is full. Larger array writes are posted and the asyn thread
+ * waits until the realtime thread has executed them.\n
+ * With the mailbox enabled the realtime thread does not take any locks:
+ * command parser calls (ecmcConfig, asyn octet) and the motor record driver
+ * are executed by the realtime thread (see ecmcRTExec()) and the asyn
+ * parameter callbacks are raised by a separate publisher thread (arrays are
+ * buffered). Heavy commands still extend the cycle they are executed in.\n
+ * Only allowed in configuration mode.\n
+ *
+ * \param[in] enable Enable command mailbox.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Enable command mailbox.\n
+ *  "Cfg.SetEnableCmdMailbox(1)" //Command string to ecmcCmdParser.c\n
+ */
+int setEnableCmdMailbox(int enable);
+
+/** \brief Set size of command mailbox.\n
+ *
+ * Size is rounded up to a power of 2 (default 256 commands).\n
+ * Only allowed in configuration mode.\n
+ *
+ * \param[in] size Number of commands.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Allow 1024 queued commands.\n
+ *  "Cfg.SetCmdMailboxSize(1024)" //Command string to ecmcCmdParser.c\n
+ */
+int setCmdMailboxSize(int size);
+
+/** \brief Set max number of mailbox commands executed per cycle.\n
+ *
+ * Remaining commands are executed in the following cycles (default 32).\n
+ *
+ * \param[in] budget Commands per cycle.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Execute max 8 commands per cycle.\n
+ *  "Cfg.SetCmdMailboxBudget(8)" //Command string to ecmcCmdParser.c\n
+ */
+int setCmdMailboxBudget(int budget);
+
+/** \brief Get number of commands rejected since the mailbox was full.\n
+ *
+ * \param[out] count Number of rejected commands.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Get rejected command count.\n
+ *  "GetCmdMailboxRejected()" //Command string to ecmcCmdParser.c\n
+ */
+int getCmdMailboxRejected(uint64_t *count);
+
+/** \brief Print command mailbox statistics.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print statistics.\n
+ *  "Cfg.PrintCmdMailboxStatus()" //Command string to ecmcCmdParser.c\n
+ */
+int printCmdMailboxStatus();
+
+/** \brief Publish asyn parameters with a timing wheel.\n
+ *
+ * When enabled, the parameters linked to records are scheduled by sample
+ * time when the ioc is running. Each cycle only the parameters that are
+ * due are published, and asyn callbacks are only done in cycles where a
+ * published value changed (instead of at the fastest sample time).
+ * The refresh calls of the owners then only update the data pointer
+ * (unless the data item has plugin subscribers).\n
+ * Only allowed in configuration mode.\n
+ *
+ * \param[in] enable Enable parameter wheel.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Enable parameter wheel.\n
+ *  "Cfg.SetEnableAsynParamWheel(1)" //Command string to ecmcCmdParser.c\n
+ */
+int setEnableAsynParamWheel(int enable);
+
+/** \brief Print asyn parameter wheel statistics.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print statistics.\n
+ *  "Cfg.PrintAsynParamWheel()" //Command string to ecmcCmdParser.c\n
+ */
+int printAsynParamWheel();
+
+/** \brief Publish an array parameter from a non realtime thread.\n
+ *
+ * The realtime thread hands over the array in a triple buffer (index flip,
+ * EtherCAT memmaps are copied directly into the buffer) and the
+ * doCallbacks*Array() calls are made by the thread "ecmcAsynArrPub".
+ * The callbacks are made with the port locked, one array at a time. The
+ * realtime thread only waits for them if it takes the port lock (not with
+ * the command mailbox, see setEnableCmdMailbox()). Readers always get a
+ * complete array.\n
+ * Only allowed in configuration mode.\n
+ *
+ * \param[in] paramName Asyn parameter name.\n
+ * \param[in] decimation Hand over every n:th refresh (1 = all).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Buffer memmap "ec0.s10.mm.CH1_ARRAY", every 10th refresh.\n
+ *  "Cfg.SetAsynArrayBuffered(ec0.s10.mm.CH1_ARRAY,10)" //Command string to ecmcCmdParser.c\n
+ */
+int setAsynArrayBuffered(const char *paramName,
+                         int         decimation);
+
+/** \brief Print array buffered asyn parameters.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print array buffered parameters.\n
+ *  "Cfg.PrintAsynArrayBuffered()" //Command string to ecmcCmdParser.c\n
+ */
+int printAsynArrayBuffered();
+
 # ifdef __cplusplus
 }
 # endif  // ifdef __cplusplus
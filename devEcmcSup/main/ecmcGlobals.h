@@ -23,26 +23,35 @@
 #include "ecmcPluginLib.h"
 #include "ecmcPVTController.h"
 #include "ecmcLookupTable.h"
+#include "ecmcCapture.h"
+#include "ecmcEcEdgeCapture.h"
 #include "epicsMutex.h"
 #include "ecmcMasterSlaveStateMachine.h"
+#include "ecmcPIDBatch.h"
+#include "ecmcRegistry.h"
+#include "ecmcCmdMailbox.h"
 
-ecmcAxisBase *axes[ECMC_MAX_AXES];
-ecmcAxisGroup *axisGroups[ECMC_MAX_AXES];
+ecmcRegistry<ecmcAxisBase> axes(ECMC_DEFAULT_AXES);
+ecmcRegistry<ecmcAxisGroup> axisGroups(ECMC_DEFAULT_AXES);
 size_t axisGroupCounter = 0;
 ecmcEc *ec;
-ecmcDataStorage  *dataStorages[ECMC_MAX_DATA_STORAGE_OBJECTS];
+ecmcRegistry<ecmcDataStorage> dataStorages(ECMC_DEFAULT_DATA_STORAGE_OBJECTS);
 ecmcPLCMain *plcs;
 ecmcAsynPortDriver *asynPort = NULL;
 ecmcAsynDataItem   *mainAsynParams[ECMC_ASYN_MAIN_PAR_COUNT];
 ecmcMainThreadDiag  threadDiag = { 0 };
 app_mode_type appModeCmd, appModeCmdOld, appModeStat;
 ecmcMotorRecordController *asynPortMotorRecord;
-ecmcPluginLib *plugins[ECMC_MAX_PLUGINS];
+ecmcRegistry<ecmcPluginLib> plugins(ECMC_DEFAULT_PLUGINS);
 ecmcPluginLib *safetyplugin = NULL;
 ecmcShm shmObj;
 ecmcPVTController *pvtCtrl_ = NULL;
-ecmcLookupTable<double, double>  *luts[ECMC_MAX_LUTS];
+ecmcRegistry<ecmcLookupTable<double, double> > luts(ECMC_DEFAULT_LUTS);
+ecmcRegistry<ecmcCapture> captures(ECMC_DEFAULT_CAPTURES);
+ecmcRegistry<ecmcEcEdgeCapture> edgeCaptures(ECMC_DEFAULT_EDGE_CAPTURES);
 ecmcMasterSlaveStateMachine *masterSlaveSMs[ECMC_MAX_MST_SLVS_SMS];
+ecmcPIDBatch *cntrlBatch = NULL;
+ecmcCmdMailbox *cmdMailbox = NULL;
 
 // Mutex for motor record access
 epicsMutexId ecmcRTMutex;
@@ -67,5 +76,11 @@ int    shmAccessError            = 0;
 int    currentMasterSlaveSMIndex = 0;
 int    allowCallbackEpicsState   = 0;
 int    epicsHookState            = 0;
+int    cntrlBatchMode            = 0;
+int    maxPlcCount               = ECMC_DEFAULT_PLCS;
+int    cntrlBatchVerify          = 0;
+int    cmdMailboxMode            = 0;
+int    cmdMailboxSize            = ECMC_CMD_MAILBOX_DEFAULT_SIZE;
+int    cmdMailboxBudget          = ECMC_CMD_MAILBOX_DEFAULT_BUDGET;
 
 #endif  /* ECMC_GLOBALS_H_ */
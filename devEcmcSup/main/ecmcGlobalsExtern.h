@@ -25,26 +25,35 @@
 #include "ecmcPluginLib.h"
 #include "ecmcPVTController.h"
 #include "ecmcLookupTable.h"
+#include "ecmcCapture.h"
+#include "ecmcEcEdgeCapture.h"
 #include "epicsMutex.h"
 #include "ecmcMasterSlaveStateMachine.h"
+#include "ecmcPIDBatch.h"
+#include "ecmcRegistry.h"
+#include "ecmcCmdMailbox.h"
 
-extern ecmcAxisBase *axes[ECMC_MAX_AXES];
-extern ecmcAxisGroup *axisGroups[ECMC_MAX_AXES];
+extern ecmcRegistry<ecmcAxisBase> axes;
+extern ecmcRegistry<ecmcAxisGroup> axisGroups;
 extern size_t axisGroupCounter;
 extern ecmcEc *ec;
-extern ecmcDataStorage  *dataStorages[ECMC_MAX_DATA_STORAGE_OBJECTS];
+extern ecmcRegistry<ecmcDataStorage> dataStorages;
 extern ecmcPLCMain *plcs;
 extern ecmcAsynPortDriver *asynPort;
 extern ecmcAsynDataItem   *mainAsynParams[ECMC_ASYN_MAIN_PAR_COUNT];
 extern ecmcMainThreadDiag  threadDiag;
 extern app_mode_type appModeCmd, appModeCmdOld, appModeStat;
 extern ecmcMotorRecordController *asynPortMotorRecord;
-extern ecmcPluginLib *plugins[ECMC_MAX_PLUGINS];
+extern ecmcRegistry<ecmcPluginLib> plugins;
 extern ecmcPluginLib *safetyplugin;
 extern ecmcShm shmObj;
 extern ecmcPVTController *pvtCtrl_;
-extern ecmcLookupTable<double, double>  *luts[ECMC_MAX_LUTS];
+extern ecmcRegistry<ecmcLookupTable<double, double> > luts;
+extern ecmcRegistry<ecmcCapture> captures;
+extern ecmcRegistry<ecmcEcEdgeCapture> edgeCaptures;
 extern ecmcMasterSlaveStateMachine *masterSlaveSMs[ECMC_MAX_MST_SLVS_SMS];
+extern ecmcPIDBatch *cntrlBatch;
+extern ecmcCmdMailbox *cmdMailbox;
 
 // Mutex for motor record access
 extern epicsMutexId ecmcRTMutex;
@@ -69,5 +78,11 @@ extern int    shmAccessError;
 extern int    currentMasterSlaveSMIndex;
 extern int    allowCallbackEpicsState;
 extern int    epicsHookState;
+extern int    cntrlBatchMode;
+extern int    maxPlcCount;
+extern int    cntrlBatchVerify;
+extern int    cmdMailboxMode;
+extern int    cmdMailboxSize;
+extern int    cmdMailboxBudget;
 
 #endif  /* ECMC_GLOBALS_EXTERN_H_ */
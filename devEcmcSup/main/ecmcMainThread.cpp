@@ -29,8 +29,10 @@
 #include <exception>
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "epicsThread.h"
+#include "epicsAtomic.h"
 #include "ecmcMainThread.h"
 #include "ecmcGeneral.h"
 #include "ecrt.h"
@@ -44,11 +46,19 @@
 #include "ecmcMisc.h"
 #include "ecmcAsynPortDriver.h"
 #include "ecmcMotorRecordController.h"
+#include "ecmcThreadCfg.h"
+#include "ecmcCfgTiming.h"
+#include "ecmcExeOrder.h"
+#include "ecmcAxisGroupTransform.h"
+#include "ecmcAxisGear.h"
+#include "ecmcCmdSnapshot.h"
 
 /****************************************************************************/
 extern int allowCallbackEpicsState;
 
 static unsigned int counter                          = 0;
+static epicsThreadId ecmcRTThreadId                  = NULL;
+static int rtLockFree                                = 0;  // epicsAtomic
 static struct timespec masterActivationTimeMonotonic = {};
 static struct timespec masterActivationTimeOffset    = {};
 static struct timespec masterActivationTimeRealtime  = {};
@@ -84,8 +94,7 @@ static inline bool writeMasterStatus(int masterId, char status) {
 
 void printStatus() {
   // Print axis diagnostics to screen
-  if (PRINT_STDOUT_BIT12() && (axisDiagIndex < ECMC_MAX_AXES) &&
-      (axisDiagIndex >= 0)) {
+  if (PRINT_STDOUT_BIT12() && axes.validIndex(axisDiagIndex)) {
     if (axes[axisDiagIndex] != NULL) {
       axes[axisDiagIndex]->printAxisStatus();
     }
@@ -166,6 +175,20 @@ void updateAsynParams(int force) {
                                                                         controllerErrorMsg));
   }
 
+  // Parameter wheel: publish due parameters, callbacks only if changed
+  if (localAsynPort->getParamWheelEnable()) {
+    localAsynPort->executeParamWheel();
+
+    if (localAsynPort->getParamsChanged() || force) {
+      // Counter published in the same callbacks
+      ecmcUpdatedCounter++;
+      mainAsynParams[ECMC_ASYN_MAIN_PAR_UPDATE_READY_ID]->refreshParamRT(1);
+      localAsynPort->callParamCallbacksRT();
+      localAsynPort->clearParamsChanged();
+    }
+    return;
+  }
+
   // Asyn callbacks for all parameters (except arrays)
   if (asynSkipUpdateCounterFastest && !force) {
     asynSkipUpdateCounterFastest--;
@@ -177,8 +200,7 @@ void updateAsynParams(int force) {
     }
 
     if (localAsynPort->getAllowRtThreadCom()) {
-      localAsynPort->callParamCallbacks(ECMC_ASYN_DEFAULT_LIST,
-                                        ECMC_ASYN_DEFAULT_ADDR);
+      localAsynPort->callParamCallbacksRT();
 
       /* refresh updated counter (To know in epics when refresh have been made)
       waveform*/
@@ -200,6 +222,66 @@ struct rtThreadOSD {
 
 typedef struct rtThreadOSD *rtThreadId;
 
+/* Object registries can only grow in configuration mode */
+static void setRegistriesFrozen(bool frozen) {
+  if (frozen) {
+    axes.freeze();
+    axisGroups.freeze();
+    dataStorages.freeze();
+    plugins.freeze();
+    luts.freeze();
+    captures.freeze();
+    edgeCaptures.freeze();
+  } else {
+    axes.unfreeze();
+    axisGroups.unfreeze();
+    dataStorages.unfreeze();
+    plugins.unfreeze();
+    luts.unfreeze();
+    captures.unfreeze();
+    edgeCaptures.unfreeze();
+  }
+}
+
+/* Attach controllers of all real axes to the batch controller */
+static int attachCntrlBatch() {
+  if (!cntrlBatch) {
+    cntrlBatch = new ecmcPIDBatch(axes.size());
+  }
+
+  cntrlBatch->setVerify(cntrlBatchVerify);
+
+  for (int i = 0; i < axes.size(); i++) {
+    if ((axes[i] == NULL) ||
+        (axes[i]->getAxisType() != ECMC_AXIS_TYPE_REAL)) {
+      continue;
+    }
+
+    ecmcPIDController *cntrl = axes[i]->getCntrl();
+
+    if (cntrl == NULL) {
+      continue;
+    }
+
+    int errorCode = cntrl->attachToBatch(cntrlBatch);
+
+    if (errorCode) {
+      LOGERR("%s/%s:%d: ERROR: Axis %d: Attach to controller batch failed (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             i,
+             errorCode);
+      return errorCode;
+    }
+  }
+
+  LOGINFO("ecmc::  Controller batch mode enabled (%zu controllers, SIMD width %d).\n",
+          cntrlBatch->getSlotCount(),
+          ECMC_PID_BATCH_VEC_WIDTH);
+  return 0;
+}
+
 static void* start_routine(void *arg) {
   LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
   rtThreadId thread = (rtThreadId)arg;
@@ -284,6 +366,56 @@ struct timespec timespec_sub(struct timespec time1, struct timespec time2) {
   return result;
 }
 
+int ecmcRTLockFree() {
+  return epicsAtomicGetIntT(&rtLockFree);
+}
+
+int ecmcRTExec(ecmcRTExecFunc func, void *arg) {
+  // Already exclusive
+  if (epicsThreadGetIdSelf() == ecmcRTThreadId) {
+    return func(arg);
+  }
+
+  if (ecmcRTLockFree()) {
+    int result    = 0;
+    int errorCode = cmdMailbox->call(func,
+                                     arg,
+                                     ECMC_CMD_MAILBOX_CALL_TIMEOUT_S,
+                                     &result);
+
+    if (!errorCode) {
+      return result;
+    }
+
+    // Not executed, fall back to the mutex only if the rt thread stopped
+    if ((errorCode != ERROR_CMD_MAILBOX_CALL_TIMEOUT) || ecmcRTLockFree()) {
+      LOGERR("%s/%s:%d: ERROR: Command mailbox call failed (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             errorCode);
+      return errorCode;
+    }
+  }
+
+  if (ecmcRTMutex) epicsMutexLock(ecmcRTMutex);
+  int result = func(arg);
+  if (ecmcRTMutex) epicsMutexUnlock(ecmcRTMutex);
+  return result;
+}
+
+/* Evaluate the controller batch and complete the staged axes */
+static void collectCntrlBatch(ecmcAxisBase **batchAxes,
+                              int           *count,
+                              int            ecStat) {
+  cntrlBatch->execute();
+
+  for (int i = 0; i < *count; i++) {
+    batchAxes[i]->executePostCntrl(ecStat);
+  }
+  *count = 0;
+}
+
 void cyclic_task(void *usr) {
   LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
   int i      = 0;
@@ -296,17 +428,36 @@ void cyclic_task(void *usr) {
   const bool hasRealMaster        = masterId >= 0;
   int axisDiagFreqCached          = -1;
   int slowCycleInterval           = 1;
-  int activeAxisCount             = 0;
-  ecmcAxisBase *activeAxes[ECMC_MAX_AXES] = {};
-  int activeAxisPlcId[ECMC_MAX_AXES] = {};
-  int activeMasterSlaveCount      = 0;
-  ecmcMasterSlaveStateMachine *activeMasterSlaves[ECMC_MAX_MST_SLVS_SMS] = {};
-  int activePluginCount           = 0;
-  ecmcPluginLib *activePlugins[ECMC_MAX_PLUGINS] = {};
+  // Registries are frozen in runtime, so the dense lists are fixed
+  const int activeAxisCount       = axes.activeCount();
+  std::vector<ecmcAxisBase *> activeAxes(activeAxisCount);
+  // Axis plcs, axes, gears, master slave state machines and transforms in
+  // data flow order
+  const int exeNodeCount          = exeOrderGetCount();
+  const ecmcExeNode *exeNodes     = exeOrderGetNodes();
+  std::vector<ecmcAxisBase *> exeAxes(exeNodeCount, NULL);
+  std::vector<ecmcMasterSlaveStateMachine *> exeMasterSlaves(exeNodeCount,
+                                                             NULL);
+  std::vector<ecmcAxisGroupTransform *> exeTransforms(exeNodeCount, NULL);
+  std::vector<ecmcAxisGear *> exeGears(exeNodeCount, NULL);
+  const int *exeBatchCollect      = exeOrderGetBatchCollect();
+  // Axes staged in the controller batch, not yet collected
+  std::vector<ecmcAxisBase *> batchAxes(exeNodeCount, NULL);
+  int batchAxisCount              = 0;
+  const int activePluginCount     = plugins.activeCount();
+  std::vector<ecmcPluginLib *> activePlugins(activePluginCount);
+  const int activeCaptureCount    = captures.activeCount();
+  std::vector<ecmcCapture *> activeCaptures(activeCaptureCount);
+  const int activeEdgeCaptureCount = edgeCaptures.activeCount();
+  std::vector<ecmcEcEdgeCapture *> activeEdgeCaptures(activeEdgeCaptureCount);
+  int snapshotAxis                = 0;
 
   int writeToShm = masterId < ECMC_SHM_MAX_MASTERS &&
                    masterId > -ECMC_SHM_MAX_MASTERS;
 
+  // Affinity and scheduling configured by Cfg.SetRtThread*()
+  applyRtThreadAttributes(mcuPeriod);
+
   offsetStartTime.tv_nsec = MCU_NSEC_PER_SEC / 10;
   offsetStartTime.tv_sec  = 0;
 
@@ -314,39 +465,63 @@ void cyclic_task(void *usr) {
   wakeupTime = timespec_add(masterActivationTimeMonotonic, offsetStartTime);
 
   // Build active object index lists once at RT start to avoid scanning sparse arrays each cycle.
-  for (int axisIndex = 0; axisIndex < ECMC_MAX_AXES; ++axisIndex) {
-    auto * const axis = axes[axisIndex];
-    if (axis != NULL) {
-      activeAxes[activeAxisCount] = axis;
-      activeAxisPlcId[activeAxisCount] = AXIS_PLC_ID_TO_PLC_ID(axisIndex);
-      activeAxisCount++;
-    }
+  for (int i = 0; i < activeAxisCount; ++i) {
+    activeAxes[i] = axes.active(i);
   }
-  for (int smsIndex = 0; smsIndex < ECMC_MAX_MST_SLVS_SMS; ++smsIndex) {
-    auto * const masterSlaveSM = masterSlaveSMs[smsIndex];
-    if (masterSlaveSM != NULL) {
-      activeMasterSlaves[activeMasterSlaveCount] = masterSlaveSM;
-      activeMasterSlaveCount++;
+  for (int i = 0; i < exeNodeCount; ++i) {
+    if (exeNodes[i].type == ECMC_EXE_NODE_AXIS) {
+      exeAxes[i] = axes[exeNodes[i].index];
+    } else if (exeNodes[i].type == ECMC_EXE_NODE_MST_SLV_SM) {
+      exeMasterSlaves[i] = masterSlaveSMs[exeNodes[i].index];
+    } else if ((exeNodes[i].type == ECMC_EXE_NODE_GRP_TRANSFORM_FWD) ||
+               (exeNodes[i].type == ECMC_EXE_NODE_GRP_TRANSFORM_INV)) {
+      exeTransforms[i] = axisGroups[exeNodes[i].index]->getTransform();
+    } else if (exeNodes[i].type == ECMC_EXE_NODE_AXIS_GEAR) {
+      exeGears[i] = axes[exeNodes[i].index]->getGear();
     }
   }
-  for (int pluginIndex = 0; pluginIndex < ECMC_MAX_PLUGINS; ++pluginIndex) {
-    auto * const plugin = plugins[pluginIndex];
-    if (plugin != NULL) {
-      activePlugins[activePluginCount] = plugin;
-      activePluginCount++;
-    }
+  for (int i = 0; i < activePluginCount; ++i) {
+    activePlugins[i] = plugins.active(i);
+  }
+  for (int i = 0; i < activeCaptureCount; ++i) {
+    activeCaptures[i] = captures.active(i);
   }
+  for (int i = 0; i < activeEdgeCaptureCount; ++i) {
+    activeEdgeCaptures[i] = edgeCaptures.active(i);
+  }
+
+  ecmcCmdMailbox *const localCmdMailbox = cmdMailbox;
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
+  /* With the command mailbox no other thread accesses the ecmc objects
+   * directly (see ecmcRTExec()) and the asyn publication is deferred to the
+   * param publisher thread, so no locks are taken in the rt loop.
+   */
+  const bool lockFree = localCmdMailbox != NULL;
+  ecmcRTThreadId = epicsThreadGetIdSelf();
+
+  if (lockFree) {
+    epicsAtomicSetIntT(&rtLockFree, 1);
+  } else if (ecmcRTMutex) {
+    epicsMutexLock(ecmcRTMutex);
+  }
 
   while (appModeCmd == ECMC_MODE_RUNTIME) {
     const bool ecInitDone = ec->getInitDone();
     auto * const localAsynPort = asynPort;
 
     wakeupTime.tv_nsec += cycletime.tv_nsec;
+
+    // Keep frames at a fixed phase to SYNC0 (Cfg.EcSetDcWakeupCtrl())
+    if (ecInitDone) {
+      wakeupTime.tv_nsec += ec->getDcWakeupAdjustNs();
+    }
+
     if (wakeupTime.tv_nsec >= MCU_NSEC_PER_SEC) {
       wakeupTime.tv_sec++;
       wakeupTime.tv_nsec -= MCU_NSEC_PER_SEC;
+    } else if (wakeupTime.tv_nsec < 0) {
+      wakeupTime.tv_sec--;
+      wakeupTime.tv_nsec += MCU_NSEC_PER_SEC;
     }
 
     /* Only lock asyn port when ec is started
@@ -354,20 +529,20 @@ void cyclic_task(void *usr) {
      * (sleep in waitforstartup() this is called
      * in asyn thread) .
      * */
-    if ((appModeStat == ECMC_MODE_RUNTIME) && localAsynPort) {
+    if (!lockFree && (appModeStat == ECMC_MODE_RUNTIME) && localAsynPort) {
       localAsynPort->unlock();
     }
 
     // Mutex for motor record access
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+    if (!lockFree && ecmcRTMutex) epicsMutexUnlock(ecmcRTMutex);
     clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeupTime, NULL);
 
-    if ((appModeStat == ECMC_MODE_RUNTIME) && localAsynPort) {
+    if (!lockFree && (appModeStat == ECMC_MODE_RUNTIME) && localAsynPort) {
       localAsynPort->lock();
     }
 
     // Mutex for motor record access
-    if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
+    if (!lockFree && ecmcRTMutex) epicsMutexLock(ecmcRTMutex);
 
     clock_gettime(CLOCK_MONOTONIC, &startTime);
 
@@ -414,10 +589,20 @@ void cyclic_task(void *usr) {
       ec->receive();
       ec->checkDomainsState();
       ecStat = ec->statusOK();
+
+      // Edges of inputs (before plcs and plugins)
+      for (i = 0; i < activeEdgeCaptureCount; i++) {
+        activeEdgeCaptures[i]->execute(ec->getLastAppTimeNs());
+      }
     } else {
       ecStat = 1;
     }
 
+    // Execute commands posted by non rt threads (asyn writes)
+    if (localCmdMailbox) {
+      localCmdMailbox->drain(localCmdMailbox->getBudget());
+    }
+
     // Master to master coms
     if (writeToShm) {
       if (hasRealMaster) {
@@ -427,11 +612,49 @@ void cyclic_task(void *usr) {
       }
     }
 
-    // Motion
-    for (i = 0; i < activeAxisCount; i++) {
-      auto * const axis = activeAxes[i];
-      plcs->execute(activeAxisPlcId[i], ecStat);
-      axis->execute(ecStat);
+    // Motion (axis plcs, axes, gears, master slave statemachines and
+    // transforms)
+    // Batch: stage the controllers, evaluate in one pass and complete the
+    // axes before the first node using them (same data as without batch)
+    for (i = 0; i < exeNodeCount; i++) {
+      if (batchAxisCount && exeBatchCollect[i]) {
+        collectCntrlBatch(batchAxes.data(), &batchAxisCount, ecStat);
+      }
+
+      switch (exeNodes[i].type) {
+      case ECMC_EXE_NODE_AXIS_PLC:
+        plcs->execute(AXIS_PLC_ID_TO_PLC_ID(exeNodes[i].index), ecStat);
+        break;
+
+      case ECMC_EXE_NODE_AXIS:
+        if (cntrlBatch) {
+          exeAxes[i]->executePreCntrl(ecStat);
+          batchAxes[batchAxisCount++] = exeAxes[i];
+        } else {
+          exeAxes[i]->execute(ecStat);
+        }
+        break;
+
+      case ECMC_EXE_NODE_MST_SLV_SM:
+        exeMasterSlaves[i]->execute();
+        break;
+
+      case ECMC_EXE_NODE_GRP_TRANSFORM_FWD:
+        exeTransforms[i]->executeForward();
+        break;
+
+      case ECMC_EXE_NODE_GRP_TRANSFORM_INV:
+        exeTransforms[i]->executeInverse();
+        break;
+
+      case ECMC_EXE_NODE_AXIS_GEAR:
+        exeGears[i]->execute();
+        break;
+      }
+    }
+
+    if (batchAxisCount) {
+      collectCntrlBatch(batchAxes.data(), &batchAxisCount, ecStat);
     }
 
     // PVT motion
@@ -439,11 +662,6 @@ void cyclic_task(void *usr) {
       pvtCtrl_->execute();
     }
 
-    // Master Slave statemachines
-    for (int i = 0; i < activeMasterSlaveCount; i++) {
-      activeMasterSlaves[i]->execute();
-    }
-
     // Plugins
     for (i = 0; i < activePluginCount; i++) {
       pluginsError = activePlugins[i]->exeRTFunc(controllerError);
@@ -454,6 +672,17 @@ void cyclic_task(void *usr) {
       plcs->execute(ecStat);
     }
 
+    // Captures (after plcs, cap_trigg() in same cycle)
+    for (i = 0; i < activeCaptureCount; i++) {
+      activeCaptures[i]->execute();
+    }
+
+    // Axis status snapshot for command clients (one axis per cycle)
+    if (activeAxisCount) {
+      ecmcCmdSnapshotPublish(activeAxes[snapshotAxis]);
+      snapshotAxis = snapshotAxis + 1 < activeAxisCount ? snapshotAxis + 1 : 0;
+    }
+
     if (counter) {
       counter--;
     } else {    // Lower freq
@@ -502,6 +731,20 @@ void cyclic_task(void *usr) {
     clock_gettime(CLOCK_MONOTONIC, &endTime);
   }  // enc of RT-loop
 
+  // Commands posted before the mailbox was detached
+  if (localCmdMailbox) {
+    epicsAtomicSetIntT(&rtLockFree, 0);
+    localCmdMailbox->drainAll();
+
+    // Objects accessed directly again (port locked by the writers)
+    if (asynPort) {
+      asynPort->setDeferredPublish(false);
+    }
+  }
+
+  // Status queries served by the command parser from now on
+  ecmcCmdSnapshotInvalidate();
+
   appModeStat = ECMC_MODE_CONFIG;
 
   // Write to SHM the this ioc closes down
@@ -528,22 +771,13 @@ int ecmcInitThread(void) {
   axisDiagFreq  = 10;
   setDiagAxisEnable(0);
 
-  for (int i = 0; i < ECMC_MAX_AXES; i++) {
-    axisGroups[i] = NULL;
-    axes[i] = NULL;
-  }
-
-  for (int i = 0; i < ECMC_MAX_DATA_STORAGE_OBJECTS; i++) {
-    dataStorages[i] = NULL;
-  }
-
-  for (int i = 0; i < ECMC_MAX_PLUGINS; i++) {
-    plugins[i] = NULL;
-  }
-
-  for (int i = 0; i < ECMC_MAX_LUTS; i++) {
-    luts[i] = NULL;
-  }
+  axisGroups.clear();
+  axes.clear();
+  dataStorages.clear();
+  plugins.clear();
+  luts.clear();
+  captures.clear();
+  edgeCaptures.clear();
 
   for (int i = 0; i < ECMC_MAX_MST_SLVS_SMS; i++) {
     masterSlaveSMs[i] = NULL;
@@ -627,11 +861,13 @@ int lockMem(int size) {
   // lock memory
   if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
     LOGERR("WARNING: mlockall() failed (0x%x).\n", ERROR_MAIN_MLOCKALL_FAIL);
+    setMemLockStatus(0);
 
     // return ERROR_MAIN_MLOCKALL_FAIL;
   } else {
     // Memlock OK
-    threadDiag.status = threadDiag.status || 0x2;
+    threadDiag.status = threadDiag.status | 0x2;
+    setMemLockStatus(1);
   }
   mainAsynParams[ECMC_ASYN_MAIN_PAR_STATUS_ID]->refreshParamRT(1);
 
@@ -682,12 +918,18 @@ int startRTthread() {
 
 int setAppModeCfg(int mode) {
   LOGINFO4("INFO:\t\tApplication in configuration mode.\n");
+
+  // Asyn writes directly to objects again
+  if (asynPort) {
+    asynPort->setCmdMailbox(NULL);
+  }
+
   appModeCmdOld = appModeCmd;
   appModeCmd    = (app_mode_type)mode;
 
   if ((appModeCmd == ECMC_MODE_CONFIG) &&
       (appModeCmdOld == ECMC_MODE_RUNTIME)) {
-    for (int i = 0; i < ECMC_MAX_PLUGINS; ++i) {
+    for (int i = 0; i < plugins.size(); ++i) {
       if (plugins[i]) {
         int errorCode = plugins[i]->exeExitRTFunc();
 
@@ -706,12 +948,14 @@ int setAppModeCfg(int mode) {
     asynPort->setAllowRtThreadCom(false);
   }
 
-  for (int i = 0; i < ECMC_MAX_AXES; i++) {
+  for (int i = 0; i < axes.size(); i++) {
     if (axes[i] != NULL) {
       axes[i]->setRealTimeStarted(false);
     }
   }
 
+  setRegistriesFrozen(false);
+
   // For some reason the "munlockall" results in several missed frames of other masters.
   // munlockall();
 
@@ -723,6 +967,8 @@ int setAppModeRun(int mode) {
     return ERROR_MAIN_APP_MODE_ALREADY_RUNTIME;
   }
 
+  double startTime = cfgTimingNow();
+
   // wait for ethercat scan (if rescan is just done)
   int errorCode = waitForEcMasterScan(
     ecTimeoutSeconds > 0 ? ecTimeoutSeconds : EC_START_TIMEOUT_S);
@@ -730,6 +976,7 @@ int setAppModeRun(int mode) {
   if (errorCode) {
     return errorCode;
   }
+  cfgTimingAddPhase("setAppMode: wait for ec master scan", startTime);
 
   // Block rt communication during startup
   // (since sleep in waitForThreadToStart())
@@ -746,20 +993,48 @@ int setAppModeRun(int mode) {
                                  ECMC_ASYN_DEFAULT_ADDR);
   }
 
-  for (int i = 0; i < ECMC_MAX_AXES; i++) {
+  for (int i = 0; i < axes.size(); i++) {
     if (axes[i] != NULL) {
       axes[i]->setInStartupPhase(true);
     }
   }
 
+  startTime = cfgTimingNow();
   errorCode = validateConfig();
 
   if (errorCode) {
     return errorCode;
   }
+  cfgTimingAddPhase("setAppMode: validate config", startTime);
+
+  setRegistriesFrozen(true);
+
+  if (cntrlBatchMode) {
+    errorCode = attachCntrlBatch();
+
+    if (errorCode) {
+      return errorCode;
+    }
+  }
+
+  if (cmdMailboxMode && !cmdMailbox) {
+    cmdMailbox = new ecmcCmdMailbox(cmdMailboxSize);
+    cmdMailbox->setBudget(cmdMailboxBudget);
+  }
+
+  // Lock free rt thread, asyn publication by the param publisher thread
+  if (cmdMailbox && asynPort) {
+    errorCode = asynPort->setDeferredPublish(true);
+
+    if (errorCode) {
+      return errorCode;
+    }
+  }
 
   // Plugins
-  for (int i = 0; i < ECMC_MAX_PLUGINS; ++i) {
+  startTime = cfgTimingNow();
+
+  for (int i = 0; i < plugins.size(); ++i) {
     if (plugins[i]) {
       errorCode = plugins[i]->exeEnterRTFunc();
 
@@ -777,6 +1052,8 @@ int setAppModeRun(int mode) {
     }
   }
 
+  cfgTimingAddPhase("setAppMode: plugins enter rt", startTime);
+
   clock_gettime(CLOCK_MONOTONIC, &masterActivationTimeMonotonic);
 
   // absolute clock (epoch)
@@ -789,14 +1066,29 @@ int setAppModeRun(int mode) {
     ecrt_master_application_time(ec->getMaster(),
                                  TIMESPEC2NS(masterActivationTimeRealtime));
 
+    startTime = cfgTimingNow();
+
     if (ec->activate()) {
       LOGERR("INFO:\t\tActivation of master failed.\n");
       return ERROR_MAIN_EC_ACTIVATE_FAILED;
     }
+    cfgTimingAddPhase("setAppMode: ec master activate", startTime);
+
+    // Bind edge captures to the process image
+    for (int i = 0; i < edgeCaptures.size(); i++) {
+      if (edgeCaptures[i] != NULL) {
+        errorCode = edgeCaptures[i]->activate();
+
+        if (errorCode) {
+          return errorCode;
+        }
+      }
+    }
   } else {
     LOGERR(
       "WARNING: EtherCAT master not initialized. Starting ECMC without EtherCAT support.\n");
   }
+  startTime = cfgTimingNow();
   errorCode = startRTthread();
 
   if (errorCode) {
@@ -805,7 +1097,7 @@ int setAppModeRun(int mode) {
 
   LOGINFO4("INFO:\t\tApplication in runtime mode.\n");
 
-  for (int i = 0; i < ECMC_MAX_AXES; i++) {
+  for (int i = 0; i < axes.size(); i++) {
     if (axes[i] != NULL) {
       axes[i]->setRealTimeStarted(true);
     }
@@ -817,10 +1109,14 @@ int setAppModeRun(int mode) {
   if (errorCode) {
     return errorCode;
   }
+  cfgTimingAddPhase("setAppMode: start rt thread", startTime);
   appModeStat = ECMC_MODE_RUNTIME;
 
+  printRtSystemCheck();
+
   if (asynPort) {
     asynPort->setAllowRtThreadCom(true);  // Set by epics state hooks
+    asynPort->setCmdMailbox(cmdMailbox);
   }
 
   int masterId = ec->getMasterIndex();
@@ -965,7 +1261,7 @@ int validateConfig() {
     }
   }
 
-  for (int i = 0; i < ECMC_MAX_AXES; i++) {
+  for (int i = 0; i < axes.size(); i++) {
     if (axes[i] != NULL) {
       axisCount++;
       errorCode = axes[i]->validate();
@@ -976,6 +1272,17 @@ int validateConfig() {
                errorCode);
         return errorCode;
       }
+
+      if (axes[i]->getGear()) {
+        errorCode = axes[i]->getGear()->validate();
+
+        if (errorCode) {
+          LOGERR("ERROR: Validation failed on gear of axis %d with error code %x.",
+                 i,
+                 errorCode);
+          return errorCode;
+        }
+      }
     }
   }
 
@@ -1003,5 +1310,42 @@ int validateConfig() {
     }
   }
 
+  // Plc variables exist, data items can be resolved
+  for (int i = 0; i < captures.size(); i++) {
+    if (captures[i] != NULL) {
+      errorCode = captures[i]->validate();
+
+      if (errorCode) {
+        LOGERR("ERROR: Validation failed on capture %d with error code %x.",
+               i,
+               errorCode);
+        return errorCode;
+      }
+    }
+  }
+
+  for (int i = 0; i < axisGroups.size(); i++) {
+    if ((axisGroups[i] != NULL) && axisGroups[i]->getTransform()) {
+      errorCode = axisGroups[i]->getTransform()->validate();
+
+      if (errorCode) {
+        LOGERR(
+          "ERROR: Validation failed on transform of axis group %d with error code %x.",
+          i,
+          errorCode);
+        return errorCode;
+      }
+    }
+  }
+
+  // Plcs are compiled, axis variables are known
+  errorCode = exeOrderBuild();
+
+  if (errorCode) {
+    LOGERR("ERROR: Build of execution order failed with error code %x.",
+           errorCode);
+    return errorCode;
+  }
+
   return 0;
 }
@@ -26,10 +26,14 @@
 #include "epicsThread.h"
 #include "ecmcDefinitions.h"
 
+#ifdef __cplusplus
+#include <type_traits>
+#endif  // ifdef __cplusplus
+
 #define AXIS_CHECK_RETURN_USED_BUFFER(_axis) { init_axis(_axis);\
                                                if (((_axis) <= 0) ||\
                                                    ((_axis) >=\
-                                                    ECMC_MAX_AXES)) return 0; }
+                                                    getMaxAxes())) return 0; }
 
 #ifdef __cplusplus
 extern "C" {
@@ -108,8 +112,61 @@ int setSamplePeriodMs(double samplePeriodMs);
 
 void updateAsynParams(int force);
 
+typedef int (*ecmcRTExecFunc)(void *arg);
+
+/** \brief Execute function exclusive with the realtime thread
+ *
+ * With the command mailbox enabled (see setEnableCmdMailbox()) the
+ * realtime thread does not take any locks. The function is then posted to
+ * the mailbox and executed by the realtime thread, the caller waits for the
+ * result. Otherwise the function is executed by the caller with ecmcRTMutex
+ * locked. Executed directly if called from the realtime thread.\n
+ * The caller must not hold ecmcRTMutex.\n
+ *
+ * \param[in] func Function.\n
+ * \param[in] arg  Argument to function.\n
+ *
+ * \return Return value of func or an error code if not executed.\n
+ */
+int ecmcRTExec(ecmcRTExecFunc func,
+               void          *arg);
+
+/** \brief Realtime thread runs without locks (command mailbox in use)
+ *
+ * \return 1 if lock free.\n
+ */
+int ecmcRTLockFree(void);
+
 #ifdef __cplusplus
 }
+
+// Execute f() exclusive with the realtime thread (see ecmcRTExec()).
+// Returns the int returned by f() (0 for void) or the error code if f()
+// was not executed (command mailbox full or timeout). Always check it.
+template <class F>
+static int ecmcRTExecInvoke(F& f, std::true_type) {
+  f();
+  return 0;
+}
+
+template <class F>
+static int ecmcRTExecInvoke(F& f, std::false_type) {
+  return f();
+}
+
+template <class F>
+static int ecmcRTExecFunctor(void *arg) {
+  F& f = *static_cast<F *>(arg);
+
+  return ecmcRTExecInvoke(f, std::is_void<decltype(f())>());
+}
+
+template <class F>
+int ecmcRTExec(F&& f) {
+  return ecmcRTExec(ecmcRTExecFunctor<typename std::remove_reference<F>::type>,
+                    &f);
+}
+
 #endif  // ifdef __cplusplus
 
 #endif  /* ECMC_MAIN_TASK_H_ */
@@ -0,0 +1,144 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcRegistry.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Index based object registry replacing the fixed size global object arrays
+* (axes, data storages, plugins, luts..).
+* The registry grows (never shrinks) during configuration and is frozen
+* before runtime. A dense list of the non NULL objects is maintained so that
+* cyclic code does not need to scan the (possibly sparse) index range.
+*
+\*************************************************************************/
+
+#ifndef ECMC_REGISTRY_H_
+#define ECMC_REGISTRY_H_
+
+#include <vector>
+#include <stddef.h>
+#include "ecmcErrorsList.h"
+
+// Upper limit of any registry (sanity check of indices)
+#define ECMC_REGISTRY_MAX_SIZE 4096
+
+template<typename T>
+class ecmcRegistry {
+public:
+  explicit ecmcRegistry(int size) {
+    frozen_ = false;
+    resize(size);
+  }
+
+  // Returns NULL for empty slots and indices out of range
+  T* operator[](int index) const {
+    if (!validIndex(index)) {
+      return NULL;
+    }
+    return items_[index];
+  }
+
+  int size() const {
+    return (int)items_.size();
+  }
+
+  bool validIndex(int index) const {
+    return index >= 0 && index < (int)items_.size();
+  }
+
+  // Grow to at least size slots (never shrinks). Not allowed when frozen.
+  int resize(int size) {
+    if (size <= (int)items_.size()) {
+      return 0;
+    }
+
+    if (size > ECMC_REGISTRY_MAX_SIZE) {
+      return ERROR_MAIN_REGISTRY_SIZE_OUT_OF_RANGE;
+    }
+
+    if (frozen_) {
+      return ERROR_MAIN_REGISTRY_FROZEN;
+    }
+
+    items_.resize(size, NULL);
+
+    // Dense lists will never need to reallocate
+    active_.reserve(size);
+    activeIndex_.reserve(size);
+    return 0;
+  }
+
+  // Store object at index (grows registry if needed)
+  int set(int index, T *obj) {
+    if (index < 0) {
+      return ERROR_MAIN_REGISTRY_SIZE_OUT_OF_RANGE;
+    }
+
+    int errorCode = resize(index + 1);
+
+    if (errorCode) {
+      return errorCode;
+    }
+
+    items_[index] = obj;
+    updateActive();
+    return 0;
+  }
+
+  // Set all slots to NULL (objects are not deleted)
+  void clear() {
+    for (size_t i = 0; i < items_.size(); i++) {
+      items_[i] = NULL;
+    }
+    updateActive();
+  }
+
+  void freeze() {
+    frozen_ = true;
+  }
+
+  void unfreeze() {
+    frozen_ = false;
+  }
+
+  bool getFrozen() const {
+    return frozen_;
+  }
+
+  // Dense list of non NULL objects (in index order)
+  int activeCount() const {
+    return (int)active_.size();
+  }
+
+  T* active(int i) const {
+    return active_[i];
+  }
+
+  int activeIndex(int i) const {
+    return activeIndex_[i];
+  }
+
+private:
+  void updateActive() {
+    active_.clear();
+    activeIndex_.clear();
+
+    for (size_t i = 0; i < items_.size(); i++) {
+      if (items_[i]) {
+        active_.push_back(items_[i]);
+        activeIndex_.push_back((int)i);
+      }
+    }
+  }
+
+  std::vector<T *>items_;
+  std::vector<T *>active_;
+  std::vector<int>activeIndex_;
+  bool frozen_;
+};
+
+#endif  /* ECMC_REGISTRY_H_ */
@@ -0,0 +1,592 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcThreadCfg.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcThreadCfg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/syscall.h>
+#include "ecmcOctetIF.h"        // Log Macros
+#include "ecmcErrorsList.h"
+#include "ecmcDefinitions.h"
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif  // ifndef SCHED_DEADLINE
+
+#define ECMC_SCHED_NOT_SET -1
+
+// Kernel interface for SCHED_DEADLINE (not in glibc)
+struct ecmcSchedAttr {
+  uint32_t size;
+  uint32_t sched_policy;
+  uint64_t sched_flags;
+  int32_t  sched_nice;
+  uint32_t sched_priority;
+  uint64_t sched_runtime;
+  uint64_t sched_deadline;
+  uint64_t sched_period;
+};
+
+struct ecmcHelperThread {
+  pthread_t thread;
+  char      name[32];
+  int       used;
+};
+
+// Realtime thread config
+static cpu_set_t rtCpus;
+static int rtCpusSet          = 0;
+static char rtCpuList[ECMC_THREAD_CFG_CPU_LIST_MAX_CHARS] = "";
+static int rtPolicy           = ECMC_SCHED_NOT_SET;
+static int rtPriority         = 0;
+static int rtDeadlineRuntimeUs = 0;
+
+// Realtime thread state (for system check)
+static pthread_t rtThread;
+static int rtThreadValid      = 0;
+static int rtApplyError       = 0;
+static int memLocked          = -1;
+
+// Helper threads
+static cpu_set_t helperCpus;
+static int helperCpusSet      = 0;
+static int helperPriority     = 0;
+static ecmcHelperThread helperThreads[ECMC_MAX_HELPER_THREADS];
+static pthread_mutex_t  helperLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Parse "2", "1,3" or "0-2,5" */
+static int parseCpuList(const char *cpuList, cpu_set_t *cpus) {
+  long cpuCount = sysconf(_SC_NPROCESSORS_CONF);
+  const char *p = cpuList;
+
+  CPU_ZERO(cpus);
+
+  if (!cpuList || !cpuList[0]) {
+    return ERROR_MAIN_THREAD_INVALID_CPU_LIST;
+  }
+
+  while (*p) {
+    char *end = NULL;
+    long  first = strtol(p, &end, 10);
+
+    if (end == p) {
+      return ERROR_MAIN_THREAD_INVALID_CPU_LIST;
+    }
+    long last = first;
+    p = end;
+
+    if (*p == '-') {
+      p++;
+      last = strtol(p, &end, 10);
+
+      if (end == p) {
+        return ERROR_MAIN_THREAD_INVALID_CPU_LIST;
+      }
+      p = end;
+    }
+
+    if ((first < 0) || (last < first) || (last >= CPU_SETSIZE) ||
+        ((cpuCount > 0) && (last >= cpuCount))) {
+      return ERROR_MAIN_THREAD_INVALID_CPU_LIST;
+    }
+
+    for (long cpu = first; cpu <= last; cpu++) {
+      CPU_SET(cpu, cpus);
+    }
+
+    if (*p == ',') {
+      p++;
+    } else if (*p) {
+      return ERROR_MAIN_THREAD_INVALID_CPU_LIST;
+    }
+  }
+  return 0;
+}
+
+static const char* policyToString(int policy) {
+  switch (policy) {
+  case SCHED_FIFO:
+    return "FIFO";
+
+  case SCHED_RR:
+    return "RR";
+
+  case SCHED_OTHER:
+    return "OTHER";
+
+  case SCHED_DEADLINE:
+    return "DEADLINE";
+
+  default:
+    return "UNKNOWN";
+  }
+}
+
+static void cpuSetToString(const cpu_set_t *cpus, char *buffer, size_t size) {
+  size_t used = 0;
+
+  buffer[0] = '\0';
+
+  for (int cpu = 0; cpu < CPU_SETSIZE && used < size; cpu++) {
+    if (CPU_ISSET(cpu, cpus)) {
+      used += snprintf(buffer + used, size - used, used ? ",%d" : "%d", cpu);
+    }
+  }
+}
+
+static int setThreadSched(pthread_t thread, int policy, int priority) {
+  struct sched_param param = {};
+
+  param.sched_priority = priority;
+  return pthread_setschedparam(thread, policy, &param);
+}
+
+static void applyHelperAttributes(pthread_t thread, const char *name) {
+  int result = 0;
+
+  if (helperCpusSet) {
+    result = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &helperCpus);
+
+    if (result) {
+      LOGERR("WARNING: Failed to set affinity of helper thread %s (%s).\n",
+             name,
+             strerror(result));
+    }
+  }
+
+  if (helperPriority > 0) {
+    result = setThreadSched(thread, SCHED_FIFO, helperPriority);
+
+    if (result) {
+      LOGERR("WARNING: Failed to set priority of helper thread %s (%s).\n",
+             name,
+             strerror(result));
+    }
+  }
+}
+
+static void applyHelperAttributesAll() {
+  pthread_mutex_lock(&helperLock);
+
+  for (int i = 0; i < ECMC_MAX_HELPER_THREADS; i++) {
+    if (helperThreads[i].used) {
+      applyHelperAttributes(helperThreads[i].thread, helperThreads[i].name);
+    }
+  }
+  pthread_mutex_unlock(&helperLock);
+}
+
+int setRtThreadAffinity(const char *cpuList) {
+  LOGINFO4("%s/%s:%d cpuList=%s\n", __FILE__, __FUNCTION__, __LINE__,
+           cpuList);
+
+  cpu_set_t cpus;
+  int errorCode = parseCpuList(cpuList, &cpus);
+
+  if (errorCode) {
+    LOGERR("ERROR: Invalid cpu list \"%s\" (0x%x).\n", cpuList, errorCode);
+    return errorCode;
+  }
+
+  rtCpus    = cpus;
+  rtCpusSet = 1;
+  snprintf(rtCpuList, sizeof(rtCpuList), "%s", cpuList);
+  return 0;
+}
+
+int setRtThreadSchedPolicy(const char *policy) {
+  LOGINFO4("%s/%s:%d policy=%s\n", __FILE__, __FUNCTION__, __LINE__, policy);
+
+  if (!strcmp(policy, "FIFO")) {
+    rtPolicy = SCHED_FIFO;
+  } else if (!strcmp(policy, "RR")) {
+    rtPolicy = SCHED_RR;
+  } else if (!strcmp(policy, "OTHER")) {
+    rtPolicy = SCHED_OTHER;
+  } else if (!strcmp(policy, "DEADLINE")) {
+#ifdef SYS_sched_setattr
+    rtPolicy = SCHED_DEADLINE;
+#else  // ifdef SYS_sched_setattr
+    LOGERR("ERROR: SCHED_DEADLINE not supported on this system (0x%x).\n",
+           ERROR_MAIN_THREAD_INVALID_SCHED_POLICY);
+    return ERROR_MAIN_THREAD_INVALID_SCHED_POLICY;
+#endif  // ifdef SYS_sched_setattr
+  } else {
+    LOGERR("ERROR: Invalid scheduling policy \"%s\" (0x%x).\n",
+           policy,
+           ERROR_MAIN_THREAD_INVALID_SCHED_POLICY);
+    return ERROR_MAIN_THREAD_INVALID_SCHED_POLICY;
+  }
+  return 0;
+}
+
+int setRtThreadPriority(int priority) {
+  LOGINFO4("%s/%s:%d priority=%d\n", __FILE__, __FUNCTION__, __LINE__,
+           priority);
+
+  if ((priority < sched_get_priority_min(SCHED_FIFO)) ||
+      (priority > sched_get_priority_max(SCHED_FIFO))) {
+    return ERROR_MAIN_THREAD_INVALID_PRIORITY;
+  }
+
+  rtPriority = priority;
+
+  if (rtPolicy == ECMC_SCHED_NOT_SET) {
+    rtPolicy = SCHED_FIFO;
+  }
+  return 0;
+}
+
+int setRtThreadDeadlineRuntimeUs(int runtimeUs) {
+  LOGINFO4("%s/%s:%d runtimeUs=%d\n", __FILE__, __FUNCTION__, __LINE__,
+           runtimeUs);
+
+  if (runtimeUs <= 0) {
+    return ERROR_MAIN_THREAD_INVALID_RUNTIME;
+  }
+  rtDeadlineRuntimeUs = runtimeUs;
+  return 0;
+}
+
+int setHelperThreadAffinity(const char *cpuList) {
+  LOGINFO4("%s/%s:%d cpuList=%s\n", __FILE__, __FUNCTION__, __LINE__,
+           cpuList);
+
+  cpu_set_t cpus;
+  int errorCode = parseCpuList(cpuList, &cpus);
+
+  if (errorCode) {
+    LOGERR("ERROR: Invalid cpu list \"%s\" (0x%x).\n", cpuList, errorCode);
+    return errorCode;
+  }
+
+  helperCpus    = cpus;
+  helperCpusSet = 1;
+  applyHelperAttributesAll();
+  return 0;
+}
+
+int setHelperThreadPriority(int priority) {
+  LOGINFO4("%s/%s:%d priority=%d\n", __FILE__, __FUNCTION__, __LINE__,
+           priority);
+
+  if ((priority < 0) || (priority > sched_get_priority_max(SCHED_FIFO))) {
+    return ERROR_MAIN_THREAD_INVALID_PRIORITY;
+  }
+
+  helperPriority = priority;
+  applyHelperAttributesAll();
+  return 0;
+}
+
+int applyRtThreadAttributes(double periodNs) {
+  LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
+  int result = 0;
+
+  rtThread      = pthread_self();
+  rtThreadValid = 1;
+  rtApplyError  = 0;
+
+  if (rtCpusSet) {
+    result = pthread_setaffinity_np(rtThread, sizeof(cpu_set_t), &rtCpus);
+
+    if (result) {
+      LOGERR("ERROR: Failed to set rt thread affinity to %s: %s (0x%x).\n",
+             rtCpuList,
+             strerror(result),
+             ERROR_MAIN_THREAD_ATTR_APPLY_FAIL);
+      rtApplyError = ERROR_MAIN_THREAD_ATTR_APPLY_FAIL;
+    }
+  }
+
+  if (rtPolicy == ECMC_SCHED_NOT_SET) {
+    return rtApplyError;
+  }
+
+  if (rtPolicy == SCHED_DEADLINE) {
+#ifdef SYS_sched_setattr
+    struct ecmcSchedAttr attr = {};
+    attr.size           = sizeof(attr);
+    attr.sched_policy   = SCHED_DEADLINE;
+    attr.sched_period   = (uint64_t)periodNs;
+    attr.sched_deadline = (uint64_t)periodNs;
+    attr.sched_runtime  = rtDeadlineRuntimeUs > 0 ?
+                          (uint64_t)rtDeadlineRuntimeUs * 1000 :
+                          (uint64_t)(periodNs / 2);
+    result = syscall(SYS_sched_setattr, 0, &attr, 0) ? errno : 0;
+#else  // ifdef SYS_sched_setattr
+    result = ENOSYS;
+#endif  // ifdef SYS_sched_setattr
+  } else {
+    // FIFO/RR without priority: keep the current rt priority (0 is invalid)
+    if ((rtPolicy != SCHED_OTHER) &&
+        (rtPriority < sched_get_priority_min(rtPolicy))) {
+      struct sched_param param = {};
+      int policy               = 0;
+
+      if (pthread_getschedparam(rtThread, &policy, &param) ||
+          (param.sched_priority < sched_get_priority_min(rtPolicy))) {
+        param.sched_priority = sched_get_priority_min(rtPolicy);
+      }
+      rtPriority = param.sched_priority;
+      LOGINFO("INFO: No rt thread priority set, using %d for %s.\n",
+              rtPriority,
+              policyToString(rtPolicy));
+    }
+    result = setThreadSched(rtThread,
+                            rtPolicy,
+                            rtPolicy == SCHED_OTHER ? 0 : rtPriority);
+  }
+
+  if (result) {
+    LOGERR("ERROR: Failed to set rt thread scheduling %s (prio %d): %s (0x%x).\n",
+           policyToString(rtPolicy),
+           rtPriority,
+           strerror(result),
+           ERROR_MAIN_THREAD_ATTR_APPLY_FAIL);
+    rtApplyError = ERROR_MAIN_THREAD_ATTR_APPLY_FAIL;
+  }
+
+  return rtApplyError;
+}
+
+void registerHelperThread(const char *name) {
+  pthread_t self = pthread_self();
+
+  pthread_mutex_lock(&helperLock);
+
+  for (int i = 0; i < ECMC_MAX_HELPER_THREADS; i++) {
+    if (!helperThreads[i].used) {
+      helperThreads[i].thread = self;
+      helperThreads[i].used   = 1;
+      snprintf(helperThreads[i].name, sizeof(helperThreads[i].name), "%s",
+               name);
+      applyHelperAttributes(self, name);
+      break;
+    }
+  }
+  pthread_mutex_unlock(&helperLock);
+}
+
+void unregisterHelperThread() {
+  pthread_t self = pthread_self();
+
+  pthread_mutex_lock(&helperLock);
+
+  for (int i = 0; i < ECMC_MAX_HELPER_THREADS; i++) {
+    if (helperThreads[i].used &&
+        pthread_equal(helperThreads[i].thread, self)) {
+      helperThreads[i].used = 0;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&helperLock);
+}
+
+void setMemLockStatus(int locked) {
+  memLocked = locked;
+}
+
+/* Read first line of a file. Returns 0 if success */
+static int readLine(const char *path, char *buffer, size_t size) {
+  FILE *file = fopen(path, "r");
+
+  if (!file) {
+    return -1;
+  }
+
+  if (!fgets(buffer, size, file)) {
+    buffer[0] = '\0';
+  }
+  fclose(file);
+  buffer[strcspn(buffer, "\n")] = '\0';
+  return 0;
+}
+
+static int cpuSetsIntersect(const cpu_set_t *a, const cpu_set_t *b) {
+  cpu_set_t result;
+
+  CPU_AND(&result, a, b);
+  return CPU_COUNT(&result) > 0;
+}
+
+int printRtSystemCheck() {
+  char buffer[ECMC_THREAD_CFG_CPU_LIST_MAX_CHARS];
+  char path[ECMC_THREAD_CFG_CPU_LIST_MAX_CHARS + 64];
+  int  warnings = 0;
+  cpu_set_t rtActual;
+
+  CPU_ZERO(&rtActual);
+
+  printf("ecmc realtime system check:\n");
+
+  // Realtime thread
+  if (rtThreadValid) {
+    struct sched_param param = {};
+    int policy = 0;
+
+    pthread_getschedparam(rtThread, &policy, &param);
+    pthread_getaffinity_np(rtThread, sizeof(cpu_set_t), &rtActual);
+    cpuSetToString(&rtActual, buffer, sizeof(buffer));
+    printf("  rt thread scheduling:   %s, priority %d%s\n",
+           policyToString(policy),
+           param.sched_priority,
+           rtApplyError ? " (configured attributes failed)" : "");
+    printf("  rt thread cpus:         %s\n", buffer);
+
+    if (rtApplyError) {
+      warnings++;
+    }
+
+    if ((policy != SCHED_FIFO) && (policy != SCHED_RR) &&
+        (policy != SCHED_DEADLINE)) {
+      printf("  WARNING: rt thread not running with a realtime policy.\n");
+      warnings++;
+    }
+  } else {
+    printf("  rt thread:              not started\n");
+  }
+
+  if (!rtCpusSet) {
+    printf("  WARNING: rt thread not pinned (Cfg.SetRtThreadAffinity()).\n");
+    warnings++;
+  }
+
+  // Isolation
+  cpu_set_t isolated;
+  CPU_ZERO(&isolated);
+
+  if (!readLine("/sys/devices/system/cpu/isolated", buffer, sizeof(buffer))) {
+    printf("  isolated cpus:          %s\n", buffer[0] ? buffer : "none");
+
+    if (buffer[0]) {
+      parseCpuList(buffer, &isolated);
+    }
+  }
+
+  if (!readLine("/sys/devices/system/cpu/nohz_full", buffer, sizeof(buffer))) {
+    printf("  nohz_full cpus:         %s\n",
+           buffer[0] && strcmp(buffer, "(null)") ? buffer : "none");
+  }
+
+  if (rtCpusSet) {
+    cpu_set_t notIsolated;
+    CPU_XOR(&notIsolated, &rtCpus, &isolated);
+    CPU_AND(&notIsolated, &notIsolated, &rtCpus);
+
+    if (CPU_COUNT(&notIsolated)) {
+      cpuSetToString(&notIsolated, buffer, sizeof(buffer));
+      printf("  WARNING: rt cpus not isolated: %s\n", buffer);
+      warnings++;
+    }
+  }
+
+  // Interrupts that can be served on the rt cpus
+  if (rtCpusSet) {
+    DIR *dir = opendir("/proc/irq");
+
+    if (dir) {
+      struct dirent *entry;
+      int  irqCount = 0;
+      char irqList[128] = "";
+      size_t used = 0;
+
+      while ((entry = readdir(dir)) != NULL) {
+        if ((entry->d_name[0] < '0') || (entry->d_name[0] > '9')) {
+          continue;
+        }
+        snprintf(path, sizeof(path), "/proc/irq/%s/smp_affinity_list",
+                 entry->d_name);
+        cpu_set_t irqCpus;
+
+        if (readLine(path, buffer, sizeof(buffer)) ||
+            parseCpuList(buffer, &irqCpus)) {
+          continue;
+        }
+
+        if (cpuSetsIntersect(&irqCpus, &rtCpus)) {
+          irqCount++;
+
+          if (used < sizeof(irqList) - 8) {
+            used += snprintf(irqList + used, sizeof(irqList) - used,
+                             used ? ",%s" : "%s", entry->d_name);
+          }
+        }
+      }
+      closedir(dir);
+      printf("  irqs on rt cpus:        %d%s%s\n",
+             irqCount,
+             irqCount ? " " : "",
+             irqList);
+
+      if (irqCount) {
+        printf("  WARNING: move irqs from rt cpus (irqaffinity= or /proc/irq/*/smp_affinity_list).\n");
+        warnings++;
+      }
+    }
+
+    // Frequency scaling
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (!CPU_ISSET(cpu, &rtCpus)) {
+        continue;
+      }
+      snprintf(path, sizeof(path),
+               "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_governor", cpu);
+
+      if (!readLine(path, buffer, sizeof(buffer))) {
+        printf("  cpu%d governor:          %s\n", cpu, buffer);
+
+        if (strcmp(buffer, "performance")) {
+          printf("  WARNING: cpu%d not using \"performance\" governor.\n", cpu);
+          warnings++;
+        }
+      }
+    }
+  }
+
+  // Rt throttling
+  if (!readLine("/proc/sys/kernel/sched_rt_runtime_us", buffer,
+                sizeof(buffer))) {
+    printf("  sched_rt_runtime_us:    %s\n", buffer);
+  }
+
+  // Memory locking
+  printf("  mlockall:               %s\n",
+         memLocked < 0 ? "not done" : memLocked ? "OK" : "FAILED");
+
+  if (memLocked == 0) {
+    printf("  WARNING: memory not locked, page faults can occur in rt thread.\n");
+    warnings++;
+  }
+
+  FILE *status = fopen("/proc/self/status", "r");
+
+  if (status) {
+    while (fgets(buffer, sizeof(buffer), status)) {
+      if (!strncmp(buffer, "VmLck:", 6)) {
+        printf("  locked memory:          %s", buffer + 6 + strspn(buffer + 6, " \t"));
+        break;
+      }
+    }
+    fclose(status);
+  }
+
+  printf("  warnings:               %d\n", warnings);
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcThreadCfg.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+/**
+\file
+    @brief Thread attributes (cpu affinity, scheduling) and rt system check
+*/
+
+#ifndef ECMC_THREAD_CFG_H_
+#define ECMC_THREAD_CFG_H_
+
+#define ECMC_MAX_HELPER_THREADS 32
+#define ECMC_THREAD_CFG_CPU_LIST_MAX_CHARS 256
+
+# ifdef __cplusplus
+extern "C" {
+# endif  // ifdef __cplusplus
+
+/** \brief Set cpu affinity of the realtime thread.\n
+ *
+ * Preferably use isolated cores (kernel parameter "isolcpus" or cpusets).
+ * Applied when the realtime thread starts.\n
+ * Only allowed in configuration mode.\n
+ *
+ * \param[in] cpuList List of cpus, like "3", "2,3" or "2-3".\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Run realtime thread on core 3.\n
+ *  "Cfg.SetRtThreadAffinity(3)" //Command string to ecmcCmdParser.c\n
+ */
+int setRtThreadAffinity(const char *cpuList);
+
+/** \brief Set scheduling policy of the realtime thread.\n
+ *
+ * Supported policies: "FIFO", "RR", "OTHER" and "DEADLINE". If not set the
+ * thread is created by EPICS with the default ecmc priority.\n
+ * For "FIFO" and "RR" without Cfg.SetRtThreadPriority() the current
+ * priority of the thread is kept (at least the minimum of the policy).\n
+ * For "DEADLINE" the period and deadline are set to the ecmc sample
+ * period and the runtime to Cfg.SetRtThreadDeadlineRuntimeUs(), default
+ * half the sample period. Note that the kernel only accepts "DEADLINE"
+ * for threads that may run on all cpus of the root domain, so it can
+ * normally not be combined with Cfg.SetRtThreadAffinity().\n
+ * Only allowed in configuration mode.\n
+ *
+ * \param[in] policy Scheduling policy.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Use SCHED_FIFO.\n
+ *  "Cfg.SetRtThreadSchedPolicy(FIFO)" //Command string to ecmcCmdParser.c\n
+ */
+int setRtThreadSchedPolicy(const char *policy);
+
+/** \brief Set priority of the realtime thread.\n
+ *
+ * OS priority (1..99 for "FIFO" and "RR"). If no policy is set, "FIFO" is
+ * used.\n
+ * Only allowed in configuration mode.\n
+ *
+ * \param[in] priority Priority.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Set priority 90.\n
+ *  "Cfg.SetRtThreadPriority(90)" //Command string to ecmcCmdParser.c\n
+ */
+int setRtThreadPriority(int priority);
+
+/** \brief Set runtime budget for "DEADLINE" scheduling of the realtime
+ *  thread.\n
+ *
+ * Only allowed in configuration mode.\n
+ *
+ * \param[in] runtimeUs Runtime per period [us].\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Allow 300us execution per period.\n
+ *  "Cfg.SetRtThreadDeadlineRuntimeUs(300)" //Command string to ecmcCmdParser.c\n
+ */
+int setRtThreadDeadlineRuntimeUs(int runtimeUs);
+
+/** \brief Set cpu affinity of ecmc helper threads.\n
+ *
+ * Helper threads are the non realtime threads created by ecmc (shutdown
+ * monitor, data storage stream writers). Normally pinned to cores not used
+ * by the realtime thread. Applied directly to running helper threads.\n
+ *
+ * \param[in] cpuList List of cpus, like "0", "0,1" or "0-2".\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Run helper threads on core 0 and 1.\n
+ *  "Cfg.SetHelperThreadAffinity(0-1)" //Command string to ecmcCmdParser.c\n
+ */
+int setHelperThreadAffinity(const char *cpuList);
+
+/** \brief Set priority of ecmc helper threads.\n
+ *
+ * 0 keeps the EPICS priority, otherwise "FIFO" with this OS priority is
+ * used. Applied directly to running helper threads.\n
+ *
+ * \param[in] priority Priority.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Set helper thread priority 20.\n
+ *  "Cfg.SetHelperThreadPriority(20)" //Command string to ecmcCmdParser.c\n
+ */
+int setHelperThreadPriority(int priority);
+
+/** \brief Print realtime system check.\n
+ *
+ * Reports realtime thread scheduling and affinity, core isolation
+ * (isolcpus, nohz_full), interrupts that can be served on the realtime
+ * cores, cpu frequency governor, rt throttling and memory locking.
+ * Automatically printed when entering runtime mode.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print check.\n
+ *  "Cfg.PrintRtSystemCheck()" //Command string to ecmcCmdParser.c\n
+ */
+int printRtSystemCheck();
+
+/** \brief Apply configured attributes to the calling (realtime) thread.\n
+ *
+ * \param[in] periodNs Sample period (used for "DEADLINE").\n
+ */
+int  applyRtThreadAttributes(double periodNs);
+
+/** \brief Register the calling thread as helper thread and apply the helper
+ *  attributes. Call unregisterHelperThread() before the thread exits.\n
+ */
+void registerHelperThread(const char *name);
+void unregisterHelperThread();
+
+/** \brief Result of mlockall() (for system check).\n
+ */
+void setMemLockStatus(int locked);
+
+# ifdef __cplusplus
+}
+# endif  // ifdef __cplusplus
+
+#endif  /* ECMC_THREAD_CFG_H_ */
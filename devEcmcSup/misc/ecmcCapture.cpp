@@ -0,0 +1,621 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcCapture.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcCapture.h"
+#include "ecmcErrorsList.h"
+#include "ecmcOctetIF.h"
+#include "ecmcThreadCfg.h"
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <epicsThread.h>
+#include <epicsAtomic.h>
+
+ecmcCapture::ecmcCapture(ecmcAsynPortDriver *asynPortDriver,
+                         int                 index,
+                         int                 samples,
+                         int                 preTriggerSamples,
+                         int                 decimation) {
+  asynPortDriver_       = asynPortDriver;
+  index_                = index;
+  errorCode_            = 0;
+  size_                 = samples;
+  preTrigger_           = preTriggerSamples;
+  decimation_           = decimation > 1 ? decimation : 1;
+  mode_                 = ECMC_CAPTURE_MODE_SINGLE;
+  channelCount_         = 0;
+  ring_                 = NULL;
+  ringChannels_         = 0;
+  triggerChannel_       = 0;
+  triggerType_          = ECMC_CAPTURE_TRIGGER_NONE;
+  triggerLevel_         = 0;
+  triggerValueOld_      = 0;
+  triggerValueOldValid_ = false;
+  triggerRequest_       = 0;
+  armRequest_           = 0;
+  decimationCounter_    = 0;
+  writeSlot_            = 0;
+  recorded_             = 0;
+  postTriggerLeft_      = 0;
+  state_                = ECMC_CAPTURE_STATE_IDLE;
+  stop_                 = 0;
+  threadStarted_        = false;
+  exitEvent_            = NULL;
+  asynState_            = 0;
+  publishedCount_       = 0;
+  stateAsynDataItem_    = NULL;
+  countAsynDataItem_    = NULL;
+  memset(channelNames_, 0, sizeof(channelNames_));
+  memset(channelInfo_, 0, sizeof(channelInfo_));
+  memset(channelAsyn_, 0, sizeof(channelAsyn_));
+  memset(channelData_, 0, sizeof(channelData_));
+  memset(&copy8_, 0, sizeof(copy8_));
+  memset(&copy4_, 0, sizeof(copy4_));
+  memset(&copy2_, 0, sizeof(copy2_));
+  memset(&copy1_, 0, sizeof(copy1_));
+
+  if ((size_ <= 0) || (size_ > ECMC_CAPTURE_MAX_SAMPLES) ||
+      (preTrigger_ < 0) || (preTrigger_ >= size_)) {
+    LOGERR("%s/%s:%d: ERROR: Capture %d. Invalid samples %d or pre trigger samples %d (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           samples,
+           preTriggerSamples,
+           ERROR_CAPTURE_INVALID_CFG);
+    errorCode_ = ERROR_CAPTURE_INVALID_CFG;
+    return;
+  }
+
+  errorCode_ = initAsyn();
+
+  if (errorCode_) {
+    return;
+  }
+
+  exitEvent_ = epicsEventCreate(epicsEventEmpty);
+
+  if (!exitEvent_ || (epicsThreadCreate(ECMC_CAPTURE_THREAD_NAME,
+                                        epicsThreadPriorityLow,
+                                        epicsThreadGetStackSize(
+                                          epicsThreadStackMedium),
+                                        publisherThread,
+                                        this) == NULL)) {
+    LOGERR("%s/%s:%d: ERROR: Capture %d. Failed create publisher thread (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           ERROR_CAPTURE_THREAD_FAIL);
+    errorCode_ = ERROR_CAPTURE_THREAD_FAIL;
+    return;
+  }
+  threadStarted_ = true;
+}
+
+ecmcCapture::~ecmcCapture() {
+  if (threadStarted_) {
+    stop_ = 1;
+    epicsEventWait(exitEvent_);
+  }
+
+  if (exitEvent_) {
+    epicsEventDestroy(exitEvent_);
+  }
+
+  for (int i = 0; i < channelCount_; i++) {
+    free(channelNames_[i]);
+    delete[] channelData_[i];
+  }
+  delete[] ring_;
+}
+
+int ecmcCapture::getErrorCode() {
+  return errorCode_;
+}
+
+int ecmcCapture::addChannel(const char *dataItemName) {
+  if (channelCount_ >= ECMC_CAPTURE_MAX_CHANNELS) {
+    LOGERR("%s/%s:%d: ERROR: Capture %d. Max %d channels (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           ECMC_CAPTURE_MAX_CHANNELS,
+           ERROR_CAPTURE_CHANNEL_COUNT_OUT_OF_RANGE);
+    return ERROR_CAPTURE_CHANNEL_COUNT_OUT_OF_RANGE;
+  }
+
+  double *data = NULL;
+
+  try {
+    data = new double[size_];
+  } catch (std::bad_alloc& ex) {
+    LOGERR("%s/%s:%d: ERROR: Capture %d. Mem alloc error (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           ERROR_CAPTURE_ALLOC_FAIL);
+    return ERROR_CAPTURE_ALLOC_FAIL;
+  }
+  memset(data, 0, sizeof(double) * size_);
+
+  ecmcAsynDataItem *param = NULL;
+
+  if (asynPortDriver_) {
+    char name[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+    // "capture<index>.ch<channel>"
+    int chars = snprintf(name,
+                         sizeof(name),
+                         ECMC_CAPTURE_STR "%d." ECMC_CAPTURE_CHANNEL_STR "%d",
+                         index_,
+                         channelCount_);
+
+    if (chars >= (int)sizeof(name) - 1) {
+      delete[] data;
+      return ERROR_CAPTURE_ASYN_PARAM_FAIL;
+    }
+
+    param = asynPortDriver_->addNewAvailParam(name,
+                                              asynParamFloat64Array,
+                                              (uint8_t *)data,
+                                              sizeof(double) * size_,
+                                              ECMC_EC_F64,
+                                              0);
+
+    // Published by the array publisher thread (not from rt)
+    if (!param || param->setArrayBuffered(1)) {
+      LOGERR("%s/%s:%d: ERROR: Capture %d. Add parameter %s failed (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             index_,
+             name,
+             ERROR_CAPTURE_ASYN_PARAM_FAIL);
+      delete[] data;
+      return ERROR_CAPTURE_ASYN_PARAM_FAIL;
+    }
+    param->setAllowWriteToEcmc(false);
+  }
+
+  channelNames_[channelCount_] = strdup(dataItemName);
+  channelData_[channelCount_]  = data;
+  channelAsyn_[channelCount_]  = param;
+  channelCount_++;
+  return 0;
+}
+
+int ecmcCapture::validate() {
+  if (channelCount_ == 0) {
+    LOGERR("%s/%s:%d: ERROR: Capture %d. No channels (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           ERROR_CAPTURE_INVALID_CFG);
+    return ERROR_CAPTURE_INVALID_CFG;
+  }
+
+  if (triggerChannel_ >= channelCount_) {
+    LOGERR("%s/%s:%d: ERROR: Capture %d. Trigger channel %d not added (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           triggerChannel_,
+           ERROR_CAPTURE_TRIGGER_INVALID);
+    return ERROR_CAPTURE_TRIGGER_INVALID;
+  }
+
+  memset(&copy8_, 0, sizeof(copy8_));
+  memset(&copy4_, 0, sizeof(copy4_));
+  memset(&copy2_, 0, sizeof(copy2_));
+  memset(&copy1_, 0, sizeof(copy1_));
+
+  for (int i = 0; i < channelCount_; i++) {
+    ecmcDataItem *item = asynPortDriver_ ?
+                         asynPortDriver_->findAvailDataItem(channelNames_[i]) :
+                         NULL;
+
+    if (!item) {
+      LOGERR("%s/%s:%d: ERROR: Capture %d. Data item %s not found (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             index_,
+             channelNames_[i],
+             ERROR_CAPTURE_CHANNEL_NOT_FOUND);
+      return ERROR_CAPTURE_CHANNEL_NOT_FOUND;
+    }
+    channelInfo_[i] = item->getDataItemInfo();
+
+    ecmcCaptureCopyList *list = NULL;
+
+    switch (channelInfo_[i]->dataElementSize) {
+    case 8:
+      list = &copy8_;
+      break;
+
+    case 4:
+      list = &copy4_;
+      break;
+
+    case 2:
+      list = &copy2_;
+      break;
+
+    case 1:
+      list = &copy1_;
+      break;
+    }
+
+    if (!list || !channelInfo_[i]->data) {
+      LOGERR("%s/%s:%d: ERROR: Capture %d. Data item %s type not supported (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             index_,
+             channelNames_[i],
+             ERROR_CAPTURE_CHANNEL_TYPE_INVALID);
+      return ERROR_CAPTURE_CHANNEL_TYPE_INVALID;
+    }
+
+    // First element of arrays
+    list->src[list->count]  = channelInfo_[i]->data;
+    list->slot[list->count] = i;
+    list->count++;
+  }
+
+  if (ring_ && (ringChannels_ == channelCount_)) {
+    return 0;
+  }
+
+  uint64_t *ring = NULL;
+
+  try {
+    ring = new uint64_t[(size_t)size_ * channelCount_];
+  } catch (std::bad_alloc& ex) {
+    LOGERR("%s/%s:%d: ERROR: Capture %d. Mem alloc error (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           ERROR_CAPTURE_ALLOC_FAIL);
+    return ERROR_CAPTURE_ALLOC_FAIL;
+  }
+  memset(ring, 0, sizeof(uint64_t) * size_ * channelCount_);
+  delete[] ring_;
+  ring_         = ring;
+  ringChannels_ = channelCount_;
+  return 0;
+}
+
+int ecmcCapture::setTrigger(int channel, int type, double level) {
+  if ((channel < 0) || (channel >= ECMC_CAPTURE_MAX_CHANNELS) ||
+      (type < ECMC_CAPTURE_TRIGGER_NONE) ||
+      (type > ECMC_CAPTURE_TRIGGER_BELOW)) {
+    return ERROR_CAPTURE_TRIGGER_INVALID;
+  }
+
+  // Rt channel index must be valid when trigger is changed in runtime
+  if (ring_ && (channel >= channelCount_)) {
+    return ERROR_CAPTURE_TRIGGER_INVALID;
+  }
+  triggerType_          = ECMC_CAPTURE_TRIGGER_NONE;
+  triggerLevel_         = level;
+  triggerChannel_       = channel;
+  triggerValueOldValid_ = false;
+  triggerType_          = type;
+  return 0;
+}
+
+int ecmcCapture::setMode(int mode) {
+  if ((mode != ECMC_CAPTURE_MODE_SINGLE) && (mode != ECMC_CAPTURE_MODE_AUTO)) {
+    return ERROR_CAPTURE_INVALID_CFG;
+  }
+  mode_ = mode;
+  return 0;
+}
+
+void ecmcCapture::arm() {
+  epicsAtomicSetIntT(&armRequest_, 1);
+}
+
+void ecmcCapture::trigger() {
+  epicsAtomicSetIntT(&triggerRequest_, 1);
+}
+
+int ecmcCapture::getState() {
+  return epicsAtomicGetIntT(&state_);
+}
+
+double ecmcCapture::toDouble(uint64_t raw, int channel) {
+  switch (channelInfo_[channel]->dataType) {
+  case ECMC_EC_B1:
+  case ECMC_EC_B2:
+  case ECMC_EC_B3:
+  case ECMC_EC_B4:
+    return (double)(raw & ((1 << channelInfo_[channel]->dataType) - 1));
+
+  case ECMC_EC_S8:
+    return (double)(int8_t)raw;
+
+  case ECMC_EC_S16:
+    return (double)(int16_t)raw;
+
+  case ECMC_EC_S32:
+    return (double)(int32_t)raw;
+
+  case ECMC_EC_S64:
+    return (double)(int64_t)raw;
+
+  case ECMC_EC_F32: {
+    uint32_t bits = (uint32_t)raw;
+    float    value;
+    memcpy(&value, &bits, sizeof(value));
+    return (double)value;
+  }
+
+  case ECMC_EC_F64: {
+    double value;
+    memcpy(&value, &raw, sizeof(value));
+    return value;
+  }
+
+  default:  // Unsigned
+    return (double)raw;
+  }
+}
+
+void ecmcCapture::execute() {
+  if (!ring_) {
+    return;
+  }
+
+  // Arm is deferred while frozen (ring owned by the publisher)
+  if ((epicsAtomicGetIntT(&state_) != ECMC_CAPTURE_STATE_FROZEN) &&
+      epicsAtomicCmpAndSwapIntT(&armRequest_, 1, 0)) {
+    epicsAtomicSetIntT(&triggerRequest_, 0);
+    decimationCounter_    = 0;
+    writeSlot_            = 0;
+    recorded_             = 0;
+    triggerValueOldValid_ = false;
+    epicsAtomicSetIntT(&state_, ECMC_CAPTURE_STATE_ARMED);
+  }
+
+  const int state = epicsAtomicGetIntT(&state_);
+
+  if ((state == ECMC_CAPTURE_STATE_ARMED) ||
+      (state == ECMC_CAPTURE_STATE_TRIGGERED)) {
+    if (++decimationCounter_ >= decimation_) {
+      decimationCounter_ = 0;
+
+      // One load and one store per channel (raw value)
+      uint64_t *record = &ring_[(size_t)writeSlot_ * ringChannels_];
+
+      for (int i = 0; i < copy8_.count; i++) {
+        uint64_t value;
+        memcpy(&value, copy8_.src[i], sizeof(value));
+        record[copy8_.slot[i]] = value;
+      }
+
+      for (int i = 0; i < copy4_.count; i++) {
+        uint32_t value;
+        memcpy(&value, copy4_.src[i], sizeof(value));
+        record[copy4_.slot[i]] = value;
+      }
+
+      for (int i = 0; i < copy2_.count; i++) {
+        uint16_t value;
+        memcpy(&value, copy2_.src[i], sizeof(value));
+        record[copy2_.slot[i]] = value;
+      }
+
+      for (int i = 0; i < copy1_.count; i++) {
+        record[copy1_.slot[i]] = *copy1_.src[i];
+      }
+
+      writeSlot_ = writeSlot_ + 1 < size_ ? writeSlot_ + 1 : 0;
+
+      if (recorded_ < size_) {
+        recorded_++;
+      }
+
+      if (state == ECMC_CAPTURE_STATE_ARMED) {
+        bool   triggered = false;
+        double value     = toDouble(record[triggerChannel_], triggerChannel_);
+
+        switch (triggerType_) {
+        case ECMC_CAPTURE_TRIGGER_RISING:
+          triggered = triggerValueOldValid_ && triggerValueOld_ < triggerLevel_ &&
+                      value >= triggerLevel_;
+          break;
+
+        case ECMC_CAPTURE_TRIGGER_FALLING:
+          triggered = triggerValueOldValid_ && triggerValueOld_ > triggerLevel_ &&
+                      value <= triggerLevel_;
+          break;
+
+        case ECMC_CAPTURE_TRIGGER_EDGE:
+          triggered = triggerValueOldValid_ &&
+                      ((triggerValueOld_ < triggerLevel_ && value >= triggerLevel_) ||
+                       (triggerValueOld_ > triggerLevel_ && value <= triggerLevel_));
+          break;
+
+        case ECMC_CAPTURE_TRIGGER_ABOVE:
+          triggered = value >= triggerLevel_;
+          break;
+
+        case ECMC_CAPTURE_TRIGGER_BELOW:
+          triggered = value <= triggerLevel_;
+          break;
+        }
+        triggerValueOld_      = value;
+        triggerValueOldValid_ = true;
+
+        // Pre trigger samples (before this sample) must be recorded
+        if ((recorded_ > preTrigger_) &&
+            (triggered ||
+             epicsAtomicCmpAndSwapIntT(&triggerRequest_, 1, 0))) {
+          postTriggerLeft_ = size_ - preTrigger_ - 1;
+          epicsAtomicSetIntT(&state_, ECMC_CAPTURE_STATE_TRIGGERED);
+        }
+      } else {
+        postTriggerLeft_--;
+      }
+
+      if ((epicsAtomicGetIntT(&state_) == ECMC_CAPTURE_STATE_TRIGGERED) &&
+          (postTriggerLeft_ <= 0)) {
+        // Ring visible to publisher before state
+        epicsAtomicWriteMemoryBarrier();
+        epicsAtomicSetIntT(&state_, ECMC_CAPTURE_STATE_FROZEN);
+      }
+    }
+  }
+
+  asynState_ = epicsAtomicGetIntT(&state_);
+
+  if (stateAsynDataItem_) {
+    stateAsynDataItem_->refreshParamRT(0);
+  }
+
+  if (countAsynDataItem_) {
+    countAsynDataItem_->refreshParamRT(0);
+  }
+}
+
+void ecmcCapture::publisherThread(void *obj) {
+  registerHelperThread(ECMC_CAPTURE_THREAD_NAME);
+  ((ecmcCapture *)obj)->publisherLoop();
+}
+
+void ecmcCapture::publisherLoop() {
+  while (!stop_) {
+    if (epicsAtomicGetIntT(&state_) == ECMC_CAPTURE_STATE_FROZEN) {
+      epicsAtomicReadMemoryBarrier();
+      publish();
+      epicsAtomicCmpAndSwapIntT(&state_,
+                                ECMC_CAPTURE_STATE_FROZEN,
+                                ECMC_CAPTURE_STATE_DONE);
+
+      if (mode_ == ECMC_CAPTURE_MODE_AUTO) {
+        arm();
+      }
+    }
+    epicsThreadSleep(ECMC_CAPTURE_PUBLISH_PERIOD_S);
+  }
+  unregisterHelperThread();
+  epicsEventSignal(exitEvent_);
+}
+
+/* Ring is full and frozen, oldest record at writeSlot_ */
+void ecmcCapture::publish() {
+  const size_t bytes = sizeof(double) * size_;
+
+  for (int c = 0; c < ringChannels_; c++) {
+    if (!channelAsyn_[c]) {
+      continue;
+    }
+
+    double *out = (double *)channelAsyn_[c]->getArrayWriteBuffer();
+
+    if (!out) {
+      continue;
+    }
+
+    int slot = writeSlot_;
+
+    for (int k = 0; k < size_; k++) {
+      out[k] = toDouble(ring_[(size_t)slot * ringChannels_ + c], c);
+      slot   = slot + 1 < size_ ? slot + 1 : 0;
+    }
+    channelAsyn_[c]->refreshParam(1, (uint8_t *)out, bytes);
+  }
+  publishedCount_++;
+}
+
+void ecmcCapture::print() {
+  const char *stateStr[] = { "idle", "armed", "triggered", "frozen", "done" };
+
+  printf("Capture %d:\n", index_);
+  printf("  samples %d, pre trigger %d, decimation %d, mode %s\n",
+         size_,
+         preTrigger_,
+         decimation_,
+         mode_ == ECMC_CAPTURE_MODE_AUTO ? "auto" : "single");
+  printf("  trigger channel %d, type %d, level %lg\n",
+         triggerChannel_,
+         triggerType_,
+         triggerLevel_);
+  printf("  state %s, published %d\n",
+         stateStr[epicsAtomicGetIntT(&state_)],
+         publishedCount_);
+  printf("  rt copies (8/4/2/1 bytes): %d/%d/%d/%d\n",
+         copy8_.count,
+         copy4_.count,
+         copy2_.count,
+         copy1_.count);
+
+  for (int i = 0; i < channelCount_; i++) {
+    printf("  " ECMC_CAPTURE_CHANNEL_STR "%d: %s\n", i, channelNames_[i]);
+  }
+}
+
+int ecmcCapture::initAsyn() {
+  if (!asynPortDriver_) {
+    return 0;
+  }
+
+  char name[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  // "capture<index>.state"
+  snprintf(name,
+           sizeof(name),
+           ECMC_CAPTURE_STR "%d." ECMC_CAPTURE_STATE_STR,
+           index_);
+  stateAsynDataItem_ = asynPortDriver_->addNewAvailParam(name,
+                                                         asynParamInt32,
+                                                         (uint8_t *)&asynState_,
+                                                         sizeof(asynState_),
+                                                         ECMC_EC_S32,
+                                                         0);
+
+  // "capture<index>.count"
+  snprintf(name,
+           sizeof(name),
+           ECMC_CAPTURE_STR "%d." ECMC_CAPTURE_COUNT_STR,
+           index_);
+  countAsynDataItem_ = asynPortDriver_->addNewAvailParam(name,
+                                                         asynParamInt32,
+                                                         (uint8_t *)&publishedCount_,
+                                                         sizeof(publishedCount_),
+                                                         ECMC_EC_S32,
+                                                         0);
+
+  if (!stateAsynDataItem_ || !countAsynDataItem_) {
+    LOGERR("%s/%s:%d: ERROR: Capture %d. Add parameters failed (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           ERROR_CAPTURE_ASYN_PARAM_FAIL);
+    return ERROR_CAPTURE_ASYN_PARAM_FAIL;
+  }
+  stateAsynDataItem_->setAllowWriteToEcmc(false);
+  stateAsynDataItem_->refreshParam(1);
+  countAsynDataItem_->setAllowWriteToEcmc(false);
+  countAsynDataItem_->refreshParam(1);
+  return 0;
+}
@@ -0,0 +1,173 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcCapture.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Triggered capture of data items (oscilloscope). N channels are bound to
+* data items by name and recorded (every decimation:th cycle) into one
+* preallocated interleaved ring (one uint64 slot per channel and sample).
+* The channels are grouped by element size (8, 4, 2, 1 bytes) so that the
+* rt cost per channel is one load and one store of the raw value, the
+* conversion to double is made when published.
+*
+* Trigger: edge or level of one of the channels compared to a level, or a
+* request from plc code (cap_trigg(), any expression) or a command. The
+* trigger is accepted when the pre trigger samples are recorded. Then
+* samples - pre trigger samples are recorded and the ring is frozen.
+* A low priority thread converts the frozen ring into one waveform per
+* channel, "capture<index>.ch<channel>" (oldest first, trigger sample at
+* index pre trigger samples), and hands them over to the array publisher
+* (array buffered parameters). In auto mode the capture is then rearmed.
+*
+\*************************************************************************/
+
+#ifndef ECMCCAPTURE_H_
+#define ECMCCAPTURE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "epicsEvent.h"
+#include "ecmcAsynPortDriver.h"
+#include "ecmcDataItem.h"
+
+#define ERROR_CAPTURE_ALLOC_FAIL 0x20220
+#define ERROR_CAPTURE_INVALID_CFG 0x20221
+#define ERROR_CAPTURE_CHANNEL_NOT_FOUND 0x20222
+#define ERROR_CAPTURE_CHANNEL_TYPE_INVALID 0x20223
+#define ERROR_CAPTURE_CHANNEL_COUNT_OUT_OF_RANGE 0x20224
+#define ERROR_CAPTURE_ASYN_PARAM_FAIL 0x20225
+#define ERROR_CAPTURE_THREAD_FAIL 0x20226
+#define ERROR_CAPTURE_NULL 0x20227
+#define ERROR_CAPTURE_INDEX_OUT_OF_RANGE 0x20228
+#define ERROR_CAPTURE_TRIGGER_INVALID 0x20229
+
+#define ECMC_CAPTURE_MAX_CHANNELS 32
+#define ECMC_CAPTURE_MAX_SAMPLES (1 << 20)
+#define ECMC_CAPTURE_PUBLISH_PERIOD_S 0.01
+#define ECMC_CAPTURE_THREAD_NAME "ecmcCapture"
+
+#define ECMC_CAPTURE_STR "capture"
+#define ECMC_CAPTURE_CHANNEL_STR "ch"
+#define ECMC_CAPTURE_STATE_STR "state"
+#define ECMC_CAPTURE_COUNT_STR "count"
+
+enum ecmcCaptureTrigger {
+  ECMC_CAPTURE_TRIGGER_NONE    = 0,  // Only cap_trigg() or command
+  ECMC_CAPTURE_TRIGGER_RISING  = 1,
+  ECMC_CAPTURE_TRIGGER_FALLING = 2,
+  ECMC_CAPTURE_TRIGGER_EDGE    = 3,  // Rising or falling
+  ECMC_CAPTURE_TRIGGER_ABOVE   = 4,  // Level, value >= level
+  ECMC_CAPTURE_TRIGGER_BELOW   = 5,  // Level, value <= level
+};
+
+enum ecmcCaptureState {
+  ECMC_CAPTURE_STATE_IDLE      = 0,
+  ECMC_CAPTURE_STATE_ARMED     = 1,  // Recording, waiting for trigger
+  ECMC_CAPTURE_STATE_TRIGGERED = 2,  // Recording post trigger samples
+  ECMC_CAPTURE_STATE_FROZEN    = 3,  // Waiting for publisher
+  ECMC_CAPTURE_STATE_DONE      = 4,  // Published
+};
+
+enum ecmcCaptureMode {
+  ECMC_CAPTURE_MODE_SINGLE = 0,
+  ECMC_CAPTURE_MODE_AUTO   = 1,  // Rearm after publish
+};
+
+// Rt copy list of one element size
+struct ecmcCaptureCopyList {
+  const uint8_t *src[ECMC_CAPTURE_MAX_CHANNELS];
+  int            slot[ECMC_CAPTURE_MAX_CHANNELS];
+  int            count;
+};
+
+class ecmcCapture {
+public:
+  ecmcCapture(ecmcAsynPortDriver *asynPortDriver,
+              int                 index,
+              int                 samples,
+              int                 preTriggerSamples,
+              int                 decimation);
+  ~ecmcCapture();
+
+  // Returns 0 if created (buffers allocated and publisher thread running)
+  int  getErrorCode();
+
+  // Config. Data items are resolved in validate() (plc variables exist)
+  int  addChannel(const char *dataItemName);
+  int  validate();
+
+  int  setTrigger(int    channel,
+                  int    type,
+                  double level);
+  int  setMode(int mode);
+  void arm();      // Deferred until published if frozen
+  void trigger();  // Accepted when armed and pre trigger samples recorded
+  int  getState();
+
+  // Rt
+  void execute();
+  void print();
+
+private:
+  static void publisherThread(void *obj);
+  void        publisherLoop();
+  void        publish();
+  double      toDouble(uint64_t raw,
+                       int      channel);
+  int         initAsyn();
+
+  ecmcAsynPortDriver *asynPortDriver_;
+  int index_;
+  int errorCode_;
+  int size_;               // Samples per capture
+  int preTrigger_;
+  int decimation_;
+  int mode_;
+
+  // Channels
+  int channelCount_;
+  char *channelNames_[ECMC_CAPTURE_MAX_CHANNELS];
+  ecmcDataItemInfo *channelInfo_[ECMC_CAPTURE_MAX_CHANNELS];
+  ecmcAsynDataItem *channelAsyn_[ECMC_CAPTURE_MAX_CHANNELS];
+  double *channelData_[ECMC_CAPTURE_MAX_CHANNELS];  // Initial param data
+  ecmcCaptureCopyList copy8_;
+  ecmcCaptureCopyList copy4_;
+  ecmcCaptureCopyList copy2_;
+  ecmcCaptureCopyList copy1_;
+
+  // Ring, size_ records of channelCount_ slots
+  uint64_t *ring_;
+  int ringChannels_;
+
+  // Trigger
+  int triggerChannel_;
+  int triggerType_;
+  double triggerLevel_;
+  double triggerValueOld_;
+  bool triggerValueOldValid_;
+  int triggerRequest_;      // epicsAtomic
+  int armRequest_;          // epicsAtomic, deferred while frozen
+
+  // Rt
+  int decimationCounter_;
+  int writeSlot_;
+  int recorded_;
+  int postTriggerLeft_;
+  int state_;              // epicsAtomic (rt <-> publisher)
+
+  // Publisher
+  volatile int stop_;
+  bool threadStarted_;
+  epicsEventId exitEvent_;
+  int32_t asynState_;
+  int32_t publishedCount_;
+  ecmcAsynDataItem *stateAsynDataItem_;
+  ecmcAsynDataItem *countAsynDataItem_;
+};
+
+#endif  /* ECMCCAPTURE_H_ */
@@ -34,6 +34,7 @@ ecmcDataStorage::ecmcDataStorage(ecmcAsynPortDriver *asynPortDriver,
 }
 
 ecmcDataStorage::~ecmcDataStorage() {
+  delete stream_;
   delete buffer_;
 }
 
@@ -102,6 +103,7 @@ void ecmcDataStorage::initVars() {
   indexAsynDataItem_  = NULL;
   sizeAsynDataItem_   = NULL;
   statusWord_         = 0;
+  stream_             = NULL;
 }
 
 int ecmcDataStorage::clearBuffer() {
@@ -386,6 +388,10 @@ int ecmcDataStorage::appendData(double *data, int size, bool refreshAsyn) {
     return errorCode;
   }
 
+  if (stream_) {
+    stream_->push(data, size);
+  }
+
   if (refreshAsyn) {
     errorCode = updateAsyn(0);
   }
@@ -597,9 +603,67 @@ int ecmcDataStorage::updateAsyn(bool force) {
   statusAsynDataItem_->refreshParamRT(force);
   indexAsynDataItem_->refreshParamRT(force);
   sizeAsynDataItem_->refreshParamRT(force);
+
+  if (stream_) {
+    stream_->updateAsyn(force);
+  }
   return 0;
 }
 
+int ecmcDataStorage::setStream(const char *fileName,
+                               int         blockSize,
+                               int         blockCount,
+                               double      sampleRateHz) {
+  LOGINFO9("%s/%s:%d: dataStorage[%d].stream=%s,%d,%d;\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index_,
+           fileName,
+           blockSize,
+           blockCount);
+
+  // Only one stream per data storage (asyn params are registered once)
+  if (stream_) {
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_DATA_STORAGE_STREAM_INVALID_CFG);
+  }
+
+  stream_ = new ecmcDataStorageStream(asynPortDriver_,
+                                      index_,
+                                      fileName,
+                                      blockSize,
+                                      blockCount,
+                                      sampleRateHz);
+
+  int errorCode = stream_->getErrorCode();
+
+  if (errorCode) {
+    delete stream_;
+    stream_ = NULL;
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+
+  return 0;
+}
+
+int ecmcDataStorage::setStreamEnable(bool enable) {
+  if (!stream_) {
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_DATA_STORAGE_STREAM_NULL);
+  }
+  stream_->setEnable(enable);
+  return 0;
+}
+
+ecmcDataStorageStream * ecmcDataStorage::getStream() {
+  return stream_;
+}
+
 double ecmcDataStorage::getAvg() {
   int elements = dataCountInBuffer_;
 
@@ -18,6 +18,7 @@
 #include "ecmcError.h"
 #include "ecmcDefinitions.h"
 #include "ecmcAsynPortDriver.h"
+#include "ecmcDataStorageStream.h"
 
 // Data storage
 #define ERROR_DATA_STORAGE_FULL 0x20200
@@ -79,6 +80,14 @@ public:
   double getMin();
   double getMax();
 
+  // Stream all appended data to file (see ecmcDataStorageStream)
+  int    setStream(const char *fileName,
+                   int         blockSize,
+                   int         blockCount,
+                   double      sampleRateHz);
+  int    setStreamEnable(bool enable);
+  ecmcDataStorageStream* getStream();
+
 private:
   int    appendDataFifo(double *data,
                         int     size);
@@ -101,6 +110,7 @@ private:
   ecmcAsynDataItem *sizeAsynDataItem_;
   int isFull_;
   uint32_t statusWord_;
+  ecmcDataStorageStream *stream_;
 };
 
 #endif  /* ECMCDATASTORAGE_H_ */
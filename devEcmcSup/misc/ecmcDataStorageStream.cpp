@@ -0,0 +1,496 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcDataStorageStream.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcDataStorageStream.h"
+#include "ecmcDataStorage.h"
+#include "ecmcErrorsList.h"
+#include "ecmcOctetIF.h"
+#include "ecmcThreadCfg.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <epicsThread.h>
+#include <epicsAtomic.h>
+
+static int64_t streamTimeNs(clockid_t clock) {
+  struct timespec ts;
+
+  clock_gettime(clock, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + (int64_t)ts.tv_nsec;
+}
+
+ecmcDataStorageStream::ecmcDataStorageStream(
+  ecmcAsynPortDriver *asynPortDriver,
+  int                 dataStorageIndex,
+  const char         *fileName,
+  int                 blockSize,
+  int                 blockCount,
+  double              sampleRateHz) {
+  asynPortDriver_            = asynPortDriver;
+  dataStorageIndex_          = dataStorageIndex;
+  fileName_                  = strdup(fileName);
+  file_                      = NULL;
+  errorCode_                 = 0;
+  blockSize_                 = 0;
+  blockCount_                = 0;
+  sampleRateHz_              = sampleRateHz;
+  enable_                    = 1;
+  blockData_                 = NULL;
+  blockHeaders_              = NULL;
+  fillCount_                 = 0;
+  sequence_                  = 0;
+  droppedSamples_            = 0;
+  droppedBlocks_             = 0;
+  droppedInBlock_            = 0;
+  head_                      = 0;
+  tail_                      = 0;
+  writtenBlocks_             = 0;
+  writtenBytes_              = 0;
+  bytesPerSecond_            = 0;
+  stop_                      = 0;
+  threadStarted_             = false;
+  exitEvent_                 = NULL;
+  asynWrittenBlocks_         = 0;
+  asynDroppedBlocks_         = 0;
+  asynBytesPerSecond_        = 0;
+  writtenBlocksAsynDataItem_ = NULL;
+  droppedBlocksAsynDataItem_ = NULL;
+  rateAsynDataItem_          = NULL;
+
+  if ((blockSize <= 0) || (blockCount < ECMC_DS_STREAM_MIN_BLOCKS) ||
+      (blockCount > ECMC_DS_STREAM_MAX_BLOCKS)) {
+    LOGERR(
+      "%s/%s:%d: ERROR: Data storage %d. Invalid stream block size/count %d/%d (0x%x).\n",
+      __FILE__,
+      __FUNCTION__,
+      __LINE__,
+      dataStorageIndex_,
+      blockSize,
+      blockCount,
+      ERROR_DATA_STORAGE_STREAM_INVALID_CFG);
+    errorCode_ = ERROR_DATA_STORAGE_STREAM_INVALID_CFG;
+    return;
+  }
+
+  blockSize_    = (size_t)blockSize;
+  blockCount_   = (size_t)blockCount;
+  blockData_    = new double[blockSize_ * blockCount_];
+  blockHeaders_ = new ecmcDSStreamBlockHeader[blockCount_];
+
+  if (!blockData_ || !blockHeaders_) {
+    LOGERR("%s/%s:%d: ERROR: Data storage %d. Stream allocation failed (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           dataStorageIndex_,
+           ERROR_DATA_STORAGE_STREAM_ALLOC_FAIL);
+    errorCode_ = ERROR_DATA_STORAGE_STREAM_ALLOC_FAIL;
+    return;
+  }
+  memset(blockData_, 0, sizeof(double) * blockSize_ * blockCount_);
+  memset(blockHeaders_, 0, sizeof(ecmcDSStreamBlockHeader) * blockCount_);
+
+  file_ = fopen(fileName_, "wb");
+
+  if (!file_) {
+    LOGERR("%s/%s:%d: ERROR: Data storage %d. Failed open file %s (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           dataStorageIndex_,
+           fileName_,
+           ERROR_DATA_STORAGE_STREAM_FILE_OPEN_FAIL);
+    errorCode_ = ERROR_DATA_STORAGE_STREAM_FILE_OPEN_FAIL;
+    return;
+  }
+
+  ecmcDSStreamFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, ECMC_DS_STREAM_FILE_MAGIC,
+         sizeof(ECMC_DS_STREAM_FILE_MAGIC));
+  header.version          = ECMC_DS_STREAM_VERSION;
+  header.headerSize       = sizeof(header);
+  header.dataStorageIndex = dataStorageIndex_;
+  header.blockSize        = blockSize_;
+  header.elementSize      = sizeof(double);
+  header.sampleRateHz     = sampleRateHz_;
+  header.startTimeNs      = streamTimeNs(CLOCK_REALTIME);
+  snprintf(header.channelName,
+           sizeof(header.channelName),
+           ECMC_PLC_DATA_STORAGE_STR "%d." ECMC_DATA_STORAGE_DATA_DATA_STR,
+           dataStorageIndex_);
+
+  if (fwrite(&header, sizeof(header), 1, file_) != 1) {
+    LOGERR("%s/%s:%d: ERROR: Data storage %d. Failed write to file %s (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           dataStorageIndex_,
+           fileName_,
+           ERROR_DATA_STORAGE_STREAM_FILE_WRITE_FAIL);
+    errorCode_ = ERROR_DATA_STORAGE_STREAM_FILE_WRITE_FAIL;
+    return;
+  }
+
+  exitEvent_ = epicsEventCreate(epicsEventEmpty);
+
+  if (!exitEvent_ || (epicsThreadCreate(ECMC_DS_STREAM_THREAD_NAME,
+                                        epicsThreadPriorityLow,
+                                        epicsThreadGetStackSize(
+                                          epicsThreadStackMedium),
+                                        writerThread,
+                                        this) == NULL)) {
+    LOGERR("%s/%s:%d: ERROR: Data storage %d. Failed create writer thread (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           dataStorageIndex_,
+           ERROR_DATA_STORAGE_STREAM_THREAD_FAIL);
+    errorCode_ = ERROR_DATA_STORAGE_STREAM_THREAD_FAIL;
+    return;
+  }
+  threadStarted_ = true;
+
+  initAsyn();
+}
+
+ecmcDataStorageStream::~ecmcDataStorageStream() {
+  if (threadStarted_) {
+    stop_ = 1;
+    epicsEventWait(exitEvent_);
+  }
+
+  if (exitEvent_) {
+    epicsEventDestroy(exitEvent_);
+  }
+
+  // Rt is stopped here, write the last partial block
+  if (file_ && !errorCode_) {
+    if (fillCount_ > 0) {
+      publishBlock();
+    }
+    drain();
+  }
+
+  if (file_) {
+    fclose(file_);
+  }
+
+  delete[] blockData_;
+  delete[] blockHeaders_;
+  free(fileName_);
+}
+
+int ecmcDataStorageStream::getErrorCode() {
+  return errorCode_;
+}
+
+void ecmcDataStorageStream::push(const double *data, int size) {
+  if (errorCode_ || (size <= 0)) {
+    return;
+  }
+
+  if (!enable_) {
+    // Hand over the partial block so that the file is complete when paused
+    if (fillCount_ > 0) {
+      publishBlock();
+    }
+    return;
+  }
+
+  size_t left = (size_t)size;
+
+  while (left > 0) {
+    size_t head = epicsAtomicGetSizeT(&head_);
+    size_t tail = epicsAtomicGetSizeT(&tail_);
+
+    if (head - tail >= blockCount_) {
+      // All blocks queued for the writer, drop
+      droppedSamples_ += left;
+      droppedInBlock_ += left;
+
+      while (droppedInBlock_ >= blockSize_) {
+        droppedBlocks_++;
+        droppedInBlock_ -= blockSize_;
+      }
+      return;
+    }
+
+    // Count the last partial dropped block when recovering
+    if (droppedInBlock_ > 0) {
+      droppedBlocks_++;
+      droppedInBlock_ = 0;
+    }
+
+    size_t slot                     = head % blockCount_;
+    ecmcDSStreamBlockHeader *header = &blockHeaders_[slot];
+
+    if (fillCount_ == 0) {
+      header->firstTimeNs    = streamTimeNs(CLOCK_REALTIME);
+      header->droppedSamples = droppedSamples_;
+    }
+
+    size_t toCopy = blockSize_ - fillCount_;
+
+    if (toCopy > left) {
+      toCopy = left;
+    }
+
+    memcpy(blockData_ + slot * blockSize_ + fillCount_,
+           data,
+           toCopy * sizeof(double));
+    fillCount_ += toCopy;
+    data       += toCopy;
+    left       -= toCopy;
+
+    if (fillCount_ >= blockSize_) {
+      publishBlock();
+    }
+  }
+}
+
+void ecmcDataStorageStream::publishBlock() {
+  size_t head                     = epicsAtomicGetSizeT(&head_);
+  ecmcDSStreamBlockHeader *header = &blockHeaders_[head % blockCount_];
+
+  header->magic      = ECMC_DS_STREAM_BLOCK_MAGIC;
+  header->samples    = (uint32_t)fillCount_;
+  header->sequence   = sequence_++;
+  header->lastTimeNs = streamTimeNs(CLOCK_REALTIME);
+  fillCount_         = 0;
+
+  // Block data must be visible before the writer sees the new head
+  epicsAtomicWriteMemoryBarrier();
+  epicsAtomicSetSizeT(&head_, head + 1);
+}
+
+void ecmcDataStorageStream::setEnable(bool enable) {
+  enable_ = enable;
+}
+
+bool ecmcDataStorageStream::getEnable() {
+  return enable_;
+}
+
+void ecmcDataStorageStream::writerThread(void *obj) {
+  registerHelperThread(ECMC_DS_STREAM_THREAD_NAME);
+  ((ecmcDataStorageStream *)obj)->writerLoop();
+}
+
+void ecmcDataStorageStream::writerLoop() {
+  int64_t  lastRateTimeNs = streamTimeNs(CLOCK_MONOTONIC);
+  uint64_t lastRateBytes  = 0;
+
+  while (!stop_ && !errorCode_) {
+    drain();
+
+    int64_t now = streamTimeNs(CLOCK_MONOTONIC);
+
+    if (now - lastRateTimeNs >= 1000000000LL) {
+      bytesPerSecond_ = (double)(writtenBytes_ - lastRateBytes) * 1E9 /
+                        (double)(now - lastRateTimeNs);
+      lastRateBytes  = writtenBytes_;
+      lastRateTimeNs = now;
+    }
+
+    epicsThreadSleep(ECMC_DS_STREAM_WRITER_PERIOD_S);
+  }
+  unregisterHelperThread();
+  epicsEventSignal(exitEvent_);
+}
+
+void ecmcDataStorageStream::drain() {
+  size_t tail = epicsAtomicGetSizeT(&tail_);
+  size_t head = epicsAtomicGetSizeT(&head_);
+
+  if (tail == head) {
+    return;
+  }
+
+  epicsAtomicReadMemoryBarrier();
+
+  while (tail != head) {
+    if (writeBlock(tail % blockCount_)) {
+      return;
+    }
+    tail++;
+
+    // Block may be refilled by rt after tail is updated
+    epicsAtomicSetSizeT(&tail_, tail);
+  }
+  fflush(file_);
+}
+
+int ecmcDataStorageStream::writeBlock(size_t slot) {
+  ecmcDSStreamBlockHeader *header = &blockHeaders_[slot];
+
+  if ((fwrite(header, sizeof(*header), 1, file_) != 1) ||
+      (fwrite(blockData_ + slot * blockSize_, sizeof(double), header->samples,
+              file_) != header->samples)) {
+    LOGERR("%s/%s:%d: ERROR: Data storage %d. Failed write to file %s (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           dataStorageIndex_,
+           fileName_,
+           ERROR_DATA_STORAGE_STREAM_FILE_WRITE_FAIL);
+    errorCode_ = ERROR_DATA_STORAGE_STREAM_FILE_WRITE_FAIL;
+    return errorCode_;
+  }
+
+  writtenBlocks_++;
+  writtenBytes_ += sizeof(*header) + header->samples * sizeof(double);
+  return 0;
+}
+
+uint64_t ecmcDataStorageStream::getWrittenBlocks() {
+  return writtenBlocks_;
+}
+
+uint64_t ecmcDataStorageStream::getWrittenBytes() {
+  return writtenBytes_;
+}
+
+uint64_t ecmcDataStorageStream::getDroppedBlocks() {
+  return droppedBlocks_;
+}
+
+uint64_t ecmcDataStorageStream::getDroppedSamples() {
+  return droppedSamples_;
+}
+
+double ecmcDataStorageStream::getBytesPerSecond() {
+  return bytesPerSecond_;
+}
+
+void ecmcDataStorageStream::printStatus() {
+  printf("Data storage %d stream:\n", dataStorageIndex_);
+  printf("  file:            %s\n",  fileName_);
+  printf("  enable:          %d\n",  enable_);
+  printf("  error:           0x%x\n", errorCode_);
+  printf("  block size:      %zu\n", blockSize_);
+  printf("  block count:     %zu\n", blockCount_);
+  printf("  written blocks:  %" PRIu64 "\n", writtenBlocks_);
+  printf("  written bytes:   %" PRIu64 "\n", writtenBytes_);
+  printf("  dropped blocks:  %" PRIu64 "\n", droppedBlocks_);
+  printf("  dropped samples: %" PRIu64 "\n", droppedSamples_);
+  printf("  rate [bytes/s]:  %lf\n", bytesPerSecond_);
+}
+
+int ecmcDataStorageStream::addAsynParam(const char        *suffix,
+                                        asynParamType      asynType,
+                                        uint8_t           *data,
+                                        size_t             bytes,
+                                        ecmcEcDataType     dt,
+                                        ecmcAsynDataItem **item) {
+  char buffer[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  // "ds%d.stream.<suffix>"
+  unsigned int charCount = snprintf(buffer,
+                                    sizeof(buffer),
+                                    ECMC_PLC_DATA_STORAGE_STR "%d."
+                                    ECMC_DATA_STORAGE_STREAM_STR ".%s",
+                                    dataStorageIndex_,
+                                    suffix);
+
+  if (charCount >= sizeof(buffer) - 1) {
+    LOGERR(
+      "%s/%s:%d: Error: Failed to generate alias. Buffer to small (0x%x).\n",
+      __FILE__,
+      __FUNCTION__,
+      __LINE__,
+      ERROR_DATA_STORAGE_ASYN_PARAM_REGISTER_FAIL);
+    return ERROR_DATA_STORAGE_ASYN_PARAM_REGISTER_FAIL;
+  }
+
+  *item = asynPortDriver_->addNewAvailParam(buffer,
+                                            asynType,
+                                            data,
+                                            bytes,
+                                            dt,
+                                            0);
+
+  if (!*item) {
+    LOGERR(
+      "%s/%s:%d: ERROR: Add create default parameter for %s failed.\n",
+      __FILE__,
+      __FUNCTION__,
+      __LINE__,
+      buffer);
+    return ERROR_MAIN_ASYN_CREATE_PARAM_FAIL;
+  }
+  (*item)->setAllowWriteToEcmc(false);
+  (*item)->refreshParam(1);
+  return 0;
+}
+
+int ecmcDataStorageStream::initAsyn() {
+  if (!asynPortDriver_) {
+    return 0;
+  }
+
+  int errorCode = addAsynParam(ECMC_DATA_STORAGE_STREAM_BLOCKS_STR,
+                               asynParamInt32,
+                               (uint8_t *)&asynWrittenBlocks_,
+                               sizeof(asynWrittenBlocks_),
+                               ECMC_EC_S32,
+                               &writtenBlocksAsynDataItem_);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  errorCode = addAsynParam(ECMC_DATA_STORAGE_STREAM_DROPPED_STR,
+                           asynParamInt32,
+                           (uint8_t *)&asynDroppedBlocks_,
+                           sizeof(asynDroppedBlocks_),
+                           ECMC_EC_S32,
+                           &droppedBlocksAsynDataItem_);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  errorCode = addAsynParam(ECMC_DATA_STORAGE_STREAM_RATE_STR,
+                           asynParamFloat64,
+                           (uint8_t *)&asynBytesPerSecond_,
+                           sizeof(asynBytesPerSecond_),
+                           ECMC_EC_F64,
+                           &rateAsynDataItem_);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  asynPortDriver_->callParamCallbacks(ECMC_ASYN_DEFAULT_LIST,
+                                      ECMC_ASYN_DEFAULT_ADDR);
+  return 0;
+}
+
+int ecmcDataStorageStream::updateAsyn(bool force) {
+  asynWrittenBlocks_  = (int32_t)writtenBlocks_;
+  asynDroppedBlocks_  = (int32_t)droppedBlocks_;
+  asynBytesPerSecond_ = bytesPerSecond_;
+
+  if (writtenBlocksAsynDataItem_) {
+    writtenBlocksAsynDataItem_->refreshParamRT(force);
+  }
+
+  if (droppedBlocksAsynDataItem_) {
+    droppedBlocksAsynDataItem_->refreshParamRT(force);
+  }
+
+  if (rateAsynDataItem_) {
+    rateAsynDataItem_->refreshParamRT(force);
+  }
+  return 0;
+}
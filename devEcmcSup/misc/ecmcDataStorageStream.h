@@ -0,0 +1,161 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcDataStorageStream.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Streaming of data storage samples to disk for long acquisitions.
+* Samples appended to a data storage are also copied into preallocated
+* blocks. Full blocks are handed over to a low priority writer thread that
+* appends them to a binary file. No memory is allocated and no file access
+* is made in the realtime thread. If the writer can not keep up, new
+* samples are dropped (and counted) until a block is free again.
+*
+* File layout (native byte order):
+*   ecmcDSStreamFileHeader   (once)
+*   ecmcDSStreamBlockHeader + samples (double) * samples  (repeated)
+*
+\*************************************************************************/
+
+#ifndef ECMCDATASTORAGESTREAM_H_
+#define ECMCDATASTORAGESTREAM_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include "epicsEvent.h"
+#include "ecmcAsynPortDriver.h"
+
+#define ERROR_DATA_STORAGE_STREAM_FILE_OPEN_FAIL 0x20210
+#define ERROR_DATA_STORAGE_STREAM_ALLOC_FAIL 0x20211
+#define ERROR_DATA_STORAGE_STREAM_THREAD_FAIL 0x20212
+#define ERROR_DATA_STORAGE_STREAM_INVALID_CFG 0x20213
+#define ERROR_DATA_STORAGE_STREAM_NULL 0x20214
+#define ERROR_DATA_STORAGE_STREAM_FILE_WRITE_FAIL 0x20215
+
+#define ECMC_DS_STREAM_FILE_MAGIC "ECMCDSS"
+#define ECMC_DS_STREAM_BLOCK_MAGIC 0x4B4C4244  // "DBLK"
+#define ECMC_DS_STREAM_VERSION 1
+#define ECMC_DS_STREAM_CHANNEL_NAME_LENGTH 64
+#define ECMC_DS_STREAM_MIN_BLOCKS 2
+#define ECMC_DS_STREAM_DEFAULT_BLOCKS 3
+#define ECMC_DS_STREAM_MAX_BLOCKS 64
+#define ECMC_DS_STREAM_WRITER_PERIOD_S 0.01
+#define ECMC_DS_STREAM_THREAD_NAME "ecmcDSStream"
+
+#define ECMC_DATA_STORAGE_STREAM_STR "stream"
+#define ECMC_DATA_STORAGE_STREAM_BLOCKS_STR "blocks"
+#define ECMC_DATA_STORAGE_STREAM_DROPPED_STR "dropped"
+#define ECMC_DATA_STORAGE_STREAM_RATE_STR "rate"
+
+struct ecmcDSStreamFileHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+  int32_t  dataStorageIndex;
+  uint32_t blockSize;         // Max samples per block
+  uint32_t elementSize;       // sizeof(double)
+  uint32_t reserved;
+  double   sampleRateHz;      // ecmc rt loop rate
+  int64_t  startTimeNs;       // CLOCK_REALTIME
+  char     channelName[ECMC_DS_STREAM_CHANNEL_NAME_LENGTH];
+};
+
+struct ecmcDSStreamBlockHeader {
+  uint32_t magic;
+  uint32_t samples;           // Valid samples in this block
+  uint64_t sequence;          // Block sequence number
+  int64_t  firstTimeNs;       // CLOCK_REALTIME of first sample
+  int64_t  lastTimeNs;        // CLOCK_REALTIME of last sample
+  uint64_t droppedSamples;    // Total dropped samples before this block
+};
+
+class ecmcDataStorageStream {
+public:
+  ecmcDataStorageStream(ecmcAsynPortDriver *asynPortDriver,
+                        int                 dataStorageIndex,
+                        const char         *fileName,
+                        int                 blockSize,
+                        int                 blockCount,
+                        double              sampleRateHz);
+  ~ecmcDataStorageStream();
+
+  // Returns 0 if started (file open and writer thread running)
+  int      getErrorCode();
+
+  // Called from rt (copy only)
+  void     push(const double *data,
+                int           size);
+  void     setEnable(bool enable);
+  bool     getEnable();
+  int      updateAsyn(bool force);
+
+  uint64_t getWrittenBlocks();
+  uint64_t getWrittenBytes();
+  uint64_t getDroppedBlocks();
+  uint64_t getDroppedSamples();
+  double   getBytesPerSecond();
+  void     printStatus();
+
+private:
+  static void writerThread(void *obj);
+  void        writerLoop();
+  void        drain();
+  int         writeBlock(size_t slot);
+  void        publishBlock();
+  int         initAsyn();
+  int         addAsynParam(const char *suffix,
+                           asynParamType      asynType,
+                           uint8_t           *data,
+                           size_t             bytes,
+                           ecmcEcDataType     dt,
+                           ecmcAsynDataItem **item);
+
+  ecmcAsynPortDriver *asynPortDriver_;
+  int dataStorageIndex_;
+  char *fileName_;
+  FILE *file_;
+  int errorCode_;
+  size_t blockSize_;
+  size_t blockCount_;
+  double sampleRateHz_;
+  volatile int enable_;
+
+  // Blocks (allocated in constructor)
+  double *blockData_;
+  ecmcDSStreamBlockHeader *blockHeaders_;
+
+  // Owned by producer (rt)
+  size_t fillCount_;
+  uint64_t sequence_;
+  uint64_t droppedSamples_;
+  uint64_t droppedBlocks_;
+  size_t droppedInBlock_;
+
+  // Published blocks are [tail_, head_) (epicsAtomic)
+  size_t head_;
+  size_t tail_;
+
+  // Owned by writer
+  uint64_t writtenBlocks_;
+  uint64_t writtenBytes_;
+  double bytesPerSecond_;
+  volatile int stop_;
+  bool threadStarted_;
+  epicsEventId exitEvent_;
+
+  // Asyn (int32/float64 copies of counters)
+  int32_t asynWrittenBlocks_;
+  int32_t asynDroppedBlocks_;
+  double asynBytesPerSecond_;
+  ecmcAsynDataItem *writtenBlocksAsynDataItem_;
+  ecmcAsynDataItem *droppedBlocksAsynDataItem_;
+  ecmcAsynDataItem *rateAsynDataItem_;
+};
+
+#endif  /* ECMCDATASTORAGESTREAM_H_ */
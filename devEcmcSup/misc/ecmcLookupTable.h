@@ -84,9 +84,65 @@ public:
                       (inputIndex - indexTable_[i1])) / (indexTable_[i2] - indexTable_[i1]));
   }
 
+  // Linear interpolation with cached interval (for rt use, like cams).
+  // *interval is the interval of the last call (init to 0). If the index
+  // is in the same or a neighbouring interval no search is needed (O(1)
+  // for continuous inputs). *slope is the derivative d(value)/d(index)
+  // (0 outside the table).
+  T2 getValue(T1 inputIndex, size_t *interval, double *slope) {
+    const size_t last = indexTable_.size() - 1;
+
+    if (inputIndex <= indexTable_.front()) {
+      *interval = 0;
+      *slope    = 0;
+      return valueTable_.front();
+    }
+    if (inputIndex >= indexTable_.back()) {
+      *interval = last - 1;
+      *slope    = 0;
+      return valueTable_.back();
+    }
+
+    size_t i1 = *interval < last ? *interval : last - 1;
+
+    if (inputIndex < indexTable_[i1]) {
+      if ((i1 > 0) && (inputIndex >= indexTable_[i1 - 1])) {
+        i1--;
+      } else {
+        i1 = std::distance(indexTable_.begin(),
+                           std::lower_bound(indexTable_.begin(),
+                                            indexTable_.end(),
+                                            inputIndex)) - 1;
+      }
+    } else if (inputIndex > indexTable_[i1 + 1]) {
+      if ((i1 + 2 <= last) && (inputIndex <= indexTable_[i1 + 2])) {
+        i1++;
+      } else {
+        i1 = std::distance(indexTable_.begin(),
+                           std::lower_bound(indexTable_.begin(),
+                                            indexTable_.end(),
+                                            inputIndex)) - 1;
+      }
+    }
+    *interval = i1;
+    const size_t i2 = i1 + 1;
+
+    *slope = static_cast<double>(valueTable_[i2] - valueTable_[i1]) /
+             (indexTable_[i2] - indexTable_[i1]);
+    return (T2) (valueTable_[i1] + *slope * (inputIndex - indexTable_[i1]));
+  }
+
+  T1 getIndexFirst() {
+    return indexTable_.front();
+  }
+
+  T1 getIndexLast() {
+    return indexTable_.back();
+  }
+
   int getValidatedOK() {
     return validatedOK_;
-  }  
+  }
 
 private:
   std::vector<T1> indexTable_;
@@ -33,7 +33,7 @@ int createDataStorage(int index, int elements, int bufferType) {
            index,
            elements);
 
-  if ((index >= ECMC_MAX_DATA_STORAGE_OBJECTS) || (index < 0)) {
+  if ((index >= ECMC_REGISTRY_MAX_SIZE) || (index < 0)) {
     return ERROR_MAIN_DATA_STORAGE_INDEX_OUT_OF_RANGE;
   }
 
@@ -41,13 +41,20 @@ int createDataStorage(int index, int elements, int bufferType) {
     return ERROR_MAIN_DATA_STORAGE_INVALID_SIZE;
   }
 
+  // Grow registry if needed
+  int errorCode = dataStorages.resize(index + 1);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
   // Sample rate fixed
   sampleRateChangeAllowed = 0;
 
   delete dataStorages[index];
-  dataStorages[index] = new ecmcDataStorage(asynPort, index,
-                                            elements,
-                                            (ecmcDSBufferType)bufferType);
+  dataStorages.set(index, new ecmcDataStorage(asynPort, index,
+                                              elements,
+                                              (ecmcDSBufferType)bufferType));
 
   if (!dataStorages[index]) {
     LOGERR("%s/%s:%d: FAILED TO ALLOCATE MEMORY FOR DATA STORAGE OBJECT.\n",
@@ -161,6 +168,85 @@ int setDataStorageCurrentDataIndex(int indexStorage, int position) {
   return dataStorages[indexStorage]->setCurrentPosition(position);
 }
 
+int setDataStorageStream(int   indexStorage,
+                         int   blockSize,
+                         int   blockCount,
+                         char *fileName) {
+  LOGINFO4("%s/%s:%d indexStorage=%d blockSize=%d blockCount=%d fileName=%s\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           indexStorage,
+           blockSize,
+           blockCount,
+           fileName);
+
+  CHECK_STORAGE_RETURN_IF_ERROR(indexStorage);
+
+  return dataStorages[indexStorage]->setStream(fileName,
+                                               blockSize,
+                                               blockCount,
+                                               mcuFrequency);
+}
+
+int setDataStorageStreamEnable(int indexStorage, int enable) {
+  LOGINFO4("%s/%s:%d indexStorage=%d enable=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           indexStorage,
+           enable);
+
+  CHECK_STORAGE_RETURN_IF_ERROR(indexStorage);
+
+  return dataStorages[indexStorage]->setStreamEnable(enable);
+}
+
+int getDataStorageStreamWrittenBlocks(int indexStorage, uint64_t *blocks) {
+  CHECK_STORAGE_RETURN_IF_ERROR(indexStorage);
+
+  ecmcDataStorageStream *stream = dataStorages[indexStorage]->getStream();
+
+  if (!stream) {
+    return ERROR_DATA_STORAGE_STREAM_NULL;
+  }
+
+  *blocks = stream->getWrittenBlocks();
+  return 0;
+}
+
+int getDataStorageStreamDroppedBlocks(int indexStorage, uint64_t *blocks) {
+  CHECK_STORAGE_RETURN_IF_ERROR(indexStorage);
+
+  ecmcDataStorageStream *stream = dataStorages[indexStorage]->getStream();
+
+  if (!stream) {
+    return ERROR_DATA_STORAGE_STREAM_NULL;
+  }
+
+  *blocks = stream->getDroppedBlocks();
+  return 0;
+}
+
+int printDataStorageStream(int indexStorage) {
+  LOGINFO4("%s/%s:%d indexStorage=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           indexStorage);
+
+  CHECK_STORAGE_RETURN_IF_ERROR(indexStorage);
+
+  ecmcDataStorageStream *stream = dataStorages[indexStorage]->getStream();
+
+  if (!stream) {
+    return ERROR_DATA_STORAGE_STREAM_NULL;
+  }
+
+  stream->printStatus();
+  return 0;
+}
+
 int createShm() {
   LOGINFO4("%s/%s:%d\n",
            __FILE__,
@@ -234,13 +320,145 @@ int loadLUT(int index, char *fileName) {
   CHECK_LUT_RETURN_IF_ERROR(index);
 
   try {
+    int errorCode = luts.resize(index + 1);
+
+    if (errorCode) {
+      return errorCode;
+    }
+
     if( luts[index] ) {
       delete luts[index];
+      luts.set(index, NULL);
     }
-    luts[index] = new ecmcLookupTable<double,double>(fileName);
+    luts.set(index, new ecmcLookupTable<double,double>(fileName));
   }
   catch(...) {
     return ERROR_LUT_LOAD_ERROR;
   }
   return 0;
 }
+
+int createCapture(int index,
+                  int samples,
+                  int preTriggerSamples,
+                  int decimation) {
+  LOGINFO4("%s/%s:%d index=%d samples=%d preTriggerSamples=%d decimation=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           samples,
+           preTriggerSamples,
+           decimation);
+
+  if ((index < 0) || (index >= ECMC_REGISTRY_MAX_SIZE)) {
+    return ERROR_CAPTURE_INDEX_OUT_OF_RANGE;
+  }
+
+  int errorCode = captures.resize(index + 1);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  if (captures[index]) {
+    delete captures[index];
+    captures.set(index, NULL);
+  }
+
+  ecmcCapture *capture = NULL;
+
+  try {
+    capture = new ecmcCapture(asynPort,
+                              index,
+                              samples,
+                              preTriggerSamples,
+                              decimation);
+  }
+  catch (std::bad_alloc& ex) {
+    LOGERR("%s/%s:%d: ERROR: Mem alloc error (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           ERROR_CAPTURE_ALLOC_FAIL);
+    return ERROR_CAPTURE_ALLOC_FAIL;
+  }
+
+  errorCode = capture->getErrorCode();
+
+  if (errorCode) {
+    delete capture;
+    return errorCode;
+  }
+  captures.set(index, capture);
+  return 0;
+}
+
+int addCaptureChannel(int index, const char *dataItemName) {
+  LOGINFO4("%s/%s:%d index=%d dataItemName=%s\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           dataItemName);
+  CHECK_CAPTURE_RETURN_IF_ERROR(index);
+
+  return captures[index]->addChannel(dataItemName);
+}
+
+int setCaptureTrigger(int index, int channel, int type, double level) {
+  LOGINFO4("%s/%s:%d index=%d channel=%d type=%d level=%lf\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           channel,
+           type,
+           level);
+  CHECK_CAPTURE_RETURN_IF_ERROR(index);
+
+  return captures[index]->setTrigger(channel, type, level);
+}
+
+int setCaptureMode(int index, int mode) {
+  LOGINFO4("%s/%s:%d index=%d mode=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           mode);
+  CHECK_CAPTURE_RETURN_IF_ERROR(index);
+
+  return captures[index]->setMode(mode);
+}
+
+int armCapture(int index) {
+  LOGINFO4("%s/%s:%d index=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index);
+  CHECK_CAPTURE_RETURN_IF_ERROR(index);
+
+  captures[index]->arm();
+  return 0;
+}
+
+int triggerCapture(int index) {
+  LOGINFO4("%s/%s:%d index=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index);
+  CHECK_CAPTURE_RETURN_IF_ERROR(index);
+
+  captures[index]->trigger();
+  return 0;
+}
+
+int printCapture(int index) {
+  CHECK_CAPTURE_RETURN_IF_ERROR(index);
+
+  captures[index]->print();
+  return 0;
+}
@@ -20,8 +20,7 @@
 
 #define CHECK_STORAGE_RETURN_IF_ERROR(indexStorage)\
         {\
-          if (indexStorage >= ECMC_MAX_DATA_STORAGE_OBJECTS ||\
-              indexStorage < 0) {\
+          if (!dataStorages.validIndex(indexStorage)) {\
             LOGERR("ERROR: Data storage index out of range.\n");\
             return ERROR_MAIN_DATA_STORAGE_INDEX_OUT_OF_RANGE;\
           }\
@@ -33,13 +32,25 @@
 
 #define CHECK_LUT_RETURN_IF_ERROR(lutIndex)\
         {\
-          if (lutIndex >= ECMC_MAX_LUTS ||\
+          if (lutIndex >= ECMC_REGISTRY_MAX_SIZE ||\
               lutIndex < 0) {\
             LOGERR("ERROR: LUT list index out of range.\n");\
             return ERROR_LUT_INDEX_OUT_OF_RANGE;\
           }\
         }\
 
+#define CHECK_CAPTURE_RETURN_IF_ERROR(captureIndex)\
+        {\
+          if (!captures.validIndex(captureIndex)) {\
+            LOGERR("ERROR: Capture index out of range.\n");\
+            return ERROR_CAPTURE_INDEX_OUT_OF_RANGE;\
+          }\
+          if (captures[captureIndex] == NULL) {\
+            LOGERR("ERROR: Capture object NULL.\n");\
+            return ERROR_CAPTURE_NULL;\
+          }\
+        }\
+
 
 # ifdef __cplusplus
 extern "C" {
@@ -186,6 +197,87 @@ int appendStorageBuffer(int     indexStorage,
 int setDataStorageCurrentDataIndex(int indexStorage,
                                    int position);
 
+/** \brief Stream data storage to file.\n
+ *
+ * All data appended to the data storage is also copied to blocks that
+ * are written to a binary file by a low priority thread (no file access in
+ * realtime). Each block holds a header with sequence number, timestamps of
+ * the first and last sample and the number of dropped samples. If the
+ * writer can not keep up, data is dropped and counted.\n
+ * Counters are available as asyn parameters:\n
+ *   ds<index>.stream.blocks  : Written blocks\n
+ *   ds<index>.stream.dropped : Dropped blocks\n
+ *   ds<index>.stream.rate    : Throughput [bytes/s]\n
+ *
+ * \param[in] indexStorage Index of data storage object to address.\n
+ * \param[in] blockSize Samples per block.\n
+ * \param[in] blockCount Number of blocks (2=double, 3=triple buffering..).\n
+ * \param[in] fileName Filename.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Stream data storage 3 to file in blocks of 1000 samples,
+ * triple buffered.\n
+ *  "Cfg.SetDataStorageStream(3,1000,3,/data/scan.bin)" //Command string to ecmcCmdParser.c\n
+ */
+int setDataStorageStream(int   indexStorage,
+                         int   blockSize,
+                         int   blockCount,
+                         char *fileName);
+
+/** \brief Enable/pause streaming of data storage to file.\n
+ *
+ * When disabled, the last partial block is written and new data is not
+ * streamed.\n
+ *
+ * \param[in] indexStorage Index of data storage object to address.\n
+ * \param[in] enable Enable streaming.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Pause streaming of data storage 3.\n
+ *  "Cfg.SetDataStorageStreamEnable(3,0)" //Command string to ecmcCmdParser.c\n
+ */
+int setDataStorageStreamEnable(int indexStorage,
+                               int enable);
+
+/** \brief Get number of blocks written to file.\n
+ *
+ * \param[in] indexStorage Index of data storage object to address.\n
+ * \param[out] blocks Written blocks.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Get written blocks of data storage 3.\n
+ *  "GetDataStorageStreamWrittenBlocks(3)" //Command string to ecmcCmdParser.c\n
+ */
+int getDataStorageStreamWrittenBlocks(int       indexStorage,
+                                      uint64_t *blocks);
+
+/** \brief Get number of dropped blocks.\n
+ *
+ * \param[in] indexStorage Index of data storage object to address.\n
+ * \param[out] blocks Dropped blocks.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Get dropped blocks of data storage 3.\n
+ *  "GetDataStorageStreamDroppedBlocks(3)" //Command string to ecmcCmdParser.c\n
+ */
+int getDataStorageStreamDroppedBlocks(int       indexStorage,
+                                      uint64_t *blocks);
+
+/** \brief Print status of data storage stream.\n
+ *
+ * \param[in] indexStorage Index of data storage object to address.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print stream status of data storage 3.\n
+ *  "Cfg.PrintDataStorageStream(3)" //Command string to ecmcCmdParser.c\n
+ */
+int printDataStorageStream(int indexStorage);
+
 /** \brief Load and create lookup table (LUT).\n
  *
  * \param[in] index Index of LUT.\n
@@ -198,6 +290,113 @@ int setDataStorageCurrentDataIndex(int indexStorage,
  */
 int loadLUT(int index, char *fileName);
 
+/** \brief Create a capture object (triggered recording of data items).\n
+ *
+ * Data items (ec entries, axis parameters, plc variables..) are recorded
+ * each decimation:th cycle into a preallocated ring. When triggered, the
+ * post trigger samples are recorded and the ring is published as one
+ * waveform per channel, "capture<index>.ch<channel>" (oldest sample first).
+ * State and number of published captures are available in
+ * "capture<index>.state" and "capture<index>.count".\n
+ *
+ * \param[in] index Index of capture object.\n
+ * \param[in] samples Samples per capture (waveform size).\n
+ * \param[in] preTriggerSamples Samples recorded before trigger.\n
+ * \param[in] decimation Record every decimation:th cycle.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Create capture 0 of 1000 samples, 100 before trigger,
+ * recorded each cycle.\n
+ *  "Cfg.CreateCapture(0,1000,100,1)" //Command string to ecmcCmdParser.c\n
+ */
+int createCapture(int index,
+                  int samples,
+                  int preTriggerSamples,
+                  int decimation);
+
+/** \brief Add a channel to a capture object.\n
+ *
+ * The data item is resolved at validation. The first element of the data
+ * item is recorded (1, 2, 4 or 8 byte types).\n
+ *
+ * \param[in] index Index of capture object.\n
+ * \param[in] dataItemName Name of data item.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Add actual position of axis 1 to capture 0.\n
+ *  "Cfg.AddCaptureChannel(0,ax1.enc.actpos)" //Command string to ecmcCmdParser.c\n
+ */
+int addCaptureChannel(int index, const char *dataItemName);
+
+/** \brief Set trigger of a capture object.\n
+ *
+ * \param[in] index Index of capture object.\n
+ * \param[in] channel Channel compared to level.\n
+ * \param[in] type Trigger type:\n
+ *   0 = None (only triggerCapture() or cap_trigg() in plc code),\n
+ *   1 = Rising edge,\n
+ *   2 = Falling edge,\n
+ *   3 = Rising or falling edge,\n
+ *   4 = Above level (value >= level),\n
+ *   5 = Below level (value <= level).\n
+ * \param[in] level Trigger level.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Trigger capture 0 on rising edge of channel 1 at 2.5.\n
+ *  "Cfg.SetCaptureTrigger(0,1,1,2.5)" //Command string to ecmcCmdParser.c\n
+ */
+int setCaptureTrigger(int index, int channel, int type, double level);
+
+/** \brief Set mode of a capture object.\n
+ *
+ * \param[in] index Index of capture object.\n
+ * \param[in] mode 0 = single, 1 = auto (rearm after publish).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Set capture 0 to auto mode.\n
+ *  "Cfg.SetCaptureMode(0,1)" //Command string to ecmcCmdParser.c\n
+ */
+int setCaptureMode(int index, int mode);
+
+/** \brief Arm a capture object.\n
+ *
+ * \param[in] index Index of capture object.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Arm capture 0.\n
+ *  "Cfg.ArmCapture(0)" //Command string to ecmcCmdParser.c\n
+ */
+int armCapture(int index);
+
+/** \brief Trigger a capture object.\n
+ *
+ * Accepted when armed and the pre trigger samples are recorded.\n
+ *
+ * \param[in] index Index of capture object.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Trigger capture 0.\n
+ *  "Cfg.TriggerCapture(0)" //Command string to ecmcCmdParser.c\n
+ */
+int triggerCapture(int index);
+
+/** \brief Print capture object.\n
+ *
+ * \param[in] index Index of capture object.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print capture 0.\n
+ *  "Cfg.PrintCapture(0)" //Command string to ecmcCmdParser.c\n
+ */
+int printCapture(int index);
+
 /** \brief Create SHM Object.\n
  *
  * Creates a shared memory object for master 2 master communication
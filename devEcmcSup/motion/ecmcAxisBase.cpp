@@ -18,6 +18,7 @@
 #include <iostream>
 #include "ecmcMotion.h"
 #include "ecmcErrorsList.h"
+#include "ecmcAxisGear.h"
 
 /**
  * Callback function for asynWrites (control word)
@@ -231,6 +232,10 @@ ecmcAxisBase::ecmcAxisBase(ecmcAsynPortDriver *asynPortDriver,
   seq_.setMon(mon_);
   seq_.setEnc(encArray_);
   initAsyn();
+
+  flightRec_ = new ecmcAxisFlightRecorder(asynPortDriver_,
+                                          axisID,
+                                          ECMC_AXIS_FR_DEFAULT_SAMPLES);
 }
 
 ecmcAxisBase::~ecmcAxisBase() {
@@ -245,6 +250,10 @@ ecmcAxisBase::~ecmcAxisBase() {
   extTrajVeloFilter_ = NULL;
   delete extEncVeloFilter_;
   extEncVeloFilter_ = NULL;
+  delete flightRec_;
+  flightRec_ = NULL;
+  delete gear_;
+  gear_ = NULL;
 }
 
 void ecmcAxisBase::initVars() {
@@ -280,6 +289,10 @@ void ecmcAxisBase::initVars() {
   memset(diagBuffer_, 0, AX_MAX_DIAG_STRING_CHAR_LENGTH);
   extTrajVeloFilter_         = NULL;
   extEncVeloFilter_          = NULL;
+  flightRec_                 = NULL;
+  gear_                      = NULL;
+  extTrajVeloFF_             = 0;
+  extTrajVeloFFValid_        = false;
   enableExtTrajVeloFilter_   = false;
   enableExtEncVeloFilter_    = false;
   disableAxisAtErrorReset_   = false;
@@ -315,6 +328,13 @@ void ecmcAxisBase::initVars() {
   enableAutoResetError_         = 1;
 }
 
+void ecmcAxisBase::executePreCntrl(bool masterOK) {
+  // Axes without batched controller execute everything here
+  execute(masterOK);
+}
+
+void ecmcAxisBase::executePostCntrl(bool masterOK) {}
+
 void ecmcAxisBase::preExecute(bool masterOK) {
   auto &status = data_.status_;
   auto &statusWord = status.statusWord_;
@@ -455,6 +475,12 @@ void ecmcAxisBase::preExecute(bool masterOK) {
     status.externalTrajectoryVelocity = extTrajDelta * invSampleTime_;
   }
 
+  // Velocity from source (gear), filter above still updated
+  if (extTrajVeloFFValid_) {
+    status.externalTrajectoryVelocity = extTrajVeloFF_;
+    extTrajVeloFFValid_ = false;
+  }
+
   // Enc
   if (enableExtEncVeloFilter_ && extEncVeloFilter_) {
     status.externalEncoderVelocity = extEncVeloFilter_->getFiltVelo(extEncDelta);
@@ -504,6 +530,8 @@ void ecmcAxisBase::postExecute(bool masterOK) {
     statusOutputEntry_->writeValue(getErrorID() == 0);
   }
 
+  flightRec_->record(&data_.status_);
+
   // Data for last scan
   memcpy(&data_.statusOld_,&data_.status_,sizeof(data_.status_));
   memcpy(&data_.controlOld_,&data_.control_,sizeof(data_.control_));
@@ -789,6 +817,10 @@ ecmcTrajectoryBase * ecmcAxisBase::getTraj() {
   return traj_;
 }
 
+ecmcAxisFlightRecorder * ecmcAxisBase::getFlightRecorder() {
+  return flightRec_;
+}
+
 ecmcMonitor * ecmcAxisBase::getMon() {
   return mon_;
 }
@@ -1560,6 +1592,12 @@ int ecmcAxisBase::setExtActPos(double pos) {
   return 0;
 }
 
+int ecmcAxisBase::setExtSetVel(double vel) {
+  extTrajVeloFF_      = vel;
+  extTrajVeloFFValid_ = true;
+  return 0;
+}
+
 int ecmcAxisBase::setEnableExtTrajVeloFilter(bool enable) {
   if (!extTrajVeloFilter_) {
     return setErrorID(__FILE__,
@@ -3484,3 +3522,14 @@ void ecmcAxisBase::setBlocked(bool blocked) {
 bool ecmcAxisBase::getBlocked() {
   return masterSlaveBlocked_ || getBlockCom();
 }
+
+void ecmcAxisBase::setGear(ecmcAxisGear *gear) {
+  if (gear_ && (gear_ != gear)) {
+    delete gear_;
+  }
+  gear_ = gear;
+}
+
+ecmcAxisGear * ecmcAxisBase::getGear() {
+  return gear_;
+}
@@ -30,6 +30,9 @@
 #include "ecmcAxisData.h"
 #include "ecmcFilter.h"
 #include "ecmcMotionUtils.h"
+#include "ecmcAxisFlightRecorder.h"
+
+class ecmcAxisGear;
 
 enum axisState {
   ECMC_AXIS_STATE_STARTUP  = 0,
@@ -58,6 +61,10 @@ public:
   virtual ecmcPIDController* getCntrl()             = 0;
   virtual int                validate()             = 0;
   virtual void               execute(bool masterOK) = 0;
+
+  // Split execute used when controllers are evaluated in batch (ecmcPIDBatch)
+  virtual void               executePreCntrl(bool masterOK);
+  virtual void               executePostCntrl(bool masterOK);
   int                        getCntrlError(double *error);
   int                        setEnable(bool enable);
   int                        setEnableAtStartup(bool enable);
@@ -92,6 +99,7 @@ public:
                                        int  *bytesUsed);
   ecmcTrajectoryBase*        getTraj();
   ecmcMonitor*               getMon();
+  ecmcAxisFlightRecorder*    getFlightRecorder();
   ecmcEncoder*               getEnc();
   ecmcEncoder*               getEnc(int  encIndex,
                                     int *error);
@@ -141,6 +149,8 @@ public:
   int                        getModType();
   int                        setExtSetPos(double pos);
   int                        setExtActPos(double pos);
+  // Velocity of external setpoint for this cycle (instead of difference)
+  int                        setExtSetVel(double vel);
   int                        setEnableExtEncVeloFilter(bool enable);
   int                        setEnableExtTrajVeloFilter(bool enable);
   bool                       getEnableExtEncVeloFilter();
@@ -274,6 +284,8 @@ public:
   double     getCurrentPositionSetpoint();
   ecmcAxisDataStatus* getAxisStatusStruct();
   bool       getHwReady();
+  void       setGear(ecmcAxisGear *gear);  // Takes ownership
+  ecmcAxisGear* getGear();
 
 protected:
   void       initVars();
@@ -305,6 +317,7 @@ protected:
   ecmcEcEntry *statusOutputEntry_;
   ecmcFilter *extTrajVeloFilter_;
   ecmcFilter *extEncVeloFilter_;
+  ecmcAxisFlightRecorder *flightRec_;
   bool allowCmdFromOtherPLC_;
   bool executeCmdOld_;
   bool enableExtTrajVeloFilter_;
@@ -334,6 +347,9 @@ protected:
   double invSampleTime_;
   bool masterSlaveBlocked_;
   bool enableAutoResetError_;
+  double extTrajVeloFF_;
+  bool extTrajVeloFFValid_;
+  ecmcAxisGear *gear_;
 };
 
 #endif  /* ECMCAXISBASE_H_ */
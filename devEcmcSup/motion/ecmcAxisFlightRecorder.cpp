@@ -0,0 +1,343 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAxisFlightRecorder.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcAxisFlightRecorder.h"
+#include "ecmcErrorsList.h"
+#include "ecmcOctetIF.h"
+#include <string.h>
+#include <time.h>
+#include <new>
+
+ecmcAxisFlightRecorder::ecmcAxisFlightRecorder(
+  ecmcAsynPortDriver *asynPortDriver,
+  int                 axisId,
+  int                 samples) {
+  asynPortDriver_     = asynPortDriver;
+  dataAsynDataItem_   = NULL;
+  axisId_             = axisId;
+  ring_               = NULL;
+  keyframes_          = NULL;
+  size_               = 0;
+  mask_               = 0;
+  writeIndex_         = 0;
+  triggered_          = false;
+  frozen_             = false;
+  armRequest_         = 0;
+  postTriggerSamples_ = ECMC_AXIS_FR_POST_TRIGGER;
+  triggerPostSamples_ = 0;
+  postTriggerLeft_    = 0;
+  lastErrorCode_      = 0;
+  triggerErrorCode_   = 0;
+  triggerCycle_       = 0;
+  waveform_           = NULL;
+  unpackCount_        = 0;
+  unpackIndex_        = 0;
+  unpackStart_        = 0;
+  costNsAvg_          = 0;
+  costNsMax_          = 0;
+  costCounter_        = 0;
+
+  setSize(samples);
+  initAsyn();
+}
+
+ecmcAxisFlightRecorder::~ecmcAxisFlightRecorder() {
+  delete[] ring_;
+  delete[] keyframes_;
+  delete[] waveform_;
+}
+
+int ecmcAxisFlightRecorder::setSize(int samples) {
+  if ((samples < 0) || (samples > ECMC_AXIS_FR_MAX_SAMPLES)) {
+    LOGERR("%s/%s:%d: ERROR: Axis[%d]: Invalid flight recorder size %d (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           axisId_,
+           samples,
+           ERROR_AXIS_FR_INVALID_SIZE);
+    return ERROR_AXIS_FR_INVALID_SIZE;
+  }
+
+  size_t newSize = 0;
+
+  if (samples > 0) {
+    // Power of 2 (index by mask) and at least one keyframe block
+    newSize = ECMC_AXIS_FR_KEYFRAME_SAMPLES;
+
+    while (newSize < (size_t)samples) {
+      newSize <<= 1;
+    }
+  }
+
+  ecmcAxisFRSample *ring      = NULL;
+  double           *keyframes = NULL;
+  double           *waveform  = NULL;
+
+  if (newSize > 0) {
+    try {
+      ring      = new ecmcAxisFRSample[newSize];
+      keyframes = new double[newSize >> ECMC_AXIS_FR_KEYFRAME_BITS];
+      waveform  = new double[newSize * ECMC_AXIS_FR_VALUES_PER_SAMPLE];
+    } catch (std::bad_alloc& ex) {
+      delete[] ring;
+      delete[] keyframes;
+      LOGERR("%s/%s:%d: ERROR: Axis[%d]: Flight recorder mem alloc error (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             axisId_,
+             ERROR_AXIS_FR_ALLOC_FAIL);
+      return ERROR_AXIS_FR_ALLOC_FAIL;
+    }
+    memset(ring, 0, sizeof(ecmcAxisFRSample) * newSize);
+    memset(keyframes, 0,
+           sizeof(double) * (newSize >> ECMC_AXIS_FR_KEYFRAME_BITS));
+    memset(waveform, 0,
+           sizeof(double) * newSize * ECMC_AXIS_FR_VALUES_PER_SAMPLE);
+  }
+
+  delete[] ring_;
+  delete[] keyframes_;
+  delete[] waveform_;
+  ring_        = ring;
+  keyframes_   = keyframes;
+  waveform_    = waveform;
+  size_        = newSize;
+  mask_        = newSize > 0 ? newSize - 1 : 0;
+  writeIndex_  = 0;
+  triggered_   = false;
+  frozen_      = false;
+  unpackCount_ = 0;
+  unpackIndex_ = 0;
+
+  // Set new address to asyn interface
+  if (dataAsynDataItem_) {
+    dataAsynDataItem_->setEcmcDataPointer((uint8_t *)waveform_,
+                                          size_ *
+                                          ECMC_AXIS_FR_VALUES_PER_SAMPLE *
+                                          sizeof(double));
+  }
+
+  return 0;
+}
+
+int ecmcAxisFlightRecorder::getSize() {
+  return (int)size_;
+}
+
+void ecmcAxisFlightRecorder::setPostTriggerSamples(int samples) {
+  postTriggerSamples_ = samples > 0 ? samples : 0;
+}
+
+void ecmcAxisFlightRecorder::arm() {
+  armRequest_ = 1;
+}
+
+bool ecmcAxisFlightRecorder::getFrozen() {
+  return frozen_;
+}
+
+void ecmcAxisFlightRecorder::record(const ecmcAxisDataStatus *status) {
+  if (!size_) {
+    return;
+  }
+
+  if (armRequest_) {
+    armRequest_  = 0;
+    triggered_   = false;
+    frozen_      = false;
+    writeIndex_  = 0;
+    unpackCount_ = 0;
+    unpackIndex_ = 0;
+  }
+
+  if (frozen_) {
+    unpackStep();
+    return;
+  }
+
+  // Error edge
+  if (status->errorCode && !lastErrorCode_ && !triggered_) {
+    // Keep the trigger sample in the ring
+    triggerPostSamples_ = postTriggerSamples_ < (int)size_ ?
+                          postTriggerSamples_ : (int)size_ - 1;
+    triggered_        = true;
+    postTriggerLeft_  = triggerPostSamples_;
+    triggerErrorCode_ = status->errorCode;
+    triggerCycle_     = status->cycleCounter;
+  }
+  lastErrorCode_ = status->errorCode;
+
+  // Measure cost of a few samples
+  if (++costCounter_ >= ECMC_AXIS_FR_COST_MEASURE_INTERVAL) {
+    struct timespec start, end;
+    costCounter_ = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    writeSample(status);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double ns = (double)(end.tv_sec - start.tv_sec) * 1E9 +
+                (double)(end.tv_nsec - start.tv_nsec);
+    costNsAvg_ = costNsAvg_ > 0 ? 0.9 * costNsAvg_ + 0.1 * ns : ns;
+
+    if (ns > costNsMax_) {
+      costNsMax_ = ns;
+    }
+  } else {
+    writeSample(status);
+  }
+
+  if (triggered_) {
+    if (postTriggerLeft_ <= 0) {
+      frozen_      = true;
+      unpackCount_ = getValidCount();
+      unpackStart_ = writeIndex_ - unpackCount_;
+      unpackIndex_ = 0;
+    }
+    postTriggerLeft_--;
+  }
+}
+
+void ecmcAxisFlightRecorder::writeSample(const ecmcAxisDataStatus *status) {
+  size_t slot = writeIndex_ & mask_;
+
+  if ((slot & (ECMC_AXIS_FR_KEYFRAME_SAMPLES - 1)) == 0) {
+    keyframes_[slot >> ECMC_AXIS_FR_KEYFRAME_BITS] =
+      status->currentPositionSetpoint;
+  }
+
+  double key              = keyframes_[slot >> ECMC_AXIS_FR_KEYFRAME_BITS];
+  ecmcAxisFRSample *sample = &ring_[slot];
+  sample->posSetOffset = (float)(status->currentPositionSetpoint - key);
+  sample->posActOffset = (float)(status->currentPositionActual - key);
+  sample->cntrlError   = (float)status->cntrlError;
+  sample->cntrlOutput  = (float)status->cntrlOutput;
+  memcpy(&sample->statusWord, &status->statusWord_, sizeof(uint32_t));
+  writeIndex_++;
+}
+
+/* Samples in the ring with a valid keyframe. The keyframe of the oldest,
+*  partially overwritten block belongs to newer samples. */
+int ecmcAxisFlightRecorder::getValidCount() {
+  if (writeIndex_ <= size_) {
+    return (int)writeIndex_;
+  }
+
+  size_t partial = (ECMC_AXIS_FR_KEYFRAME_SAMPLES -
+                    (writeIndex_ & (ECMC_AXIS_FR_KEYFRAME_SAMPLES - 1))) &
+                   (ECMC_AXIS_FR_KEYFRAME_SAMPLES - 1);
+
+  return (int)(size_ - partial);
+}
+
+void ecmcAxisFlightRecorder::unpackStep() {
+  if (unpackIndex_ >= unpackCount_) {
+    return;
+  }
+
+  int end = unpackIndex_ + ECMC_AXIS_FR_UNPACK_PER_CYCLE;
+
+  if (end > unpackCount_) {
+    end = unpackCount_;
+  }
+
+  for (int i = unpackIndex_; i < end; i++) {
+    size_t slot                    = (unpackStart_ + i) & mask_;
+    double key                     = keyframes_[slot >> ECMC_AXIS_FR_KEYFRAME_BITS];
+    const ecmcAxisFRSample *sample = &ring_[slot];
+    double *out                    = &waveform_[i * ECMC_AXIS_FR_VALUES_PER_SAMPLE];
+    out[0] = key + sample->posSetOffset;
+    out[1] = key + sample->posActOffset;
+    out[2] = sample->cntrlError;
+    out[3] = sample->cntrlOutput;
+    out[4] = sample->statusWord;
+  }
+  unpackIndex_ = end;
+
+  if ((unpackIndex_ >= unpackCount_) && dataAsynDataItem_) {
+    dataAsynDataItem_->refreshParamRT(1,
+                                      unpackCount_ *
+                                      ECMC_AXIS_FR_VALUES_PER_SAMPLE *
+                                      sizeof(double));
+  }
+}
+
+void ecmcAxisFlightRecorder::print() {
+  printf("Axis[%d] flight recorder:\n", axisId_);
+  printf("  size [samples]:     %zu\n", size_);
+  printf("  sample size [byte]: %zu\n", sizeof(ecmcAxisFRSample));
+  printf("  frozen:             %d\n",  frozen_);
+  printf("  trigger error:      0x%x\n", triggerErrorCode_);
+  printf("  trigger cycle:      %d\n",  triggerCycle_);
+  printf("  cost avg/max [ns]:  %.1lf/%.1lf (incl. timer overhead)\n",
+         costNsAvg_,
+         costNsMax_);
+
+  if (!frozen_ || (unpackIndex_ < unpackCount_)) {
+    return;
+  }
+
+  printf("  index, setpoint, actual, error, output, statusword\n");
+
+  for (int i = 0; i < unpackCount_; i++) {
+    double *v = &waveform_[i * ECMC_AXIS_FR_VALUES_PER_SAMPLE];
+    printf("  %d, %lf, %lf, %lf, %lf, 0x%08x\n",
+           i - (unpackCount_ - triggerPostSamples_ - 1),
+           v[0], v[1], v[2], v[3], (uint32_t)v[4]);
+  }
+}
+
+int ecmcAxisFlightRecorder::initAsyn() {
+  if (!asynPortDriver_) {
+    return 0;
+  }
+
+  char buffer[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  // "ax%d.flightrec"
+  unsigned int charCount = snprintf(buffer,
+                                    sizeof(buffer),
+                                    ECMC_AX_STR "%d." ECMC_AXIS_FR_STR,
+                                    axisId_);
+
+  if (charCount >= sizeof(buffer) - 1) {
+    LOGERR(
+      "%s/%s:%d: Error: Failed to generate alias. Buffer to small (0x%x).\n",
+      __FILE__,
+      __FUNCTION__,
+      __LINE__,
+      ERROR_AXIS_FR_ASYN_PARAM_FAIL);
+    return ERROR_AXIS_FR_ASYN_PARAM_FAIL;
+  }
+
+  dataAsynDataItem_ = asynPortDriver_->addNewAvailParam(buffer,
+                                                        asynParamFloat64Array,
+                                                        (uint8_t *)waveform_,
+                                                        size_ *
+                                                        ECMC_AXIS_FR_VALUES_PER_SAMPLE *
+                                                        sizeof(double),
+                                                        ECMC_EC_F64,
+                                                        0);
+
+  if (!dataAsynDataItem_) {
+    LOGERR(
+      "%s/%s:%d: ERROR: Add create default parameter for %s failed.\n",
+      __FILE__,
+      __FUNCTION__,
+      __LINE__,
+      buffer);
+    return ERROR_AXIS_FR_ASYN_PARAM_FAIL;
+  }
+  dataAsynDataItem_->setAllowWriteToEcmc(false);
+  dataAsynDataItem_->refreshParam(1, (size_t)0);
+  return 0;
+}
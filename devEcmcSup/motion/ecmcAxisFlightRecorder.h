@@ -0,0 +1,113 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAxisFlightRecorder.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Always-on history of the last samples of an axis for post-mortem analysis.
+* Each cycle one compact sample (20 bytes) is written to a preallocated ring:
+* setpoint and actual position as float offsets to a double keyframe
+* (one keyframe per ECMC_AXIS_FR_KEYFRAME_SAMPLES samples), controller error
+* and output as floats and the status word.
+* On an error edge the recorder records ECMC_AXIS_FR_POST_TRIGGER samples more
+* and then freezes. The frozen ring is unpacked in steps (few samples per
+* cycle) into a waveform available as asyn parameter "ax<id>.flightrec":
+*   [setpoint, actual, error, output, statusword] * samples (oldest first)
+*
+\*************************************************************************/
+
+#ifndef ECMCAXISFLIGHTRECORDER_H_
+#define ECMCAXISFLIGHTRECORDER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ecmcAxisData.h"
+#include "ecmcAsynPortDriver.h"
+
+#define ERROR_AXIS_FR_ALLOC_FAIL 0x18000
+#define ERROR_AXIS_FR_INVALID_SIZE 0x18001
+#define ERROR_AXIS_FR_ASYN_PARAM_FAIL 0x18002
+
+#define ECMC_AXIS_FR_DEFAULT_SAMPLES 1024
+#define ECMC_AXIS_FR_MAX_SAMPLES (1 << 20)
+#define ECMC_AXIS_FR_KEYFRAME_BITS 6
+#define ECMC_AXIS_FR_KEYFRAME_SAMPLES (1 << ECMC_AXIS_FR_KEYFRAME_BITS)
+#define ECMC_AXIS_FR_POST_TRIGGER 32
+#define ECMC_AXIS_FR_UNPACK_PER_CYCLE 128
+#define ECMC_AXIS_FR_VALUES_PER_SAMPLE 5
+#define ECMC_AXIS_FR_COST_MEASURE_INTERVAL 1024
+#define ECMC_AXIS_FR_STR "flightrec"
+
+struct ecmcAxisFRSample {
+  float    posSetOffset;  // Setpoint minus keyframe
+  float    posActOffset;  // Actual minus keyframe
+  float    cntrlError;
+  float    cntrlOutput;
+  uint32_t statusWord;
+};
+
+class ecmcAxisFlightRecorder {
+public:
+  ecmcAxisFlightRecorder(ecmcAsynPortDriver *asynPortDriver,
+                         int                 axisId,
+                         int                 samples);
+  ~ecmcAxisFlightRecorder();
+
+  // Allocation (not in rt). Size is rounded up to a power of 2, 0 disables.
+  int  setSize(int samples);
+  int  getSize();
+  void setPostTriggerSamples(int samples);
+
+  // Called every cycle from ecmcAxisBase::postExecute()
+  void record(const ecmcAxisDataStatus *status);
+
+  // Rearm (applied in next record())
+  void arm();
+  bool getFrozen();
+  void print();
+
+private:
+  void writeSample(const ecmcAxisDataStatus *status);
+  void unpackStep();
+  int  getValidCount();
+  int  initAsyn();
+
+  ecmcAsynPortDriver *asynPortDriver_;
+  ecmcAsynDataItem *dataAsynDataItem_;
+  int axisId_;
+
+  // Ring
+  ecmcAxisFRSample *ring_;
+  double *keyframes_;
+  size_t size_;
+  size_t mask_;
+  uint64_t writeIndex_;
+
+  // Trigger
+  bool triggered_;
+  bool frozen_;
+  volatile int armRequest_;
+  int postTriggerSamples_;
+  int triggerPostSamples_;  // postTriggerSamples_ latched at trigger
+  int postTriggerLeft_;
+  int lastErrorCode_;
+  int triggerErrorCode_;
+  int triggerCycle_;
+
+  // Unpacked waveform
+  double *waveform_;
+  int unpackCount_;
+  int unpackIndex_;
+  uint64_t unpackStart_;
+
+  // Measured cost of writeSample()
+  double costNsAvg_;
+  double costNsMax_;
+  int costCounter_;
+};
+
+#endif  /* ECMCAXISFLIGHTRECORDER_H_ */
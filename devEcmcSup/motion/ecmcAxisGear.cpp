@@ -0,0 +1,353 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAxisGear.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcAxisGear.h"
+#include <math.h>
+#include <string.h>
+#include "ecmcRegistry.h"
+
+extern ecmcRegistry<ecmcLookupTable<double, double> > luts;
+
+ecmcAxisGear::ecmcAxisGear(ecmcAxisBase       *slave,
+                           ecmcAxisBase       *master,
+                           int                 masterSource,
+                           double              sampleTimeS,
+                           ecmcAsynPortDriver *asynPortDriver) {
+  errorReset();
+  slave_          = slave;
+  master_         = master;
+  masterSource_   = masterSource;
+  sampleTimeS_    = sampleTimeS;
+  asynPortDriver_ = asynPortDriver;
+  ratio_          = 1;
+  lutIndex_       = -1;
+  lut_            = NULL;
+  lutInterval_    = 0;
+  engageDist_     = 0;
+  phaseTarget_    = 0;
+  phaseVelo_      = 0;
+  engageCmd_      = false;
+  firstCycle_     = true;
+  masterPosOld_   = 0;
+  phase_          = 0;
+  target_         = 0;
+  targetOld_      = 0;
+  hold_           = 0;
+  travel_         = 0;
+  out_            = 0;
+  velFF_          = 0;
+  state_          = ECMC_AXIS_GEAR_DISENGAGED;
+  memset(asynParams_, 0, sizeof(asynParams_));
+
+  if (!slave_ || !master_ || (slave_ == master_)) {
+    setErrorID(__FILE__, __FUNCTION__, __LINE__,
+               ERROR_AXIS_GEAR_MASTER_INVALID);
+    return;
+  }
+
+  if ((masterSource_ != ECMC_AXIS_GEAR_SOURCE_SETPOINT) &&
+      (masterSource_ != ECMC_AXIS_GEAR_SOURCE_ACTUAL)) {
+    setErrorID(__FILE__, __FUNCTION__, __LINE__,
+               ERROR_AXIS_GEAR_MASTER_SOURCE_INVALID);
+    return;
+  }
+
+  int errorCode = initAsyn();
+
+  if (errorCode) {
+    setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+}
+
+ecmcAxisGear::~ecmcAxisGear() {}
+
+int ecmcAxisGear::setRatio(double ratio) {
+  ratio_ = ratio;
+  return 0;
+}
+
+int ecmcAxisGear::setCamLUT(int lutIndex) {
+  lutIndex_ = lutIndex;
+  lut_      = NULL;
+  return 0;
+}
+
+int ecmcAxisGear::setEngageDist(double dist) {
+  if (dist < 0) {
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__,
+                      ERROR_AXIS_GEAR_VALUE_OUT_OF_RANGE);
+  }
+  engageDist_ = dist;
+  return 0;
+}
+
+int ecmcAxisGear::setPhase(double phase) {
+  phaseTarget_ = phase;
+  return 0;
+}
+
+int ecmcAxisGear::setPhaseVelo(double velo) {
+  if (velo < 0) {
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__,
+                      ERROR_AXIS_GEAR_VALUE_OUT_OF_RANGE);
+  }
+  phaseVelo_ = velo;
+  return 0;
+}
+
+int ecmcAxisGear::setEngage(bool engage) {
+  if (engage && (slave_->getTrajDataSourceType() != ECMC_DATA_SOURCE_EXTERNAL)) {
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__,
+                      ERROR_AXIS_GEAR_SOURCE_NOT_EXTERNAL);
+  }
+  engageCmd_ = engage;
+  return 0;
+}
+
+int ecmcAxisGear::getState() {
+  return state_;
+}
+
+ecmcAxisBase * ecmcAxisGear::getMaster() {
+  return master_;
+}
+
+int ecmcAxisGear::validate() {
+  lut_ = NULL;
+
+  if (lutIndex_ >= 0) {
+    if (!luts.validIndex(lutIndex_) || (luts[lutIndex_] == NULL)) {
+      LOGERR("%s/%s:%d: ERROR: Axis[%d]: Cam lut %d not loaded (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             slave_->getAxisID(),
+             lutIndex_,
+             ERROR_AXIS_GEAR_LUT_INVALID);
+      return setErrorID(__FILE__, __FUNCTION__, __LINE__,
+                        ERROR_AXIS_GEAR_LUT_INVALID);
+    }
+    lut_ = luts[lutIndex_];
+  }
+  return 0;
+}
+
+bool ecmcAxisGear::slaveReady() {
+  return slave_->getEnabled() &&
+         slave_->getTrajDataSourceType() == ECMC_DATA_SOURCE_EXTERNAL;
+}
+
+void ecmcAxisGear::execute() {
+  double masterPos = 0;
+  double masterVel = 0;
+
+  if (masterSource_ == ECMC_AXIS_GEAR_SOURCE_ACTUAL) {
+    master_->getPosAct(&masterPos);
+    master_->getVelAct(&masterVel);
+  } else {
+    master_->getPosSet(&masterPos);
+    master_->getVelSet(&masterVel);
+  }
+
+  // Master delta (unwrap modulo)
+  const double range = master_->getModRange();
+  double delta       = firstCycle_ ? 0 : masterPos - masterPosOld_;
+
+  if (range > 0) {
+    if (delta > range / 2) {
+      delta -= range;
+    } else if (delta < -range / 2) {
+      delta += range;
+    }
+  }
+  masterPosOld_ = masterPos;
+  firstCycle_   = false;
+
+  // Phase, ramped (or step)
+  double phaseDelta = phaseTarget_ - phase_;
+
+  if ((phaseVelo_ > 0) && (fabs(phaseDelta) > phaseVelo_ * sampleTimeS_)) {
+    phaseDelta = copysign(phaseVelo_ * sampleTimeS_, phaseDelta);
+  }
+  phase_ += phaseDelta;
+
+  if (phaseVelo_ > 0) {
+    masterVel += phaseDelta / sampleTimeS_;
+  }
+
+  // Engage/disengage
+  if (state_ != ECMC_AXIS_GEAR_DISENGAGED && !slaveReady()) {
+    state_     = ECMC_AXIS_GEAR_DISENGAGED;
+    engageCmd_ = false;
+  }
+
+  if (engageCmd_ && ((state_ == ECMC_AXIS_GEAR_DISENGAGED) ||
+                     (state_ == ECMC_AXIS_GEAR_DISENGAGING))) {
+    if (slaveReady()) {
+      slave_->getPosSet(&hold_);
+      target_  = hold_;  // Gear is relative
+      travel_  = 0;
+      state_   = ECMC_AXIS_GEAR_ENGAGING;
+    } else {
+      engageCmd_ = false;
+    }
+  } else if (!engageCmd_ && ((state_ == ECMC_AXIS_GEAR_ENGAGED) ||
+                             (state_ == ECMC_AXIS_GEAR_ENGAGING))) {
+    travel_ = 0;
+    state_  = ECMC_AXIS_GEAR_DISENGAGING;
+  }
+
+  // Slave position in sync and d(slave)/d(master)
+  double slope = ratio_;
+  targetOld_ = target_;
+
+  if (lut_) {
+    double x = masterPos + phase_;
+
+    if (range > 0) {
+      x = fmod(x, range);
+      x = x < 0 ? x + range : x;
+    }
+    target_ = lut_->getValue(x, &lutInterval_, &slope);
+  } else {
+    target_ += ratio_ * (delta + phaseDelta);
+  }
+
+  // Blend over master travel (smoothstep)
+  travel_ += fabs(delta + phaseDelta);
+  double k = engageDist_ > 0 ? travel_ / engageDist_ : 1;
+  k = k > 1 ? 1 : k;
+  const double s  = k * k * (3 - 2 * k);
+  const double ds = engageDist_ > 0 ? 6 * k * (1 - k) / engageDist_ : 0;
+
+  switch (state_) {
+  case ECMC_AXIS_GEAR_ENGAGING:
+    out_   = hold_ + s * (target_ - hold_);
+    velFF_ = s * slope * masterVel + ds * (target_ - hold_) * fabs(masterVel);
+
+    if (k >= 1) {
+      state_ = ECMC_AXIS_GEAR_ENGAGED;
+    }
+    break;
+
+  case ECMC_AXIS_GEAR_ENGAGED:
+    out_   = target_;
+    velFF_ = slope * masterVel;
+    break;
+
+  case ECMC_AXIS_GEAR_DISENGAGING:
+    out_  += (1 - s) * (target_ - targetOld_);
+    velFF_ = (1 - s) * slope * masterVel;
+
+    if (k >= 1) {
+      state_ = ECMC_AXIS_GEAR_DISENGAGED;
+      velFF_ = 0;
+    }
+    break;
+
+  default:
+    velFF_ = 0;
+    break;
+  }
+
+  if (state_ != ECMC_AXIS_GEAR_DISENGAGED) {
+    slave_->setExtSetPos(out_);
+    slave_->setExtSetVel(velFF_);
+  }
+
+  for (int i = 0; i < ECMC_AXIS_GEAR_PAR_COUNT; i++) {
+    if (asynParams_[i]) {
+      asynParams_[i]->refreshParamRT(0);
+    }
+  }
+}
+
+void ecmcAxisGear::print() {
+  const char *stateStr[] = { "disengaged", "engaging", "engaged",
+                             "disengaging" };
+
+  printf("Gear " ECMC_AX_STR "%d (master " ECMC_AX_STR "%d %s):\n",
+         slave_->getAxisID(),
+         master_->getAxisID(),
+         masterSource_ == ECMC_AXIS_GEAR_SOURCE_ACTUAL ? "actual" : "setpoint");
+
+  if (lutIndex_ >= 0) {
+    printf("  cam lut %d%s\n", lutIndex_, lut_ ? "" : " (not validated)");
+  } else {
+    printf("  ratio %lg\n", ratio_);
+  }
+  printf("  engage distance %lg, phase %lg (target %lg, velocity %lg)\n",
+         engageDist_,
+         phase_,
+         phaseTarget_,
+         phaseVelo_);
+  printf("  state %s, position %lg, velocity %lg\n",
+         stateStr[state_],
+         out_,
+         velFF_);
+}
+
+int ecmcAxisGear::initAsyn() {
+  if (!asynPortDriver_) {
+    return 0;
+  }
+
+  struct {
+    const char    *name;
+    asynParamType  type;
+    ecmcEcDataType ecmcType;
+    uint8_t       *data;
+    size_t         bytes;
+  } pars[ECMC_AXIS_GEAR_PAR_COUNT] = {
+    { ECMC_AXIS_GEAR_STATE_STR, asynParamInt32,   ECMC_EC_S32, (uint8_t *)&state_, sizeof(state_) },
+    { ECMC_AXIS_GEAR_PHASE_STR, asynParamFloat64, ECMC_EC_F64, (uint8_t *)&phase_, sizeof(phase_) },
+    { ECMC_AXIS_GEAR_VELO_STR,  asynParamFloat64, ECMC_EC_F64, (uint8_t *)&velFF_, sizeof(velFF_) },
+  };
+
+  char name[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  for (int i = 0; i < ECMC_AXIS_GEAR_PAR_COUNT; i++) {
+    // "ax<index>.gear.<name>"
+    int chars = snprintf(name,
+                         sizeof(name),
+                         ECMC_AX_STR "%d." ECMC_AXIS_GEAR_STR ".%s",
+                         slave_->getAxisID(),
+                         pars[i].name);
+
+    if (chars >= (int)sizeof(name) - 1) {
+      return ERROR_AXIS_GEAR_ASYN_PARAM_FAIL;
+    }
+
+    ecmcAsynDataItem *paramTemp =
+      asynPortDriver_->addNewAvailParam(name,
+                                        pars[i].type,
+                                        pars[i].data,
+                                        pars[i].bytes,
+                                        pars[i].ecmcType,
+                                        0);
+
+    if (!paramTemp) {
+      LOGERR(
+        "%s/%s:%d: ERROR: Add create default parameter for %s failed (0x%x).\n",
+        __FILE__,
+        __FUNCTION__,
+        __LINE__,
+        name,
+        ERROR_AXIS_GEAR_ASYN_PARAM_FAIL);
+      return ERROR_AXIS_GEAR_ASYN_PARAM_FAIL;
+    }
+    paramTemp->setAllowWriteToEcmc(false);
+    paramTemp->refreshParam(1);
+    asynParams_[i] = paramTemp;
+  }
+  return 0;
+}
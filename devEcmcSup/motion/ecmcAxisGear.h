@@ -0,0 +1,130 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAxisGear.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Electronic gearing and camming of a slave axis to a master axis. The
+* master position (setpoint or actual) is mapped to the external trajectory
+* setpoint of the slave (the trajectory source of the slave must be set to
+* external). Executed in the execution order right after the master axis
+* and before the slave axis.
+*  - gear: slave += ratio * master delta (relative, handles modulo master)
+*  - cam:  slave = lut(master + phase), lut from Cfg.LoadLUT(). For modulo
+*          masters the lut index is wrapped to the modulo range.
+* Engage and disengage are synchronized to master travel: the slave is
+* blended in (smoothstep) from its position to the gear/cam position over
+* the engage distance, and the slave velocity is ramped out over the same
+* distance on disengage. The phase (master offset) is ramped with the
+* phase velocity (0 = step). The slave velocity (d(slave)/dt) is written
+* as external trajectory velocity (velocity feed forward). Disengaged if
+* the slave is disabled or the trajectory source is not external.
+*
+\*************************************************************************/
+
+#ifndef ECMC_AXIS_GEAR_H_
+#define ECMC_AXIS_GEAR_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ecmcError.h"
+#include "ecmcAxisBase.h"
+#include "ecmcAsynPortDriver.h"
+#include "ecmcLookupTable.h"
+
+#define ERROR_AXIS_GEAR_NULL 0x16200
+#define ERROR_AXIS_GEAR_MASTER_INVALID 0x16201
+#define ERROR_AXIS_GEAR_LUT_INVALID 0x16202
+#define ERROR_AXIS_GEAR_SOURCE_NOT_EXTERNAL 0x16203
+#define ERROR_AXIS_GEAR_ASYN_PARAM_FAIL 0x16204
+#define ERROR_AXIS_GEAR_MASTER_SOURCE_INVALID 0x16205
+#define ERROR_AXIS_GEAR_VALUE_OUT_OF_RANGE 0x16206
+
+#define ECMC_AXIS_GEAR_STR "gear"
+#define ECMC_AXIS_GEAR_STATE_STR "state"
+#define ECMC_AXIS_GEAR_PHASE_STR "phase"
+#define ECMC_AXIS_GEAR_VELO_STR "velff"
+
+enum ecmcAxisGearSource {
+  ECMC_AXIS_GEAR_SOURCE_SETPOINT = 0,
+  ECMC_AXIS_GEAR_SOURCE_ACTUAL   = 1,
+};
+
+enum ecmcAxisGearState {
+  ECMC_AXIS_GEAR_DISENGAGED  = 0,
+  ECMC_AXIS_GEAR_ENGAGING    = 1,
+  ECMC_AXIS_GEAR_ENGAGED     = 2,
+  ECMC_AXIS_GEAR_DISENGAGING = 3,
+};
+
+enum ecmcAxisGearPar {
+  ECMC_AXIS_GEAR_PAR_STATE = 0,
+  ECMC_AXIS_GEAR_PAR_PHASE,
+  ECMC_AXIS_GEAR_PAR_VELO,
+  ECMC_AXIS_GEAR_PAR_COUNT
+};
+
+class ecmcAxisGear : public ecmcError {
+public:
+  ecmcAxisGear(ecmcAxisBase       *slave,
+               ecmcAxisBase       *master,
+               int                 masterSource,
+               double              sampleTimeS,
+               ecmcAsynPortDriver *asynPortDriver);
+  ~ecmcAxisGear();
+
+  int           setRatio(double ratio);
+  int           setCamLUT(int lutIndex);  // -1 = gear
+  int           setEngageDist(double dist);
+  int           setPhase(double phase);
+  int           setPhaseVelo(double velo);
+  int           setEngage(bool engage);
+  int           getState();
+
+  // Lut is resolved here (luts are loaded)
+  int           validate();
+
+  // Rt, after master axis, before slave axis
+  void          execute();
+  void          print();
+  ecmcAxisBase* getMaster();
+
+private:
+  int           initAsyn();
+  bool          slaveReady();
+
+  ecmcAxisBase *slave_;
+  ecmcAxisBase *master_;
+  int masterSource_;
+  double sampleTimeS_;
+  ecmcAsynPortDriver *asynPortDriver_;
+  ecmcAsynDataItem *asynParams_[ECMC_AXIS_GEAR_PAR_COUNT];
+
+  // Cfg (engage, phase and ratio may change in runtime)
+  double ratio_;
+  int lutIndex_;
+  ecmcLookupTable<double, double> *lut_;
+  size_t lutInterval_;
+  double engageDist_;
+  double phaseTarget_;
+  double phaseVelo_;
+  bool engageCmd_;
+
+  // Rt
+  bool firstCycle_;
+  double masterPosOld_;
+  double phase_;
+  double target_;      // Slave position in sync
+  double targetOld_;
+  double hold_;        // Slave position at engage
+  double travel_;      // Master travel since engage/disengage
+  double out_;
+  double velFF_;
+  int32_t state_;
+};
+
+#endif  /* ECMC_AXIS_GEAR_H_ */
@@ -11,18 +11,21 @@
 \*************************************************************************/
 #include "ecmcAxisGroup.h"
 #include "ecmcErrorsList.h"
+#include "ecmcAxisGroupTransform.h"
+#include "ecmcAxisGroupCmd.h"
 
 ecmcAxisGroup::ecmcAxisGroup(int index, const char *name){
   name_ = name;
   axesCounter_ = 0;
   index_ = index;
   blocked_ = false;
-  axisInGroup_.assign(ECMC_MAX_AXES, false);
+  transform_ = NULL;
+  axisInGroup_.assign(ECMC_DEFAULT_AXES, false);
   printf("ecmcAxisGroup: Created axis group[%d] %s.\n", index_, name_.c_str());
 };
 
 ecmcAxisGroup::~ecmcAxisGroup(){
-
+  delete transform_;
 };
 
 const char* ecmcAxisGroup::getName(){
@@ -38,7 +41,11 @@ void ecmcAxisGroup::addAxis(ecmcAxisBase *axis){
   axes_.push_back(axis);
   const int axisId = axis->getAxisID();
   axesIds_.push_back(axisId);
-  if ((axisId >= 0) && (axisId < ECMC_MAX_AXES)) {
+  if (axisId >= 0) {
+    // Grow lookup if needed (configuration time)
+    if (axisId >= (int)axisInGroup_.size()) {
+      axisInGroup_.resize(axisId + 1, false);
+    }
     axisInGroup_[axisId] = true;
   }
   axesCounter_++;
@@ -186,9 +193,53 @@ void ecmcAxisGroup::halt(){
   }
 };
 
+// Stage move of all axes (applied by ecmcAxisGroupCmd::apply())
+int ecmcAxisGroup::stageMove(ecmcAxisGroupCmd *cmd,
+                             const double     *positions,
+                             size_t            count,
+                             bool              relative,
+                             double            velocity,
+                             double            acceleration,
+                             double            deceleration){
+  if (count != axes_.size()) {
+    return ERROR_AXIS_GROUP_CMD_COUNT_MISMATCH;
+  }
+
+  for (size_t i = 0; i < axes_.size(); i++) {
+    const int error = cmd->addMove(axes_[i], positions[i], relative,
+                                   velocity, acceleration, deceleration);
+    if (error) {
+      return error;
+    }
+  }
+  return 0;
+}
+
+// Stage stop of all axes
+int ecmcAxisGroup::stageStop(ecmcAxisGroupCmd *cmd){
+  for (auto *axis : axes_) {
+    const int error = cmd->addStop(axis);
+    if (error) {
+      return error;
+    }
+  }
+  return 0;
+}
+
+// Stage enable of all axes
+int ecmcAxisGroup::stageEnable(ecmcAxisGroupCmd *cmd, bool enable){
+  for (auto *axis : axes_) {
+    const int error = cmd->addEnable(axis, enable);
+    if (error) {
+      return error;
+    }
+  }
+  return 0;
+}
+
 // Check if axis is in group
 bool ecmcAxisGroup::inGroup(int axisIndex){
-  if ((axisIndex >= 0) && (axisIndex < ECMC_MAX_AXES)) {
+  if ((axisIndex >= 0) && (axisIndex < (int)axisInGroup_.size())) {
     return axisInGroup_[axisIndex];
   }
 
@@ -206,6 +257,22 @@ size_t ecmcAxisGroup::size(){
   return axesCounter_;
 }
 
+ecmcAxisBase* ecmcAxisGroup::getAxis(size_t index){
+  if (index >= axes_.size()) {
+    return NULL;
+  }
+  return axes_[index];
+}
+
+void ecmcAxisGroup::setTransform(ecmcAxisGroupTransform *transform){
+  delete transform_;
+  transform_ = transform;
+}
+
+ecmcAxisGroupTransform* ecmcAxisGroup::getTransform(){
+  return transform_;
+}
+
 ecmcAxisGroupStatusSummary ecmcAxisGroup::getStatusSummary(bool includeMonFields) {
   ecmcAxisGroupStatusSummary summary;
   const bool hasAxes = !axes_.empty();
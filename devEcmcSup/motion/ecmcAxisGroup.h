@@ -20,6 +20,9 @@
 #include <vector>
 #include <string>
 
+class ecmcAxisGroupTransform;
+class ecmcAxisGroupCmd;
+
 struct ecmcAxisGroupStatusSummary {
   bool allEnableCmd;
   bool anyEnableCmd;
@@ -101,10 +104,27 @@ class ecmcAxisGroup : public ecmcError {
     bool getBlocked();
     // Stop motion
     void halt();
+    // Stage move of all axes in one transaction (positions in axis order)
+    int stageMove(ecmcAxisGroupCmd *cmd,
+                  const double     *positions,
+                  size_t            count,
+                  bool              relative,
+                  double            velocity,
+                  double            acceleration,
+                  double            deceleration);
+    // Stage stop of all axes in one transaction
+    int stageStop(ecmcAxisGroupCmd *cmd);
+    // Stage enable of all axes in one transaction
+    int stageEnable(ecmcAxisGroupCmd *cmd, bool enable);
     // Check if axis is in group
     bool inGroup(int axisIndex);
     // Axis count in group
     size_t size();
+    // Axis in the order added (NULL if out of range)
+    ecmcAxisBase* getAxis(size_t index);
+    // Kinematic transform, group is the virtual side (owned by group)
+    void setTransform(ecmcAxisGroupTransform *transform);
+    ecmcAxisGroupTransform* getTransform();
     // Enable auto-enable functionality (if configured)
     void setEnableAutoEnable(bool enable);
     // Enable auto-disable functionality (if configured)
@@ -126,6 +146,7 @@ class ecmcAxisGroup : public ecmcError {
     std::vector<int> axesIds_;
     std::vector<bool> axisInGroup_;
     bool blocked_;
+    ecmcAxisGroupTransform *transform_;
 };
 
 #endif  /* ECMCAXISGROUP_H_ */
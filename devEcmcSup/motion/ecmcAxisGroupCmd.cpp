@@ -0,0 +1,210 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAxisGroupCmd.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcAxisGroupCmd.h"
+#include "ecmcErrorsList.h"
+
+ecmcAxisGroupCmd::ecmcAxisGroupCmd() {
+  items_.reserve(ECMC_AXIS_GROUP_CMD_DEFAULT_SIZE);
+}
+
+ecmcAxisGroupCmd::~ecmcAxisGroupCmd() {}
+
+void ecmcAxisGroupCmd::clear() {
+  items_.clear();
+}
+
+int ecmcAxisGroupCmd::add(const ecmcAxisGroupCmdItem& item) {
+  if (!item.axis) {
+    LOGERR("%s/%s:%d: ERROR: Axis NULL (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           ERROR_AXIS_GROUP_CMD_AXIS_NULL);
+    return ERROR_AXIS_GROUP_CMD_AXIS_NULL;
+  }
+  items_.push_back(item);
+  return 0;
+}
+
+int ecmcAxisGroupCmd::addMove(ecmcAxisBase *axis,
+                              double        position,
+                              bool          relative,
+                              double        velocity,
+                              double        acceleration,
+                              double        deceleration) {
+  ecmcAxisGroupCmdItem item = {};
+
+  item.axis         = axis;
+  item.type         = relative ? ECMC_AXIS_GROUP_CMD_MOVE_REL :
+                      ECMC_AXIS_GROUP_CMD_MOVE_ABS;
+  item.position     = position;
+  item.velocity     = velocity;
+  item.acceleration = acceleration;
+  item.deceleration = deceleration;
+  return add(item);
+}
+
+int ecmcAxisGroupCmd::addMoveVelo(ecmcAxisBase *axis,
+                                  double        velocity,
+                                  double        acceleration,
+                                  double        deceleration) {
+  ecmcAxisGroupCmdItem item = {};
+
+  item.axis         = axis;
+  item.type         = ECMC_AXIS_GROUP_CMD_MOVE_VELO;
+  item.velocity     = velocity;
+  item.acceleration = acceleration;
+  item.deceleration = deceleration;
+  return add(item);
+}
+
+int ecmcAxisGroupCmd::addStop(ecmcAxisBase *axis) {
+  ecmcAxisGroupCmdItem item = {};
+
+  item.axis = axis;
+  item.type = ECMC_AXIS_GROUP_CMD_STOP;
+  return add(item);
+}
+
+int ecmcAxisGroupCmd::addEnable(ecmcAxisBase *axis,
+                                bool          enable) {
+  ecmcAxisGroupCmdItem item = {};
+
+  item.axis   = axis;
+  item.type   = ECMC_AXIS_GROUP_CMD_ENABLE;
+  item.enable = enable;
+  return add(item);
+}
+
+int ecmcAxisGroupCmd::remove(ecmcAxisBase *axis) {
+  size_t kept = 0;
+
+  for (size_t i = 0; i < items_.size(); i++) {
+    if (items_[i].axis != axis) {
+      items_[kept++] = items_[i];
+    }
+  }
+
+  int removed = (int)(items_.size() - kept);
+  items_.resize(kept);
+  return removed;
+}
+
+size_t ecmcAxisGroupCmd::size() {
+  return items_.size();
+}
+
+ecmcAxisGroupCmdItem * ecmcAxisGroupCmd::getItem(size_t index) {
+  if (index >= items_.size()) {
+    return NULL;
+  }
+  return &items_[index];
+}
+
+int ecmcAxisGroupCmd::validate(ecmcAxisGroupCmdItem *item) {
+  ecmcAxisBase *axis = item->axis;
+
+  switch (item->type) {
+  case ECMC_AXIS_GROUP_CMD_MOVE_ABS:
+  case ECMC_AXIS_GROUP_CMD_MOVE_REL:
+  case ECMC_AXIS_GROUP_CMD_MOVE_VELO:
+    if (axis->getBlockCom()) {
+      axis->setExternalCommandBlockedError();
+      return ERROR_AXIS_GROUP_CMD_COM_BLOCKED;
+    }
+
+    // Only one group can accept commands at a time (master/slave)
+    if (axis->getBlocked()) {
+      return ERROR_AXIS_BLOCKED;
+    }
+    return 0;
+
+  case ECMC_AXIS_GROUP_CMD_ENABLE:
+    if (item->enable && axis->getBlockCom()) {
+      axis->setExternalCommandBlockedError();
+      return ERROR_AXIS_GROUP_CMD_COM_BLOCKED;
+    }
+    return 0;
+
+  case ECMC_AXIS_GROUP_CMD_STOP:
+    return 0;
+  }
+  return ERROR_AXIS_GROUP_CMD_TYPE_INVALID;
+}
+
+int ecmcAxisGroupCmd::apply() {
+  int firstError = 0;
+
+  // All or nothing
+  for (auto& item : items_) {
+    item.errorCode = validate(&item);
+
+    if (item.errorCode && !firstError) {
+      firstError = item.errorCode;
+      LOGERR("%s/%s:%d: ERROR: Axis[%d]: Command rejected (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             item.axis->getAxisID(),
+             item.errorCode);
+    }
+  }
+
+  if (firstError) {
+    for (auto& item : items_) {
+      if (!item.errorCode) {
+        item.errorCode = ERROR_AXIS_GROUP_CMD_REJECTED;
+      }
+    }
+    return firstError;
+  }
+
+  for (auto& item : items_) {
+    ecmcAxisBase *axis = item.axis;
+
+    switch (item.type) {
+    case ECMC_AXIS_GROUP_CMD_MOVE_ABS:
+      item.errorCode = axis->moveAbsolutePosition(item.position,
+                                                  item.velocity,
+                                                  item.acceleration,
+                                                  item.deceleration);
+      break;
+
+    case ECMC_AXIS_GROUP_CMD_MOVE_REL:
+      item.errorCode = axis->moveRelativePosition(item.position,
+                                                  item.velocity,
+                                                  item.acceleration,
+                                                  item.deceleration);
+      break;
+
+    case ECMC_AXIS_GROUP_CMD_MOVE_VELO:
+      item.errorCode = axis->moveVelocity(item.velocity,
+                                          item.acceleration,
+                                          item.deceleration);
+      break;
+
+    case ECMC_AXIS_GROUP_CMD_STOP:
+      item.errorCode = axis->stopMotion(0);
+      break;
+
+    case ECMC_AXIS_GROUP_CMD_ENABLE:
+      item.errorCode = axis->setEnable(item.enable);
+      break;
+    }
+
+    if (item.errorCode && !firstError) {
+      firstError = item.errorCode;
+    }
+  }
+  return firstError;
+}
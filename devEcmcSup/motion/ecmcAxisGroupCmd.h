@@ -0,0 +1,91 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAxisGroupCmd.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Staged motion command transaction for many axes. Move, stop and enable
+* requests are collected (non rt, no locking) and then applied in one pass
+* by apply(), with the rt mutex held by the caller. Since the rt thread is
+* blocked during apply() all commands of the transaction are seen by the
+* axes in the same cycle, with one lock handoff instead of one per axis.
+* All items are validated before any item is applied: if an axis blocks
+* communication or is blocked (master/slave) nothing is applied.
+*
+\*************************************************************************/
+
+#ifndef ECMC_AXIS_GROUP_CMD_H_
+#define ECMC_AXIS_GROUP_CMD_H_
+
+#include <stddef.h>
+#include <vector>
+#include "ecmcAxisBase.h"
+
+#define ERROR_AXIS_GROUP_CMD_AXIS_NULL 0x16300
+#define ERROR_AXIS_GROUP_CMD_TYPE_INVALID 0x16301
+#define ERROR_AXIS_GROUP_CMD_COUNT_MISMATCH 0x16302
+#define ERROR_AXIS_GROUP_CMD_COM_BLOCKED 0x16303
+#define ERROR_AXIS_GROUP_CMD_REJECTED 0x16304
+
+#define ECMC_AXIS_GROUP_CMD_DEFAULT_SIZE 64
+
+enum ecmcAxisGroupCmdType {
+  ECMC_AXIS_GROUP_CMD_MOVE_ABS  = 0,
+  ECMC_AXIS_GROUP_CMD_MOVE_REL  = 1,
+  ECMC_AXIS_GROUP_CMD_MOVE_VELO = 2,
+  ECMC_AXIS_GROUP_CMD_STOP      = 3,
+  ECMC_AXIS_GROUP_CMD_ENABLE    = 4,
+};
+
+struct ecmcAxisGroupCmdItem {
+  ecmcAxisBase *axis;
+  int           type;
+  double        position;
+  double        velocity;
+  double        acceleration;
+  double        deceleration;
+  bool          enable;
+  int           errorCode;  // Result of apply()
+};
+
+class ecmcAxisGroupCmd {
+public:
+  ecmcAxisGroupCmd();
+  ~ecmcAxisGroupCmd();
+
+  // Staging (non rt)
+  void                  clear();
+  int                   addMove(ecmcAxisBase *axis,
+                                double        position,
+                                bool          relative,
+                                double        velocity,
+                                double        acceleration,
+                                double        deceleration);
+  int                   addMoveVelo(ecmcAxisBase *axis,
+                                    double        velocity,
+                                    double        acceleration,
+                                    double        deceleration);
+  int                   addStop(ecmcAxisBase *axis);
+  int                   addEnable(ecmcAxisBase *axis,
+                                  bool          enable);
+
+  // Remove staged items of axis (returns removed count)
+  int                   remove(ecmcAxisBase *axis);
+  size_t                size();
+  ecmcAxisGroupCmdItem* getItem(size_t index);
+
+  // Apply all items, rt mutex held by caller. Returns first error or 0.
+  int                   apply();
+
+private:
+  int                   add(const ecmcAxisGroupCmdItem& item);
+  int                   validate(ecmcAxisGroupCmdItem *item);
+
+  std::vector<ecmcAxisGroupCmdItem> items_;
+};
+
+#endif  /* ECMC_AXIS_GROUP_CMD_H_ */
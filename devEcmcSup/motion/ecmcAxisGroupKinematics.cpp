@@ -0,0 +1,390 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAxisGroupKinematics.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcAxisGroupKinematics.h"
+#include <math.h>
+#include <string.h>
+
+/* Solve m * y = v (n x n, row major) with partial pivoting.
+ * m is destroyed and v is replaced by y. Returns false if singular.
+ */
+static bool solveLinear(int n, double *m, double *v) {
+  for (int c = 0; c < n; c++) {
+    int    pivot = c;
+    double best  = fabs(m[c * n + c]);
+
+    for (int r = c + 1; r < n; r++) {
+      if (fabs(m[r * n + c]) > best) {
+        best  = fabs(m[r * n + c]);
+        pivot = r;
+      }
+    }
+
+    if (best < 1e-12) {
+      return false;
+    }
+
+    if (pivot != c) {
+      for (int k = 0; k < n; k++) {
+        double temp = m[c * n + k];
+        m[c * n + k]     = m[pivot * n + k];
+        m[pivot * n + k] = temp;
+      }
+      double temp = v[c];
+      v[c]     = v[pivot];
+      v[pivot] = temp;
+    }
+
+    for (int r = c + 1; r < n; r++) {
+      double f = m[r * n + c] / m[c * n + c];
+
+      for (int k = c; k < n; k++) {
+        m[r * n + k] -= f * m[c * n + k];
+      }
+      v[r] -= f * v[c];
+    }
+  }
+
+  for (int r = n - 1; r >= 0; r--) {
+    double sum = v[r];
+
+    for (int k = r + 1; k < n; k++) {
+      sum -= m[r * n + k] * v[k];
+    }
+    v[r] = sum / m[r * n + r];
+  }
+  return true;
+}
+
+ecmcAxisGroupKinematics::ecmcAxisGroupKinematics(int type) {
+  type_          = type;
+  dof_           = 0;
+  paramCount_    = 0;
+  maxIterations_ = ECMC_GRP_TRANSFORM_DEFAULT_MAX_ITER;
+  tolerance_     = ECMC_GRP_TRANSFORM_DEFAULT_TOL;
+  iterations_    = 0;
+  residual_      = 0;
+  failCount_     = 0;
+
+  // Angle unit default 1 rad
+  if (type_ == ECMC_GRP_TRANSFORM_TRIPOD) {
+    params_.assign(13, 0);
+    params_[12] = 1;
+  } else if (type_ == ECMC_GRP_TRANSFORM_HEXAPOD) {
+    params_.assign(40, 0);
+    params_[39] = 1;
+  }
+}
+
+ecmcAxisGroupKinematics::~ecmcAxisGroupKinematics() {}
+
+bool ecmcAxisGroupKinematics::isTypeValid() {
+  return type_ >= ECMC_GRP_TRANSFORM_LINEAR &&
+         type_ <= ECMC_GRP_TRANSFORM_HEXAPOD;
+}
+
+int ecmcAxisGroupKinematics::getType() {
+  return type_;
+}
+
+int ecmcAxisGroupKinematics::setParam(int index, double value) {
+  if (index < 0) {
+    return ERROR_GRP_TRANSFORM_PARAM_INDEX_OUT_OF_RANGE;
+  }
+
+  if (index >= (int)params_.size()) {
+    params_.resize(index + 1, 0);
+  }
+  params_[index] = value;
+
+  if (index >= paramCount_) {
+    paramCount_ = index + 1;
+  }
+  return 0;
+}
+
+double ecmcAxisGroupKinematics::getParam(int index) {
+  if ((index < 0) || (index >= (int)params_.size())) {
+    return 0;
+  }
+  return params_[index];
+}
+
+int ecmcAxisGroupKinematics::getParamCount() {
+  return paramCount_;
+}
+
+int ecmcAxisGroupKinematics::getRequiredParamCount() {
+  switch (type_) {
+  case ECMC_GRP_TRANSFORM_LINEAR:
+    return dof_ * dof_;
+
+  case ECMC_GRP_TRANSFORM_TRIPOD:
+    return 9;
+
+  case ECMC_GRP_TRANSFORM_HEXAPOD:
+    return 36;
+  }
+  return 0;
+}
+
+int ecmcAxisGroupKinematics::setSolver(int maxIterations, double tolerance) {
+  if ((maxIterations < 1) || (tolerance <= 0)) {
+    return ERROR_GRP_TRANSFORM_SOLVER_INVALID;
+  }
+  maxIterations_ = maxIterations;
+  tolerance_     = tolerance;
+  return 0;
+}
+
+int ecmcAxisGroupKinematics::getMaxIterations() {
+  return maxIterations_;
+}
+
+double ecmcAxisGroupKinematics::getTolerance() {
+  return tolerance_;
+}
+
+int ecmcAxisGroupKinematics::init(int dof) {
+  if (!isTypeValid()) {
+    return ERROR_GRP_TRANSFORM_TYPE_INVALID;
+  }
+
+  if ((dof < 1) ||
+      ((type_ == ECMC_GRP_TRANSFORM_GAP_CENTER) && (dof != 2)) ||
+      ((type_ == ECMC_GRP_TRANSFORM_TRIPOD) && (dof != 3)) ||
+      ((type_ == ECMC_GRP_TRANSFORM_HEXAPOD) && (dof != 6))) {
+    return ERROR_GRP_TRANSFORM_DOF_MISMATCH;
+  }
+  dof_ = dof;
+
+  // Linear offset b is optional
+  if ((int)params_.size() < dof_ * dof_ + dof_) {
+    params_.resize(dof_ * dof_ + dof_, 0);
+  }
+  a_.assign(dof_ * dof_, 0);
+  aInv_.assign(dof_ * dof_, 0);
+  b_.assign(dof_, 0);
+  legHome_.assign(dof_, 0);
+  xLast_.assign(dof_, 0);
+  qx_.assign(dof_, 0);
+  qh_.assign(dof_, 0);
+  xh_.assign(dof_, 0);
+  jac_.assign(dof_ * dof_, 0);
+
+  if (paramCount_ < getRequiredParamCount()) {
+    return ERROR_GRP_TRANSFORM_PARAMS_MISSING;
+  }
+
+  if (type_ == ECMC_GRP_TRANSFORM_GAP_CENTER) {
+    const double gapCenter[4] = { 0.5, 1, -0.5, 1 };
+    a_.assign(gapCenter, gapCenter + 4);
+  } else if (type_ == ECMC_GRP_TRANSFORM_LINEAR) {
+    a_.assign(params_.begin(), params_.begin() + dof_ * dof_);
+    b_.assign(params_.begin() + dof_ * dof_,
+              params_.begin() + dof_ * dof_ + dof_);
+  }
+
+  if ((type_ == ECMC_GRP_TRANSFORM_GAP_CENTER) ||
+      (type_ == ECMC_GRP_TRANSFORM_LINEAR)) {
+    // Columns of the inverse
+    for (int c = 0; c < dof_; c++) {
+      std::vector<double> m(a_);
+      std::vector<double> v(dof_, 0);
+      v[c] = 1;
+
+      if (!solveLinear(dof_, m.data(), v.data())) {
+        return ERROR_GRP_TRANSFORM_SINGULAR;
+      }
+
+      for (int r = 0; r < dof_; r++) {
+        aInv_[r * dof_ + c] = v[r];
+      }
+    }
+  }
+
+  if (type_ == ECMC_GRP_TRANSFORM_HEXAPOD) {
+    for (int i = 0; i < 6; i++) {
+      const double *a = &params_[i * 3];
+      const double *b = &params_[18 + i * 3];
+      legHome_[i] = sqrt((a[0] - b[0]) * (a[0] - b[0]) +
+                         (a[1] - b[1]) * (a[1] - b[1]) +
+                         (a[2] - b[2]) * (a[2] - b[2]));
+    }
+  }
+
+  return 0;
+}
+
+int ecmcAxisGroupKinematics::getDof() {
+  return dof_;
+}
+
+void ecmcAxisGroupKinematics::parallelInverse(const double *x, double *q) {
+  const bool    tripod = type_ == ECMC_GRP_TRANSFORM_TRIPOD;
+  const double *pivot  = tripod ? &params_[9] : &params_[36];
+  const double  unit   = tripod ? params_[12] : params_[39];
+  double t[3], r[3];
+
+  if (tripod) {
+    t[0] = 0;
+    t[1] = 0;
+    t[2] = x[0];
+    r[0] = x[1] * unit;
+    r[1] = x[2] * unit;
+    r[2] = 0;
+  } else {
+    t[0] = x[0];
+    t[1] = x[1];
+    t[2] = x[2];
+    r[0] = x[3] * unit;
+    r[1] = x[4] * unit;
+    r[2] = x[5] * unit;
+  }
+
+  // R = Rz * Ry * Rx
+  const double cx = cos(r[0]), sx = sin(r[0]);
+  const double cy = cos(r[1]), sy = sin(r[1]);
+  const double cz = cos(r[2]), sz = sin(r[2]);
+  const double rot[9] = {
+    cz * cy, cz * sy * sx - sz * cx, cz * sy * cx + sz * sx,
+    sz * cy, sz * sy * sx + cz * cx, sz * sy * cx - cz * sx,
+    -sy,     cy * sx,                cy * cx
+  };
+
+  for (int i = 0; i < dof_; i++) {
+    const double *a = &params_[i * 3];
+    double d[3] = { a[0] - pivot[0], a[1] - pivot[1], a[2] - pivot[2] };
+    double p[3];
+
+    for (int k = 0; k < 3; k++) {
+      p[k] = t[k] + pivot[k] +
+             rot[k * 3] * d[0] + rot[k * 3 + 1] * d[1] + rot[k * 3 + 2] * d[2];
+    }
+
+    if (tripod) {
+      q[i] = p[2] - a[2];
+    } else {
+      const double *b = &params_[18 + i * 3];
+      q[i] = sqrt((p[0] - b[0]) * (p[0] - b[0]) +
+                  (p[1] - b[1]) * (p[1] - b[1]) +
+                  (p[2] - b[2]) * (p[2] - b[2])) - legHome_[i];
+    }
+  }
+}
+
+void ecmcAxisGroupKinematics::parallelForward(const double *q, double *x) {
+  double *qx  = qx_.data();
+  double *qh  = qh_.data();
+  double *xh  = xh_.data();
+  double *jac = jac_.data();
+  int     iter = 0;
+
+  // Warm start
+  memcpy(x, xLast_.data(), dof_ * sizeof(double));
+
+  for (;;) {
+    parallelInverse(x, qx);
+    double maxRes = 0;
+
+    for (int i = 0; i < dof_; i++) {
+      qx[i] -= q[i];
+
+      if (fabs(qx[i]) > maxRes) {
+        maxRes = fabs(qx[i]);
+      }
+    }
+    residual_ = maxRes;
+
+    if (maxRes <= tolerance_) {
+      break;
+    }
+
+    if (iter >= maxIterations_) {
+      failCount_++;
+      break;
+    }
+
+    // Numerical jacobian dq/dx
+    memcpy(xh, x, dof_ * sizeof(double));
+
+    for (int c = 0; c < dof_; c++) {
+      xh[c] += ECMC_GRP_TRANSFORM_JACOBIAN_STEP;
+      parallelInverse(xh, qh);
+      xh[c] = x[c];
+
+      for (int r = 0; r < dof_; r++) {
+        jac[r * dof_ + c] = (qh[r] - q[r] - qx[r]) /
+                            ECMC_GRP_TRANSFORM_JACOBIAN_STEP;
+      }
+    }
+
+    if (!solveLinear(dof_, jac, qx)) {
+      failCount_++;
+      break;
+    }
+
+    for (int i = 0; i < dof_; i++) {
+      x[i] -= qx[i];
+    }
+    iter++;
+  }
+
+  iterations_ = iter;
+  memcpy(xLast_.data(), x, dof_ * sizeof(double));
+}
+
+void ecmcAxisGroupKinematics::inverse(const double *x, double *q) {
+  if ((type_ == ECMC_GRP_TRANSFORM_TRIPOD) ||
+      (type_ == ECMC_GRP_TRANSFORM_HEXAPOD)) {
+    parallelInverse(x, q);
+    return;
+  }
+
+  for (int r = 0; r < dof_; r++) {
+    double sum = b_[r];
+
+    for (int c = 0; c < dof_; c++) {
+      sum += a_[r * dof_ + c] * x[c];
+    }
+    q[r] = sum;
+  }
+}
+
+void ecmcAxisGroupKinematics::forward(const double *q, double *x) {
+  if ((type_ == ECMC_GRP_TRANSFORM_TRIPOD) ||
+      (type_ == ECMC_GRP_TRANSFORM_HEXAPOD)) {
+    parallelForward(q, x);
+    return;
+  }
+
+  for (int r = 0; r < dof_; r++) {
+    double sum = 0;
+
+    for (int c = 0; c < dof_; c++) {
+      sum += aInv_[r * dof_ + c] * (q[c] - b_[c]);
+    }
+    x[r] = sum;
+  }
+}
+
+int ecmcAxisGroupKinematics::getIterations() {
+  return iterations_;
+}
+
+double ecmcAxisGroupKinematics::getResidual() {
+  return residual_;
+}
+
+int ecmcAxisGroupKinematics::getFailCount() {
+  return failCount_;
+}
@@ -0,0 +1,106 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAxisGroupKinematics.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Math of the axis group transforms (see ecmcAxisGroupTransform.h for the
+* types and parameter layouts), without axes or asyn:
+*  - inverse: coordinates x -> joints q
+*  - forward: joints q -> coordinates x (closed form for linear and
+*             gap/center, Newton iterations warm started from the last
+*             solution for tripod and hexapod)
+*
+\*************************************************************************/
+
+#ifndef ECMC_AXIS_GROUP_KINEMATICS_H_
+#define ECMC_AXIS_GROUP_KINEMATICS_H_
+
+#include <stdint.h>
+#include <vector>
+
+#define ERROR_GRP_TRANSFORM_TYPE_INVALID 0x16100
+#define ERROR_GRP_TRANSFORM_DOF_MISMATCH 0x16101
+#define ERROR_GRP_TRANSFORM_PARAM_INDEX_OUT_OF_RANGE 0x16102
+#define ERROR_GRP_TRANSFORM_PARAMS_MISSING 0x16103
+#define ERROR_GRP_TRANSFORM_SINGULAR 0x16104
+#define ERROR_GRP_TRANSFORM_SOLVER_INVALID 0x16108
+
+#define ECMC_GRP_TRANSFORM_DEFAULT_MAX_ITER 10
+#define ECMC_GRP_TRANSFORM_DEFAULT_TOL 1e-6
+#define ECMC_GRP_TRANSFORM_JACOBIAN_STEP 1e-6
+
+enum ecmcGrpTransformType {
+  ECMC_GRP_TRANSFORM_LINEAR     = 1,
+  ECMC_GRP_TRANSFORM_GAP_CENTER = 2,
+  ECMC_GRP_TRANSFORM_TRIPOD     = 3,
+  ECMC_GRP_TRANSFORM_HEXAPOD    = 4,
+};
+
+class ecmcAxisGroupKinematics {
+public:
+  explicit ecmcAxisGroupKinematics(int type);
+  ~ecmcAxisGroupKinematics();
+
+  bool   isTypeValid();
+  int    getType();
+  int    setParam(int    index,
+                  double value);
+  double getParam(int index);
+  int    getParamCount();          // Highest set index + 1
+  int    getRequiredParamCount();  // Valid after init()
+  int    setSolver(int    maxIterations,
+                   double tolerance);
+  int    getMaxIterations();
+  double getTolerance();
+
+  // Check axis count and params, allocate buffers. Returns 0 or error code.
+  int    init(int dof);
+  int    getDof();
+
+  // Rt (after init())
+  void   inverse(const double *x,
+                 double       *q);
+  void   forward(const double *q,
+                 double       *x);
+
+  // Diagnostics of the last forward()
+  int    getIterations();
+  double getResidual();
+  int    getFailCount();
+
+private:
+  void   parallelInverse(const double *x,
+                         double       *q);
+  void   parallelForward(const double *q,
+                         double       *x);
+
+  int type_;
+  int dof_;
+  std::vector<double> params_;  // Grows with highest set index
+  int paramCount_;              // Highest set index + 1
+
+  // Linear: q = A * x + b, x = Ainv * (q - b)
+  std::vector<double> a_;
+  std::vector<double> aInv_;
+  std::vector<double> b_;
+
+  // Parallel: home leg lengths (hexapod), solution of last cycle
+  std::vector<double> legHome_;
+  std::vector<double> xLast_;
+
+  // Work buffers of the rt functions
+  std::vector<double> qx_, qh_, xh_, jac_;
+  int maxIterations_;
+  double tolerance_;
+
+  int iterations_;
+  double residual_;
+  int failCount_;
+};
+
+#endif  /* ECMC_AXIS_GROUP_KINEMATICS_H_ */
@@ -0,0 +1,279 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAxisGroupTransform.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcAxisGroupTransform.h"
+#include "ecmcAxisGroup.h"
+#include <string.h>
+#include <time.h>
+
+static inline int64_t transformTimeNs() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+ecmcAxisGroupTransform::ecmcAxisGroupTransform(int                 type,
+                                               ecmcAxisGroup      *virtGrp,
+                                               ecmcAxisGroup      *realGrp,
+                                               int                 grpIndex,
+                                               ecmcAsynPortDriver *asynPortDriver)
+  : kinematics_(type) {
+  errorReset();
+  virtGrp_        = virtGrp;
+  realGrp_        = realGrp;
+  grpIndex_       = grpIndex;
+  asynPortDriver_ = asynPortDriver;
+  dof_            = 0;
+  fwdTimeNs_      = 0;
+  exeTimeNs_      = 0;
+  exeTimeMaxNs_   = 0;
+  iterations_     = 0;
+  residual_       = 0;
+  failCount_      = 0;
+  memset(asynParams_, 0, sizeof(asynParams_));
+
+  if (!kinematics_.isTypeValid()) {
+    setErrorID(__FILE__, __FUNCTION__, __LINE__,
+               ERROR_GRP_TRANSFORM_TYPE_INVALID);
+    return;
+  }
+
+  int errorCode = initAsyn();
+
+  if (errorCode) {
+    setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+}
+
+ecmcAxisGroupTransform::~ecmcAxisGroupTransform() {}
+
+int ecmcAxisGroupTransform::setParam(int index, double value) {
+  int errorCode = kinematics_.setParam(index, value);
+
+  if (errorCode) {
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+  return 0;
+}
+
+int ecmcAxisGroupTransform::setSolver(int maxIterations, double tolerance) {
+  int errorCode = kinematics_.setSolver(maxIterations, tolerance);
+
+  if (errorCode) {
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+  return 0;
+}
+
+int ecmcAxisGroupTransform::validate() {
+  int count = (int)virtGrp_->size();
+  int errorCode = count == (int)realGrp_->size() ?
+                  kinematics_.init(count) : ERROR_GRP_TRANSFORM_DOF_MISMATCH;
+
+  if (errorCode == ERROR_GRP_TRANSFORM_DOF_MISMATCH) {
+    LOGERR("%s/%s:%d: ERROR: Transform %s: Wrong axis count %d/%zu (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           virtGrp_->getName(),
+           count,
+           realGrp_->size(),
+           ERROR_GRP_TRANSFORM_DOF_MISMATCH);
+  } else if (errorCode == ERROR_GRP_TRANSFORM_PARAMS_MISSING) {
+    LOGERR("%s/%s:%d: ERROR: Transform %s: %d params set, %d needed (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           virtGrp_->getName(),
+           kinematics_.getParamCount(),
+           kinematics_.getRequiredParamCount(),
+           ERROR_GRP_TRANSFORM_PARAMS_MISSING);
+  }
+
+  if (errorCode) {
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+
+  dof_ = count;
+  virtAxes_.assign(dof_, NULL);
+  realAxes_.assign(dof_, NULL);
+  x_.assign(dof_, 0);
+  q_.assign(dof_, 0);
+
+  for (int i = 0; i < dof_; i++) {
+    virtAxes_[i] = virtGrp_->getAxis(i);
+    realAxes_[i] = realGrp_->getAxis(i);
+  }
+  return 0;
+}
+
+void ecmcAxisGroupTransform::executeForward() {
+  const int64_t startNs = transformTimeNs();
+  double *q = q_.data();
+  double *x = x_.data();
+
+  for (int i = 0; i < dof_; i++) {
+    realAxes_[i]->getPosAct(&q[i]);
+  }
+
+  kinematics_.forward(q, x);
+  iterations_ = kinematics_.getIterations();
+  residual_   = kinematics_.getResidual();
+  failCount_  = kinematics_.getFailCount();
+
+  for (int i = 0; i < dof_; i++) {
+    virtAxes_[i]->setExtActPos(x[i]);
+  }
+  fwdTimeNs_ = (int32_t)(transformTimeNs() - startNs);
+}
+
+void ecmcAxisGroupTransform::executeInverse() {
+  const int64_t startNs = transformTimeNs();
+  double *x = x_.data();
+  double *q = q_.data();
+
+  for (int i = 0; i < dof_; i++) {
+    virtAxes_[i]->getPosSet(&x[i]);
+  }
+
+  kinematics_.inverse(x, q);
+
+  for (int i = 0; i < dof_; i++) {
+    realAxes_[i]->setExtSetPos(q[i]);
+  }
+
+  exeTimeNs_ = fwdTimeNs_ + (int32_t)(transformTimeNs() - startNs);
+
+  if (exeTimeNs_ > exeTimeMaxNs_) {
+    exeTimeMaxNs_ = exeTimeNs_;
+  }
+
+  for (int i = 0; i < ECMC_GRP_TRANSFORM_PAR_COUNT; i++) {
+    if (asynParams_[i] && (asynParams_[i]->refreshParamRT(0) == 0) &&
+        (i == ECMC_GRP_TRANSFORM_PAR_EXE_TIME_MAX)) {
+      // Max reset after successful write
+      exeTimeMaxNs_ = 0;
+    }
+  }
+}
+
+ecmcAxisGroup * ecmcAxisGroupTransform::getVirtGrp() {
+  return virtGrp_;
+}
+
+ecmcAxisGroup * ecmcAxisGroupTransform::getRealGrp() {
+  return realGrp_;
+}
+
+void ecmcAxisGroupTransform::print() {
+  const char *typeStr = "linear";
+  int         type    = kinematics_.getType();
+
+  if (type == ECMC_GRP_TRANSFORM_GAP_CENTER) {
+    typeStr = "gap/center";
+  } else if (type == ECMC_GRP_TRANSFORM_TRIPOD) {
+    typeStr = "tripod";
+  } else if (type == ECMC_GRP_TRANSFORM_HEXAPOD) {
+    typeStr = "hexapod";
+  }
+
+  printf("Transform " ECMC_GRP_STR "%d (%s -> %s), type %s:\n",
+         grpIndex_,
+         virtGrp_->getName(),
+         realGrp_->getName(),
+         typeStr);
+  printf("  axes (virtual -> real):");
+
+  for (int i = 0; i < dof_; i++) {
+    printf(" %d->%d",
+           virtAxes_[i]->getAxisID(),
+           realAxes_[i]->getAxisID());
+  }
+  printf("%s\n", dof_ ? "" : " (not validated)");
+  printf("  params (%d):", kinematics_.getParamCount());
+
+  for (int i = 0; i < kinematics_.getParamCount(); i++) {
+    printf(" %lg", kinematics_.getParam(i));
+  }
+  printf("\n");
+  printf("  solver: max iterations %d, tolerance %lg\n",
+         kinematics_.getMaxIterations(),
+         kinematics_.getTolerance());
+  printf("  exe time %dns, iterations %d, residual %lg, fail count %d\n",
+         exeTimeNs_,
+         iterations_,
+         residual_,
+         failCount_);
+}
+
+int ecmcAxisGroupTransform::initAsyn() {
+  if (!asynPortDriver_) {
+    return 0;
+  }
+
+  struct {
+    const char    *name;
+    asynParamType  type;
+    ecmcEcDataType ecmcType;
+    uint8_t       *data;
+    size_t         bytes;
+  } pars[ECMC_GRP_TRANSFORM_PAR_COUNT] = {
+    { ECMC_GRP_TRANSFORM_EXE_TIME_STR,     asynParamInt32,   ECMC_EC_S32, (uint8_t *)&exeTimeNs_,    sizeof(exeTimeNs_)    },
+    { ECMC_GRP_TRANSFORM_EXE_TIME_MAX_STR, asynParamInt32,   ECMC_EC_S32, (uint8_t *)&exeTimeMaxNs_, sizeof(exeTimeMaxNs_) },
+    { ECMC_GRP_TRANSFORM_ITER_STR,         asynParamInt32,   ECMC_EC_S32, (uint8_t *)&iterations_,   sizeof(iterations_)   },
+    { ECMC_GRP_TRANSFORM_RESIDUAL_STR,     asynParamFloat64, ECMC_EC_F64, (uint8_t *)&residual_,     sizeof(residual_)     },
+    { ECMC_GRP_TRANSFORM_FAIL_STR,         asynParamInt32,   ECMC_EC_S32, (uint8_t *)&failCount_,    sizeof(failCount_)    },
+  };
+
+  char name[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  for (int i = 0; i < ECMC_GRP_TRANSFORM_PAR_COUNT; i++) {
+    // "grp<index>.transform.<name>"
+    int chars = snprintf(name,
+                         sizeof(name),
+                         ECMC_GRP_STR "%d." ECMC_GRP_TRANSFORM_STR ".%s",
+                         grpIndex_,
+                         pars[i].name);
+
+    if (chars >= (int)sizeof(name) - 1) {
+      return ERROR_GRP_TRANSFORM_ASYN_PARAM_FAIL;
+    }
+
+    ecmcAsynDataItem *paramTemp =
+      asynPortDriver_->addNewAvailParam(name,
+                                        pars[i].type,
+                                        pars[i].data,
+                                        pars[i].bytes,
+                                        pars[i].ecmcType,
+                                        0);
+
+    if (!paramTemp) {
+      LOGERR(
+        "%s/%s:%d: ERROR: Add create default parameter for %s failed (0x%x).\n",
+        __FILE__,
+        __FUNCTION__,
+        __LINE__,
+        name,
+        ERROR_GRP_TRANSFORM_ASYN_PARAM_FAIL);
+      return ERROR_GRP_TRANSFORM_ASYN_PARAM_FAIL;
+    }
+    paramTemp->setAllowWriteToEcmc(false);
+
+    if (i == ECMC_GRP_TRANSFORM_PAR_EXE_TIME_MAX) {
+      paramTemp->setAllowScheduler(false);  // Max reset when refreshed
+    }
+    paramTemp->refreshParam(1);
+    asynParams_[i] = paramTemp;
+  }
+  return 0;
+}
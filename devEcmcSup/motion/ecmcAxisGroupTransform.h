@@ -0,0 +1,123 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcAxisGroupTransform.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Kinematic transform between a group of virtual axes (coordinates x) and
+* a group of real axes (joints q), attached to the virtual group. Axes are
+* used in the order they were added to the groups.
+*  - forward: actual positions of the real axes -> external encoder
+*             position of the virtual axes
+*  - inverse: setpoints of the virtual axes -> external trajectory
+*             setpoint of the real axes
+* The sources of the axes must be set to external (like when the same is
+* done in plc code).
+*
+* Types:
+*  - linear:     q = A * x + b (n axes). Params: A row major (n*n), b (n).
+*  - gap/center: x = [gap, center], q = [center + gap/2, center - gap/2].
+*  - tripod:     three vertical jacks, x = [z, rx, ry]. q is the vertical
+*                displacement of the jack anchors from home. Params:
+*                anchors a1..a3 (9), pivot (3), angle unit (1).
+*  - hexapod:    six legs, x = [x, y, z, rx, ry, rz]. q is the leg length
+*                minus the length at home. Params: platform anchors
+*                a1..a6 at home (18), base anchors b1..b6 (18), pivot (3),
+*                angle unit (1).
+* For tripod and hexapod the anchors are moved by p = t + pivot +
+* R * (a - pivot), R = Rz * Ry * Rx. Angles are in the unit of the virtual
+* axes times the angle unit [rad] (default 1). The forward transform is
+* solved with Newton iterations, started from the solution of the last
+* cycle. The math is in ecmcAxisGroupKinematics.
+*
+\*************************************************************************/
+
+#ifndef ECMC_AXIS_GROUP_TRANSFORM_H_
+#define ECMC_AXIS_GROUP_TRANSFORM_H_
+
+#include <stdint.h>
+#include <vector>
+#include "ecmcError.h"
+#include "ecmcAxisBase.h"
+#include "ecmcAsynPortDriver.h"
+#include "ecmcAxisGroupKinematics.h"
+
+class ecmcAxisGroup;
+
+#define ERROR_GRP_TRANSFORM_ASYN_PARAM_FAIL 0x16105
+#define ERROR_GRP_TRANSFORM_ALREADY_CREATED 0x16106
+#define ERROR_GRP_TRANSFORM_NULL 0x16107
+
+#define ECMC_GRP_STR "grp"
+#define ECMC_GRP_TRANSFORM_STR "transform"
+#define ECMC_GRP_TRANSFORM_EXE_TIME_STR "exetime"
+#define ECMC_GRP_TRANSFORM_EXE_TIME_MAX_STR "exetimemax"
+#define ECMC_GRP_TRANSFORM_ITER_STR "iterations"
+#define ECMC_GRP_TRANSFORM_RESIDUAL_STR "residual"
+#define ECMC_GRP_TRANSFORM_FAIL_STR "failcount"
+
+enum ecmcGrpTransformPar {
+  ECMC_GRP_TRANSFORM_PAR_EXE_TIME = 0,
+  ECMC_GRP_TRANSFORM_PAR_EXE_TIME_MAX,
+  ECMC_GRP_TRANSFORM_PAR_ITER,
+  ECMC_GRP_TRANSFORM_PAR_RESIDUAL,
+  ECMC_GRP_TRANSFORM_PAR_FAIL,
+  ECMC_GRP_TRANSFORM_PAR_COUNT
+};
+
+class ecmcAxisGroupTransform : public ecmcError {
+public:
+  ecmcAxisGroupTransform(int                 type,
+                         ecmcAxisGroup      *virtGrp,
+                         ecmcAxisGroup      *realGrp,
+                         int                 grpIndex,
+                         ecmcAsynPortDriver *asynPortDriver);
+  ~ecmcAxisGroupTransform();
+
+  int            setParam(int    index,
+                          double value);
+  int            setSolver(int    maxIterations,
+                           double tolerance);
+
+  // Axes are taken from the groups here (groups are complete)
+  int            validate();
+
+  // Rt, real actual positions -> virtual external encoder positions
+  void           executeForward();
+
+  // Rt, virtual setpoints -> real external trajectory setpoints
+  void           executeInverse();
+  void           print();
+  ecmcAxisGroup* getVirtGrp();
+  ecmcAxisGroup* getRealGrp();
+
+private:
+  int            initAsyn();
+
+  int grpIndex_;
+  ecmcAxisGroup *virtGrp_;
+  ecmcAxisGroup *realGrp_;
+  ecmcAsynPortDriver *asynPortDriver_;
+  ecmcAsynDataItem *asynParams_[ECMC_GRP_TRANSFORM_PAR_COUNT];
+  ecmcAxisGroupKinematics kinematics_;
+
+  // Valid after validate(), sized from the groups (no allocation in rt)
+  int dof_;
+  std::vector<ecmcAxisBase *> virtAxes_;
+  std::vector<ecmcAxisBase *> realAxes_;
+  std::vector<double> x_, q_;
+
+  // Diagnostics
+  int32_t fwdTimeNs_;
+  int32_t exeTimeNs_;
+  int32_t exeTimeMaxNs_;
+  int32_t iterations_;
+  double residual_;
+  int32_t failCount_;
+};
+
+#endif  /* ECMC_AXIS_GROUP_TRANSFORM_H_ */
@@ -64,9 +64,15 @@ ecmcAxisReal::~ecmcAxisReal() {
 
 void ecmcAxisReal::initVars() {
   currentDriveType_         = ECMC_NO_DRIVE;
+  cntrlStaged_              = false;
 }
 
 void ecmcAxisReal::execute(bool masterOK) {
+  executePreCntrl(masterOK);
+  executePostCntrl(masterOK);
+}
+
+void ecmcAxisReal::executePreCntrl(bool masterOK) {
   ecmcAxisBase::preExecute(masterOK);
   const bool axisEnabled = getEnabled();
   const bool axisEnableCmd = getEnable();
@@ -114,6 +120,10 @@ void ecmcAxisReal::execute(bool masterOK) {
       if (!data_.status_.statusWord_.busy && mon_->getCtrlInDeadband()) {
         cntrl_->reset();  // Keep now for legacy reasons...
         cntrOutput = 0;
+      } else if (cntrl_->getAttachedToBatch()) {
+        // Output is written to drive in executePostCntrl()
+        cntrlStaged_ = cntrl_->stage(data_.status_.cntrlError,
+                                     data_.status_.currentVelocitySetpoint);
       } else {
         cntrOutput = cntrl_->control(data_.status_.cntrlError,
                                      data_.status_.currentVelocitySetpoint);
@@ -130,7 +140,12 @@ void ecmcAxisReal::execute(bool masterOK) {
       } else {        
         // CSP with controller
         if (data_.status_.statusWord_.busy ||  !mon_->getCtrlInDeadband()) {
-          data_.status_.currentCSPPositionSetpointOffset = cntrl_->control(data_.status_.cntrlError,0);
+          if (cntrl_->getAttachedToBatch()) {
+            // Offset is updated in executePostCntrl()
+            cntrlStaged_ = cntrl_->stage(data_.status_.cntrlError, 0);
+          } else {
+            data_.status_.currentCSPPositionSetpointOffset = cntrl_->control(data_.status_.cntrlError,0);
+          }
         }
         // Actual control. ecmc PID enabled on top of teh psoition loop in the drive (different encoders)        
         drv_->setCspPosSet(data_.status_.currentPositionSetpoint + data_.status_.currentCSPPositionSetpointOffset);
@@ -179,6 +194,19 @@ void ecmcAxisReal::execute(bool masterOK) {
                __LINE__,
                ERROR_AXIS_HARDWARE_STATUS_NOT_OK);
   }
+}
+
+void ecmcAxisReal::executePostCntrl(bool masterOK) {
+  if (cntrlStaged_) {
+    if (data_.control_.drvMode == ECMC_DRV_MODE_CSP) {
+      data_.status_.currentCSPPositionSetpointOffset = cntrl_->collect();
+      drv_->setCspPosSet(data_.status_.currentPositionSetpoint +
+                         data_.status_.currentCSPPositionSetpointOffset);
+    } else {
+      drv_->setVelSet(cntrl_->collect());  // Actual control (batch)
+    }
+    cntrlStaged_ = false;
+  }
 
   // Write to hardware
   // refreshExternalOutputSources();
@@ -27,6 +27,8 @@ public:
                ecmcTrajTypes       trajType);
   ~ecmcAxisReal();
   void               execute(bool masterOK);
+  void               executePreCntrl(bool masterOK);
+  void               executePostCntrl(bool masterOK);
   ecmcDriveBase*     getDrv();
   ecmcPIDController* getCntrl();
   int                validate();
@@ -36,6 +38,7 @@ private:
   ecmcDriveBase *drv_;
   ecmcPIDController *cntrl_;
   ecmcDriveTypes currentDriveType_;
+  bool cntrlStaged_;
 };
 
 #endif  /* ECMCAXISREAL_H_ */
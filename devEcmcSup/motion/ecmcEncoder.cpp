@@ -27,6 +27,7 @@ ecmcEncoder::ecmcEncoder(ecmcAsynPortDriver *asynPortDriver,
   sampleTimeMs_ = sampleTime * 1000;
   invSampleTime_ = sampleTime > 0 ? 1.0 / sampleTime : 0.0;
   delayTimeS_ = 2 * sampleTime;  // 2 cycles delay as default
+  sampleTimeNs_ = (uint64_t)(sampleTime * 1E9);
   
 
   // Encoder index start from 1 here, to get asyn param naming correct
@@ -153,6 +154,17 @@ void ecmcEncoder::initVars() {
   encLatchControlWordIdle_= 0;
   encLatchControlBits_    = 1;  // default to write 1 bit to arm latch
   allowOverUnderFlow_     = true;  // Allow as default
+  actAcc_                 = 0;
+  actAccLocal_            = 0;
+  encAccAct_              = NULL;
+  timestampDefined_       = false;
+  timestampValid_         = false;
+  timestampBits_          = 0;
+  timestampOld_           = 0;
+  sampleTimeNs_           = 0;
+  timeNowNs_              = 0;
+  timeMeasNs_             = 0;
+  distSinceMeas_          = 0;
 }
 
 bool ecmcEncoder::isPrimary() const {
@@ -257,6 +269,8 @@ void ecmcEncoder::setActPos(double pos) {
   // Must clear velocity filter
   velocityFilter_->initFilter(pos);
   positionFilter_->initFilter(pos);
+  velEstimator_.reset();
+  distSinceMeas_ = 0;
   actPos_ = pos;
 }
 
@@ -277,6 +291,10 @@ double ecmcEncoder::getActVel() {
   return actVel_;
 }
 
+double ecmcEncoder::getActAcc() {
+  return actAcc_;
+}
+
 void ecmcEncoder::setHomed(bool homed) {
   homed_ = homed;
 }
@@ -589,7 +607,9 @@ int ecmcEncoder::readHwActPos(bool masterOK, bool domainOK) {
       distTraveled += moduloRange;
     }
   }
-  if(enableVelocityFilter_) {
+  if (velEstimator_.getType() != ECMC_VEL_EST_FILTER) {
+    actVelLocal_ = estimateVelocity(distTraveled);
+  } else if(enableVelocityFilter_) {
     actVelLocal_ = velocityFilter_->getFiltVelo(distTraveled);
   } else {
     actVelLocal_ = distTraveled * invSampleTime_;
@@ -806,10 +826,12 @@ double ecmcEncoder::readEntries(bool masterOK) {
 
   actPos_ = actPosLocal_;
   actVel_ = actVelLocal_;
+  actAcc_ = actAccLocal_;
 
   // Update Asyn
   encPosAct_->refreshParamRT(0);
   encVelAct_->refreshParamRT(0);
+  encAccAct_->refreshParamRT(0);
 
   // Only set axis error id if primary
   if(encLocalErrorId_ && isPrimary()) {
@@ -969,6 +991,26 @@ int ecmcEncoder::validate() {
     hwReadyBitDefined_ = true;
   }
 
+  // Check timestamp link (measurement time of position)
+  timestampDefined_ = false;
+  timestampValid_   = false;
+
+  if (checkEntryExist(ECMC_ENCODER_ENTRY_INDEX_TIMESTAMP)) {
+    errorCode = validateEntry(ECMC_ENCODER_ENTRY_INDEX_TIMESTAMP);
+
+    if (errorCode) {
+      return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+    }
+
+    getEntryBitCount(ECMC_ENCODER_ENTRY_INDEX_TIMESTAMP, &timestampBits_);
+
+    if ((timestampBits_ != 32) && (timestampBits_ != 64)) {
+      return setErrorID(__FILE__, __FUNCTION__, __LINE__,
+                        ERROR_ENC_TIMESTAMP_BITS_INVALID);
+    }
+    timestampDefined_ = true;
+  }
+
   // Check hw trigged homing
   if (homeSeqId_ == ECMC_SEQ_HOME_TRIGG_EXTERN) {
     if (checkEntryExist(ECMC_ENCODER_ENTRY_INDEX_STAT_HOME) &&
@@ -1203,6 +1245,123 @@ int ecmcEncoder::getVelFilterEnable() {
   return enableVelocityFilter_;
 }
 
+int ecmcEncoder::setVelEstimator(int type, double timeConst) {
+  int errorCode = velEstimator_.setTimeConst(timeConst);
+
+  if (errorCode) {
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+
+  errorCode = velEstimator_.setType(type);
+
+  if (errorCode) {
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+  actAccLocal_   = 0;
+  distSinceMeas_ = 0;
+  timeMeasNs_    = timeNowNs_;
+  return 0;
+}
+
+int ecmcEncoder::getVelEstType() {
+  return velEstimator_.getType();
+}
+
+double ecmcEncoder::getVelEstTimeConst() {
+  return velEstimator_.getTimeConst();
+}
+
+/*
+* Extend 32 bit timestamp to 64 bit (closest to current time)
+*/
+uint64_t ecmcEncoder::extendTimestamp(uint64_t timestamp) {
+  if (timestampBits_ != 32) {
+    return timestamp;
+  }
+
+  uint64_t time = (timeNowNs_ & ~0xFFFFFFFFULL) | (timestamp & 0xFFFFFFFFULL);
+
+  if (time > timeNowNs_ + 0x80000000ULL) {
+    time -= 0x100000000ULL;
+  } else if (time + 0x80000000ULL < timeNowNs_) {
+    time += 0x100000000ULL;
+  }
+  return time;
+}
+
+/*
+* Model based velocity (ecmcVelEstimator). Without timestamp the position
+  is measured at each cycle. With timestamp (DC time of last count) the
+  estimator is updated at the time of each count. Between counts the
+  velocity is extrapolated but limited to one count since the last count,
+  and the estimator is reset if counts are overdue (standstill).
+*/
+double ecmcEncoder::estimateVelocity(double distTraveled) {
+  double sampleTime  = sampleTimeMs_ / 1000;
+  uint64_t timestamp = 0;
+
+  if (!timestampDefined_ ||
+      readEcEntryValue(ECMC_ENCODER_ENTRY_INDEX_TIMESTAMP, &timestamp)) {
+    velEstimator_.update(distTraveled, sampleTime);
+    actAccLocal_ = velEstimator_.getAcc();
+    return velEstimator_.getVel(0);
+  }
+
+  if (!timestampValid_) {
+    // Margin for extension of 32 bit timestamps
+    timeNowNs_      = timestampBits_ == 32 ? timestamp + 0x100000000ULL :
+                      timestamp;
+    timeMeasNs_     = timeNowNs_;
+    timestampOld_   = timestamp;
+    distSinceMeas_  = 0;
+    timestampValid_ = true;
+    return velEstimator_.getVel(0);
+  }
+
+  timeNowNs_     += sampleTimeNs_;
+  distSinceMeas_ += distTraveled;
+
+  if (timestamp != timestampOld_) {
+    timestampOld_ = timestamp;
+    uint64_t timeCountNs = extendTimestamp(timestamp);
+
+    // The count was in the last cycle (limit drift to timestamp clock)
+    if (timeCountNs > timeNowNs_) {
+      timeNowNs_ = timeCountNs;
+    } else if (timeNowNs_ - timeCountNs > sampleTimeNs_) {
+      timeNowNs_ = timeCountNs + sampleTimeNs_;
+    }
+
+    if (timeCountNs > timeMeasNs_) {
+      velEstimator_.update(distSinceMeas_,
+                           (timeCountNs - timeMeasNs_) * 1E-9);
+      timeMeasNs_    = timeCountNs;
+      distSinceMeas_ = 0;
+    }
+  } else if (distSinceMeas_ != 0) {
+    // Moved without new timestamp
+    velEstimator_.update(distSinceMeas_, (timeNowNs_ - timeMeasNs_) * 1E-9);
+    timeMeasNs_    = timeNowNs_;
+    distSinceMeas_ = 0;
+  }
+
+  double dt     = (timeNowNs_ - timeMeasNs_) * 1E-9;
+  double vel    = velEstimator_.getVel(dt);
+  double velMax = dt > 0 ? std::abs(scale_) / dt : std::abs(vel);
+
+  if (std::abs(velEstimator_.getVel(0)) > ECMC_VEL_EST_OVERDUE_FACTOR * velMax) {
+    velEstimator_.reset();
+    vel = 0;
+  } else if (vel > velMax) {
+    vel = velMax;
+  } else if (vel < -velMax) {
+    vel = -velMax;
+  }
+
+  actAccLocal_ = velEstimator_.getAcc();
+  return vel;
+}
+
 void ecmcEncoder::errorReset() {
   // Reset hardware if needed
   if (hwResetDefined_) {
@@ -1359,6 +1518,49 @@ int ecmcEncoder::initAsyn() {
   paramTemp->refreshParam(1);
   encVelAct_ = paramTemp;
 
+  // Actacc
+  charCount = snprintf(buffer,
+                       sizeof(buffer),
+                       ECMC_AX_STR "%d." ECMC_ASYN_ENC_ACT_ACC_NAME "%d",
+                       data_->status_.axisId,
+                       localIndex);
+
+
+  if (charCount >= sizeof(buffer) - 1) {
+    LOGERR(
+      "%s/%s:%d: ERROR (axis %d): Failed to generate (%s). Buffer to small (0x%x).\n",
+      __FILE__,
+      __FUNCTION__,
+      __LINE__,
+      data_->status_.axisId,
+      ECMC_AX_STR "%d." ECMC_ASYN_ENC_ACT_ACC_NAME "%d",
+      ERROR_AXIS_ASYN_PRINT_TO_BUFFER_FAIL);
+    return ERROR_AXIS_ASYN_PRINT_TO_BUFFER_FAIL;
+  }
+
+  name      = buffer;
+  paramTemp = asynPortDriver_->addNewAvailParam(name,
+                                                asynParamFloat64,
+                                                (uint8_t *)&actAcc_,
+                                                8,
+                                                ECMC_EC_F64,
+                                                0);
+
+  if (!paramTemp) {
+    LOGERR(
+      "%s/%s:%d: ERROR (axis %d): Add create default parameter for %s failed.\n",
+      __FILE__,
+      __FUNCTION__,
+      __LINE__,
+      data_->status_.axisId,
+      name);
+    return ERROR_MAIN_ASYN_CREATE_PARAM_FAIL;
+  }
+
+  paramTemp->setAllowWriteToEcmc(false);
+  paramTemp->refreshParam(1);
+  encAccAct_ = paramTemp;
+
 
   // Error ID
   charCount = snprintf(buffer,
@@ -28,6 +28,7 @@
 #include "ecmcEcEntryLink.h"
 #include "ecmcEcPdo.h"
 #include "ecmcFilter.h"
+#include "ecmcVelEstimator.h"
 #include "ecmcAxisData.h"
 #include "ecmcMotionUtils.h"
 #include "ecmcLookupTable.h"
@@ -75,6 +76,7 @@ public:
   void                  setActPos(double pos);
   double                getSampleTime();
   double                getActVel();
+  double                getActAcc();  // Only alpha-beta-gamma estimator
   void                  setHomed(bool homed);
   bool                  getHomed();
   encoderType           getType();
@@ -103,6 +105,12 @@ public:
   int                   setPosFilterEnable(bool enable);
   int                   getPosFilterEnable();
 
+  // Velocity estimator (type ecmcVelEstType, time constant [s])
+  int                   setVelEstimator(int    type,
+                                        double timeConst);
+  int                   getVelEstType();
+  double                getVelEstTimeConst();
+
   // Ref this encoder to other encoder at startup (i.e ref relative encoder to abs at startup)
   int                   setRefToOtherEncAtStartup(int encIndex);
   int                   getRefToOtherEncAtStartup();
@@ -181,10 +189,13 @@ protected:
   int      readHwWarningError(bool domainOK);
   int      readHwLatch(bool domainOK);
   int      readHwReady(bool domainOK);
+  double   estimateVelocity(double distTraveled);
+  uint64_t extendTimestamp(uint64_t timestamp);
   
   encoderType encType_;
   ecmcFilter *velocityFilter_;
   ecmcFilter *positionFilter_;
+  ecmcVelEstimator velEstimator_;
   ecmcAxisData *data_;
   int64_t turns_;
   uint64_t rawPosUint_;          // Raw position register (masked and shifted)
@@ -215,6 +226,8 @@ protected:
   double invSampleTime_;
   double actVel_;
   double actVelLocal_;
+  double actAcc_;
+  double actAccLocal_;
   bool homed_;
   bool encLatchFunctEnabled_;
   bool encLatchStatus_;
@@ -262,6 +275,7 @@ protected:
   ecmcAsynPortDriver *asynPortDriver_;
   ecmcAsynDataItem *encPosAct_;
   ecmcAsynDataItem *encVelAct_;
+  ecmcAsynDataItem *encAccAct_;
   ecmcAsynDataItem *encErrId_;
 
   int hwReadyInvert_;
@@ -286,6 +300,16 @@ protected:
   double delayTimeS_; // Compensate for delay between setpoint and actual value (should default to 2 cycles)
   bool enableDelayTime_;
   bool allowOverUnderFlow_;
+
+  // Measurement time of position from encoder (DC time of last count)
+  bool timestampDefined_;
+  bool timestampValid_;
+  int timestampBits_;
+  uint64_t timestampOld_;
+  uint64_t sampleTimeNs_;
+  uint64_t timeNowNs_;   // Time of this cycle in timestamp time base
+  uint64_t timeMeasNs_;  // Time of last estimator update
+  double distSinceMeas_;
 };
 
 #endif  /* ECMCENCODER_H_ */
@@ -59,6 +59,14 @@ const char* ecmcMasterSlaveStateMachine::getName(){
   return name_.c_str();
 };
 
+ecmcAxisGroup* ecmcMasterSlaveStateMachine::getMasterGrp(){
+  return masterGrp_;
+}
+
+ecmcAxisGroup* ecmcMasterSlaveStateMachine::getSlaveGrp(){
+  return slaveGrp_;
+}
+
 void ecmcMasterSlaveStateMachine::execute(){
 
   //always update
@@ -70,6 +70,8 @@ class ecmcMasterSlaveStateMachine : public ecmcError {
     const char* getName();
     void execute();
     int validate();
+    ecmcAxisGroup* getMasterGrp();
+    ecmcAxisGroup* getSlaveGrp();
 
   private:
     int stateIdle();
@@ -37,6 +37,8 @@
 
 // TODO: REMOVE GLOBALS
 #include "ecmcGlobalsExtern.h"
+#include "ecmcAxisGroupTransform.h"
+#include "ecmcAxisGear.h"
 
 
 int moveAbsolutePosition(int    axisIndex,
@@ -1540,6 +1542,23 @@ int setAxisEncVelFilterEnable(int axisIndex,
   return axes[axisIndex]->setEncVeloFiltEnable(enable);
 }
 
+int setAxisEncVelEstimator(int    axisIndex,
+                           int    type,
+                           double timeConstMs) {
+  LOGINFO4("%s/%s:%d axisIndex=%d type=%d timeConstMs=%lf\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           axisIndex,
+           type,
+           timeConstMs);
+  CHECK_AXIS_RETURN_IF_ERROR_AND_BLOCK_COM(axisIndex);
+  CHECK_AXIS_ENCODER_CFG_RETURN_IF_ERROR(axisIndex);
+
+  return axes[axisIndex]->getConfigEnc()->setVelEstimator(type,
+                                                          timeConstMs / 1000);
+}
+
 int setAxisEncPosFilterSize(int axisIndex,
                             int size) {
   LOGINFO4("%s/%s:%d axisIndex=%d size=%d\n",
@@ -1599,7 +1618,7 @@ const char* getAxisPLCExpr(int axisIndex, int *error) {
            __LINE__,
            axisIndex);
 
-  if ((axisIndex >= ECMC_MAX_AXES) || (axisIndex < 0)) {
+  if (!axes.validIndex(axisIndex)) {
     LOGERR("ERROR: Axis index out of range.\n");
     *error = ERROR_MAIN_AXIS_INDEX_OUT_OF_RANGE;
     return "";
@@ -1611,14 +1630,7 @@ const char* getAxisPLCExpr(int axisIndex, int *error) {
     return "";
   }
 
-  int plcIndex = ECMC_MAX_PLCS + axisIndex;
-
-  if ((plcIndex >= ECMC_MAX_PLCS + ECMC_MAX_AXES) ||
-      (plcIndex < ECMC_MAX_PLCS)) {
-    LOGERR("ERROR: PLC index out of range.\n");
-    *error = ERROR_PLCS_INDEX_OUT_OF_RANGE;
-    return "";
-  }
+  int plcIndex = AXIS_PLC_ID_TO_PLC_ID(axisIndex);
 
   if (!plcs) {
     LOGERR("ERROR: PLC object NULL.\n");
@@ -3797,10 +3809,17 @@ int createAxis(int index, int type, int drvType, int trajType) {
            drvType,
            trajType);
 
-  if ((index < 0) || (index >= ECMC_MAX_AXES)) {
+  if ((index < 0) || (index >= ECMC_REGISTRY_MAX_SIZE)) {
     return ERROR_MAIN_AXIS_INDEX_OUT_OF_RANGE;
   }
 
+  // Grow registry if needed
+  int errorCode = axes.resize(index + 1);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
   // Do not allow create already created axis (must be deleted first)
   if (axes[index] != NULL) {
     return ERROR_MAIN_AXIS_ALREADY_CREATED;
@@ -3817,10 +3836,10 @@ int createAxis(int index, int type, int drvType, int trajType) {
       // Sample rate fixed
       sampleRateChangeAllowed = 0;
 
-      axes[index]             = new ecmcAxisReal(asynPort, index,
-                                                 1 / mcuFrequency,
-                                                 (ecmcDriveTypes)drvType,
-                                                 (ecmcTrajTypes)trajType);
+      axes.set(index, new ecmcAxisReal(asynPort, index,
+                                       1 / mcuFrequency,
+                                       (ecmcDriveTypes)drvType,
+                                       (ecmcTrajTypes)trajType));
       break;
 
     case ECMC_AXIS_TYPE_VIRTUAL:
@@ -3832,9 +3851,9 @@ int createAxis(int index, int type, int drvType, int trajType) {
 
       // Sample rate fixed
       sampleRateChangeAllowed = 0;
-      axes[index]             = new ecmcAxisVirt(asynPort, index,
-                                                 1 / mcuFrequency,
-                                                 (ecmcTrajTypes)trajType);
+      axes.set(index, new ecmcAxisVirt(asynPort, index,
+                                       1 / mcuFrequency,
+                                       (ecmcTrajTypes)trajType));
       break;
 
     default:
@@ -3843,7 +3862,7 @@ int createAxis(int index, int type, int drvType, int trajType) {
   }
   catch (std::exception& e) {
     delete axes[index];
-    axes[index] = NULL;
+    axes.set(index, NULL);
     LOGERR("%s/%s:%d: EXCEPTION %s WHEN ALLOCATE MEMORY FOR AXIS OBJECT.\n",
            __FILE__,
            __FUNCTION__,
@@ -3870,10 +3889,17 @@ int addAxisGroup(const char *name) {
            name);
 
   int index = axisGroupCounter;
-  if ((index < 0) || (index >= ECMC_MAX_AXES)) {
+  if ((index < 0) || (index >= ECMC_REGISTRY_MAX_SIZE)) {
     return ERROR_MAIN_AXIS_INDEX_OUT_OF_RANGE;
   }
 
+  // Grow registry if needed
+  int errorCode = axisGroups.resize(index + 1);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
   for (int i = 0; i < index; i++) {
     if (axisGroups[i] && strcmp(axisGroups[i]->getName(), name) == 0) {
       return ERROR_AXISGRP_NAME_ALREADY_EXISTS;
@@ -3886,12 +3912,12 @@ int addAxisGroup(const char *name) {
   }
 
   try {
-    axisGroups[index] = new ecmcAxisGroup(index, name);
+    axisGroups.set(index, new ecmcAxisGroup(index, name));
     axisGroupCounter++;
   }
   catch (std::exception& e) {
     delete axisGroups[index];
-    axisGroups[index] = NULL;
+    axisGroups.set(index, NULL);
     LOGERR("%s/%s:%d: EXCEPTION %s WHEN ALLOCATE MEMORY FOR AXISGROUP OBJECT.\n",
            __FILE__,
            __FUNCTION__,
@@ -3960,7 +3986,7 @@ int addAxisToGroupByIndex(int axIndex, int grpIndex) {
     return ERROR_AXISGRP_NOT_FOUND;
   }
   
-  if ((axIndex < 0) || (axIndex >= ECMC_MAX_AXES)) {
+  if (!axes.validIndex(axIndex)) {
     return ERROR_MAIN_AXIS_INDEX_OUT_OF_RANGE;
   }
 
@@ -3978,6 +4004,240 @@ int addAxisToGroupByIndex(int axIndex, int grpIndex) {
   return 0;
 }
 
+static ecmcAxisGroupTransform* getAxisGroupTransform(const char *virtGrpName) {
+  int index = -1;
+
+  if (getAxisGroupIndexByName(virtGrpName, &index)) {
+    return NULL;
+  }
+  return axisGroups[index]->getTransform();
+}
+
+int createAxisGroupTransform(const char *virtGrpName,
+                             const char *realGrpName,
+                             int         type) {
+  LOGINFO4("%s/%s:%d virt=%s, real=%s, type=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           virtGrpName,
+           realGrpName,
+           type);
+
+  int virtIndex = -1;
+  int realIndex = -1;
+  int errorCode = getAxisGroupIndexByName(virtGrpName, &virtIndex);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  errorCode = getAxisGroupIndexByName(realGrpName, &realIndex);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  if (axisGroups[virtIndex]->getTransform()) {
+    return ERROR_GRP_TRANSFORM_ALREADY_CREATED;
+  }
+
+  ecmcAxisGroupTransform *transform = NULL;
+
+  try {
+    transform = new ecmcAxisGroupTransform(type,
+                                           axisGroups[virtIndex],
+                                           axisGroups[realIndex],
+                                           virtIndex,
+                                           asynPort);
+  }
+  catch (std::exception& e) {
+    LOGERR("%s/%s:%d: EXCEPTION %s WHEN ALLOCATE MEMORY FOR TRANSFORM OBJECT.\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           e.what());
+    return ERROR_MAIN_EXCEPTION;
+  }
+
+  errorCode = transform->getErrorID();
+
+  if (errorCode) {
+    delete transform;
+    return errorCode;
+  }
+  axisGroups[virtIndex]->setTransform(transform);
+  return 0;
+}
+
+int setAxisGroupTransformParam(const char *virtGrpName,
+                               int         paramIndex,
+                               double      value) {
+  LOGINFO4("%s/%s:%d virt=%s, index=%d, value=%lf\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           virtGrpName,
+           paramIndex,
+           value);
+
+  ecmcAxisGroupTransform *transform = getAxisGroupTransform(virtGrpName);
+
+  if (!transform) {
+    return ERROR_GRP_TRANSFORM_NULL;
+  }
+  return transform->setParam(paramIndex, value);
+}
+
+int setAxisGroupTransformSolver(const char *virtGrpName,
+                                int         maxIterations,
+                                double      tolerance) {
+  LOGINFO4("%s/%s:%d virt=%s, maxIterations=%d, tolerance=%lf\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           virtGrpName,
+           maxIterations,
+           tolerance);
+
+  ecmcAxisGroupTransform *transform = getAxisGroupTransform(virtGrpName);
+
+  if (!transform) {
+    return ERROR_GRP_TRANSFORM_NULL;
+  }
+  return transform->setSolver(maxIterations, tolerance);
+}
+
+int printAxisGroupTransform(const char *virtGrpName) {
+  ecmcAxisGroupTransform *transform = getAxisGroupTransform(virtGrpName);
+
+  if (!transform) {
+    return ERROR_GRP_TRANSFORM_NULL;
+  }
+  transform->print();
+  return 0;
+}
+
+int createAxisGear(int slaveAxisIndex,
+                   int masterAxisIndex,
+                   int masterSource) {
+  LOGINFO4("%s/%s:%d slave=%d, master=%d, source=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           slaveAxisIndex,
+           masterAxisIndex,
+           masterSource);
+
+  CHECK_AXIS_RETURN_IF_ERROR(slaveAxisIndex)
+  CHECK_AXIS_RETURN_IF_ERROR(masterAxisIndex)
+
+  ecmcAxisGear *gear = NULL;
+
+  try {
+    gear = new ecmcAxisGear(axes[slaveAxisIndex],
+                            axes[masterAxisIndex],
+                            masterSource,
+                            1.0 / mcuFrequency,
+                            asynPort);
+  }
+  catch (std::exception& e) {
+    LOGERR("%s/%s:%d: EXCEPTION %s WHEN ALLOCATE MEMORY FOR GEAR OBJECT.\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           e.what());
+    return ERROR_MAIN_EXCEPTION;
+  }
+
+  int errorCode = gear->getErrorID();
+
+  if (errorCode) {
+    delete gear;
+    return errorCode;
+  }
+  axes[slaveAxisIndex]->setGear(gear);
+  return 0;
+}
+
+int setAxisGearRatio(int slaveAxisIndex, double ratio) {
+  LOGINFO4("%s/%s:%d slave=%d, ratio=%lf\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           slaveAxisIndex,
+           ratio);
+
+  CHECK_AXIS_GEAR_RETURN_IF_ERROR(slaveAxisIndex)
+  return axes[slaveAxisIndex]->getGear()->setRatio(ratio);
+}
+
+int setAxisGearCamLUT(int slaveAxisIndex, int lutIndex) {
+  LOGINFO4("%s/%s:%d slave=%d, lut=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           slaveAxisIndex,
+           lutIndex);
+
+  CHECK_AXIS_GEAR_RETURN_IF_ERROR(slaveAxisIndex)
+  return axes[slaveAxisIndex]->getGear()->setCamLUT(lutIndex);
+}
+
+int setAxisGearEngageDist(int slaveAxisIndex, double distance) {
+  LOGINFO4("%s/%s:%d slave=%d, distance=%lf\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           slaveAxisIndex,
+           distance);
+
+  CHECK_AXIS_GEAR_RETURN_IF_ERROR(slaveAxisIndex)
+  return axes[slaveAxisIndex]->getGear()->setEngageDist(distance);
+}
+
+int setAxisGearPhase(int slaveAxisIndex, double phase) {
+  LOGINFO4("%s/%s:%d slave=%d, phase=%lf\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           slaveAxisIndex,
+           phase);
+
+  CHECK_AXIS_GEAR_RETURN_IF_ERROR(slaveAxisIndex)
+  return axes[slaveAxisIndex]->getGear()->setPhase(phase);
+}
+
+int setAxisGearPhaseVelo(int slaveAxisIndex, double velocity) {
+  LOGINFO4("%s/%s:%d slave=%d, velocity=%lf\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           slaveAxisIndex,
+           velocity);
+
+  CHECK_AXIS_GEAR_RETURN_IF_ERROR(slaveAxisIndex)
+  return axes[slaveAxisIndex]->getGear()->setPhaseVelo(velocity);
+}
+
+int setAxisGearEngage(int slaveAxisIndex, int engage) {
+  LOGINFO4("%s/%s:%d slave=%d, engage=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           slaveAxisIndex,
+           engage);
+
+  CHECK_AXIS_GEAR_RETURN_IF_ERROR(slaveAxisIndex)
+  return axes[slaveAxisIndex]->getGear()->setEngage(engage);
+}
+
+int printAxisGear(int slaveAxisIndex) {
+  CHECK_AXIS_GEAR_RETURN_IF_ERROR(slaveAxisIndex)
+  axes[slaveAxisIndex]->getGear()->print();
+  return 0;
+}
+
 int linkEcEntryToAxisEnc(int   slaveIndex,
                          char *entryIDString,
                          int   axisIndex,
@@ -4434,7 +4694,7 @@ int getAxisValid(int axisIndex) {
            __LINE__,
            axisIndex);
 
-  if ((axisIndex >= ECMC_MAX_AXES) || (axisIndex <= 0)) {
+  if (!axes.validIndex(axisIndex) || (axisIndex <= 0)) {
     return 0;
   }
   return axes[axisIndex] != NULL;
@@ -4565,7 +4825,7 @@ void* getAxisPointer(int  axisIndex) {
            __FUNCTION__,
            __LINE__,
            axisIndex);
-  if (axisIndex >= ECMC_MAX_AXES || axisIndex <= 0) {
+  if (!axes.validIndex(axisIndex) || axisIndex <= 0) {
     LOGERR("ERROR: Axis index out of range.\n");
     return NULL;
   }
@@ -4585,7 +4845,7 @@ int createMasterSlaveSM(int index,
 
   ecmcAxisGroup *masterGrp = NULL;
   ecmcAxisGroup *slaveGrp  = NULL;
-  for(int i = 0;i < ECMC_MAX_AXES; i++) {
+  for(int i = 0;i < axisGroups.size(); i++) {
     if(axisGroups[i] != NULL) {
       printf("Comparing %s with %s and %s\n",axisGroups[i]->getName(),masterGrpName,slaveGrpName);
       if(strcmp(axisGroups[i]->getName(),masterGrpName) == 0) {
@@ -4611,3 +4871,97 @@ int createMasterSlaveSM(int index,
                                                           autoDisableSlaves);
   return 0;
 }
+
+int setEnableCntrlBatch(int enable) {
+  LOGINFO4("%s/%s:%d enable=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           enable);
+
+  cntrlBatchMode = enable;
+  return 0;
+}
+
+int setCntrlBatchVerify(int verify) {
+  LOGINFO4("%s/%s:%d verify=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           verify);
+
+  cntrlBatchVerify = verify;
+
+  if (cntrlBatch) {
+    cntrlBatch->setVerify(verify);
+  }
+  return 0;
+}
+
+int getCntrlBatchVerifyErrors(uint64_t *count) {
+  LOGINFO4("%s/%s:%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__);
+
+  *count = 0;
+
+  if (cntrlBatch) {
+    *count = cntrlBatch->getVerifyErrorCount();
+    cntrlBatch->printVerifyErrors();
+  }
+  return 0;
+}
+
+int setAxisFlightRecorderSize(int axisIndex, int samples) {
+  LOGINFO4("%s/%s:%d axisIndex=%d samples=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           axisIndex,
+           samples);
+
+  CHECK_AXIS_RETURN_IF_ERROR(axisIndex);
+
+  return axes[axisIndex]->getFlightRecorder()->setSize(samples);
+}
+
+int setAxisFlightRecorderPostTrigger(int axisIndex, int samples) {
+  LOGINFO4("%s/%s:%d axisIndex=%d samples=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           axisIndex,
+           samples);
+
+  CHECK_AXIS_RETURN_IF_ERROR(axisIndex);
+
+  axes[axisIndex]->getFlightRecorder()->setPostTriggerSamples(samples);
+  return 0;
+}
+
+int armAxisFlightRecorder(int axisIndex) {
+  LOGINFO4("%s/%s:%d axisIndex=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           axisIndex);
+
+  CHECK_AXIS_RETURN_IF_ERROR(axisIndex);
+
+  axes[axisIndex]->getFlightRecorder()->arm();
+  return 0;
+}
+
+int printAxisFlightRecorder(int axisIndex) {
+  LOGINFO4("%s/%s:%d axisIndex=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           axisIndex);
+
+  CHECK_AXIS_RETURN_IF_ERROR(axisIndex);
+
+  axes[axisIndex]->getFlightRecorder()->print();
+  return 0;
+}
@@ -25,7 +25,7 @@ extern "C" {
 
 #define CHECK_AXIS_RETURN_IF_ERROR(axisIndex)\
         {\
-          if (axisIndex >= ECMC_MAX_AXES || axisIndex < 0) {\
+          if (!axes.validIndex(axisIndex)) {\
             LOGERR("ERROR: Axis index out of range.\n");\
             return ERROR_MAIN_AXIS_INDEX_OUT_OF_RANGE;\
           }\
@@ -101,6 +101,15 @@ extern "C" {
           }\
         }\
 
+#define CHECK_AXIS_GEAR_RETURN_IF_ERROR(axisIndex)\
+        {\
+          CHECK_AXIS_RETURN_IF_ERROR(axisIndex);\
+          if (axes[axisIndex]->getGear() == NULL) {\
+            LOGERR("ERROR: Gear object NULL.\n");\
+            return ERROR_AXIS_GEAR_NULL;\
+          }\
+        }\
+
 #define CHECK_AXIS_MON_RETURN_IF_ERROR(axisIndex)\
         {\
           CHECK_AXIS_RETURN_IF_ERROR(axisIndex);\
@@ -1908,6 +1917,35 @@ int setAxisEncVelFilterSize(int axisIndex,
  */
 int setAxisEncVelFilterEnable(int axisIndex,
                               int enable);
+
+/** \brief Select encoder velocity estimator.\n
+ *
+ *  Alternative to the moving average velocity filter, which lags\n
+ *  filter size/2 cycles:\n
+ *    type = 0 : Moving average filter (default, see\n
+ *               Cfg.SetAxisEncVelFilterSize()).\n
+ *    type = 1 : Alpha-beta tracker (constant velocity model).\n
+ *    type = 2 : Alpha-beta-gamma tracker (constant acceleration model,\n
+ *               acceleration in ax<id>.actacc<enc>).\n
+ *  The trackers are critically damped, the time constant sets the noise\n
+ *  reduction (no lag at constant velocity/acceleration).\n
+ *  If a timestamp entry is linked to the encoder ("ax<id>.enc.timestamp",\n
+ *  32 or 64 bit DC time of last count) the position is treated as\n
+ *  measured at that time, improving the estimate for low count rates.\n
+ *  Applies to the encoder that currently is being configured.\n
+ *
+ * \param[in] axisIndex  Axis index.\n
+ * \param[in] type       Estimator type.\n
+ * \param[in] timeConstMs Time constant of trackers [ms] (>0).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Alpha-beta tracker with 5ms time constant for axis 7.\n
+ * "Cfg.SetAxisEncVelEstimator(7,1,5)" //Command string to ecmcCmdParser.c.\n
+ */
+int setAxisEncVelEstimator(int    axisIndex,
+                           int    type,
+                           double timeConstMs);
 int getAxisEncVelFilterSize(int axisIndex,
                             int *size);
 int getAxisEncVelFilterEnable(int axisIndex,
@@ -3834,6 +3872,205 @@ int getAxisGroupIndexByName(const char* grpName, int *index);
  */
 int getAxisGroupCount(int *count);
 
+/** \brief Create a kinematic transform between two axis groups.
+ *
+ * The transform is attached to the virtual group and executed natively
+ * each cycle (see ecmcAxisGroupTransform.h):\n
+ *  forward: actual positions of the real axes -> external encoder
+ *           positions of the virtual axes.\n
+ *  inverse: setpoints of the virtual axes -> external trajectory
+ *           setpoints of the real axes.\n
+ * Axes are used in the order they were added to the groups. Execution
+ * time, solver iterations, residual and failed solves are available as
+ * grp<index>.transform.* parameters.\n
+ *
+ * \param[in] virtGrpName Name of group with virtual axes (coordinates).\n
+ * \param[in] realGrpName Name of group with real axes (joints).\n
+ * \param[in] type Transform type:\n
+ *   type = 1: Linear, q = A * x + b.\n
+ *   type = 2: Gap/center (2 axes).\n
+ *   type = 3: Tripod, three vertical jacks (z, rx, ry).\n
+ *   type = 4: Hexapod, six legs (x, y, z, rx, ry, rz).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Gap/center transform for a slit.\n
+ *  "Cfg.CreateAxisGroupTransform(Virt,Phys,2)" //Command string to ecmcCmdParser.c\n
+ */
+int createAxisGroupTransform(const char *virtGrpName,
+                             const char *realGrpName,
+                             int         type);
+
+/** \brief Set a parameter of a kinematic transform.
+ *
+ * Parameter layout depends on type (see ecmcAxisGroupTransform.h):\n
+ *   Linear:  A row major (n*n), then b (n, default 0).\n
+ *   Tripod:  jack anchors (3 x xyz), pivot (xyz), angle unit [rad].\n
+ *   Hexapod: platform anchors at home (6 x xyz), base anchors (6 x xyz),
+ *            pivot (xyz), angle unit [rad].\n
+ *
+ * \param[in] virtGrpName Name of group with virtual axes.\n
+ * \param[in] paramIndex Parameter index.\n
+ * \param[in] value Parameter value.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Set element A[0][0] to 0.5.\n
+ *  "Cfg.SetAxisGroupTransformParam(Virt,0,0.5)" //Command string to ecmcCmdParser.c\n
+ */
+int setAxisGroupTransformParam(const char *virtGrpName,
+                               int         paramIndex,
+                               double      value);
+
+/** \brief Set solver of a kinematic transform (tripod and hexapod).
+ *
+ * The forward transform is solved with Newton iterations started from
+ * the solution of the last cycle.\n
+ *
+ * \param[in] virtGrpName Name of group with virtual axes.\n
+ * \param[in] maxIterations Max iterations per cycle (default 10).\n
+ * \param[in] tolerance Max residual of the real axes (default 1e-6).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Max 5 iterations and tolerance 1e-7.\n
+ *  "Cfg.SetAxisGroupTransformSolver(Virt,5,1e-7)" //Command string to ecmcCmdParser.c\n
+ */
+int setAxisGroupTransformSolver(const char *virtGrpName,
+                                int         maxIterations,
+                                double      tolerance);
+
+/** \brief Print a kinematic transform.
+ *
+ * \param[in] virtGrpName Name of group with virtual axes.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print transform of group Virt.\n
+ *  "Cfg.PrintAxisGroupTransform(Virt)" //Command string to ecmcCmdParser.c\n
+ */
+int printAxisGroupTransform(const char *virtGrpName);
+
+/** \brief Create electronic gear/cam of a slave axis.
+ *
+ * The master position is mapped to the external trajectory setpoint of
+ * the slave each cycle, right after the master axis is executed (see
+ * ecmcAxisGear.h). Default is gearing with ratio 1, use
+ * "Cfg.SetAxisGearCamLUT()" for camming. The trajectory source of the
+ * slave must be set to external. State, phase and slave velocity are
+ * available as ax<index>.gear.* parameters.\n
+ *
+ * \param[in] slaveAxisIndex Slave axis index.\n
+ * \param[in] masterAxisIndex Master axis index.\n
+ * \param[in] masterSource Master position:\n
+ *   masterSource = 0: Setpoint.\n
+ *   masterSource = 1: Actual position.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Gear axis 2 to setpoint of axis 1.\n
+ *  "Cfg.CreateAxisGear(2,1,0)" //Command string to ecmcCmdParser.c\n
+ */
+int createAxisGear(int slaveAxisIndex,
+                   int masterAxisIndex,
+                   int masterSource);
+
+/** \brief Set gear ratio (slave delta / master delta).
+ *
+ * \param[in] slaveAxisIndex Slave axis index.\n
+ * \param[in] ratio Gear ratio.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Slave moves half the distance of master.\n
+ *  "Cfg.SetAxisGearRatio(2,0.5)" //Command string to ecmcCmdParser.c\n
+ */
+int setAxisGearRatio(int    slaveAxisIndex,
+                     double ratio);
+
+/** \brief Use a lookup table (Cfg.LoadLUT()) as cam.
+ *
+ * Slave position = lut(master position + phase). The lut index is wrapped
+ * to the modulo range of the master (if modulo).\n
+ *
+ * \param[in] slaveAxisIndex Slave axis index.\n
+ * \param[in] lutIndex Lookup table index (-1 = gear).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Use lut 0 as cam for axis 2.\n
+ *  "Cfg.SetAxisGearCamLUT(2,0)" //Command string to ecmcCmdParser.c\n
+ */
+int setAxisGearCamLUT(int slaveAxisIndex,
+                      int lutIndex);
+
+/** \brief Set engage/disengage distance (master travel).
+ *
+ * On engage the slave is blended in from its position to the gear/cam
+ * position, on disengage the slave velocity is ramped down, both over this
+ * master distance.\n
+ *
+ * \param[in] slaveAxisIndex Slave axis index.\n
+ * \param[in] distance Master distance (0 = step, default).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Engage over 10 units of master travel.\n
+ *  "Cfg.SetAxisGearEngageDist(2,10)" //Command string to ecmcCmdParser.c\n
+ */
+int setAxisGearEngageDist(int    slaveAxisIndex,
+                          double distance);
+
+/** \brief Set phase (offset added to master position).
+ *
+ * \param[in] slaveAxisIndex Slave axis index.\n
+ * \param[in] phase Phase in master units.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Shift phase 90 units.\n
+ *  "Cfg.SetAxisGearPhase(2,90)" //Command string to ecmcCmdParser.c\n
+ */
+int setAxisGearPhase(int    slaveAxisIndex,
+                     double phase);
+
+/** \brief Set velocity of phase changes.
+ *
+ * \param[in] slaveAxisIndex Slave axis index.\n
+ * \param[in] velocity Phase velocity [master units/s] (0 = step).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Change phase with 5 units/s.\n
+ *  "Cfg.SetAxisGearPhaseVelo(2,5)" //Command string to ecmcCmdParser.c\n
+ */
+int setAxisGearPhaseVelo(int    slaveAxisIndex,
+                         double velocity);
+
+/** \brief Engage or disengage gear/cam.
+ *
+ * \param[in] slaveAxisIndex Slave axis index.\n
+ * \param[in] engage 1 = engage, 0 = disengage.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Engage gear of axis 2.\n
+ *  "Cfg.SetAxisGearEngage(2,1)" //Command string to ecmcCmdParser.c\n
+ */
+int setAxisGearEngage(int slaveAxisIndex,
+                      int engage);
+
+/** \brief Print gear/cam of a slave axis.
+ *
+ * \param[in] slaveAxisIndex Slave axis index.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print gear of axis 2.\n
+ *  "Cfg.PrintAxisGear(2)" //Command string to ecmcCmdParser.c\n
+ */
+int printAxisGear(int slaveAxisIndex);
+
 /** \brief Links an EtherCAT entry to the encoder object of the axis at axisIndex.
    *
    *  \param[in] slaveBusPosition Position of the EtherCAT slave on the bus.\n
@@ -4276,6 +4513,106 @@ int createMasterSlaveSM(int index,
                         int autoDisableMasters,
                         int autoDisableSlaves);
 
+/** \brief Enable batch evaluation of the PID controllers of all CSV axes.\n
+ *
+ * When enabled, the position controllers of all real axes are evaluated in
+ * one SIMD pass per cycle (see ecmcPIDBatch) instead of one call per axis.
+ * All axes (and axis PLCs) first execute up to the controller, then all
+ * controllers are evaluated and finally the outputs are written to the drives.
+ * Only allowed in configuration mode.\n
+ *
+ * \param[in] enable Enable batch mode.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Enable batch controller evaluation.\n
+ * "Cfg.SetEnableCntrlBatch(1)" //Command string to ecmcCmdParser.c\n
+ */
+int setEnableCntrlBatch(int enable);
+
+/** \brief Verify batch controller results against the scalar implementation.\n
+ *
+ * Each batch result is recalculated with the scalar controller code and
+ * any difference is counted and printed (intended for commissioning).\n
+ *
+ * \param[in] verify Enable verification.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Enable verification.\n
+ * "Cfg.SetCntrlBatchVerify(1)" //Command string to ecmcCmdParser.c\n
+ */
+int setCntrlBatchVerify(int verify);
+
+/** \brief Get number of batch controller results that differed from the
+ *  scalar implementation.\n
+ *
+ * Nothing is printed from the realtime thread, the first mismatch is
+ * printed when the count is read.\n
+ *
+ * \param[out] count Number of differing results.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Get verification error count.\n
+ * "GetCntrlBatchVerifyErrors()" //Command string to ecmcCmdParser.c\n
+ */
+int getCntrlBatchVerifyErrors(uint64_t *count);
+
+/** \brief Set size of axis flight recorder.\n
+ *
+ * The flight recorder keeps the last samples of setpoint, actual position,
+ * controller error, controller output and status word of the axis. It
+ * freezes automatically on an error edge (see ecmcAxisFlightRecorder).\n
+ * The size is rounded up to a power of 2. 0 disables the recorder.\n
+ * Only allowed in configuration mode.\n
+ *
+ * \param[in] axisIndex  Axis index.\n
+ * \param[in] samples Number of samples.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Keep 4096 samples of axis 3.\n
+ * "Cfg.SetAxisFlightRecorderSize(3,4096)" //Command string to ecmcCmdParser.c\n
+ */
+int setAxisFlightRecorderSize(int axisIndex,
+                              int samples);
+
+/** \brief Set number of samples recorded after the error edge.\n
+ *
+ * \param[in] axisIndex  Axis index.\n
+ * \param[in] samples Number of samples.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Record 100 samples after error of axis 3.\n
+ * "Cfg.SetAxisFlightRecorderPostTrigger(3,100)" //Command string to ecmcCmdParser.c\n
+ */
+int setAxisFlightRecorderPostTrigger(int axisIndex,
+                                     int samples);
+
+/** \brief Rearm (unfreeze) axis flight recorder.\n
+ *
+ * \param[in] axisIndex  Axis index.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Rearm flight recorder of axis 3.\n
+ * "Cfg.ArmAxisFlightRecorder(3)" //Command string to ecmcCmdParser.c\n
+ */
+int armAxisFlightRecorder(int axisIndex);
+
+/** \brief Print status and (if frozen) contents of axis flight recorder.\n
+ *
+ * \param[in] axisIndex  Axis index.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print flight recorder of axis 3.\n
+ * "Cfg.PrintAxisFlightRecorder(3)" //Command string to ecmcCmdParser.c\n
+ */
+int printAxisFlightRecorder(int axisIndex);
+
 # ifdef __cplusplus
 }
 # endif  // ifdef __cplusplus
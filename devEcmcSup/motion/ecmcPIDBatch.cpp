@@ -0,0 +1,375 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcPIDBatch.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcPIDBatch.h"
+#include "ecmcOctetIF.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+// Number of double arrays in the structure-of-arrays
+#define ECMC_PID_BATCH_ARRAY_COUNT 24
+
+// GCC vector extensions (SSE2 or AVX depending on target flags)
+typedef double ecmcPIDBatchVec
+  __attribute__((vector_size(ECMC_PID_BATCH_VEC_WIDTH * sizeof(double)),
+                 aligned(sizeof(double))));
+typedef int64_t ecmcPIDBatchMask
+  __attribute__((vector_size(ECMC_PID_BATCH_VEC_WIDTH * sizeof(int64_t))));
+
+static inline ecmcPIDBatchVec loadVec(const double *src) {
+  ecmcPIDBatchVec v;
+
+  memcpy(&v, src, sizeof(v));
+  return v;
+}
+
+static inline void storeVec(double *dest, ecmcPIDBatchVec v) {
+  memcpy(dest, &v, sizeof(v));
+}
+
+ecmcPIDBatch::ecmcPIDBatch(size_t capacity) {
+  // Round up to full vectors
+  capacity_ = (capacity + ECMC_PID_BATCH_VEC_WIDTH - 1) /
+              ECMC_PID_BATCH_VEC_WIDTH * ECMC_PID_BATCH_VEC_WIDTH;
+  count_          = 0;
+  verify_         = false;
+  verifyErrors_   = 0;
+  executeCounter_ = 0;
+  verifyFirstSlot_      = 0;
+  verifyFirstCycle_     = 0;
+  verifyFirstOut_       = 0;
+  verifyFirstOutScalar_ = 0;
+  verifyFirstI_         = 0;
+  verifyFirstIScalar_   = 0;
+
+  // One block for all arrays (keeps slots of the same kind contiguous)
+  double *mem = (double *)calloc(capacity_ * ECMC_PID_BATCH_ARRAY_COUNT,
+                                 sizeof(double));
+
+  if (!mem) {
+    LOGERR("%s/%s:%d: ERROR: Failed to allocate PID batch memory (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           ERROR_PID_BATCH_ALLOC_FAIL);
+    exit(EXIT_FAILURE);
+  }
+
+  kp_           = mem + 0 * capacity_;
+  ki_           = mem + 1 * capacity_;
+  kd_           = mem + 2 * capacity_;
+  kff_          = mem + 3 * capacity_;
+  kpInner_      = mem + 4 * capacity_;
+  kiInner_      = mem + 5 * capacity_;
+  kdInner_      = mem + 6 * capacity_;
+  innerTol_     = mem + 7 * capacity_;
+  iMax_         = mem + 8 * capacity_;
+  iMin_         = mem + 9 * capacity_;
+  outMax_       = mem + 10 * capacity_;
+  outMin_       = mem + 11 * capacity_;
+  posError_     = mem + 12 * capacity_;
+  ff_           = mem + 13 * capacity_;
+  distToTarget_ = mem + 14 * capacity_;
+  staged_       = mem + 15 * capacity_;
+  outI_         = mem + 16 * capacity_;
+  errOld_       = mem + 17 * capacity_;
+  outP_         = mem + 18 * capacity_;
+  outD_         = mem + 19 * capacity_;
+  outFF_        = mem + 20 * capacity_;
+  outTot_       = mem + 21 * capacity_;
+  verifyOutI_   = mem + 22 * capacity_;
+  verifyErrOld_ = mem + 23 * capacity_;
+}
+
+ecmcPIDBatch::~ecmcPIDBatch() {
+  free(kp_);
+}
+
+int ecmcPIDBatch::addSlot() {
+  if (count_ >= capacity_) {
+    return -1;
+  }
+  return (int)count_++;
+}
+
+size_t ecmcPIDBatch::getSlotCount() {
+  return count_;
+}
+
+size_t ecmcPIDBatch::paddedCount() {
+  return (count_ + ECMC_PID_BATCH_VEC_WIDTH - 1) /
+         ECMC_PID_BATCH_VEC_WIDTH * ECMC_PID_BATCH_VEC_WIDTH;
+}
+
+void ecmcPIDBatch::setParams(int    slot,
+                             double kp,
+                             double ki,
+                             double kd,
+                             double kff,
+                             double kpInner,
+                             double kiInner,
+                             double kdInner,
+                             double innerTol,
+                             double iMax,
+                             double iMin,
+                             double outMax,
+                             double outMin) {
+  kp_[slot]       = kp;
+  ki_[slot]       = ki;
+  kd_[slot]       = kd;
+  kff_[slot]      = kff;
+  kpInner_[slot]  = kpInner;
+  kiInner_[slot]  = kiInner;
+  kdInner_[slot]  = kdInner;
+  innerTol_[slot] = innerTol;
+  iMax_[slot]     = iMax;
+  iMin_[slot]     = iMin;
+  outMax_[slot]   = outMax;
+  outMin_[slot]   = outMin;
+}
+
+void ecmcPIDBatch::stage(int    slot,
+                         double posError,
+                         double ff,
+                         double distToTarget) {
+  posError_[slot]     = posError;
+  ff_[slot]           = ff;
+  distToTarget_[slot] = distToTarget;
+  staged_[slot]       = 1.0;
+}
+
+void ecmcPIDBatch::resetSlot(int slot) {
+  outI_[slot]   = 0;
+  errOld_[slot] = 0;
+  outP_[slot]   = 0;
+  outD_[slot]   = 0;
+  outFF_[slot]  = 0;
+  outTot_[slot] = 0;
+  staged_[slot] = 0;
+}
+
+void ecmcPIDBatch::execute() {
+  const size_t n = paddedCount();
+
+  if (verify_) {
+    memcpy(verifyOutI_,   outI_,   n * sizeof(double));
+    memcpy(verifyErrOld_, errOld_, n * sizeof(double));
+  }
+
+  const ecmcPIDBatchVec zero = {};
+
+  // n is padded to the vector width (unused slots are never staged)
+  for (size_t i = 0; i < n; i += ECMC_PID_BATCH_VEC_WIDTH) {
+    const ecmcPIDBatchVec e      = loadVec(posError_ + i);
+    const ecmcPIDBatchVec tol    = loadVec(innerTol_ + i);
+    const ecmcPIDBatchVec dist   = loadVec(distToTarget_ + i);
+    const ecmcPIDBatchVec iHi    = loadVec(iMax_ + i);
+    const ecmcPIDBatchVec iLo    = loadVec(iMin_ + i);
+    const ecmcPIDBatchVec oHi    = loadVec(outMax_ + i);
+    const ecmcPIDBatchVec oLo    = loadVec(outMin_ + i);
+    const ecmcPIDBatchVec iOld   = loadVec(outI_ + i);
+    const ecmcPIDBatchVec eOld   = loadVec(errOld_ + i);
+    const ecmcPIDBatchMask active = loadVec(staged_ + i) > zero;
+
+    // Inner parameters if distance to target is less than innerTol (>0)
+    const ecmcPIDBatchMask inner = (tol > zero) & (dist < tol);
+    const ecmcPIDBatchVec  kp    = inner ? loadVec(kpInner_ + i) : loadVec(kp_ + i);
+    const ecmcPIDBatchVec  ki    = inner ? loadVec(kiInner_ + i) : loadVec(ki_ + i);
+    const ecmcPIDBatchVec  kd    = inner ? loadVec(kdInner_ + i) : loadVec(kd_ + i);
+
+    const ecmcPIDBatchVec p  = e * kp;
+    ecmcPIDBatchVec iPart    = iOld + e * ki;
+
+    // Integrator limits enabled only when max>min
+    const ecmcPIDBatchMask iLim = iHi > iLo;
+    iPart = (iLim & (iPart > iHi)) ? iHi : iPart;
+    iPart = (iLim & (iPart < iLo)) ? iLo : iPart;
+
+    const ecmcPIDBatchVec d  = (e - eOld) * kd;
+    const ecmcPIDBatchVec ff = loadVec(ff_ + i) * loadVec(kff_ + i);
+    ecmcPIDBatchVec out      = p + iPart + d + ff;
+
+    // Output limits enabled only when max>min
+    const ecmcPIDBatchMask oLim = oHi > oLo;
+    out = (oLim & (out > oHi)) ? oHi : out;
+    out = (oLim & (out < oLo)) ? oLo : out;
+
+    // Slots not staged this cycle keep their state
+    storeVec(outP_ + i,   active ? p : loadVec(outP_ + i));
+    storeVec(outI_ + i,   active ? iPart : iOld);
+    storeVec(outD_ + i,   active ? d : loadVec(outD_ + i));
+    storeVec(outFF_ + i,  active ? ff : loadVec(outFF_ + i));
+    storeVec(outTot_ + i, active ? out : loadVec(outTot_ + i));
+    storeVec(errOld_ + i, active ? e : eOld);
+  }
+
+  if (verify_) {
+    verify();
+  }
+
+  memset(staged_, 0, n * sizeof(double));
+  executeCounter_++;
+}
+
+void ecmcPIDBatch::verify() {
+  for (size_t i = 0; i < count_; i++) {
+    if (!(staged_[i] > 0)) {
+      continue;
+    }
+    double p = 0, d = 0, ff = 0;
+    double out = controlScalar(posError_[i], ff_[i], distToTarget_[i],
+                               kp_[i], ki_[i], kd_[i], kff_[i],
+                               kpInner_[i], kiInner_[i], kdInner_[i],
+                               innerTol_[i], iMax_[i], iMin_[i],
+                               outMax_[i], outMin_[i],
+                               &verifyOutI_[i], &verifyErrOld_[i],
+                               &p, &d, &ff);
+
+    if (differs(out, outTot_[i]) || differs(verifyOutI_[i], outI_[i]) ||
+        differs(p, outP_[i]) || differs(d, outD_[i]) ||
+        differs(ff, outFF_[i])) {
+      // No printouts in rt, first mismatch is latched for printVerifyErrors()
+      if (verifyErrors_ == 0) {
+        verifyFirstSlot_      = i;
+        verifyFirstCycle_     = executeCounter_;
+        verifyFirstOut_       = outTot_[i];
+        verifyFirstOutScalar_ = out;
+        verifyFirstI_         = outI_[i];
+        verifyFirstIScalar_   = verifyOutI_[i];
+      }
+      verifyErrors_++;
+    }
+  }
+}
+
+bool ecmcPIDBatch::differs(double a, double b) {
+  double scale = fabs(a) > 1.0 ? fabs(a) : 1.0;
+
+  return fabs(a - b) > ECMC_PID_BATCH_VERIFY_TOL * scale;
+}
+
+double ecmcPIDBatch::getOutTot(int slot) {
+  return outTot_[slot];
+}
+
+double ecmcPIDBatch::getOutP(int slot) {
+  return outP_[slot];
+}
+
+double ecmcPIDBatch::getOutI(int slot) {
+  return outI_[slot];
+}
+
+double ecmcPIDBatch::getOutD(int slot) {
+  return outD_[slot];
+}
+
+double ecmcPIDBatch::getOutFF(int slot) {
+  return outFF_[slot];
+}
+
+void ecmcPIDBatch::setVerify(bool verify) {
+  verify_ = verify;
+}
+
+bool ecmcPIDBatch::getVerify() {
+  return verify_;
+}
+
+uint64_t ecmcPIDBatch::getVerifyErrorCount() {
+  return verifyErrors_;
+}
+
+void ecmcPIDBatch::printVerifyErrors() {
+  if (verifyErrors_ == 0) {
+    return;
+  }
+  LOGERR(
+    "%s/%s:%d: WARNING: PID batch differs from scalar in %" PRIu64 " slot evaluations. First in slot %zu, execute pass %" PRIu64 " (out %lf!=%lf, i %lf!=%lf).\n",
+    __FILE__,
+    __FUNCTION__,
+    __LINE__,
+    verifyErrors_,
+    verifyFirstSlot_,
+    verifyFirstCycle_,
+    verifyFirstOut_,
+    verifyFirstOutScalar_,
+    verifyFirstI_,
+    verifyFirstIScalar_);
+}
+
+uint64_t ecmcPIDBatch::getExecuteCount() {
+  return executeCounter_;
+}
+
+double ecmcPIDBatch::controlScalar(double  posError,
+                                   double  ff,
+                                   double  distToTarget,
+                                   double  kp,
+                                   double  ki,
+                                   double  kd,
+                                   double  kff,
+                                   double  kpInner,
+                                   double  kiInner,
+                                   double  kdInner,
+                                   double  innerTol,
+                                   double  iMax,
+                                   double  iMin,
+                                   double  outMax,
+                                   double  outMin,
+                                   double *outI,
+                                   double *errOld,
+                                   double *outP,
+                                   double *outD,
+                                   double *outFF) {
+  double kpUse = kp;
+  double kiUse = ki;
+  double kdUse = kd;
+
+  if (innerTol > 0) {
+    if (distToTarget < innerTol) {
+      kpUse = kpInner;
+      kiUse = kiInner;
+      kdUse = kdInner;
+    }
+  }
+
+  *outFF = ff * kff;
+  *outP  = posError * kpUse;
+  *outI  = *outI + posError * kiUse;
+
+  if ((iMax != iMin) && (iMax > iMin)) {
+    if (*outI > iMax) {
+      *outI = iMax;
+    }
+
+    if (*outI < iMin) {
+      *outI = iMin;
+    }
+  }
+  *outD = (posError - *errOld) * kdUse;
+  double out = *outP + *outI + *outD + *outFF;
+
+  if ((outMax != outMin) && (outMax > outMin)) {
+    if (out > outMax) {
+      out = outMax;
+    }
+
+    if (out < outMin) {
+      out = outMin;
+    }
+  }
+  *errOld = posError;
+  return out;
+}
@@ -0,0 +1,151 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcPIDBatch.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Batch evaluation of the PID/FF controllers of all CSV axes.
+* Controller parameters and state are kept in a structure-of-arrays so that
+* one branch free pass over all slots is executed with SIMD instructions
+* (GCC vector extensions, SSE2 or AVX depending on target flags).
+* Each axis stages its inputs with ecmcPIDController::stage(), then
+* execute() is called and the outputs are collected with
+* ecmcPIDController::collect(). execute() runs once per cycle, or more
+* often if nodes in the execution order use axes staged earlier in the
+* same cycle (see exeOrderBatchCollect()).
+*
+\*************************************************************************/
+
+#ifndef ECMCPIDBATCH_H_
+#define ECMCPIDBATCH_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ERROR_PID_BATCH_FULL 0x14510
+#define ERROR_PID_BATCH_ALLOC_FAIL 0x14511
+
+#ifdef __AVX__
+#define ECMC_PID_BATCH_VEC_WIDTH 4
+#else
+#define ECMC_PID_BATCH_VEC_WIDTH 2
+#endif
+
+// Relative tolerance used when comparing batch and scalar outputs
+#define ECMC_PID_BATCH_VERIFY_TOL 1e-9
+
+class ecmcPIDBatch {
+public:
+  explicit ecmcPIDBatch(size_t capacity);
+  ~ecmcPIDBatch();
+
+  // Returns slot index or -1 if full
+  int      addSlot();
+  size_t   getSlotCount();
+
+  // Set all parameters of one slot (called from ecmcPIDController::stage())
+  void     setParams(int    slot,
+                     double kp,
+                     double ki,
+                     double kd,
+                     double kff,
+                     double kpInner,
+                     double kiInner,
+                     double kdInner,
+                     double innerTol,
+                     double iMax,
+                     double iMin,
+                     double outMax,
+                     double outMin);
+
+  // Stage inputs of one slot for the next execute()
+  void     stage(int    slot,
+                 double posError,
+                 double ff,
+                 double distToTarget);
+
+  // Clear integrator and derivative state of one slot
+  void     resetSlot(int slot);
+
+  // One pass over all slots. Only staged slots update state/outputs.
+  void     execute();
+
+  double   getOutTot(int slot);
+  double   getOutP(int slot);
+  double   getOutI(int slot);
+  double   getOutD(int slot);
+  double   getOutFF(int slot);
+
+  // Compare every batch result with the scalar implementation
+  void     setVerify(bool verify);
+  bool     getVerify();
+  uint64_t getVerifyErrorCount();
+
+  // Print count and first mismatch (not from rt, nothing printed in verify)
+  void     printVerifyErrors();
+  uint64_t getExecuteCount();
+
+  // Scalar reference (same math as ecmcPIDController::control())
+  static double controlScalar(double  posError,
+                              double  ff,
+                              double  distToTarget,
+                              double  kp,
+                              double  ki,
+                              double  kd,
+                              double  kff,
+                              double  kpInner,
+                              double  kiInner,
+                              double  kdInner,
+                              double  innerTol,
+                              double  iMax,
+                              double  iMin,
+                              double  outMax,
+                              double  outMin,
+                              double *outI,
+                              double *errOld,
+                              double *outP,
+                              double *outD,
+                              double *outFF);
+
+private:
+  size_t   paddedCount();
+  void     verify();
+  bool     differs(double a,
+                   double b);
+
+  size_t capacity_;
+  size_t count_;
+  bool verify_;
+  uint64_t verifyErrors_;
+  uint64_t executeCounter_;
+
+  // Parameters
+  double *kp_, *ki_, *kd_, *kff_;
+  double *kpInner_, *kiInner_, *kdInner_, *innerTol_;
+  double *iMax_, *iMin_, *outMax_, *outMin_;
+
+  // Inputs (one cycle)
+  double *posError_, *ff_, *distToTarget_;
+  double *staged_;  // 1.0 if staged this cycle, else 0.0
+
+  // State
+  double *outI_, *errOld_;
+
+  // Outputs
+  double *outP_, *outD_, *outFF_, *outTot_;
+
+  // Shadow state for verification
+  double *verifyOutI_, *verifyErrOld_;
+
+  // First mismatch
+  size_t verifyFirstSlot_;
+  uint64_t verifyFirstCycle_;
+  double verifyFirstOut_, verifyFirstOutScalar_;
+  double verifyFirstI_, verifyFirstIScalar_;
+};
+
+#endif  /* ECMCPIDBATCH_H_ */
@@ -87,6 +87,8 @@ void ecmcPIDController::initVars() {
   ki_inner_           = 0;
   kd_inner_           = 0;
   innerTol_           = 0;
+  batch_              = NULL;
+  batchSlot_          = -1;
 }
 
 ecmcPIDController::~ecmcPIDController() {}
@@ -98,6 +100,10 @@ void ecmcPIDController::reset() {
   ff_                        = 0;
   controllerErrorOld_        = 0;
   data_->status_.cntrlOutput = 0;
+
+  if (batch_) {
+    batch_->resetSlot(batchSlot_);
+  }
 }
 
 void ecmcPIDController::setIRange(double iMax, double iMin) {
@@ -226,6 +232,71 @@ double ecmcPIDController::control(double posError, double ff) {
   return data_->status_.cntrlOutput;
 }
 
+int ecmcPIDController::attachToBatch(ecmcPIDBatch *batch) {
+  if (batch_) {
+    return 0;
+  }
+
+  int slot = batch->addSlot();
+
+  if (slot < 0) {
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PID_BATCH_FULL);
+  }
+  batch_     = batch;
+  batchSlot_ = slot;
+  reset();
+  return 0;
+}
+
+bool ecmcPIDController::getAttachedToBatch() {
+  return batch_ != NULL;
+}
+
+bool ecmcPIDController::stage(double posError, double ff) {
+  // Same enable logic as control()
+  if (!data_->status_.statusWord_.enable || data_->interlocks_.driveSummaryInterlock) {
+    reset();
+    return false;
+  }
+
+  // Refresh params every cycle since kp, ki, kd and kff can be written
+  // directly from asyn
+  batch_->setParams(batchSlot_,
+                    kp_,
+                    ki_,
+                    kd_,
+                    kff_,
+                    kp_inner_,
+                    ki_inner_,
+                    kd_inner_,
+                    innerTol_,
+                    outputIMax_,
+                    outputIMin_,
+                    outputMax_,
+                    outputMin_);
+  batch_->stage(batchSlot_,
+                posError,
+                ff,
+                std::abs(data_->status_.currentTargetPosition -
+                         data_->status_.currentPositionActual));
+
+  // Keep scalar state in sync (in case control() is used later)
+  controllerErrorOld_ = posError;
+  return true;
+}
+
+double ecmcPIDController::collect() {
+  outputP_                   = batch_->getOutP(batchSlot_);
+  outputI_                   = batch_->getOutI(batchSlot_);
+  outputD_                   = batch_->getOutD(batchSlot_);
+  ff_                        = batch_->getOutFF(batchSlot_);
+  data_->status_.cntrlOutput = batch_->getOutTot(batchSlot_);
+  return data_->status_.cntrlOutput;
+}
+
 int ecmcPIDController::validate() {
   if (data_->status_.sampleTime <= 0) {
     return setErrorID(__FILE__,
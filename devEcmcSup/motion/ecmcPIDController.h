@@ -20,6 +20,7 @@
 #include "ecmcDefinitions.h"
 #include "ecmcAsynPortDriver.h"
 #include "ecmcErrorsList.h"
+#include "ecmcPIDBatch.h"
 
 class ecmcPIDController : public ecmcError {
 public:
@@ -75,6 +76,14 @@ public:
   void   setIOutMin(double outMin);
   int    validate();
 
+  // Batch mode (see ecmcPIDBatch): stage() replaces control() and the
+  // result is read with collect() after ecmcPIDBatch::execute()
+  int    attachToBatch(ecmcPIDBatch *batch);
+  bool   getAttachedToBatch();
+  bool   stage(double posError,
+               double ff);
+  double collect();
+
 private:
   int    initAsyn();
   double kp_, ki_, kd_, kff_;
@@ -97,6 +106,8 @@ private:
   double sampleTime_;
   ecmcAxisData *data_;
   bool settingMade_;
+  ecmcPIDBatch *batch_;
+  int batchSlot_;
 
   // Asyn
   ecmcAsynPortDriver *asynPortDriver_;
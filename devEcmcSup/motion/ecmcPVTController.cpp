@@ -50,9 +50,9 @@ ecmcPVTController::ecmcPVTController(ecmcAsynPortDriver *asynPortDriver,
   state_          = ECMC_PVT_IDLE;
   stateOld_       = ECMC_PVT_IDLE;
   busy_           = 0;
-  startPositions_.reserve(ECMC_MAX_AXES);
-  axes_.reserve(ECMC_MAX_AXES);
-  pvtObjs_.reserve(ECMC_MAX_AXES);
+  startPositions_.reserve(ECMC_DEFAULT_AXES);
+  axes_.reserve(ECMC_DEFAULT_AXES);
+  pvtObjs_.reserve(ECMC_DEFAULT_AXES);
   triggerDefined_ = 0;
   triggerEcEntryIndex_ = 0;
   triggerCount_        = 0;
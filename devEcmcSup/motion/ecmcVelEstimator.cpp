@@ -0,0 +1,88 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcVelEstimator.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcVelEstimator.h"
+#include <cmath>
+
+ecmcVelEstimator::ecmcVelEstimator() {
+  type_      = ECMC_VEL_EST_FILTER;
+  timeConst_ = 0.01;
+  reset();
+}
+
+ecmcVelEstimator::~ecmcVelEstimator() {}
+
+int ecmcVelEstimator::setType(int type) {
+  if ((type < ECMC_VEL_EST_FILTER) || (type > ECMC_VEL_EST_ALPHA_BETA_GAMMA)) {
+    return ERROR_VEL_EST_TYPE_INVALID;
+  }
+  type_ = type;
+  reset();
+  return 0;
+}
+
+int ecmcVelEstimator::getType() {
+  return type_;
+}
+
+int ecmcVelEstimator::setTimeConst(double timeConst) {
+  if (!(timeConst > 0)) {
+    return ERROR_VEL_EST_TIME_CONST_INVALID;
+  }
+  timeConst_ = timeConst;
+  return 0;
+}
+
+double ecmcVelEstimator::getTimeConst() {
+  return timeConst_;
+}
+
+void ecmcVelEstimator::reset() {
+  posErr_ = 0;
+  vel_    = 0;
+  acc_    = 0;
+}
+
+void ecmcVelEstimator::update(double dist, double dt) {
+  if (dt <= 0) {
+    return;
+  }
+
+  double theta = exp(-dt / timeConst_);
+  double c     = 1 - theta;
+
+  // Residual of predicted position (measured position moved dist)
+  double r = dist - vel_ * dt - 0.5 * acc_ * dt * dt - posErr_;
+  double g, h;
+
+  vel_ += acc_ * dt;
+
+  if (type_ == ECMC_VEL_EST_ALPHA_BETA_GAMMA) {
+    g     = 1 - theta * theta * theta;
+    h     = 1.5 * c * c * (1 + theta);
+    acc_ += c * c * c * r / (dt * dt);  // 2*k*r/dt^2
+  } else {
+    g    = 1 - theta * theta;
+    h    = c * c;
+    acc_ = 0;
+  }
+  vel_   += h * r / dt;
+  posErr_ = (g - 1) * r;
+}
+
+double ecmcVelEstimator::getVel(double dt) {
+  return vel_ + acc_ * dt;
+}
+
+double ecmcVelEstimator::getAcc() {
+  return acc_;
+}
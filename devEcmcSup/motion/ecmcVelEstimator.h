@@ -0,0 +1,71 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcVelEstimator.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Model based velocity estimation (alternative to the moving average of
+* ecmcFilter, which lags filterSize/2 cycles). A critically damped tracking
+* filter (fading memory polynomial filter) with constant velocity
+* (alpha-beta) or constant acceleration (alpha-beta-gamma) model:
+*   predict:  x' = x + v*dt + a*dt^2/2,  v' = v + a*dt
+*   residual: r  = z - x'
+*   correct:  x = x' + g*r,  v = v' + h*r/dt,  a = a + 2*k*r/dt^2
+* with the gains from theta = exp(-dt/timeConst):
+*   alpha-beta:       g = 1-theta^2, h = (1-theta)^2
+*   alpha-beta-gamma: g = 1-theta^3, h = 1.5*(1-theta)^2*(1+theta),
+*                     k = 0.5*(1-theta)^3
+* No lag for constant velocity (alpha-beta) or constant acceleration
+* (alpha-beta-gamma), noise reduction set by timeConst. dt can vary
+* between updates (measurement times from encoder timestamps).
+* The position state is kept relative to the last measurement, so the
+* estimator only needs the distance travelled since the last update.
+*
+\*************************************************************************/
+
+#ifndef ECMC_VEL_ESTIMATOR_H_
+#define ECMC_VEL_ESTIMATOR_H_
+
+#define ERROR_VEL_EST_TYPE_INVALID 0x14430
+#define ERROR_VEL_EST_TIME_CONST_INVALID 0x14431
+
+// Reset if the next count is overdue by this factor (standstill)
+#define ECMC_VEL_EST_OVERDUE_FACTOR 2.0
+
+enum ecmcVelEstType {
+  ECMC_VEL_EST_FILTER           = 0,  // Moving average (ecmcFilter)
+  ECMC_VEL_EST_ALPHA_BETA       = 1,
+  ECMC_VEL_EST_ALPHA_BETA_GAMMA = 2,
+};
+
+class ecmcVelEstimator {
+public:
+  ecmcVelEstimator();
+  ~ecmcVelEstimator();
+  int    setType(int type);
+  int    getType();
+  int    setTimeConst(double timeConst);  // [s]
+  double getTimeConst();
+  void   reset();
+
+  // Measurement dist [eng] travelled in dt [s] since last update
+  void   update(double dist,
+                double dt);
+
+  // Velocity extrapolated dt [s] after last update
+  double getVel(double dt);
+  double getAcc();
+
+private:
+  int type_;
+  double timeConst_;
+  double posErr_;  // Estimated minus measured position
+  double vel_;
+  double acc_;
+};
+
+#endif  /* ECMC_VEL_ESTIMATOR_H_ */
@@ -15,6 +15,7 @@
 #include "ecmcMotorRecordAxis.h"
 #include "ecmcMotorRecordController.h"
 #include "ecmcGlobalsExtern.h"
+#include "ecmcMainThread.h"
 #include "ecmcPluginClient.h"
 
 #ifndef ASYN_TRACE_INFO
@@ -336,9 +337,9 @@ extern "C" int ecmcMotorRecordCreateAxis(const char *controllerPortName,
                                          int         axisNo,
                                          int         axisFlags,
                                          const char *axisOptionsStr) {
-  if ((axisNo >= ECMC_MAX_AXES) || (axisNo < 0)) {
+  if (!axes.validIndex(axisNo)) {
     printf("ERROR: axisNo out of range. Allowed values 0..%d\n",
-           ECMC_MAX_AXES - 1);
+           axes.size() - 1);
     return asynError;
   }
 
@@ -401,8 +402,9 @@ extern "C" int ecmcMotorRecordCreateAxis(const char *controllerPortName,
     return asynError;
   }
 
-  if ((axisNo >= ECMC_MAX_AXES) || (axisNo < 0)) {
-    printf("ERROR: Axis index out of range.\n");
+  if ((axisNo >= pC->maxAddr) || (axisNo < 0)) {
+    printf("ERROR: Axis index out of range for controller (max %d, see Cfg.SetMaxAxes()).\n",
+           pC->maxAddr - 1);
     return asynError;
   }
 
@@ -511,37 +513,35 @@ int ecmcMotorRecordAxis::applyMotorSoftLimitChange(bool   updateFwd,
   double oldFwd     = 0.0;
   int    errorCode  = 0;
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
+  int rtError = ecmcRTExec([&]() {
+    oldBwd = drvlocal.ecmcAxis->getMon()->getSoftLimitBwd();
+    oldFwd = drvlocal.ecmcAxis->getMon()->getSoftLimitFwd();
 
-  oldBwd = drvlocal.ecmcAxis->getMon()->getSoftLimitBwd();
-  oldFwd = drvlocal.ecmcAxis->getMon()->getSoftLimitFwd();
-
-  if (updateFwd) {
-    errorCode = drvlocal.ecmcAxis->getMon()->setSoftLimitFwd(value);
-  } else {
-    errorCode = drvlocal.ecmcAxis->getMon()->setSoftLimitBwd(value);
-  }
+    if (updateFwd) {
+      errorCode = drvlocal.ecmcAxis->getMon()->setSoftLimitFwd(value);
+    } else {
+      errorCode = drvlocal.ecmcAxis->getMon()->setSoftLimitBwd(value);
+    }
 
-  if (!errorCode) {
-    currentBwd = drvlocal.ecmcAxis->getMon()->getSoftLimitBwd();
-    currentFwd = drvlocal.ecmcAxis->getMon()->getSoftLimitFwd();
+    if (!errorCode) {
+      currentBwd = drvlocal.ecmcAxis->getMon()->getSoftLimitBwd();
+      currentFwd = drvlocal.ecmcAxis->getMon()->getSoftLimitFwd();
 
-    if (currentBwd == 0.0 && currentFwd == 0.0) {
-      errorCode = drvlocal.ecmcAxis->getMon()->setEnableSoftLimitBwd(0);
-      if (!errorCode) {
-        errorCode = drvlocal.ecmcAxis->getMon()->setEnableSoftLimitFwd(0);
-      }
-    } else if (oldBwd == 0.0 && oldFwd == 0.0 &&
-               currentBwd < currentFwd) {
-      errorCode = drvlocal.ecmcAxis->getMon()->setEnableSoftLimitBwd(1);
-      if (!errorCode) {
-        errorCode = drvlocal.ecmcAxis->getMon()->setEnableSoftLimitFwd(1);
+      if (currentBwd == 0.0 && currentFwd == 0.0) {
+        errorCode = drvlocal.ecmcAxis->getMon()->setEnableSoftLimitBwd(0);
+        if (!errorCode) {
+          errorCode = drvlocal.ecmcAxis->getMon()->setEnableSoftLimitFwd(0);
+        }
+      } else if (oldBwd == 0.0 && oldFwd == 0.0 &&
+                 currentBwd < currentFwd) {
+        errorCode = drvlocal.ecmcAxis->getMon()->setEnableSoftLimitBwd(1);
+        if (!errorCode) {
+          errorCode = drvlocal.ecmcAxis->getMon()->setEnableSoftLimitFwd(1);
+        }
       }
     }
-  }
-
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
-  return errorCode;
+  });
+  return rtError ? rtError : errorCode;
 }
 
 asynStatus ecmcMotorRecordAxis::syncEcmcSoftLimits() {
@@ -564,12 +564,16 @@ asynStatus ecmcMotorRecordAxis::syncEcmcSoftLimits(bool force, bool updateParams
   int    enabledFwd = 0,  enabledBwd = 0;
   double fValueFwd = 0.0, fValueBwd  = 0.0;
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  fValueBwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitBwd();
-  fValueFwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitFwd();
-  enabledBwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitBwd();
-  enabledFwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitFwd();
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int rtError = ecmcRTExec([&]() {
+    fValueBwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitBwd();
+    fValueFwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitFwd();
+    enabledBwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitBwd();
+    enabledFwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitFwd();
+  });
+
+  if (rtError) {
+    return asynError;
+  }
 
   asynMotorAxis::setIntegerParam(pC_->ecmcMotorRecordCfgDLLM_En_, enabledBwd);
   asynMotorAxis::setDoubleParam(pC_->ecmcMotorRecordCfgDLLM_, fValueBwd);
@@ -602,12 +606,16 @@ asynStatus ecmcMotorRecordAxis::syncMotorSoftLimits(bool force, bool updateParam
   int enabledFwd = 0,  enabledBwd = 0;
   double fValueFwd = 0.0, fValueBwd  = 0.0;
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  fValueBwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitBwd();
-  fValueFwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitFwd();
-  enabledBwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitBwd();
-  enabledFwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitFwd();
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int rtError = ecmcRTExec([&]() {
+    fValueBwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitBwd();
+    fValueFwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitFwd();
+    enabledBwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitBwd();
+    enabledFwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitFwd();
+  });
+
+  if (rtError) {
+    return asynError;
+  }
 
   if((enabledBwd == 0 && enabledFwd == 0) || (fValueBwd == 0 && fValueFwd == 0)) {
     asynMotorAxis::setDoubleParam(pC_->motorLowLimitRO_,  0);
@@ -643,12 +651,16 @@ asynStatus ecmcMotorRecordAxis::readBackSoftLimits(bool updateMotor) {
   int enabledFwd = 0,  enabledBwd = 0;
   double fValueFwd = 0.0, fValueBwd  = 0.0;
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  fValueBwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitBwd();
-  fValueFwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitFwd();
-  enabledBwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitBwd();
-  enabledFwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitFwd();
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int rtError = ecmcRTExec([&]() {
+    fValueBwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitBwd();
+    fValueFwd  = drvlocal.ecmcAxis->getMon()->getSoftLimitFwd();
+    enabledBwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitBwd();
+    enabledFwd = drvlocal.ecmcAxis->getMon()->getEnableSoftLimitFwd();
+  });
+
+  if (rtError) {
+    return asynError;
+  }
 
   pC_->setIntegerParam(axisNo_, pC_->ecmcMotorRecordCfgDLLM_En_, enabledBwd);
   pC_->setDoubleParam(axisNo_, pC_->ecmcMotorRecordCfgDLLM_, fValueBwd);
@@ -669,10 +681,9 @@ asynStatus ecmcMotorRecordAxis::readScaling(int axisID) {
   int errorCode = 0;
   double num = 0, denom = 0;
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  errorCode = drvlocal.ecmcAxis->getEncScaleNum(&num);
-
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  errorCode = ecmcRTExec([&]() {
+    return drvlocal.ecmcAxis->getEncScaleNum(&num);
+  });
 
   if (errorCode) {
     LOGERR(
@@ -684,10 +695,9 @@ asynStatus ecmcMotorRecordAxis::readScaling(int axisID) {
     return asynError;
   }
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  errorCode = drvlocal.ecmcAxis->getEncScaleDenom(&denom);
-
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  errorCode = ecmcRTExec([&]() {
+    return drvlocal.ecmcAxis->getEncScaleDenom(&denom);
+  });
 
   if (errorCode) {
     LOGERR(
@@ -729,19 +739,22 @@ asynStatus ecmcMotorRecordAxis::readMonitoring(int axisID) {
   int    poslag_enable, attarget_enable;
 
   // Position lag monitoring (following error)
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  poslag_tol  = drvlocal.ecmcAxis->getMon()->getPosLagTol();
-  poslag_time = drvlocal.ecmcAxis->getMon()->getPosLagTime() * 1 /
-                mcuFrequency;
-  poslag_enable = drvlocal.ecmcAxis->getMon()->getEnableLagMon();
-
-  // At target monitoring (must be enabled)
-  attarget_tol  = drvlocal.ecmcAxis->getMon()->getAtTargetTol();
-  attarget_time = drvlocal.ecmcAxis->getMon()->getAtTargetTime() * 1 /
+  int rtError = ecmcRTExec([&]() {
+    poslag_tol  = drvlocal.ecmcAxis->getMon()->getPosLagTol();
+    poslag_time = drvlocal.ecmcAxis->getMon()->getPosLagTime() * 1 /
                   mcuFrequency;
-  attarget_enable = drvlocal.ecmcAxis->getMon()->getEnableAtTargetMon();
+    poslag_enable = drvlocal.ecmcAxis->getMon()->getEnableLagMon();
+
+    // At target monitoring (must be enabled)
+    attarget_tol  = drvlocal.ecmcAxis->getMon()->getAtTargetTol();
+    attarget_time = drvlocal.ecmcAxis->getMon()->getAtTargetTime() * 1 /
+                    mcuFrequency;
+    attarget_enable = drvlocal.ecmcAxis->getMon()->getEnableAtTargetMon();
+  });
 
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  if (rtError) {
+    return asynError;
+  }
 
   // At target monitoring must be enabled
   if(!attarget_enable || !attarget_tol) {
@@ -790,11 +803,14 @@ asynStatus ecmcMotorRecordAxis::readMonitoring(int axisID) {
 asynStatus ecmcMotorRecordAxis::readBackVelocities(int axisID) {
   double vel_max, acceleration;
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  vel_max      = drvlocal.ecmcAxis->getMon()->getMaxVel();
-  acceleration = drvlocal.ecmcAxis->getTraj()->getAcc();
+  int rtError = ecmcRTExec([&]() {
+    vel_max      = drvlocal.ecmcAxis->getMon()->getMaxVel();
+    acceleration = drvlocal.ecmcAxis->getTraj()->getAcc();
+  });
 
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  if (rtError) {
+    return asynError;
+  }
 
   if (drvlocal.manualVelocFast > 0.0) {
     updateCfgValue(pC_->ecmcMotorRecordCfgVELO_,
@@ -920,17 +936,6 @@ asynStatus ecmcMotorRecordAxis::move(double position,
         maxVelocity,
         acceleration);
   }
-  printf("%s/%s:%d: Axis[%d]: move(): tgtpos=%lf, rel=%d, velo = %lf..%lf, acc=%lf\n",
-        __FILE__,
-        __FUNCTION__,
-        __LINE__,
-        drvlocal.axisId,
-        position,
-        relative,
-        minVelocity,
-        maxVelocity,
-        acceleration);
-
   //asynPrint(pPrintOutAsynUser,
   //          ASYN_TRACE_INFO,
   //          "%s/%s:%d: Axis[%d] Move cmd: trgpos=%lf, rel=%d, velo = %lf..%lf, acc=%lf\n",
@@ -952,14 +957,63 @@ asynStatus ecmcMotorRecordAxis::move(double position,
     return asynSuccess;
   }
 
-  int errorCode = 0;
+  // Staged, applied together with the other axes when DEFER_MOVES is reset
+  if (pC_->deferMoves_) {
+    if (pC_->deferredCmd_.addMove(drvlocal.ecmcAxis,
+                                  position,
+                                  relative,
+                                  maxVelocity,
+                                  acceleration,
+                                  acceleration)) {
+      return asynError;
+    }
+    setMoveStaged();
+    return asynSuccess;
+  }
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  
-  // Communication to axis blocked
-  if (drvlocal.ecmcAxis->getBlockCom()) {
-    if (ecmcRTMutex) epicsMutexUnlock(ecmcRTMutex);
-    drvlocal.ecmcAxis->setExternalCommandBlockedError();
+  int errorCode  = 0;
+  int comBlocked = 0;
+  int blocked    = 0;
+
+  int rtError = ecmcRTExec([&]() {
+    // Communication to axis blocked
+    comBlocked = drvlocal.ecmcAxis->getBlockCom();
+    if (comBlocked) {
+      drvlocal.ecmcAxis->setExternalCommandBlockedError();
+      return;
+    }
+
+    // Axis blocked (maybe by master slave statemachine, only one grouop can accept commands at a time)
+    blocked = drvlocal.ecmcAxis->getBlocked();
+    if (blocked) {
+      return;
+    }
+
+    if (relative) {
+      errorCode = drvlocal.ecmcAxis->moveRelativePosition(position,
+                                                          maxVelocity,
+                                                          acceleration,
+                                                          acceleration);
+    } else {
+      errorCode = drvlocal.ecmcAxis->moveAbsolutePosition(position,
+                                                          maxVelocity,
+                                                          acceleration,
+                                                          acceleration);
+    }
+
+    if (!errorCode) {
+      // Latch command timing while exclusive with the rt thread so poll()
+      // cannot observe accepted motion with stale moveReady state.
+      latchNewMoveCmd();
+      commandAccepted = true;
+    }
+  });
+
+  if (rtError) {
+    return asynError;
+  }
+
+  if (comBlocked) {
     LOGERR(
       "%s/%s:%d: ERROR: Axis[%d]: Communication to ECMC blocked, motion commands not allowed..\n",
       __FILE__,
@@ -968,9 +1022,7 @@ asynStatus ecmcMotorRecordAxis::move(double position,
     return asynError;
   }
 
-  // Axis blocked (maybe by master slave statemachine, only one grouop can accept commands at a time)
-  if (drvlocal.ecmcAxis->getBlocked()) {
-    if (ecmcRTMutex) epicsMutexUnlock(ecmcRTMutex);
+  if (blocked) {
     LOGERR(
       "%s/%s:%d: ERROR: Axis[%d]: Axis blocked (could be Masters/Slave related).\n",
       __FILE__,
@@ -979,33 +1031,8 @@ asynStatus ecmcMotorRecordAxis::move(double position,
     return asynError;
   }
 
-  if (relative) {
-    errorCode = drvlocal.ecmcAxis->moveRelativePosition(position,
-                                                        maxVelocity,
-                                                        acceleration,
-                                                        acceleration);
-  } else {
-    errorCode = drvlocal.ecmcAxis->moveAbsolutePosition(position,
-                                                        maxVelocity,
-                                                        acceleration,
-                                                        acceleration);
-  }
-
-  if (!errorCode) {
-    // Latch command timing while RT mutex is still held so poll() cannot
-    // observe accepted motion with stale moveReady state.
-    drvlocal.moveReady = false;
-    ecmcCycleCounterAtNewCmd_ = drvlocal.ecmcAxis->getCycleCounter();
-#ifndef motorWaitPollsBeforeReadyString
-    drvlocal.waitNumPollsBeforeReady += WAITNUMPOLLSBEFOREREADY;
-#endif // ifndef motorWaitPollsBeforeReadyString
-    commandAccepted = true;
-  }
-
   //printf("Axis[%d]:ecmcMotorRecordAxis::move(): ecmc busy %d\n", axisNo_,drvlocal.ecmcAxis->getBusy());
 
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
-
   if (commandAccepted) {
     // update motor record
     setIntegerParam(pC_->motorStatusMoving_, 1);
@@ -1080,11 +1107,16 @@ asynStatus ecmcMotorRecordAxis::home(double minVelocity,
   double drvScale = 0.0;
   if(useHVEL) {
     // read drive scale maxVelocity, acceleration are in raw units
-    if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-    if(drvlocal.ecmcAxis->getDrv() != NULL) {
-      drvScale = drvlocal.ecmcAxis->getDrv()->getScale();
+    int rtError = ecmcRTExec([&]() {
+      if(drvlocal.ecmcAxis->getDrv() != NULL) {
+        drvScale = drvlocal.ecmcAxis->getDrv()->getScale();
+      }
+    });
+
+    if (rtError) {
+      return asynError;
     }
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+
     drvScale = std::abs(drvScale);    
     if(drvScale > 0) {  
       useHVELOk = true;
@@ -1131,14 +1163,44 @@ asynStatus ecmcMotorRecordAxis::home(double minVelocity,
     }
   }
   
-  int errorCode = 0;
+  int errorCode  = 0;
+  int comBlocked = 0;
+  int blocked    = 0;
+
+  int rtError = ecmcRTExec([&]() {
+    comBlocked = drvlocal.ecmcAxis->getBlockCom();
+    if (comBlocked) {
+      drvlocal.ecmcAxis->setExternalCommandBlockedError();
+      return;
+    }
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
+    // Axis blocked (maybe by master slave statemachine, only one grouop can accept commands at a time)
+    blocked = drvlocal.ecmcAxis->getBlocked();
+    if (blocked) {
+      return;
+    }
 
-  if (drvlocal.ecmcAxis->getBlockCom()) {
-    if (ecmcRTMutex) epicsMutexUnlock(ecmcRTMutex);
-    drvlocal.ecmcAxis->setExternalCommandBlockedError();
+    // "-1" will lead to not overwriting anything that is set in ecmc
+    errorCode =  drvlocal.ecmcAxis->moveHome(cmdData,
+                                             homPos,
+                                             velToCam,
+                                             velOffCam,
+                                             accHom,
+                                             accHom);
+
+    if (!errorCode) {
+      // Latch command timing while exclusive with the rt thread so poll()
+      // cannot observe accepted motion with stale moveReady state.
+      latchNewMoveCmd();
+      commandAccepted = true;
+    }
+  });
 
+  if (rtError) {
+    return asynError;
+  }
+
+  if (comBlocked) {
     LOGERR(
       "%s/%s:%d: ERROR: Communication to ECMC blocked, motion commands not allowed..\n",
       __FILE__,
@@ -1146,10 +1208,8 @@ asynStatus ecmcMotorRecordAxis::home(double minVelocity,
       __LINE__);
     return asynError;
   }
-  
-  // Axis blocked (maybe by master slave statemachine, only one grouop can accept commands at a time)
-  if (drvlocal.ecmcAxis->getBlocked()) {
-    if (ecmcRTMutex) epicsMutexUnlock(ecmcRTMutex);
+
+  if (blocked) {
     LOGERR(
       "%s/%s:%d: ERROR: Axis[%d]: Axis blocked (could be Masters/Slave related).\n",
       __FILE__,
@@ -1158,27 +1218,6 @@ asynStatus ecmcMotorRecordAxis::home(double minVelocity,
     return asynError;
   }
 
-  // "-1" will lead to not overwriting anything that is set in ecmc
-  errorCode =  drvlocal.ecmcAxis->moveHome(cmdData,
-                                           homPos,
-                                           velToCam,
-                                           velOffCam,
-                                           accHom,
-                                           accHom);
-
-  if (!errorCode) {
-    // Latch command timing while RT mutex is still held so poll() cannot
-    // observe accepted motion with stale moveReady state.
-    drvlocal.moveReady = false;
-    ecmcCycleCounterAtNewCmd_ = drvlocal.ecmcAxis->getCycleCounter();
-#ifndef motorWaitPollsBeforeReadyString
-    drvlocal.waitNumPollsBeforeReady += WAITNUMPOLLSBEFOREREADY;
-#endif // ifndef motorWaitPollsBeforeReadyString
-    commandAccepted = true;
-  }
-
-  if (ecmcRTMutex) epicsMutexUnlock(ecmcRTMutex);
-
   if (commandAccepted) {
     // update motor record
     setIntegerParam(pC_->motorStatusMoving_, 1);
@@ -1238,13 +1277,52 @@ asynStatus ecmcMotorRecordAxis::moveVelocity(double minVelocity,
     acc = -acc;
   }
 
-  int errorCode = 0;
+  // Staged, applied together with the other axes when DEFER_MOVES is reset
+  if (pC_->deferMoves_) {
+    if (pC_->deferredCmd_.addMoveVelo(drvlocal.ecmcAxis,
+                                      velo,
+                                      acc,
+                                      acc)) {
+      return asynError;
+    }
+    setMoveStaged();
+    return asynSuccess;
+  }
+
+  int errorCode  = 0;
+  int comBlocked = 0;
+  int blocked    = 0;
+
+  int rtError = ecmcRTExec([&]() {
+    comBlocked = drvlocal.ecmcAxis->getBlockCom();
+    if (comBlocked) {
+      drvlocal.ecmcAxis->setExternalCommandBlockedError();
+      return;
+    }
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
+    // Axis blocked (maybe by master slave statemachine, only one grouop can accept commands at a time)
+    blocked = drvlocal.ecmcAxis->getBlocked();
+    if (blocked) {
+      return;
+    }
+
+    errorCode = drvlocal.ecmcAxis->moveVelocity(velo,
+                                                acc,
+                                                acc);
+
+    if (!errorCode) {
+      // Latch command timing while exclusive with the rt thread so poll()
+      // cannot observe accepted motion with stale moveReady state.
+      latchNewMoveCmd();
+      commandAccepted = true;
+    }
+  });
+
+  if (rtError) {
+    return asynError;
+  }
 
-  if (drvlocal.ecmcAxis->getBlockCom()) {
-    if (ecmcRTMutex) epicsMutexUnlock(ecmcRTMutex);
-    drvlocal.ecmcAxis->setExternalCommandBlockedError();
+  if (comBlocked) {
     LOGERR(
       "%s/%s:%d: ERROR: Communication to ECMC blocked, motion commands not allowed..\n",
       __FILE__,
@@ -1253,9 +1331,7 @@ asynStatus ecmcMotorRecordAxis::moveVelocity(double minVelocity,
     return asynError;
   }
 
-  // Axis blocked (maybe by master slave statemachine, only one grouop can accept commands at a time)
-  if (drvlocal.ecmcAxis->getBlocked()) {
-    if (ecmcRTMutex) epicsMutexUnlock(ecmcRTMutex);
+  if (blocked) {
     LOGERR(
       "%s/%s:%d: ERROR: Axis[%d]: Axis blocked (could be Masters/Slave related).\n",
       __FILE__,
@@ -1264,33 +1340,6 @@ asynStatus ecmcMotorRecordAxis::moveVelocity(double minVelocity,
     return asynError;
   }
 
-  // if(drvlocal.ecmcAxis->getAllowConstVelo()) {
-  errorCode = drvlocal.ecmcAxis->moveVelocity(velo,
-                                              acc,
-                                              acc);
-
-  if (!errorCode) {
-    // Latch command timing while RT mutex is still held so poll() cannot
-    // observe accepted motion with stale moveReady state.
-    drvlocal.moveReady = false;
-    ecmcCycleCounterAtNewCmd_ = drvlocal.ecmcAxis->getCycleCounter();
-#ifndef motorWaitPollsBeforeReadyString
-    drvlocal.waitNumPollsBeforeReady += WAITNUMPOLLSBEFOREREADY;
-#endif // ifndef motorWaitPollsBeforeReadyString
-    commandAccepted = true;
-  }
- 
-  // } else
-  // {
-  //  LOGERR(
-  //    "%s/%s:%d: ERROR: Constant velo disabled and therefore not allowed.\n",
-  //    __FILE__,
-  //    __FUNCTION__,
-  //    __LINE__);
-  // }
-
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
-
   if (commandAccepted) {
     // update motor record
     setIntegerParam(pC_->motorStatusMoving_, 1);
@@ -1312,10 +1361,9 @@ asynStatus ecmcMotorRecordAxis::setPosition(double value) {
 
   drvlocal.eeAxisWarning = eeAxisWarningNoWarning;
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  int errorCode =  drvlocal.ecmcAxis->setPosition(value);
-
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int errorCode = ecmcRTExec([&]() {
+    return drvlocal.ecmcAxis->setPosition(value);
+  });
 
   return errorCode == 0 ? asynSuccess : asynError;
 }
@@ -1329,10 +1377,13 @@ asynStatus ecmcMotorRecordAxis::resetAxis(void) {
   drvlocal.eeAxisWarning      = eeAxisWarningNoWarning;
   drvlocal.cmdErrorMessage[0] = 0;
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  drvlocal.ecmcAxis->errorReset();
+  int rtError = ecmcRTExec([&]() {
+    drvlocal.ecmcAxis->errorReset();
+  });
 
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  if (rtError) {
+    return asynError;
+  }
 
   // Refresh
   bool moving;
@@ -1346,11 +1397,29 @@ asynStatus ecmcMotorRecordAxis::setEnable(int on) {
             __FILE__, __FUNCTION__, __LINE__,
             axisNo_, on);
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
+  // Staged, applied together with the other axes when DEFER_MOVES is reset
+  if (pC_->deferMoves_) {
+    return pC_->deferredCmd_.addEnable(drvlocal.ecmcAxis, on) ?
+           asynError : asynSuccess;
+  }
+
+  int errorCode  = 0;
+  int comBlocked = 0;
+
+  int rtError = ecmcRTExec([&]() {
+    comBlocked = drvlocal.ecmcAxis->getBlockCom() && on;
+    if (comBlocked) {
+      drvlocal.ecmcAxis->setExternalCommandBlockedError();
+      return;
+    }
+    errorCode = drvlocal.ecmcAxis->setEnable(on);
+  });
+
+  if (rtError) {
+    return asynError;
+  }
 
-  if (drvlocal.ecmcAxis->getBlockCom() && on) {
-    if (ecmcRTMutex) epicsMutexUnlock(ecmcRTMutex);
-    drvlocal.ecmcAxis->setExternalCommandBlockedError();
+  if (comBlocked) {
     LOGERR(
       "%s/%s:%d: ERROR: Communication to ECMC blocked, motion commands not allowed..\n",
       __FILE__,
@@ -1359,10 +1428,6 @@ asynStatus ecmcMotorRecordAxis::setEnable(int on) {
     return asynError;
   }
 
-  int errorCode = drvlocal.ecmcAxis->setEnable(on);
-  
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
-
   if (errorCode) {
     LOGERR(
       "%s/%s:%d: ERROR: Function setEnable(%d) returned errorCode (0x%x).\n",
@@ -1386,13 +1451,16 @@ asynStatus ecmcMotorRecordAxis::setEnable(int on) {
  *  Method is called cyclic from asynMotorController::autoPowerOn()
  */
 bool ecmcMotorRecordAxis::pollPowerIsOn(void) {
-  printf("ecmcMotorRecordAxis::pollPowerIsOn(): Axis: %d\n",drvlocal.axisId);
   int enabled = 0;
   bool interlock = 0;
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  enabled = drvlocal.ecmcAxis->getEnabled() && drvlocal.ecmcAxis->getEnable();
-  interlock = drvlocal.ecmcAxis->getMon()->getSumInterlock();
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int rtError = ecmcRTExec([&]() {
+    enabled = drvlocal.ecmcAxis->getEnabled() && drvlocal.ecmcAxis->getEnable();
+    interlock = drvlocal.ecmcAxis->getMon()->getSumInterlock();
+  });
+
+  if (rtError) {
+    return false;
+  }
 
   if(interlock) {
     triggstop_++;
@@ -1515,15 +1583,26 @@ asynStatus ecmcMotorRecordAxis::stopAxisInternal(const char *function_name,
             __FILE__, __FUNCTION__, __LINE__,
             axisNo_, function_name, acceleration);
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  int errorCode = drvlocal.ecmcAxis->stopMotion(0);
-
-  int exeAbort = false;
-  if(pC_->pvtController_){      
-      exeAbort=pC_->pvtController_->getBusy();
+  // Stop is never deferred, drop staged commands of this axis
+  if (pC_->deferMoves_) {
+    pC_->deferredCmd_.remove(drvlocal.ecmcAxis);
+    drvlocal.moveStaged = 0;
   }
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
 
+  int errorCode = 0;
+  int exeAbort  = false;
+
+  int rtError = ecmcRTExec([&]() {
+    errorCode = drvlocal.ecmcAxis->stopMotion(0);
+
+    if(pC_->pvtController_){
+        exeAbort=pC_->pvtController_->getBusy();
+    }
+  });
+
+  if (rtError) {
+    errorCode = rtError;
+  }
   
   if(profileInProgress_) {
     if(exeAbort) {
@@ -1676,31 +1755,49 @@ void ecmcMotorRecordAxis::callParamCallbacksUpdateError() {
 }
 
 asynStatus ecmcMotorRecordAxis::readEcmcAxisStatusData() {
+  int started = 0;
+  int copied  = 0;
+
+  int rtError = ecmcRTExec([&]() {
+    /* Driver not yet initialized, do nothing */
+    started = drvlocal.ecmcAxis->getRealTimeStarted();
+    if (!started) {
+      return;
+    }
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  /* Driver not yet initialized, do nothing */
-  if (!drvlocal.ecmcAxis->getRealTimeStarted()) {
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
-    return asynSuccess;
-  }
+    drvlocal.ecmcSafetyInterlock = drvlocal.ecmcAxis->getMon()->getSafetyInterlock();
+    drvlocal.ecmcBusy = drvlocal.ecmcAxis->getBusy();
+    drvlocal.ecmcAtTarget = drvlocal.ecmcAxis->getMon()->getAtTarget();
+    drvlocal.ecmcAtTargetMonEnable = drvlocal.ecmcAxis->getMon()->getEnableAtTargetMon();
+    drvlocal.axisPrintDbg = drvlocal.ecmcAxis->getPrintDbg();
+    drvlocal.axisInStartup = drvlocal.ecmcAxis->getInStartupPhase();
+    drvlocal.ecmcSummaryInterlock = drvlocal.ecmcAxis->getMon()->getSumInterlock();
+    drvlocal.ecmcTrjSrc = drvlocal.ecmcAxis->getTrajDataSourceType() ==
+                          ECMC_DATA_SOURCE_EXTERNAL;
+
+    drvlocal.ecmcIgnoreDisableAxisStatus = drvlocal.ecmcAxis->getMRIgnoreDisableStatusCheck();
+
+    // Get values from ecmc
+    ecmcAxisDataStatus *tempAxisStat =
+      drvlocal.ecmcAxis->getAxisStatusDataPtr();
+    if (!tempAxisStat) {
+      return;
+    }
+
+    // copy data locally
+    memcpy(&drvlocal.status_, tempAxisStat, sizeof(ecmcAxisDataStatus));
+    copied = 1;
+  });
 
-  drvlocal.ecmcSafetyInterlock = drvlocal.ecmcAxis->getMon()->getSafetyInterlock();
-  drvlocal.ecmcBusy = drvlocal.ecmcAxis->getBusy();
-  drvlocal.ecmcAtTarget = drvlocal.ecmcAxis->getMon()->getAtTarget();
-  drvlocal.ecmcAtTargetMonEnable = drvlocal.ecmcAxis->getMon()->getEnableAtTargetMon();
-  drvlocal.axisPrintDbg = drvlocal.ecmcAxis->getPrintDbg();
-  drvlocal.axisInStartup = drvlocal.ecmcAxis->getInStartupPhase();  
-  drvlocal.ecmcSummaryInterlock = drvlocal.ecmcAxis->getMon()->getSumInterlock();
-  drvlocal.ecmcTrjSrc = drvlocal.ecmcAxis->getTrajDataSourceType() == 
-                        ECMC_DATA_SOURCE_EXTERNAL;
+  if (rtError) {
+    return asynError;
+  }
 
-  drvlocal.ecmcIgnoreDisableAxisStatus = drvlocal.ecmcAxis->getMRIgnoreDisableStatusCheck();
+  if (!started) {
+    return asynSuccess;
+  }
 
-  // Get values from ecmc
-  ecmcAxisDataStatus *tempAxisStat =
-    drvlocal.ecmcAxis->getAxisStatusDataPtr();
-  if (!tempAxisStat) {
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  if (!copied) {
     LOGERR(
       "%s/%s:%d: ERROR: function getAxisDebugInfoDataPointer() returned NULL.\n",
       __FILE__,
@@ -1709,11 +1806,6 @@ asynStatus ecmcMotorRecordAxis::readEcmcAxisStatusData() {
     return asynError;
   }
 
-  // copy data locally
-  memcpy(&drvlocal.status_, tempAxisStat, sizeof(ecmcAxisDataStatus));
-
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
-
   drvlocal.nErrorIdMcu = drvlocal.status_.errorCode;
   
   return asynSuccess;
@@ -1793,6 +1885,11 @@ asynStatus ecmcMotorRecordAxis::poll(bool *moving) {
     drvlocal.moveReady = false;
   }
 
+  // Staged move (DEFER_MOVES) is not done before applied
+  if (drvlocal.moveStaged) {
+    drvlocal.moveReady = false;
+  }
+
   //if(!drvlocal.moveReady){
   //  printf("Axis[%d]:ecmcMotorRecordAxis::poll(): ecmc busy %d\n", axisNo_,drvlocal.ecmcAxis->getBusy());
   //}
@@ -2098,9 +2195,9 @@ asynStatus ecmcMotorRecordAxis::setIntegerParam(int function, int value) {
               "%ssetIntegerParam(%d ecmcMotorRecordCfgDHLM_En)=%d\n",
               modNamEMC, axisNo_, value);
 
-    if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-    errorCode = drvlocal.ecmcAxis->getMon()->setEnableSoftLimitFwd(value);
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+    errorCode = ecmcRTExec([&]() {
+      return drvlocal.ecmcAxis->getMon()->setEnableSoftLimitFwd(value);
+    });
 
     syncSoftLimitInterfaces(true);
   
@@ -2111,9 +2208,9 @@ asynStatus ecmcMotorRecordAxis::setIntegerParam(int function, int value) {
               "%ssetIntegerParam(%d ecmcMotorRecordCfgDLLM_En)=%d\n",
               modNamEMC, axisNo_, value);
 
-    if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-    errorCode = drvlocal.ecmcAxis->getMon()->setEnableSoftLimitBwd(value);
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+    errorCode = ecmcRTExec([&]() {
+      return drvlocal.ecmcAxis->getMon()->setEnableSoftLimitBwd(value);
+    });
 
     syncSoftLimitInterfaces(true);
     
@@ -2311,10 +2408,9 @@ asynStatus ecmcMotorRecordAxis::setDoubleParam(int function, double value) {
               axisNo_,
               value);
 
-    if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-    errorCode = drvlocal.ecmcAxis->getMon()->setMaxVel(value);
-
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+    errorCode = ecmcRTExec([&]() {
+      return drvlocal.ecmcAxis->getMon()->setMaxVel(value);
+    });
 
     return errorCode == 0 ? asynSuccess : asynError;
   } // manual velo fast.. Just store here in "motor record" driver
@@ -2336,12 +2432,11 @@ asynStatus ecmcMotorRecordAxis::setDoubleParam(int function, double value) {
               axisNo_,
               value);
 
-    if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-    drvlocal.ecmcAxis->getSeq()->setAcc(value);
+    int rtError = ecmcRTExec([&]() {
+      drvlocal.ecmcAxis->getSeq()->setAcc(value);
+    });
 
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
-
-    return asynSuccess;
+    return rtError ? asynError : asynSuccess;
   }
 
   // Call the base class method
@@ -2696,13 +2791,19 @@ asynStatus ecmcMotorRecordAxis::executeProfile() {
   
   
   if(pvtRunning_) {
-    if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-    if(pvtRunning_->getBusy()) {
+    int busy = 0;
+    int rtError = ecmcRTExec([&]() {
+      busy = pvtRunning_->getBusy();
+    });
+
+    if (rtError) {
+      return asynError;
+    }
+
+    if(busy) {
       printf("ecmcMotorRecordAxis::executeProfile(): Error axis[%d]: Profile busy..\n",axisNo_);
-      if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
       return asynError;
     }
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
   }
 
   if(profileSwitchPVTObject_) {
@@ -2712,17 +2813,26 @@ asynStatus ecmcMotorRecordAxis::executeProfile() {
     pvtRunning_ = pvtPrepare_;
     
     // Add pvt object to axis
-    if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-    drvlocal.ecmcAxis->getSeq()->setPVTObject(pvtRunning_);
-    pvtPrepare_ = pvtTempSwitch;
-    profileSwitchPVTObject_ = false;
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+    int rtError = ecmcRTExec([&]() {
+      drvlocal.ecmcAxis->getSeq()->setPVTObject(pvtRunning_);
+      pvtPrepare_ = pvtTempSwitch;
+      profileSwitchPVTObject_ = false;
+    });
+
+    if (rtError) {
+      pvtRunning_ = pvtTempSwitch;
+      return asynError;
+    }
   }
 
   // Add axis to pvt controller after any PVT object switch.
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  pC_->getPVTController()->addAxis(drvlocal.ecmcAxis);
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int rtError = ecmcRTExec([&]() {
+    pC_->getPVTController()->addAxis(drvlocal.ecmcAxis);
+  });
+
+  if (rtError) {
+    return asynError;
+  }
   
   if(drvlocal.axisPrintDbg) {
     printf("ecmcMotorRecordAxis::executeProfile()\n");
@@ -2741,9 +2851,15 @@ asynStatus ecmcMotorRecordAxis::executeProfile() {
   status = pC_->getIntegerParam(pC_->profileMoveMode_, &mode);
 
   // Check for interlock
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  int ilock=drvlocal.ecmcAxis->getSumInterlock();
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int ilock = 0;
+  rtError = ecmcRTExec([&]() {
+    ilock=drvlocal.ecmcAxis->getSumInterlock();
+  });
+
+  if (rtError) {
+    return asynError;
+  }
+
   if(ilock) {
     printf("ecmcMotorRecordAxis::executeProfile(): Error Axis[%d]: Axis interlocked, aborting profile...\n",
     drvlocal.axisId);
@@ -2753,11 +2869,13 @@ asynStatus ecmcMotorRecordAxis::executeProfile() {
 
   // The actual execute is handled from ecmcPVTController in ecmcMotorRecordController::executeProfile
   //int errorCode = 0;
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-
-  pvtRunning_->setRelMode(mode==PROFILE_MOVE_MODE_RELATIVE) ;
+  rtError = ecmcRTExec([&]() {
+    pvtRunning_->setRelMode(mode==PROFILE_MOVE_MODE_RELATIVE) ;
+  });
 
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  if (rtError) {
+    return asynError;
+  }
 
   profileInProgress_ = true;
   return asynSuccess;
@@ -2784,34 +2902,42 @@ asynStatus ecmcMotorRecordAxis::readbackProfile() {
     return asynError;
   }
 
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
+  int    validData = 0;
+  size_t elements  = 0;
+
+  int rtError = ecmcRTExec([&]() {
+    // Get pointers to data of ecmc vectors
+    double *dataPosAct =  pvtRunning_->getResultPosActDataPrt();
+    double *dataPosErr =  pvtRunning_->getResultPosErrDataPrt();
+    elements = pvtRunning_->getResultBufferSize();
+
+    validData = dataPosAct != NULL && dataPosErr != NULL;
+    if(!validData || elements == 0) {
+      return;
+    }
+
+    if(elements > profileMaxPoints_) {
+      elements = profileMaxPoints_;
+    }
+
+    memcpy(profileReadbacks_,       dataPosAct, elements * sizeof(double));
+    memcpy(profileFollowingErrors_, dataPosErr, elements * sizeof(double));
+  });
 
-  // Get pointers to data of ecmc vectors
-  double *dataPosAct =  pvtRunning_->getResultPosActDataPrt();
-  double *dataPosErr =  pvtRunning_->getResultPosErrDataPrt();
-  size_t elements = pvtRunning_->getResultBufferSize();
+  if (rtError) {
+    return asynError;
+  }
 
-  if(dataPosAct == NULL || dataPosErr == NULL) {
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  if(!validData) {
     printf("!pointer NULL_\n");
     return asynError;
   }
 
   if(elements == 0) {
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
     printf("!elements 0_\n");
     return asynError;
   }
 
-  if(elements > profileMaxPoints_) {
-    elements = profileMaxPoints_;
-  }
-
-  memcpy(profileReadbacks_,       dataPosAct, elements * sizeof(double));
-  memcpy(profileFollowingErrors_, dataPosErr, elements * sizeof(double));
-  
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
-
   status  = pC_->doCallbacksFloat64Array(profileReadbacks_,       elements, pC_->profileReadbacks_, axisNo_);
   status |= pC_->doCallbacksFloat64Array(profileFollowingErrors_, elements, pC_->profileFollowingErrors_, axisNo_);
   return asynSuccess;
@@ -2833,9 +2959,15 @@ asynStatus ecmcMotorRecordAxis::checkProfileStatus() {
   }
   
   // Check for interlock
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  int ilock=drvlocal.ecmcAxis->getSumInterlock();
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int ilock = 0;
+  int rtError = ecmcRTExec([&]() {
+    ilock=drvlocal.ecmcAxis->getSumInterlock();
+  });
+
+  if (rtError) {
+    return asynError;
+  }
+
   if(ilock) {
     printf("ecmcMotorRecordController::checkProfileStatus(): Error Axis[%d]: Axis interlocked, aborting profile...\n",
            drvlocal.axisId);
@@ -2851,9 +2983,13 @@ int ecmcMotorRecordAxis::getProfileCurrentSegementID() {
     return id; //Invalid..
   }
   
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-    id = pvtRunning_->getCurrentSegementId();
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int rtError = ecmcRTExec([&]() {
+      id = pvtRunning_->getCurrentSegementId();
+  });
+
+  if (rtError) {
+    return -1;
+  }
 
   return id;
 }
@@ -2864,9 +3000,13 @@ int ecmcMotorRecordAxis::getProfileBusy() {
     return busy;  //Invalid..
   }
   
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  busy = pvtRunning_->getBusy();
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int rtError = ecmcRTExec([&]() {
+    busy = pvtRunning_->getBusy();
+  });
+
+  if (rtError) {
+    return -1;
+  }
 
   return busy;
 }
@@ -2910,11 +3050,9 @@ asynStatus ecmcMotorRecordAxis::setPGain(double pGain) {
   if (drvlocal.ecmcAxis->getCntrl() == NULL) {
     return asynError;
   }
-  int errorCode = 0;
-
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  errorCode = drvlocal.ecmcAxis->setCntrlKp(CONTROL_GAIN_SCALE * pGain);
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int errorCode = ecmcRTExec([&]() {
+    return drvlocal.ecmcAxis->setCntrlKp(CONTROL_GAIN_SCALE * pGain);
+  });
   return errorCode == 0 ? asynSuccess : asynError;
 }
 
@@ -2941,11 +3079,9 @@ asynStatus ecmcMotorRecordAxis::setIGain(double iGain) {
   if (drvlocal.ecmcAxis->getCntrl() == NULL) {
     return asynError;
   }
-  int errorCode = 0;
-
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  errorCode = drvlocal.ecmcAxis->setCntrlKi(CONTROL_GAIN_SCALE * iGain);
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int errorCode = ecmcRTExec([&]() {
+    return drvlocal.ecmcAxis->setCntrlKi(CONTROL_GAIN_SCALE * iGain);
+  });
   return errorCode == 0 ? asynSuccess : asynError;
 }
 
@@ -2972,11 +3108,9 @@ asynStatus ecmcMotorRecordAxis::setDGain(double dGain) {
   if (drvlocal.ecmcAxis->getCntrl() == NULL) {
     return asynError;
   }
-  int errorCode = 0;
-
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  errorCode = drvlocal.ecmcAxis->setCntrlKd(CONTROL_GAIN_SCALE * dGain);
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int errorCode = ecmcRTExec([&]() {
+    return drvlocal.ecmcAxis->setCntrlKd(CONTROL_GAIN_SCALE * dGain);
+  });
   return errorCode == 0 ? asynSuccess : asynError;
 }
 
@@ -3060,6 +3194,24 @@ void ecmcMotorRecordAxis::newCmd() {
   //printf("Axis[%d]: New command received!\n", axisNo_);
 }
 
+// New motion command accepted by ecmc (called with RT mutex held)
+void ecmcMotorRecordAxis::latchNewMoveCmd() {
+  drvlocal.moveReady = false;
+  ecmcCycleCounterAtNewCmd_ = drvlocal.ecmcAxis->getCycleCounter();
+#ifndef motorWaitPollsBeforeReadyString
+  drvlocal.waitNumPollsBeforeReady += WAITNUMPOLLSBEFOREREADY;
+#endif // ifndef motorWaitPollsBeforeReadyString
+}
+
+// Move staged (DEFER_MOVES): report moving until applied or dropped
+void ecmcMotorRecordAxis::setMoveStaged() {
+  drvlocal.moveStaged = 1;
+  drvlocal.moveReady  = false;
+  setIntegerParam(pC_->motorStatusMoving_, 1);
+  setIntegerParam(pC_->motorStatusDone_,   0);
+  callParamCallbacks();
+}
+
 bool ecmcMotorRecordAxis::dataIsSampledAfterNewCmd() {
   // the diff >1000 is just to handle overfows so not stuck in DMOV=0.
   return drvlocal.status_.cycleCounter > ecmcCycleCounterAtNewCmd_ || abs(ecmcCycleCounterAtNewCmd_ - drvlocal.status_.cycleCounter) > 1000;
@@ -126,6 +126,7 @@ private:
     int  axisPrintDbg;
     int  moveReady;
     int  moveReadyOld;
+    int  moveStaged;   /* Move staged (DEFER_MOVES), not done until applied */
     char cmdErrorMessage[80];               /* From driver */
     char sErrorMessage[80];               /* From controller */
     bool ecmcBusy;
@@ -199,6 +200,8 @@ private:
   size_t getProfilePointCount();
   void updateError();
   void newCmd();
+  void latchNewMoveCmd();
+  void setMoveStaged();
   bool dataIsSampledAfterNewCmd();
   ecmcAxisPVTSequence *pvtRunning_;
   ecmcAxisPVTSequence *pvtPrepare_;
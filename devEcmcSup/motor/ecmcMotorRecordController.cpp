@@ -16,6 +16,7 @@ FILENAME... ecmcMotorRecordController.cpp
 #include "ecmcMotorRecordAxis.h"
 #include "ecmcMotorRecordController.h"
 #include "ecmcGlobalsExtern.h"
+#include "ecmcMainThread.h"
 #include "ecmcPVTController.h"
 #include "ecmcPluginClient.h"
 
@@ -38,6 +39,12 @@ const static unsigned reportedFeatureBits =
   FEATURE_BITS_ECMC |
   FEATURE_BITS_V2;
 
+/* Number of motor axes: at least the size of the ecmc axis registry
+   (increase with Cfg.SetMaxAxes() before creating the controller) */
+static int ecmcMotorRecordNumAxes(int numAxes) {
+  return numAxes > axes.size() ? numAxes : axes.size();
+}
+
 extern "C"
 double ecmcMotorRecordgetNowTimeSecs(void) {
   epicsTimeStamp nowTime;
@@ -148,7 +155,7 @@ ecmcMotorRecordController::ecmcMotorRecordController(const char *portName,
                                                      double      movingPollPeriod,
                                                      double      idlePollPeriod,
                                                      const char *optionStr)
-  :  asynMotorController(portName, ECMC_MAX_AXES, NUM_VIRTUAL_MOTOR_PARAMS,
+  :  asynMotorController(portName, ecmcMotorRecordNumAxes(numAxes), NUM_VIRTUAL_MOTOR_PARAMS,
                          0, // No additional interfaces beyond those in base class
                          0, // No additional callback interfaces beyond those in base class
                          ASYN_CANBLOCK | ASYN_MULTIDEVICE,
@@ -167,6 +174,7 @@ ecmcMotorRecordController::ecmcMotorRecordController(const char *portName,
   profileBuilt_              = 0;  
   pvtController_             = NULL;
   profileInProgress_         = false;
+  deferMoves_                = false;
 #ifndef motorMessageTextString
   createParam("MOTOR_MESSAGE_TEXT",
               asynParamOctet,
@@ -405,9 +413,9 @@ extern "C" int ecmcMotorRecordCreateController(const char *portName,
     printf(
       "    MotorPortName    : Obsolete. Not used. Kept to keep syntax same as EthercatMC module.  : \"NOT_USED\"\n");
     printf(
-      "    numAxes          : Obsolete. Not used. Kept to keep syntax same as EthercatMC module.  : \"0\"\n");
-    printf("                       numAxes already defined in ecmc to %d\n",
-           ECMC_MAX_AXES);
+      "    numAxes          : Minimum number of axes (ecmc axis count used if higher).            : \"0\"\n");
+    printf("                       ecmc axis count currently %d (Cfg.SetMaxAxes())\n",
+           axes.size());
     printf(
       "    movingPollPeriod : Scan period rate of motor record status update when axis is moving. : \"200\" (unit [ms])\n");
     printf(
@@ -569,24 +577,29 @@ asynStatus ecmcMotorRecordController::poll(void) {
   }
 
   // read ecmc controller data
-  readEcmcControllerStatus();
+  status = readEcmcControllerStatus();
+
+  // No fresh pvt state, skip profile handling this poll
+  if (status != asynSuccess) {
+    return status;
+  }
 
   profilePoll();
   
   return status;
 }
 
-void ecmcMotorRecordController::readEcmcControllerStatus(){
-  
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
+asynStatus ecmcMotorRecordController::readEcmcControllerStatus(){
   
-  if(pvtController_) {
-    ctrlLocal.pvtErrorId = pvtController_->getErrorID();
-    ctrlLocal.pvtCurrentTriggerId = pvtController_->getCurrentTriggerId();
-  }
-  ctrlLocal.errorId = controllerError;  // global variable
+  int rtError = ecmcRTExec([&]() {
+    if(pvtController_) {
+      ctrlLocal.pvtErrorId = pvtController_->getErrorID();
+      ctrlLocal.pvtCurrentTriggerId = pvtController_->getCurrentTriggerId();
+    }
+    ctrlLocal.errorId = controllerError;  // global variable
+  });
 
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  return rtError ? asynError : asynSuccess;
 }
 
 void ecmcMotorRecordController::profilePoll() {
@@ -748,7 +761,7 @@ asynStatus ecmcMotorRecordController::writeInt32(asynUser *pasynUser, epicsInt32
 
   // Must be controller related
   if (function == motorDeferMoves_) {
-    status = asynMotorController::setDeferredMoves(value);     
+    status = setDeferredMoves(value != 0);
   } else if (function == profileBuild_) {
 
     status = buildProfile();
@@ -807,6 +820,97 @@ asynStatus ecmcMotorRecordController::writeInt32(asynUser *pasynUser, epicsInt32
   return status;
 }
 
+asynStatus ecmcMotorRecordController::setDeferredMoves(bool defer) {
+  if (defer) {
+    if (!deferMoves_) {
+      deferredCmd_.clear();
+    }
+    deferMoves_ = true;
+    return asynSuccess;
+  }
+
+  if (!deferMoves_) {
+    return asynSuccess;
+  }
+  deferMoves_ = false;
+
+  asynStatus status = executeGroupCmd(&deferredCmd_);
+  deferredCmd_.clear();
+  return status;
+}
+
+asynStatus ecmcMotorRecordController::executeGroupCmd(ecmcAxisGroupCmd *cmd) {
+  if (!cmd || (cmd->size() == 0)) {
+    return asynSuccess;
+  }
+
+  const size_t items = cmd->size();
+
+  int errorCode = 0;
+
+  int rtError = ecmcRTExec([&]() {
+    errorCode = cmd->apply();
+
+    // Latch command timing while exclusive with the rt thread (see move())
+    for (size_t i = 0; i < items; i++) {
+      ecmcAxisGroupCmdItem *item = cmd->getItem(i);
+      ecmcMotorRecordAxis  *pAxis = getAxis(item->axis->getAxisID());
+
+      if (pAxis && (pAxis->drvlocal.ecmcAxis == item->axis) &&
+          !item->errorCode && (item->type <= ECMC_AXIS_GROUP_CMD_MOVE_VELO)) {
+        pAxis->latchNewMoveCmd();
+      }
+    }
+  });
+
+  // Nothing applied, axes keep their staged state
+  if (rtError) {
+    for (size_t i = 0; i < items; i++) {
+      cmd->getItem(i)->errorCode = rtError;
+    }
+    LOGERR(
+      "%s/%s:%d: ERROR: Group command not executed (0x%x).\n",
+      __FILE__,
+      __FUNCTION__,
+      __LINE__,
+      rtError);
+    return asynError;
+  }
+
+  for (size_t i = 0; i < items; i++) {
+    ecmcAxisGroupCmdItem *item = cmd->getItem(i);
+    ecmcMotorRecordAxis  *pAxis = getAxis(item->axis->getAxisID());
+
+    if (!pAxis || (pAxis->drvlocal.ecmcAxis != item->axis)) {
+      continue;
+    }
+
+    // Applied or failed, poll() reports done from the axis status again
+    pAxis->drvlocal.moveStaged = 0;
+
+    if (item->errorCode) {
+      LOGERR(
+        "%s/%s:%d: ERROR: Axis[%d]: Group command %d failed (0x%x).\n",
+        __FILE__,
+        __FUNCTION__,
+        __LINE__,
+        pAxis->axisNo_,
+        item->type,
+        item->errorCode);
+      continue;
+    }
+
+    if (item->type <= ECMC_AXIS_GROUP_CMD_MOVE_VELO) {
+      // update motor record
+      pAxis->setIntegerParam(motorStatusMoving_, 1);
+      pAxis->setIntegerParam(motorStatusDone_,   0);
+      pAxis->callParamCallbacks();
+    }
+  }
+
+  return errorCode == 0 ? asynSuccess : asynError;
+}
+
 asynStatus ecmcMotorRecordController::abortProfile()
 {
   printf("ecmcMotorRecordAxis::abortProfile()\n");
@@ -821,11 +925,13 @@ asynStatus ecmcMotorRecordController::abortProfile()
     pAxis->abortProfile();
   }
 
+  int rtError = 0;
+
   if(pvtController_) {
-    if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-    pvtController_->abortPVT();
-    pvtController_->clearPVTAxes();
-    if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+    rtError = ecmcRTExec([&]() {
+      pvtController_->abortPVT();
+      pvtController_->clearPVTAxes();
+    });
   }
 
   setIntegerParam(profileExecuteState_, PROFILE_STATUS_UNDEFINED);
@@ -833,10 +939,14 @@ asynStatus ecmcMotorRecordController::abortProfile()
   setIntegerParam(profileCurrentPoint_, 0);
   setIntegerParam(profileActualPulses_, 0);
   setIntegerParam(profileExecuteStatus_,PROFILE_STATUS_ABORT);
-  sprintf(profileMessage_, "Profile aborted.\n");
+  if (rtError) {
+    sprintf(profileMessage_, "Profile abort failed (error 0x%x).\n", rtError);
+  } else {
+    sprintf(profileMessage_, "Profile aborted.\n");
+  }
   setStringParam(profileExecuteMessage_, profileMessage_);
   callParamCallbacks();
-  return asynSuccess;
+  return rtError ? asynError : asynSuccess;
 }
 
 asynStatus ecmcMotorRecordController::buildProfile() {
@@ -1083,10 +1193,20 @@ asynStatus ecmcMotorRecordController::executeProfile() {
     }
   }
   // Trigg new sequence all axes (ensure in same scan)
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  pvtController_->setExecute(0);
-  pvtController_->setExecute(1);
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
+  int rtError = ecmcRTExec([&]() {
+    pvtController_->setExecute(0);
+    pvtController_->setExecute(1);
+  });
+
+  if (rtError) {
+    setIntegerParam(profileExecuteState_, PROFILE_EXECUTE_DONE);
+    setIntegerParam(profileExecuteStatus_, PROFILE_STATUS_FAILURE);
+    sprintf(profileMessage_, "Profile start failed (error 0x%x).\n", rtError);
+    setStringParam(profileExecuteMessage_, profileMessage_);
+    callParamCallbacks();
+    return asynError;
+  }
+
   profileInProgress_ = true;
   setIntegerParam(profileExecuteState_, PROFILE_EXECUTE_MOVE_START);
   setIntegerParam(profileExecuteStatus_, PROFILE_STATUS_UNDEFINED);
@@ -1244,15 +1364,22 @@ asynStatus ecmcMotorRecordController::profileValidateTime() {
     return asynError;    
   }
   
-  if (ecmcRTMutex)epicsMutexLock(ecmcRTMutex);
-  if(pulseCount > 0){
-    pvtController_->setTriggerInfo(pulseStartTime, pulseTimeBetween,
-                                     pulseEndTime, pulseCount);
-  } else {
-    // disable triggering
-    pvtController_->setTriggerInfo(-1,-1,-1, 0);
+  int rtError = ecmcRTExec([&]() {
+    if(pulseCount > 0){
+      pvtController_->setTriggerInfo(pulseStartTime, pulseTimeBetween,
+                                       pulseEndTime, pulseCount);
+    } else {
+      // disable triggering
+      pvtController_->setTriggerInfo(-1,-1,-1, 0);
+    }
+  });
+
+  if (rtError) {
+    sprintf(profileMessage_, "Error: Trigger setup failed (error 0x%x).\n", rtError);
+    setStringParam(profileBuildMessage_, profileMessage_);
+    callParamCallbacks();
+    return asynError;
   }
-  if (ecmcRTMutex)epicsMutexUnlock(ecmcRTMutex);
 
   return asynSuccess;
 }
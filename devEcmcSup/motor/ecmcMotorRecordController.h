@@ -9,6 +9,7 @@ FILENAME...   ecmcMotorRecordController.h
 #include "asynMotorAxis.h"
 #include "ecmcMotorRecordAxis.h"
 #include "ecmcPVTController.h"
+#include "ecmcAxisGroupCmd.h"
 
 extern ecmcAsynPortDriver *asynPort;
 
@@ -124,6 +125,10 @@ public:
   asynStatus abortProfile();
   asynStatus readbackProfile();
   asynStatus enableAxisPVTFunc(int axisNo, int enable);
+  // DEFER_MOVES: 1 stages moves/enables of all axes, 0 applies them together
+  asynStatus setDeferredMoves(bool defer);
+  // Apply a staged transaction with one rt mutex handoff (same cycle)
+  asynStatus executeGroupCmd(ecmcAxisGroupCmd *cmd);
   int features_;
 
 protected:
@@ -138,7 +143,7 @@ protected:
   asynStatus poll();
   void       profilePoll();
   ecmcPVTController *getPVTController();
-  void readEcmcControllerStatus();
+  asynStatus readEcmcControllerStatus();
 
   struct {
     asynStatus   oldStatus;
@@ -237,6 +242,8 @@ protected:
   ecmcPVTController *pvtController_;
   bool profileInProgress_;
   size_t profileTimeArraySize_;
+  ecmcAxisGroupCmd deferredCmd_;
+  bool deferMoves_;
 
   friend class ecmcMotorRecordAxis;
 };
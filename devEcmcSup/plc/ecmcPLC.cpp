@@ -25,18 +25,19 @@
 #include "ecmcPLCTask.h"
 #include "ecmcPLCLib.h"
 #include "ecmcLookupTable.h"
+#include "ecmcRegistry.h"
 
-extern ecmcAxisBase *axes[ECMC_MAX_AXES];
-extern ecmcAxisGroup *axisGroups[ECMC_MAX_AXES];
+extern ecmcRegistry<ecmcAxisBase> axes;
+extern ecmcRegistry<ecmcAxisGroup> axisGroups;
 extern ecmcEc *ec;
-extern ecmcDataStorage *dataStorages[ECMC_MAX_DATA_STORAGE_OBJECTS];
+extern ecmcRegistry<ecmcDataStorage> dataStorages;
 extern ecmcPLCMain     *plcs;
 extern ecmcAsynPortDriver *asynPort;
 extern double mcuFrequency;
 extern int    sampleRateChangeAllowed;
-extern ecmcPluginLib *plugins[ECMC_MAX_PLUGINS];
+extern ecmcRegistry<ecmcPluginLib> plugins;
 extern ecmcShm shmObj;
-extern ecmcLookupTable<double, double>  *luts[ECMC_MAX_LUTS];
+extern ecmcRegistry<ecmcLookupTable<double, double> > luts;
 
 int createPLC(int index,  double cycleTimeMs, int axisPLC) {
   LOGINFO4("%s/%s:%d index=%d, cycleTimeMs=%lf, axisPLC?=%d\n",
@@ -69,15 +70,15 @@ int createPLC(int index,  double cycleTimeMs, int axisPLC) {
   sampleRateChangeAllowed = 0;
 
   if (!plcs) {
-    plcs = new ecmcPLCMain(ec, mcuFrequency, asynPort);
+    plcs = new ecmcPLCMain(ec, mcuFrequency, asynPort, maxPlcCount);
   }
 
   if (axisPLC) {
-    if ((index < 0) || (index >= ECMC_MAX_PLCS + ECMC_MAX_AXES)) {
+    if ((index < maxPlcCount) || (index >= maxPlcCount + axes.size())) {
       return ERROR_MAIN_PLC_INDEX_OUT_OF_RANGE;
     }
   } else {
-    if ((index < 0) || (index >= ECMC_MAX_PLCS)) {
+    if ((index < 0) || (index >= maxPlcCount)) {
       return ERROR_MAIN_PLC_INDEX_OUT_OF_RANGE;
     }
   }
@@ -85,22 +86,22 @@ int createPLC(int index,  double cycleTimeMs, int axisPLC) {
   if (!ec) return ERROR_MAIN_EC_NOT_INITIALIZED;
 
   // Set axis grp pointers (for the already configuered axes)
-  for (int i = 0; i < ECMC_MAX_AXES; i++) {
+  for (int i = 0; i < axisGroups.size(); i++) {
     plcs->setAxisGroupArrayPointer(axisGroups[i], i);
   }
 
   // Set axes pointers (for the already configuered axes)
-  for (int i = 0; i < ECMC_MAX_AXES; i++) {
+  for (int i = 0; i < axes.size(); i++) {
     plcs->setAxisArrayPointer(axes[i], i);
   }
 
   // Set data storage pointers
-  for (int i = 0; i < ECMC_MAX_DATA_STORAGE_OBJECTS; i++) {
+  for (int i = 0; i < dataStorages.size(); i++) {
     plcs->setDataStoragePointer(dataStorages[i], i);
   }
 
   // Set plugin pointers
-  for (int i = 0; i < ECMC_MAX_PLUGINS; i++) {
+  for (int i = 0; i < plugins.size(); i++) {
     plcs->setPluginPointer(plugins[i], i);
   }
 
@@ -236,7 +237,7 @@ const char* getPLCExpr(int plcIndex, int *error) {
            __LINE__,
            plcIndex);
 
-  if ((plcIndex >= ECMC_MAX_PLCS + ECMC_MAX_AXES) || (plcIndex < 0)) {
+  if ((plcIndex >= maxPlcCount + axes.size()) || (plcIndex < 0)) {
     LOGERR("ERROR: PLC index out of range.\n");
     *error = ERROR_PLCS_INDEX_OUT_OF_RANGE;
     return "";
@@ -258,3 +259,69 @@ const char* getPLCExpr(int plcIndex, int *error) {
 
   return expr->c_str();
 }
+
+int loadPLCFileOnline(int index, char *fileName) {
+  LOGINFO4("%s/%s:%d index=%d value=%s\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           fileName);
+  CHECK_PLCS_RETURN_IF_ERROR();
+  return plcs->loadPLCFileOnline(index, fileName);
+}
+
+int printPLCOnlineChangeStatus() {
+  LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
+  CHECK_PLCS_RETURN_IF_ERROR();
+  plcs->printOnlineChangeStatus();
+  return 0;
+}
+
+int setPLCTimeBudget(int index, double budgetUs) {
+  LOGINFO4("%s/%s:%d index=%d budgetUs=%lf\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           budgetUs);
+  CHECK_PLCS_RETURN_IF_ERROR();
+  return plcs->setTimeBudget(index, budgetUs);
+}
+
+int setPLCBudgetDemotion(int index, int overrunLimit, int skipCycles) {
+  LOGINFO4("%s/%s:%d index=%d overrunLimit=%d skipCycles=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           overrunLimit,
+           skipCycles);
+  CHECK_PLCS_RETURN_IF_ERROR();
+  return plcs->setBudgetDemotion(index, overrunLimit, skipCycles);
+}
+
+int printPLCProfile() {
+  LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
+  CHECK_PLCS_RETURN_IF_ERROR();
+  plcs->printProfile();
+  return 0;
+}
+
+int setPLCNativeMode(int index, int mode) {
+  LOGINFO4("%s/%s:%d index=%d mode=%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           index,
+           mode);
+  CHECK_PLCS_RETURN_IF_ERROR();
+  return plcs->setNativeMode(index, mode);
+}
+
+int printPLCNativeStatus() {
+  LOGINFO4("%s/%s:%d\n", __FILE__, __FUNCTION__, __LINE__);
+  CHECK_PLCS_RETURN_IF_ERROR();
+  plcs->printNativeStatus();
+  return 0;
+}
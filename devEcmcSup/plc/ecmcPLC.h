@@ -256,6 +256,25 @@ int setPLCExpr(int   index,
  *   5. retvalue=ec_get_err():
  *      Returns error code from last lib call.\n
  *
+ *   6. retvalue = ec_edge_pop(
+ *                           <edgeCapIndex>,  : Edge capture index
+ *                           <channel>        : Channel index
+ *                           );
+ *      Pops next event of channel (own cursor for plcs).\n
+ *      Returns 1 (rising), 2 (falling) or 0 if no new event.\n
+ *
+ *   7. retvalue = ec_edge_time(
+ *                           <edgeCapIndex>,  : Edge capture index
+ *                           <channel>        : Channel index
+ *                           );
+ *      Returns time of the event popped by ec_edge_pop() [ns].\n
+ *
+ *   8. retvalue = ec_edge_count(
+ *                           <edgeCapIndex>,  : Edge capture index
+ *                           <channel>        : Channel index
+ *                           );
+ *      Returns number of events captured on channel.\n
+ *
  *  Function Lib: Motion
  *   1. retvalue = mc_move_abs(
  *                           <axIndex>,       : Axis index\n
@@ -396,6 +415,26 @@ int setPLCExpr(int   index,
  *                           );
  *      Returns maximum of the values in the data storage.\n
  *
+ *  Function Lib: Capture
+ *   1. retvalue = cap_arm(
+ *                           <capIndex>,      : Capture index\n
+ *                           );
+ *      Arm capture (restart recording, wait for trigger).\n
+ *      returns 0 if success or error code.\n
+ *
+ *   2. retvalue = cap_trigg(
+ *                           <capIndex>,      : Capture index\n
+ *                           );
+ *      Trigger capture (any plc expression can be used as trigger).\n
+ *      Accepted when armed and pre trigger samples are recorded.\n
+ *      returns 0 if success or error code.\n
+ *
+ *   3. retvalue = cap_get_state(
+ *                           <capIndex>,      : Capture index\n
+ *                           );
+ *      Returns state of capture (0=idle, 1=armed, 2=triggered, 3=frozen,\n
+ *      4=done) or negative error code.\n
+ *
  * \note Pipe sign "|" should be used instead of ";" This because asynOctet
  * interface uses ";" as command delimiter\n.
  *
@@ -548,6 +587,141 @@ int getPLCEnable(int  index,
 const char* getPLCExpr(int  axisIndex,
                        int *error);
 
+/** \brief Load new PLC file to a running PLC (online change).\n
+ *
+ * Replaces the code of a PLC in runtime without stopping the realtime\n
+ * loop. The file is parsed directly, the compilation is made in a\n
+ * separate thread and the new program is then swapped in at the start\n
+ * of a realtime cycle. Static variables keep their values. If any step\n
+ * fails the running program is kept.\n
+ * Before runtime the command is the same as ClearPLCExpr() followed\n
+ * by LoadPLCFile().\n
+ * Not supported for axis PLCs.\n
+ *
+ * \param[in] index     PLC index.\n
+ * \param[in] fileName  File name.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Replace code of running PLC 5\n
+ * "Cfg.LoadPLCFileOnline(5,/home/iocuser/dummyPLC.plc)" //Command string to ecmcCmdParser.c.\n
+ */
+int loadPLCFileOnline(int   index,
+                      char *fileName);
+
+/** \brief Print status of PLC online changes.\n
+ *
+ * Prints parse time, compile time and swap latency (from compiled\n
+ * to running in the realtime thread) of the last online change of each\n
+ * PLC.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print PLC online change status\n
+ * "Cfg.PrintPLCOnlineChangeStatus()" //Command string to ecmcCmdParser.c.\n
+ */
+int printPLCOnlineChangeStatus();
+
+/** \brief Set execution time budget of PLC.\n
+ *
+ * Executions of the PLC longer than the budget are counted as overruns\n
+ * ("plcs.plc<index>.prof.overruns") and a warning is raised\n
+ * ("plcs.plc<index>.prof.budgetwarning"), see also setPLCBudgetDemotion().\n
+ *
+ * \param[in] index     PLC index.\n
+ * \param[in] budgetUs  Budget in micro seconds (0 = no budget).\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Set a budget of 50us for PLC 5\n
+ * "Cfg.SetPLCTimeBudget(5,50)" //Command string to ecmcCmdParser.c.\n
+ *
+ * \note Example: Set a budget of 20us for the PLC of axis 3\n
+ * "Cfg.SetAxisPLCTimeBudget(3,20)" //Command string to ecmcCmdParser.c.\n
+ */
+int setPLCTimeBudget(int    index,
+                     double budgetUs);
+
+/** \brief Demote PLC to slower rate if the time budget is exceeded.\n
+ *
+ * After overrunLimit consecutive executions longer than the time budget\n
+ * (see setPLCTimeBudget()) the PLC is executed with skipCycles instead\n
+ * (plc<index>.scantime is updated). The demotion is not reverted.\n
+ *
+ * \param[in] index         PLC index.\n
+ * \param[in] overrunLimit  Consecutive overruns before demotion (0 = off).\n
+ * \param[in] skipCycles    Skip cycles after demotion.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Execute PLC 5 every 10th cycle after 100 consecutive\n
+ * overruns\n
+ * "Cfg.SetPLCBudgetDemotion(5,100,9)" //Command string to ecmcCmdParser.c.\n
+ *
+ * \note Example: Same for the PLC of axis 3\n
+ * "Cfg.SetAxisPLCBudgetDemotion(3,100,9)" //Command string to ecmcCmdParser.c.\n
+ */
+int setPLCBudgetDemotion(int index,
+                         int overrunLimit,
+                         int skipCycles);
+
+/** \brief Print execution profile of all PLCs.\n
+ *
+ * Prints execution count, last/min/max execution time, the read, eval and\n
+ * write phases of the last execution, budget, overruns and skip cycles.\n
+ * The same data is available as asyn parameters\n
+ * "plcs.plc<index>.prof.*" (axis PLCs: "plcs.ax<index>.prof.*").\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print PLC profile\n
+ * "Cfg.PrintPLCProfile()" //Command string to ecmcCmdParser.c.\n
+ */
+int printPLCProfile();
+
+/** \brief Set execution mode of PLC (exprtk or native code).\n
+ *
+ * In native mode the PLC code is translated to C++, compiled with the\n
+ * system compiler and loaded (dlopen()) when the PLC is compiled\n
+ * (validation or online change). Only a subset of the PLC syntax is\n
+ * supported natively (no strings, vectors, fileIO or PLC lib functions),\n
+ * if translation, compilation or loading fails exprtk is used.\n
+ * Compiler, flags and build dir are set by the environment variables\n
+ * ECMC_PLC_NATIVE_CXX (absolute path, default /usr/bin/c++),\n
+ * ECMC_PLC_NATIVE_CXXFLAGS and ECMC_PLC_NATIVE_DIR.\n
+ *
+ * \param[in] index  PLC index.\n
+ * \param[in] mode   0 = exprtk (default),\n
+ *                   1 = native,\n
+ *                   2 = verify: both are executed and the results are\n
+ *                       compared, the result of exprtk is used. Not\n
+ *                       possible for code calling functions (mc_*,\n
+ *                       ec_*, ds_*..), they would be executed twice.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Execute PLC 5 as native code\n
+ * "Cfg.SetPLCNative(5,1)" //Command string to ecmcCmdParser.c.\n
+ *
+ * \note Example: Verify native code of the PLC of axis 3\n
+ * "Cfg.SetAxisPLCNative(3,2)" //Command string to ecmcCmdParser.c.\n
+ */
+int setPLCNativeMode(int index,
+                     int mode);
+
+/** \brief Print native code status of all PLCs.\n
+ *
+ * Prints mode, if native code is loaded, build time, number of verified\n
+ * executions and mismatches (verify mode) and the reason if the native\n
+ * build failed.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note Example: Print PLC native code status\n
+ * "Cfg.PrintPLCNativeStatus()" //Command string to ecmcCmdParser.c.\n
+ */
+int printPLCNativeStatus();
+
 
 # ifdef __cplusplus
 }
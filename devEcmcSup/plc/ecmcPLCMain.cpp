@@ -11,11 +11,32 @@
 \*************************************************************************/
 
 #include "ecmcPLCMain.h"
+#include <time.h>
+#include "epicsThread.h"
+#include "epicsAtomic.h"
+#include "ecmcThreadCfg.h"
+#include "ecmcMainThread.h"
+
+static int64_t onlineChangeTimeNs() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void ecmcPLCOnlineChangeThread(void *obj) {
+  ecmcPLCOnlineChange *change = (ecmcPLCOnlineChange *)obj;
+
+  change->plcMain->onlineChangeTask(change->plcIndex);
+}
 
 ecmcPLCMain::ecmcPLCMain(ecmcEc             *ec,
                          double              mcuFreq,
-                         ecmcAsynPortDriver *asynPortDriver) {
+                         ecmcAsynPortDriver *asynPortDriver,
+                         int                 plcCount) {
   initVars();
+  plcCount_       = plcCount;
+  resizePLCs(plcCount_);
   asynPortDriver_ = asynPortDriver;
   ec_             = ec;
   mcuFreq_        = mcuFreq;
@@ -23,7 +44,7 @@ ecmcPLCMain::ecmcPLCMain(ecmcEc             *ec,
 }
 
 ecmcPLCMain::~ecmcPLCMain() {
-  for (int i = 0; i < ECMC_MAX_PLCS + ECMC_MAX_AXES; i++) {
+  for (size_t i = 0; i < plcs_.size(); i++) {
     delete plcs_[i];
     plcs_[i] = NULL;
   }
@@ -31,39 +52,40 @@ ecmcPLCMain::~ecmcPLCMain() {
 
 void ecmcPLCMain::initVars() {
   globalVariableCount_ = 0;
-
-  for (int i = 0; i < ECMC_MAX_PLCS + ECMC_MAX_AXES; i++) {
-    plcs_[i]         = NULL;
-    plcEnable_[i]    = NULL;
-    plcError_[i]     = NULL;
-    plcFirstScan_[i] = NULL;
-  }
-
-  for (int i = 0; i < ECMC_MAX_AXES; i++) {
-    axes_[i] = NULL;
-  }
-
-  for (int i = 0; i < ECMC_MAX_DATA_STORAGE_OBJECTS; i++) {
-    ds_[i] = NULL;
-  }
+  plcCount_            = ECMC_DEFAULT_PLCS;
 
   for (int i = 0; i < ECMC_MAX_PLC_VARIABLES; i++) {
     globalDataArray_[i] = 0;
   }
 
-  for (int i = 0; i < ECMC_MAX_PLUGINS; i++) {
-    plugins_[i] = 0;
-  }
-
   asynPortDriver_ = NULL;
   ec_             = NULL;
   memset(&shm_, 0, sizeof(ecmcShm));
   ecStatus_ = NULL;
   mcuFreq_  = MCU_FREQUENCY;
+  onlineChangeParseTask_ = NULL;
+}
+
+// Grow PLC arrays (normal PLCs + axis PLCs), configuration time only
+void ecmcPLCMain::resizePLCs(int count) {
+  if (count <= (int)plcs_.size()) {
+    return;
+  }
+  plcs_.resize(count, NULL);
+  plcEnable_.resize(count, NULL);
+  plcError_.resize(count, NULL);
+  plcFirstScan_.resize(count, NULL);
+  plcScanTime_.resize(count, NULL);
+  onlineChange_.resize(count, ecmcPLCOnlineChange());
+
+  for (int i = 0; i < count; i++) {
+    onlineChange_[i].plcMain  = this;
+    onlineChange_[i].plcIndex = i;
+  }
 }
 
 int ecmcPLCMain::createPLC(int plcIndex, int skipCycles) {
-  if ((plcIndex < 0) || (plcIndex >= ECMC_MAX_PLCS + ECMC_MAX_AXES)) {
+  if ((plcIndex < 0) || (plcIndex >= (int)plcs_.size())) {
     return ERROR_PLCS_INDEX_OUT_OF_RANGE;
   }
 
@@ -86,11 +108,12 @@ int ecmcPLCMain::createPLC(int plcIndex, int skipCycles) {
     plcEnable_[plcIndex] = NULL;
     plcError_[plcIndex]  = NULL;
     plcFirstScan_[plcIndex] = NULL;
+    plcScanTime_[plcIndex]  = NULL;
     return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
   }
 
   // Set plugin pointers
-  for (int i = 0; i < ECMC_MAX_PLUGINS; i++) {
+  for (size_t i = 0; i < plugins_.size(); i++) {
     plcs_[plcIndex]->setPluginPointer(plugins_[i], i);
   }
 
@@ -102,6 +125,7 @@ int ecmcPLCMain::createPLC(int plcIndex, int skipCycles) {
     plcEnable_[plcIndex]    = NULL;
     plcError_[plcIndex]     = NULL;
     plcFirstScan_[plcIndex] = NULL;
+    plcScanTime_[plcIndex]  = NULL;
     return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
   }
 
@@ -109,34 +133,48 @@ int ecmcPLCMain::createPLC(int plcIndex, int skipCycles) {
 }
 
 int ecmcPLCMain::setAxisGroupArrayPointer(ecmcAxisGroup *grp, int index) {
-  if ((index >= ECMC_MAX_AXES) || (index < 0)) {
+  if ((index >= ECMC_REGISTRY_MAX_SIZE) || (index < 0)) {
     return setErrorID(__FILE__,
                       __FUNCTION__,
                       __LINE__,
                       ERROR_PLCS_AXIS_INDEX_OUT_OF_RANGE);
   }
+
+  if (index >= (int)axisGrp_.size()) {
+    axisGrp_.resize(index + 1, NULL);
+  }
   axisGrp_[index] = grp;
   return 0;
 }
 
 int ecmcPLCMain::setAxisArrayPointer(ecmcAxisBase *axis, int index) {
-  if ((index >= ECMC_MAX_AXES) || (index < 0)) {
+  if ((index >= ECMC_REGISTRY_MAX_SIZE) || (index < 0)) {
     return setErrorID(__FILE__,
                       __FUNCTION__,
                       __LINE__,
                       ERROR_PLCS_AXIS_INDEX_OUT_OF_RANGE);
   }
+
+  // One axis PLC slot per axis
+  if (index >= (int)axes_.size()) {
+    axes_.resize(index + 1, NULL);
+    resizePLCs(plcCount_ + index + 1);
+  }
   axes_[index] = axis;
   return 0;
 }
 
 int ecmcPLCMain::setDataStoragePointer(ecmcDataStorage *ds, int index) {
-  if ((index >= ECMC_MAX_DATA_STORAGE_OBJECTS) || (index < 0)) {
+  if ((index >= ECMC_REGISTRY_MAX_SIZE) || (index < 0)) {
     return setErrorID(__FILE__,
                       __FUNCTION__,
                       __LINE__,
                       ERROR_PLCS_DATA_STORAGE_INDEX_OUT_OF_RANGE);
   }
+
+  if (index >= (int)ds_.size()) {
+    ds_.resize(index + 1, NULL);
+  }
   ds_[index] = ds;
   return 0;
 }
@@ -158,7 +196,7 @@ int ecmcPLCMain::validate() {
 
   int errorCode = 0;
 
-  for (int i = 0; i < ECMC_MAX_PLCS + ECMC_MAX_AXES; i++) {
+  for (int i = 0; i < (int)plcs_.size(); i++) {
     if (plcs_[i]) {
       if (!getCompiled(i)) {
         errorCode = addExprLine(i, plcs_[i]->getRawExpr()->c_str());
@@ -178,7 +216,7 @@ int ecmcPLCMain::validate() {
   }
 
   // Validate
-  for (int i = 0; i < ECMC_MAX_PLCS + ECMC_MAX_AXES; i++) {
+  for (int i = 0; i < (int)plcs_.size(); i++) {
     int errorCode = validate(i);
 
     if (errorCode) {
@@ -196,7 +234,9 @@ int ecmcPLCMain::execute(bool ecOK) {
   }
 
   // ONLY EXECUTE NORMAL PLCS (AXIS PLCs are executed from main thread)
-  for (int plcIndex = 0; plcIndex < ECMC_MAX_PLCS; plcIndex++) {
+  for (int plcIndex = 0; plcIndex < plcCount_; plcIndex++) {
+    swapOnlineChange(plcIndex);
+
     ecmcPLCTask * const plc = plcs_[plcIndex];
     if (plc == NULL) {
       continue;
@@ -215,6 +255,11 @@ int ecmcPLCMain::execute(bool ecOK) {
         plcFirstScan->setData(plc->getFirstScanDone() == 0);  // First scan
       }
     }
+
+    // Rate demoted by time budget
+    if (plc->getSampleTimeChanged() && plcScanTime_[plcIndex]) {
+      plcScanTime_[plcIndex]->setData(plc->getSampleTime());
+    }
   }
 
   /** update asyn params here for all globals to get sample rate correct
@@ -249,11 +294,16 @@ int ecmcPLCMain::execute(int plcIndex, bool ecOK) {
       plcFirstScan->setData(plc->getFirstScanDone() == 0);  // First scan
     }
   }
+
+  // Rate demoted by time budget
+  if (plc->getSampleTimeChanged() && plcScanTime_[plcIndex]) {
+    plcScanTime_[plcIndex]->setData(plc->getSampleTime());
+  }
   return 0;
 }
 
 std::string * ecmcPLCMain::getExpr(int plcIndex, int *error) {
-  if ((plcIndex >= ECMC_MAX_PLCS + ECMC_MAX_AXES) || (plcIndex < 0)) {
+  if ((plcIndex >= (int)plcs_.size()) || (plcIndex < 0)) {
     LOGERR("ERROR: PLC index out of range.\n");
     *error =  ERROR_PLCS_INDEX_OUT_OF_RANGE;
     return NULL;
@@ -321,19 +371,57 @@ int ecmcPLCMain::addExprLine(int plcIndex, const char *expr) {
     }
     strEc++;
   }
-  errorCode = plcs_[plcIndex]->addExprLine(localExpr);
+  errorCode = parseTask(plcIndex)->addExprLine(localExpr);
   free(localExpr);
   return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
 }
 
 int ecmcPLCMain::appendExprLine(int plcIndex, const char *expr) {
   CHECK_PLC_RETURN_IF_ERROR(plcIndex)
-  int errorCode = plcs_[plcIndex]->appendRawExpr(expr);
+  int errorCode = parseTask(plcIndex)->appendRawExpr(expr);
   return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
 }
 
 int ecmcPLCMain::loadPLCFile(int plcIndex, char *fileName) {
   CHECK_PLC_RETURN_IF_ERROR(plcIndex)
+  int errorCode = appendPLCFile(plcIndex, fileName);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  // Set enable as default
+  errorCode = setEnable(plcIndex, 1);
+
+  if (errorCode) {
+    LOGERR("%s/%s:%d: ERROR PLC%d: Error Enabling PLC file: %s (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex,
+           fileName,
+           errorCode);
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+
+  return 0;
+}
+
+// Append the code of a file to the raw expression of the parse task
+int ecmcPLCMain::appendPLCFile(int plcIndex, char *fileName) {
+  std::string code;
+  int errorCode = readPLCFile(plcIndex, fileName, &code);
+
+  if (errorCode) {
+    return errorCode;
+  }
+  return appendPLCCode(plcIndex, code);
+}
+
+// Code of a file with variables substituted (no objects accessed)
+int ecmcPLCMain::readPLCFile(int          plcIndex,
+                             const char  *fileName,
+                             std::string *code) {
   std::ifstream plcFile;
   plcFile.open(fileName);
 
@@ -360,11 +448,14 @@ int ecmcPLCMain::loadPLCFile(int plcIndex, char *fileName) {
   ssCode << fsCode.rdbuf();
   auto alias = parseVarBlock(ssCode.str(),codeNoVar);
 
-  std::string codeSubst = substituteWithSuffix(codeNoVar, alias);
+  *code = substituteWithSuffix(codeNoVar, alias);
   std::cout << "Code (with variables substituted):" << "\n";
-  std::cout << codeSubst;
+  std::cout << *code;
+  return 0;
+}
 
-  std::istringstream ssCodeSubst(codeSubst);
+int ecmcPLCMain::appendPLCCode(int plcIndex, const std::string& code) {
+  std::istringstream ssCodeSubst(code);
   std::string line, lineNoComments;
   int lineNumber = 1;
   int errorCode  = 0;
@@ -393,20 +484,6 @@ int ecmcPLCMain::loadPLCFile(int plcIndex, char *fileName) {
     lineNumber++;
   }
 
-  // Set enable as default
-  errorCode = setEnable(plcIndex, 1);
-
-  if (errorCode) {
-    LOGERR("%s/%s:%d: ERROR PLC%d: Error Enabling PLC file: %s (0x%x).\n",
-           __FILE__,
-           __FUNCTION__,
-           __LINE__,
-           plcIndex,
-           fileName,
-           errorCode);
-    return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
-  }
-
   return 0;
 }
 
@@ -460,7 +537,7 @@ int ecmcPLCMain::getCompiled(int plcIndex, int *compiled) {
 }
 
 int ecmcPLCMain::getCompiled(int plcIndex) {
-  if ((plcIndex >= ECMC_MAX_PLCS + ECMC_MAX_AXES) || (plcIndex < 0)) {
+  if ((plcIndex >= (int)plcs_.size()) || (plcIndex < 0)) {
     LOGERR("ERROR: PLC index out of range.\n");
     return 0;
   }
@@ -589,7 +666,7 @@ int ecmcPLCMain::createNewGlobalDataIF(char              *varName,
   case ECMC_RECORDER_SOURCE_AXIS:
     axisId = getAxisIndex(varName);
 
-    if ((axisId >= ECMC_MAX_AXES) || (axisId < 0)) {
+    if ((axisId >= (int)axes_.size()) || (axisId < 0)) {
       return setErrorID(__FILE__,
                         __FUNCTION__,
                         __LINE__,
@@ -650,7 +727,7 @@ int ecmcPLCMain::createNewGlobalDataIF(char              *varName,
   case ECMC_RECORDER_SOURCE_DATA_STORAGE:
     dsId = getDsIndex(varName);
 
-    if ((dsId >= ECMC_MAX_DATA_STORAGE_OBJECTS) || (dsId < 0)) {
+    if ((dsId >= (int)ds_.size()) || (dsId < 0)) {
       return setErrorID(__FILE__,
                         __FUNCTION__,
                         __LINE__,
@@ -733,7 +810,7 @@ int ecmcPLCMain::parseAxis(int plcIndex, const char *exprStr) {
                    varName);
 
     if (nvals == 2) {
-      if ((axisId >= ECMC_MAX_AXES) || (axisId < 0)) {
+      if ((axisId >= (int)axes_.size()) || (axisId < 0)) {
         free(strLocal);
         return setErrorID(__FILE__,
                           __FUNCTION__,
@@ -841,7 +918,7 @@ int ecmcPLCMain::parseStatic(int plcIndex, const char *exprStr) {
     int nvals = sscanf(strStatic, ECMC_PLC_VAR_FORMAT, varName);
 
     if (nvals == 1) {
-      int errorCode = plcs_[plcIndex]->addAndRegisterLocalVar(varName);
+      int errorCode = parseTask(plcIndex)->addAndRegisterLocalVar(varName);
       if (errorCode) {
         free(strLocal);
         return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
@@ -854,7 +931,7 @@ int ecmcPLCMain::parseStatic(int plcIndex, const char *exprStr) {
 }
 
 int ecmcPLCMain::parseFunctions(int plcIndex, const char *exprStr) {
-  return plcs_[plcIndex]->parseFunctions(exprStr);
+  return parseTask(plcIndex)->parseFunctions(exprStr);
 }
 
 int ecmcPLCMain::parseGlobal(int plcIndex, const char *exprStr) {
@@ -1041,7 +1118,7 @@ int ecmcPLCMain::createAndRegisterNewDataIF(int                plcIndex,
   }
 
   // Register in dedicated PLC if needed
-  errorCode = plcs_[plcIndex]->addAndReisterGlobalVar(dataIF);
+  errorCode = parseTask(plcIndex)->addAndReisterGlobalVar(dataIF);
 
   if (errorCode) {
     return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
@@ -1093,7 +1170,7 @@ int ecmcPLCMain::addPLCDefaultVariables(int plcIndex, int skipCycles) {
 
   if (ec_->getInitDone()) {
     // Add ec<id>.masterstatus
-    errorCode = plcs_[plcIndex]->addAndReisterGlobalVar(ecStatus_);
+    errorCode = parseTask(plcIndex)->addAndReisterGlobalVar(ecStatus_);
 
     if (errorCode) {
       return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
@@ -1130,6 +1207,7 @@ int ecmcPLCMain::addPLCDefaultVariables(int plcIndex, int skipCycles) {
   }
   dataIF->setReadOnly(1);
   dataIF->setData(1 / mcuFreq_ * (skipCycles + 1));
+  plcScanTime_[plcIndex] = dataIF;
 
   // Add plc<index>.firstscan
   errorCode =
@@ -1154,8 +1232,39 @@ int ecmcPLCMain::addPLCDefaultVariables(int plcIndex, int skipCycles) {
   return 0;
 }
 
+// Online change: the default variables exist and are used by the running
+// plc. Only register them in the new program, values are kept.
+int ecmcPLCMain::registerPLCDefaultVariables(int plcIndex) {
+  int errorCode = 0;
+
+  if (ec_->getInitDone()) {
+    errorCode = parseTask(plcIndex)->addAndReisterGlobalVar(ecStatus_);
+
+    if (errorCode) {
+      return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+    }
+  }
+
+  const char *suffixes[] = { ECMC_PLC_ENABLE_DATA_STR,
+                             ECMC_PLC_ERROR_DATA_STR,
+                             ECMC_PLC_SCAN_TIME_DATA_STR,
+                             ECMC_PLC_FIRST_SCAN_STR,
+                             ECMC_PLC_DBG_STR };
+  ecmcPLCDataIF *dataIF = NULL;
+
+  for (size_t i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); i++) {
+    errorCode = addPLCDefaultVariable(plcIndex, suffixes[i], &dataIF);
+
+    if (errorCode) {
+      return errorCode;
+    }
+  }
+
+  return 0;
+}
+
 int ecmcPLCMain::getPLCErrorID() {
-  for (int i = 0; i < ECMC_MAX_PLCS; i++) {
+  for (int i = 0; i < plcCount_; i++) {
     ecmcPLCDataIF * const plcError = plcError_[i];
     if (plcError) {
       const double plcErrorValue = plcError->getData();
@@ -1181,7 +1290,7 @@ int ecmcPLCMain::getErrorID() {
 
 void ecmcPLCMain::errorReset() {
   // reset all plc error
-  for (int i = 0; i < ECMC_MAX_PLCS; i++) {
+  for (int i = 0; i < plcCount_; i++) {
     ecmcPLCDataIF * const plcError = plcError_[i];
     if (plcError && plcError->getData()) {
       plcError->setData(0);
@@ -1223,7 +1332,7 @@ int ecmcPLCMain::updateAllScanTimeVars(int plcIndex) {
 
 int ecmcPLCMain::updateAllScanTimeVars() {
   // Update all scantime variables for all axes)
-  for (int i = 0; i < ECMC_MAX_PLCS + ECMC_MAX_AXES; i++) {
+  for (int i = 0; i < (int)plcs_.size(); i++) {
     int error = updateAllScanTimeVars(i);
 
     if (error) {
@@ -1248,14 +1357,14 @@ int ecmcPLCMain::writeStaticPLCVar(int plcIndex, const char  *varName,
 ecmcPLCTask * ecmcPLCMain::getPLCTaskForAxis(int axisId) {
   /*
    PLCs in array:
-   0             .. (ECMC_MAX_PLCS-1)                   : Normal PLCs (exe here)
-   ECMC_MAX_PLCS .. (ECMC_MAX_PLCS + ECMC_MAX_AXES-1)   : PLC objects for axis syncs
-                                                          exe in axis objects
+   0         .. (plcCount_-1)              : Normal PLCs (exe here)
+   plcCount_ .. (plcCount_ + axisCount-1)  : PLC objects for axis syncs
+                                             exe in axis objects
   */
   int error = 0;
-  int index = ECMC_MAX_PLCS + axisId;
+  int index = plcCount_ + axisId;
 
-  if ((index >= ECMC_MAX_PLCS + ECMC_MAX_AXES) || (index < ECMC_MAX_PLCS)) {
+  if ((index >= (int)plcs_.size()) || (index < plcCount_)) {
     LOGERR("%s/%s:%d: ERROR: Axis PLC index out of range.\n",
            __FILE__,
            __FUNCTION__,
@@ -1300,7 +1409,7 @@ int ecmcPLCMain::addPLCDefaultVariable(int             plcIndex,
   int  chars = 0;
 
   // Normal PLC
-  if (plcIndex < ECMC_MAX_PLCS) {
+  if (plcIndex < plcCount_) {
     chars = snprintf(varName,
                      EC_MAX_OBJECT_PATH_CHAR_LENGTH - 1,
                      ECMC_PLC_DATA_STR "%d.%s",
@@ -1316,7 +1425,7 @@ int ecmcPLCMain::addPLCDefaultVariable(int             plcIndex,
     chars = snprintf(varName,
                      EC_MAX_OBJECT_PATH_CHAR_LENGTH - 1,
                      ECMC_AX_STR "%d." ECMC_PLC_DATA_STR ".%s",
-                     plcIndex - ECMC_MAX_PLCS, suffix);
+                     plcIndex - plcCount_, suffix);
 
     if (chars >= EC_MAX_OBJECT_PATH_CHAR_LENGTH - 1) {
       return setErrorID(__FILE__,
@@ -1356,10 +1465,14 @@ int ecmcPLCMain::addPLCDefaultVariable(int             plcIndex,
 }
 
 int ecmcPLCMain::setPluginPointer(ecmcPluginLib *plugin, int index) {
-  if ((index < 0) || (index >= ECMC_MAX_PLUGINS)) {
+  if ((index < 0) || (index >= ECMC_REGISTRY_MAX_SIZE)) {
     return ERROR_PLCS_PLUGIN_INDEX_OUT_OF_RANGE;
   }
 
+  if (index >= (int)plugins_.size()) {
+    plugins_.resize(index + 1, NULL);
+  }
+
   plugins_[index] = plugin;
   return 0;
 }
@@ -1393,6 +1506,408 @@ int ecmcPLCMain::addLib(int plcIndex, ecmcPLCLib* lib) {
   return plcs_[plcIndex]->addLib(lib);
 }
 
+/*
+ * Find all axis variables in the code of a plc. A variable is written if
+ * followed by an assignment operator (":=", "+=", "-=", "*=", "/=", "%=").
+ */
+int ecmcPLCMain::getAxisAccess(int plcIndex, std::vector<int> *access) {
+  access->assign(axes_.size(), 0);
+
+  // Not an error, axes without plc
+  if ((plcIndex >= (int)plcs_.size()) || (plcIndex < 0) ||
+      !plcs_[plcIndex]) {
+    return ERROR_PLCS_PLC_NULL;
+  }
+
+  const char *expr    = plcs_[plcIndex]->getExpr()->c_str();
+  const char *strAxis = expr;
+  int   axisId        = 0;
+  char  varName[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  while ((strAxis = strstr(strAxis, ECMC_AX_STR)) && strlen(strAxis) > 0) {
+    // Not a part of another name (like "max1.")
+    if ((strAxis > expr) &&
+        (std::isalnum(static_cast<unsigned char>(strAxis[-1])) ||
+         (strAxis[-1] == '_') ||
+         (strAxis[-1] == '.'))) {
+      strAxis++;
+      continue;
+    }
+
+    int nvals = sscanf(strAxis,
+                       ECMC_AX_STR "%d." ECMC_PLC_VAR_FORMAT,
+                       &axisId,
+                       varName);
+
+    if ((nvals == 2) && (axisId >= 0) && (axisId < (int)axes_.size())) {
+      const char *op = strAxis + strspn(strAxis,
+                                        "0123456789abcdefghijklmnopqrstuvwxyz"
+                                        "ABCDEFGHIJKLMNOPQRSTUVWXYZ._");
+      op += strspn(op, " \t");
+
+      if ((op[0] == ':' || op[0] == '+' || op[0] == '-' || op[0] == '*' ||
+           op[0] == '/' || op[0] == '%') && (op[1] == '=')) {
+        (*access)[axisId] |= ECMC_PLC_AXIS_ACCESS_WRITE;
+      } else {
+        (*access)[axisId] |= ECMC_PLC_AXIS_ACCESS_READ;
+      }
+    }
+    strAxis++;
+  }
+  return 0;
+}
+
+ecmcPLCTask * ecmcPLCMain::parseTask(int plcIndex) {
+  // New program during online change, otherwise the plc itself
+  if (onlineChangeParseTask_ &&
+      (onlineChangeParseTask_ == onlineChange_[plcIndex].task)) {
+    return onlineChangeParseTask_;
+  }
+  return plcs_[plcIndex];
+}
+
+/** Load, parse and compile new code for a running plc.
+ *  Parsing (variable bindings) is made here with the port locked,
+ *  compile is made in a worker thread and the rt thread swaps in the
+ *  new program at the start of a cycle. The running program is kept if
+ *  any step fails.
+ */
+// Parse code to a new program. The raw code, enable and default variables
+// of the running plc are untouched.
+int ecmcPLCMain::loadPLCCodeOnline(int plcIndex, const std::string& code) {
+  ecmcPLCOnlineChange *change = &onlineChange_[plcIndex];
+  ecmcPLCTask *task           = new ecmcPLCTask(plcs_[plcIndex]);
+  int errorCode               = task->getErrorID();
+
+  if (!errorCode) {
+    change->task           = task;
+    onlineChangeParseTask_ = task;
+    errorCode              = appendPLCCode(plcIndex, code);
+
+    if (!errorCode) {
+      errorCode = registerPLCDefaultVariables(plcIndex);
+    }
+
+    if (!errorCode) {
+      errorCode = addExprLine(plcIndex, task->getRawExpr()->c_str());
+    }
+    onlineChangeParseTask_ = NULL;
+  }
+
+  if (errorCode) {
+    change->task = NULL;
+    task->releaseLocalVars();
+    delete task;
+  }
+  return errorCode;
+}
+
+int ecmcPLCMain::loadPLCFileOnline(int plcIndex, char *fileName) {
+  CHECK_PLC_RETURN_IF_ERROR(plcIndex)
+
+  // Axis plcs are referenced by the axis objects
+  if (plcIndex >= plcCount_) {
+    LOGERR("%s/%s:%d: ERROR PLC%d: Online change of axis PLC not supported (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex,
+           ERROR_PLCS_ONLINE_CHANGE_AXIS_PLC);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLCS_ONLINE_CHANGE_AXIS_PLC);
+  }
+
+  ecmcPLCOnlineChange *change = &onlineChange_[plcIndex];
+
+  if (epicsAtomicGetIntT(&change->busy)) {
+    LOGERR("%s/%s:%d: ERROR PLC%d: Online change already in progress (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex,
+           ERROR_PLCS_ONLINE_CHANGE_BUSY);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLCS_ONLINE_CHANGE_BUSY);
+  }
+
+  int64_t startNs = onlineChangeTimeNs();
+
+  // File access and printouts in the calling thread
+  std::string code;
+  int errorCode = readPLCFile(plcIndex, fileName, &code);
+
+  if (!errorCode) {
+    // Variables are registered in the shared data items, so exclusive with
+    // the rt thread (executed by the rt thread if lock free)
+    int rtError = ecmcRTExec([&]() {
+                               errorCode = loadPLCCodeOnline(plcIndex, code);
+                             });
+
+    if (rtError) {
+      errorCode = rtError;
+    }
+  }
+
+  if (errorCode) {
+    change->errorCode = errorCode;
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+  ecmcPLCTask *task = change->task;
+
+  change->parseTimeMs = (onlineChangeTimeNs() - startNs) / 1E6;
+  change->replaced    = NULL;
+  change->errorCode   = 0;
+  epicsAtomicSetIntT(&change->swapped, 0);
+  epicsAtomicSetIntT(&change->busy, 1);
+
+  if (epicsThreadCreate(ECMC_PLC_ONLINE_CHANGE_THREAD_NAME,
+                        epicsThreadPriorityLow,
+                        epicsThreadGetStackSize(epicsThreadStackBig),
+                        ecmcPLCOnlineChangeThread,
+                        change) == NULL) {
+    LOGERR("%s/%s:%d: ERROR PLC%d: Create online change thread failed (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex,
+           ERROR_PLCS_ONLINE_CHANGE_THREAD_FAIL);
+    change->task      = NULL;
+    change->errorCode = ERROR_PLCS_ONLINE_CHANGE_THREAD_FAIL;
+    task->releaseLocalVars();
+    delete task;
+    epicsAtomicSetIntT(&change->busy, 0);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLCS_ONLINE_CHANGE_THREAD_FAIL);
+  }
+
+  return 0;
+}
+
+void ecmcPLCMain::onlineChangeTask(int plcIndex) {
+  registerHelperThread(ECMC_PLC_ONLINE_CHANGE_THREAD_NAME);
+
+  ecmcPLCOnlineChange *change = &onlineChange_[plcIndex];
+  ecmcPLCTask *task           = change->task;
+
+  // Port is not locked, the rt thread runs the old program meanwhile
+  int64_t startNs = onlineChangeTimeNs();
+  int errorCode   = task->compile();
+
+  change->compileTimeMs = (onlineChangeTimeNs() - startNs) / 1E6;
+
+  if (!errorCode) {
+    change->publishTimeNs = onlineChangeTimeNs();
+    epicsAtomicSetPtrT(&change->pending, task);
+
+    double waitS = 0;
+
+    while (!epicsAtomicGetIntT(&change->swapped)) {
+      // Withdraw if the rt thread does not pick it up (not running)
+      if ((waitS >= ECMC_PLC_ONLINE_CHANGE_TIMEOUT_S) &&
+          (epicsAtomicCmpAndSwapPtrT(&change->pending, task, NULL) == task)) {
+        errorCode = ERROR_PLCS_ONLINE_CHANGE_TIMEOUT;
+        break;
+      }
+      epicsThreadSleep(ECMC_PLC_ONLINE_CHANGE_POLL_S);
+      waitS += ECMC_PLC_ONLINE_CHANGE_POLL_S;
+    }
+  }
+
+  if (errorCode) {
+    LOGERR("%s/%s:%d: ERROR PLC%d: Online change failed, old program kept (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex,
+           errorCode);
+
+    // Static variables have asyn params, never deleted
+    task->releaseLocalVars();
+    delete task;
+  } else {
+    epicsAtomicReadMemoryBarrier();
+    change->swapLatencyUs = (change->swapTimeNs - change->publishTimeNs) /
+                            1E3;
+
+    if (change->swapLatencyUs > change->swapLatencyMaxUs) {
+      change->swapLatencyMaxUs = change->swapLatencyUs;
+    }
+
+    ecmcPLCTask *replaced = change->replaced;
+    auto commit = [task, replaced]() {
+                    return task->commitOnlineChange(replaced);
+                  };
+    int commitError = 0;
+
+    // Lock free rt thread: executed by the rt thread
+    if (ecmcRTLockFree()) {
+      commitError = ecmcRTExec(commit);
+    } else {
+      if (asynPortDriver_) {
+        asynPortDriver_->lock();
+      }
+      commitError = commit();
+
+      if (asynPortDriver_) {
+        asynPortDriver_->unlock();
+      }
+    }
+
+    // Not committed: the replaced program still owns the static variables
+    // of the running one, keep it instead of deleting them
+    if (commitError) {
+      LOGERR("%s/%s:%d: ERROR PLC%d: Online change commit failed, replaced program not released (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             plcIndex,
+             commitError);
+      errorCode = commitError;
+    } else {
+      delete change->replaced;
+    }
+    change->changeCount++;
+    LOGINFO4("%s/%s:%d: PLC%d online change done (compile %.3fms, swap %.1fus).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             plcIndex,
+             change->compileTimeMs,
+             change->swapLatencyUs);
+  }
+
+  change->task      = NULL;
+  change->replaced  = NULL;
+  change->errorCode = errorCode;
+  unregisterHelperThread();
+  epicsAtomicSetIntT(&change->busy, 0);
+}
+
+// Executed in rt at the start of the plc cycle
+void ecmcPLCMain::swapOnlineChange(int plcIndex) {
+  ecmcPLCOnlineChange * const change = &onlineChange_[plcIndex];
+  ecmcPLCTask * const task           =
+    (ecmcPLCTask *)epicsAtomicGetPtrT(&change->pending);
+
+  if (!task) {
+    return;
+  }
+
+  // Only swap if not withdrawn by the worker thread
+  if (epicsAtomicCmpAndSwapPtrT(&change->pending, task, NULL) != task) {
+    return;
+  }
+
+  change->replaced   = plcs_[plcIndex];
+  plcs_[plcIndex]    = task;
+  change->swapTimeNs = onlineChangeTimeNs();
+  epicsAtomicWriteMemoryBarrier();
+  epicsAtomicSetIntT(&change->swapped, 1);
+}
+
+int ecmcPLCMain::setTimeBudget(int plcIndex, double budgetUs) {
+  CHECK_PLC_RETURN_IF_ERROR(plcIndex)
+  ecmcPLCProfiler *profiler = plcs_[plcIndex]->getProfiler();
+
+  if (!profiler) {
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__, ERROR_PLCS_PLC_NULL);
+  }
+  return profiler->setBudget(budgetUs);
+}
+
+int ecmcPLCMain::setBudgetDemotion(int plcIndex,
+                                   int overrunLimit,
+                                   int skipCycles) {
+  CHECK_PLC_RETURN_IF_ERROR(plcIndex)
+  ecmcPLCProfiler *profiler = plcs_[plcIndex]->getProfiler();
+
+  if (!profiler) {
+    return setErrorID(__FILE__, __FUNCTION__, __LINE__, ERROR_PLCS_PLC_NULL);
+  }
+  return profiler->setDemotion(overrunLimit, skipCycles);
+}
+
+void ecmcPLCMain::printProfile() {
+  printf("PLC execution profile (times in us, axis PLCs from index %d):\n",
+         plcCount_);
+  printf("  %-6s %-10s %-9s %-9s %-9s %-9s %-9s %-9s %-10s %-9s %-5s\n",
+         "plc",
+         "count",
+         "exe",
+         "exe min",
+         "exe max",
+         "read",
+         "eval",
+         "write",
+         "budget",
+         "overruns",
+         "skip");
+
+  for (size_t i = 0; i < plcs_.size(); i++) {
+    if (plcs_[i] && plcs_[i]->getProfiler()) {
+      plcs_[i]->getProfiler()->print();
+    }
+  }
+}
+
+int ecmcPLCMain::setNativeMode(int plcIndex, int mode) {
+  CHECK_PLC_RETURN_IF_ERROR(plcIndex)
+  return plcs_[plcIndex]->setNativeMode(mode);
+}
+
+void ecmcPLCMain::printNativeStatus() {
+  printf("PLC native code status (axis PLCs from index %d):\n", plcCount_);
+  printf("  %-4s %-7s %-7s %-10s %-12s %-12s %s\n",
+         "plc",
+         "mode",
+         "loaded",
+         "build[ms]",
+         "verified",
+         "mismatches",
+         "info");
+
+  for (size_t i = 0; i < plcs_.size(); i++) {
+    if (plcs_[i] && plcs_[i]->getNative()) {
+      plcs_[i]->getNative()->print(plcs_[i]->getNativeMode());
+    }
+  }
+}
+
+void ecmcPLCMain::printOnlineChangeStatus() {
+  printf("PLC online change status:\n");
+  printf("  %-4s %-5s %-8s %-10s %-12s %-10s %-14s %s\n",
+         "plc",
+         "busy",
+         "changes",
+         "parse[ms]",
+         "compile[ms]",
+         "swap[us]",
+         "swap max[us]",
+         "error");
+
+  for (int i = 0; i < plcCount_; i++) {
+    if (!plcs_[i]) {
+      continue;
+    }
+    ecmcPLCOnlineChange *change = &onlineChange_[i];
+    printf("  %-4d %-5d %-8d %-10.3f %-12.3f %-10.1f %-14.1f 0x%x\n",
+           i,
+           epicsAtomicGetIntT(&change->busy),
+           change->changeCount,
+           change->parseTimeMs,
+           change->compileTimeMs,
+           change->swapLatencyUs,
+           change->swapLatencyMaxUs,
+           change->errorCode);
+  }
+}
+
 void ecmcPLCMain::trimInplace(std::string& s) {
   size_t a = 0, b = s.size();
   while (a < b && std::isspace(static_cast<unsigned char>(s[a]))) ++a;
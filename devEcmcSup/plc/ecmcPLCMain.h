@@ -19,6 +19,7 @@
 #include <string>
 #include <regex>
 #include <unordered_map>
+#include <vector>
 #include "ecmcAsynPortDriver.h"
 #include "ecmcDefinitions.h"
 #include "ecmcAxisBase.h"
@@ -28,6 +29,7 @@
 #include "ecmcPLCTask.h"
 #include "ecmcPLCDataIF.h"
 #include "ecmcLookupTable.h"
+#include "ecmcRegistry.h"
 
 #define ERROR_PLCS_INDEX_OUT_OF_RANGE 0x20700
 #define ERROR_PLCS_AXIS_INDEX_OUT_OF_RANGE 0x20701
@@ -41,10 +43,22 @@
 #define ERROR_PLCS_PLUGIN_INDEX_OUT_OF_RANGE 0x20709
 #define ERROR_PLCS_PLC_INDEX_ALREADY_CREATED 0x2070A
 #define ERROR_PLCS_LIB_FILE_INVALID 0x2070B
+#define ERROR_PLCS_ONLINE_CHANGE_BUSY 0x2070C
+#define ERROR_PLCS_ONLINE_CHANGE_AXIS_PLC 0x2070D
+#define ERROR_PLCS_ONLINE_CHANGE_TIMEOUT 0x2070E
+#define ERROR_PLCS_ONLINE_CHANGE_THREAD_FAIL 0x2070F
+
+// Axis variable access of a plc (getAxisAccess())
+#define ECMC_PLC_AXIS_ACCESS_READ 0x1
+#define ECMC_PLC_AXIS_ACCESS_WRITE 0x2
+
+#define ECMC_PLC_ONLINE_CHANGE_THREAD_NAME "ecmcPLCOnline"
+#define ECMC_PLC_ONLINE_CHANGE_TIMEOUT_S 5.0
+#define ECMC_PLC_ONLINE_CHANGE_POLL_S 0.001
 
 
 #define CHECK_PLC_RETURN_IF_ERROR(index) {\
-          if (index >= ECMC_MAX_PLCS + ECMC_MAX_AXES || index < 0) {\
+          if (index >= (int)plcs_.size() || index < 0) {\
             LOGERR("ERROR: PLC index out of range.\n");\
             return ERROR_PLCS_INDEX_OUT_OF_RANGE;\
           }\
@@ -59,11 +73,38 @@
     bool allow_suffix; // ax*, ax*.{drv,enc,mon,traj}, ds*, ec*.s* -> true
   };
 
+class ecmcPLCMain;
+
+/**
+*  State and diagnostics of the online change of one PLC.
+*  The new program is compiled in a worker thread and handed to the rt
+*  thread through "pending". The rt thread swaps it in at the start of the
+*  next cycle and the worker thread deletes the replaced task.
+*/
+typedef struct ecmcPLCOnlineChange {
+  ecmcPLCMain *plcMain;
+  int          plcIndex;
+  int          busy;              // Change in progress (atomic)
+  int          swapped;           // Set by rt thread after swap (atomic)
+  ecmcPLCTask *task;              // New program
+  void        *pending;           // Compiled task waiting for rt (atomic)
+  ecmcPLCTask *replaced;          // Swapped out by rt thread
+  int64_t      publishTimeNs;
+  int64_t      swapTimeNs;
+  double       parseTimeMs;       // In command thread (port locked)
+  double       compileTimeMs;     // In worker thread
+  double       swapLatencyUs;     // Publish to swap in rt thread
+  double       swapLatencyMaxUs;
+  int          changeCount;
+  int          errorCode;
+} ecmcPLCOnlineChange;
+
 class ecmcPLCMain : public ecmcError {
 public:
   explicit ecmcPLCMain(ecmcEc             *ec,
                        double              mcuFreq,
-                       ecmcAsynPortDriver *asynPortDriver);
+                       ecmcAsynPortDriver *asynPortDriver,
+                       int                 plcCount);
   ~ecmcPLCMain();
   int          createPLC(int plcIndex,
                          int skipCycles);
@@ -116,19 +157,57 @@ public:
   ecmcPLCTask* getPLCTaskForAxis(int axisId);
   int          addLib(int plcIndex, ecmcPLCLib* lib);
 
+  // Axis variables used in the code of a plc (for the execution order).
+  // access[axisIndex]: ECMC_PLC_AXIS_ACCESS_READ/WRITE bits
+  int          getAxisAccess(int                plcIndex,
+                             std::vector<int> *access);
+
+  // Online change (runtime): load, parse and compile in background
+  int          loadPLCFileOnline(int   plcIndex,
+                                 char *fileName);
+  void         printOnlineChangeStatus();
+
+  // Execution profile and time budget
+  int          setTimeBudget(int    plcIndex,
+                             double budgetUs);
+  int          setBudgetDemotion(int plcIndex,
+                                 int overrunLimit,
+                                 int skipCycles);
+  void         printProfile();
+
+  // Native (compiled) PLC code, see ecmcPLCNative.h
+  int          setNativeMode(int plcIndex,
+                             int mode);
+  void         printNativeStatus();
+
+  // Worker thread of the online change (not for external use)
+  void         onlineChangeTask(int plcIndex);
 
 private:
   void         initVars();
+  void         resizePLCs(int count);
   int          createNewGlobalDataIF(char              *varName,
                                      ecmcDataSourceType dataSource,
                                      ecmcPLCDataIF    **outDataIF);
   int          createAndRegisterNewDataIF(int                plcIndex,
                                           char              *varName,
                                           ecmcDataSourceType dataSource);
+  ecmcPLCTask* parseTask(int plcIndex);
+  int          appendPLCFile(int   plcIndex,
+                             char *fileName);
+  int          readPLCFile(int          plcIndex,
+                           const char  *fileName,
+                           std::string *code);
+  int          appendPLCCode(int                plcIndex,
+                             const std::string& code);
+  int          loadPLCCodeOnline(int                plcIndex,
+                                 const std::string& code);
+  void         swapOnlineChange(int plcIndex);
   int          getAxisIndex(char *varName);
   int          getDsIndex(char *varName);
   int          addPLCDefaultVariables(int plcIndex,
                                       int skipCycles);
+  int          registerPLCDefaultVariables(int plcIndex);
   int          addPLCDefaultVariable(int             plcIndex,
                                      const char     *suffix,
                                      ecmcPLCDataIF **dataIFOut);
@@ -164,22 +243,29 @@ private:
 
   int          globalVariableCount_;
 
-  // Dedicateed plcs then one per axis
-  ecmcPLCTask *plcs_[ECMC_MAX_PLCS + ECMC_MAX_AXES];
-  ecmcAxisBase *axes_[ECMC_MAX_AXES];
-  ecmcAxisGroup *axisGrp_[ECMC_MAX_AXES];
-  ecmcDataStorage *ds_[ECMC_MAX_DATA_STORAGE_OBJECTS];
+  // Dedicated plcs (0..plcCount_-1) then one per axis.
+  // Sized during configuration (set*Pointer()), fixed in runtime
+  int plcCount_;
+  std::vector<ecmcPLCTask *>plcs_;
+  std::vector<ecmcAxisBase *>axes_;
+  std::vector<ecmcAxisGroup *>axisGrp_;
+  std::vector<ecmcDataStorage *>ds_;
 
   ecmcEc *ec_;
   ecmcAsynPortDriver *asynPortDriver_;
-  ecmcPLCDataIF *plcEnable_[ECMC_MAX_PLCS + ECMC_MAX_AXES];
-  ecmcPLCDataIF *plcError_[ECMC_MAX_PLCS + ECMC_MAX_AXES];
-  ecmcPLCDataIF *plcFirstScan_[ECMC_MAX_PLCS + ECMC_MAX_AXES];
+  std::vector<ecmcPLCDataIF *>plcEnable_;
+  std::vector<ecmcPLCDataIF *>plcError_;
+  std::vector<ecmcPLCDataIF *>plcFirstScan_;
+  std::vector<ecmcPLCDataIF *>plcScanTime_;
   ecmcPLCDataIF *globalDataArray_[ECMC_MAX_PLC_VARIABLES];
   ecmcPLCDataIF *ecStatus_;
   double mcuFreq_;
-  ecmcPluginLib *plugins_[ECMC_MAX_PLUGINS];
+  std::vector<ecmcPluginLib *>plugins_;
   ecmcShm shm_;
+
+  // Online change, task that parsed variables are registered in
+  ecmcPLCTask *onlineChangeParseTask_;
+  std::vector<ecmcPLCOnlineChange>onlineChange_;
 };
 
 
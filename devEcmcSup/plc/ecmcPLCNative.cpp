@@ -0,0 +1,1588 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcPLCNative.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcPLCNative.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <inttypes.h>
+#include <map>
+#include "ecmcDefinitions.h"
+
+extern char **environ;
+
+// Helpers and function pointer types of the generated code
+static const char *nativePrelude =
+  "#include <cmath>\n"
+  "\n"
+  "typedef double (*n_f0)();\n"
+  "typedef double (*n_f1)(double);\n"
+  "typedef double (*n_f2)(double, double);\n"
+  "typedef double (*n_f3)(double, double, double);\n"
+  "typedef double (*n_f4)(double, double, double, double);\n"
+  "typedef double (*n_f5)(double, double, double, double, double);\n"
+  "typedef double (*n_f6)(double, double, double, double, double, double);\n"
+  "typedef double (*n_f7)(double, double, double, double, double, double,\n"
+  "                       double);\n"
+  "typedef double (*n_f8)(double, double, double, double, double, double,\n"
+  "                       double, double);\n"
+  "typedef double (*n_f9)(double, double, double, double, double, double,\n"
+  "                       double, double, double);\n"
+  "typedef double (*n_f10)(double, double, double, double, double, double,\n"
+  "                        double, double, double, double);\n"
+  "\n"
+  "static inline double n_b(bool x) { return x ? 1.0 : 0.0; }\n"
+  "static inline double n_and(double a, double b) {\n"
+  "  return n_b(a != 0 && b != 0);\n}\n"
+  "static inline double n_or(double a, double b) {\n"
+  "  return n_b(a != 0 || b != 0);\n}\n"
+  "static inline double n_nand(double a, double b) {\n"
+  "  return n_b(!(a != 0 && b != 0));\n}\n"
+  "static inline double n_nor(double a, double b) {\n"
+  "  return n_b(!(a != 0 || b != 0));\n}\n"
+  "static inline double n_xor(double a, double b) {\n"
+  "  return n_b((a != 0) != (b != 0));\n}\n"
+  "static inline double n_xnor(double a, double b) {\n"
+  "  return n_b((a != 0) == (b != 0));\n}\n"
+  "static inline double n_min(double a, double b) {\n"
+  "  return (b < a) ? b : a;\n}\n"
+  "static inline double n_max(double a, double b) {\n"
+  "  return (a < b) ? b : a;\n}\n"
+  "static inline double n_sgn(double x) {\n"
+  "  return (x > 0) ? 1.0 : ((x < 0) ? -1.0 : 0.0);\n}\n"
+  "static inline double n_frac(double x) { return x - std::trunc(x); }\n"
+  "static inline double n_deg2rad(double x) {\n"
+  "  return x * (3.14159265358979323846 / 180.0);\n}\n"
+  "static inline double n_rad2deg(double x) {\n"
+  "  return x * (180.0 / 3.14159265358979323846);\n}\n"
+  "static inline double n_equal(double a, double b) {\n"
+  "  double m = std::fabs(a) > std::fabs(b) ? std::fabs(a) : std::fabs(b);\n"
+  "  return n_b(std::fabs(a - b) <= (m > 1.0 ? m : 1.0) * 1e-10);\n}\n"
+  "static inline double n_clamp(double l, double x, double h) {\n"
+  "  return (x < l) ? l : ((x > h) ? h : x);\n}\n"
+  "static inline double n_inrange(double l, double x, double h) {\n"
+  "  return n_b(l <= x && x <= h);\n}\n"
+  "static inline double n_logn(double x, double n) {\n"
+  "  return std::log(x) / std::log(n);\n}\n"
+  "static inline double n_root(double x, double n) {\n"
+  "  return std::pow(x, 1.0 / n);\n}\n"
+  "static inline double n_roundn(double x, double n) {\n"
+  "  double p = std::pow(10.0, std::floor(n));\n"
+  "  return (x < 0) ? std::ceil(x * p - 0.5) / p : std::floor(x * p + 0.5) / p;\n"
+  "}\n"
+  "\n";
+
+struct ecmcPLCNativeBuiltin {
+  const char *name;
+  const char *cName;
+  int         argCount;  // -1: variadic (chained with cName)
+};
+
+static const ecmcPLCNativeBuiltin nativeBuiltins[] = {
+  { "abs",      "std::fabs",   1 },
+  { "acos",     "std::acos",   1 },
+  { "acosh",    "std::acosh",  1 },
+  { "asin",     "std::asin",   1 },
+  { "asinh",    "std::asinh",  1 },
+  { "atan",     "std::atan",   1 },
+  { "atanh",    "std::atanh",  1 },
+  { "cbrt",     "std::cbrt",   1 },
+  { "ceil",     "std::ceil",   1 },
+  { "cos",      "std::cos",    1 },
+  { "cosh",     "std::cosh",   1 },
+  { "erf",      "std::erf",    1 },
+  { "erfc",     "std::erfc",   1 },
+  { "exp",      "std::exp",    1 },
+  { "expm1",    "std::expm1",  1 },
+  { "floor",    "std::floor",  1 },
+  { "log",      "std::log",    1 },
+  { "log10",    "std::log10",  1 },
+  { "log1p",    "std::log1p",  1 },
+  { "log2",     "std::log2",   1 },
+  { "round",    "std::round",  1 },
+  { "sin",      "std::sin",    1 },
+  { "sinh",     "std::sinh",   1 },
+  { "sqrt",     "std::sqrt",   1 },
+  { "tan",      "std::tan",    1 },
+  { "tanh",     "std::tanh",   1 },
+  { "trunc",    "std::trunc",  1 },
+  { "sgn",      "n_sgn",       1 },
+  { "frac",     "n_frac",      1 },
+  { "deg2rad",  "n_deg2rad",   1 },
+  { "rad2deg",  "n_rad2deg",   1 },
+  { "atan2",    "std::atan2",  2 },
+  { "pow",      "std::pow",    2 },
+  { "hypot",    "std::hypot",  2 },
+  { "equal",    "n_equal",     2 },
+  { "logn",     "n_logn",      2 },
+  { "root",     "n_root",      2 },
+  { "roundn",   "n_roundn",    2 },
+  { "clamp",    "n_clamp",     3 },
+  { "inrange",  "n_inrange",   3 },
+  { "min",      "n_min",      -1 },
+  { "max",      "n_max",      -1 },
+  { "mand",     "n_and",      -1 },
+  { "mor",      "n_or",       -1 },
+  { NULL,       NULL,          0 }
+};
+
+enum ecmcPLCNativeTokType {
+  NATIVE_TOK_END = 0,
+  NATIVE_TOK_NUM,
+  NATIVE_TOK_IDENT,
+  NATIVE_TOK_OP
+};
+
+struct ecmcPLCNativeTok {
+  int         type;
+  std::string text;  // Op, number or identifier (lower case)
+  int         line;
+};
+
+struct ecmcPLCNativeExpr {
+  std::string code;
+  bool        lvalue;
+};
+
+static std::string nativeLower(const std::string& str) {
+  std::string lower = str;
+
+  for (size_t i = 0; i < lower.size(); i++) {
+    lower[i] = (char)tolower((unsigned char)lower[i]);
+  }
+  return lower;
+}
+
+static std::string nativeNumber(double value) {
+  char buffer[64];
+
+  if (isinf(value)) {
+    return value > 0 ? "HUGE_VAL" : "(-HUGE_VAL)";
+  }
+
+  if (isnan(value)) {
+    return "NAN";
+  }
+  snprintf(buffer, sizeof(buffer), "%.17g", value);
+  std::string str = buffer;
+
+  if (str.find_first_of(".e") == std::string::npos) {
+    str += ".0";
+  }
+
+  if (value < 0) {
+    str = "(" + str + ")";
+  }
+  return str;
+}
+
+/* Recursive descent translator of the exprtk subset used in PLC code.
+ * Symbols are case insensitive (as in exprtk). Any unsupported
+ * construct makes the translation fail (PLC stays on exprtk).
+ */
+class ecmcPLCNativeTranslator {
+public:
+  ecmcPLCNativeTranslator() {
+    pos_            = 0;
+    localCount_     = 0;
+    loopDepth_      = 0;
+    callsFunctions_ = false;
+  }
+
+  std::map<std::string, int> vars_;
+  std::map<std::string, int> funcs_;
+  std::vector<int> funcArgCount_;
+  std::map<std::string, double> consts_;
+  bool callsFunctions_;  // Functions of the libs (side effects)
+
+  bool translate(const std::string& expr, std::string *body) {
+    if (!tokenize(expr)) {
+      return false;
+    }
+    scopes_.clear();
+    scopes_.push_back(std::map<std::string, std::string>());
+
+    if (!statementList(false, body, 1)) {
+      return false;
+    }
+    return true;
+  }
+
+  std::string getError() {
+    return error_;
+  }
+
+private:
+  bool fail(const std::string& what) {
+    if (error_.empty()) {
+      char buffer[32];
+      int  line = pos_ < toks_.size() ? toks_[pos_].line : 0;
+      snprintf(buffer, sizeof(buffer), " (line %d)", line);
+      error_ = what + buffer;
+    }
+    return false;
+  }
+
+  bool tokenize(const std::string& s) {
+    size_t n    = s.size();
+    size_t i    = 0;
+    int    line = 1;
+
+    static const char *ops2[] = { ":=", "+=", "-=", "*=", "/=", "%=", "==",
+                                  "!=", "<>", "<=", ">=", "&&", "||", NULL };
+    static const char *ops1 = "+-*/%^()<>=,;?:!&|{}";
+
+    toks_.clear();
+
+    while (i < n) {
+      char c    = s[i];
+      char next = i + 1 < n ? s[i + 1] : 0;
+
+      if (c == '\n') {
+        line++;
+        i++;
+        continue;
+      }
+
+      if (isspace((unsigned char)c)) {
+        i++;
+        continue;
+      }
+
+      // Comments
+      if ((c == '#') || ((c == '/') && (next == '/'))) {
+        while (i < n && s[i] != '\n') {
+          i++;
+        }
+        continue;
+      }
+
+      if ((c == '/') && (next == '*')) {
+        i += 2;
+
+        while (i + 1 < n && !(s[i] == '*' && s[i + 1] == '/')) {
+          if (s[i] == '\n') {
+            line++;
+          }
+          i++;
+        }
+        i += 2;
+        continue;
+      }
+
+      ecmcPLCNativeTok tok;
+      tok.line = line;
+
+      if (isdigit((unsigned char)c) ||
+          ((c == '.') && isdigit((unsigned char)next))) {
+        char *end = NULL;
+        strtod(s.c_str() + i, &end);
+        size_t len = end - (s.c_str() + i);
+        tok.type = NATIVE_TOK_NUM;
+        tok.text = s.substr(i, len);
+        i       += len;
+
+        // Implicit multiplication ("2x")
+        if ((i < n) && (isalpha((unsigned char)s[i]) || (s[i] == '_'))) {
+          pos_ = toks_.size();
+          toks_.push_back(tok);
+          return fail("implicit multiplication not supported");
+        }
+        toks_.push_back(tok);
+        continue;
+      }
+
+      if (isalpha((unsigned char)c) || (c == '_')) {
+        size_t start = i;
+
+        while (i < n && (isalnum((unsigned char)s[i]) || s[i] == '_' ||
+                         s[i] == '.')) {
+          i++;
+        }
+        tok.type = NATIVE_TOK_IDENT;
+        tok.text = nativeLower(s.substr(start, i - start));
+        toks_.push_back(tok);
+        continue;
+      }
+
+      bool found = false;
+
+      for (int j = 0; ops2[j]; j++) {
+        if ((c == ops2[j][0]) && (next == ops2[j][1])) {
+          tok.type = NATIVE_TOK_OP;
+          tok.text = ops2[j];
+          i       += 2;
+          found    = true;
+          break;
+        }
+      }
+
+      if (!found && strchr(ops1, c)) {
+        tok.type = NATIVE_TOK_OP;
+        tok.text = std::string(1, c);
+        i++;
+        found = true;
+      }
+
+      if (!found) {
+        pos_ = toks_.size();
+        toks_.push_back(tok);
+        return fail(std::string("unsupported character '") + c + "'");
+      }
+      toks_.push_back(tok);
+    }
+
+    ecmcPLCNativeTok end;
+    end.type = NATIVE_TOK_END;
+    end.line = line;
+    toks_.push_back(end);
+    pos_ = 0;
+    return true;
+  }
+
+  const ecmcPLCNativeTok& peek(size_t ahead = 0) {
+    size_t i = pos_ + ahead;
+    return i < toks_.size() ? toks_[i] : toks_.back();
+  }
+
+  bool isOp(const char *op, size_t ahead = 0) {
+    const ecmcPLCNativeTok& tok = peek(ahead);
+    return tok.type == NATIVE_TOK_OP && tok.text == op;
+  }
+
+  bool isKeyword(const char *word, size_t ahead = 0) {
+    const ecmcPLCNativeTok& tok = peek(ahead);
+    return tok.type == NATIVE_TOK_IDENT && tok.text == word;
+  }
+
+  bool acceptOp(const char *op) {
+    if (isOp(op)) {
+      pos_++;
+      return true;
+    }
+    return false;
+  }
+
+  bool expectOp(const char *op) {
+    if (acceptOp(op)) {
+      return true;
+    }
+    return fail(std::string("expected '") + op + "'");
+  }
+
+  std::string indent(int level) {
+    return std::string(level * 2, ' ');
+  }
+
+  std::string declareLocal(const std::string& name) {
+    char buffer[32];
+
+    snprintf(buffer, sizeof(buffer), "l_%d", localCount_++);
+    scopes_.back()[name] = buffer;
+    return buffer;
+  }
+
+  // Statements
+
+  bool statementList(bool inBlock, std::string *out, int level) {
+    while (true) {
+      while (acceptOp(";")) {}
+
+      if (peek().type == NATIVE_TOK_END) {
+        return inBlock ? fail("expected '}'") : true;
+      }
+
+      if (inBlock && isOp("}")) {
+        return true;
+      }
+
+      if (!statement(out, level)) {
+        return false;
+      }
+    }
+  }
+
+  bool block(std::string *out, int level) {
+    std::string body;
+
+    if (!expectOp("{")) {
+      return false;
+    }
+    scopes_.push_back(std::map<std::string, std::string>());
+
+    if (!statementList(true, &body, level + 1)) {
+      return false;
+    }
+    scopes_.pop_back();
+
+    if (!expectOp("}")) {
+      return false;
+    }
+    *out += indent(level) + "{\n" + body + indent(level) + "}\n";
+    return true;
+  }
+
+  // Body of if/while/for: block or single statement
+  bool body(std::string *out, int level) {
+    if (isOp("{")) {
+      return block(out, level);
+    }
+    std::string stmt;
+    scopes_.push_back(std::map<std::string, std::string>());
+
+    if (!statement(&stmt, level + 1)) {
+      return false;
+    }
+    scopes_.pop_back();
+    *out += indent(level) + "{\n" + stmt + indent(level) + "}\n";
+    return true;
+  }
+
+  bool varDecl(std::string *out) {
+    pos_++;  // var
+
+    if (peek().type != NATIVE_TOK_IDENT) {
+      return fail("expected variable name");
+    }
+    std::string name = peek().text;
+    pos_++;
+    ecmcPLCNativeExpr init;
+    init.code = "0.0";
+
+    if (acceptOp(":=")) {
+      if (!expression(&init)) {
+        return false;
+      }
+    } else if (isOp("[")) {
+      return fail("vectors not supported");
+    }
+
+    // Declared after init so "var x := x" refers to outer x
+    *out = "double " + declareLocal(name) + " = " + init.code + ";";
+    return true;
+  }
+
+  bool ifStatement(std::string *out, int level) {
+    ecmcPLCNativeExpr cond;
+
+    pos_++;  // if
+
+    if (!expectOp("(") || !expression(&cond)) {
+      return false;
+    }
+
+    // Function form: if (cond, a, b)
+    if (acceptOp(",")) {
+      ecmcPLCNativeExpr a, b;
+
+      if (!expression(&a) || !expectOp(",") || !expression(&b) ||
+          !expectOp(")")) {
+        return false;
+      }
+      *out += indent(level) + "(void)(((" + cond.code + ") != 0) ? (" +
+              a.code + ") : (" + b.code + "));\n";
+      return true;
+    }
+
+    if (!expectOp(")")) {
+      return false;
+    }
+    std::string thenBody, elseBody;
+
+    if (!body(&thenBody, level)) {
+      return false;
+    }
+
+    if (isOp(";") && isKeyword("else", 1)) {
+      pos_++;
+    }
+    *out += indent(level) + "if ((" + cond.code + ") != 0)\n" + thenBody;
+
+    if (isKeyword("else")) {
+      pos_++;
+
+      if (isKeyword("if")) {
+        if (!ifStatement(&elseBody, level + 1)) {
+          return false;
+        }
+        elseBody = indent(level) + "{\n" + elseBody + indent(level) + "}\n";
+      } else if (!body(&elseBody, level)) {
+        return false;
+      }
+      *out += indent(level) + "else\n" + elseBody;
+    }
+    return true;
+  }
+
+  bool statement(std::string *out, int level) {
+    const ecmcPLCNativeTok& tok = peek();
+
+    if (isOp("{")) {
+      return block(out, level);
+    }
+
+    if (tok.type == NATIVE_TOK_IDENT) {
+      if (tok.text == "var") {
+        std::string decl;
+
+        if (!varDecl(&decl)) {
+          return false;
+        }
+        *out += indent(level) + decl + "\n";
+        return true;
+      }
+
+      if (tok.text == "if") {
+        return ifStatement(out, level);
+      }
+
+      if (tok.text == "while") {
+        ecmcPLCNativeExpr cond;
+        std::string loopBody;
+        pos_++;
+
+        if (!expectOp("(") || !expression(&cond) || !expectOp(")")) {
+          return false;
+        }
+        loopDepth_++;
+
+        if (!body(&loopBody, level)) {
+          return false;
+        }
+        loopDepth_--;
+        *out += indent(level) + "while ((" + cond.code + ") != 0)\n" +
+                loopBody;
+        return true;
+      }
+
+      if (tok.text == "for") {
+        ecmcPLCNativeExpr cond, inc;
+        std::string init, loopBody;
+        pos_++;
+
+        if (!expectOp("(")) {
+          return false;
+        }
+        scopes_.push_back(std::map<std::string, std::string>());
+
+        if (isKeyword("var")) {
+          if (!varDecl(&init)) {
+            return false;
+          }
+        } else if (!isOp(";")) {
+          ecmcPLCNativeExpr initExpr;
+
+          if (!expression(&initExpr)) {
+            return false;
+          }
+          init = "(void)(" + initExpr.code + ");";
+        }
+
+        if (!expectOp(";") || !expression(&cond) || !expectOp(";")) {
+          return false;
+        }
+        inc.code = "0.0";
+
+        if (!isOp(")") && !expression(&inc)) {
+          return false;
+        }
+
+        if (!expectOp(")")) {
+          return false;
+        }
+        loopDepth_++;
+
+        if (!body(&loopBody, level + 1)) {
+          return false;
+        }
+        loopDepth_--;
+        scopes_.pop_back();
+        *out += indent(level) + "{\n" + indent(level + 1) + init + "\n" +
+                indent(level + 1) + "for (; (" + cond.code + ") != 0; (void)(" +
+                inc.code + "))\n" + loopBody + indent(level) + "}\n";
+        return true;
+      }
+
+      if (tok.text == "repeat") {
+        ecmcPLCNativeExpr cond;
+        std::string loopBody;
+        pos_++;
+        scopes_.push_back(std::map<std::string, std::string>());
+        loopDepth_++;
+
+        while (!isKeyword("until")) {
+          while (acceptOp(";")) {}
+
+          if (isKeyword("until")) {
+            break;
+          }
+
+          if (peek().type == NATIVE_TOK_END) {
+            return fail("expected 'until'");
+          }
+
+          if (!statement(&loopBody, level + 1)) {
+            return false;
+          }
+        }
+        loopDepth_--;
+        scopes_.pop_back();
+        pos_++;  // until
+
+        if (!expectOp("(") || !expression(&cond) || !expectOp(")")) {
+          return false;
+        }
+        *out += indent(level) + "do {\n" + loopBody + indent(level) +
+                "} while ((" + cond.code + ") == 0);\n";
+        return true;
+      }
+
+      if ((tok.text == "break") || (tok.text == "continue")) {
+        if (loopDepth_ == 0) {
+          return fail(tok.text + " outside loop");
+        }
+
+        if (isOp("[", 1)) {
+          return fail("break with value not supported");
+        }
+        *out += indent(level) + tok.text + ";\n";
+        pos_++;
+        return true;
+      }
+
+      if ((tok.text == "switch") || (tok.text == "return") ||
+          (tok.text == "case") || (tok.text == "default")) {
+        return fail("'" + tok.text + "' not supported");
+      }
+    }
+
+    ecmcPLCNativeExpr expr;
+
+    if (!expression(&expr)) {
+      return false;
+    }
+    *out += indent(level) + "(void)(" + expr.code + ");\n";
+    return true;
+  }
+
+  // Expressions (lowest to highest precedence)
+
+  bool expression(ecmcPLCNativeExpr *out) {
+    ecmcPLCNativeExpr lhs;
+
+    if (!ternary(&lhs)) {
+      return false;
+    }
+    static const char *assignOps[] = { ":=", "+=", "-=", "*=", "/=", "%=",
+                                       NULL };
+
+    for (int i = 0; assignOps[i]; i++) {
+      if (!isOp(assignOps[i])) {
+        continue;
+      }
+
+      if (!lhs.lvalue) {
+        return fail("assignment to non variable");
+      }
+      pos_++;
+      ecmcPLCNativeExpr rhs;
+
+      if (!expression(&rhs)) {
+        return false;
+      }
+
+      if (i == 0) {
+        out->code = "(" + lhs.code + " = (" + rhs.code + "))";
+      } else if (i == 5) {
+        out->code = "(" + lhs.code + " = std::fmod(" + lhs.code + ", (" +
+                    rhs.code + ")))";
+      } else {
+        out->code = "(" + lhs.code + " " + assignOps[i] + " (" + rhs.code +
+                    "))";
+      }
+      out->lvalue = false;
+      return true;
+    }
+    *out = lhs;
+    return true;
+  }
+
+  bool ternary(ecmcPLCNativeExpr *out) {
+    if (!logicOr(out)) {
+      return false;
+    }
+
+    if (acceptOp("?")) {
+      ecmcPLCNativeExpr a, b;
+
+      if (!expression(&a) || !expectOp(":") || !ternary(&b)) {
+        return false;
+      }
+      out->code = "(((" + out->code + ") != 0) ? (" + a.code + ") : (" +
+                  b.code + "))";
+      out->lvalue = false;
+    }
+    return true;
+  }
+
+  bool logicOr(ecmcPLCNativeExpr *out) {
+    if (!logicAnd(out)) {
+      return false;
+    }
+
+    while (true) {
+      std::string func;
+      bool shortCircuit = false;
+
+      // exprtk: "|" short circuits, "or" evaluates both
+      if (isKeyword("or")) {
+        func = "n_or";
+      } else if (isKeyword("nor")) {
+        func = "n_nor";
+      } else if (isKeyword("xor")) {
+        func = "n_xor";
+      } else if (isKeyword("xnor")) {
+        func = "n_xnor";
+      } else if (isOp("||") || isOp("|")) {
+        shortCircuit = true;
+      } else {
+        return true;
+      }
+      pos_++;
+      ecmcPLCNativeExpr rhs;
+
+      if (!logicAnd(&rhs)) {
+        return false;
+      }
+
+      if (shortCircuit) {
+        out->code = "n_b(((" + out->code + ") != 0) || ((" + rhs.code +
+                    ") != 0))";
+      } else {
+        out->code = func + "(" + out->code + ", " + rhs.code + ")";
+      }
+      out->lvalue = false;
+    }
+  }
+
+  bool logicAnd(ecmcPLCNativeExpr *out) {
+    if (!compare(out)) {
+      return false;
+    }
+
+    while (true) {
+      std::string func;
+      bool shortCircuit = false;
+
+      // exprtk: "&" short circuits, "and" evaluates both
+      if (isKeyword("and")) {
+        func = "n_and";
+      } else if (isKeyword("nand")) {
+        func = "n_nand";
+      } else if (isOp("&&") || isOp("&")) {
+        shortCircuit = true;
+      } else {
+        return true;
+      }
+      pos_++;
+      ecmcPLCNativeExpr rhs;
+
+      if (!compare(&rhs)) {
+        return false;
+      }
+
+      if (shortCircuit) {
+        out->code = "n_b(((" + out->code + ") != 0) && ((" + rhs.code +
+                    ") != 0))";
+      } else {
+        out->code = func + "(" + out->code + ", " + rhs.code + ")";
+      }
+      out->lvalue = false;
+    }
+  }
+
+  bool compare(ecmcPLCNativeExpr *out) {
+    if (!additive(out)) {
+      return false;
+    }
+
+    while (true) {
+      const ecmcPLCNativeTok& tok = peek();
+      std::string op;
+
+      if (tok.type != NATIVE_TOK_OP) {
+        return true;
+      }
+
+      if ((tok.text == "<") || (tok.text == "<=") || (tok.text == ">") ||
+          (tok.text == ">=") || (tok.text == "==") || (tok.text == "!=")) {
+        op = tok.text;
+      } else if (tok.text == "=") {
+        op = "==";
+      } else if (tok.text == "<>") {
+        op = "!=";
+      } else {
+        return true;
+      }
+      pos_++;
+      ecmcPLCNativeExpr rhs;
+
+      if (!additive(&rhs)) {
+        return false;
+      }
+      out->code   = "n_b((" + out->code + ") " + op + " (" + rhs.code + "))";
+      out->lvalue = false;
+    }
+  }
+
+  bool additive(ecmcPLCNativeExpr *out) {
+    if (!multiplicative(out)) {
+      return false;
+    }
+
+    while (isOp("+") || isOp("-")) {
+      std::string op = peek().text;
+      pos_++;
+      ecmcPLCNativeExpr rhs;
+
+      if (!multiplicative(&rhs)) {
+        return false;
+      }
+      out->code   = "(" + out->code + " " + op + " " + rhs.code + ")";
+      out->lvalue = false;
+    }
+    return true;
+  }
+
+  bool multiplicative(ecmcPLCNativeExpr *out) {
+    if (!unary(out)) {
+      return false;
+    }
+
+    while (isOp("*") || isOp("/") || isOp("%")) {
+      std::string op = peek().text;
+      pos_++;
+      ecmcPLCNativeExpr rhs;
+
+      if (!unary(&rhs)) {
+        return false;
+      }
+
+      if (op == "%") {
+        out->code = "std::fmod(" + out->code + ", " + rhs.code + ")";
+      } else {
+        out->code = "(" + out->code + " " + op + " " + rhs.code + ")";
+      }
+      out->lvalue = false;
+    }
+    return true;
+  }
+
+  bool unary(ecmcPLCNativeExpr *out) {
+    if (acceptOp("-")) {
+      if (!unary(out)) {
+        return false;
+      }
+      out->code   = "(-" + out->code + ")";
+      out->lvalue = false;
+      return true;
+    }
+
+    if (acceptOp("+")) {
+      if (!unary(out)) {
+        return false;
+      }
+      out->lvalue = false;
+      return true;
+    }
+
+    if (isOp("!") || isKeyword("not")) {
+      pos_++;
+
+      if (!unary(out)) {
+        return false;
+      }
+      out->code   = "n_b((" + out->code + ") == 0)";
+      out->lvalue = false;
+      return true;
+    }
+    return power(out);
+  }
+
+  bool powerOperand(ecmcPLCNativeExpr *out) {
+    if (acceptOp("-")) {
+      if (!powerOperand(out)) {
+        return false;
+      }
+      out->code = "(-" + out->code + ")";
+      return true;
+    }
+    acceptOp("+");
+    return primary(out);
+  }
+
+  bool power(ecmcPLCNativeExpr *out) {
+    if (!primary(out)) {
+      return false;
+    }
+
+    while (acceptOp("^")) {
+      ecmcPLCNativeExpr rhs;
+
+      if (!powerOperand(&rhs)) {
+        return false;
+      }
+      out->code   = "std::pow(" + out->code + ", " + rhs.code + ")";
+      out->lvalue = false;
+    }
+    return true;
+  }
+
+  bool arguments(std::vector<std::string> *args) {
+    if (!expectOp("(")) {
+      return false;
+    }
+
+    if (acceptOp(")")) {
+      return true;
+    }
+
+    while (true) {
+      ecmcPLCNativeExpr arg;
+
+      if (!expression(&arg)) {
+        return false;
+      }
+      args->push_back(arg.code);
+
+      if (acceptOp(")")) {
+        return true;
+      }
+
+      if (!expectOp(",")) {
+        return false;
+      }
+    }
+  }
+
+  bool call(const std::string& name, ecmcPLCNativeExpr *out) {
+    std::vector<std::string> args;
+
+    if (!arguments(&args)) {
+      return false;
+    }
+    out->lvalue = false;
+
+    // Functions of mc/ec/ds/misc/plugin libs
+    std::map<std::string, int>::iterator func = funcs_.find(name);
+
+    if (func != funcs_.end()) {
+      int argCount = funcArgCount_[func->second];
+
+      if ((int)args.size() != argCount) {
+        return fail("wrong argument count in call to " + name);
+      }
+      char buffer[64];
+      snprintf(buffer, sizeof(buffer), "((n_f%d)f[%d])(", argCount,
+               func->second);
+      out->code       = buffer;
+      callsFunctions_ = true;
+
+      for (size_t i = 0; i < args.size(); i++) {
+        out->code += (i ? ", " : "") + args[i];
+      }
+      out->code += ")";
+      return true;
+    }
+
+    for (int i = 0; nativeBuiltins[i].name; i++) {
+      const ecmcPLCNativeBuiltin& builtin = nativeBuiltins[i];
+
+      if (name != builtin.name) {
+        continue;
+      }
+
+      if (builtin.argCount < 0) {
+        if (args.empty()) {
+          return fail("no arguments in call to " + name);
+        }
+        out->code = args[0];
+
+        for (size_t j = 1; j < args.size(); j++) {
+          out->code = std::string(builtin.cName) + "(" + out->code + ", " +
+                      args[j] + ")";
+        }
+        return true;
+      }
+
+      if ((int)args.size() != builtin.argCount) {
+        return fail("wrong argument count in call to " + name);
+      }
+      out->code = std::string(builtin.cName) + "(";
+
+      for (size_t j = 0; j < args.size(); j++) {
+        out->code += (j ? ", " : "") + args[j];
+      }
+      out->code += ")";
+      return true;
+    }
+
+    // sum, avg, mul
+    if ((name == "sum") || (name == "avg") || (name == "mul")) {
+      if (args.empty()) {
+        return fail("no arguments in call to " + name);
+      }
+      const char *op = name == "mul" ? " * " : " + ";
+      out->code = "(" + args[0];
+
+      for (size_t j = 1; j < args.size(); j++) {
+        out->code += op + args[j];
+      }
+      out->code += ")";
+
+      if (name == "avg") {
+        out->code = "(" + out->code + " / " +
+                    nativeNumber((double)args.size()) + ")";
+      }
+      return true;
+    }
+    return fail("function " + name + " not available natively");
+  }
+
+  bool primary(ecmcPLCNativeExpr *out) {
+    const ecmcPLCNativeTok tok = peek();
+
+    out->lvalue = false;
+
+    if (tok.type == NATIVE_TOK_NUM) {
+      pos_++;
+      out->code = nativeNumber(strtod(tok.text.c_str(), NULL));
+      return true;
+    }
+
+    if (acceptOp("(")) {
+      if (!expression(out) || !expectOp(")")) {
+        return false;
+      }
+      out->code   = "(" + out->code + ")";
+      out->lvalue = false;
+      return true;
+    }
+
+    if (tok.type != NATIVE_TOK_IDENT) {
+      return fail("unexpected '" + tok.text + "'");
+    }
+    pos_++;
+
+    if ((tok.text == "true") || (tok.text == "false")) {
+      out->code = tok.text == "true" ? "1.0" : "0.0";
+      return true;
+    }
+
+    if (tok.text == "if") {
+      ecmcPLCNativeExpr cond, a, b;
+
+      if (!expectOp("(") || !expression(&cond) || !expectOp(",") ||
+          !expression(&a) || !expectOp(",") || !expression(&b) ||
+          !expectOp(")")) {
+        return false;
+      }
+      out->code = "(((" + cond.code + ") != 0) ? (" + a.code + ") : (" +
+                  b.code + "))";
+      return true;
+    }
+
+    if (isOp("(")) {
+      return call(tok.text, out);
+    }
+
+    // Local "var" (inner scope first)
+    for (size_t i = scopes_.size(); i > 0; i--) {
+      std::map<std::string, std::string>::iterator local =
+        scopes_[i - 1].find(tok.text);
+
+      if (local != scopes_[i - 1].end()) {
+        out->code   = local->second;
+        out->lvalue = true;
+        return true;
+      }
+    }
+
+    // Bound ecmc variable
+    std::map<std::string, int>::iterator var = vars_.find(tok.text);
+
+    if (var != vars_.end()) {
+      char buffer[32];
+      snprintf(buffer, sizeof(buffer), "(*v[%d])", var->second);
+      out->code   = buffer;
+      out->lvalue = true;
+      return true;
+    }
+
+    std::map<std::string, double>::iterator cnst = consts_.find(tok.text);
+
+    if (cnst != consts_.end()) {
+      out->code = nativeNumber(cnst->second);
+      return true;
+    }
+
+    if (tok.text == "pi") {
+      out->code = "3.14159265358979323846";
+      return true;
+    }
+
+    if (tok.text == "epsilon") {
+      out->code = "1e-10";
+      return true;
+    }
+
+    if (tok.text == "inf") {
+      out->code = "HUGE_VAL";
+      return true;
+    }
+    return fail("symbol " + tok.text + " not available natively");
+  }
+
+  std::vector<ecmcPLCNativeTok> toks_;
+  size_t pos_;
+  std::string error_;
+  std::vector<std::map<std::string, std::string> > scopes_;
+  int localCount_;
+  int loopDepth_;
+};
+
+static inline int64_t nativeTimeNs() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+ecmcPLCNative::ecmcPLCNative(int plcIndex) {
+  errorReset();
+  plcIndex_           = plcIndex;
+  dlHandle_           = NULL;
+  func_               = NULL;
+  buildTimeMs_        = 0;
+  verifyCount_        = 0;
+  mismatchCount_      = 0;
+  lastMismatchVar_    = -1;
+  lastMismatchExprtk_ = 0;
+  lastMismatchNative_ = 0;
+  callsFunctions_     = false;
+}
+
+ecmcPLCNative::~ecmcPLCNative() {
+  unload();
+}
+
+int ecmcPLCNative::addFunctionPtr(const char *name,
+                                  void       *func,
+                                  int         argCount) {
+  if (!name || !func) {
+    return 0;
+  }
+  funcNames_.push_back(nativeLower(name));
+  funcs_.push_back(func);
+  funcArgCount_.push_back(argCount);
+  return 0;
+}
+
+int ecmcPLCNative::addConstant(const char *name, double value) {
+  if (!name) {
+    return 0;
+  }
+  constNames_.push_back(nativeLower(name));
+  constValues_.push_back(value);
+  return 0;
+}
+
+int ecmcPLCNative::addVariable(const char *name, double *data) {
+  if (!name || !data) {
+    return 0;
+  }
+  varNames_.push_back(name);
+  vars_.push_back(data);
+  return 0;
+}
+
+void ecmcPLCNative::clearVariables() {
+  // Variables are bound in the loaded code
+  unload();
+  varNames_.clear();
+  vars_.clear();
+}
+
+bool ecmcPLCNative::getLoaded() {
+  return func_ != NULL;
+}
+
+bool ecmcPLCNative::getCallsFunctions() {
+  return callsFunctions_;
+}
+
+int ecmcPLCNative::build(const std::string& expr, bool verify) {
+  int64_t start = nativeTimeNs();
+
+  unload();
+  errorReset();
+  buildError_      = "";
+  verifyCount_     = 0;
+  mismatchCount_   = 0;
+  lastMismatchVar_ = -1;
+  ecmcPLCNativeTranslator translator;
+
+  for (size_t i = 0; i < varNames_.size(); i++) {
+    translator.vars_[nativeLower(varNames_[i])] = (int)i;
+  }
+
+  for (size_t i = 0; i < funcNames_.size(); i++) {
+    translator.funcs_[funcNames_[i]] = (int)i;
+  }
+  translator.funcArgCount_ = funcArgCount_;
+
+  for (size_t i = 0; i < constNames_.size(); i++) {
+    translator.consts_[constNames_[i]] = constValues_[i];
+  }
+
+  std::string body;
+
+  bool translated = translator.translate(expr, &body);
+
+  callsFunctions_ = translator.callsFunctions_;
+
+  // Verify would execute the functions (mc_*, ec_*..) twice
+  if (translated && verify && callsFunctions_) {
+    buildError_ = "verify not possible, code calls functions";
+    LOGERR("%s/%s:%d: PLC%d: Native %s (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           buildError_.c_str(),
+           ERROR_PLC_NATIVE_VERIFY_FUNCS);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLC_NATIVE_VERIFY_FUNCS);
+  }
+
+  if (!translated) {
+    buildError_ = translator.getError();
+    LOGERR("%s/%s:%d: PLC%d: Translation to native code failed: %s (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           buildError_.c_str(),
+           ERROR_PLC_NATIVE_TRANSLATE_FAIL);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLC_NATIVE_TRANSLATE_FAIL);
+  }
+
+  char header[128];
+  snprintf(header, sizeof(header),
+           "// PLC %d, generated by ecmc from the PLC code (do not edit)\n",
+           plcIndex_);
+
+  std::string code = std::string(header) + nativePrelude +
+                     "extern \"C\" void " ECMC_PLC_NATIVE_ENTRY
+                     "(double *const *v, void *const *f) {\n"
+                     "  (void)v;\n  (void)f;\n" + body + "}\n";
+
+  int errorCode = compileAndLoad(code);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
+  before_.assign(vars_.size(), 0);
+  result_.assign(vars_.size(), 0);
+  buildTimeMs_ = (nativeTimeNs() - start) / 1e6;
+  return 0;
+}
+
+// Unique file (O_EXCL) in dir, name not predictable
+static int nativeTempFile(const char *dir, int plcIndex, const char *suffix,
+                          std::string *fileName) {
+  char name[512];
+
+  snprintf(name, sizeof(name), "%s/ecmcPLC%d_XXXXXX%s", dir, plcIndex,
+           suffix);
+  int fd = mkstemps(name, (int)strlen(suffix));
+
+  if (fd >= 0) {
+    *fileName = name;
+  }
+  return fd;
+}
+
+int ecmcPLCNative::compileAndLoad(const std::string& code) {
+  const char *cxx      = getenv("ECMC_PLC_NATIVE_CXX");
+  const char *cxxFlags = getenv("ECMC_PLC_NATIVE_CXXFLAGS");
+  const char *dir      = getenv("ECMC_PLC_NATIVE_DIR");
+
+  if (!cxx || (strlen(cxx) == 0)) {
+    cxx = ECMC_PLC_NATIVE_DEFAULT_CXX;
+  }
+
+  if (!cxxFlags) {
+    cxxFlags = ECMC_PLC_NATIVE_DEFAULT_CXXFLAGS;
+  }
+
+  if (!dir || (strlen(dir) == 0)) {
+    dir = ECMC_PLC_NATIVE_DEFAULT_DIR;
+  }
+
+  // Executed directly (no shell, no search path)
+  if (cxx[0] != '/') {
+    buildError_ = std::string("compiler must be an absolute path: ") + cxx;
+    LOGERR("%s/%s:%d: PLC%d: Native %s (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           buildError_.c_str(),
+           ERROR_PLC_NATIVE_COMPILE_FAIL);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLC_NATIVE_COMPILE_FAIL);
+  }
+
+  // Unique names (dlopen() of an already loaded file name returns old lib)
+  std::string logFileName;
+  int srcFd = nativeTempFile(dir, plcIndex_, ".cpp", &srcFileName_);
+  int libFd = nativeTempFile(dir, plcIndex_, ".so", &libFileName_);
+  int logFd = nativeTempFile(dir, plcIndex_, ".log", &logFileName);
+  FILE *file = srcFd >= 0 ? fdopen(srcFd, "w") : NULL;
+
+  if (libFd >= 0) {
+    close(libFd);
+  }
+
+  if (!file || (fputs(code.c_str(), file) < 0) || (logFd < 0)) {
+    if (file) {
+      fclose(file);
+    } else if (srcFd >= 0) {
+      close(srcFd);
+    }
+
+    if (logFd >= 0) {
+      close(logFd);
+    }
+    buildError_ = std::string("failed to create files in ") + dir;
+    LOGERR("%s/%s:%d: PLC%d: %s (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           buildError_.c_str(),
+           ERROR_PLC_NATIVE_COMPILE_FAIL);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLC_NATIVE_COMPILE_FAIL);
+  }
+  fclose(file);
+
+  // argv: compiler, flags (split at white space), fixed args
+  std::vector<std::string> args;
+  std::string flags(cxxFlags);
+  size_t pos = 0;
+
+  args.push_back(cxx);
+
+  while ((pos = flags.find_first_not_of(" \t", pos)) != std::string::npos) {
+    size_t end = flags.find_first_of(" \t", pos);
+    args.push_back(flags.substr(pos, end - pos));
+    pos = end;
+  }
+  args.push_back("-shared");
+  args.push_back("-fPIC");
+  args.push_back("-o");
+  args.push_back(libFileName_);
+  args.push_back(srcFileName_);
+
+  std::vector<char *> argv;
+
+  for (size_t i = 0; i < args.size(); i++) {
+    argv.push_back(&args[i][0]);
+  }
+  argv.push_back(NULL);
+
+  posix_spawn_file_actions_t actions;
+  pid_t pid    = 0;
+  int   status = -1;
+
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, logFd, STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, logFd, STDERR_FILENO);
+
+  if ((posix_spawn(&pid, cxx, &actions, NULL, argv.data(), environ) != 0) ||
+      (waitpid(pid, &status, 0) != pid)) {
+    status = -1;
+  }
+  posix_spawn_file_actions_destroy(&actions);
+  close(logFd);
+
+  if ((status == -1) || !WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+    buildError_ = "compile failed (see " + logFileName + ")";
+    LOGERR("%s/%s:%d: PLC%d: Native %s (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           buildError_.c_str(),
+           ERROR_PLC_NATIVE_COMPILE_FAIL);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLC_NATIVE_COMPILE_FAIL);
+  }
+  remove(logFileName.c_str());
+
+  dlHandle_ = dlopen(libFileName_.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+  if (dlHandle_) {
+    func_ = (ecmcPLCNativeFunc)dlsym(dlHandle_, ECMC_PLC_NATIVE_ENTRY);
+  }
+
+  if (!func_) {
+    const char *dlError = dlerror();
+    buildError_ = std::string("load failed: ") + (dlError ? dlError : "");
+    LOGERR("%s/%s:%d: PLC%d: Native %s (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           buildError_.c_str(),
+           ERROR_PLC_NATIVE_LOAD_FAIL);
+    unload();
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLC_NATIVE_LOAD_FAIL);
+  }
+  return 0;
+}
+
+void ecmcPLCNative::unload() {
+  // Generated files are kept for inspection if the build failed
+  if (func_) {
+    remove(srcFileName_.c_str());
+    remove(libFileName_.c_str());
+  }
+  func_ = NULL;
+
+  if (dlHandle_) {
+    dlclose(dlHandle_);
+    dlHandle_ = NULL;
+  }
+}
+
+void ecmcPLCNative::verifyBegin() {
+  const size_t count = vars_.size();
+
+  for (size_t i = 0; i < count; i++) {
+    before_[i] = *vars_[i];
+  }
+}
+
+void ecmcPLCNative::verifyEnd() {
+  const size_t count = vars_.size();
+
+  for (size_t i = 0; i < count; i++) {
+    result_[i] = *vars_[i];
+    *vars_[i]  = before_[i];
+  }
+
+  run();
+
+  bool mismatch = false;
+
+  for (size_t i = 0; i < count; i++) {
+    double exprtkValue = result_[i];
+    double nativeValue = *vars_[i];
+    double diff        = fabs(exprtkValue - nativeValue);
+    double scale       = fmax(1.0, fmax(fabs(exprtkValue), fabs(nativeValue)));
+    bool   bothNan     = isnan(exprtkValue) && isnan(nativeValue);
+
+    if (!bothNan && !(diff <= ECMC_PLC_NATIVE_VERIFY_TOL * scale)) {
+      if (!mismatch) {
+        lastMismatchVar_    = (int)i;
+        lastMismatchExprtk_ = exprtkValue;
+        lastMismatchNative_ = nativeValue;
+      }
+      mismatch = true;
+    }
+
+    // exprtk result is used
+    *vars_[i] = exprtkValue;
+  }
+
+  verifyCount_++;
+
+  if (mismatch) {
+    mismatchCount_++;
+
+    if (mismatchCount_ == 1) {
+      LOGERR("%s/%s:%d: WARNING: PLC%d: Native code differs from exprtk: "
+             "%s=%lf (exprtk %lf).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             plcIndex_,
+             varNames_[lastMismatchVar_].c_str(),
+             lastMismatchNative_,
+             lastMismatchExprtk_);
+    }
+  }
+}
+
+void ecmcPLCNative::print(int mode) {
+  static const char *modeNames[] = { "exprtk", "native", "verify" };
+  const char *modeName           = (mode >= ECMC_PLC_NATIVE_OFF &&
+                                    mode <= ECMC_PLC_NATIVE_VERIFY) ?
+                                   modeNames[mode] : "?";
+  std::string info;
+
+  if (!getLoaded()) {
+    info = buildError_;
+  } else if (lastMismatchVar_ >= 0) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "=%lf (exprtk %lf)",
+             lastMismatchNative_, lastMismatchExprtk_);
+    info = varNames_[lastMismatchVar_] + buffer;
+  } else {
+    info = libFileName_;
+  }
+
+  printf("  %-4d %-7s %-7s %-10.1f %-12" PRIu64 " %-12" PRIu64 " %s\n",
+         plcIndex_,
+         modeName,
+         getLoaded() ? "yes" : "no",
+         buildTimeMs_,
+         verifyCount_,
+         mismatchCount_,
+         info.c_str());
+}
@@ -0,0 +1,139 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcPLCNative.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Optional native backend of a PLC. The (exprtk validated) PLC code is
+* translated to C++, compiled with the system compiler and loaded with
+* dlopen(). Bound variables are accessed by pointer and functions of the
+* mc, ec, ds, misc and plugin libs are called by function pointer.
+* Only a subset of the exprtk syntax is translated (statements, var,
+* if/else, while, for, repeat/until, arithmetic, logic and math functions),
+* for other code (strings, vectors, fileIO, PLC lib functions..) the PLC
+* falls back to exprtk.
+*
+* Environment variables:
+*  ECMC_PLC_NATIVE_CXX       Compiler, absolute path (default "/usr/bin/c++")
+*  ECMC_PLC_NATIVE_CXXFLAGS  Compiler flags (default "-O2")
+*  ECMC_PLC_NATIVE_DIR       Dir for generated source and lib (default "/tmp")
+*
+* The compiler is executed directly (posix_spawn(), no shell) and the
+* generated files get unique names (mkstemps()).
+*
+\*************************************************************************/
+
+#ifndef ECMC_PLC_NATIVE_H_
+#define ECMC_PLC_NATIVE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ecmcError.h"
+
+#define ERROR_PLC_NATIVE_TRANSLATE_FAIL 0x20514
+#define ERROR_PLC_NATIVE_COMPILE_FAIL 0x20515
+#define ERROR_PLC_NATIVE_LOAD_FAIL 0x20516
+#define ERROR_PLC_NATIVE_MODE_INVALID 0x20517
+#define ERROR_PLC_NATIVE_VERIFY_FUNCS 0x20518
+
+// Execution mode of a PLC
+#define ECMC_PLC_NATIVE_OFF 0     // exprtk
+#define ECMC_PLC_NATIVE_RUN 1     // native code (exprtk if build failed)
+#define ECMC_PLC_NATIVE_VERIFY 2  // run both, compare, exprtk result is used
+                                  // (not for code calling functions)
+
+#define ECMC_PLC_NATIVE_MAX_FUNC_ARGS 10
+#define ECMC_PLC_NATIVE_DEFAULT_CXX "/usr/bin/c++"
+#define ECMC_PLC_NATIVE_DEFAULT_CXXFLAGS "-O2"
+#define ECMC_PLC_NATIVE_DEFAULT_DIR "/tmp"
+#define ECMC_PLC_NATIVE_ENTRY "ecmcPLCNativeRun"
+
+// Relative tolerance in verify mode
+#define ECMC_PLC_NATIVE_VERIFY_TOL 1e-9
+
+typedef void (*ecmcPLCNativeFunc)(double *const *vars,
+                                  void *const   *funcs);
+
+class ecmcPLCNative : public ecmcError {
+public:
+  explicit ecmcPLCNative(int plcIndex);
+  ~ecmcPLCNative();
+
+  // Functions with double args only (others are not available natively)
+  template<typename ... Args>
+  int addFunction(const char *name,
+                  double (*func)(Args...)) {
+    if (sizeof ... (Args) > ECMC_PLC_NATIVE_MAX_FUNC_ARGS) {
+      return 0;
+    }
+    return addFunctionPtr(name, (void *)func, sizeof ... (Args));
+  }
+
+  template<typename T>
+  int addFunction(const char *,
+                  T) {
+    return 0;
+  }
+
+  int         addConstant(const char *name,
+                          double      value);
+  int         addVariable(const char *name,
+                          double     *data);
+  void        clearVariables();
+
+  // Translate, compile and load (config time, not rt). Fails for verify
+  // if the code calls functions (would be executed twice)
+  int         build(const std::string& expr,
+                    bool               verify);
+  bool        getLoaded();
+  bool        getCallsFunctions();
+
+  // Rt
+  inline void run() {
+    func_(vars_.data(), funcs_.data());
+  }
+
+  // Verify mode: verifyBegin() + exprtk refresh + verifyEnd()
+  void        verifyBegin();
+  void        verifyEnd();
+  void        print(int mode);
+
+private:
+  int         addFunctionPtr(const char *name,
+                             void       *func,
+                             int         argCount);
+  int         compileAndLoad(const std::string& code);
+  void        unload();
+
+  int plcIndex_;
+  std::vector<std::string> varNames_;
+  std::vector<double *> vars_;
+  std::vector<std::string> funcNames_;
+  std::vector<void *> funcs_;
+  std::vector<int> funcArgCount_;
+  std::vector<std::string> constNames_;
+  std::vector<double> constValues_;
+  void *dlHandle_;
+  ecmcPLCNativeFunc func_;
+  std::string srcFileName_;
+  std::string libFileName_;
+  std::string buildError_;
+  double buildTimeMs_;
+  bool callsFunctions_;
+
+  // Verify
+  std::vector<double> before_;
+  std::vector<double> result_;
+  uint64_t verifyCount_;
+  uint64_t mismatchCount_;
+  int lastMismatchVar_;
+  double lastMismatchExprtk_;
+  double lastMismatchNative_;
+};
+
+#endif  /* ECMC_PLC_NATIVE_H_ */
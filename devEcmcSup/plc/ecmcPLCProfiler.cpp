@@ -0,0 +1,348 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcPLCProfiler.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+\*************************************************************************/
+
+#include "ecmcPLCProfiler.h"
+#include <time.h>
+#include <limits.h>
+#include <inttypes.h>
+#include "ecmcDefinitions.h"
+
+static inline int64_t profTimeNs() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline int32_t profDiffNs(int64_t start, int64_t end) {
+  int64_t diff = end - start;
+
+  return diff > INT_MAX ? INT_MAX : (int32_t)diff;
+}
+
+ecmcPLCProfiler::ecmcPLCProfiler(int                 plcIndex,
+                                 int                 skipCycles,
+                                 ecmcAsynPortDriver *asynPortDriver) {
+  errorReset();
+  plcIndex_            = plcIndex;
+  asynPortDriver_      = asynPortDriver;
+  startNs_             = 0;
+  readDoneNs_          = 0;
+  evalDoneNs_          = 0;
+  exeNs_               = 0;
+  exeMinNs_            = INT_MAX;
+  exeMaxNs_            = 0;
+  readNs_              = 0;
+  readMaxNs_           = 0;
+  evalNs_              = 0;
+  evalMaxNs_           = 0;
+  writeNs_             = 0;
+  writeMaxNs_          = 0;
+  overruns_            = 0;
+  warning_             = 0;
+  skipCycles_          = skipCycles;
+  exeCount_            = 0;
+  exeMinTotNs_         = INT_MAX;
+  exeMaxTotNs_         = 0;
+  budgetNs_            = 0;
+  consecutiveOverruns_ = 0;
+  demoteOverrunLimit_  = 0;
+  demoteSkipCycles_    = 0;
+  demoted_             = false;
+
+  for (int i = 0; i < ECMC_PLC_PROF_HIST_BINS; i++) {
+    hist_[i] = 0;
+  }
+
+  for (int i = 0; i < ECMC_PLC_PROF_PAR_COUNT; i++) {
+    params_[i] = NULL;
+  }
+
+  int errorCode = initAsyn();
+
+  if (errorCode) {
+    setErrorID(__FILE__, __FUNCTION__, __LINE__, errorCode);
+  }
+}
+
+ecmcPLCProfiler::~ecmcPLCProfiler() {}
+
+void ecmcPLCProfiler::start() {
+  startNs_ = profTimeNs();
+}
+
+void ecmcPLCProfiler::readDone() {
+  readDoneNs_ = profTimeNs();
+}
+
+void ecmcPLCProfiler::evalDone() {
+  evalDoneNs_ = profTimeNs();
+}
+
+int ecmcPLCProfiler::done(int skipCycles) {
+  int64_t doneNs = profTimeNs();
+
+  readNs_  = profDiffNs(startNs_, readDoneNs_);
+  evalNs_  = profDiffNs(readDoneNs_, evalDoneNs_);
+  writeNs_ = profDiffNs(evalDoneNs_, doneNs);
+  exeNs_   = profDiffNs(startNs_, doneNs);
+  exeCount_++;
+
+  if (exeNs_ < exeMinNs_) exeMinNs_ = exeNs_;
+
+  if (exeNs_ > exeMaxNs_) exeMaxNs_ = exeNs_;
+
+  if (readNs_ > readMaxNs_) readMaxNs_ = readNs_;
+
+  if (evalNs_ > evalMaxNs_) evalMaxNs_ = evalNs_;
+
+  if (writeNs_ > writeMaxNs_) writeMaxNs_ = writeNs_;
+
+  if (exeNs_ < exeMinTotNs_) exeMinTotNs_ = exeNs_;
+
+  if (exeNs_ > exeMaxTotNs_) exeMaxTotNs_ = exeNs_;
+
+  // Histogram bin: log2 of micro seconds
+  int32_t us  = exeNs_ / 1000;
+  int     bin = 0;
+
+  while (us && (bin < ECMC_PLC_PROF_HIST_BINS - 1)) {
+    us >>= 1;
+    bin++;
+  }
+  hist_[bin]++;
+
+  skipCycles_ = skipCycles;
+
+  if (budgetNs_ <= 0) {
+    return skipCycles;
+  }
+
+  if (exeNs_ <= budgetNs_) {
+    consecutiveOverruns_ = 0;
+    warning_             = 0;
+    return skipCycles;
+  }
+
+  overruns_++;
+  consecutiveOverruns_++;
+
+  if (!warning_) {
+    LOGERR(
+      "%s/%s:%d: WARNING: PLC%d execution time %dus exceeds budget %dus (overrun %d).\n",
+      __FILE__,
+      __FUNCTION__,
+      __LINE__,
+      plcIndex_,
+      exeNs_ / 1000,
+      budgetNs_ / 1000,
+      overruns_);
+  }
+  warning_ = 1;
+
+  if (demoted_ || (demoteOverrunLimit_ <= 0) ||
+      (consecutiveOverruns_ < demoteOverrunLimit_) ||
+      (demoteSkipCycles_ <= skipCycles)) {
+    return skipCycles;
+  }
+
+  demoted_    = true;
+  skipCycles_ = demoteSkipCycles_;
+  LOGERR(
+    "%s/%s:%d: WARNING: PLC%d demoted to skip cycles %d after %d consecutive overruns.\n",
+    __FILE__,
+    __FUNCTION__,
+    __LINE__,
+    plcIndex_,
+    demoteSkipCycles_,
+    consecutiveOverruns_);
+  return skipCycles_;
+}
+
+void ecmcPLCProfiler::resetPar(int parId) {
+  switch (parId) {
+  case ECMC_PLC_PROF_PAR_EXE_MIN:
+    exeMinNs_ = INT_MAX;
+    break;
+
+  case ECMC_PLC_PROF_PAR_EXE_MAX:
+    exeMaxNs_ = 0;
+    break;
+
+  case ECMC_PLC_PROF_PAR_READ_MAX:
+    readMaxNs_ = 0;
+    break;
+
+  case ECMC_PLC_PROF_PAR_EVAL_MAX:
+    evalMaxNs_ = 0;
+    break;
+
+  case ECMC_PLC_PROF_PAR_WRITE_MAX:
+    writeMaxNs_ = 0;
+    break;
+
+  default:
+    break;
+  }
+}
+
+void ecmcPLCProfiler::updateAsyn(int force) {
+  for (int i = 0; i < ECMC_PLC_PROF_PAR_COUNT; i++) {
+    if (params_[i] && (params_[i]->refreshParamRT(force) == 0)) {
+      // Min/max reset after successful write
+      resetPar(i);
+    }
+  }
+}
+
+int ecmcPLCProfiler::setBudget(double budgetUs) {
+  if ((budgetUs < 0) || (budgetUs * 1000 > INT_MAX)) {
+    LOGERR("%s/%s:%d: ERROR: PLC%d invalid time budget %lfus (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           budgetUs,
+           ERROR_PLC_PROFILER_BUDGET_INVALID);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLC_PROFILER_BUDGET_INVALID);
+  }
+
+  consecutiveOverruns_ = 0;
+  warning_             = 0;
+  budgetNs_            = (int32_t)(budgetUs * 1000);
+  return 0;
+}
+
+int ecmcPLCProfiler::setDemotion(int overrunLimit, int skipCycles) {
+  if ((overrunLimit < 0) || (skipCycles < 0)) {
+    LOGERR("%s/%s:%d: ERROR: PLC%d invalid demotion (%d,%d) (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           overrunLimit,
+           skipCycles,
+           ERROR_PLC_PROFILER_DEMOTION_INVALID);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLC_PROFILER_DEMOTION_INVALID);
+  }
+
+  consecutiveOverruns_ = 0;
+  demoteOverrunLimit_  = overrunLimit;
+  demoteSkipCycles_    = skipCycles;
+  demoted_             = false;
+  return 0;
+}
+
+void ecmcPLCProfiler::print() {
+  printf("  %-6d %-10" PRIu64 " %-9.1f %-9.1f %-9.1f %-9.1f %-9.1f %-9.1f %-10.1f %-9d %-5d\n",
+         plcIndex_,
+         exeCount_,
+         exeNs_ / 1E3,
+         exeMinTotNs_ == INT_MAX ? 0 : exeMinTotNs_ / 1E3,
+         exeMaxTotNs_ / 1E3,
+         readNs_ / 1E3,
+         evalNs_ / 1E3,
+         writeNs_ / 1E3,
+         budgetNs_ / 1E3,
+         overruns_,
+         skipCycles_);
+}
+
+int ecmcPLCProfiler::initAsyn() {
+  if (!asynPortDriver_) {
+    return 0;
+  }
+
+  struct {
+    const char   *name;
+    asynParamType type;
+    int32_t      *data;
+    size_t        bytes;
+  } pars[ECMC_PLC_PROF_PAR_COUNT] = {
+    { ECMC_PLC_PROF_EXE_STR,         asynParamInt32,      &exeNs_,      sizeof(exeNs_)      },
+    { ECMC_PLC_PROF_EXE_MIN_STR,     asynParamInt32,      &exeMinNs_,   sizeof(exeMinNs_)   },
+    { ECMC_PLC_PROF_EXE_MAX_STR,     asynParamInt32,      &exeMaxNs_,   sizeof(exeMaxNs_)   },
+    { ECMC_PLC_PROF_READ_STR,        asynParamInt32,      &readNs_,     sizeof(readNs_)     },
+    { ECMC_PLC_PROF_READ_MAX_STR,    asynParamInt32,      &readMaxNs_,  sizeof(readMaxNs_)  },
+    { ECMC_PLC_PROF_EVAL_STR,        asynParamInt32,      &evalNs_,     sizeof(evalNs_)     },
+    { ECMC_PLC_PROF_EVAL_MAX_STR,    asynParamInt32,      &evalMaxNs_,  sizeof(evalMaxNs_)  },
+    { ECMC_PLC_PROF_WRITE_STR,       asynParamInt32,      &writeNs_,    sizeof(writeNs_)    },
+    { ECMC_PLC_PROF_WRITE_MAX_STR,   asynParamInt32,      &writeMaxNs_, sizeof(writeMaxNs_) },
+    { ECMC_PLC_PROF_HIST_STR,        asynParamInt32Array, hist_,        sizeof(hist_)       },
+    { ECMC_PLC_PROF_OVERRUNS_STR,    asynParamInt32,      &overruns_,   sizeof(overruns_)   },
+    { ECMC_PLC_PROF_WARNING_STR,     asynParamInt32,      &warning_,    sizeof(warning_)    },
+    { ECMC_PLC_PROF_SKIP_CYCLES_STR, asynParamInt32,      &skipCycles_, sizeof(skipCycles_) },
+  };
+
+  char name[EC_MAX_OBJECT_PATH_CHAR_LENGTH];
+
+  for (int i = 0; i < ECMC_PLC_PROF_PAR_COUNT; i++) {
+    int chars = 0;
+
+    if (plcIndex_ < maxPlcCount) {
+      // "plcs.plc<index>.prof.<name>"
+      chars = snprintf(name,
+                       sizeof(name),
+                       ECMC_PLCS_DATA_STR "." ECMC_PLC_DATA_STR "%d."
+                       ECMC_PLC_PROF_STR ".%s",
+                       plcIndex_,
+                       pars[i].name);
+    } else {
+      // Axis PLC "plcs.ax<index>.prof.<name>"
+      chars = snprintf(name,
+                       sizeof(name),
+                       ECMC_PLCS_DATA_STR "." ECMC_AX_STR "%d."
+                       ECMC_PLC_PROF_STR ".%s",
+                       plcIndex_ - maxPlcCount,
+                       pars[i].name);
+    }
+
+    if (chars >= (int)sizeof(name) - 1) {
+      return ERROR_PLC_PROFILER_ASYN_PARAM_FAIL;
+    }
+
+    ecmcAsynDataItem *paramTemp =
+      asynPortDriver_->addNewAvailParam(name,
+                                        pars[i].type,
+                                        (uint8_t *)pars[i].data,
+                                        pars[i].bytes,
+                                        ECMC_EC_S32,
+                                        0);
+
+    if (!paramTemp) {
+      LOGERR(
+        "%s/%s:%d: ERROR: Add create default parameter for %s failed (0x%x).\n",
+        __FILE__,
+        __FUNCTION__,
+        __LINE__,
+        name,
+        ERROR_PLC_PROFILER_ASYN_PARAM_FAIL);
+      return ERROR_PLC_PROFILER_ASYN_PARAM_FAIL;
+    }
+    paramTemp->setAllowWriteToEcmc(false);
+    paramTemp->setAllowScheduler(false);  // Min/max reset when refreshed
+
+    if (pars[i].type == asynParamInt32Array) {
+      paramTemp->setArrayCheckSize(false);
+    }
+    paramTemp->refreshParam(1);
+    params_[i] = paramTemp;
+  }
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecmcPLCProfiler.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Execution time profile of one PLC, split in the phases of
+* ecmcPLCTask::execute(): read of variables, evaluation of the expression
+* and write of variables (incl. asyn updates of static variables).
+* Optional time budget: overruns are counted and, if configured, the PLC is
+* demoted to a slower rate (skip cycles) after a number of consecutive
+* overruns.
+*
+\*************************************************************************/
+
+#ifndef ECMC_PLC_PROFILER_H_
+#define ECMC_PLC_PROFILER_H_
+
+#include <stdint.h>
+#include "ecmcAsynPortDriver.h"
+#include "ecmcError.h"
+
+#define ERROR_PLC_PROFILER_ASYN_PARAM_FAIL 0x20511
+#define ERROR_PLC_PROFILER_BUDGET_INVALID 0x20512
+#define ERROR_PLC_PROFILER_DEMOTION_INVALID 0x20513
+
+// Histogram of execution time: bin 0 < 1us, bin n < 2^n us, last bin rest
+#define ECMC_PLC_PROF_HIST_BINS 16
+
+#define ECMC_PLC_PROF_STR "prof"
+#define ECMC_PLC_PROF_EXE_STR "exetime"
+#define ECMC_PLC_PROF_EXE_MIN_STR "exetimemin"
+#define ECMC_PLC_PROF_EXE_MAX_STR "exetimemax"
+#define ECMC_PLC_PROF_READ_STR "readtime"
+#define ECMC_PLC_PROF_READ_MAX_STR "readtimemax"
+#define ECMC_PLC_PROF_EVAL_STR "evaltime"
+#define ECMC_PLC_PROF_EVAL_MAX_STR "evaltimemax"
+#define ECMC_PLC_PROF_WRITE_STR "writetime"
+#define ECMC_PLC_PROF_WRITE_MAX_STR "writetimemax"
+#define ECMC_PLC_PROF_HIST_STR "hist"
+#define ECMC_PLC_PROF_OVERRUNS_STR "overruns"
+#define ECMC_PLC_PROF_WARNING_STR "budgetwarning"
+#define ECMC_PLC_PROF_SKIP_CYCLES_STR "skipcycles"
+
+enum ecmcPLCProfPar {
+  ECMC_PLC_PROF_PAR_EXE = 0,
+  ECMC_PLC_PROF_PAR_EXE_MIN,
+  ECMC_PLC_PROF_PAR_EXE_MAX,
+  ECMC_PLC_PROF_PAR_READ,
+  ECMC_PLC_PROF_PAR_READ_MAX,
+  ECMC_PLC_PROF_PAR_EVAL,
+  ECMC_PLC_PROF_PAR_EVAL_MAX,
+  ECMC_PLC_PROF_PAR_WRITE,
+  ECMC_PLC_PROF_PAR_WRITE_MAX,
+  ECMC_PLC_PROF_PAR_HIST,
+  ECMC_PLC_PROF_PAR_OVERRUNS,
+  ECMC_PLC_PROF_PAR_WARNING,
+  ECMC_PLC_PROF_PAR_SKIP_CYCLES,
+  ECMC_PLC_PROF_PAR_COUNT
+};
+
+class ecmcPLCProfiler : public ecmcError {
+public:
+  ecmcPLCProfiler(int                 plcIndex,
+                  int                 skipCycles,
+                  ecmcAsynPortDriver *asynPortDriver);
+  ~ecmcPLCProfiler();
+
+  // Rt, called in ecmcPLCTask::execute()
+  void   start();
+  void   readDone();
+  void   evalDone();
+
+  // Returns the skip cycles to use (changed if demoted)
+  int    done(int skipCycles);
+  void   updateAsyn(int force);
+
+  // Budget in micro seconds (0 = no budget)
+  int    setBudget(double budgetUs);
+
+  // Demote to skipCycles after overrunLimit consecutive overruns (0 = off)
+  int    setDemotion(int overrunLimit,
+                     int skipCycles);
+  void   print();
+
+private:
+  int    initAsyn();
+  void   resetPar(int parId);
+
+  int plcIndex_;
+  ecmcAsynPortDriver *asynPortDriver_;
+  ecmcAsynDataItem *params_[ECMC_PLC_PROF_PAR_COUNT];
+  int64_t startNs_;
+  int64_t readDoneNs_;
+  int64_t evalDoneNs_;
+
+  // Nano seconds (same as the rt thread diagnostics)
+  int32_t exeNs_;
+  int32_t exeMinNs_;
+  int32_t exeMaxNs_;
+  int32_t readNs_;
+  int32_t readMaxNs_;
+  int32_t evalNs_;
+  int32_t evalMaxNs_;
+  int32_t writeNs_;
+  int32_t writeMaxNs_;
+  int32_t hist_[ECMC_PLC_PROF_HIST_BINS];
+  int32_t overruns_;
+  int32_t warning_;
+  int32_t skipCycles_;
+  uint64_t exeCount_;
+
+  // Min/max since start (print), the above are reset when published
+  int32_t exeMinTotNs_;
+  int32_t exeMaxTotNs_;
+  int32_t budgetNs_;
+  int consecutiveOverruns_;
+  int demoteOverrunLimit_;
+  int demoteSkipCycles_;
+  bool demoted_;
+};
+
+#endif  /* ECMC_PLC_PROFILER_H_ */
@@ -24,6 +24,7 @@
           if (errorCode) {\
             return errorCode;\
           }\
+          native_->addFunction(cmd, func);\
 }\
 
 ecmcPLCTask::ecmcPLCTask(int                 plcIndex,
@@ -36,16 +37,80 @@ ecmcPLCTask::ecmcPLCTask(int                 plcIndex,
   asynPortDriver_    = asynPortDriver;
   functionLibs_.clear();
   exprtk_            = new exprtkWrap();
+  native_            = new ecmcPLCNative(plcIndex);
   mcuFreq_           = mcuFreq;
   plcScanTimeInSecs_ = 1 / mcuFreq_ * (skipCycles + 1);
   initAsyn(plcIndex);
+  profiler_ = new ecmcPLCProfiler(plcIndex, skipCycles, asynPortDriver);
+
+  if (profiler_->getErrorID()) {
+    setErrorID(__FILE__, __FUNCTION__, __LINE__, profiler_->getErrorID());
+  }
+}
+
+ecmcPLCTask::ecmcPLCTask(ecmcPLCTask *activeTask) {
+  initVars();
+  plcIndex_          = activeTask->plcIndex_;
+  skipCycles_        = activeTask->skipCycles_;
+  asynPortDriver_    = activeTask->asynPortDriver_;
+  functionLibs_.clear();
+  exprtk_            = new exprtkWrap();
+  native_            = new ecmcPLCNative(plcIndex_);
+  nativeMode_        = activeTask->nativeMode_;
+  mcuFreq_           = activeTask->mcuFreq_;
+  plcScanTimeInSecs_ = activeTask->plcScanTimeInSecs_;
+
+  // Asyn expression param and profiler are taken over in
+  // commitOnlineChange()
+  for (size_t i = 0; i < activeTask->plugins_.size(); i++) {
+    setPluginPointer(activeTask->plugins_[i], i);
+  }
+
+  for (size_t i = 0; i < activeTask->functionLibs_.size(); i++) {
+    if (addLib(activeTask->functionLibs_[i])) {
+      return;
+    }
+  }
+
+  // Static variables are shared (owned by activeTask until commit)
+  for (int i = 0; i < activeTask->localVariableCount_; i++) {
+    ecmcPLCDataIF *localData = activeTask->localArray_[i];
+
+    if (!localData) {
+      continue;
+    }
+
+    if (exprtk_->addVariable(localData->getVarName(),
+                             localData->getDataRef())) {
+      LOGERR("%s/%s:%d: Failed to add variable %s to exprtk  (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             localData->getVarName(),
+             ERROR_PLC_ADD_VARIABLE_FAIL);
+      setErrorID(__FILE__,
+                 __FUNCTION__,
+                 __LINE__,
+                 ERROR_PLC_ADD_VARIABLE_FAIL);
+      break;
+    }
+    localArray_[localVariableCount_] = localData;
+    localVariableCount_++;
+  }
+  borrowedLocalCount_ = localVariableCount_;
 }
 
 ecmcPLCTask::~ecmcPLCTask() {
-  for (int i = 0; i < ECMC_MAX_PLC_VARIABLES; i++) {
+  for (int i = borrowedLocalCount_; i < ECMC_MAX_PLC_VARIABLES; i++) {
     delete localArray_[i];
     localArray_[i] = NULL;
   }
+  delete exprtk_;
+  exprtk_ = NULL;
+  delete profiler_;
+  profiler_ = NULL;
+  delete native_;
+  native_ = NULL;
 }
 
 void ecmcPLCTask::initVars() {
@@ -56,6 +121,7 @@ void ecmcPLCTask::initVars() {
   compiled_            = false;
   globalVariableCount_ = 0;
   localVariableCount_  = 0;
+  borrowedLocalCount_  = 0;
   inStartup_           = 1;
   skipCycles_          = 0;
   skipCyclesCounter_   = 0;
@@ -66,10 +132,8 @@ void ecmcPLCTask::initVars() {
     localArray_[i]  = NULL;
   }
 
-  for (int i = 0; i < ECMC_MAX_PLUGINS; i++) {
-    plugins_[i]          = 0;
-    libPluginsLoaded_[i] = 0;
-  }
+  plugins_.clear();
+  libPluginsLoaded_.clear();
   firstScanDone_   = 0;
   libMcLoaded_     = 0;
   libEcLoaded_     = 0;
@@ -80,6 +144,10 @@ void ecmcPLCTask::initVars() {
   newExpr_         = 0;
   mcuFreq_         = MCU_FREQUENCY;
   asynParamExpr_   = NULL;
+  profiler_        = NULL;
+  sampleTimeChanged_ = false;
+  native_          = NULL;
+  nativeMode_      = ECMC_PLC_NATIVE_OFF;
 }
 
 int ecmcPLCTask::addAndRegisterLocalVar(char *localVarStr) {
@@ -162,6 +230,49 @@ int ecmcPLCTask::compile() {
   compiled_   = true;
   newExpr_    = false;
   exprStrRaw_ = "";
+
+  if (nativeMode_ != ECMC_PLC_NATIVE_OFF) {
+    buildNative();
+  }
+  return 0;
+}
+
+int ecmcPLCTask::buildNative() {
+  // Same variables as exprtk
+  native_->clearVariables();
+
+  for (int i = 0; i < localVariableCount_; i++) {
+    if (localArray_[i]) {
+      native_->addVariable(localArray_[i]->getVarName(),
+                           &localArray_[i]->getDataRef());
+    }
+  }
+
+  for (int i = 0; i < globalVariableCount_; i++) {
+    if (globalArray_[i]) {
+      native_->addVariable(globalArray_[i]->getExprTkVarName(),
+                           &globalArray_[i]->getDataRef());
+    }
+  }
+
+  int errorCode = native_->build(exprStr_,
+                                 nativeMode_ == ECMC_PLC_NATIVE_VERIFY);
+
+  if (errorCode) {
+    // Not fatal, exprtk is used
+    LOGERR("%s/%s:%d: WARNING: PLC%d: Native build failed, using exprtk (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           errorCode);
+    return errorCode;
+  }
+  LOGINFO4("%s/%s:%d: PLC%d: Native code loaded.\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_);
   return 0;
 }
 
@@ -189,6 +300,12 @@ int ecmcPLCTask::execute(bool ecOK) {
     return 0;
   }
 
+  ecmcPLCProfiler * const profiler = profiler_;
+
+  if (profiler) {
+    profiler->start();
+  }
+
   const int localCount = localVariableCount_;
   for (int i = 0; i < localCount; i++) {
     ecmcPLCDataIF * const localData = localArray_[i];
@@ -205,8 +322,16 @@ int ecmcPLCTask::execute(bool ecOK) {
     }
   }
 
+  if (profiler) {
+    profiler->readDone();
+  }
+
   // Run equation
-  exprtk_->refresh();
+  evaluate();
+
+  if (profiler) {
+    profiler->evalDone();
+  }
 
   for (int i = 0; i < localCount; i++) {
     ecmcPLCDataIF * const localData = localArray_[i];
@@ -228,6 +353,18 @@ int ecmcPLCTask::execute(bool ecOK) {
 
   firstScanDone_ = 1;
 
+  if (profiler) {
+    const int skipCycles = profiler->done(skipCycles_);
+
+    // Demoted (time budget exceeded)
+    if (skipCycles != skipCycles_) {
+      skipCycles_        = skipCycles;
+      plcScanTimeInSecs_ = 1 / mcuFreq_ * (skipCycles_ + 1);
+      sampleTimeChanged_ = true;
+    }
+    profiler->updateAsyn(0);
+  }
+
   return 0;
 }
 
@@ -293,12 +430,13 @@ int ecmcPLCTask::clearExpr() {
   compiled_ = false;
 
   for (int i = 0; i < localVariableCount_; i++) {
-    if (localArray_[i]) {
+    if (localArray_[i] && (i >= borrowedLocalCount_)) {
       delete localArray_[i];
-      localArray_[i] = NULL;
     }
+    localArray_[i] = NULL;
   }
   localVariableCount_ = 0;
+  borrowedLocalCount_ = 0;
   return 0;
 }
 
@@ -519,7 +657,7 @@ int ecmcPLCTask::parseFunctions(const char *exprStr) {
     }
   }
 
-  for (int i = 0; i < ECMC_MAX_PLUGINS; ++i) {
+  for (size_t i = 0; i < plugins_.size(); ++i) {
     if (!libPluginsLoaded_[i]) {
       if (findPluginFunction(plugins_[i], exprStr) ||
           findPluginConstant(plugins_[i], exprStr)) {
@@ -742,6 +880,8 @@ int ecmcPLCTask::loadPluginLib(ecmcPluginLib *plugin) {
     if (errorCode) {
       return errorCode;
     }
+    native_->addConstant(data->consts[i].constName,
+                         data->consts[i].constValue);
   }
 
   return 0;
@@ -786,6 +926,9 @@ int ecmcPLCTask::loadEcLib() {
   ecmcPLCTaskAddFunction("ec_get_dom_state", ec_get_dom_state);
   ecmcPLCTaskAddFunction("ec_get_time_frm_src", ec_get_time_frm_src);
   ecmcPLCTaskAddFunction("ec_get_time_offset_mono", ec_get_time_offset_mono);
+  ecmcPLCTaskAddFunction("ec_edge_pop", ec_edge_pop);
+  ecmcPLCTaskAddFunction("ec_edge_time", ec_edge_time);
+  ecmcPLCTaskAddFunction("ec_edge_count", ec_edge_count);
 
   if (ec_cmd_count != cmdCounter) {
     LOGERR("%s/%s:%d: PLC Lib EC command count missmatch (0x%x).\n",
@@ -943,6 +1086,9 @@ int ecmcPLCTask::loadMiscLib() {
   ecmcPLCTaskAddFunction("lut_get_value", lut_get_value);
   ecmcPLCTaskAddFunction("epics_get_started", epics_get_started);
   ecmcPLCTaskAddFunction("epics_get_state", epics_get_state);
+  ecmcPLCTaskAddFunction("cap_arm", cap_arm);
+  ecmcPLCTaskAddFunction("cap_trigg", cap_trigg);
+  ecmcPLCTaskAddFunction("cap_get_state", cap_get_state);
   
   if (misc_cmd_count != cmdCounter) {
     LOGERR("%s/%s:%d: PLC Lib DS command count missmatch (0x%x).\n",
@@ -1029,7 +1175,7 @@ int ecmcPLCTask::initAsyn(int plcIndex) {
   int chars                   = 0;
 
   // ECMC_PLC_EXPR_STR
-  if (plcIndex < ECMC_MAX_PLCS) {
+  if (plcIndex < maxPlcCount) {
     chars = snprintf(name,
                      EC_MAX_OBJECT_PATH_CHAR_LENGTH - 1,
                      ECMC_PLC_DATA_STR "%d." ECMC_PLC_EXPR_STR,
@@ -1045,7 +1191,7 @@ int ecmcPLCTask::initAsyn(int plcIndex) {
     chars = snprintf(name,
                      EC_MAX_OBJECT_PATH_CHAR_LENGTH - 1,
                      ECMC_AX_STR "%d." ECMC_PLC_DATA_STR "." ECMC_PLC_EXPR_STR,
-                     plcIndex - ECMC_MAX_PLCS);
+                     plcIndex - maxPlcCount);
 
     if (chars >= EC_MAX_OBJECT_PATH_CHAR_LENGTH - 1) {
       return setErrorID(__FILE__,
@@ -1082,15 +1228,108 @@ int ecmcPLCTask::initAsyn(int plcIndex) {
 }
 
 void ecmcPLCTask::updateAsyn() {
+  if (!asynParamExpr_) {
+    return;
+  }
+
+  // exprStr_ may have been reallocated
+  asynParamExpr_->setEcmcDataPointer((uint8_t *)exprStr_.c_str(),
+                                     strlen(exprStr_.c_str()));
   asynParamExpr_->refreshParam(1, (uint8_t *)exprStr_.c_str(),
                                strlen(exprStr_.c_str()));
 }
 
+int ecmcPLCTask::getSkipCycles() {
+  return skipCycles_;
+}
+
+ecmcPLCProfiler * ecmcPLCTask::getProfiler() {
+  return profiler_;
+}
+
+bool ecmcPLCTask::getSampleTimeChanged() {
+  bool changed = sampleTimeChanged_;
+
+  sampleTimeChanged_ = false;
+  return changed;
+}
+
+int ecmcPLCTask::setNativeMode(int mode) {
+  if ((mode < ECMC_PLC_NATIVE_OFF) || (mode > ECMC_PLC_NATIVE_VERIFY)) {
+    LOGERR("%s/%s:%d: PLC%d: Invalid native mode %d (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           mode,
+           ERROR_PLC_NATIVE_MODE_INVALID);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLC_NATIVE_MODE_INVALID);
+  }
+  // Verify would execute the functions (mc_*, ec_*..) twice
+  if ((mode == ECMC_PLC_NATIVE_VERIFY) && native_->getLoaded() &&
+      native_->getCallsFunctions()) {
+    LOGERR("%s/%s:%d: PLC%d: Native verify not possible, code calls functions (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           plcIndex_,
+           ERROR_PLC_NATIVE_VERIFY_FUNCS);
+    return setErrorID(__FILE__,
+                      __FUNCTION__,
+                      __LINE__,
+                      ERROR_PLC_NATIVE_VERIFY_FUNCS);
+  }
+  nativeMode_ = mode;
+
+  // Already compiled (otherwise built in compile())
+  if (compiled_ && (mode != ECMC_PLC_NATIVE_OFF) && !native_->getLoaded()) {
+    buildNative();
+  }
+  return 0;
+}
+
+int ecmcPLCTask::getNativeMode() {
+  return nativeMode_;
+}
+
+ecmcPLCNative * ecmcPLCTask::getNative() {
+  return native_;
+}
+
+int ecmcPLCTask::commitOnlineChange(ecmcPLCTask *replacedTask) {
+  if (!replacedTask) {
+    return 0;
+  }
+
+  // Take over the expression param, the profiler and the static variables
+  asynParamExpr_               = replacedTask->asynParamExpr_;
+  replacedTask->asynParamExpr_ = NULL;
+  profiler_                    = replacedTask->profiler_;
+  replacedTask->profiler_      = NULL;
+  replacedTask->releaseLocalVars();
+  borrowedLocalCount_ = 0;
+  updateAsyn();
+  return 0;
+}
+
+void ecmcPLCTask::releaseLocalVars() {
+  // Asyn params of the static variables point to the data interfaces
+  borrowedLocalCount_ = ECMC_MAX_PLC_VARIABLES;
+}
+
 int ecmcPLCTask::setPluginPointer(ecmcPluginLib *plugin, int index) {
-  if ((index < 0) || (index >= ECMC_MAX_PLUGINS)) {
+  if ((index < 0) || (index >= ECMC_REGISTRY_MAX_SIZE)) {
     return ERROR_PLC_PLUGIN_INDEX_OUT_OF_RANGE;
   }
 
+  if (index >= (int)plugins_.size()) {
+    plugins_.resize(index + 1, NULL);
+    libPluginsLoaded_.resize(index + 1, 0);
+  }
+
   plugins_[index] = plugin;
   return 0;
 }
@@ -25,7 +25,12 @@
 #include "ecmcPluginLib.h"
 #include "ecmcPLCLib.h"
 #include "ecmcPLCDataIF.h"
+#include "ecmcPLCProfiler.h"
+#include "ecmcPLCNative.h"
 #include "ecmcLookupTable.h"
+#include "ecmcCapture.h"
+#include "ecmcEcEdgeCapture.h"
+#include "ecmcRegistry.h"
 
 #define ECMC_MAX_PLC_VARIABLES 1024
 #define ECMC_MAX_PLC_VARIABLES_NAME_LENGTH 1024
@@ -55,6 +60,10 @@ public:
                        int                 skipCycles,
                        double              mcuFreq,
                        ecmcAsynPortDriver *asynPortDriver_);
+
+  // Online change: new program for the same plc index. Plugins, libs and
+  // static variables of activeTask are reused (static values are kept).
+  explicit ecmcPLCTask(ecmcPLCTask *activeTask);
   ~ecmcPLCTask();
   bool         getCompiled();
   int          validate();
@@ -81,6 +90,22 @@ public:
   double       getSampleTime();
   int          getNewExpr();
   int          addLib(ecmcPLCLib* lib);
+  int          getSkipCycles();
+  ecmcPLCProfiler* getProfiler();
+
+  // True once after the rate was changed by the profiler (budget demotion)
+  bool         getSampleTimeChanged();
+
+  // Call (off rt) when this task has replaced replacedTask in the rt loop
+  int          commitOnlineChange(ecmcPLCTask *replacedTask);
+
+  // Do not delete static variables (and their asyn params) with the task
+  void         releaseLocalVars();
+
+  // ECMC_PLC_NATIVE_OFF/RUN/VERIFY (native code is built in compile())
+  int          setNativeMode(int mode);
+  int          getNativeMode();
+  ecmcPLCNative* getNative();
   
 
 private:
@@ -106,6 +131,20 @@ private:
   int  loadFileIOLib();
   int  loadPluginLib(ecmcPluginLib *plugin);
   int  loadMiscLib();
+  int  buildNative();
+
+  // Evaluate the code (exprtk or native)
+  inline void evaluate() {
+    if (nativeMode_ == ECMC_PLC_NATIVE_OFF || !native_->getLoaded()) {
+      exprtk_->refresh();
+    } else if (nativeMode_ == ECMC_PLC_NATIVE_RUN) {
+      native_->run();
+    } else {
+      native_->verifyBegin();
+      exprtk_->refresh();
+      native_->verifyEnd();
+    }
+  }
 
   std::string exprStr_;
   std::string exprStrRaw_; // Before compile and preprocess
@@ -115,6 +154,7 @@ private:
   ecmcPLCDataIF *localArray_[ECMC_MAX_PLC_VARIABLES];
   int globalVariableCount_;
   int localVariableCount_;
+  int borrowedLocalCount_;  // localArray_[0..n-1] owned by other task
   int inStartup_;
   int firstScanDone_;
   int plcIndex_;
@@ -126,14 +166,18 @@ private:
   int libDsLoaded_;
   int libFileIOLoaded_;
   int libMiscLoaded_;
-  int libPluginsLoaded_[ECMC_MAX_PLUGINS];
+  std::vector<int> libPluginsLoaded_;
 
   ecmcAsynPortDriver *asynPortDriver_;
   int newExpr_;
   ecmcAsynDataItem *asynParamExpr_;
   double mcuFreq_;
-  ecmcPluginLib *plugins_[ECMC_MAX_PLUGINS];
+  std::vector<ecmcPluginLib*> plugins_;
   std::vector<ecmcPLCLib*> functionLibs_;
+  ecmcPLCProfiler *profiler_;
+  bool sampleTimeChanged_;
+  ecmcPLCNative *native_;
+  int nativeMode_;
 
 };
 
@@ -27,25 +27,32 @@ int loadPlugin(int pluginId, const char *filenameWP, const char *configStr) {
            filenameWP,
            configStr);
 
-  if ((pluginId < 0) || (pluginId >= ECMC_MAX_PLUGINS)) {
+  if ((pluginId < 0) || (pluginId >= ECMC_REGISTRY_MAX_SIZE)) {
     return ERROR_MAIN_PLUGIN_INDEX_OUT_OF_RANGE;
   }
 
+  // Grow registry if needed
+  int errorCode = plugins.resize(pluginId + 1);
+
+  if (errorCode) {
+    return errorCode;
+  }
+
   if (plugins[pluginId]) {
     delete plugins[pluginId];
   }
 
-  plugins[pluginId] = new ecmcPluginLib(pluginId);
+  plugins.set(pluginId, new ecmcPluginLib(pluginId));
 
   if (!plugins[pluginId]) {
     return ERROR_MAIN_PLUGIN_OBJECT_NULL;
   }
 
-  int errorCode = plugins[pluginId]->load(filenameWP, configStr);
+  errorCode = plugins[pluginId]->load(filenameWP, configStr);
 
   if (errorCode) {
     delete plugins[pluginId];
-    plugins[pluginId] = NULL;
+    plugins.set(pluginId, NULL);
     return errorCode;
   }
 
@@ -92,7 +99,7 @@ int reportPlugin(int pluginId) {
            __LINE__,
            pluginId);
 
-  if ((pluginId < 0) || (pluginId >= ECMC_MAX_PLUGINS)) {
+  if (!plugins.validIndex(pluginId)) {
     return ERROR_MAIN_PLUGIN_INDEX_OUT_OF_RANGE;
   }
 
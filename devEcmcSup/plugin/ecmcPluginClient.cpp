@@ -10,6 +10,8 @@
 *
 \*************************************************************************/
 
+#include <string.h>
+#include <vector>
 #include "ecmcPluginClient.h"
 #include "ecmcOctetIF.h"        // Log Macros
 #include "ecmcDefinitions.h"
@@ -42,6 +44,96 @@ void* getEcmcAsynDataItem(char *idStringWP) {
   return (void *)asynPort->findAvailDataItem(idStringWP);
 }
 
+static void fillSubscription(const char               *idStringWP,
+                             ecmcDataItem             *item,
+                             ecmcDataItemSubscription *sub) {
+  memset(sub, 0, sizeof(*sub));
+  sub->name = idStringWP;
+
+  if (!item) {
+    return;
+  }
+
+  ecmcDataItemInfo *info = item->getDataItemInfo();
+  sub->data            = (void *)info->data;
+  sub->updateSeq       = item->getUpdateSeqPtr();
+  sub->dataSize        = info->dataSize;
+  sub->dataElementSize = info->dataElementSize;
+  sub->elements        = info->dataElementSize > 0 ?
+                         info->dataSize / info->dataElementSize : 0;
+  sub->dataType = (int)info->dataType;
+  sub->dataItem = (void *)item;
+}
+
+int subscribeEcmcDataItem(const char               *idStringWP,
+                          ecmcDataItemSubscription *sub) {
+  LOGINFO4("%s/%s:%d: idStringWP =%s\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           idStringWP ? idStringWP : "NULL");
+
+  if (!idStringWP || !sub) {
+    return ERROR_PLUGIN_CLIENT_ARG_NULL;
+  }
+
+  if (!asynPort) {
+    fillSubscription(idStringWP, NULL, sub);
+    return ERROR_PLUGIN_CLIENT_ASYN_PORT_NULL;
+  }
+
+  ecmcDataItem *item = asynPort->findAvailDataItem(idStringWP);
+  fillSubscription(idStringWP, item, sub);
+
+  if (!item) {
+    LOGERR("%s/%s:%d: ERROR: Data item %s not found (0x%x).\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           idStringWP,
+           ERROR_PLUGIN_CLIENT_DATA_ITEM_NOT_FOUND);
+    return ERROR_PLUGIN_CLIENT_DATA_ITEM_NOT_FOUND;
+  }
+
+  return 0;
+}
+
+int subscribeEcmcDataItems(const char              **idStringsWP,
+                           int                       count,
+                           ecmcDataItemSubscription *subs) {
+  LOGINFO4("%s/%s:%d: count =%d\n",
+           __FILE__,
+           __FUNCTION__,
+           __LINE__,
+           count);
+
+  if (!idStringsWP || !subs || (count < 0)) {
+    return -1;
+  }
+
+  std::vector<ecmcDataItem *> items(count, (ecmcDataItem *)NULL);
+  int notFound = count;
+
+  if (asynPort && (count > 0)) {
+    notFound = asynPort->findAvailDataItems(idStringsWP, count, &items[0]);
+  }
+
+  for (int i = 0; i < count; i++) {
+    fillSubscription(idStringsWP[i], items[i], &subs[i]);
+
+    if (!items[i]) {
+      LOGERR("%s/%s:%d: ERROR: Data item %s not found (0x%x).\n",
+             __FILE__,
+             __FUNCTION__,
+             __LINE__,
+             idStringsWP[i] ? idStringsWP[i] : "NULL",
+             ERROR_PLUGIN_CLIENT_DATA_ITEM_NOT_FOUND);
+    }
+  }
+
+  return notFound;
+}
+
 void* getEcMaster() {
   return (void *)ec;
 }
@@ -75,3 +167,14 @@ int getEcmcEpicsIOCState() {
   }
   return asynPort->getEpicsState();
 }
+
+int readEcmcEdgeEvent(int       index,
+                      int       channel,
+                      size_t   *cursor,
+                      uint64_t *timeNs,
+                      int      *edge) {
+  if (!edgeCaptures.validIndex(index) || !edgeCaptures[index] || !cursor) {
+    return -1;
+  }
+  return edgeCaptures[index]->readEvent(channel, cursor, timeNs, edge);
+}
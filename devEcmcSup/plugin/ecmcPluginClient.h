@@ -15,6 +15,56 @@
 #ifndef ECMC_PLUGIN_H_
 #define ECMC_PLUGIN_H_
 
+#include <stdint.h>
+#include <stddef.h>
+#include <epicsAtomic.h>
+
+#define ERROR_PLUGIN_CLIENT_ARG_NULL 0x231100
+#define ERROR_PLUGIN_CLIENT_DATA_ITEM_NOT_FOUND 0x231101
+#define ERROR_PLUGIN_CLIENT_ASYN_PORT_NULL 0x231102
+
+/** \brief Subscription to an ecmcDataItem (see subscribeEcmcDataItem())
+ *
+ *  Filled once at load time. In the realtime function the data is read
+ *  directly through data and updateSeq is compared with the value of the
+ *  previous cycle to see if the producer refreshed the item.\n
+ */
+typedef struct {
+  const char              *name;            /**< Identification string */
+  void                    *data;            /**< Pointer to ecmc data (stable) */
+  const size_t            *updateSeq;       /**< Incremented on each refresh */
+  size_t                   dataSize;        /**< Size of data in bytes */
+  size_t                   dataElementSize; /**< Size of one element in bytes */
+  size_t                   elements;        /**< Number of elements */
+  int                      dataType;        /**< ecmcEcDataType */
+  void                    *dataItem;        /**< ecmcDataItem (void*) object */
+} ecmcDataItemSubscription;
+
+/** \brief Read a subscribed data item as type T (no checks, use in RT)
+ *
+ *  Example: double pos = ECMC_SUBSCRIPTION_VALUE(sub, double);\n
+ */
+#define ECMC_SUBSCRIPTION_VALUE(sub, T) (*(const volatile T *)((sub).data))
+
+/** \brief Read the update sequence number of a subscribed data item
+ *
+ *  Atomic read (no tearing on 32 bit targets). Data read after this
+ *  macro is at least as new as the returned sequence number.\n
+ */
+static inline size_t ecmcSubscriptionSeq(const size_t *updateSeq) {
+  size_t seq = epicsAtomicGetSizeT(updateSeq);
+
+  epicsAtomicReadMemoryBarrier();
+  return seq;
+}
+
+#define ECMC_SUBSCRIPTION_SEQ(sub) ecmcSubscriptionSeq((sub).updateSeq)
+
+/** \brief Check if subscribed data item was refreshed since lastSeq.\n
+ */
+#define ECMC_SUBSCRIPTION_UPDATED(sub, lastSeq) \
+  (ECMC_SUBSCRIPTION_SEQ(sub) != (lastSeq))
+
 # ifdef __cplusplus
 extern "C" {
 # endif  // ifdef __cplusplus
@@ -57,6 +107,47 @@ void*  getEcmcDataItem(char *idStringWP);
  */
 void*  getEcmcAsynDataItem(char *idStringWP);
 
+/** \brief Subscribe to an ecmcDataItem by idStringWP
+ *
+ *  Resolves the data item and fills sub with a stable pointer to the data,
+ *  type information and a pointer to the update sequence number of the
+ *  item. No callback is registered so there's no overhead in the
+ *  producer, the plugin reads the data directly in the realtime function.\n
+ *  Call at load time (not in realtime).\n
+ *
+ *  \param[in] idStringWP Identification string "with path".\n
+ *                        examples: ec0.s1.AI_1\n
+ *                                  ax1.enc.actpos\n
+ *  \param[out] sub Subscription.\n
+ *
+ * \return 0 if success or otherwise an error code.\n
+ *
+ * \note There's no ascii command in ecmcCmdParser.c for this method.\n
+ */
+int    subscribeEcmcDataItem(const char               *idStringWP,
+                             ecmcDataItemSubscription *sub);
+
+/** \brief Subscribe to many ecmcDataItems in one call
+ *
+ *  Same as subscribeEcmcDataItem() but resolves all names in one pass
+ *  over the registered data items (use when subscribing to hundreds of
+ *  items). Subscriptions of names that are not found are cleared
+ *  (data == NULL).\n
+ *  Call at load time (not in realtime).\n
+ *
+ *  \param[in] idStringsWP Array of identification strings.\n
+ *  \param[in] count Number of identification strings.\n
+ *  \param[out] subs Array of count subscriptions.\n
+ *
+ * \return Number of names not found (0 if all found) or -1 on invalid
+ *  arguments.\n
+ *
+ * \note There's no ascii command in ecmcCmdParser.c for this method.\n
+ */
+int    subscribeEcmcDataItems(const char              **idStringsWP,
+                              int                       count,
+                              ecmcDataItemSubscription *subs);
+
 /** \brief Get ecmc ec master
  *
  * \return ecmcEc (void*) object if success or otherwise NULL.\n
@@ -100,6 +191,28 @@ double getEcmcSampleTimeMS();
  */
 int    getEcmcEpicsIOCState();
 
+/** \brief Read next event of an edge capture channel
+ *
+ * Any thread. Each reader keeps its own cursor (start with 0 or the\n
+ * current event count to skip old events). The cursor is advanced past\n
+ * events that have been overwritten.\n
+ *
+ * \param[in] index Edge capture index.\n
+ * \param[in] channel Channel index.\n
+ * \param[in,out] cursor Number of next event to read.\n
+ * \param[out] timeNs Time of event [ns].\n
+ * \param[out] edge Edge of event (1=rising, 2=falling).\n
+ *
+ * \return 1 if an event was read, 0 if no new event, -1 if invalid index.\n
+ *
+ * \note There's no ascii command in ecmcCmdParser.c for this method.\n
+ */
+int    readEcmcEdgeEvent(int       index,
+                         int       channel,
+                         size_t   *cursor,
+                         uint64_t *timeNs,
+                         int      *edge);
+
 # ifdef __cplusplus
 }
 # endif  // ifdef __cplusplus
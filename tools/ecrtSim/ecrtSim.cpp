@@ -0,0 +1,1490 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  ecrtSim.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Stand-in for the etherlab user space library (libethercat) implementing
+* the part of the ecrt.h API used by ecmc. The unmodified ecmcEc, ecmcEcSlave,
+* ecmcEcDomain, ecmcEcEntry and ecmcEcAsyncSDO code runs against simulated
+* slaves at full rate without hardware (profiling, regression tests):
+*
+*   make -C tools/ecrtSim ETHERLAB=/opt/etherlab
+*   ECMC_ECRT_SIM_CFG=bus.cfg LD_PRELOAD=tools/ecrtSim/libecrtsim.so \
+*     ./st.cmd
+*
+* The bus is described in the file ECMC_ECRT_SIM_CFG, one item per line
+* ('#' comment, numbers dec or hex):
+*
+*   slave <pos> <vendorId> <productCode> [<revision> [<serial> [<alias>]]]
+*   name <pos> <name>
+*   sync <pos> <smIndex> <in|out>              (default layout of the slave,
+*   pdo <pos> <smIndex> <pdoIndex>              used if ecmc does not
+*   entry <pos> <pdoIndex> <index> <subIndex> <bits>  configure the pdos)
+*   sdo <pos> <index> <subIndex> <size> <value>
+*   input <pos> <index> <subIndex> <value>     (constant input value)
+*   loopback <pos> <index> <subIndex> <inPos> <inIndex> <inSubIndex>
+*                                              (output copied to input)
+*   autoslaves <0|1>       slaves configured by ecmc are added to the bus
+*   sdo_autocreate <0|1>   upload of unknown objects returns zeros
+*   op_delay <cycles>      cycles in SAFEOP after activation (default 10)
+*   wkc_fail <p>           probability of a lost working counter per cycle
+*   latency_us <min> <max> random delay in ecrt_master_receive()
+*   link_down <cycle> <cycles>
+*   slave_offline <pos> <cycle> <cycles>
+*   sdo_delay <cycles>     busy cycles of sdo requests (default 2)
+*   sdo_fail <p>           probability of sdo abort
+*   seed <n>               seed of the random generator
+*   dc_drift_ppm <ppm>     drift of the reference clock vs CLOCK_MONOTONIC
+*
+* Counters are printed when the master is released.
+*
+\*************************************************************************/
+
+#include <ecrt.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// Functions returning void in ecrt.h 1.5 return int from 1.6
+#if defined(ECRT_VERSION_MAGIC) && defined(ECRT_VERSION) && \
+  (ECRT_VERSION_MAGIC >= ECRT_VERSION(1, 6))
+# define SIM_RET int
+# define SIM_RETURN(x) return (x)
+# define SIM_CONST const
+#else  // if defined(ECRT_VERSION_MAGIC) && defined(ECRT_VERSION) &&
+       // (ECRT_VERSION_MAGIC >= ECRT_VERSION(1, 6))
+# define SIM_RET void
+# define SIM_RETURN(x) return
+# define SIM_CONST
+#endif  // if defined(ECRT_VERSION_MAGIC) && defined(ECRT_VERSION) &&
+        // (ECRT_VERSION_MAGIC >= ECRT_VERSION(1, 6))
+
+#define SIM_CFG_ENV "ECMC_ECRT_SIM_CFG"
+#define SIM_AL_INIT 0x1
+#define SIM_AL_PREOP 0x2
+#define SIM_AL_SAFEOP 0x4
+#define SIM_AL_OP 0x8
+#define SIM_SDO_ABORT_NOT_EXIST 0x06020000
+#define SIM_SDO_ABORT_GENERAL 0x08000000
+#define SIM_SDO_KEY(index, sub) (((uint32_t)(index) << 8) | (sub))
+
+struct simEntry {
+  uint16_t index;
+  uint8_t  subIndex;
+  uint8_t  bits;
+};
+
+struct simPdo {
+  uint16_t              index;
+  std::vector<simEntry> entries;
+};
+
+struct simSync {
+  uint8_t             index;
+  ec_direction_t      dir;
+  std::vector<simPdo> pdos;
+};
+
+typedef std::vector<simSync> simLayout;
+typedef std::map<uint32_t, std::vector<uint8_t> > simDictionary;
+
+struct simBusSlave {
+  uint16_t      position;
+  uint16_t      alias;
+  uint32_t      vendorId;
+  uint32_t      productCode;
+  uint32_t      revision;
+  uint32_t      serial;
+  std::string   name;
+  simLayout     layout;  // From file
+  simDictionary sdos;
+  simDictionary idns;
+  int64_t       offlineStart;
+  int64_t       offlineCycles;
+};
+
+struct simValue {
+  uint16_t position;
+  uint16_t index;
+  uint8_t  subIndex;
+  uint64_t value;
+};
+
+struct simLoopback {
+  uint16_t outPosition;
+  uint16_t outIndex;
+  uint8_t  outSubIndex;
+  uint16_t inPosition;
+  uint16_t inIndex;
+  uint8_t  inSubIndex;
+};
+
+struct simRegEntry {
+  ec_slave_config_t *sc;
+  uint16_t           index;
+  uint8_t            subIndex;
+  size_t             offset;
+  unsigned int       bitPos;
+  unsigned int       bits;
+};
+
+struct simBlock {
+  ec_slave_config_t *sc;
+  uint8_t            syncIndex;
+  size_t             offset;
+  size_t             size;
+  bool               output;
+};
+
+// Resolved constant input or loopback (offsets in domain data)
+struct simCopy {
+  ec_domain_t *outDomain;
+  simRegEntry  out;
+  ec_domain_t *inDomain;
+  simRegEntry  in;
+  uint64_t     value;
+};
+
+struct ec_sdo_request {
+  ec_slave_config_t   *sc;
+  uint16_t             index;
+  uint8_t              subIndex;
+  std::vector<uint8_t> data;
+  uint32_t             timeoutMs;
+  ec_request_state_t   state;
+  int                  countdown;
+  bool                 write;
+};
+
+struct ec_slave_config {
+  ec_master_t                                 *master;
+  uint16_t                                     alias;
+  uint16_t                                     position;
+  uint32_t                                     vendorId;
+  uint32_t                                     productCode;
+  std::map<uint8_t, ec_direction_t>            dirs;
+  std::map<uint8_t, std::vector<uint16_t> >    assigns;
+  std::map<uint16_t, std::vector<simEntry> >   mappings;
+  std::vector<std::pair<uint32_t, std::vector<uint8_t> > > sdos;
+  std::vector<ec_sdo_request_t *>              requests;
+  uint16_t                                     dcAssignActivate;
+  uint32_t                                     dcSync0Cycle;
+};
+
+struct ec_domain {
+  ec_master_t             *master;
+  std::vector<simBlock>    blocks;
+  std::vector<simRegEntry> entries;
+  size_t                   size;
+  uint8_t                 *data;
+  uint16_t                 wc;
+  uint16_t                 expectedWc;
+  ec_wc_state_t            wcState;
+  uint64_t                 wcFaults;
+};
+
+struct ec_master {
+  unsigned int                    index;
+  pthread_mutex_t                 lock;
+  std::vector<simBusSlave>        bus;
+  std::vector<ec_slave_config_t *> configs;
+  std::vector<ec_domain_t *>      domains;
+  std::vector<simValue>           inputs;
+  std::vector<simLoopback>        loopbacks;
+  std::vector<simCopy>            copies;
+  bool                            activated;
+  int64_t                         cycle;
+  int64_t                         opCycle;
+  uint64_t                        appTime;
+  uint64_t                        rngState;
+
+  // Options
+  bool                            autoSlaves;
+  bool                            sdoAutoCreate;
+  int                             opDelay;
+  double                          wkcFail;
+  int                             latencyMinUs;
+  int                             latencyMaxUs;
+  int64_t                         linkDownStart;
+  int64_t                         linkDownCycles;
+  int                             sdoDelay;
+  double                          sdoFail;
+  double                          dcDriftPpm;
+
+  // Reference clock, synced to the application time at first send after
+  // activation and by ecrt_master_sync_reference_clock()
+  bool                            dcSyncPending;
+  bool                            dcValid;
+  int64_t                         dcOffsetNs;
+  uint32_t                        dcRefTime;
+
+  // Counters
+  uint64_t                        sends;
+  uint64_t                        refClockSyncs;
+  uint64_t                        slaveClockSyncs;
+  uint64_t                        sdoTransfers;
+  uint64_t                        sdoAborts;
+  int64_t                         maxLatencyNs;
+};
+
+static int64_t simTimeNs() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// xorshift64, 0..1
+static double simRandom(ec_master_t *master) {
+  uint64_t x = master->rngState;
+
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  master->rngState = x;
+  return (double)(x >> 11) / (double)(1ULL << 53);
+}
+
+static bool simActive(int64_t cycle, int64_t start, int64_t cycles) {
+  return cycles > 0 && cycle >= start && cycle < start + cycles;
+}
+
+static bool simLinkUp(const ec_master_t *master) {
+  return !simActive(master->cycle, master->linkDownStart,
+                    master->linkDownCycles);
+}
+
+static simBusSlave* simFindBusSlave(ec_master_t *master, uint16_t position) {
+  for (size_t i = 0; i < master->bus.size(); i++) {
+    if (master->bus[i].position == position) {
+      return &master->bus[i];
+    }
+  }
+  return NULL;
+}
+
+static bool simSlaveOnline(const ec_master_t *master,
+                           const simBusSlave *slave) {
+  return slave && simLinkUp(master) &&
+         !simActive(master->cycle, slave->offlineStart, slave->offlineCycles);
+}
+
+static uint8_t simSlaveAlState(const ec_master_t *master) {
+  if (!master->activated) {
+    return SIM_AL_PREOP;
+  }
+  return master->cycle >= master->opCycle ? SIM_AL_OP : SIM_AL_SAFEOP;
+}
+
+static bool simConfigMatches(ec_master_t *master, ec_slave_config_t *sc) {
+  simBusSlave *slave = simFindBusSlave(master, sc->position);
+
+  return slave && slave->vendorId == sc->vendorId &&
+         slave->productCode == sc->productCode &&
+         simSlaveOnline(master, slave);
+}
+
+// Default direction of sync managers (etherlab convention)
+static ec_direction_t simDefaultDir(uint8_t syncIndex) {
+  return (syncIndex % 2) == 0 ? EC_DIR_OUTPUT : EC_DIR_INPUT;
+}
+
+static ec_slave_config_t* simFindConfig(ec_master_t *master,
+                                        uint16_t     position) {
+  for (size_t i = 0; i < master->configs.size(); i++) {
+    if (master->configs[i]->position == position) {
+      return master->configs[i];
+    }
+  }
+  return NULL;
+}
+
+// Pdo layout configured by the application (falls back to file layout)
+static simLayout simConfigLayout(ec_slave_config_t *sc) {
+  simLayout layout;
+
+  if (sc->assigns.empty()) {
+    simBusSlave *slave = simFindBusSlave(sc->master, sc->position);
+
+    if (slave) {
+      return slave->layout;
+    }
+    return layout;
+  }
+
+  for (std::map<uint8_t, std::vector<uint16_t> >::iterator it =
+         sc->assigns.begin(); it != sc->assigns.end(); ++it) {
+    simSync sync;
+    sync.index = it->first;
+    sync.dir   = sc->dirs.count(it->first) ? sc->dirs[it->first] :
+                 simDefaultDir(it->first);
+
+    for (size_t i = 0; i < it->second.size(); i++) {
+      simPdo pdo;
+      pdo.index   = it->second[i];
+      pdo.entries = sc->mappings[pdo.index];
+      sync.pdos.push_back(pdo);
+    }
+    layout.push_back(sync);
+  }
+  return layout;
+}
+
+static simLayout simBusLayout(ec_master_t *master, simBusSlave *slave) {
+  ec_slave_config_t *sc = simFindConfig(master, slave->position);
+
+  if (slave->layout.empty() && sc) {
+    return simConfigLayout(sc);
+  }
+  return slave->layout;
+}
+
+static void simWriteBits(uint8_t *data,
+                         size_t   offset,
+                         unsigned bitPos,
+                         unsigned bits,
+                         uint64_t value) {
+  for (unsigned i = 0; i < bits; i++) {
+    size_t   bit  = bitPos + i;
+    uint8_t *byte = data + offset + bit / 8;
+    uint8_t  mask = (uint8_t)(1 << (bit % 8));
+
+    *byte = (value >> i) & 1 ? (*byte | mask) : (*byte & ~mask);
+  }
+}
+
+static uint64_t simReadBits(const uint8_t *data,
+                            size_t         offset,
+                            unsigned       bitPos,
+                            unsigned       bits) {
+  uint64_t value = 0;
+
+  for (unsigned i = 0; i < bits && i < 64; i++) {
+    size_t bit = bitPos + i;
+
+    if (data[offset + bit / 8] & (1 << (bit % 8))) {
+      value |= 1ULL << i;
+    }
+  }
+  return value;
+}
+
+static bool simFindRegEntry(ec_master_t  *master,
+                            uint16_t      position,
+                            uint16_t      index,
+                            uint8_t       subIndex,
+                            ec_domain_t **domain,
+                            simRegEntry  *entry) {
+  for (size_t d = 0; d < master->domains.size(); d++) {
+    std::vector<simRegEntry>& entries = master->domains[d]->entries;
+
+    for (size_t i = 0; i < entries.size(); i++) {
+      if ((entries[i].sc->position == position) &&
+          (entries[i].index == index) &&
+          (entries[i].subIndex == subIndex)) {
+        *domain = master->domains[d];
+        *entry  = entries[i];
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static uint64_t simParseNumber(const char *str) {
+  return strtoull(str, NULL, 0);
+}
+
+static simSync* simFileSync(simBusSlave *slave, uint8_t syncIndex) {
+  for (size_t i = 0; i < slave->layout.size(); i++) {
+    if (slave->layout[i].index == syncIndex) {
+      return &slave->layout[i];
+    }
+  }
+  simSync sync;
+  sync.index = syncIndex;
+  sync.dir   = simDefaultDir(syncIndex);
+  slave->layout.push_back(sync);
+  return &slave->layout.back();
+}
+
+static simPdo* simFilePdo(simBusSlave *slave, uint16_t pdoIndex) {
+  for (size_t i = 0; i < slave->layout.size(); i++) {
+    for (size_t j = 0; j < slave->layout[i].pdos.size(); j++) {
+      if (slave->layout[i].pdos[j].index == pdoIndex) {
+        return &slave->layout[i].pdos[j];
+      }
+    }
+  }
+  return NULL;
+}
+
+static int simLoadConfig(ec_master_t *master, const char *fileName) {
+  FILE *file = fopen(fileName, "r");
+  char  line[512];
+  int   lineNumber = 0;
+
+  if (!file) {
+    fprintf(stderr, "ecrtSim: Failed to open %s.\n", fileName);
+    return -ENOENT;
+  }
+
+  while (fgets(line, sizeof(line), file)) {
+    char *argv[16];
+    int   argc = 0;
+    lineNumber++;
+
+    char *comment = strchr(line, '#');
+
+    if (comment) {
+      *comment = 0;
+    }
+
+    for (char *tok = strtok(line, " \t\r\n"); tok && argc < 16;
+         tok = strtok(NULL, " \t\r\n")) {
+      argv[argc++] = tok;
+    }
+
+    if (argc == 0) {
+      continue;
+    }
+    std::string  cmd   = argv[0];
+    simBusSlave *slave = argc > 1 ?
+                         simFindBusSlave(master,
+                                         (uint16_t)simParseNumber(argv[1])) :
+                         NULL;
+    bool ok = true;
+
+    if ((cmd == "slave") && (argc >= 4)) {
+      simBusSlave newSlave;
+      newSlave.position      = (uint16_t)simParseNumber(argv[1]);
+      newSlave.vendorId      = (uint32_t)simParseNumber(argv[2]);
+      newSlave.productCode   = (uint32_t)simParseNumber(argv[3]);
+      newSlave.revision      = argc > 4 ? (uint32_t)simParseNumber(argv[4]) : 0;
+      newSlave.serial        = argc > 5 ? (uint32_t)simParseNumber(argv[5]) : 0;
+      newSlave.alias         = argc > 6 ? (uint16_t)simParseNumber(argv[6]) : 0;
+      newSlave.offlineStart  = 0;
+      newSlave.offlineCycles = 0;
+      master->bus.push_back(newSlave);
+    } else if ((cmd == "name") && slave && (argc >= 3)) {
+      slave->name = argv[2];
+    } else if ((cmd == "sync") && slave && (argc >= 4)) {
+      simFileSync(slave, (uint8_t)simParseNumber(argv[2]))->dir =
+        strcmp(argv[3], "out") == 0 ? EC_DIR_OUTPUT : EC_DIR_INPUT;
+    } else if ((cmd == "pdo") && slave && (argc >= 4)) {
+      simPdo pdo;
+      pdo.index = (uint16_t)simParseNumber(argv[3]);
+      simFileSync(slave, (uint8_t)simParseNumber(argv[2]))->pdos.push_back(pdo);
+    } else if ((cmd == "entry") && slave && (argc >= 6)) {
+      simPdo *pdo = simFilePdo(slave, (uint16_t)simParseNumber(argv[2]));
+      ok = pdo != NULL;
+
+      if (pdo) {
+        simEntry entry;
+        entry.index    = (uint16_t)simParseNumber(argv[3]);
+        entry.subIndex = (uint8_t)simParseNumber(argv[4]);
+        entry.bits     = (uint8_t)simParseNumber(argv[5]);
+        pdo->entries.push_back(entry);
+      }
+    } else if ((cmd == "sdo") && slave && (argc >= 6)) {
+      size_t   size  = (size_t)simParseNumber(argv[4]);
+      uint64_t value = simParseNumber(argv[5]);
+      std::vector<uint8_t> data(size);
+
+      for (size_t i = 0; i < size; i++) {
+        data[i] = i < 8 ? (uint8_t)(value >> (8 * i)) : 0;
+      }
+      slave->sdos[SIM_SDO_KEY(simParseNumber(argv[2]),
+                              simParseNumber(argv[3]))] = data;
+    } else if ((cmd == "input") && (argc >= 5)) {
+      simValue input;
+      input.position = (uint16_t)simParseNumber(argv[1]);
+      input.index    = (uint16_t)simParseNumber(argv[2]);
+      input.subIndex = (uint8_t)simParseNumber(argv[3]);
+      input.value    = simParseNumber(argv[4]);
+      master->inputs.push_back(input);
+    } else if ((cmd == "loopback") && (argc >= 7)) {
+      simLoopback loopback;
+      loopback.outPosition = (uint16_t)simParseNumber(argv[1]);
+      loopback.outIndex    = (uint16_t)simParseNumber(argv[2]);
+      loopback.outSubIndex = (uint8_t)simParseNumber(argv[3]);
+      loopback.inPosition  = (uint16_t)simParseNumber(argv[4]);
+      loopback.inIndex     = (uint16_t)simParseNumber(argv[5]);
+      loopback.inSubIndex  = (uint8_t)simParseNumber(argv[6]);
+      master->loopbacks.push_back(loopback);
+    } else if ((cmd == "autoslaves") && (argc >= 2)) {
+      master->autoSlaves = simParseNumber(argv[1]) != 0;
+    } else if ((cmd == "sdo_autocreate") && (argc >= 2)) {
+      master->sdoAutoCreate = simParseNumber(argv[1]) != 0;
+    } else if ((cmd == "op_delay") && (argc >= 2)) {
+      master->opDelay = (int)simParseNumber(argv[1]);
+    } else if ((cmd == "wkc_fail") && (argc >= 2)) {
+      master->wkcFail = atof(argv[1]);
+    } else if ((cmd == "latency_us") && (argc >= 3)) {
+      master->latencyMinUs = (int)simParseNumber(argv[1]);
+      master->latencyMaxUs = (int)simParseNumber(argv[2]);
+    } else if ((cmd == "link_down") && (argc >= 3)) {
+      master->linkDownStart  = (int64_t)simParseNumber(argv[1]);
+      master->linkDownCycles = (int64_t)simParseNumber(argv[2]);
+    } else if ((cmd == "slave_offline") && slave && (argc >= 4)) {
+      slave->offlineStart  = (int64_t)simParseNumber(argv[2]);
+      slave->offlineCycles = (int64_t)simParseNumber(argv[3]);
+    } else if ((cmd == "sdo_delay") && (argc >= 2)) {
+      master->sdoDelay = (int)simParseNumber(argv[1]);
+    } else if ((cmd == "sdo_fail") && (argc >= 2)) {
+      master->sdoFail = atof(argv[1]);
+    } else if ((cmd == "seed") && (argc >= 2)) {
+      master->rngState = simParseNumber(argv[1]) | 1;
+    } else if ((cmd == "dc_drift_ppm") && (argc >= 2)) {
+      master->dcDriftPpm = atof(argv[1]);
+    } else {
+      ok = false;
+    }
+
+    if (!ok) {
+      fprintf(stderr, "ecrtSim: %s:%d: Invalid line ignored.\n",
+              fileName, lineNumber);
+    }
+  }
+  fclose(file);
+  return 0;
+}
+
+/* Master */
+
+ec_master_t* ecrt_request_master(unsigned int master_index) {
+  ec_master_t *master = new ec_master_t();
+
+  master->index           = master_index;
+  pthread_mutex_init(&master->lock, NULL);
+  master->activated       = false;
+  master->cycle           = 0;
+  master->opCycle         = 0;
+  master->appTime         = 0;
+  master->rngState        = 1;
+  master->autoSlaves      = false;
+  master->sdoAutoCreate   = false;
+  master->opDelay         = 10;
+  master->wkcFail         = 0;
+  master->latencyMinUs    = 0;
+  master->latencyMaxUs    = 0;
+  master->linkDownStart   = 0;
+  master->linkDownCycles  = 0;
+  master->sdoDelay        = 2;
+  master->sdoFail         = 0;
+  master->dcDriftPpm      = 0;
+  master->dcSyncPending   = false;
+  master->dcValid         = false;
+  master->dcOffsetNs      = 0;
+  master->dcRefTime       = 0;
+  master->sends           = 0;
+  master->refClockSyncs   = 0;
+  master->slaveClockSyncs = 0;
+  master->sdoTransfers    = 0;
+  master->sdoAborts       = 0;
+  master->maxLatencyNs    = 0;
+
+  const char *fileName = getenv(SIM_CFG_ENV);
+
+  if (fileName && (strlen(fileName) > 0)) {
+    simLoadConfig(master, fileName);
+  }
+  fprintf(stderr, "ecrtSim: Simulated master %u with %d slaves.\n",
+          master_index, (int)master->bus.size());
+  return master;
+}
+
+void ecrt_release_master(ec_master_t *master) {
+  if (!master) {
+    return;
+  }
+
+  fprintf(stderr,
+          "ecrtSim: Master %u: cycles %lld, sends %llu, ref clock syncs %llu, "
+          "slave clock syncs %llu, sdo transfers %llu, sdo aborts %llu, "
+          "max injected latency %lld ns.\n",
+          master->index,
+          (long long)master->cycle,
+          (unsigned long long)master->sends,
+          (unsigned long long)master->refClockSyncs,
+          (unsigned long long)master->slaveClockSyncs,
+          (unsigned long long)master->sdoTransfers,
+          (unsigned long long)master->sdoAborts,
+          (long long)master->maxLatencyNs);
+
+  for (size_t i = 0; i < master->domains.size(); i++) {
+    ec_domain_t *domain = master->domains[i];
+    fprintf(stderr,
+            "ecrtSim: Domain %d: size %d, expected wc %d, wc faults %llu.\n",
+            (int)i,
+            (int)domain->size,
+            domain->expectedWc,
+            (unsigned long long)domain->wcFaults);
+    free(domain->data);
+    delete domain;
+  }
+
+  for (size_t i = 0; i < master->configs.size(); i++) {
+    for (size_t j = 0; j < master->configs[i]->requests.size(); j++) {
+      delete master->configs[i]->requests[j];
+    }
+    delete master->configs[i];
+  }
+  pthread_mutex_destroy(&master->lock);
+  delete master;
+}
+
+ec_domain_t* ecrt_master_create_domain(ec_master_t *master) {
+  if (master->activated) {
+    return NULL;
+  }
+  ec_domain_t *domain = new ec_domain_t();
+  domain->master     = master;
+  domain->size       = 0;
+  domain->data       = NULL;
+  domain->wc         = 0;
+  domain->expectedWc = 0;
+  domain->wcState    = EC_WC_ZERO;
+  domain->wcFaults   = 0;
+  master->domains.push_back(domain);
+  return domain;
+}
+
+ec_slave_config_t* ecrt_master_slave_config(ec_master_t *master,
+                                            uint16_t     alias,
+                                            uint16_t     position,
+                                            uint32_t     vendor_id,
+                                            uint32_t     product_code) {
+  ec_slave_config_t *sc = simFindConfig(master, position);
+
+  if (sc) {
+    // Same position must be configured with same identity
+    if ((sc->vendorId != vendor_id) || (sc->productCode != product_code)) {
+      return NULL;
+    }
+    return sc;
+  }
+
+  if (master->activated) {
+    return NULL;
+  }
+
+  if (master->autoSlaves && !simFindBusSlave(master, position)) {
+    simBusSlave slave;
+    slave.position      = position;
+    slave.alias         = alias;
+    slave.vendorId      = vendor_id;
+    slave.productCode   = product_code;
+    slave.revision      = 0;
+    slave.serial        = 0;
+    slave.offlineStart  = 0;
+    slave.offlineCycles = 0;
+    master->bus.push_back(slave);
+  }
+
+  sc                   = new ec_slave_config_t();
+  sc->master           = master;
+  sc->alias            = alias;
+  sc->position         = position;
+  sc->vendorId         = vendor_id;
+  sc->productCode      = product_code;
+  sc->dcAssignActivate = 0;
+  sc->dcSync0Cycle     = 0;
+  master->configs.push_back(sc);
+  return sc;
+}
+
+int ecrt_master_select_reference_clock(ec_master_t       *master,
+                                       ec_slave_config_t *sc) {
+  (void)master;
+  (void)sc;
+  return 0;
+}
+
+int ecrt_master(ec_master_t *master, ec_master_info_t *master_info) {
+  memset(master_info, 0, sizeof(*master_info));
+  master_info->slave_count = (unsigned int)master->bus.size();
+  master_info->link_up     = simLinkUp(master);
+  master_info->scan_busy   = 0;
+  master_info->app_time    = master->appTime;
+  return 0;
+}
+
+int ecrt_master_get_slave(ec_master_t     *master,
+                          uint16_t         slave_position,
+                          ec_slave_info_t *slave_info) {
+  pthread_mutex_lock(&master->lock);
+  simBusSlave *slave = simFindBusSlave(master, slave_position);
+
+  if (!slave) {
+    pthread_mutex_unlock(&master->lock);
+    return -ENOENT;
+  }
+  memset(slave_info, 0, sizeof(*slave_info));
+  slave_info->position        = slave->position;
+  slave_info->vendor_id       = slave->vendorId;
+  slave_info->product_code    = slave->productCode;
+  slave_info->revision_number = slave->revision;
+  slave_info->serial_number   = slave->serial;
+  slave_info->alias           = slave->alias;
+  slave_info->al_state        = simSlaveOnline(master, slave) ?
+                                simSlaveAlState(master) : 0;
+  slave_info->sync_count      = (uint8_t)simBusLayout(master, slave).size();
+  slave_info->sdo_count       = (uint16_t)slave->sdos.size();
+  strncpy(slave_info->name, slave->name.c_str(), sizeof(slave_info->name) - 1);
+  pthread_mutex_unlock(&master->lock);
+  return 0;
+}
+
+int ecrt_master_get_sync_manager(ec_master_t    *master,
+                                 uint16_t        slave_position,
+                                 uint8_t         sync_index,
+                                 ec_sync_info_t *sync) {
+  simBusSlave *slave = simFindBusSlave(master, slave_position);
+
+  if (!slave) {
+    return -ENOENT;
+  }
+  simLayout layout = simBusLayout(master, slave);
+
+  if (sync_index >= layout.size()) {
+    return -ENOENT;
+  }
+  memset(sync, 0, sizeof(*sync));
+  sync->index         = layout[sync_index].index;
+  sync->dir           = layout[sync_index].dir;
+  sync->n_pdos        = (unsigned int)layout[sync_index].pdos.size();
+  sync->pdos          = NULL;
+  sync->watchdog_mode = EC_WD_DEFAULT;
+  return 0;
+}
+
+int ecrt_master_get_pdo(ec_master_t   *master,
+                        uint16_t       slave_position,
+                        uint8_t        sync_index,
+                        uint16_t       pos,
+                        ec_pdo_info_t *pdo) {
+  simBusSlave *slave = simFindBusSlave(master, slave_position);
+
+  if (!slave) {
+    return -ENOENT;
+  }
+  simLayout layout = simBusLayout(master, slave);
+
+  if ((sync_index >= layout.size()) ||
+      (pos >= layout[sync_index].pdos.size())) {
+    return -ENOENT;
+  }
+  pdo->index     = layout[sync_index].pdos[pos].index;
+  pdo->n_entries = (unsigned int)layout[sync_index].pdos[pos].entries.size();
+  pdo->entries   = NULL;
+  return 0;
+}
+
+int ecrt_master_get_pdo_entry(ec_master_t         *master,
+                              uint16_t             slave_position,
+                              uint8_t              sync_index,
+                              uint16_t             pdo_pos,
+                              uint16_t             entry_pos,
+                              ec_pdo_entry_info_t *entry) {
+  simBusSlave *slave = simFindBusSlave(master, slave_position);
+
+  if (!slave) {
+    return -ENOENT;
+  }
+  simLayout layout = simBusLayout(master, slave);
+
+  if ((sync_index >= layout.size()) ||
+      (pdo_pos >= layout[sync_index].pdos.size()) ||
+      (entry_pos >= layout[sync_index].pdos[pdo_pos].entries.size())) {
+    return -ENOENT;
+  }
+  const simEntry& simEntry = layout[sync_index].pdos[pdo_pos].entries[entry_pos];
+  entry->index      = simEntry.index;
+  entry->subindex   = simEntry.subIndex;
+  entry->bit_length = simEntry.bits;
+  return 0;
+}
+
+// Returns true if the transfer is aborted (injected failure)
+static bool simSdoFail(ec_master_t *master) {
+  master->sdoTransfers++;
+
+  if ((master->sdoFail > 0) && (simRandom(master) < master->sdoFail)) {
+    master->sdoAborts++;
+    return true;
+  }
+  return false;
+}
+
+int ecrt_master_sdo_download(ec_master_t        *master,
+                             uint16_t            slave_position,
+                             uint16_t            index,
+                             uint8_t             subindex,
+                             SIM_CONST uint8_t *data,
+                             size_t              data_size,
+                             uint32_t           *abort_code) {
+  pthread_mutex_lock(&master->lock);
+  simBusSlave *slave = simFindBusSlave(master, slave_position);
+
+  if (!simSlaveOnline(master, slave)) {
+    pthread_mutex_unlock(&master->lock);
+    return -EIO;
+  }
+
+  if (simSdoFail(master)) {
+    *abort_code = SIM_SDO_ABORT_GENERAL;
+    pthread_mutex_unlock(&master->lock);
+    return -EIO;
+  }
+  slave->sdos[SIM_SDO_KEY(index, subindex)].assign(data, data + data_size);
+  pthread_mutex_unlock(&master->lock);
+  return 0;
+}
+
+static int simUpload(ec_master_t   *master,
+                     simDictionary *dictionary,
+                     uint32_t       key,
+                     uint8_t       *target,
+                     size_t         target_size,
+                     size_t        *result_size) {
+  simDictionary::iterator it = dictionary->find(key);
+
+  if (it == dictionary->end()) {
+    if (!master->sdoAutoCreate) {
+      return -ENOENT;
+    }
+    size_t size = target_size < 4 ? target_size : 4;
+    (*dictionary)[key].assign(size, 0);
+    it = dictionary->find(key);
+  }
+
+  size_t size = it->second.size() < target_size ? it->second.size() :
+                target_size;
+
+  if (size) {
+    memcpy(target, &it->second[0], size);
+  }
+  *result_size = size;
+  return 0;
+}
+
+int ecrt_master_sdo_upload(ec_master_t *master,
+                           uint16_t     slave_position,
+                           uint16_t     index,
+                           uint8_t      subindex,
+                           uint8_t     *target,
+                           size_t       target_size,
+                           size_t      *result_size,
+                           uint32_t    *abort_code) {
+  pthread_mutex_lock(&master->lock);
+  simBusSlave *slave = simFindBusSlave(master, slave_position);
+
+  if (!simSlaveOnline(master, slave)) {
+    pthread_mutex_unlock(&master->lock);
+    return -EIO;
+  }
+
+  if (simSdoFail(master)) {
+    *abort_code = SIM_SDO_ABORT_GENERAL;
+    pthread_mutex_unlock(&master->lock);
+    return -EIO;
+  }
+
+  if (simUpload(master, &slave->sdos, SIM_SDO_KEY(index, subindex), target,
+                target_size, result_size)) {
+    *abort_code = SIM_SDO_ABORT_NOT_EXIST;
+    pthread_mutex_unlock(&master->lock);
+    return -EIO;
+  }
+  pthread_mutex_unlock(&master->lock);
+  return 0;
+}
+
+int ecrt_master_write_idn(ec_master_t        *master,
+                          uint16_t            slave_position,
+                          uint8_t             drive_no,
+                          uint16_t            idn,
+                          SIM_CONST uint8_t *data,
+                          size_t              data_size,
+                          uint16_t           *error_code) {
+  pthread_mutex_lock(&master->lock);
+  simBusSlave *slave = simFindBusSlave(master, slave_position);
+
+  if (!simSlaveOnline(master, slave)) {
+    pthread_mutex_unlock(&master->lock);
+    return -EIO;
+  }
+  *error_code = 0;
+  slave->idns[SIM_SDO_KEY(idn, drive_no)].assign(data, data + data_size);
+  pthread_mutex_unlock(&master->lock);
+  return 0;
+}
+
+int ecrt_master_read_idn(ec_master_t *master,
+                         uint16_t     slave_position,
+                         uint8_t      drive_no,
+                         uint16_t     idn,
+                         uint8_t     *target,
+                         size_t       target_size,
+                         size_t      *result_size,
+                         uint16_t    *error_code) {
+  pthread_mutex_lock(&master->lock);
+  simBusSlave *slave = simFindBusSlave(master, slave_position);
+
+  if (!simSlaveOnline(master, slave)) {
+    pthread_mutex_unlock(&master->lock);
+    return -EIO;
+  }
+  *error_code = 0;
+  int errorCode = simUpload(master, &slave->idns, SIM_SDO_KEY(idn, drive_no),
+                            target, target_size, result_size);
+  pthread_mutex_unlock(&master->lock);
+  return errorCode ? -EIO : 0;
+}
+
+int ecrt_master_activate(ec_master_t *master) {
+  if (master->activated) {
+    return -EBUSY;
+  }
+
+  for (size_t d = 0; d < master->domains.size(); d++) {
+    ec_domain_t *domain = master->domains[d];
+    domain->data = (uint8_t *)calloc(domain->size ? domain->size : 1, 1);
+
+    if (!domain->data) {
+      return -ENOMEM;
+    }
+
+    // LRW: +2 for slaves with outputs, +1 with inputs
+    std::map<ec_slave_config_t *, int> wc;
+
+    for (size_t i = 0; i < domain->blocks.size(); i++) {
+      wc[domain->blocks[i].sc] |= domain->blocks[i].output ? 2 : 1;
+    }
+    domain->expectedWc = 0;
+
+    for (std::map<ec_slave_config_t *, int>::iterator it = wc.begin();
+         it != wc.end(); ++it) {
+      domain->expectedWc += (it->second & 2) + (it->second & 1);
+    }
+  }
+
+  // Startup sdos are written to the slaves
+  for (size_t i = 0; i < master->configs.size(); i++) {
+    ec_slave_config_t *sc    = master->configs[i];
+    simBusSlave       *slave = simFindBusSlave(master, sc->position);
+
+    for (size_t j = 0; slave && j < sc->sdos.size(); j++) {
+      slave->sdos[sc->sdos[j].first] = sc->sdos[j].second;
+    }
+  }
+
+  // Resolve constant inputs and loopbacks
+  for (size_t i = 0; i < master->inputs.size(); i++) {
+    simCopy   copy;
+    simValue& input = master->inputs[i];
+    copy.outDomain = NULL;
+    copy.value     = input.value;
+
+    if (simFindRegEntry(master, input.position, input.index, input.subIndex,
+                        &copy.inDomain, &copy.in)) {
+      master->copies.push_back(copy);
+    } else {
+      fprintf(stderr,
+              "ecrtSim: Input %d/0x%x:%d not registered in a domain.\n",
+              input.position, input.index, input.subIndex);
+    }
+  }
+
+  for (size_t i = 0; i < master->loopbacks.size(); i++) {
+    simCopy      copy;
+    simLoopback& loopback = master->loopbacks[i];
+    copy.value = 0;
+
+    if (simFindRegEntry(master, loopback.outPosition, loopback.outIndex,
+                        loopback.outSubIndex, &copy.outDomain, &copy.out) &&
+        simFindRegEntry(master, loopback.inPosition, loopback.inIndex,
+                        loopback.inSubIndex, &copy.inDomain, &copy.in)) {
+      master->copies.push_back(copy);
+    } else {
+      fprintf(stderr,
+              "ecrtSim: Loopback %d/0x%x:%d -> %d/0x%x:%d not registered "
+              "in a domain.\n",
+              loopback.outPosition, loopback.outIndex, loopback.outSubIndex,
+              loopback.inPosition, loopback.inIndex, loopback.inSubIndex);
+    }
+  }
+
+  master->activated     = true;
+  master->opCycle       = master->cycle + master->opDelay;
+  master->dcSyncPending = true;
+  return 0;
+}
+
+SIM_RET ecrt_master_send(ec_master_t *master) {
+  master->sends++;
+
+  // Time when the frame passes the reference clock (read back next cycle)
+  if (master->activated) {
+    int64_t now     = simTimeNs();
+    int64_t dcLocal = now + (int64_t)(now * master->dcDriftPpm * 1e-6);
+
+    if (master->dcSyncPending) {
+      master->dcOffsetNs    = (int64_t)master->appTime - dcLocal;
+      master->dcSyncPending = false;
+      master->dcValid       = true;
+    }
+    master->dcRefTime = (uint32_t)(dcLocal + master->dcOffsetNs);
+  }
+  SIM_RETURN(0);
+}
+
+SIM_RET ecrt_master_receive(ec_master_t *master) {
+  if (master->latencyMaxUs > 0) {
+    int64_t start = simTimeNs();
+    int64_t delay = (int64_t)(master->latencyMinUs +
+                              simRandom(master) * (master->latencyMaxUs -
+                                                   master->latencyMinUs)) *
+                    1000;
+
+    // Busy wait (as a frame in flight)
+    while (simTimeNs() - start < delay) {}
+
+    if (delay > master->maxLatencyNs) {
+      master->maxLatencyNs = delay;
+    }
+  }
+
+  pthread_mutex_lock(&master->lock);
+  master->cycle++;
+
+  // Sdo requests
+  for (size_t i = 0; i < master->configs.size(); i++) {
+    ec_slave_config_t *sc    = master->configs[i];
+    simBusSlave       *slave = simFindBusSlave(master, sc->position);
+
+    for (size_t j = 0; j < sc->requests.size(); j++) {
+      ec_sdo_request_t *req = sc->requests[j];
+
+      if ((req->state != EC_REQUEST_BUSY) || (--req->countdown > 0)) {
+        continue;
+      }
+
+      if (!simSlaveOnline(master, slave) || simSdoFail(master)) {
+        req->state = EC_REQUEST_ERROR;
+        continue;
+      }
+      uint32_t key = SIM_SDO_KEY(req->index, req->subIndex);
+
+      if (req->write) {
+        slave->sdos[key] = req->data;
+        req->state       = EC_REQUEST_SUCCESS;
+      } else {
+        size_t size = 0;
+        req->state = simUpload(master, &slave->sdos, key, &req->data[0],
+                               req->data.size(), &size) ?
+                     EC_REQUEST_ERROR : EC_REQUEST_SUCCESS;
+      }
+    }
+  }
+  pthread_mutex_unlock(&master->lock);
+  SIM_RETURN(0);
+}
+
+SIM_RET ecrt_master_state(const ec_master_t *master,
+                          ec_master_state_t *state) {
+  unsigned int responding = 0;
+
+  for (size_t i = 0; i < master->bus.size(); i++) {
+    if (simSlaveOnline(master, &master->bus[i])) {
+      responding++;
+    }
+  }
+  memset(state, 0, sizeof(*state));
+  state->slaves_responding = responding;
+  state->al_states         = responding ? simSlaveAlState(master) : 0;
+  state->link_up           = simLinkUp(master);
+  SIM_RETURN(0);
+}
+
+SIM_RET ecrt_master_application_time(ec_master_t *master,
+                                     uint64_t     app_time) {
+  master->appTime = app_time;
+  SIM_RETURN(0);
+}
+
+SIM_RET ecrt_master_sync_reference_clock(ec_master_t *master) {
+  master->refClockSyncs++;
+  master->dcSyncPending = master->activated;
+  SIM_RETURN(0);
+}
+
+int ecrt_master_reference_clock_time(SIM_CONST ec_master_t *master,
+                                     uint32_t              *time) {
+  if (!master->dcValid) {
+    return -EIO;
+  }
+  *time = master->dcRefTime;
+  return 0;
+}
+
+SIM_RET ecrt_master_sync_slave_clocks(ec_master_t *master) {
+  master->slaveClockSyncs++;
+  SIM_RETURN(0);
+}
+
+SIM_RET ecrt_master_reset(ec_master_t *master) {
+  (void)master;
+  SIM_RETURN(0);
+}
+
+/* Slave configuration */
+
+int ecrt_slave_config_sync_manager(ec_slave_config_t *sc,
+                                   uint8_t            sync_index,
+                                   ec_direction_t     direction,
+                                   ec_watchdog_mode_t watchdog_mode) {
+  (void)watchdog_mode;
+  sc->dirs[sync_index] = direction;
+  return 0;
+}
+
+SIM_RET ecrt_slave_config_watchdog(ec_slave_config_t *sc,
+                                   uint16_t           watchdog_divider,
+                                   uint16_t           watchdog_intervals) {
+  (void)sc;
+  (void)watchdog_divider;
+  (void)watchdog_intervals;
+  SIM_RETURN(0);
+}
+
+int ecrt_slave_config_pdo_assign_add(ec_slave_config_t *sc,
+                                     uint8_t            sync_index,
+                                     uint16_t           index) {
+  sc->assigns[sync_index].push_back(index);
+  return 0;
+}
+
+SIM_RET ecrt_slave_config_pdo_assign_clear(ec_slave_config_t *sc,
+                                           uint8_t            sync_index) {
+  sc->assigns[sync_index].clear();
+  SIM_RETURN(0);
+}
+
+int ecrt_slave_config_pdo_mapping_add(ec_slave_config_t *sc,
+                                      uint16_t           pdo_index,
+                                      uint16_t           entry_index,
+                                      uint8_t            entry_subindex,
+                                      uint8_t            entry_bit_length) {
+  simEntry entry;
+
+  entry.index    = entry_index;
+  entry.subIndex = entry_subindex;
+  entry.bits     = entry_bit_length;
+  sc->mappings[pdo_index].push_back(entry);
+  return 0;
+}
+
+SIM_RET ecrt_slave_config_pdo_mapping_clear(ec_slave_config_t *sc,
+                                            uint16_t           pdo_index) {
+  sc->mappings[pdo_index].clear();
+  SIM_RETURN(0);
+}
+
+int ecrt_slave_config_reg_pdo_entry(ec_slave_config_t *sc,
+                                    uint16_t           entry_index,
+                                    uint8_t            entry_subindex,
+                                    ec_domain_t       *domain,
+                                    unsigned int      *bit_position) {
+  simLayout layout = simConfigLayout(sc);
+
+  for (size_t s = 0; s < layout.size(); s++) {
+    unsigned int bitOffset = 0;
+    unsigned int syncBits  = 0;
+    int          found     = -1;
+    unsigned int bits      = 0;
+
+    for (size_t p = 0; p < layout[s].pdos.size(); p++) {
+      std::vector<simEntry>& entries = layout[s].pdos[p].entries;
+
+      for (size_t e = 0; e < entries.size(); e++) {
+        if ((found < 0) && (entries[e].index == entry_index) &&
+            (entries[e].subIndex == entry_subindex)) {
+          found     = 1;
+          bitOffset = syncBits;
+          bits      = entries[e].bits;
+        }
+        syncBits += entries[e].bits;
+      }
+    }
+
+    if (found < 0) {
+      continue;
+    }
+
+    // Process data of a sync manager is one block in the domain
+    simBlock *block = NULL;
+
+    for (size_t b = 0; b < domain->blocks.size(); b++) {
+      if ((domain->blocks[b].sc == sc) &&
+          (domain->blocks[b].syncIndex == layout[s].index)) {
+        block = &domain->blocks[b];
+      }
+    }
+
+    if (!block) {
+      simBlock newBlock;
+      newBlock.sc        = sc;
+      newBlock.syncIndex = layout[s].index;
+      newBlock.offset    = domain->size;
+      newBlock.size      = (syncBits + 7) / 8;
+      newBlock.output    = layout[s].dir == EC_DIR_OUTPUT;
+      domain->size      += newBlock.size;
+      domain->blocks.push_back(newBlock);
+      block = &domain->blocks.back();
+    }
+
+    if (!bit_position && (bitOffset % 8)) {
+      return -EINVAL;
+    }
+
+    if (bit_position) {
+      *bit_position = bitOffset % 8;
+    }
+
+    simRegEntry entry;
+    entry.sc       = sc;
+    entry.index    = entry_index;
+    entry.subIndex = entry_subindex;
+    entry.offset   = block->offset + bitOffset / 8;
+    entry.bitPos   = bitOffset % 8;
+    entry.bits     = bits;
+    domain->entries.push_back(entry);
+    return (int)entry.offset;
+  }
+  return -ENOENT;
+}
+
+SIM_RET ecrt_slave_config_dc(ec_slave_config_t *sc,
+                             uint16_t           assign_activate,
+                             uint32_t           sync0_cycle,
+                             int32_t            sync0_shift,
+                             uint32_t           sync1_cycle,
+                             int32_t            sync1_shift) {
+  (void)sync0_shift;
+  (void)sync1_cycle;
+  (void)sync1_shift;
+  sc->dcAssignActivate = assign_activate;
+  sc->dcSync0Cycle     = sync0_cycle;
+  SIM_RETURN(0);
+}
+
+int ecrt_slave_config_sdo(ec_slave_config_t *sc,
+                          uint16_t           index,
+                          uint8_t            subindex,
+                          const uint8_t     *data,
+                          size_t             size) {
+  sc->sdos.push_back(std::make_pair(SIM_SDO_KEY(index, subindex),
+                                    std::vector<uint8_t>(data, data + size)));
+  return 0;
+}
+
+int ecrt_slave_config_sdo8(ec_slave_config_t *sc,
+                           uint16_t           sdo_index,
+                           uint8_t            sdo_subindex,
+                           uint8_t            value) {
+  return ecrt_slave_config_sdo(sc, sdo_index, sdo_subindex, &value, 1);
+}
+
+int ecrt_slave_config_sdo16(ec_slave_config_t *sc,
+                            uint16_t           sdo_index,
+                            uint8_t            sdo_subindex,
+                            uint16_t           value) {
+  uint8_t data[2];
+
+  EC_WRITE_U16(data, value);
+  return ecrt_slave_config_sdo(sc, sdo_index, sdo_subindex, data, 2);
+}
+
+int ecrt_slave_config_sdo32(ec_slave_config_t *sc,
+                            uint16_t           sdo_index,
+                            uint8_t            sdo_subindex,
+                            uint32_t           value) {
+  uint8_t data[4];
+
+  EC_WRITE_U32(data, value);
+  return ecrt_slave_config_sdo(sc, sdo_index, sdo_subindex, data, 4);
+}
+
+int ecrt_slave_config_complete_sdo(ec_slave_config_t *sc,
+                                   uint16_t           index,
+                                   const uint8_t     *data,
+                                   size_t             size) {
+  return ecrt_slave_config_sdo(sc, index, 0, data, size);
+}
+
+ec_sdo_request_t* ecrt_slave_config_create_sdo_request(ec_slave_config_t *sc,
+                                                       uint16_t index,
+                                                       uint8_t  subindex,
+                                                       size_t   size) {
+  ec_sdo_request_t *req = new ec_sdo_request_t();
+
+  req->sc        = sc;
+  req->index     = index;
+  req->subIndex  = subindex;
+  req->data.assign(size ? size : 1, 0);
+  req->timeoutMs = 0;
+  req->state     = EC_REQUEST_UNUSED;
+  req->countdown = 0;
+  req->write     = false;
+  pthread_mutex_lock(&sc->master->lock);
+  sc->requests.push_back(req);
+  pthread_mutex_unlock(&sc->master->lock);
+  return req;
+}
+
+SIM_RET ecrt_slave_config_state(const ec_slave_config_t *sc,
+                                ec_slave_config_state_t *state) {
+  bool online = simConfigMatches(sc->master, (ec_slave_config_t *)sc);
+
+  memset(state, 0, sizeof(*state));
+  state->online      = online;
+  state->al_state    = online ? simSlaveAlState(sc->master) : 0;
+  state->operational = online && state->al_state == SIM_AL_OP;
+  SIM_RETURN(0);
+}
+
+int ecrt_slave_config_idn(ec_slave_config_t *sc,
+                          uint8_t            drive_no,
+                          uint16_t           idn,
+                          ec_al_state_t      state,
+                          const uint8_t     *data,
+                          size_t             size) {
+  (void)state;
+  simBusSlave *slave = simFindBusSlave(sc->master, sc->position);
+
+  if (slave) {
+    slave->idns[SIM_SDO_KEY(idn, drive_no)].assign(data, data + size);
+  }
+  return 0;
+}
+
+/* Domain */
+
+size_t ecrt_domain_size(const ec_domain_t *domain) {
+  return domain->size;
+}
+
+uint8_t* ecrt_domain_data(ec_domain_t *domain) {
+  return domain->data;
+}
+
+SIM_RET ecrt_domain_process(ec_domain_t *domain) {
+  ec_master_t *master = domain->master;
+  bool op             = simSlaveAlState(master) == SIM_AL_OP;
+  std::map<ec_slave_config_t *, int> wc;
+
+  for (size_t i = 0; i < domain->blocks.size(); i++) {
+    simBlock& block = domain->blocks[i];
+
+    // Outputs are not processed before OP
+    if (simConfigMatches(master, block.sc) && (!block.output || op)) {
+      wc[block.sc] |= block.output ? 2 : 1;
+    }
+  }
+  int counter = 0;
+
+  for (std::map<ec_slave_config_t *, int>::iterator it = wc.begin();
+       it != wc.end(); ++it) {
+    counter += (it->second & 2) + (it->second & 1);
+  }
+
+  if ((counter > 0) && (master->wkcFail > 0) &&
+      (simRandom(master) < master->wkcFail)) {
+    counter--;
+    domain->wcFaults++;
+  }
+  domain->wc      = (uint16_t)counter;
+  domain->wcState = counter == 0 ? EC_WC_ZERO :
+                    (counter == domain->expectedWc ? EC_WC_COMPLETE :
+                     EC_WC_INCOMPLETE);
+
+  // Inputs of online slaves
+  for (size_t i = 0; i < master->copies.size(); i++) {
+    simCopy& copy = master->copies[i];
+
+    if ((copy.inDomain != domain) || !simConfigMatches(master, copy.in.sc)) {
+      continue;
+    }
+    uint64_t value = copy.value;
+
+    if (copy.outDomain) {
+      value = simReadBits(copy.outDomain->data, copy.out.offset,
+                          copy.out.bitPos, copy.out.bits);
+    }
+    simWriteBits(domain->data, copy.in.offset, copy.in.bitPos, copy.in.bits,
+                 value);
+  }
+  SIM_RETURN(0);
+}
+
+SIM_RET ecrt_domain_queue(ec_domain_t *domain) {
+  (void)domain;
+  SIM_RETURN(0);
+}
+
+SIM_RET ecrt_domain_state(const ec_domain_t *domain,
+                          ec_domain_state_t *state) {
+  memset(state, 0, sizeof(*state));
+  state->working_counter = domain->wc;
+  state->wc_state        = domain->wcState;
+  SIM_RETURN(0);
+}
+
+/* Sdo requests */
+
+SIM_RET ecrt_sdo_request_timeout(ec_sdo_request_t *req,
+                                 uint32_t          timeout) {
+  req->timeoutMs = timeout;
+  SIM_RETURN(0);
+}
+
+uint8_t* ecrt_sdo_request_data(ec_sdo_request_t *req) {
+  return &req->data[0];
+}
+
+ec_request_state_t ecrt_sdo_request_state(SIM_CONST ec_sdo_request_t *req) {
+  return req->state;
+}
+
+static void simRequestStart(ec_sdo_request_t *req, bool write) {
+  ec_master_t *master = req->sc->master;
+
+  pthread_mutex_lock(&master->lock);
+  req->write     = write;
+  req->countdown = master->sdoDelay > 0 ? master->sdoDelay : 1;
+  req->state     = EC_REQUEST_BUSY;
+  pthread_mutex_unlock(&master->lock);
+}
+
+SIM_RET ecrt_sdo_request_write(ec_sdo_request_t *req) {
+  simRequestStart(req, true);
+  SIM_RETURN(0);
+}
+
+SIM_RET ecrt_sdo_request_read(ec_sdo_request_t *req) {
+  simRequestStart(req, false);
+  SIM_RETURN(0);
+}
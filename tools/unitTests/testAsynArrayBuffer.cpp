@@ -0,0 +1,147 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  testAsynArrayBuffer.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* ecmcAsynArrayBuffer: publish/fetch hand over, latest data wins,
+* decimation and a concurrent writer/reader without torn buffers.
+*
+\*************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+#include <thread>
+#include <epicsAtomic.h>
+#include "ecmcAsynArrayBuffer.h"
+#include "unitTest.h"
+
+#define TEST_ELEMENTS 1024
+#define TEST_PUBLISHES 200000
+
+static void fill(ecmcAsynArrayBuffer *buf, uint32_t value) {
+  uint32_t *data = (uint32_t *)buf->getWriteBuffer();
+
+  for (int i = 0; i < TEST_ELEMENTS; i++) {
+    data[i] = value;
+  }
+}
+
+static void testHandOver() {
+  ecmcAsynArrayBuffer buf(TEST_ELEMENTS * sizeof(uint32_t), 0);
+  uint8_t *data  = NULL;
+  size_t   bytes = 0;
+
+  UNIT_CHECK(buf.getSize() == TEST_ELEMENTS * sizeof(uint32_t));
+  UNIT_CHECK(buf.getDecimation() == 1);
+  UNIT_CHECK(!buf.fetch(&data, &bytes));
+
+  fill(&buf, 1);
+  UNIT_CHECK(buf.publish(100, false));
+  UNIT_CHECK(buf.fetch(&data, &bytes));
+  UNIT_CHECK(bytes == 100);
+  UNIT_CHECK(((uint32_t *)data)[0] == 1);
+  UNIT_CHECK(data != buf.getWriteBuffer());
+  UNIT_CHECK(!buf.fetch(&data, &bytes));
+
+  // Latest publish wins, fetched buffer stays untouched by the writer
+  uint8_t *held = data;
+
+  fill(&buf, 2);
+  buf.publish(8, false);
+  fill(&buf, 3);
+  UNIT_CHECK(buf.getWriteBuffer() != held);
+  buf.publish(12, false);
+  UNIT_CHECK(buf.getWriteBuffer() != held);
+  UNIT_CHECK(((uint32_t *)held)[0] == 1);
+  UNIT_CHECK(buf.fetch(&data, &bytes));
+  UNIT_CHECK(bytes == 12);
+  UNIT_CHECK(((uint32_t *)data)[0] == 3);
+
+  // Clamped to buffer size
+  buf.publish(buf.getSize() + 1, false);
+  UNIT_CHECK(buf.fetch(&data, &bytes));
+  UNIT_CHECK(bytes == buf.getSize());
+
+  UNIT_CHECK(buf.getPublishedCount() == 4);
+  UNIT_CHECK(buf.getFetchedCount() == 3);
+}
+
+static void testDecimation() {
+  ecmcAsynArrayBuffer buf(64, 3);
+  uint8_t *data  = NULL;
+  size_t   bytes = 0;
+
+  UNIT_CHECK(buf.getDecimation() == 3);
+  UNIT_CHECK(!buf.publish(1, false));
+  UNIT_CHECK(!buf.fetch(&data, &bytes));
+  UNIT_CHECK(!buf.publish(2, false));
+  UNIT_CHECK(buf.publish(3, false));
+  UNIT_CHECK(buf.fetch(&data, &bytes));
+  UNIT_CHECK(bytes == 3);
+
+  // Forced publish flips and restarts the decimation
+  UNIT_CHECK(!buf.publish(4, false));
+  UNIT_CHECK(buf.publish(5, true));
+  UNIT_CHECK(!buf.publish(6, false));
+  UNIT_CHECK(!buf.publish(7, false));
+  UNIT_CHECK(buf.publish(8, false));
+  UNIT_CHECK(buf.getPublishedCount() == 3);
+}
+
+// Writer fills each buffer with its sequence number, the reader must never
+// see a mix of two publishes or an older one
+static void testConcurrent() {
+  ecmcAsynArrayBuffer buf(TEST_ELEMENTS * sizeof(uint32_t), 1);
+  int  done    = 0;
+  bool torn    = false;
+  bool ordered = true;
+  int  fetched = 0;
+
+  std::thread reader([&]() {
+    uint32_t last = 0;
+    uint8_t *data = NULL;
+    size_t   bytes = 0;
+
+    for (;;) {
+      int finished = epicsAtomicGetIntT(&done);
+
+      if (buf.fetch(&data, &bytes)) {
+        uint32_t *values = (uint32_t *)data;
+
+        for (int i = 1; i < TEST_ELEMENTS; i++) {
+          torn |= values[i] != values[0];
+        }
+        ordered &= values[0] > last;
+        last     = values[0];
+        fetched++;
+      } else if (finished) {
+        break;
+      }
+    }
+    ordered &= last == TEST_PUBLISHES;
+  });
+
+  for (uint32_t seq = 1; seq <= TEST_PUBLISHES; seq++) {
+    fill(&buf, seq);
+    buf.publish(buf.getSize(), false);
+  }
+  epicsAtomicSetIntT(&done, 1);
+  reader.join();
+
+  UNIT_CHECK(!torn);
+  UNIT_CHECK(ordered);
+  UNIT_CHECK(fetched > 0);
+  UNIT_CHECK(buf.getFetchedCount() == (uint64_t)fetched);
+}
+
+int main() {
+  testHandOver();
+  testDecimation();
+  testConcurrent();
+  return unitTestResult("testAsynArrayBuffer");
+}
@@ -0,0 +1,234 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  testAxisGroupKinematics.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* ecmcAxisGroupKinematics: inverse/forward round trip of the linear,
+* gap/center, tripod and hexapod transforms and configuration errors.
+*
+\*************************************************************************/
+
+#include <math.h>
+#include "ecmcAxisGroupKinematics.h"
+#include "unitTest.h"
+
+// Round trip x -> q -> x, returns max error
+static double roundTrip(ecmcAxisGroupKinematics *kin, const double *x) {
+  double q[6], xBack[6];
+  double maxErr = 0;
+
+  kin->inverse(x, q);
+  kin->forward(q, xBack);
+
+  for (int i = 0; i < kin->getDof(); i++) {
+    maxErr = fmax(maxErr, fabs(xBack[i] - x[i]));
+  }
+  return maxErr;
+}
+
+static void testLinear() {
+  ecmcAxisGroupKinematics kin(ECMC_GRP_TRANSFORM_LINEAR);
+  const double a[9] = { 2, 1, 0, 0, 1, -1, 1, 0, 3 };
+  const double b[3] = { 0.5, -1, 2 };
+
+  for (int i = 0; i < 9; i++) {
+    kin.setParam(i, a[i]);
+  }
+
+  for (int i = 0; i < 3; i++) {
+    kin.setParam(9 + i, b[i]);
+  }
+  UNIT_CHECK(kin.init(3) == 0);
+
+  double x[3] = { 1, 2, 3 };
+  double q[3];
+
+  kin.inverse(x, q);
+  UNIT_CHECK_NEAR(q[0], 2 + 2 + 0.5, 1e-12);
+  UNIT_CHECK_NEAR(q[1], 2 - 3 - 1, 1e-12);
+  UNIT_CHECK_NEAR(q[2], 1 + 9 + 2, 1e-12);
+  UNIT_CHECK(roundTrip(&kin, x) < 1e-12);
+
+  const double x2[3] = { -10, 0.001, 1e3 };
+  UNIT_CHECK(roundTrip(&kin, x2) < 1e-9);
+
+  // Offset b is optional
+  ecmcAxisGroupKinematics noOffset(ECMC_GRP_TRANSFORM_LINEAR);
+
+  for (int i = 0; i < 4; i++) {
+    noOffset.setParam(i, i == 0 || i == 3 ? 2 : 0);
+  }
+  UNIT_CHECK(noOffset.init(2) == 0);
+  noOffset.inverse(x, q);
+  UNIT_CHECK_NEAR(q[0], 2, 1e-12);
+  UNIT_CHECK_NEAR(q[1], 4, 1e-12);
+}
+
+static void testGapCenter() {
+  ecmcAxisGroupKinematics kin(ECMC_GRP_TRANSFORM_GAP_CENTER);
+  const double x[2] = { 2, 1 };  // gap, center
+  double q[2];
+
+  UNIT_CHECK(kin.init(3) == ERROR_GRP_TRANSFORM_DOF_MISMATCH);
+  UNIT_CHECK(kin.init(2) == 0);
+  kin.inverse(x, q);
+  UNIT_CHECK_NEAR(q[0], 2, 1e-12);
+  UNIT_CHECK_NEAR(q[1], 0, 1e-12);
+  UNIT_CHECK(roundTrip(&kin, x) < 1e-12);
+}
+
+static void testErrors() {
+  ecmcAxisGroupKinematics invalid(7);
+  UNIT_CHECK(!invalid.isTypeValid());
+  UNIT_CHECK(invalid.init(1) == ERROR_GRP_TRANSFORM_TYPE_INVALID);
+
+  ecmcAxisGroupKinematics kin(ECMC_GRP_TRANSFORM_LINEAR);
+  UNIT_CHECK(kin.setParam(-1, 0) ==
+             ERROR_GRP_TRANSFORM_PARAM_INDEX_OUT_OF_RANGE);
+  UNIT_CHECK(kin.setSolver(0, 1e-6) == ERROR_GRP_TRANSFORM_SOLVER_INVALID);
+  UNIT_CHECK(kin.setSolver(5, 0) == ERROR_GRP_TRANSFORM_SOLVER_INVALID);
+  UNIT_CHECK(kin.init(0) == ERROR_GRP_TRANSFORM_DOF_MISMATCH);
+
+  kin.setParam(2, 1);
+  UNIT_CHECK(kin.init(2) == ERROR_GRP_TRANSFORM_PARAMS_MISSING);
+  UNIT_CHECK(kin.getRequiredParamCount() == 4);
+
+  // Rows linearly dependent
+  kin.setParam(0, 1);
+  kin.setParam(1, 2);
+  kin.setParam(2, 2);
+  kin.setParam(3, 4);
+  UNIT_CHECK(kin.init(2) == ERROR_GRP_TRANSFORM_SINGULAR);
+
+  ecmcAxisGroupKinematics tripod(ECMC_GRP_TRANSFORM_TRIPOD);
+  UNIT_CHECK(tripod.init(3) == ERROR_GRP_TRANSFORM_PARAMS_MISSING);
+}
+
+// Jacks on a circle (radius 0.5), pivot in the center, angles in mrad
+static void testTripod() {
+  ecmcAxisGroupKinematics kin(ECMC_GRP_TRANSFORM_TRIPOD);
+
+  for (int i = 0; i < 3; i++) {
+    double angle = 2 * M_PI * i / 3;
+    kin.setParam(i * 3, 0.5 * cos(angle));
+    kin.setParam(i * 3 + 1, 0.5 * sin(angle));
+    kin.setParam(i * 3 + 2, 0);
+  }
+  kin.setParam(12, 1e-3);
+
+  // Tolerance is in joint units (1um at 0.5m is 2e-3 mrad)
+  UNIT_CHECK(kin.setSolver(20, 1e-10) == 0);
+  UNIT_CHECK(kin.init(3) == 0);
+
+  double x[3] = { 0, 0, 0 };
+  double q[3];
+
+  kin.inverse(x, q);
+  UNIT_CHECK_NEAR(q[0], 0, 1e-12);
+  UNIT_CHECK_NEAR(q[1], 0, 1e-12);
+  UNIT_CHECK_NEAR(q[2], 0, 1e-12);
+
+  // Pure lift
+  x[0] = 0.01;
+  kin.inverse(x, q);
+  UNIT_CHECK_NEAR(q[0], 0.01, 1e-12);
+  UNIT_CHECK_NEAR(q[2], 0.01, 1e-12);
+
+  const double poses[4][3] = {
+    { 0.01,   2,   -1  },
+    { -0.02,  -5,  3   },
+    { 0.005,  10,  10  },
+    { 0,      0,   0   },
+  };
+
+  for (int p = 0; p < 4; p++) {
+    UNIT_CHECK(roundTrip(&kin, poses[p]) < 1e-4);
+    UNIT_CHECK(kin.getResidual() <= 1e-10);
+  }
+  UNIT_CHECK(kin.getFailCount() == 0);
+}
+
+// Platform anchors (radius 0.1, z 0.2) above base anchors (radius 0.15),
+// pivot in the platform center
+static void initHexapod(ecmcAxisGroupKinematics *kin) {
+  for (int i = 0; i < 6; i++) {
+    double pa = 2 * M_PI * (i / 2) / 3 + (i % 2 ? 0.3 : -0.3);
+    double ba = 2 * M_PI * ((i + 1) / 2) / 3 + (i % 2 ? -0.7 : 0.7) -
+                M_PI / 3;
+    kin->setParam(i * 3, 0.1 * cos(pa));
+    kin->setParam(i * 3 + 1, 0.1 * sin(pa));
+    kin->setParam(i * 3 + 2, 0.2);
+    kin->setParam(18 + i * 3, 0.15 * cos(ba));
+    kin->setParam(18 + i * 3 + 1, 0.15 * sin(ba));
+    kin->setParam(18 + i * 3 + 2, 0);
+  }
+  kin->setParam(36, 0);
+  kin->setParam(37, 0);
+  kin->setParam(38, 0.2);
+}
+
+static void testHexapod() {
+  ecmcAxisGroupKinematics kin(ECMC_GRP_TRANSFORM_HEXAPOD);
+
+  initHexapod(&kin);
+  UNIT_CHECK(kin.init(5) == ERROR_GRP_TRANSFORM_DOF_MISMATCH);
+  UNIT_CHECK(kin.init(6) == 0);
+
+  double x[6] = { 0, 0, 0, 0, 0, 0 };
+  double q[6];
+  double qMax = 0;
+
+  kin.inverse(x, q);
+
+  for (int i = 0; i < 6; i++) {
+    qMax = fmax(qMax, fabs(q[i]));
+  }
+  UNIT_CHECK(qMax < 1e-12);
+
+  // Warm started trajectory and a jump from home
+  int    fails  = 0;
+  double maxErr = 0;
+
+  for (int k = 0; k <= 100; k++) {
+    double t = k * 0.01;
+    const double pose[6] = {
+      0.005 * sin(2 * M_PI * t), 0.003 * cos(2 * M_PI * t), 0.002 * t,
+      0.02 * sin(2 * M_PI * t),  -0.01 * t,                 0.03 * t
+    };
+    maxErr = fmax(maxErr, roundTrip(&kin, pose));
+    fails += kin.getResidual() > ECMC_GRP_TRANSFORM_DEFAULT_TOL;
+  }
+  UNIT_CHECK(maxErr < 1e-4);
+  UNIT_CHECK(fails == 0);
+  UNIT_CHECK(kin.getFailCount() == 0);
+
+  ecmcAxisGroupKinematics cold(ECMC_GRP_TRANSFORM_HEXAPOD);
+  initHexapod(&cold);
+  UNIT_CHECK(cold.init(6) == 0);
+  const double jump[6] = { 0.01, -0.01, 0.005, 0.05, -0.05, 0.1 };
+  UNIT_CHECK(roundTrip(&cold, jump) < 1e-4);
+  UNIT_CHECK(cold.getIterations() > 0);
+  UNIT_CHECK(cold.getFailCount() == 0);
+
+  // Solver limited to one iteration from home: counted as failure
+  ecmcAxisGroupKinematics limited(ECMC_GRP_TRANSFORM_HEXAPOD);
+  initHexapod(&limited);
+  UNIT_CHECK(limited.setSolver(1, 1e-12) == 0);
+  UNIT_CHECK(limited.init(6) == 0);
+  roundTrip(&limited, jump);
+  UNIT_CHECK(limited.getFailCount() == 1);
+}
+
+int main() {
+  testLinear();
+  testGapCenter();
+  testErrors();
+  testTripod();
+  testHexapod();
+  return unitTestResult("testAxisGroupKinematics");
+}
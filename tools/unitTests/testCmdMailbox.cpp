@@ -0,0 +1,241 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  testCmdMailbox.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* ecmcCmdMailbox: ordering, payload copy, full/budget handling, wrap
+* around, concurrent producers and call() (result and timeout).
+*
+\*************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+#include <epicsAtomic.h>
+#include "ecmcCmdMailbox.h"
+#include "unitTest.h"
+
+#define TEST_PRODUCERS 4
+#define TEST_PRODUCER_CMDS 20000
+
+struct testLog {
+  std::vector<int> values;
+  std::vector<int> types;
+};
+
+static void logCmd(void *obj, uint8_t *data, size_t bytes, int type) {
+  testLog *log = (testLog *)obj;
+  int value    = -1;
+
+  if (bytes == sizeof(int)) {
+    memcpy(&value, data, sizeof(int));
+  }
+  log->values.push_back(value);
+  log->types.push_back(type);
+}
+
+static int postInt(ecmcCmdMailbox *mb, testLog *log, int value, int type) {
+  return mb->post(logCmd, log, (const uint8_t *)&value, sizeof(value), type);
+}
+
+static void testSize() {
+  ecmcCmdMailbox a(1), b(5), c(256), d(ECMC_CMD_MAILBOX_MAX_SIZE * 2);
+
+  UNIT_CHECK(a.getSize() == 2);
+  UNIT_CHECK(b.getSize() == 8);
+  UNIT_CHECK(c.getSize() == 256);
+  UNIT_CHECK(d.getSize() == ECMC_CMD_MAILBOX_MAX_SIZE);
+}
+
+static void testOrderAndPayload() {
+  ecmcCmdMailbox mb(16);
+  testLog log;
+  int     value = 1;
+
+  UNIT_CHECK(mb.post(logCmd, &log, (const uint8_t *)&value, sizeof(value),
+                     7) == 0);
+  value = 2;  // Payload is copied at post
+  UNIT_CHECK(postInt(&mb, &log, 3, 8) == 0);
+  UNIT_CHECK(mb.post(logCmd, &log, NULL, 0, 9) == 0);
+  UNIT_CHECK(mb.getPending() == 3);
+  UNIT_CHECK(log.values.empty());
+
+  UNIT_CHECK(mb.drainAll() == 3);
+  UNIT_CHECK(log.values.size() == 3);
+  UNIT_CHECK(log.values[0] == 1 && log.types[0] == 7);
+  UNIT_CHECK(log.values[1] == 3 && log.types[1] == 8);
+  UNIT_CHECK(log.values[2] == -1 && log.types[2] == 9);
+  UNIT_CHECK(mb.getPending() == 0);
+  UNIT_CHECK(mb.getPosted() == 3);
+  UNIT_CHECK(mb.getExecuted() == 3);
+  UNIT_CHECK(mb.drainAll() == 0);
+
+  uint8_t big[ECMC_CMD_MAILBOX_MAX_PAYLOAD + 1] = { 0 };
+  UNIT_CHECK(mb.post(logCmd, &log, big, sizeof(big), 0) ==
+             ERROR_CMD_MAILBOX_PAYLOAD_TO_LARGE);
+  UNIT_CHECK(mb.post(logCmd, &log, big, ECMC_CMD_MAILBOX_MAX_PAYLOAD, 0) ==
+             0);
+}
+
+static void testFullAndBudget() {
+  ecmcCmdMailbox mb(8);
+  testLog log;
+
+  for (int i = 0; i < 8; i++) {
+    UNIT_CHECK(postInt(&mb, &log, i, 0) == 0);
+  }
+  UNIT_CHECK(postInt(&mb, &log, 8, 0) == ERROR_CMD_MAILBOX_FULL);
+  UNIT_CHECK(mb.getRejected() == 1);
+  UNIT_CHECK(mb.getPending() == 8);
+
+  // Budget spent with commands left
+  UNIT_CHECK(mb.drain(3) == 3);
+  UNIT_CHECK(mb.getPending() == 5);
+  UNIT_CHECK(mb.getBudgetHits() == 1);
+  UNIT_CHECK(mb.getMaxDepth() == 8);
+
+  // Freed cells can be reused
+  UNIT_CHECK(postInt(&mb, &log, 8, 0) == 0);
+  UNIT_CHECK(mb.drain(100) == 6);
+  UNIT_CHECK(mb.getBudgetHits() == 1);
+
+  for (int i = 0; i < 9; i++) {
+    UNIT_CHECK(log.values[i] == i);
+  }
+
+  mb.setBudget(0);
+  UNIT_CHECK(mb.getBudget() == 1);
+}
+
+static void testWrapAround() {
+  ecmcCmdMailbox mb(4);
+  testLog log;
+  int     next = 0;
+  bool    ok   = true;
+
+  for (int round = 0; round < 1000; round++) {
+    int n = 1 + round % 4;
+
+    for (int i = 0; i < n; i++) {
+      ok &= postInt(&mb, &log, next++, 0) == 0;
+    }
+    ok &= mb.drain(n) == n;
+  }
+  UNIT_CHECK(ok);
+  UNIT_CHECK((int)log.values.size() == next);
+
+  for (int i = 0; ok && i < next; i++) {
+    ok = log.values[i] == i;
+  }
+  UNIT_CHECK(ok);
+}
+
+// Concurrent producers, values are producer * TEST_PRODUCER_CMDS + seq
+static void testProducers() {
+  ecmcCmdMailbox mb(64);
+  testLog log;
+  int     done = 0;
+  std::vector<std::thread> producers;
+
+  for (int p = 0; p < TEST_PRODUCERS; p++) {
+    producers.push_back(std::thread([&mb, &log, &done, p]() {
+      for (int i = 0; i < TEST_PRODUCER_CMDS; i++) {
+        while (postInt(&mb, &log, p * TEST_PRODUCER_CMDS + i, p)) {
+          std::this_thread::yield();
+        }
+      }
+      epicsAtomicIncrIntT(&done);
+    }));
+  }
+
+  while (epicsAtomicGetIntT(&done) < TEST_PRODUCERS || mb.getPending()) {
+    if (!mb.drain(16)) {
+      std::this_thread::yield();
+    }
+  }
+
+  for (size_t p = 0; p < producers.size(); p++) {
+    producers[p].join();
+  }
+
+  UNIT_CHECK(log.values.size() ==
+             (size_t)(TEST_PRODUCERS * TEST_PRODUCER_CMDS));
+
+  // Each producer in order, no loss, no duplicates
+  std::vector<int> nextSeq(TEST_PRODUCERS, 0);
+  bool ok = true;
+
+  for (size_t i = 0; i < log.values.size(); i++) {
+    int p = log.types[i];
+
+    ok &= log.values[i] == p * TEST_PRODUCER_CMDS + nextSeq[p];
+    nextSeq[p]++;
+  }
+  UNIT_CHECK(ok);
+  UNIT_CHECK(mb.getPosted() == mb.getExecuted());
+}
+
+static int callTwice(void *arg) {
+  int *value = (int *)arg;
+
+  *value *= 2;
+  return *value + 1;
+}
+
+static void testCall() {
+  ecmcCmdMailbox mb(8);
+  int  running = 1;
+  int  value   = 21;
+  int  result  = 0;
+
+  // Consumer like the rt loop
+  std::thread consumer([&mb, &running]() {
+    while (epicsAtomicGetIntT(&running)) {
+      mb.drain(mb.getBudget());
+      std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+  });
+
+  UNIT_CHECK(mb.call(callTwice, &value, 1.0, &result) == 0);
+  UNIT_CHECK(value == 42);
+  UNIT_CHECK(result == 43);
+
+  epicsAtomicSetIntT(&running, 0);
+  consumer.join();
+
+  // No consumer: withdrawn after the timeout and never executed
+  value  = 5;
+  result = -1;
+  UNIT_CHECK(mb.call(callTwice, &value, 0.01, &result) ==
+             ERROR_CMD_MAILBOX_CALL_TIMEOUT);
+  UNIT_CHECK(result == -1);
+  UNIT_CHECK(mb.getPending() == 1);
+  UNIT_CHECK(mb.drainAll() == 1);
+  UNIT_CHECK(value == 5);
+
+  // Full
+  testLog log;
+
+  for (int i = 0; i < 8; i++) {
+    postInt(&mb, &log, i, 0);
+  }
+  UNIT_CHECK(mb.call(callTwice, &value, 0.01, &result) ==
+             ERROR_CMD_MAILBOX_FULL);
+  UNIT_CHECK(mb.drainAll() == 8);
+}
+
+int main() {
+  testSize();
+  testOrderAndPayload();
+  testFullAndBudget();
+  testWrapAround();
+  testProducers();
+  testCall();
+  return unitTestResult("testCmdMailbox");
+}
@@ -0,0 +1,193 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  testEcEdgeWords.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* edgeWordsPack(): packing of edge capture bit channels into words (word
+* boundaries, bytes loaded, channel of each bit, shared bits) and change
+* detection of the packed words on a simulated process image.
+*
+\*************************************************************************/
+
+#include <string.h>
+#include <vector>
+#include "ecmcEcEdgeWords.h"
+#include "unitTest.h"
+
+#define TEST_IMAGE_BYTES 32
+
+static uint8_t image[TEST_IMAGE_BYTES];
+
+static ecmcEcEdgeBitRef ref(int byte, int bit, int channel) {
+  ecmcEcEdgeBitRef r = { &image[byte], bit, channel };
+
+  return r;
+}
+
+static void setBit(int byte, int bit, bool value) {
+  if (value) {
+    image[byte] |= 1 << bit;
+  } else {
+    image[byte] &= ~(1 << bit);
+  }
+}
+
+static void testEmpty() {
+  std::vector<ecmcEcEdgeBitRef> refs;
+  std::vector<ecmcEcEdgeWord>   words(3);
+
+  UNIT_CHECK(edgeWordsPack(refs, &words) == 0);
+  UNIT_CHECK(words.empty());
+}
+
+// Bits of neighbouring entries share a word, unsorted input
+static void testPacking() {
+  std::vector<ecmcEcEdgeBitRef> refs;
+  std::vector<ecmcEcEdgeWord>   words;
+
+  refs.push_back(ref(7, 7, 3));   // Last bit of first word
+  refs.push_back(ref(0, 0, 0));
+  refs.push_back(ref(8, 0, 4));   // Next word
+  refs.push_back(ref(2, 5, 2));
+  refs.push_back(ref(0, 3, 1));
+  refs.push_back(ref(20, 1, 5));  // Gap, own word of one byte
+  refs.push_back(ref(9, 2, 6));
+
+  UNIT_CHECK(edgeWordsPack(refs, &words) == 0);
+  UNIT_CHECK(words.size() == 3);
+
+  if (words.size() != 3) {
+    return;
+  }
+
+  UNIT_CHECK(words[0].adr == &image[0]);
+  UNIT_CHECK(words[0].bytes == 8);
+  UNIT_CHECK(words[0].mask ==
+             ((1ULL << 0) | (1ULL << 3) | (1ULL << 21) | (1ULL << 63)));
+  UNIT_CHECK(words[0].channel[0] == 0);
+  UNIT_CHECK(words[0].channel[3] == 1);
+  UNIT_CHECK(words[0].channel[21] == 2);
+  UNIT_CHECK(words[0].channel[63] == 3);
+  UNIT_CHECK(words[0].channel[1] == -1);
+
+  // Only loads up to the last used byte
+  UNIT_CHECK(words[1].adr == &image[8]);
+  UNIT_CHECK(words[1].bytes == 2);
+  UNIT_CHECK(words[1].mask == ((1ULL << 0) | (1ULL << 10)));
+  UNIT_CHECK(words[1].channel[0] == 4);
+  UNIT_CHECK(words[1].channel[10] == 6);
+
+  UNIT_CHECK(words[2].adr == &image[20]);
+  UNIT_CHECK(words[2].bytes == 1);
+  UNIT_CHECK(words[2].mask == (1ULL << 1));
+  UNIT_CHECK(words[2].channel[1] == 5);
+
+  // Total bits equal channels
+  int bits = 0;
+
+  for (size_t i = 0; i < words.size(); i++) {
+    bits += __builtin_popcountll(words[i].mask);
+  }
+  UNIT_CHECK(bits == (int)refs.size());
+}
+
+static void testSharedBit() {
+  std::vector<ecmcEcEdgeBitRef> refs;
+  std::vector<ecmcEcEdgeWord>   words;
+
+  refs.push_back(ref(4, 2, 0));
+  refs.push_back(ref(5, 0, 1));
+  refs.push_back(ref(4, 2, 2));
+  UNIT_CHECK(edgeWordsPack(refs, &words) == -1);
+}
+
+// 64 channels, one per bit of the first 8 bytes: a single word
+static void testFullWord() {
+  std::vector<ecmcEcEdgeBitRef> refs;
+  std::vector<ecmcEcEdgeWord>   words;
+
+  for (int i = 63; i >= 0; i--) {
+    refs.push_back(ref(i / 8, i % 8, i));
+  }
+  UNIT_CHECK(edgeWordsPack(refs, &words) == 0);
+  UNIT_CHECK(words.size() == 1);
+  UNIT_CHECK(words[0].mask == ~0ULL);
+  UNIT_CHECK(words[0].bytes == 8);
+
+  bool ok = true;
+
+  for (int i = 0; i < 64; i++) {
+    ok &= words[0].channel[i] == i;
+  }
+  UNIT_CHECK(ok);
+}
+
+// Only channel bits reported, each changed bit maps to its channel
+static void testChanged() {
+  std::vector<ecmcEcEdgeBitRef> refs;
+  std::vector<ecmcEcEdgeWord>   words;
+  uint64_t value;
+
+  memset(image, 0, sizeof(image));
+  refs.push_back(ref(1, 4, 0));
+  refs.push_back(ref(3, 0, 1));
+  refs.push_back(ref(12, 7, 2));
+  UNIT_CHECK(edgeWordsPack(refs, &words) == 0);
+  UNIT_CHECK(words.size() == 2);
+
+  if (words.size() != 2) {
+    return;
+  }
+  UNIT_CHECK(words[0].adr == &image[1] && words[0].bytes == 3);
+
+  for (size_t i = 0; i < words.size(); i++) {
+    words[i].old = edgeWordLoad(words[i].adr, words[i].bytes);
+  }
+
+  UNIT_CHECK(edgeWordChanged(&words[0], &value) == 0);
+
+  // Other bits in the word and bytes around the word are ignored
+  setBit(1, 5, true);
+  setBit(0, 0, true);
+  setBit(4, 0, true);
+  UNIT_CHECK(edgeWordChanged(&words[0], &value) == 0);
+
+  // Rising on channel 0 and 1
+  setBit(1, 4, true);
+  setBit(3, 0, true);
+  uint64_t changed = edgeWordChanged(&words[0], &value);
+  UNIT_CHECK(changed == ((1ULL << 4) | (1ULL << 16)));
+  UNIT_CHECK(words[0].channel[__builtin_ctzll(changed)] == 0);
+  UNIT_CHECK((value >> 4) & 1);
+
+  // Reported once
+  UNIT_CHECK(edgeWordChanged(&words[0], &value) == 0);
+
+  // Falling on channel 1
+  setBit(3, 0, false);
+  changed = edgeWordChanged(&words[0], &value);
+  UNIT_CHECK(changed == (1ULL << 16));
+  UNIT_CHECK(words[0].channel[16] == 1);
+  UNIT_CHECK(!((value >> 16) & 1));
+
+  // Second word
+  setBit(12, 7, true);
+  UNIT_CHECK(edgeWordChanged(&words[0], &value) == 0);
+  changed = edgeWordChanged(&words[1], &value);
+  UNIT_CHECK(changed == (1ULL << 7));
+  UNIT_CHECK(words[1].channel[7] == 2);
+}
+
+int main() {
+  testEmpty();
+  testPacking();
+  testSharedBit();
+  testFullWord();
+  testChanged();
+  return unitTestResult("testEcEdgeWords");
+}
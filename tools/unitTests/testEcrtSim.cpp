@@ -0,0 +1,189 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  testEcrtSim.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Smoke test of the simulated libethercat (tools/ecrtSim) in a 1kHz cyclic
+* loop like the ecmc rt thread: activation to OP, working counter,
+* loopback and constant inputs, sdo requests and reference clock.
+*
+\*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <ecrt.h>
+#include "unitTest.h"
+
+#define TEST_CYCLE_NS 1000000
+#define TEST_CYCLES 500
+#define TEST_OP_DELAY 5
+#define TEST_SDO_DELAY 3
+
+// Output 0x7000:1 looped back to input 0x6000:1, constant 0x6000:2
+static const char *testCfg =
+  "slave 0 0x2 0x12345678\n"
+  "sync 0 2 out\n"
+  "sync 0 3 in\n"
+  "pdo 0 2 0x1600\n"
+  "entry 0 0x1600 0x7000 1 16\n"
+  "pdo 0 3 0x1a00\n"
+  "entry 0 0x1a00 0x6000 1 16\n"
+  "entry 0 0x1a00 0x6000 2 16\n"
+  "sdo 0 0x8000 1 2 0x1234\n"
+  "loopback 0 0x7000 1 0 0x6000 1\n"
+  "input 0 0x6000 2 0xbeef\n"
+  "op_delay 5\n"
+  "sdo_delay 3\n";
+
+static void addNs(struct timespec *ts, long ns) {
+  ts->tv_nsec += ns;
+
+  while (ts->tv_nsec >= 1000000000L) {
+    ts->tv_nsec -= 1000000000L;
+    ts->tv_sec++;
+  }
+}
+
+int main() {
+  char cfgFile[] = "/tmp/testEcrtSimXXXXXX";
+  int  fd        = mkstemp(cfgFile);
+
+  UNIT_CHECK(fd >= 0);
+
+  if (fd < 0) {
+    return unitTestResult("testEcrtSim");
+  }
+  UNIT_CHECK(write(fd, testCfg, strlen(testCfg)) ==
+             (ssize_t)strlen(testCfg));
+  close(fd);
+  setenv("ECMC_ECRT_SIM_CFG", cfgFile, 1);
+
+  ec_master_t *master = ecrt_request_master(0);
+  unlink(cfgFile);
+  UNIT_CHECK(master != NULL);
+
+  ec_domain_t       *domain = ecrt_master_create_domain(master);
+  ec_slave_config_t *sc     = ecrt_master_slave_config(master, 0, 0, 0x2,
+                                                       0x12345678);
+  UNIT_CHECK(domain && sc);
+  UNIT_CHECK(!ecrt_master_slave_config(master, 0, 0, 0x2, 0x1));
+
+  int outOffset  = ecrt_slave_config_reg_pdo_entry(sc, 0x7000, 1, domain,
+                                                   NULL);
+  int inOffset   = ecrt_slave_config_reg_pdo_entry(sc, 0x6000, 1, domain,
+                                                   NULL);
+  int cnstOffset = ecrt_slave_config_reg_pdo_entry(sc, 0x6000, 2, domain,
+                                                   NULL);
+  UNIT_CHECK(outOffset == 0);
+  UNIT_CHECK(inOffset == 2);
+  UNIT_CHECK(cnstOffset == 4);
+  UNIT_CHECK(ecrt_slave_config_reg_pdo_entry(sc, 0x6000, 3, domain, NULL) <
+             0);
+
+  ec_sdo_request_t *req = ecrt_slave_config_create_sdo_request(sc, 0x8000, 1,
+                                                               2);
+  UNIT_CHECK(req != NULL);
+
+  // Blocking sdo access (non rt)
+  uint8_t  sdo[2]    = { 0 };
+  size_t   sdoSize   = 0;
+  uint32_t abortCode = 0;
+  UNIT_CHECK(ecrt_master_sdo_upload(master, 0, 0x8000, 1, sdo, sizeof(sdo),
+                                    &sdoSize, &abortCode) == 0);
+  UNIT_CHECK(sdoSize == 2 && EC_READ_U16(sdo) == 0x1234);
+
+  UNIT_CHECK(ecrt_master_activate(master) == 0);
+  uint8_t *data = ecrt_domain_data(domain);
+  UNIT_CHECK(data != NULL);
+  UNIT_CHECK(ecrt_domain_size(domain) == 6);
+
+  struct timespec wakeup;
+  int64_t maxLateNs    = 0;
+  int     opCycle      = -1;
+  int     sdoCycle     = -1;
+  int     loopbackOk   = 0;
+  int     wcComplete   = 0;
+  bool    refClockOk   = true;
+  bool    constInputOk = true;
+
+  clock_gettime(CLOCK_MONOTONIC, &wakeup);
+
+  for (int cycle = 0; cycle < TEST_CYCLES; cycle++) {
+    addNs(&wakeup, TEST_CYCLE_NS);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL);
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t lateNs = (now.tv_sec - wakeup.tv_sec) * 1000000000LL +
+                     (now.tv_nsec - wakeup.tv_nsec);
+
+    if (lateNs > maxLateNs) {
+      maxLateNs = lateNs;
+    }
+
+    ecrt_master_receive(master);
+    ecrt_domain_process(domain);
+
+    ec_slave_config_state_t scState;
+    ec_domain_state_t       domainState;
+    ecrt_slave_config_state(sc, &scState);
+    ecrt_domain_state(domain, &domainState);
+
+    if (scState.operational && (opCycle < 0)) {
+      opCycle = cycle;
+    }
+
+    if (scState.operational) {
+      wcComplete += domainState.wc_state == EC_WC_COMPLETE;
+
+      // Output of the previous cycle looped back
+      loopbackOk += EC_READ_U16(data + inOffset) ==
+                    (uint16_t)(cycle - 1);
+    }
+    constInputOk &= EC_READ_U16(data + cnstOffset) == 0xbeef;
+
+    if (cycle == TEST_OP_DELAY + 10) {
+      EC_WRITE_U16(ecrt_sdo_request_data(req), 0x4321);
+      ecrt_sdo_request_write(req);
+    } else if ((sdoCycle < 0) && (cycle > TEST_OP_DELAY + 10) &&
+               (ecrt_sdo_request_state(req) == EC_REQUEST_SUCCESS)) {
+      sdoCycle = cycle;
+    }
+
+    if (cycle > 1) {
+      uint32_t refTime = 0;
+      refClockOk &= ecrt_master_reference_clock_time(master, &refTime) == 0;
+    }
+
+    EC_WRITE_U16(data + outOffset, (uint16_t)cycle);
+    ecrt_master_application_time(master,
+                                 (uint64_t)now.tv_sec * 1000000000ULL +
+                                 now.tv_nsec);
+    ecrt_domain_queue(domain);
+    ecrt_master_send(master);
+  }
+
+  UNIT_CHECK(opCycle >= TEST_OP_DELAY - 1 && opCycle <= TEST_OP_DELAY + 1);
+  UNIT_CHECK(wcComplete == TEST_CYCLES - opCycle);
+  UNIT_CHECK(loopbackOk == TEST_CYCLES - opCycle);
+  UNIT_CHECK(constInputOk);
+  UNIT_CHECK(refClockOk);
+  UNIT_CHECK(sdoCycle == TEST_OP_DELAY + 10 + TEST_SDO_DELAY);
+
+  UNIT_CHECK(ecrt_master_sdo_upload(master, 0, 0x8000, 1, sdo, sizeof(sdo),
+                                    &sdoSize, &abortCode) == 0);
+  UNIT_CHECK(EC_READ_U16(sdo) == 0x4321);
+
+  printf("testEcrtSim: max wakeup latency %lld us\n",
+         (long long)(maxLateNs / 1000));
+  ecrt_release_master(master);
+  return unitTestResult("testEcrtSim");
+}
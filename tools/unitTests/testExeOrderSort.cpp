@@ -0,0 +1,335 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  testExeOrderSort.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* exeOrderSort(): stable order without dependencies, producers first,
+* graphs like the ones built by exeOrderBuild() and cycle breaking.
+* exeOrderBatchCollect(): node outputs of a cycle with batched axes equal
+* the outputs without batch.
+*
+\*************************************************************************/
+
+#include <vector>
+#include "ecmcExeOrderSort.h"
+#include "unitTest.h"
+
+typedef std::vector<std::vector<int> > testGraph;
+
+static void edge(testGraph *graph, int producer, int consumer) {
+  (*graph)[consumer].push_back(producer);
+}
+
+static bool sameOrder(const std::vector<int>& order,
+                      const std::vector<int>& expected) {
+  return order == expected;
+}
+
+// Every producer before its consumer, except at the breaks
+static bool producersFirst(const testGraph&        graph,
+                           const std::vector<int>& order,
+                           const std::vector<int>& breaks) {
+  std::vector<int> pos(graph.size(), -1);
+
+  for (size_t i = 0; i < order.size(); i++) {
+    pos[order[i]] = (int)i;
+  }
+
+  for (size_t c = 0; c < graph.size(); c++) {
+    bool isBreak = false;
+
+    for (size_t b = 0; b < breaks.size(); b++) {
+      isBreak |= breaks[b] == (int)c;
+    }
+
+    for (size_t p = 0; p < graph[c].size() && !isBreak; p++) {
+      if (pos[graph[c][p]] > pos[c]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void testEmpty() {
+  testGraph graph;
+  std::vector<int> order(1, 5), breaks(1, 5);
+
+  exeOrderSort(graph, &order, &breaks);
+  UNIT_CHECK(order.empty());
+  UNIT_CHECK(breaks.empty());
+}
+
+static void testNoEdges() {
+  testGraph graph(4);
+  std::vector<int> order, breaks;
+
+  exeOrderSort(graph, &order, &breaks);
+  UNIT_CHECK(sameOrder(order, { 0, 1, 2, 3 }));
+  UNIT_CHECK(breaks.empty());
+}
+
+// Axis 0 and 1 (nodes plc0=0, ax0=1, plc1=2, ax1=3): plc1 writes ax0
+static void testPlcWritesOtherAxis() {
+  testGraph graph(4);
+  std::vector<int> order, breaks;
+
+  edge(&graph, 0, 1);  // plc0 before ax0
+  edge(&graph, 2, 3);  // plc1 before ax1
+  edge(&graph, 2, 1);  // plc1 writes ax0
+  exeOrderSort(graph, &order, &breaks);
+  UNIT_CHECK(sameOrder(order, { 0, 2, 1, 3 }));
+  UNIT_CHECK(breaks.empty());
+  UNIT_CHECK(producersFirst(graph, order, breaks));
+}
+
+// Master axes 2, 3 before state machine 4 before slave axes 0, 1. A gear
+// (node 5, after master ax2) drives ax0
+static void testStateMachineAndGear() {
+  testGraph graph(6);
+  std::vector<int> order, breaks;
+
+  edge(&graph, 2, 4);
+  edge(&graph, 3, 4);
+  edge(&graph, 4, 0);
+  edge(&graph, 4, 1);
+  edge(&graph, 2, 5);
+  edge(&graph, 5, 0);
+  exeOrderSort(graph, &order, &breaks);
+  UNIT_CHECK(sameOrder(order, { 2, 3, 4, 1, 5, 0 }));
+  UNIT_CHECK(breaks.empty());
+  UNIT_CHECK(producersFirst(graph, order, breaks));
+}
+
+// Transform: fwd (4) before virtual axes 2, 3 before inv (5) before real
+// axes 0, 1
+static void testTransform() {
+  testGraph graph(6);
+  std::vector<int> order, breaks;
+
+  edge(&graph, 4, 2);
+  edge(&graph, 4, 3);
+  edge(&graph, 2, 5);
+  edge(&graph, 3, 5);
+  edge(&graph, 5, 0);
+  edge(&graph, 5, 1);
+  exeOrderSort(graph, &order, &breaks);
+  UNIT_CHECK(sameOrder(order, { 4, 2, 3, 5, 0, 1 }));
+  UNIT_CHECK(breaks.empty());
+  UNIT_CHECK(producersFirst(graph, order, breaks));
+}
+
+// 0 -> 1 -> 2 -> 0 cycle and an independent node 3 depending on 2
+static void testCycle() {
+  testGraph graph(4);
+  std::vector<int> order, breaks;
+
+  edge(&graph, 0, 1);
+  edge(&graph, 1, 2);
+  edge(&graph, 2, 0);
+  edge(&graph, 2, 3);
+  exeOrderSort(graph, &order, &breaks);
+  UNIT_CHECK(sameOrder(order, { 0, 1, 2, 3 }));
+  UNIT_CHECK(sameOrder(breaks, { 0 }));
+  UNIT_CHECK(producersFirst(graph, order, breaks));
+}
+
+// Two separate cycles, each broken once, ready nodes first
+static void testTwoCycles() {
+  testGraph graph(5);
+  std::vector<int> order, breaks;
+
+  edge(&graph, 1, 0);
+  edge(&graph, 0, 1);
+  edge(&graph, 4, 3);
+  edge(&graph, 3, 4);
+  exeOrderSort(graph, &order, &breaks);
+  UNIT_CHECK(sameOrder(order, { 2, 0, 1, 3, 4 }));
+  UNIT_CHECK(sameOrder(breaks, { 0, 3 }));
+  UNIT_CHECK(producersFirst(graph, order, breaks));
+}
+
+// Chain given in reverse default order
+static void testReverseChain() {
+  const int n = 50;
+  testGraph graph(n);
+  std::vector<int> order, breaks, expected;
+
+  for (int i = n - 1; i > 0; i--) {
+    edge(&graph, i, i - 1);
+  }
+
+  for (int i = n - 1; i >= 0; i--) {
+    expected.push_back(i);
+  }
+  exeOrderSort(graph, &order, &breaks);
+  UNIT_CHECK(sameOrder(order, expected));
+  UNIT_CHECK(breaks.empty());
+}
+
+// Simulated node: output from the producers outputs, the cycle and the
+// node. A batched node (axis) stages the output, it is published when the
+// batch is collected (executePreCntrl()/executePostCntrl()).
+static double nodeOutput(const testGraph&           graph,
+                         const std::vector<double>& out,
+                         int                        node,
+                         int                        cycle) {
+  double value = node + 0.1 * cycle;
+
+  for (size_t p = 0; p < graph[node].size(); p++) {
+    value += 0.5 * out[graph[node][p]];
+  }
+  return value;
+}
+
+// Run cycles with or without batch, count collects of one cycle
+static std::vector<double> runCycles(const testGraph&         graph,
+                                     const std::vector<bool>& batched,
+                                     bool                     batch,
+                                     const std::vector<bool>& collect,
+                                     int                     *collects) {
+  std::vector<int>    order, breaks;
+  std::vector<double> out(graph.size(), 0), staged(graph.size(), 0);
+  std::vector<int>    pending;
+
+  exeOrderSort(graph, &order, &breaks);
+
+  for (int cycle = 0; cycle < 3; cycle++) {
+    *collects = 0;
+
+    for (size_t k = 0; k <= order.size(); k++) {
+      // Collect before node k and after the last node
+      if (!pending.empty() && ((k == order.size()) || collect[k])) {
+        for (size_t i = 0; i < pending.size(); i++) {
+          out[pending[i]] = staged[pending[i]];
+        }
+        pending.clear();
+        (*collects)++;
+      }
+
+      if (k == order.size()) {
+        break;
+      }
+      int node = order[k];
+
+      if (batch && batched[node]) {
+        staged[node] = nodeOutput(graph, out, node, cycle);
+        pending.push_back(node);
+      } else {
+        out[node] = nodeOutput(graph, out, node, cycle);
+      }
+    }
+  }
+  return out;
+}
+
+// Axes 0..3 (nodes 0..3), plc of axis 1 reading axis 0 (4), gear from
+// axis 0 to axis 2 (5), state machine master axis 1 slave axis 3 (6)
+static void testBatchCollect() {
+  testGraph graph(7);
+  std::vector<bool> batched(7, false);
+  std::vector<int>  order, breaks;
+  std::vector<bool> collect, noCollect;
+  int collects = 0;
+
+  for (int a = 0; a < 4; a++) {
+    batched[a] = true;
+  }
+  edge(&graph, 0, 4);
+  edge(&graph, 4, 1);
+  edge(&graph, 0, 5);
+  edge(&graph, 5, 2);
+  edge(&graph, 1, 6);
+  edge(&graph, 6, 3);
+  exeOrderSort(graph, &order, &breaks);
+  UNIT_CHECK(sameOrder(order, { 0, 4, 1, 5, 2, 6, 3 }));
+  exeOrderBatchCollect(graph, order, batched, &collect);
+
+  // Before plc (axis 0) and state machine (axis 1), gear only needs axis 0
+  UNIT_CHECK(collect == std::vector<bool>({ false, true, false, false,
+                                             false, true, false }));
+
+  int scalarCollects = 0;
+  std::vector<double> scalar = runCycles(graph, batched, false, collect,
+                                         &scalarCollects);
+  std::vector<double> batch = runCycles(graph, batched, true, collect,
+                                        &collects);
+  bool same = true;
+
+  for (size_t n = 0; n < scalar.size(); n++) {
+    same &= scalar[n] == batch[n];
+  }
+  UNIT_CHECK(same);
+  UNIT_CHECK(collects == 3);
+
+  // Without the collects the consumers see the last cycle
+  noCollect.assign(order.size(), false);
+  batch = runCycles(graph, batched, true, noCollect, &collects);
+  UNIT_CHECK(batch[4] != scalar[4]);
+  UNIT_CHECK(batch[6] != scalar[6]);
+  UNIT_CHECK(collects == 1);
+}
+
+// Independent axes and a plc only writing an axis: one collect at the end
+static void testBatchCollectIndependent() {
+  testGraph graph(5);
+  std::vector<bool> batched(5, true);
+  std::vector<int>  order, breaks;
+  std::vector<bool> collect;
+  int collects = 0;
+
+  batched[4] = false;
+  edge(&graph, 4, 2);  // plc writes axis 2
+  exeOrderSort(graph, &order, &breaks);
+  exeOrderBatchCollect(graph, order, batched, &collect);
+  UNIT_CHECK(collect == std::vector<bool>(5, false));
+  runCycles(graph, batched, true, collect, &collects);
+  UNIT_CHECK(collects == 1);
+}
+
+// Transform: fwd (4) before virtual axes 2, 3 before inv (5) before real
+// axes 0, 1. Collect virtual axes before inv.
+static void testBatchCollectTransform() {
+  testGraph graph(6);
+  std::vector<bool> batched(6, false);
+  std::vector<int>  order, breaks;
+  std::vector<bool> collect;
+  int collects = 0, scalarCollects = 0;
+
+  for (int a = 0; a < 4; a++) {
+    batched[a] = true;
+  }
+  edge(&graph, 4, 2);
+  edge(&graph, 4, 3);
+  edge(&graph, 2, 5);
+  edge(&graph, 3, 5);
+  edge(&graph, 5, 0);
+  edge(&graph, 5, 1);
+  exeOrderSort(graph, &order, &breaks);
+  exeOrderBatchCollect(graph, order, batched, &collect);
+  UNIT_CHECK(collect == std::vector<bool>({ false, false, false, true,
+                                             false, false }));
+  UNIT_CHECK(runCycles(graph, batched, true, collect, &collects) ==
+             runCycles(graph, batched, false, collect, &scalarCollects));
+  UNIT_CHECK(collects == 2);
+}
+
+int main() {
+  testEmpty();
+  testNoEdges();
+  testPlcWritesOtherAxis();
+  testStateMachineAndGear();
+  testTransform();
+  testCycle();
+  testTwoCycles();
+  testReverseChain();
+  testBatchCollect();
+  testBatchCollectIndependent();
+  testBatchCollectTransform();
+  return unitTestResult("testExeOrderSort");
+}
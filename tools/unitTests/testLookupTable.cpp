@@ -0,0 +1,154 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  testLookupTable.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* ecmcLookupTable: cached getValue() (interval and slope) against the
+* binary search getValue() for continuous, reversed and jumping inputs,
+* out of range inputs and table nodes.
+*
+\*************************************************************************/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <sstream>
+#include <iomanip>
+#include "ecmcLookupTable.h"
+#include "unitTest.h"
+
+// Log globals of ecmcOctetIF.c (not linked)
+asynUser *pPrintOutAsynUser     = NULL;
+unsigned int debug_print_flags  = 0;
+unsigned int die_on_error_flags = 0;
+
+#define TEST_ROWS 50
+
+// Non uniform index, value = index^2 (slope 2*index in the limit)
+static std::string writeTable() {
+  char fileName[] = "/tmp/testLookupTableXXXXXX";
+  int  fd         = mkstemp(fileName);
+  std::ostringstream table;
+
+  table << std::setprecision(17) << "# test table\nPREC=15\n";
+
+  for (int i = 0; i < TEST_ROWS; i++) {
+    double index = i + 0.01 * i * i;
+    table << index << "," << index * index << "\n";
+  }
+  std::string data = table.str();
+
+  if ((fd < 0) || (write(fd, data.c_str(), data.size()) !=
+                   (ssize_t)data.size())) {
+    return "";
+  }
+  close(fd);
+  return fileName;
+}
+
+// Cached value, slope and interval consistent with the binary search
+static bool checkPoint(ecmcLookupTable<double, double> *lut,
+                       double                           index,
+                       size_t                          *interval) {
+  double slope  = -1;
+  double cached = lut->getValue(index, interval, &slope);
+  double ref    = lut->getValue(index);
+
+  if (fabs(cached - ref) > 1e-9 * (1 + fabs(ref))) {
+    return false;
+  }
+
+  if ((index <= lut->getIndexFirst()) || (index >= lut->getIndexLast())) {
+    return slope == 0;
+  }
+
+  // Slope from the interval nodes
+  double h  = 1e-7;
+  double lo = lut->getValue(index - h);
+  double hi = lut->getValue(index + h);
+
+  return *interval < TEST_ROWS - 1 &&
+         fabs(slope - (hi - lo) / (2 * h)) < 1e-3 * (1 + fabs(slope));
+}
+
+static void testCached(ecmcLookupTable<double, double> *lut) {
+  double first = lut->getIndexFirst();
+  double last  = lut->getIndexLast();
+  size_t interval = 0;
+  bool   ok       = true;
+
+  UNIT_CHECK(first == 0);
+  UNIT_CHECK_NEAR(last, 49 + 0.01 * 49 * 49, 1e-9);
+
+  // Continuous forward and backward (neighbour steps)
+  for (double x = first - 1; x <= last + 1; x += 0.013) {
+    ok &= checkPoint(lut, x, &interval);
+  }
+  UNIT_CHECK(ok);
+
+  for (double x = last + 1; x >= first - 1; x -= 0.013) {
+    ok &= checkPoint(lut, x, &interval);
+  }
+  UNIT_CHECK(ok);
+
+  // Jumps (binary search)
+  srand(1);
+
+  for (int i = 0; i < 10000; i++) {
+    double x = first - 1 + (last - first + 2) * rand() / (double)RAND_MAX;
+    ok &= checkPoint(lut, x, &interval);
+  }
+  UNIT_CHECK(ok);
+
+  // Nodes, also with a stale interval from the other end
+  for (int i = 0; i < TEST_ROWS; i++) {
+    double node = i + 0.01 * i * i;
+    double slope;
+
+    interval = i % 2 ? 0 : TEST_ROWS + 5;
+    ok      &= fabs(lut->getValue(node, &interval, &slope) - node * node) <
+               1e-9 * (1 + node * node);
+  }
+  UNIT_CHECK(ok);
+
+  // Out of range
+  double slope = 1;
+  interval = 7;
+  UNIT_CHECK(lut->getValue(first - 10, &interval, &slope) == 0);
+  UNIT_CHECK(interval == 0 && slope == 0);
+  UNIT_CHECK_NEAR(lut->getValue(last + 10, &interval, &slope), last * last,
+                  1e-9);
+  UNIT_CHECK(interval == TEST_ROWS - 2 && slope == 0);
+}
+
+static void testInvalid() {
+  bool thrown = false;
+
+  try {
+    ecmcLookupTable<double, double> lut("/nonexistent/table");
+  } catch (int error) {
+    thrown = error == ERROR_LOOKUP_TABLE_OPEN_FILE_FAILED;
+  }
+  UNIT_CHECK(thrown);
+}
+
+int main() {
+  std::string fileName = writeTable();
+
+  UNIT_CHECK(!fileName.empty());
+
+  try {
+    ecmcLookupTable<double, double> lut(fileName);
+    testCached(&lut);
+  } catch (int error) {
+    UNIT_CHECK(error == 0);
+  }
+  unlink(fileName.c_str());
+
+  testInvalid();
+  return unitTestResult("testLookupTable");
+}
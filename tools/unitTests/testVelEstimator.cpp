@@ -0,0 +1,154 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  testVelEstimator.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* ecmcVelEstimator: no lag at constant velocity (alpha-beta) and constant
+* acceleration (alpha-beta-gamma), varying dt, noise reduction,
+* extrapolation, reset and configuration errors.
+*
+\*************************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+#include "ecmcVelEstimator.h"
+#include "unitTest.h"
+
+#define TEST_DT 0.001
+#define TEST_CYCLES 2000
+
+static void testConstVel() {
+  ecmcVelEstimator est;
+
+  UNIT_CHECK(est.setType(ECMC_VEL_EST_ALPHA_BETA) == 0);
+  UNIT_CHECK(est.setTimeConst(0.01) == 0);
+
+  for (int i = 0; i < TEST_CYCLES; i++) {
+    est.update(12.5 * TEST_DT, TEST_DT);
+  }
+  UNIT_CHECK_NEAR(est.getVel(0), 12.5, 1e-9);
+  UNIT_CHECK_NEAR(est.getVel(0.5), 12.5, 1e-9);
+  UNIT_CHECK(est.getAcc() == 0);
+
+  // Varying dt (timestamped measurements)
+  ecmcVelEstimator jitter;
+  jitter.setType(ECMC_VEL_EST_ALPHA_BETA);
+
+  for (int i = 0; i < TEST_CYCLES; i++) {
+    double dt = i % 2 ? 0.0005 : 0.0015;
+    jitter.update(-3 * dt, dt);
+  }
+  UNIT_CHECK_NEAR(jitter.getVel(0), -3, 1e-9);
+}
+
+// Alpha-beta lags a ramp, alpha-beta-gamma does not
+static void testConstAcc() {
+  const double acc = 40;
+  ecmcVelEstimator ab, abg;
+
+  ab.setType(ECMC_VEL_EST_ALPHA_BETA);
+  UNIT_CHECK(abg.setType(ECMC_VEL_EST_ALPHA_BETA_GAMMA) == 0);
+  UNIT_CHECK(abg.getType() == ECMC_VEL_EST_ALPHA_BETA_GAMMA);
+
+  for (int i = 0; i < TEST_CYCLES; i++) {
+    // Distance of a constant acceleration over the cycle
+    double t0   = i * TEST_DT;
+    double t1   = t0 + TEST_DT;
+    double dist = 0.5 * acc * (t1 * t1 - t0 * t0);
+    ab.update(dist, TEST_DT);
+    abg.update(dist, TEST_DT);
+  }
+  double vel = acc * TEST_CYCLES * TEST_DT;
+
+  UNIT_CHECK_NEAR(abg.getVel(0), vel, 1e-6);
+  UNIT_CHECK_NEAR(abg.getAcc(), acc, 1e-6);
+  UNIT_CHECK_NEAR(abg.getVel(0.01), vel + acc * 0.01, 1e-6);
+  UNIT_CHECK(vel - ab.getVel(0) > 0.1);
+}
+
+// Less noise than the raw difference, no bias
+static void testNoise() {
+  ecmcVelEstimator est;
+  double raw2 = 0, est2 = 0, estSum = 0;
+  double noiseOld = 0;
+  int    n        = 0;
+
+  est.setType(ECMC_VEL_EST_ALPHA_BETA);
+  est.setTimeConst(0.02);
+  srand(1);
+
+  for (int i = 0; i < TEST_CYCLES * 5; i++) {
+    double noise = 1e-4 * (2.0 * rand() / RAND_MAX - 1);
+    double dist  = 2 * TEST_DT + noise - noiseOld;
+    noiseOld = noise;
+    est.update(dist, TEST_DT);
+
+    if (i >= TEST_CYCLES) {
+      double rawErr = dist / TEST_DT - 2;
+      double estErr = est.getVel(0) - 2;
+      raw2   += rawErr * rawErr;
+      est2   += estErr * estErr;
+      estSum += estErr;
+      n++;
+    }
+  }
+  UNIT_CHECK(sqrt(est2 / n) < 0.1 * sqrt(raw2 / n));
+  UNIT_CHECK(fabs(estSum / n) < 1e-3);
+}
+
+static void testReset() {
+  ecmcVelEstimator est;
+
+  est.setType(ECMC_VEL_EST_ALPHA_BETA_GAMMA);
+
+  for (int i = 0; i < 100; i++) {
+    est.update(i * TEST_DT * TEST_DT, TEST_DT);
+  }
+  double vel = est.getVel(0);
+  UNIT_CHECK(vel != 0);
+
+  // dt <= 0 ignored
+  est.update(1, 0);
+  est.update(1, -TEST_DT);
+  UNIT_CHECK(est.getVel(0) == vel);
+
+  est.reset();
+  UNIT_CHECK(est.getVel(0) == 0 && est.getAcc() == 0);
+
+  est.update(5 * TEST_DT, TEST_DT);
+  UNIT_CHECK(est.getVel(0) != 0);
+
+  // Type change resets
+  UNIT_CHECK(est.setType(ECMC_VEL_EST_ALPHA_BETA) == 0);
+  UNIT_CHECK(est.getVel(0) == 0);
+}
+
+static void testErrors() {
+  ecmcVelEstimator est;
+
+  UNIT_CHECK(est.getType() == ECMC_VEL_EST_FILTER);
+  UNIT_CHECK(est.setType(-1) == ERROR_VEL_EST_TYPE_INVALID);
+  UNIT_CHECK(est.setType(3) == ERROR_VEL_EST_TYPE_INVALID);
+  UNIT_CHECK(est.getType() == ECMC_VEL_EST_FILTER);
+
+  UNIT_CHECK(est.setTimeConst(0) == ERROR_VEL_EST_TIME_CONST_INVALID);
+  UNIT_CHECK(est.setTimeConst(-0.01) == ERROR_VEL_EST_TIME_CONST_INVALID);
+  UNIT_CHECK(est.setTimeConst(NAN) == ERROR_VEL_EST_TIME_CONST_INVALID);
+  UNIT_CHECK(est.getTimeConst() == 0.01);
+  UNIT_CHECK(est.setTimeConst(0.005) == 0);
+  UNIT_CHECK(est.getTimeConst() == 0.005);
+}
+
+int main() {
+  testConstVel();
+  testConstAcc();
+  testNoise();
+  testReset();
+  testErrors();
+  return unitTestResult("testVelEstimator");
+}
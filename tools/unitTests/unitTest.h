@@ -0,0 +1,51 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  unitTest.h
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Minimal check macros for the standalone unit tests (one executable per
+* test, exit code 0 if all checks passed).
+*
+\*************************************************************************/
+
+#ifndef UNIT_TEST_H_
+#define UNIT_TEST_H_
+
+#include <stdio.h>
+#include <math.h>
+
+static int unitTestChecks   = 0;
+static int unitTestFailures = 0;
+
+#define UNIT_CHECK(cond)                                             \
+  do {                                                               \
+    unitTestChecks++;                                                \
+    if (!(cond)) {                                                   \
+      unitTestFailures++;                                            \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,         \
+              __LINE__, # cond);                                     \
+    }                                                                \
+  } while (0)
+
+#define UNIT_CHECK_NEAR(a, b, tol)                                   \
+  do {                                                               \
+    unitTestChecks++;                                                \
+    if (!(fabs((double)(a) - (double)(b)) <= (tol))) {               \
+      unitTestFailures++;                                            \
+      fprintf(stderr, "%s:%d: check failed: %s (%g) == %s (%g)\n",   \
+              __FILE__, __LINE__, # a, (double)(a), # b, (double)(b)); \
+    }                                                                \
+  } while (0)
+
+static inline int unitTestResult(const char *name) {
+  printf("%s: %d checks, %d failed\n", name, unitTestChecks,
+         unitTestFailures);
+  return unitTestFailures ? 1 : 0;
+}
+
+#endif  /* UNIT_TEST_H_ */
@@ -0,0 +1,308 @@
+/*************************************************************************\
+* Copyright (c) 2024 Paul Scherrer Institut
+* ecmc is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+*
+*  velEstBench.cpp
+*
+*  Created on: Oct 19, 2026
+*      Author: anderssandstrom
+*
+* Benchmark of the encoder velocity estimation: moving average
+* (ecmcFilter::getFiltVelo(), default) versus the tracking filters of
+* ecmcVelEstimator (alpha-beta and alpha-beta-gamma). Both are fed with the
+* distance travelled per cycle like in ecmcEncoder (no timestamps).
+*
+*   velEstBench gen <trace>   Write the reference trace (deterministic)
+*   velEstBench run <trace>   Evaluate all estimators on the trace
+*
+* Trace (csv): cycle, true position [mm], true velocity [mm/s], encoder
+* position [counts]. 1kHz, 1um/count, sensor noise 0.3 counts rms:
+*   0.0-0.2s standstill
+*   0.2-0.4s accelerate to 20mm/s (100mm/s2)
+*   0.4-1.4s constant 20mm/s
+*   1.4-1.6s decelerate to 0
+*   1.6-2.0s standstill
+*   2.0-3.0s sine velocity, 10mm/s amplitude, 2Hz
+*   3.0-3.5s constant 0.2mm/s (0.2 counts/cycle)
+*   3.5-4.0s standstill
+*
+* Results per estimator:
+*   lag:    time shift of the true velocity that minimizes the rms error
+*           in the acceleration and deceleration phases [ms]
+*   ramp:   mean error while accelerating [mm/s]
+*   noise:  rms error at constant velocity 0.6-1.4s [mm/s]
+*   slow:   rms error at 0.2mm/s 3.1-3.5s [mm/s]
+*   sine:   rms error 2.1-3.0s [mm/s]
+*   cpu:    time per update [ns]
+*
+\*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "ecmcFilter.h"
+#include "ecmcVelEstimator.h"
+
+// Log globals of ecmcOctetIF.c (not linked)
+asynUser *pPrintOutAsynUser     = NULL;
+unsigned int debug_print_flags  = 0;
+unsigned int die_on_error_flags = 0;
+
+#define BENCH_SAMPLE_TIME 0.001
+#define BENCH_CYCLES 4000
+#define BENCH_COUNTS_PER_MM 1000.0
+#define BENCH_NOISE_COUNTS 0.3
+#define BENCH_MAX_LAG_CYCLES 100
+#define BENCH_CPU_PASSES 200
+
+struct benchSample {
+  double pos;
+  double vel;
+  long   counts;
+};
+
+struct benchConfig {
+  const char *name;
+  int         type;       // ECMC_VEL_EST_*
+  size_t      filterSize;
+  double      timeConst;
+};
+
+static const benchConfig configs[] = {
+  { "filter size 10",       ECMC_VEL_EST_FILTER,           10,  0     },
+  { "filter size 50",       ECMC_VEL_EST_FILTER,           50,  0     },
+  { "filter size 100",      ECMC_VEL_EST_FILTER,           100, 0     },
+  { "alpha-beta 5ms",       ECMC_VEL_EST_ALPHA_BETA,       0,   0.005 },
+  { "alpha-beta 10ms",      ECMC_VEL_EST_ALPHA_BETA,       0,   0.010 },
+  { "alpha-beta 20ms",      ECMC_VEL_EST_ALPHA_BETA,       0,   0.020 },
+  { "alpha-beta-gamma 10ms", ECMC_VEL_EST_ALPHA_BETA_GAMMA, 0,  0.010 },
+  { "alpha-beta-gamma 20ms", ECMC_VEL_EST_ALPHA_BETA_GAMMA, 0,  0.020 },
+};
+
+// Deterministic gaussian noise (LCG + Box-Muller)
+static double benchNoise(uint64_t *state) {
+  double u[2];
+
+  for (int i = 0; i < 2; i++) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    u[i]   = ((*state >> 11) + 0.5) / 9007199254740992.0;
+  }
+  return sqrt(-2 * log(u[0])) * cos(2 * M_PI * u[1]);
+}
+
+static double benchVel(double t) {
+  if (t < 0.2) return 0;
+
+  if (t < 0.4) return 100 * (t - 0.2);
+
+  if (t < 1.4) return 20;
+
+  if (t < 1.6) return 20 - 100 * (t - 1.4);
+
+  if (t < 2.0) return 0;
+
+  if (t < 3.0) return 10 * sin(2 * M_PI * 2 * (t - 2.0));
+
+  if (t < 3.5) return 0.2;
+
+  return 0;
+}
+
+static int benchGen(const char *fileName) {
+  FILE *file = fopen(fileName, "w");
+
+  if (!file) {
+    fprintf(stderr, "Failed to open %s\n", fileName);
+    return 1;
+  }
+
+  uint64_t state = 1;
+  double   pos   = 0;
+
+  fprintf(file, "cycle,pos,vel,counts\n");
+
+  for (int i = 0; i < BENCH_CYCLES; i++) {
+    double t = i * BENCH_SAMPLE_TIME;
+
+    // Exact integral over the cycle (midpoint rule, fine at 1kHz)
+    double vel = benchVel(t);
+    pos += benchVel(t - 0.5 * BENCH_SAMPLE_TIME) * BENCH_SAMPLE_TIME;
+
+    long counts = lround(pos * BENCH_COUNTS_PER_MM +
+                         BENCH_NOISE_COUNTS * benchNoise(&state));
+    fprintf(file, "%d,%.9f,%.9f,%ld\n", i, pos, vel, counts);
+  }
+  fclose(file);
+  return 0;
+}
+
+static int benchRead(const char *fileName, std::vector<benchSample> *trace) {
+  FILE *file = fopen(fileName, "r");
+
+  if (!file) {
+    fprintf(stderr, "Failed to open %s\n", fileName);
+    return 1;
+  }
+
+  char line[256];
+
+  if (!fgets(line, sizeof(line), file)) {
+    fclose(file);
+    return 1;
+  }
+
+  while (fgets(line, sizeof(line), file)) {
+    benchSample s;
+    int cycle = 0;
+
+    if (sscanf(line, "%d,%lf,%lf,%ld", &cycle, &s.pos, &s.vel,
+               &s.counts) == 4) {
+      trace->push_back(s);
+    }
+  }
+  fclose(file);
+  return trace->empty();
+}
+
+// Estimated velocity of each cycle
+static void benchEstimate(const benchConfig&              cfg,
+                          const std::vector<benchSample>& trace,
+                          std::vector<double>            *out) {
+  ecmcFilter       filter(BENCH_SAMPLE_TIME,
+                          cfg.filterSize ? cfg.filterSize : 1);
+  ecmcVelEstimator est;
+
+  est.setType(cfg.type);
+
+  if (cfg.timeConst > 0) {
+    est.setTimeConst(cfg.timeConst);
+  }
+
+  out->resize(trace.size());
+
+  for (size_t i = 0; i < trace.size(); i++) {
+    double dist = i ? (trace[i].counts - trace[i - 1].counts) /
+                  BENCH_COUNTS_PER_MM : 0;
+
+    if (cfg.type == ECMC_VEL_EST_FILTER) {
+      (*out)[i] = filter.getFiltVelo(dist);
+    } else {
+      est.update(dist, BENCH_SAMPLE_TIME);
+      (*out)[i] = est.getVel(0);
+    }
+  }
+}
+
+static double benchRms(const std::vector<benchSample>& trace,
+                       const std::vector<double>&      est,
+                       double                          from,
+                       double                          to,
+                       int                             shift) {
+  double sum = 0;
+  int    n   = 0;
+
+  for (int i = (int)(from / BENCH_SAMPLE_TIME);
+       i < (int)(to / BENCH_SAMPLE_TIME); i++) {
+    double err = est[i] - trace[i - shift].vel;
+    sum += err * err;
+    n++;
+  }
+  return n ? sqrt(sum / n) : 0;
+}
+
+static double benchMean(const std::vector<benchSample>& trace,
+                        const std::vector<double>&      est,
+                        double                          from,
+                        double                          to) {
+  double sum = 0;
+  int    n   = 0;
+
+  for (int i = (int)(from / BENCH_SAMPLE_TIME);
+       i < (int)(to / BENCH_SAMPLE_TIME); i++) {
+    sum += est[i] - trace[i].vel;
+    n++;
+  }
+  return n ? sum / n : 0;
+}
+
+static double benchCpuNs(const benchConfig&              cfg,
+                         const std::vector<benchSample>& trace) {
+  std::vector<double> out;
+  struct timespec     start, end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  for (int pass = 0; pass < BENCH_CPU_PASSES; pass++) {
+    benchEstimate(cfg, trace, &out);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  double ns = (end.tv_sec - start.tv_sec) * 1e9 +
+              (end.tv_nsec - start.tv_nsec);
+  return ns / BENCH_CPU_PASSES / trace.size();
+}
+
+static int benchRun(const char *fileName) {
+  std::vector<benchSample> trace;
+
+  if (benchRead(fileName, &trace) ||
+      (trace.size() < (size_t)BENCH_CYCLES)) {
+    fprintf(stderr, "Invalid trace %s\n", fileName);
+    return 1;
+  }
+
+  printf("Velocity estimators on %s (%zu cycles, %.0fHz, %.0f counts/mm, "
+         "noise %.1f counts rms)\n\n",
+         fileName, trace.size(), 1 / BENCH_SAMPLE_TIME, BENCH_COUNTS_PER_MM,
+         BENCH_NOISE_COUNTS);
+  printf("%-22s %8s %10s %10s %10s %10s %8s\n", "estimator", "lag[ms]",
+         "ramp[mm/s]", "noise", "slow", "sine", "cpu[ns]");
+
+  for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+    std::vector<double> est;
+
+    benchEstimate(configs[c], trace, &est);
+
+    // Lag: best match of the shifted true velocity in the ramps
+    int    lag     = 0;
+    double lagBest = 1e300;
+
+    for (int shift = 0; shift <= BENCH_MAX_LAG_CYCLES; shift++) {
+      double err = benchRms(trace, est, 0.3, 0.5, shift) +
+                   benchRms(trace, est, 1.5, 1.7, shift);
+
+      if (err < lagBest) {
+        lagBest = err;
+        lag     = shift;
+      }
+    }
+
+    printf("%-22s %8.1f %10.4f %10.4f %10.4f %10.4f %8.1f\n",
+           configs[c].name,
+           lag * BENCH_SAMPLE_TIME * 1000,
+           benchMean(trace, est, 0.3, 0.4),
+           benchRms(trace, est, 0.6, 1.4, 0),
+           benchRms(trace, est, 3.1, 3.5, 0),
+           benchRms(trace, est, 2.1, 3.0, 0),
+           benchCpuNs(configs[c], trace));
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if ((argc == 3) && !strcmp(argv[1], "gen")) {
+    return benchGen(argv[2]);
+  }
+
+  if ((argc == 3) && !strcmp(argv[1], "run")) {
+    return benchRun(argv[2]);
+  }
+
+  fprintf(stderr, "Usage: %s gen|run <trace>\n", argv[0]);
+  return 1;
+}